@@ -0,0 +1,126 @@
+/*
+An arena is a bump allocator for temporary memory. Pushing memory onto it just moves a pointer forward, and
+instead of freeing each allocation, everything pushed after a marker is released at once by resetting the arena
+to that marker. The memory itself is kept and handed out again, so once an arena has grown to the most memory a
+frame (or a function) ever needs at one time, pushing onto it never calls malloc again.
+
+The arena is a chain of blocks. When the current block does not have room left, the arena moves on to the next
+block in the chain if it is large enough, or links in a new block. Memory that has been pushed never moves, so
+pointers into the arena stay valid until the arena is reset past them.
+
+A scope is made with a marker:
+
+	ArenaMarker marker = Arena_GetMarker(arena);
+	float* temporary = (float*)Arena_Push(arena, sizeof(float) * n);
+	...
+	Arena_ResetToMarker(arena, marker);
+
+The Vector and Matrix libraries take the memory for their own temporaries (copies of operands, factorizations,
+and the work vectors of the iterative solvers) from a scratch arena this way, given by Arena_GetScratch.
+Vector_InitializeFromArena and Matrix_InitializeFromArena make vectors and matrices whose components are in an
+arena. They must not be freed with Vector_Free or Matrix_Free.
+
+An arena is not thread safe, and neither is the scratch arena the libraries share.
+*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+//Every push is aligned for AVX loads and stores
+#define ARENA_ALIGNMENT 32
+//The smallest block an arena allocates
+#define ARENA_DEFAULT_BLOCK_SIZE 65536
+
+typedef struct ArenaBlock
+{
+	struct ArenaBlock* next;
+	size_t capacity;		//The number of bytes after this header
+	size_t used;			//The number of those bytes pushed so far, including padding
+}ArenaBlock;
+
+typedef struct Arena
+{
+	ArenaBlock* first;
+	ArenaBlock* current;	//The block pushes are being taken from
+	size_t blockSize;		//The size of the blocks the arena allocates, unless a push needs more
+}Arena;
+
+///
+//A position in an arena to reset it back to
+typedef struct ArenaMarker
+{
+	ArenaBlock* block;
+	size_t used;
+}ArenaMarker;
+
+///
+//Allocates memory for a new arena
+//
+//Returns:
+//	Pointer to new arena
+Arena* Arena_Allocate();
+
+///
+//Initializes an arena, allocating its first block
+//
+//Parameters:
+//	arena: Arena to initialize
+//	blockSize: The number of bytes in the first block, and the least in every block after it
+void Arena_Initialize(Arena* arena, const size_t blockSize);
+
+///
+//Frees an arena and every block it allocated
+//
+//Parameters:
+//	arena: Arena to free
+void Arena_Free(Arena* arena);
+
+///
+//Takes memory from an arena
+//
+//Parameters:
+//	arena: The arena to take the memory from
+//	size: The number of bytes to take
+//
+//Returns:
+//	A pointer to the memory, aligned to ARENA_ALIGNMENT. The memory is not cleared.
+void* Arena_Push(Arena* arena, const size_t size);
+
+///
+//Gets the current position of an arena, to reset it back to later
+//
+//Parameters:
+//	arena: The arena to get the position of
+ArenaMarker Arena_GetMarker(const Arena* arena);
+
+///
+//Releases all memory pushed onto an arena since a marker was taken. The blocks are kept for later pushes.
+//
+//Parameters:
+//	arena: The arena to reset
+//	marker: A marker from Arena_GetMarker on the same arena
+void Arena_ResetToMarker(Arena* arena, const ArenaMarker marker);
+
+///
+//Releases all memory pushed onto an arena. The blocks are kept for later pushes.
+//
+//Parameters:
+//	arena: The arena to reset
+void Arena_Reset(Arena* arena);
+
+///
+//Gets the number of bytes an arena has allocated for its blocks
+//
+//Parameters:
+//	arena: The arena to measure
+size_t Arena_GetCapacity(const Arena* arena);
+
+///
+//Gets the arena the Vector and Matrix libraries take their temporaries from.
+//It is created the first time it is used, and grows to the most memory any one operation has needed.
+Arena* Arena_GetScratch();
+
+#endif
@@ -0,0 +1,275 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "BandedMatrix.h"
+
+///
+//Allocates memory for a new banded matrix
+//
+//Returns:
+//	Pointer to new banded matrix
+BandedMatrix* BandedMatrix_Allocate()
+{
+	BandedMatrix* mat = (BandedMatrix*)malloc(sizeof(BandedMatrix));
+	return mat;
+}
+
+///
+//Initializes a banded matrix's components to 0
+//
+//Parameters:
+//	mat: Banded matrix to initialize
+//	dimension: The number of rows and columns in the matrix
+//	bandwidth: The number of diagonals below (and above) the main diagonal which can be nonzero
+void BandedMatrix_Initialize(BandedMatrix* mat, const uint32_t dimension, const uint16_t bandwidth)
+{
+	mat->dimension = dimension;
+	mat->bandwidth = bandwidth;
+	mat->components = (float*)calloc(sizeof(float), dimension * (bandwidth + 1));
+}
+
+///
+//Frees a banded matrix's resources
+//
+//Parameters:
+//	mat: Banded matrix to free
+void BandedMatrix_Free(BandedMatrix* mat)
+{
+	free(mat->components);
+	free(mat);
+}
+
+///
+//Indexes an array representing a banded matrix.
+//Row i is stored from column i - bandwidth, so the diagonal is the last component of each row.
+//
+//Parameters:
+//	band: The banded matrix to index
+//	row: The row of the element we wish to index
+//	col: The column of the element we wish to index
+//	bandwidth: The bandwidth of the matrix
+float* BandedMatrix_IndexArray(float* band, const uint32_t row, const uint32_t col, const uint16_t bandwidth)
+{
+	return band + row * (bandwidth + 1) + (col + bandwidth - row);
+}
+//Const correct indexing
+float BandedMatrix_GetIndexArray(const float* band, const uint32_t row, const uint32_t col, const uint16_t bandwidth)
+{
+	return band[row * (bandwidth + 1) + (col + bandwidth - row)];
+}
+//Performs error checking then calls BandedMatrix_IndexArray, indexing the stored half for components above
+//the diagonal. Returns null if the index is outside the band.
+float* BandedMatrix_Index(BandedMatrix* mat, const uint32_t row, const uint32_t col)
+{
+	uint32_t lower = row > col ? row : col;
+	uint32_t upper = row > col ? col : row;
+	if (lower >= mat->dimension || lower - upper > mat->bandwidth)
+	{
+		printf("BandedMatrix_Index failed! Index is not within the band. Index not found, returning null pointer.\n");
+		return 0x0;
+	}
+	return BandedMatrix_IndexArray(mat->components, lower, upper, mat->bandwidth);
+}
+
+///
+//Gets the matrix with one row and the matching column removed, as when a boundary condition is applied.
+//
+//Parameters:
+//	dest: The destination of the minor, with one less row and column than band
+//	band: The banded matrix to get the minor of
+//	removed: The row and column to remove
+//	dimension: The number of rows and columns in band
+//	bandwidth: The bandwidth of both matrices
+void BandedMatrix_GetMinorArray(float* dest, const float* band, const uint32_t removed, const uint32_t dimension, const uint16_t bandwidth)
+{
+	uint32_t destRow = 0;
+	for (uint32_t srcRow = 0; srcRow < dimension; srcRow++)
+	{
+		if (srcRow == removed) continue;
+
+		//Clear the row first, a component whose column was removed leaves a 0 at the left of the band
+		for (uint32_t i = 0; i <= bandwidth; i++)
+		{
+			dest[destRow * (bandwidth + 1) + i] = 0.0f;
+		}
+
+		uint32_t firstColumn = srcRow > bandwidth ? srcRow - bandwidth : 0;
+		for (uint32_t srcColumn = firstColumn; srcColumn <= srcRow; srcColumn++)
+		{
+			if (srcColumn == removed) continue;
+			uint32_t destColumn = srcColumn > removed ? srcColumn - 1 : srcColumn;
+			*BandedMatrix_IndexArray(dest, destRow, destColumn, bandwidth) = BandedMatrix_GetIndexArray(band, srcRow, srcColumn, bandwidth);
+		}
+		destRow++;
+	}
+}
+//Checks for errors then calls BandedMatrix_GetMinorArray
+void BandedMatrix_GetMinor(BandedMatrix* dest, const BandedMatrix* mat, const uint32_t removed)
+{
+	if (dest->dimension != mat->dimension - 1 || dest->bandwidth != mat->bandwidth)
+	{
+		printf("BandedMatrix_GetMinor failed! Destination matrix is not of proper dimensions. Minor not retrieved.\n");
+	}
+	else if (removed >= mat->dimension)
+	{
+		printf("BandedMatrix_GetMinor failed! Row to remove is not in the matrix. Minor not retrieved.\n");
+	}
+	else
+	{
+		BandedMatrix_GetMinorArray(dest->components, mat->components, removed, mat->dimension, mat->bandwidth);
+	}
+}
+
+///
+//Multiplies a vector by a banded matrix.
+//The components above the diagonal are read from their mirror below it.
+//
+//Parameters:
+//	dest: The destination of the product, must not be the same array as vector
+//	band: The banded matrix
+//	vector: The vector to multiply
+//	dimension: The number of rows and columns in the matrix
+//	bandwidth: The bandwidth of the matrix
+void BandedMatrix_GetProductVectorArray(float* dest, const float* band, const float* vector, const uint32_t dimension, const uint16_t bandwidth)
+{
+	for (uint32_t row = 0; row < dimension; row++)
+	{
+		float sum = 0.0f;
+		uint32_t firstColumn = row > bandwidth ? row - bandwidth : 0;
+		uint32_t lastColumn = row + bandwidth < dimension ? row + bandwidth : dimension - 1;
+
+		for (uint32_t col = firstColumn; col <= row; col++)
+		{
+			sum += BandedMatrix_GetIndexArray(band, row, col, bandwidth) * vector[col];
+		}
+		for (uint32_t col = row + 1; col <= lastColumn; col++)
+		{
+			sum += BandedMatrix_GetIndexArray(band, col, row, bandwidth) * vector[col];
+		}
+		dest[row] = sum;
+	}
+}
+//Checks for errors then calls BandedMatrix_GetProductVectorArray
+void BandedMatrix_GetProductVector(Vector* dest, const BandedMatrix* mat, const Vector* vector)
+{
+	if (dest->dimension != mat->dimension)
+	{
+		printf("BandedMatrix_GetProductVector failed! Destination is not the proper size. Product Vector not retrieved\n");
+	}
+	else if (vector->dimension != mat->dimension)
+	{
+		printf("BandedMatrix_GetProductVector failed! Operands are of incompatible size. Product Vector not retrieved\n");
+	}
+	else
+	{
+		BandedMatrix_GetProductVectorArray(dest->components, mat->components, vector->components, mat->dimension, mat->bandwidth);
+	}
+}
+
+///
+//Factors a symmetric positive definite banded matrix into L * transpose(L), where L is lower triangular with
+//the same band. L is stored over the matrix.
+//
+//Each column of L is found from the columns before it:
+//	L(j, j) = sqrt(A(j, j) - sum of L(j, k)^2)
+//	L(i, j) = (A(i, j) - sum of L(i, k) * L(j, k)) / L(j, j)
+//Where k runs over the earlier columns. L(i, k) is 0 when i - k > bandwidth, so each sum only has up to
+//bandwidth terms and only the band of L can be nonzero.
+//
+//Parameters:
+//	band: The matrix to factor, replaced by L
+//	dimension: The number of rows and columns in the matrix
+//	bandwidth: The bandwidth of the matrix
+//
+//Returns:
+//	1 if the matrix was factored, 0 if it is not positive definite
+int BandedMatrix_CholeskyDecomposeArray(float* band, const uint32_t dimension, const uint16_t bandwidth)
+{
+	for (uint32_t j = 0; j < dimension; j++)
+	{
+		uint32_t lastRow = j + bandwidth < dimension ? j + bandwidth : dimension - 1;
+		for (uint32_t i = j; i <= lastRow; i++)
+		{
+			uint32_t firstColumn = i > bandwidth ? i - bandwidth : 0;
+			float sum = BandedMatrix_GetIndexArray(band, i, j, bandwidth);
+			for (uint32_t k = firstColumn; k < j; k++)
+			{
+				sum -= BandedMatrix_GetIndexArray(band, i, k, bandwidth) * BandedMatrix_GetIndexArray(band, j, k, bandwidth);
+			}
+
+			if (i == j)
+			{
+				if (sum <= 0.0f)
+				{
+					return 0;
+				}
+				*BandedMatrix_IndexArray(band, j, j, bandwidth) = sqrtf(sum);
+			}
+			else
+			{
+				*BandedMatrix_IndexArray(band, i, j, bandwidth) = sum / BandedMatrix_GetIndexArray(band, j, j, bandwidth);
+			}
+		}
+	}
+	return 1;
+}
+//Checks for errors then calls BandedMatrix_CholeskyDecomposeArray
+int BandedMatrix_CholeskyDecompose(BandedMatrix* mat)
+{
+	if (mat->dimension == 0)
+	{
+		printf("BandedMatrix_CholeskyDecompose failed! Matrix is empty. Matrix not factored.\n");
+		return 0;
+	}
+	return BandedMatrix_CholeskyDecomposeArray(mat->components, mat->dimension, mat->bandwidth);
+}
+
+///
+//Solves the system of equations A * x = b in place using the Cholesky factorization of A.
+//Since L * transpose(L) * x = b, first L * y = b is solved from the top row down, then
+//transpose(L) * x = y from the bottom row up.
+//
+//Parameters:
+//	vector: The right hand side b, replaced by the solution x
+//	factor: The factorization of A from BandedMatrix_CholeskyDecomposeArray
+//	dimension: The number of rows and columns in A
+//	bandwidth: The bandwidth of A
+void BandedMatrix_CholeskySolveArray(float* vector, const float* factor, const uint32_t dimension, const uint16_t bandwidth)
+{
+	//Forward substitution
+	for (uint32_t row = 0; row < dimension; row++)
+	{
+		uint32_t firstColumn = row > bandwidth ? row - bandwidth : 0;
+		float sum = vector[row];
+		for (uint32_t col = firstColumn; col < row; col++)
+		{
+			sum -= BandedMatrix_GetIndexArray(factor, row, col, bandwidth) * vector[col];
+		}
+		vector[row] = sum / BandedMatrix_GetIndexArray(factor, row, row, bandwidth);
+	}
+
+	//Back substitution, row i of transpose(L) is column i of L
+	for (uint32_t row = dimension; row-- > 0;)
+	{
+		uint32_t lastColumn = row + bandwidth < dimension ? row + bandwidth : dimension - 1;
+		float sum = vector[row];
+		for (uint32_t col = row + 1; col <= lastColumn; col++)
+		{
+			sum -= BandedMatrix_GetIndexArray(factor, col, row, bandwidth) * vector[col];
+		}
+		vector[row] = sum / BandedMatrix_GetIndexArray(factor, row, row, bandwidth);
+	}
+}
+//Checks for errors then calls BandedMatrix_CholeskySolveArray
+void BandedMatrix_CholeskySolve(Vector* vector, const BandedMatrix* factor)
+{
+	if (vector->dimension != factor->dimension)
+	{
+		printf("BandedMatrix_CholeskySolve failed! Operands are of incompatible size. System not solved.\n");
+	}
+	else
+	{
+		BandedMatrix_CholeskySolveArray(vector->components, factor->components, factor->dimension, factor->bandwidth);
+	}
+}
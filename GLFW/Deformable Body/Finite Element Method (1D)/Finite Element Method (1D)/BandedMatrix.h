@@ -0,0 +1,123 @@
+/*
+A symmetric banded matrix: a square matrix whose only nonzero components lie within a fixed distance
+(the bandwidth) of the diagonal. A bandwidth of 1 is a tridiagonal matrix.
+
+Only the diagonal and the band below it are stored, one row after another, so an NxN matrix with bandwidth B
+takes N * (B + 1) floats instead of N * N. Row i stores columns i - B through i, and the components to the
+left of the first column are left as 0.
+
+A symmetric positive definite banded matrix (such as a stiffness matrix with a boundary condition applied)
+can be factored with a banded Cholesky decomposition in O(N * B^2) time, and each system of equations solved
+with the factorization in O(N * B) time. The factor has the same band as the matrix, so it is stored in
+place of it. For a tridiagonal matrix this is the symmetric form of the Thomas algorithm.
+*/
+
+#ifndef BANDEDMATRIX_H
+#define BANDEDMATRIX_H
+
+#include "Vector.h"
+#include <stdint.h>
+
+typedef struct BandedMatrix
+{
+	uint32_t dimension;		//The number of rows and columns
+	uint16_t bandwidth;		//The number of diagonals stored below the main diagonal
+
+	float* components;
+}BandedMatrix;
+
+///
+//Allocates memory for a new banded matrix
+//
+//Returns:
+//	Pointer to new banded matrix
+BandedMatrix* BandedMatrix_Allocate();
+
+///
+//Initializes a banded matrix's components to 0
+//
+//Parameters:
+//	mat: Banded matrix to initialize
+//	dimension: The number of rows and columns in the matrix
+//	bandwidth: The number of diagonals below (and above) the main diagonal which can be nonzero
+void BandedMatrix_Initialize(BandedMatrix* mat, const uint32_t dimension, const uint16_t bandwidth);
+
+///
+//Frees a banded matrix's resources
+//
+//Parameters:
+//	mat: Banded matrix to free
+void BandedMatrix_Free(BandedMatrix* mat);
+
+///
+//Indexes an array representing a banded matrix.
+//Only components on or below the diagonal and within the band are stored, so row must be at least col
+//and at most col + bandwidth.
+//
+//Parameters:
+//	band: The banded matrix to index
+//	row: The row of the element we wish to index
+//	col: The column of the element we wish to index
+//	bandwidth: The bandwidth of the matrix
+float* BandedMatrix_IndexArray(float* band, const uint32_t row, const uint32_t col, const uint16_t bandwidth);
+//Const correct indexing
+float BandedMatrix_GetIndexArray(const float* band, const uint32_t row, const uint32_t col, const uint16_t bandwidth);
+//Performs error checking then calls BandedMatrix_IndexArray, indexing the stored half for components above
+//the diagonal. Returns null if the index is outside the band.
+float* BandedMatrix_Index(BandedMatrix* mat, const uint32_t row, const uint32_t col);
+
+///
+//Gets the matrix with one row and the matching column removed, as when a boundary condition is applied.
+//Removing a row and column keeps the band, so the result has the same bandwidth.
+//
+//Parameters:
+//	dest: The destination of the minor, with one less row and column than band
+//	band: The banded matrix to get the minor of
+//	removed: The row and column to remove
+//	dimension: The number of rows and columns in band
+//	bandwidth: The bandwidth of both matrices
+void BandedMatrix_GetMinorArray(float* dest, const float* band, const uint32_t removed, const uint32_t dimension, const uint16_t bandwidth);
+//Checks for errors then calls BandedMatrix_GetMinorArray
+void BandedMatrix_GetMinor(BandedMatrix* dest, const BandedMatrix* mat, const uint32_t removed);
+
+///
+//Multiplies a vector by a banded matrix
+//
+//Parameters:
+//	dest: The destination of the product, must not be the same array as vector
+//	band: The banded matrix
+//	vector: The vector to multiply
+//	dimension: The number of rows and columns in the matrix
+//	bandwidth: The bandwidth of the matrix
+void BandedMatrix_GetProductVectorArray(float* dest, const float* band, const float* vector, const uint32_t dimension, const uint16_t bandwidth);
+//Checks for errors then calls BandedMatrix_GetProductVectorArray
+void BandedMatrix_GetProductVector(Vector* dest, const BandedMatrix* mat, const Vector* vector);
+
+///
+//Factors a symmetric positive definite banded matrix into L * transpose(L), where L is lower triangular with
+//the same band. L is stored over the matrix.
+//
+//Parameters:
+//	band: The matrix to factor, replaced by L
+//	dimension: The number of rows and columns in the matrix
+//	bandwidth: The bandwidth of the matrix
+//
+//Returns:
+//	1 if the matrix was factored, 0 if it is not positive definite
+int BandedMatrix_CholeskyDecomposeArray(float* band, const uint32_t dimension, const uint16_t bandwidth);
+//Checks for errors then calls BandedMatrix_CholeskyDecomposeArray
+int BandedMatrix_CholeskyDecompose(BandedMatrix* mat);
+
+///
+//Solves the system of equations A * x = b in place using the Cholesky factorization of A
+//
+//Parameters:
+//	vector: The right hand side b, replaced by the solution x
+//	factor: The factorization of A from BandedMatrix_CholeskyDecomposeArray
+//	dimension: The number of rows and columns in A
+//	bandwidth: The bandwidth of A
+void BandedMatrix_CholeskySolveArray(float* vector, const float* factor, const uint32_t dimension, const uint16_t bandwidth);
+//Checks for errors then calls BandedMatrix_CholeskySolveArray
+void BandedMatrix_CholeskySolve(Vector* vector, const BandedMatrix* factor);
+
+#endif
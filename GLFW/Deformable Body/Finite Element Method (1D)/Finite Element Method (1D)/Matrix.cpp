@@ -37,6 +37,10 @@ NGen by Nicholas Gallagher
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <string.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 #include "Matrix.h"
 
@@ -71,6 +75,27 @@ void Matrix_Initialize(Matrix* mat, const uint16_t numRows, const uint16_t numCo
 	}
 }
 
+///
+//Initializes a matrix with components taken from an arena, and sets it as an identity matrix if it is square.
+//The matrix must not be freed with Matrix_Free; its components are released when the arena is reset.
+//
+//Parameters:
+//	mat: Matrix to initialize
+//	numRows: The number of rows in the matrix
+//	numCols: The number of columns in the matrix
+//	arena: The arena to take the components from
+void Matrix_InitializeFromArena(Matrix* mat, const uint16_t numRows, const uint16_t numCols, Arena* arena)
+{
+	mat->numRows = numRows;
+	mat->numColumns = numCols;
+	mat->components = (float*)Arena_Push(arena, sizeof(float) * numRows * numCols);
+	memset(mat->components, 0, sizeof(float) * numRows * numCols);
+	if (mat->numRows == mat->numColumns)
+	{
+		Matrix_ToIdentity(mat);
+	}
+}
+
 ///
 //Frees a matrix's resources
 //
@@ -402,7 +427,7 @@ void Matrix_SliceColumn(Vector* destination, const Matrix* mat, const uint16_t d
 //	scalarValue: The value by which to scale the matrix
 void Matrix_ScaleArray(float* matrix, const uint16_t numRows, const uint16_t numColumns, const float scalarValue)
 {
-	for(uint16_t i = 0; i < numRows * numColumns; i++)
+	for(int i = 0; i < numRows * numColumns; i++)
 	{
 		matrix[i] *= scalarValue;
 	}
@@ -415,6 +440,7 @@ void Matrix_Scale(Matrix* matrix, const float scalarValue)
 
 ///
 //Calculates the determinate of a matrix in array form.
+//The determinate of the LU factorization is the product of the diagonal of U, negated if an odd number of rows were swapped.
 //
 //Parameters:
 //	mat: The matrix to calculate the determinate of
@@ -422,29 +448,22 @@ void Matrix_Scale(Matrix* matrix, const float scalarValue)
 //	numRows: The number of rows in the matrix
 float Matrix_GetDeterminateArray(const float* mat, const uint16_t numRows, const uint16_t numColumns)
 {
-	float determinate = 0.0f;
-	if(numRows > 2 && numColumns > 2)
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	float* LU = (float*)Arena_Push(scratch, sizeof(float) * numRows * numColumns);
+	uint16_t* pivots = (uint16_t*)Arena_Push(scratch, sizeof(uint16_t) * numRows);
+	Matrix_CopyArray(LU, mat, numRows, numColumns);
+
+	float determinate = (float)Matrix_LUDecomposeArray(LU, pivots, numRows);
+	if (determinate != 0.0f)
 	{
-		for(int i = 0; i < numColumns; i++)
+		for (int i = 0; i < numRows; i++)
 		{
-			float coefficient = powf(-1.0, (float)(i + 2)) * Matrix_GetIndexArray(mat, 0, i, numColumns);
-			float minorDeterminate = 0.0f;
-
-			float* minor = (float*)malloc(sizeof(float) * (numRows - 1) * (numColumns - 1));
-			Matrix_GetMinorArray(minor, mat, 0, i, numRows, numColumns);
-			minorDeterminate = Matrix_GetDeterminateArray(minor, numRows - 1, numColumns - 1);
-			free(minor);
-
-
-
-			determinate += coefficient * minorDeterminate;
+			determinate *= Matrix_GetIndexArray(LU, i, i, numColumns);
 		}
 	}
-	else
-	{
-		determinate = (Matrix_GetIndexArray(mat, 0, 0, numColumns) * Matrix_GetIndexArray(mat, 1, 1, numColumns)) - (Matrix_GetIndexArray(mat, 0, 1, numColumns) * Matrix_GetIndexArray(mat, 1, 0, numColumns));
-	}
 
+	Arena_ResetToMarker(scratch, marker);
 	return determinate;
 }
 //Checks for errors then calls CMatrix_GetDeterminateArray
@@ -471,8 +490,7 @@ float Matrix_GetDeterminate(const Matrix* mat)
 //	numColumns: the number of columns in the matrix
 void Matrix_TransposeArray(float* mat, const uint16_t numRows, const uint16_t numColumns)
 {
-	uint16_t middleRow = numRows % 2 == 0 ? numRows / 2 : numRows / 2 + 1;
-	for(int i = 0; i < middleRow; i++)
+	for(int i = 0; i < numRows; i++)
 	{
 		for(int j = i + 1; j < numColumns; j++)
 		{
@@ -526,6 +544,7 @@ void Matrix_GetTranspose(Matrix* dest, Matrix* src)
 
 ///
 //Calculates the inverse of a matrix in array form.
+//The destination is left unchanged if the matrix is not invertible.
 //
 //Parameters:
 //	dest: A pointer to an array of floats to store the inverse of the components
@@ -534,63 +553,442 @@ void Matrix_GetTranspose(Matrix* dest, Matrix* src)
 //	numCols: The number of columns in the matrix being inverted
 void Matrix_GetInverseArray(float* dest, const float* matrix, const uint16_t numRows, const uint16_t numCols)
 {
-	if(numRows > 2 && numCols > 2)
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	float* LU = (float*)Arena_Push(scratch, sizeof(float) * numRows * numCols);
+	uint16_t* pivots = (uint16_t*)Arena_Push(scratch, sizeof(uint16_t) * numRows);
+	Matrix_CopyArray(LU, matrix, numRows, numCols);
+
+	if (Matrix_LUDecomposeArray(LU, pivots, numRows) != 0)
+	{
+		Matrix_LUInverseArray(dest, LU, pivots, numRows);
+	}
+
+	Arena_ResetToMarker(scratch, marker);
+}
+//Checks for errors, then calls Matrix_GetInverseArray
+void Matrix_GetInverse(Matrix* dest, const Matrix* matrix)
+{
+	if(dest->numRows != matrix->numRows || dest->numColumns != matrix->numColumns)
+	{
+		printf("Matrix_GetInverse failed! Dimensions of destination and input matrices do not match! Inverse not found!\n");
+		return;
+	}
+	else if(matrix->numRows != matrix->numColumns)
+	{
+		printf("Matrix_GetInverse failed! Matrix is not invertible! Inverse not found!\n");
+		return;
+	}
+
+	//Factor once, both to check that the matrix is invertible and to find the inverse
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	float* LU = (float*)Arena_Push(scratch, sizeof(float) * matrix->numRows * matrix->numColumns);
+	uint16_t* pivots = (uint16_t*)Arena_Push(scratch, sizeof(uint16_t) * matrix->numRows);
+	Matrix_CopyArray(LU, matrix->components, matrix->numRows, matrix->numColumns);
+
+	if (Matrix_LUDecomposeArray(LU, pivots, matrix->numRows) == 0)
 	{
-		//Create an array of floats to hold the minor matrices
-		float* minor = (float*)malloc(sizeof(float) * (numRows - 1) * (numCols - 1));
+		printf("Matrix_GetInverse failed! Matrix is not invertible! Inverse not found!\n");
+	}
+	else
+	{
+		Matrix_LUInverseArray(dest->components, LU, pivots, matrix->numRows);
+	}
+
+	Arena_ResetToMarker(scratch, marker);
+}
 
+///
+//Factors a square matrix in array form into a lower and an upper triangular matrix with partial pivoting, so that
+//the matrix with its rows reordered by the pivots is equal to L * U.
+//The factorization is stored over the matrix: U on and above the diagonal, and L below it.
+//The diagonal of L is all ones and is not stored.
+//
+//Each column is eliminated from the rows below the diagonal in turn (Gaussian elimination), keeping the multipliers
+//as L. Before each column the row with the largest value in that column is swapped onto the diagonal, so nothing is
+//ever divided by a tiny pivot. This takes O(n^3) time, where expanding by cofactors takes O(n!).
+//
+//Parameters:
+//	mat: The matrix to factor, replaced by its factorization
+//	pivots: An array of dim indices to store the row order in. Row i of the factorization came from row pivots[i] of the matrix.
+//	dim: The number of rows and columns in the matrix
+//
+//Returns:
+//	1 or -1 if an even or odd number of rows were swapped, or 0 if the matrix is singular
+int Matrix_LUDecomposeArray(float* mat, uint16_t* pivots, const uint16_t dim)
+{
+	int sign = 1;
+	for (int i = 0; i < dim; i++)
+	{
+		pivots[i] = i;
+	}
 
-		for(unsigned int i = 0; i < numRows; i++)
+	for (int col = 0; col < dim; col++)
+	{
+		//Find the largest pivot in this column
+		int pivotRow = col;
+		float largest = fabsf(mat[col * dim + col]);
+		for (int row = col + 1; row < dim; row++)
 		{
-			for(unsigned int j = 0; j < numCols; j++)
+			if (fabsf(mat[row * dim + col]) > largest)
 			{
+				largest = fabsf(mat[row * dim + col]);
+				pivotRow = row;
+			}
+		}
 
-				//Get the minor of the 0, 0 index
-				Matrix_GetMinorArray(minor, matrix, i, j, numRows, numCols);
-
-				//Find the determinate of the minor
-				float minorDet = Matrix_GetDeterminateArray(minor, numRows - 1, numCols - 1);
+		//If the whole column is zero below the diagonal, the matrix is singular
+		if (largest == 0.0f)
+		{
+			return 0;
+		}
 
-				//The j,i th component of the adjoint matrix is (-1)^(i*j) * the i,jth minor
-				*Matrix_IndexArray(dest, j, i, numCols) = pow(-1.0f, (int)(i+j)) * minorDet;
+		if (pivotRow != col)
+		{
+			for (int j = 0; j < dim; j++)
+			{
+				float temp = mat[col * dim + j];
+				mat[col * dim + j] = mat[pivotRow * dim + j];
+				mat[pivotRow * dim + j] = temp;
+			}
+			uint16_t tempPivot = pivots[col];
+			pivots[col] = pivots[pivotRow];
+			pivots[pivotRow] = tempPivot;
+			sign = -sign;
+		}
 
+		//Eliminate this column from every row below the diagonal
+		const float* pivotRowComponents = mat + col * dim;
+		for (int row = col + 1; row < dim; row++)
+		{
+			float* rowComponents = mat + row * dim;
+			float multiplier = rowComponents[col] / pivotRowComponents[col];
+			rowComponents[col] = multiplier;
+			for (int j = col + 1; j < dim; j++)
+			{
+				rowComponents[j] -= multiplier * pivotRowComponents[j];
 			}
 		}
+	}
 
-		//Free the memory made for the minor matrix
-		free(minor);
+	return sign;
+}
+//Checks for errors then calls Matrix_LUDecomposeArray
+int Matrix_LUDecompose(Matrix* mat, uint16_t* pivots)
+{
+	if (mat->numRows != mat->numColumns)
+	{
+		printf("Matrix_LUDecompose failed! Matrix is not NxN! Matrix not factored.\n");
+		return 0;
 	}
-	else
+	return Matrix_LUDecomposeArray(mat->components, pivots, mat->numRows);
+}
+
+///
+//Solves the system of equations A * x = b in place using the LU factorization of A.
+//Since L * U * x = b (with b reordered by the pivots), first L * y = b is solved from the top row down,
+//then U * x = y from the bottom row up.
+//
+//Parameters:
+//	vector: The right hand side b, replaced by the solution x
+//	LU: The factorization of A from Matrix_LUDecomposeArray
+//	pivots: The row order from Matrix_LUDecomposeArray
+//	dim: The number of rows and columns in A
+void Matrix_LUSolveArray(float* vector, const float* LU, const uint16_t* pivots, const uint16_t dim)
+{
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	float* reordered = (float*)Arena_Push(scratch, sizeof(float) * dim);
+	for (int i = 0; i < dim; i++)
 	{
-		//Swap the components on the diagonal
-		*Matrix_IndexArray(dest, 0, 0, numCols) = Matrix_GetIndexArray(matrix, 1, 1, numCols);
-		*Matrix_IndexArray(dest, 1, 1, numCols) = Matrix_GetIndexArray(matrix, 0, 0, numCols);
+		reordered[i] = vector[pivots[i]];
+	}
 
-		//Negate the off diagonals
-		*Matrix_IndexArray(dest, 0, 1, numCols) = -1.0f * Matrix_GetIndexArray(matrix, 0, 1, numCols);
-		*Matrix_IndexArray(dest, 1, 0, numCols) = -1.0f * Matrix_GetIndexArray(matrix, 1, 0, numCols);
+	//Forward substitution, L has ones on the diagonal
+	for (int row = 0; row < dim; row++)
+	{
+		float sum = reordered[row];
+		for (int col = 0; col < row; col++)
+		{
+			sum -= LU[row * dim + col] * reordered[col];
+		}
+		reordered[row] = sum;
 	}
 
-	//Scale the adjoint by 1/det(matrix)
-	Matrix_ScaleArray(dest, numRows, numCols, 1.0f/Matrix_GetDeterminateArray(matrix, numRows, numCols));
+	//Back substitution
+	for (int row = dim - 1; row >= 0; row--)
+	{
+		float sum = reordered[row];
+		for (int col = row + 1; col < dim; col++)
+		{
+			sum -= LU[row * dim + col] * reordered[col];
+		}
+		reordered[row] = sum / LU[row * dim + row];
+	}
 
+	Vector_CopyArray(vector, reordered, dim);
+	Arena_ResetToMarker(scratch, marker);
 }
-//Checks for errors, then calls Matrix_GetInverseArray
-void Matrix_GetInverse(Matrix* dest, const Matrix* matrix)
+//Checks for errors then calls Matrix_LUSolveArray
+void Matrix_LUSolve(Vector* vector, const Matrix* LU, const uint16_t* pivots)
 {
-	if(dest->numRows != matrix->numRows || dest->numColumns != matrix->numColumns)
+	if (LU->numRows != LU->numColumns)
 	{
-		printf("Matrix_GetInverse failed! Dimensions of destination and input matrices do not match! Inverse not found!\n");
-		return;
+		printf("Matrix_LUSolve failed! Matrix is not NxN! System not solved.\n");
 	}
-	else if(Matrix_GetDeterminate(matrix) == 0)
+	else if (LU->numColumns != vector->dimension)
 	{
-		printf("Matrix_GetInverse failed! Matrix is not invertible! Inverse not found!\n");
-		return;
+		printf("Matrix_LUSolve failed! Operands are of incompatible sizes. System not solved.\n");
 	}
 	else
 	{
-		Matrix_GetInverseArray(dest->components, matrix->components, matrix->numRows, matrix->numColumns);
+		Matrix_LUSolveArray(vector->components, LU->components, pivots, LU->numRows);
+	}
+}
+
+///
+//Calculates the inverse of a matrix from its LU factorization by solving for each column of the identity matrix
+//
+//Parameters:
+//	dest: A pointer to an array of floats to store the inverse in
+//	LU: The factorization of the matrix from Matrix_LUDecomposeArray
+//	pivots: The row order from Matrix_LUDecomposeArray
+//	dim: The number of rows and columns in the matrix
+void Matrix_LUInverseArray(float* dest, const float* LU, const uint16_t* pivots, const uint16_t dim)
+{
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	float* column = (float*)Arena_Push(scratch, sizeof(float) * dim);
+	for (int col = 0; col < dim; col++)
+	{
+		for (int row = 0; row < dim; row++)
+		{
+			column[row] = row == col ? 1.0f : 0.0f;
+		}
+
+		Matrix_LUSolveArray(column, LU, pivots, dim);
+
+		for (int row = 0; row < dim; row++)
+		{
+			*Matrix_IndexArray(dest, row, col, dim) = column[row];
+		}
+	}
+	Arena_ResetToMarker(scratch, marker);
+}
+
+///
+//Solves the system of equations A * x = b in place by factoring a copy of A.
+//To solve many systems with the same matrix, factor it once with Matrix_LUDecomposeArray and call Matrix_LUSolveArray for each.
+//
+//Parameters:
+//	vector: The right hand side b, replaced by the solution x
+//	mat: The matrix A
+//	dim: The number of rows and columns in A
+//
+//Returns:
+//	0 if A is singular and the vector was left unchanged, 1 otherwise
+int Matrix_SolveArray(float* vector, const float* mat, const uint16_t dim)
+{
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	float* LU = (float*)Arena_Push(scratch, sizeof(float) * dim * dim);
+	uint16_t* pivots = (uint16_t*)Arena_Push(scratch, sizeof(uint16_t) * dim);
+	Matrix_CopyArray(LU, mat, dim, dim);
+
+	int solved = Matrix_LUDecomposeArray(LU, pivots, dim) != 0;
+	if (solved)
+	{
+		Matrix_LUSolveArray(vector, LU, pivots, dim);
+	}
+
+	Arena_ResetToMarker(scratch, marker);
+	return solved;
+}
+//Checks for errors then calls Matrix_SolveArray
+void Matrix_Solve(Vector* vector, const Matrix* mat)
+{
+	if (mat->numRows != mat->numColumns)
+	{
+		printf("Matrix_Solve failed! Matrix is not NxN! System not solved.\n");
+	}
+	else if (mat->numColumns != vector->dimension)
+	{
+		printf("Matrix_Solve failed! Operands are of incompatible sizes. System not solved.\n");
+	}
+	else if (!Matrix_SolveArray(vector->components, mat->components, mat->numRows))
+	{
+		printf("Matrix_Solve failed! Matrix is singular! System not solved.\n");
+	}
+}
+
+//Sizes of the blocks the product of two matrices is computed in.
+//A block of the right hand side matrix MATRIX_BLOCK_DEPTH rows by MATRIX_BLOCK_COLUMNS columns (256KB) stays in the
+//L2 cache while every row of the left hand side matrix is multiplied by it, and the MATRIX_BLOCK_DEPTH by 16 strip of it
+//being multiplied by four rows at a time (16KB) stays in the L1 cache.
+#define MATRIX_BLOCK_DEPTH 256
+#define MATRIX_BLOCK_COLUMNS 256
+//The number of rows of a transposed right hand side matrix which are dotted with every row of the left hand side at a time
+#define MATRIX_BLOCK_DOT_ROWS 64
+
+#if defined(__AVX2__)
+//Visual Studio enables FMA along with /arch:AVX2, other compilers need it asked for separately
+#if defined(__FMA__) || defined(_MSC_VER)
+#define MATRIX_FMADD(a, b, c) _mm256_fmadd_ps(a, b, c)
+#else
+#define MATRIX_FMADD(a, b, c) _mm256_add_ps(_mm256_mul_ps(a, b), c)
+#endif
+
+///
+//Adds the eight floats in a register together
+static float Matrix_HorizontalSum(__m256 v)
+{
+	__m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+	sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+	sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+	return _mm_cvtss_f32(sum);
+}
+#endif
+
+///
+//Gets the dot product of two arrays of floats
+//
+//Parameters:
+//	a: The first array
+//	b: The second array
+//	count: The number of floats in each array
+static float Matrix_DotArray(const float* a, const float* b, const int count)
+{
+	int i = 0;
+	float sum = 0.0f;
+#if defined(__AVX2__)
+	__m256 sum0 = _mm256_setzero_ps();
+	__m256 sum1 = _mm256_setzero_ps();
+	for (; i + 16 <= count; i += 16)
+	{
+		sum0 = MATRIX_FMADD(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+		sum1 = MATRIX_FMADD(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), sum1);
+	}
+	for (; i + 8 <= count; i += 8)
+	{
+		sum0 = MATRIX_FMADD(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+	}
+	sum = Matrix_HorizontalSum(_mm256_add_ps(sum0, sum1));
+#endif
+	for (; i < count; i++)
+	{
+		sum += a[i] * b[i];
+	}
+	return sum;
+}
+
+///
+//Adds the product of up to four rows of the left hand side matrix and a block of the right hand side matrix onto the
+//destination matrix.
+//
+//With AVX2, four rows by sixteen columns of the destination are kept in eight registers while the block's depth is
+//walked, so each row of the right hand side strip is loaded once for all four rows, and each component of the left hand
+//side is broadcast once for sixteen columns.
+//
+//Parameters:
+//	dest: The destination matrix
+//	LHS: The left hand side matrix
+//	RHS: The right hand side matrix
+//	row: The first row of the block
+//	numRows: The number of rows in the block, at most 4
+//	depthStart: The first column of the left hand side (and row of the right hand side) in the block
+//	depthEnd: One past the last column of the left hand side in the block
+//	colStart: The first column of the right hand side in the block
+//	colEnd: One past the last column of the right hand side in the block
+//	LHSNumCols: The number of columns in the left hand side matrix
+//	RHSNumCols: The number of columns in the right hand side matrix
+static void Matrix_MultiplyBlockArray(float* dest, const float* LHS, const float* RHS, const int row, const int numRows, const int depthStart, const int depthEnd, const int colStart, const int colEnd, const int LHSNumCols, const int RHSNumCols)
+{
+	int col = colStart;
+#if defined(__AVX2__)
+	if (numRows == 4)
+	{
+		const float* a0 = LHS + row * LHSNumCols;
+		const float* a1 = a0 + LHSNumCols;
+		const float* a2 = a1 + LHSNumCols;
+		const float* a3 = a2 + LHSNumCols;
+		float* c0 = dest + row * RHSNumCols;
+		float* c1 = c0 + RHSNumCols;
+		float* c2 = c1 + RHSNumCols;
+		float* c3 = c2 + RHSNumCols;
+
+		for (; col + 16 <= colEnd; col += 16)
+		{
+			__m256 c00 = _mm256_loadu_ps(c0 + col), c01 = _mm256_loadu_ps(c0 + col + 8);
+			__m256 c10 = _mm256_loadu_ps(c1 + col), c11 = _mm256_loadu_ps(c1 + col + 8);
+			__m256 c20 = _mm256_loadu_ps(c2 + col), c21 = _mm256_loadu_ps(c2 + col + 8);
+			__m256 c30 = _mm256_loadu_ps(c3 + col), c31 = _mm256_loadu_ps(c3 + col + 8);
+
+			for (int k = depthStart; k < depthEnd; k++)
+			{
+				const float* b = RHS + k * RHSNumCols + col;
+				__m256 b0 = _mm256_loadu_ps(b);
+				__m256 b1 = _mm256_loadu_ps(b + 8);
+
+				__m256 a = _mm256_broadcast_ss(a0 + k);
+				c00 = MATRIX_FMADD(a, b0, c00);
+				c01 = MATRIX_FMADD(a, b1, c01);
+				a = _mm256_broadcast_ss(a1 + k);
+				c10 = MATRIX_FMADD(a, b0, c10);
+				c11 = MATRIX_FMADD(a, b1, c11);
+				a = _mm256_broadcast_ss(a2 + k);
+				c20 = MATRIX_FMADD(a, b0, c20);
+				c21 = MATRIX_FMADD(a, b1, c21);
+				a = _mm256_broadcast_ss(a3 + k);
+				c30 = MATRIX_FMADD(a, b0, c30);
+				c31 = MATRIX_FMADD(a, b1, c31);
+			}
+
+			_mm256_storeu_ps(c0 + col, c00); _mm256_storeu_ps(c0 + col + 8, c01);
+			_mm256_storeu_ps(c1 + col, c10); _mm256_storeu_ps(c1 + col + 8, c11);
+			_mm256_storeu_ps(c2 + col, c20); _mm256_storeu_ps(c2 + col + 8, c21);
+			_mm256_storeu_ps(c3 + col, c30); _mm256_storeu_ps(c3 + col + 8, c31);
+		}
+
+		for (; col + 8 <= colEnd; col += 8)
+		{
+			__m256 c00 = _mm256_loadu_ps(c0 + col);
+			__m256 c10 = _mm256_loadu_ps(c1 + col);
+			__m256 c20 = _mm256_loadu_ps(c2 + col);
+			__m256 c30 = _mm256_loadu_ps(c3 + col);
+
+			for (int k = depthStart; k < depthEnd; k++)
+			{
+				__m256 b0 = _mm256_loadu_ps(RHS + k * RHSNumCols + col);
+				c00 = MATRIX_FMADD(_mm256_broadcast_ss(a0 + k), b0, c00);
+				c10 = MATRIX_FMADD(_mm256_broadcast_ss(a1 + k), b0, c10);
+				c20 = MATRIX_FMADD(_mm256_broadcast_ss(a2 + k), b0, c20);
+				c30 = MATRIX_FMADD(_mm256_broadcast_ss(a3 + k), b0, c30);
+			}
+
+			_mm256_storeu_ps(c0 + col, c00);
+			_mm256_storeu_ps(c1 + col, c10);
+			_mm256_storeu_ps(c2 + col, c20);
+			_mm256_storeu_ps(c3 + col, c30);
+		}
+	}
+#endif
+
+	//The remaining columns, or every column without AVX2.
+	//The inner loop runs along a row of the destination and of the right hand side, so the compiler can vectorize it.
+	for (int r = row; r < row + numRows; r++)
+	{
+		float* c = dest + r * RHSNumCols;
+		const float* a = LHS + r * LHSNumCols;
+		for (int k = depthStart; k < depthEnd; k++)
+		{
+			float scalar = a[k];
+			const float* b = RHS + k * RHSNumCols;
+			for (int j = col; j < colEnd; j++)
+			{
+				c[j] += scalar * b[j];
+			}
+		}
 	}
 }
 
@@ -605,16 +1003,16 @@ void Matrix_GetInverse(Matrix* dest, const Matrix* matrix)
 void Matrix_TransformMatrixArray(const float* LHSMatrix, float* RHSMatrix, const uint16_t LHSNumRows, const uint16_t LHSNumCols, const uint16_t RHSNumCols)
 {
 	//Create a copy of the right hand side matrix
-	float* RHSCopy = (float*)malloc(sizeof(float) * LHSNumCols * RHSNumCols);
-	//float RHSCopy[LHSNumCols * RHSNumCols];
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	float* RHSCopy = (float*)Arena_Push(scratch, sizeof(float) * LHSNumCols * RHSNumCols);
 
 	Matrix_CopyArray(RHSCopy, RHSMatrix, LHSNumCols, RHSNumCols);
 
 	//Get product of LHSMatrix and RHSCopy and store in RHSMatrix
 	Matrix_GetProductMatrixArray(RHSMatrix, LHSMatrix, RHSCopy, LHSNumRows, LHSNumCols, RHSNumCols);
 
-	//Never forget
-	free(RHSCopy);
+	Arena_ResetToMarker(scratch, marker);
 }
 //Checks for errors then calls Matrix_TransformMatrixArray
 void Matrix_TransformMatrix(const Matrix* LHSMatrix, Matrix* RHSMatrix)
@@ -633,7 +1031,9 @@ void Matrix_TransformMatrix(const Matrix* LHSMatrix, Matrix* RHSMatrix)
 }
 
 ///
-//Gets the product of a matrix acting upon another matrix
+//Gets the product of a matrix acting upon another matrix.
+//The product is computed in blocks which fit in the cache, see Matrix_MultiplyBlockArray.
+//The destination must not be either of the operands.
 //
 //Parameters:
 //	destMatrix: The destination of the product matrix
@@ -643,15 +1043,18 @@ void Matrix_TransformMatrix(const Matrix* LHSMatrix, Matrix* RHSMatrix)
 //	LHSNumCols: The number of columns in the left hand side matrix
 void Matrix_GetProductMatrixArray(float* destMatrix, const float* LHSMatrix, const float* RHSMatrix, const uint16_t LHSNumRows, const uint16_t LHSNumCols, const uint16_t RHSNumCols)
 {
-	for (int rows = 0; rows < LHSNumRows; rows++)
+	memset(destMatrix, 0, sizeof(float) * LHSNumRows * RHSNumCols);
+
+	for (int depth = 0; depth < LHSNumCols; depth += MATRIX_BLOCK_DEPTH)
 	{
-		for (int cols = 0; cols < RHSNumCols; cols++)
+		int depthEnd = depth + MATRIX_BLOCK_DEPTH < LHSNumCols ? depth + MATRIX_BLOCK_DEPTH : LHSNumCols;
+		for (int col = 0; col < RHSNumCols; col += MATRIX_BLOCK_COLUMNS)
 		{
-			*Matrix_IndexArray(destMatrix, rows, cols, RHSNumCols) = 0.0f;
-			for (int dot = 0; dot < LHSNumCols; dot++)
+			int colEnd = col + MATRIX_BLOCK_COLUMNS < RHSNumCols ? col + MATRIX_BLOCK_COLUMNS : RHSNumCols;
+			for (int row = 0; row < LHSNumRows; row += 4)
 			{
-				float increment = Matrix_GetIndexArray(LHSMatrix, rows, dot, LHSNumCols) * Matrix_GetIndexArray(RHSMatrix, dot, cols, RHSNumCols);
-				*Matrix_IndexArray(destMatrix, rows, cols, RHSNumCols) += increment;
+				int numRows = LHSNumRows - row < 4 ? LHSNumRows - row : 4;
+				Matrix_MultiplyBlockArray(destMatrix, LHSMatrix, RHSMatrix, row, numRows, depth, depthEnd, col, colEnd, LHSNumCols, RHSNumCols);
 			}
 		}
 	}
@@ -674,6 +1077,109 @@ void Matrix_GetProductMatrix(Matrix* destMatrix, const Matrix* LHSMatrix, const
 	}
 }
 
+///
+//Gets the product of a matrix acting upon another matrix, given the transpose of the right hand side matrix.
+//Every component of the product is the dot product of a row of the left hand side and a row of the transpose,
+//which are both contiguous in memory, so this is the faster product when the right hand side is on hand transposed
+//(such as for A * transpose(A)).
+//The destination must not be either of the operands.
+//
+//Parameters:
+//	destMatrix: The destination of the product matrix
+//	LHSMatrix: The left hand side matrix
+//	RHSTranspose: The transpose of the right hand side matrix, with RHSNumCols rows and LHSNumCols columns
+//	LHSNumRows: The number of rows in the left hand side matrix
+//	LHSNumCols: The number of columns in the left hand side matrix
+//	RHSNumCols: The number of columns in the right hand side matrix (rows in its transpose)
+void Matrix_GetProductMatrixTransposeArray(float* destMatrix, const float* LHSMatrix, const float* RHSTranspose, const uint16_t LHSNumRows, const uint16_t LHSNumCols, const uint16_t RHSNumCols)
+{
+	//Each block of rows of the transpose stays in the cache while every row of the left hand side is dotted with it
+	for (int block = 0; block < RHSNumCols; block += MATRIX_BLOCK_DOT_ROWS)
+	{
+		int blockEnd = block + MATRIX_BLOCK_DOT_ROWS < RHSNumCols ? block + MATRIX_BLOCK_DOT_ROWS : RHSNumCols;
+		int row = 0;
+#if defined(__AVX2__)
+		//Two rows of the left hand side are dotted with four rows of the transpose at once, in eight registers
+		int depthEnd = LHSNumCols - LHSNumCols % 8;
+		for (; row + 2 <= LHSNumRows; row += 2)
+		{
+			const float* a0 = LHSMatrix + row * LHSNumCols;
+			const float* a1 = a0 + LHSNumCols;
+			float* c0 = destMatrix + row * RHSNumCols;
+			float* c1 = c0 + RHSNumCols;
+
+			int col = block;
+			for (; col + 4 <= blockEnd; col += 4)
+			{
+				const float* b0 = RHSTranspose + col * LHSNumCols;
+				const float* b1 = b0 + LHSNumCols;
+				const float* b2 = b1 + LHSNumCols;
+				const float* b3 = b2 + LHSNumCols;
+
+				__m256 s00 = _mm256_setzero_ps(), s01 = _mm256_setzero_ps(), s02 = _mm256_setzero_ps(), s03 = _mm256_setzero_ps();
+				__m256 s10 = _mm256_setzero_ps(), s11 = _mm256_setzero_ps(), s12 = _mm256_setzero_ps(), s13 = _mm256_setzero_ps();
+				for (int k = 0; k < depthEnd; k += 8)
+				{
+					__m256 x0 = _mm256_loadu_ps(a0 + k);
+					__m256 x1 = _mm256_loadu_ps(a1 + k);
+					__m256 y = _mm256_loadu_ps(b0 + k);
+					s00 = MATRIX_FMADD(x0, y, s00);
+					s10 = MATRIX_FMADD(x1, y, s10);
+					y = _mm256_loadu_ps(b1 + k);
+					s01 = MATRIX_FMADD(x0, y, s01);
+					s11 = MATRIX_FMADD(x1, y, s11);
+					y = _mm256_loadu_ps(b2 + k);
+					s02 = MATRIX_FMADD(x0, y, s02);
+					s12 = MATRIX_FMADD(x1, y, s12);
+					y = _mm256_loadu_ps(b3 + k);
+					s03 = MATRIX_FMADD(x0, y, s03);
+					s13 = MATRIX_FMADD(x1, y, s13);
+				}
+
+				int remaining = LHSNumCols - depthEnd;
+				c0[col] = Matrix_HorizontalSum(s00) + Matrix_DotArray(a0 + depthEnd, b0 + depthEnd, remaining);
+				c0[col + 1] = Matrix_HorizontalSum(s01) + Matrix_DotArray(a0 + depthEnd, b1 + depthEnd, remaining);
+				c0[col + 2] = Matrix_HorizontalSum(s02) + Matrix_DotArray(a0 + depthEnd, b2 + depthEnd, remaining);
+				c0[col + 3] = Matrix_HorizontalSum(s03) + Matrix_DotArray(a0 + depthEnd, b3 + depthEnd, remaining);
+				c1[col] = Matrix_HorizontalSum(s10) + Matrix_DotArray(a1 + depthEnd, b0 + depthEnd, remaining);
+				c1[col + 1] = Matrix_HorizontalSum(s11) + Matrix_DotArray(a1 + depthEnd, b1 + depthEnd, remaining);
+				c1[col + 2] = Matrix_HorizontalSum(s12) + Matrix_DotArray(a1 + depthEnd, b2 + depthEnd, remaining);
+				c1[col + 3] = Matrix_HorizontalSum(s13) + Matrix_DotArray(a1 + depthEnd, b3 + depthEnd, remaining);
+			}
+			for (; col < blockEnd; col++)
+			{
+				c0[col] = Matrix_DotArray(a0, RHSTranspose + col * LHSNumCols, LHSNumCols);
+				c1[col] = Matrix_DotArray(a1, RHSTranspose + col * LHSNumCols, LHSNumCols);
+			}
+		}
+#endif
+		//The remaining rows, or every row without AVX2
+		for (; row < LHSNumRows; row++)
+		{
+			for (int col = block; col < blockEnd; col++)
+			{
+				destMatrix[row * RHSNumCols + col] = Matrix_DotArray(LHSMatrix + row * LHSNumCols, RHSTranspose + col * LHSNumCols, LHSNumCols);
+			}
+		}
+	}
+}
+//Checks for errors then calls Matrix_GetProductMatrixTransposeArray
+void Matrix_GetProductMatrixTranspose(Matrix* destMatrix, const Matrix* LHSMatrix, const Matrix* RHSTranspose)
+{
+	if (LHSMatrix->numColumns != RHSTranspose->numColumns)
+	{
+		printf("Matrix_GetProductMatrixTranspose Failed! LHSMatrix and RHSTranspose are not of compatible dimensions! Product not retrieved.\n");
+	}
+	else if (destMatrix->numRows != LHSMatrix->numRows || destMatrix->numColumns != RHSTranspose->numRows)
+	{
+		printf("Matrix_GetProductMatrixTranspose Failed! destMatrix is not of correct size for product. Product not retrieved.\n");
+	}
+	else
+	{
+		Matrix_GetProductMatrixTransposeArray(destMatrix->components, LHSMatrix->components, RHSTranspose->components, LHSMatrix->numRows, LHSMatrix->numColumns, RHSTranspose->numRows);
+	}
+}
+
 ///
 //Multiplies a matrix onto a vecor, transforming the Vector
 //
@@ -684,14 +1190,15 @@ void Matrix_GetProductMatrix(Matrix* destMatrix, const Matrix* LHSMatrix, const
 //	LHSNumCols: The number of rows in the Right Hand Side matrix
 void Matrix_TransformVectorArray(const float* LHSMatrix, float* RHSVector, const uint16_t LHSNumRows, const uint16_t LHSNumCols)
 {
-	//float RHSCopy[LHSNumCols];
-	float* RHSCopy = (float*)malloc(sizeof(float)* LHSNumCols);
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	float* RHSCopy = (float*)Arena_Push(scratch, sizeof(float) * LHSNumCols);
 
 	Vector_CopyArray(RHSCopy, RHSVector, LHSNumCols);
 
 	Matrix_GetProductVectorArray(RHSVector, LHSMatrix, RHSCopy, LHSNumRows, LHSNumCols);
 
-	free(RHSCopy);
+	Arena_ResetToMarker(scratch, marker);
 }
 //Checks for errors then calls Matrix_TransformVectorArray
 void Matrix_TransformVector(const Matrix* LHSMatrix, Vector* RHSVector)
@@ -711,7 +1218,9 @@ void Matrix_TransformVector(const Matrix* LHSMatrix, Vector* RHSVector)
 }
 
 ///
-//Gets the product of a matrix acting upon a Vector
+//Gets the product of a matrix acting upon a Vector.
+//With AVX2, four rows are dotted with the Vector at once so each part of the Vector is loaded once for all four.
+//The destination must not be the Vector operand.
 //
 //Parameters:
 //	destVector: The destination of the product Vector
@@ -721,13 +1230,36 @@ void Matrix_TransformVector(const Matrix* LHSMatrix, Vector* RHSVector)
 //	LHSNumCols: The number of columns in the LHS MatrixOperand
 void Matrix_GetProductVectorArray(float* destVector, const float* LHSMatrix, const float* RHSVector, const uint16_t LHSNumRows, const uint16_t LHSNumCols)
 {
-	for (int row = 0; row < LHSNumRows; row++)
+	int row = 0;
+#if defined(__AVX2__)
+	int depthEnd = LHSNumCols - LHSNumCols % 8;
+	for (; row + 4 <= LHSNumRows; row += 4)
 	{
-		destVector[row] = 0;
-		for (int col = 0; col < LHSNumCols; col++)
+		const float* a0 = LHSMatrix + row * LHSNumCols;
+		const float* a1 = a0 + LHSNumCols;
+		const float* a2 = a1 + LHSNumCols;
+		const float* a3 = a2 + LHSNumCols;
+
+		__m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps(), s2 = _mm256_setzero_ps(), s3 = _mm256_setzero_ps();
+		for (int k = 0; k < depthEnd; k += 8)
 		{
-			destVector[row] += Matrix_GetIndexArray(LHSMatrix, row, col, LHSNumCols) * RHSVector[col];
+			__m256 x = _mm256_loadu_ps(RHSVector + k);
+			s0 = MATRIX_FMADD(_mm256_loadu_ps(a0 + k), x, s0);
+			s1 = MATRIX_FMADD(_mm256_loadu_ps(a1 + k), x, s1);
+			s2 = MATRIX_FMADD(_mm256_loadu_ps(a2 + k), x, s2);
+			s3 = MATRIX_FMADD(_mm256_loadu_ps(a3 + k), x, s3);
 		}
+
+		int remaining = LHSNumCols - depthEnd;
+		destVector[row] = Matrix_HorizontalSum(s0) + Matrix_DotArray(a0 + depthEnd, RHSVector + depthEnd, remaining);
+		destVector[row + 1] = Matrix_HorizontalSum(s1) + Matrix_DotArray(a1 + depthEnd, RHSVector + depthEnd, remaining);
+		destVector[row + 2] = Matrix_HorizontalSum(s2) + Matrix_DotArray(a2 + depthEnd, RHSVector + depthEnd, remaining);
+		destVector[row + 3] = Matrix_HorizontalSum(s3) + Matrix_DotArray(a3 + depthEnd, RHSVector + depthEnd, remaining);
+	}
+#endif
+	for (; row < LHSNumRows; row++)
+	{
+		destVector[row] = Matrix_DotArray(LHSMatrix + row * LHSNumCols, RHSVector, LHSNumCols);
 	}
 }
 //Checks for errors then calls Matrix_GetPRoductVectorArray
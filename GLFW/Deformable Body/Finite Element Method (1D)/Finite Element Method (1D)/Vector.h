@@ -42,6 +42,8 @@ NGen by Nicholas Gallagher
 #include <stdarg.h>
 #include <stdint.h>
 
+#include "Arena.h"
+
 
 //Initializes a vector on the stack
 #define Vector_INIT_ON_STACK( vec , dim ) \
@@ -89,6 +91,16 @@ Vector* Vector_Allocate();
 //	vec: The Vector to initialize
 void Vector_Initialize(Vector* vec, uint16_t dim);
 
+///
+//Initializes a Vector with components taken from an arena, setting all components to 0.
+//The Vector must not be freed with Vector_Free; its components are released when the arena is reset.
+//
+//Parameters:
+//	vec: The Vector to initialize
+//	dim: The number of components the Vector has
+//	arena: The arena to take the components from
+void Vector_InitializeFromArena(Vector* vec, uint16_t dim, Arena* arena);
+
 ///
 //Frees the memory taken by a Vector
 //
@@ -30,11 +30,35 @@ algorithm used to take a complex problem and model it with a system of small sim
 to approximate a solution.
 
 Because of the given limitations of this example, we are able to pre-compute
-most of the information needed at the startup of the program (notice the long startup time).
+most of the information needed at the startup of the program. The bounded stiffness matrix is inverted
+with an LU decomposition instead of a cofactor expansion, whose cost grew factorially with the number of nodes.
+The dense inverse still takes O(n^3) time, so with the dense solver startup grows with the cube of the beam's length.
 This means each physics timestep we simply solve a system of equations using the pre-computed information
 and interpolate each nodes position using harmonic oscillation equations to simulate
 the deformation of the body to an equilibrium state after external forces are applied.
 
+The stiffness matrix of a 1D beam is tridiagonal, so the dense inverse wastes O(n^2) memory and O(n^2) time each
+timestep multiplying mostly zeros. The solver chosen in main can avoid this:
+The banded solver stores the bounded stiffness matrix as a banded matrix and factors it with a banded Cholesky
+decomposition (the Thomas algorithm for a tridiagonal matrix), and each timestep solves for the displacements with
+the factorization in O(n) time and memory.
+The sparse solver assembles the stiffness matrix from triplets into a compressed sparse row matrix, the way a 2D or 3D
+mesh would be assembled, and each timestep solves for the displacements with conjugate gradients preconditioned by an
+incomplete Cholesky factorization. For the beam the factorization is exact, so it converges in a single iteration.
+Both let the beam be made from a couple thousand nodes (try raising subX in main). Past that the stiffness matrix,
+whose condition number grows with the square of the number of nodes, is too poorly conditioned to solve with floats.
+
+Inverting or factoring the bounded stiffness matrix is the slowest part of starting up, so the result is saved to
+BeamPrecompute.cache (see PrecomputeCache.h). The file is keyed by a hash of the positions of the nodes, the young's
+modulus, the anchored node and the solver, and when the demo starts with the same inputs it maps the file into memory
+and uses the matrices in it where they are instead of computing them again. Changing any of the inputs computes the
+matrices again and replaces the file. With the dense solver and a beam of a couple thousand nodes this takes startup
+from seconds to under a millisecond.
+
+The vectors each timestep needs are taken from an arena (see Arena.h) which is reset at the end of the timestep, and
+the solvers take their temporaries from the scratch arena of the Matrix library, so after the first timestep the
+simulation does not allocate any memory.
+
 The user can apply forces to the right end of the beam.
 Hold the left mouse button to apply a force along the positive X axis.
 Hold the right mouse button to apply a force along the negative X axis.
@@ -47,6 +71,9 @@ Base by Srinivasan Thiagarajan
 
 #include "GLIncludes.h"
 #include "Matrix.h"
+#include "BandedMatrix.h"
+#include "SparseMatrix.h"
+#include "PrecomputeCache.h"
 
 #define PI 3.14159f
 
@@ -175,6 +202,14 @@ struct Mesh
 	}
 };
 
+//The ways a softbody can solve for the displacements of its nodes
+enum StiffnessSolver
+{
+	SOLVER_DENSE_INVERSE,				//Multiply the forces by the inverse of the bounded stiffness matrix
+	SOLVER_BANDED_CHOLESKY,				//Solve with a banded Cholesky factorization of the bounded stiffness matrix
+	SOLVER_SPARSE_CONJUGATE_GRADIENT	//Solve the sparse bounded stiffness matrix with preconditioned conjugate gradients
+};
+
 //A struct for 1D FEM deformable solid body
 struct SoftBody
 {
@@ -202,7 +237,17 @@ struct SoftBody
 	float* deformationTimer;//Time since the object began deforming
 
 
-	Matrix* boundedInverseMatrix;
+	Matrix* boundedInverseMatrix;				//Inverse of the bounded stiffness matrix, when using the dense solver
+	BandedMatrix* boundedStiffnessFactor;		//Cholesky factorization of the bounded stiffness matrix, when using the banded solver
+	SparseMatrix* boundedStiffnessMatrix;		//Bounded stiffness matrix, when using the sparse solver
+	SparseMatrix* boundedStiffnessPreconditioner;//Incomplete Cholesky factorization of the bounded stiffness matrix, when using the sparse solver
+
+	//When the matrices above were mapped from a cache file, they are these views of the arrays in it and are not freed
+	PrecomputeCache* cache;
+	Matrix cachedInverseMatrix;
+	BandedMatrix cachedStiffnessFactor;
+	SparseMatrix cachedStiffnessMatrix;
+	SparseMatrix cachedStiffnessPreconditioner;
 
 
 	//Default constructor.. Do not use.
@@ -219,7 +264,9 @@ struct SoftBody
 	//	youngsMod: The young's modulus of the material which the solid is made from
 	//	tMass: The total mass of the solid
 	//	boundaryNode: The node which is fixed in place as a boundary condition
-	SoftBody::SoftBody(const Mesh& m, int nNodes, float youngsMod, float tMass, int boundaryNode)
+	//	solver: How to solve for the displacements of the nodes
+	//	cacheFileName: The file to map the precomputed matrices from and save them to, or NULL to always compute them
+	SoftBody::SoftBody(const Mesh& m, int nNodes, float youngsMod, float tMass, int boundaryNode, StiffnessSolver solver, const char* cacheFileName)
 	{
 		//Set the number Finite Element Model properties
 		numNodes = nNodes;
@@ -262,6 +309,25 @@ struct SoftBody
 			deformationTimer[i] = 0.0f;
 		}
 
+		//The bounded stiffness matrices computed below only depend on the positions of the nodes, the young's modulus,
+		//the anchored node and the solver, so if an earlier run with the same inputs saved them they are mapped from the cache.
+		boundedInverseMatrix = 0x0;
+		boundedStiffnessFactor = 0x0;
+		boundedStiffnessMatrix = 0x0;
+		boundedStiffnessPreconditioner = 0x0;
+		cache = 0x0;
+
+		int solverIndex = solver;
+		uint64_t key = PrecomputeCache_Hash(PRECOMPUTECACHE_HASH_SEED, &numNodes, sizeof(int));
+		key = PrecomputeCache_Hash(key, &anchoredNode, sizeof(int));
+		key = PrecomputeCache_Hash(key, &youngsModulus, sizeof(float));
+		key = PrecomputeCache_Hash(key, &solverIndex, sizeof(int));
+		key = PrecomputeCache_Hash(key, initDisp, sizeof(float) * numNodes);
+		if(cacheFileName && !LoadCache(cacheFileName, key, solver))
+		{
+			printf("Computing the bounded stiffness matrix...\n");
+		}
+
 		//Calculate indices in the global stiffness matrix
 		//The global stiffness matrix will look like this:
 		//
@@ -300,11 +366,40 @@ struct SoftBody
 		//	F = -(Kij) * X
 		//Properly solving for the forces on the first node due to its displacement from the second node.
 		//Each subsequent row will fulfill the same requirement.
-		Matrix* globalStiffnessMatrix = Matrix_Allocate();
-		Matrix_Initialize(globalStiffnessMatrix, numNodes, numNodes);
+		//
+		//Every component more than one row away from the diagonal is 0, so the banded solver only stores the diagonal
+		//and the band of width 1 below it, and the sparse solver only stores the nonzero components.
+		//
+		//The banded and sparse solvers number the nodes backwards, starting from the free end of the beam. Factoring from the
+		//free end, every pivot comes out as the stiffness of a single element. Factoring from the anchored end, the pivots approach
+		//each other as the beam gets longer and the last one is lost to rounding error once the beam has a few thousand nodes.
+		Matrix* globalStiffnessMatrix = 0x0;
+		BandedMatrix* bandedStiffnessMatrix = 0x0;
+		SparseMatrix* sparseStiffnessMatrix = 0x0;
+		if(cache)
+		{
+			//The bounded stiffness matrices were mapped from the cache, only the harmonic oscillators are computed below
+		}
+		else if(solver == SOLVER_BANDED_CHOLESKY)
+		{
+			//Starts at Zero matrix
+			bandedStiffnessMatrix = BandedMatrix_Allocate();
+			BandedMatrix_Initialize(bandedStiffnessMatrix, numNodes, 1);
+		}
+		else if(solver == SOLVER_SPARSE_CONJUGATE_GRADIENT)
+		{
+			//Starts with no nonzero components
+			sparseStiffnessMatrix = SparseMatrix_Allocate();
+			SparseMatrix_Initialize(sparseStiffnessMatrix, numNodes, numNodes);
+		}
+		else
+		{
+			globalStiffnessMatrix = Matrix_Allocate();
+			Matrix_Initialize(globalStiffnessMatrix, numNodes, numNodes);
 
-		//Start at Zero matrix
-		Matrix_Scale(globalStiffnessMatrix, 0.0f);
+			//Start at Zero matrix
+			Matrix_Scale(globalStiffnessMatrix, 0.0f);
+		}
 
 		//For each node
 		for(int i = 0; i < numNodes - 1; i++)
@@ -325,11 +420,32 @@ struct SoftBody
 			//MaxT = PI/(2w)
 			deformationTime[i] = PI/(2.0f * angularFrequency[i]);
 
+			if(cache) continue;
+
 			//Set the ith element's values in the global stiffness matrix
-			*Matrix_Index(globalStiffnessMatrix, i, i) += k;
-			*Matrix_Index(globalStiffnessMatrix, i, i+1) -= k;
-			*Matrix_Index(globalStiffnessMatrix, i+1, i) -= k;
-			*Matrix_Index(globalStiffnessMatrix, i+1, i+1) += k;
+			int row = numNodes - 1 - i;
+			if(solver == SOLVER_BANDED_CHOLESKY)
+			{
+				//K(i, i+1) and K(i+1, i) are stored as the same component
+				*BandedMatrix_Index(bandedStiffnessMatrix, row, row) += k;
+				*BandedMatrix_Index(bandedStiffnessMatrix, row, row-1) -= k;
+				*BandedMatrix_Index(bandedStiffnessMatrix, row-1, row-1) += k;
+			}
+			else if(solver == SOLVER_SPARSE_CONJUGATE_GRADIENT)
+			{
+				//Each node is in two elements, so its diagonal component is added twice and summed when the matrix is compressed
+				SparseMatrix_AddTriplet(sparseStiffnessMatrix, row, row, k);
+				SparseMatrix_AddTriplet(sparseStiffnessMatrix, row, row-1, -k);
+				SparseMatrix_AddTriplet(sparseStiffnessMatrix, row-1, row, -k);
+				SparseMatrix_AddTriplet(sparseStiffnessMatrix, row-1, row-1, k);
+			}
+			else
+			{
+				*Matrix_Index(globalStiffnessMatrix, i, i) += k;
+				*Matrix_Index(globalStiffnessMatrix, i, i+1) -= k;
+				*Matrix_Index(globalStiffnessMatrix, i+1, i) -= k;
+				*Matrix_Index(globalStiffnessMatrix, i+1, i+1) += k;
+			}
 		}
 
 		//Unfortunately, the global stiffness matrix is an indeterminant matrix (Det(Global stiffness Matrix) = 0)
@@ -366,23 +482,187 @@ struct SoftBody
 		//Now we can create a bounded stiffness matrix with 1 less row and column of our global stiffness matrix
 		//And we can pull out the row and column corresponding to the node with the boundary condition.
 		//The significance of this matrix is that it now has a non-zero determinant which means it's inverse exists.
-		//Create the bounded stiffness matrix
-		Matrix* boundedStiffnessMatrix = Matrix_Allocate();
-		Matrix_Initialize(boundedStiffnessMatrix, numNodes - 1, numNodes - 1);
-		
-		//Apply the boundary condition & get the bounded stiffness matrix
-		Matrix_GetMinor(boundedStiffnessMatrix, globalStiffnessMatrix, anchoredNode, anchoredNode);
-
-		//In our equation we are not going to be solving for the forces, we want to solve for the resulting displacements of all
-		//nodes because of a force applied on a single node. To do this we need the inverse of our bounded stiffness matrix.
-		//Determine the inverse of the bounded stiffness matrix
-		boundedInverseMatrix = Matrix_Allocate();
-		Matrix_Initialize(boundedInverseMatrix, numNodes - 1, numNodes - 1);
-		Matrix_GetInverse(boundedInverseMatrix, boundedStiffnessMatrix);
-
-		Matrix_Free(globalStiffnessMatrix);
-		Matrix_Free(boundedStiffnessMatrix);
+		if(cache) return;
+
+		int precomputed = 1;
+		if(solver == SOLVER_BANDED_CHOLESKY)
+		{
+			//Removing the row and column of the anchored node keeps the matrix tridiagonal
+			boundedStiffnessFactor = BandedMatrix_Allocate();
+			BandedMatrix_Initialize(boundedStiffnessFactor, numNodes - 1, 1);
+			BandedMatrix_GetMinor(boundedStiffnessFactor, bandedStiffnessMatrix, numNodes - 1 - anchoredNode);
+
+			//Rather than inverting the bounded stiffness matrix, which would fill in every component, we factor it into
+			//L * transpose(L) where L has the same band. Each timestep then solves for the displacements with two passes
+			//over L. The bounded stiffness matrix is symmetric positive definite, so the factorization always exists.
+			if(!BandedMatrix_CholeskyDecompose(boundedStiffnessFactor))
+			{
+				printf("SoftBody failed! Bounded stiffness matrix is not positive definite!\n");
+				precomputed = 0;
+			}
+
+			BandedMatrix_Free(bandedStiffnessMatrix);
+		}
+		else if(solver == SOLVER_SPARSE_CONJUGATE_GRADIENT)
+		{
+			SparseMatrix_Compress(sparseStiffnessMatrix);
+
+			boundedStiffnessMatrix = SparseMatrix_Allocate();
+			SparseMatrix_Initialize(boundedStiffnessMatrix, numNodes - 1, numNodes - 1);
+			SparseMatrix_GetMinor(boundedStiffnessMatrix, sparseStiffnessMatrix, numNodes - 1 - anchoredNode, numNodes - 1 - anchoredNode);
+
+			//The preconditioner is factored once here and reused by every solve
+			boundedStiffnessPreconditioner = SparseMatrix_Allocate();
+			SparseMatrix_Initialize(boundedStiffnessPreconditioner, numNodes - 1, numNodes - 1);
+			if(!SparseMatrix_IncompleteCholesky(boundedStiffnessPreconditioner, boundedStiffnessMatrix))
+			{
+				printf("SoftBody failed! Bounded stiffness matrix is not positive definite, solving without a preconditioner!\n");
+				SparseMatrix_Free(boundedStiffnessPreconditioner);
+				boundedStiffnessPreconditioner = 0x0;
+				precomputed = 0;
+			}
+
+			SparseMatrix_Free(sparseStiffnessMatrix);
+		}
+		else
+		{
+			//Create the bounded stiffness matrix
+			Matrix* boundedStiffnessMatrix = Matrix_Allocate();
+			Matrix_Initialize(boundedStiffnessMatrix, numNodes - 1, numNodes - 1);
+
+			//Apply the boundary condition & get the bounded stiffness matrix
+			Matrix_GetMinor(boundedStiffnessMatrix, globalStiffnessMatrix, anchoredNode, anchoredNode);
+
+			//In our equation we are not going to be solving for the forces, we want to solve for the resulting displacements of all
+			//nodes because of a force applied on a single node. To do this we need the inverse of our bounded stiffness matrix.
+			//Determine the inverse of the bounded stiffness matrix
+			boundedInverseMatrix = Matrix_Allocate();
+			Matrix_Initialize(boundedInverseMatrix, numNodes - 1, numNodes - 1);
+			Matrix_GetInverse(boundedInverseMatrix, boundedStiffnessMatrix);
+
+			Matrix_Free(globalStiffnessMatrix);
+			Matrix_Free(boundedStiffnessMatrix);
+		}
+
+		//Only a successful factorization is worth loading next time
+		if(cacheFileName && precomputed)
+		{
+			SaveCache(cacheFileName, key, solver);
+		}
+	}
+
+	///
+	//Points a sparse matrix at three arrays of the cache: its row starts, columns and values
+	//
+	//Parameters:
+	//	mat: The sparse matrix to point at the arrays
+	//	first: The index of the first of the three arrays in the cache
+	//
+	//Returns:
+	//	0 if the arrays are not the sizes of a sparse bounded stiffness matrix, 1 otherwise
+	int SoftBody::MapSparseMatrix(SparseMatrix* mat, int first)
+	{
+		uint32_t dimension = numNodes - 1;
+		if(cache->sizes[first] != sizeof(uint32_t) * (dimension + 1)) return 0;
+
+		mat->numRows = mat->numColumns = dimension;
+		mat->numTriplets = mat->tripletCapacity = 0;
+		mat->tripletRows = mat->tripletColumns = 0x0;
+		mat->tripletValues = 0x0;
+		mat->rowStart = (uint32_t*)cache->arrays[first];
+		mat->numNonzeros = mat->rowStart[dimension];
+		mat->columns = (uint32_t*)cache->arrays[first + 1];
+		mat->values = (float*)cache->arrays[first + 2];
+		return cache->sizes[first + 1] == sizeof(uint32_t) * mat->numNonzeros && cache->sizes[first + 2] == sizeof(float) * mat->numNonzeros;
+	}
 
+	///
+	//Maps the bounded stiffness matrices the solver uses from a cache file, leaving them unset if the file is missing or out of date
+	//
+	//Parameters:
+	//	fileName: The cache file to map
+	//	key: The hash of the inputs the matrices are computed from
+	//	solver: How the softbody solves for the displacements of its nodes
+	//
+	//Returns:
+	//	0 if the matrices could not be mapped, 1 otherwise
+	int SoftBody::LoadCache(const char* fileName, uint64_t key, StiffnessSolver solver)
+	{
+		uint32_t dimension = numNodes - 1;
+		cache = PrecomputeCache_Allocate();
+		int loaded = 0;
+		if(solver == SOLVER_BANDED_CHOLESKY)
+		{
+			if(PrecomputeCache_Load(cache, fileName, key, 1) && cache->sizes[0] == sizeof(float) * 2 * dimension)
+			{
+				cachedStiffnessFactor.dimension = dimension;
+				cachedStiffnessFactor.bandwidth = 1;
+				cachedStiffnessFactor.components = (float*)cache->arrays[0];
+				boundedStiffnessFactor = &cachedStiffnessFactor;
+				loaded = 1;
+			}
+		}
+		else if(solver == SOLVER_SPARSE_CONJUGATE_GRADIENT)
+		{
+			if(PrecomputeCache_Load(cache, fileName, key, 6) && MapSparseMatrix(&cachedStiffnessMatrix, 0) && MapSparseMatrix(&cachedStiffnessPreconditioner, 3))
+			{
+				boundedStiffnessMatrix = &cachedStiffnessMatrix;
+				boundedStiffnessPreconditioner = &cachedStiffnessPreconditioner;
+				loaded = 1;
+			}
+		}
+		else
+		{
+			if(PrecomputeCache_Load(cache, fileName, key, 1) && cache->sizes[0] == sizeof(float) * dimension * dimension)
+			{
+				cachedInverseMatrix.numRows = cachedInverseMatrix.numColumns = dimension;
+				cachedInverseMatrix.components = (float*)cache->arrays[0];
+				boundedInverseMatrix = &cachedInverseMatrix;
+				loaded = 1;
+			}
+		}
+
+		if(!loaded)
+		{
+			PrecomputeCache_Free(cache);
+			cache = 0x0;
+		}
+		return loaded;
+	}
+
+	///
+	//Saves the bounded stiffness matrices the solver uses to a cache file
+	//
+	//Parameters:
+	//	fileName: The cache file to write
+	//	key: The hash of the inputs the matrices were computed from
+	//	solver: How the softbody solves for the displacements of its nodes
+	void SoftBody::SaveCache(const char* fileName, uint64_t key, StiffnessSolver solver)
+	{
+		uint32_t dimension = numNodes - 1;
+		if(solver == SOLVER_BANDED_CHOLESKY)
+		{
+			const void* arrays[] = { boundedStiffnessFactor->components };
+			size_t sizes[] = { sizeof(float) * 2 * dimension };
+			PrecomputeCache_Save(fileName, key, 1, arrays, sizes);
+		}
+		else if(solver == SOLVER_SPARSE_CONJUGATE_GRADIENT)
+		{
+			const SparseMatrix* mat = boundedStiffnessMatrix;
+			const SparseMatrix* pre = boundedStiffnessPreconditioner;
+			const void* arrays[] = { mat->rowStart, mat->columns, mat->values, pre->rowStart, pre->columns, pre->values };
+			size_t sizes[] = {
+				sizeof(uint32_t) * (dimension + 1), sizeof(uint32_t) * mat->numNonzeros, sizeof(float) * mat->numNonzeros,
+				sizeof(uint32_t) * (dimension + 1), sizeof(uint32_t) * pre->numNonzeros, sizeof(float) * pre->numNonzeros
+			};
+			PrecomputeCache_Save(fileName, key, 6, arrays, sizes);
+		}
+		else
+		{
+			const void* arrays[] = { boundedInverseMatrix->components };
+			size_t sizes[] = { sizeof(float) * dimension * dimension };
+			PrecomputeCache_Save(fileName, key, 1, arrays, sizes);
+		}
 	}
 
 	SoftBody::~SoftBody()
@@ -402,7 +682,15 @@ struct SoftBody
 
 		delete[] angularFrequency;
 
-		Matrix_Free(boundedInverseMatrix);
+		if(cache)
+		{
+			PrecomputeCache_Free(cache);
+			return;
+		}
+		if(boundedInverseMatrix) Matrix_Free(boundedInverseMatrix);
+		if(boundedStiffnessFactor) BandedMatrix_Free(boundedStiffnessFactor);
+		if(boundedStiffnessMatrix) SparseMatrix_Free(boundedStiffnessMatrix);
+		if(boundedStiffnessPreconditioner) SparseMatrix_Free(boundedStiffnessPreconditioner);
 	}
 };
 
@@ -410,6 +698,9 @@ struct Mesh* lattice;
 
 struct SoftBody* body;
 
+// The memory update uses each physics step, released at the end of the step
+Arena* frameArena;
+
 double time = 0.0;
 double timebase = 0.0;
 double accumulator = 0.0;
@@ -524,9 +815,13 @@ void update(float dt)
 		*(externalForce.components) = -5.0f;
 	}
 
+	//The vectors of this step are taken from the frame arena, so stepping does not allocate memory
+	ArenaMarker frame = Arena_GetMarker(frameArena);
+
 	//Step 1: Construct the nodal displacement vector
-	Vector* nodalDisp = Vector_Allocate();
-	Vector_Initialize(nodalDisp, body->numNodes - 1);
+	Vector nodalDispVector;
+	Vector* nodalDisp = &nodalDispVector;
+	Vector_InitializeFromArena(nodalDisp, body->numNodes - 1, frameArena);
 
 	int node = 0;
 	for(int i = 0; i < body->numNodes; i++)
@@ -539,13 +834,47 @@ void update(float dt)
 	}
 
 	//Step 2: Construct the global forces vector
-	Vector* forces = Vector_Allocate();
-	Vector_Initialize(forces, body->numNodes - 1);
+	Vector forcesVector;
+	Vector* forces = &forcesVector;
+	Vector_InitializeFromArena(forces, body->numNodes - 1, frameArena);
 
 	forces->components[body->numNodes - 2] = *(externalForce.components);
 
 	//Step 3: Calculate the nodal displacement vector to achieve these forces
-	Matrix_GetProductVector(nodalDisp, body->boundedInverseMatrix, forces);
+	if(body->boundedInverseMatrix)
+	{
+		Matrix_GetProductVector(nodalDisp, body->boundedInverseMatrix, forces);
+	}
+	else
+	{
+		//Solve K * d = F, with the nodes numbered backwards as in the banded and sparse stiffness matrices
+		int last = body->numNodes - 2;
+		for(int i = 0; i < last - i; i++)
+		{
+			float temp = forces->components[i];
+			forces->components[i] = forces->components[last - i];
+			forces->components[last - i] = temp;
+		}
+
+		if(body->boundedStiffnessFactor)
+		{
+			Vector_Copy(nodalDisp, forces);
+			BandedMatrix_CholeskySolve(nodalDisp, body->boundedStiffnessFactor);
+		}
+		else
+		{
+			Vector_ZeroArray(nodalDisp->components, nodalDisp->dimension);
+			SparseMatrix_SolveConjugateGradient(nodalDisp->components, body->boundedStiffnessMatrix, body->boundedStiffnessPreconditioner,
+				forces->components, body->numNodes - 1, 0.00001f);
+		}
+
+		for(int i = 0; i < last - i; i++)
+		{
+			float temp = nodalDisp->components[i];
+			nodalDisp->components[i] = nodalDisp->components[last - i];
+			nodalDisp->components[last - i] = temp;
+		}
+	}
 
 	//Step 4: save final position
 	node = 0;
@@ -574,9 +903,8 @@ void update(float dt)
 		}
 	}
 
-	//Step 6: Free memory
-	Vector_Free(nodalDisp);
-	Vector_Free(forces);
+	//Step 6: Release this step's memory
+	Arena_ResetToMarker(frameArena, frame);
 }
 
 // This runs once every frame to determine the FPS and how often to call update based on the physics step.
@@ -650,7 +978,10 @@ void main()
 	// Initializes most things needed before the main loop
 	init();
 
+	//Number of nodes in the beam, the banded and sparse solvers can handle a couple thousand
 	const int subX = 9;
+	//How the softbody solves for the displacements of its nodes
+	const StiffnessSolver solver = SOLVER_BANDED_CHOLESKY;
 
 	//Generate the element mesh
 	float latticeArr[subX * (sizeof(struct Vertex) / sizeof(float))];
@@ -692,7 +1023,11 @@ void main()
 	float damp = 0.75f;
 
 	//Generate the softbody
-	body = new SoftBody(*lattice, subX, coeff, 100.0f, 0);
+	body = new SoftBody(*lattice, subX, coeff, 100.0f, 0, solver, "BeamPrecompute.cache");
+
+	//Make the frame arena large enough for the two vectors update uses
+	frameArena = Arena_Allocate();
+	Arena_Initialize(frameArena, 2 * (sizeof(float) * body->numNodes + ARENA_ALIGNMENT));
 
 	//Print controls
 	printf("Controls:\nPress and hold the left mouse button to apply a positive constant force\n on the right-most node.\n");
@@ -724,6 +1059,7 @@ void main()
 
 	delete lattice;
 	delete body;
+	Arena_Free(frameArena);
 
 
 	// Frees up GLFW memory
@@ -0,0 +1,242 @@
+/*
+Title: FEM Benchmark
+File Name: main.cpp
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This program steps the corotational beam of the Finite Element Method (3D) demo without a window, at sizes from
+about two thousand up to thirty thousand tetrahedra. The beam is always 2 units long with a square cross section a
+fifth of its length, fixed at its left end, and is left to sag under its own weight for a number of steps.
+
+Every beam is stepped two ways:
+
+	- pcg: each step solves the rotated system with conjugate gradients preconditioned by the factorization of the
+	  system with no rotations, until the residual is a thousandth of the right hand side
+	- single: each step takes a single back substitution with the factorization, leaving the rotations out of the
+	  implicit part of the step
+
+Every row reports the number of tetrahedra and nodes, the time taken to precompute the element stiffness matrices
+and factor the system matrix, how many nonzero components the factor has, the average time of a step, the average
+number of conjugate gradient iterations a step took, and how far the tip of the beam has fallen after the last step.
+The beams are still swinging after the last step, and the single back substitution damps the swing less, so the two
+ways leave the tip at different points of its swing.
+
+Every beam is then reduced to its 16 lowest vibration modes, as the modal body of the demo is. A second table
+reports the time taken to find the modes with subspace iteration and how many iterations it took, the time taken to
+save them to a file and to map the file back into memory, the average time of a step of each of 500 modal bodies
+sharing the mapped modes while a force pushes on their tips, the time taken to compute the positions of every node
+of one body, and the frequency of the lowest mode in Hz. The step time stays the same as the beam gets larger; only
+computing the positions, which is only needed to draw a body, grows with it.
+
+It takes two optional arguments: the file to write the CSV to, and the file to write the CSV of the modal bodies
+to. Run it with Release settings.
+
+References:
+Real-Time Physics by Matthias Muller et al., Chapter 3 (corotational FEM)
+Direct Methods for Sparse Linear Systems by Timothy A. Davis
+Interactive Deformation Using Modal Analysis with Constraints by Hauser, Shen and O'Brien
+*/
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <chrono>
+#endif
+
+#include "ModalBody.h"
+
+// The number of steps each beam is timed for
+#define NUM_STEPS 100
+
+// The number of modes each modal body keeps, and the number of modal bodies stepped together
+#define NUM_MODES 16
+#define NUM_MODAL_BODIES 500
+
+// The standard clocks in Visual Studio 2013 only tick once a millisecond, so the performance counter is used there
+double GetSeconds()
+{
+#ifdef _WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+	const char* fileName = argc > 1 ? argv[1] : "FEMBenchmark.csv";
+	const char* modalFileName = argc > 2 ? argv[2] : "FEMModalBenchmark.csv";
+
+	FILE* file = fopen(fileName, "w");
+	if (file == 0)
+	{
+		printf("Could not open %s for writing!\n", fileName);
+		return 1;
+	}
+	FILE* modalFile = fopen(modalFileName, "w");
+	if (modalFile == 0)
+	{
+		printf("Could not open %s for writing!\n", modalFileName);
+		fclose(file);
+		return 1;
+	}
+
+	FILE* outputs[2] = { stdout, file };
+	for (int o = 0; o < 2; ++o)
+	{
+		fprintf(outputs[o], "tetrahedra,nodes,solve,ms_initialize,factor_nonzeros,ms_step,iterations_per_step,tip_displacement\n");
+	}
+	fprintf(modalFile, "tetrahedra,nodes,modes,ms_compute,subspace_iterations,ms_save,ms_map,bodies,us_step_per_body,ms_positions,lowest_frequency_hz\n");
+
+	// Cubes along the length of the beam, each split into 6 tetrahedra
+	const uint32_t lengths[] = { 20, 35, 50 };
+	const char* names[] = { "pcg", "single" };
+	const uint32_t maxIterations[] = { 50, 1 };
+
+	for (int size = 0; size < 3; ++size)
+	{
+		uint32_t cellsX = lengths[size];
+		uint32_t cellsY = cellsX / 5;
+		float cellSize = 2.0f / cellsX;
+
+		TetrahedralMesh* mesh = TetrahedralMesh_Allocate();
+		TetrahedralMesh_InitializeBox(mesh, cellsX, cellsY, cellsY, cellSize);
+
+		// Fix the left end, and watch the node at the top of the right end
+		uint8_t* fixed = (uint8_t*)malloc(mesh->numNodes);
+		uint32_t tip = 0;
+		for (uint32_t i = 0; i < mesh->numNodes; ++i)
+		{
+			const float* position = mesh->positions + 3 * i;
+			fixed[i] = position[0] < 0.5f * cellSize;
+			if (position[0] > 2.0f - 0.5f * cellSize && position[1] > cellsY * cellSize - 0.5f * cellSize) tip = i;
+		}
+
+		for (int solve = 0; solve < 2; ++solve)
+		{
+			double start = GetSeconds();
+			CorotationalBody* body = CorotationalBody_Allocate();
+			CorotationalBody_Initialize(body, mesh, fixed, 5000000.0f, 0.3f, 1000.0f, 0.012f);
+			double initializeSeconds = GetSeconds() - start;
+			body->maxIterations = maxIterations[solve];
+
+			uint32_t iterations = 0;
+			start = GetSeconds();
+			for (int step = 0; step < NUM_STEPS; ++step)
+			{
+				CorotationalBody_Step(body);
+				iterations += body->iterations;
+			}
+			double stepSeconds = (GetSeconds() - start) / NUM_STEPS;
+
+			float tipDisplacement = body->positions[3 * tip + 1] - body->restPositions[3 * tip + 1];
+			for (int o = 0; o < 2; ++o)
+			{
+				fprintf(outputs[o], "%u,%u,%s,%.1f,%u,%.3f,%.2f,%.4f\n",
+					mesh->numTetrahedra, mesh->numNodes, names[solve], initializeSeconds * 1000.0, body->factor->numNonzeros,
+					stepSeconds * 1000.0, (double)iterations / NUM_STEPS, tipDisplacement);
+				fflush(outputs[o]);
+			}
+
+			CorotationalBody_Free(body);
+		}
+
+		// Find the modes of the same beam, save them, and map them back in as a game would when it loads
+		CorotationalBody* body = CorotationalBody_Allocate();
+		CorotationalBody_Initialize(body, mesh, fixed, 5000000.0f, 0.3f, 1000.0f, 0.012f);
+
+		double start = GetSeconds();
+		ModalBasis* computed = ModalBasis_Allocate();
+		uint32_t subspaceIterations = ModalBasis_Compute(computed, body, NUM_MODES, 0.0001f);
+		double computeSeconds = GetSeconds() - start;
+
+		start = GetSeconds();
+		ModalBasis_Save(computed, "FEMBenchmark.modes");
+		double saveSeconds = GetSeconds() - start;
+		ModalBasis_Free(computed);
+
+		//Hashing the body is not part of mapping the file in, so it is left out of the timing
+		uint64_t key = ModalBasis_GetKey(body, NUM_MODES, 0.0001f);
+		start = GetSeconds();
+		ModalBasis* basis = ModalBasis_Allocate();
+		if (!ModalBasis_Load(basis, "FEMBenchmark.modes", key))
+		{
+			printf("Could not map FEMBenchmark.modes!\n");
+			return 1;
+		}
+		double mapSeconds = GetSeconds() - start;
+
+		ModalBody** bodies = (ModalBody**)malloc(NUM_MODAL_BODIES * sizeof(ModalBody*));
+		for (int b = 0; b < NUM_MODAL_BODIES; ++b)
+		{
+			bodies[b] = ModalBody_Allocate();
+			ModalBody_Initialize(bodies[b], basis, body->gravity, 0.012f);
+		}
+
+		// Every body is pushed at its tip by a slightly different force, as if each were hit by something different
+		start = GetSeconds();
+		for (int step = 0; step < NUM_STEPS; ++step)
+		{
+			for (int b = 0; b < NUM_MODAL_BODIES; ++b)
+			{
+				float force[3] = { 0.0f, 0.0f, (float)(b % 10) };
+				ModalBody_ClearForces(bodies[b]);
+				ModalBody_ApplyForce(bodies[b], tip, force);
+				ModalBody_Step(bodies[b]);
+			}
+		}
+		double modalStepSeconds = (GetSeconds() - start) / ((double)NUM_STEPS * NUM_MODAL_BODIES);
+
+		float* positions = (float*)malloc(3 * mesh->numNodes * sizeof(float));
+		start = GetSeconds();
+		for (int step = 0; step < NUM_STEPS; ++step)
+		{
+			ModalBody_GetPositions(positions, bodies[step % NUM_MODAL_BODIES]);
+		}
+		double positionsSeconds = (GetSeconds() - start) / NUM_STEPS;
+
+		double lowestFrequency = sqrt((double)basis->eigenvalues[0]) / (2.0 * 3.14159265358979);
+		fprintf(modalFile, "%u,%u,%u,%.1f,%u,%.2f,%.3f,%u,%.3f,%.3f,%.3f\n",
+			mesh->numTetrahedra, mesh->numNodes, basis->numModes, computeSeconds * 1000.0, subspaceIterations, saveSeconds * 1000.0,
+			mapSeconds * 1000.0, NUM_MODAL_BODIES, modalStepSeconds * 1000000.0, positionsSeconds * 1000.0, lowestFrequency);
+		fflush(modalFile);
+		printf("%u tetrahedra: %u modes in %.1f ms (%u iterations), %.3f us per modal body step, lowest mode %.3f Hz\n",
+			mesh->numTetrahedra, basis->numModes, computeSeconds * 1000.0, subspaceIterations, modalStepSeconds * 1000000.0, lowestFrequency);
+
+		free(positions);
+		for (int b = 0; b < NUM_MODAL_BODIES; ++b)
+		{
+			ModalBody_Free(bodies[b]);
+		}
+		free(bodies);
+		ModalBasis_Free(basis);
+		CorotationalBody_Free(body);
+
+		free(fixed);
+		TetrahedralMesh_Free(mesh);
+	}
+
+	fclose(modalFile);
+	fclose(file);
+	return 0;
+}
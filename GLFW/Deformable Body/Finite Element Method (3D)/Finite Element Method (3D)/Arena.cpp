@@ -0,0 +1,194 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "Arena.h"
+
+//The arena shared by the Vector and Matrix libraries
+static Arena Arena_scratch = { 0x0, 0x0, ARENA_DEFAULT_BLOCK_SIZE };
+
+///
+//Allocates a block for an arena, with room for the header and padding to align the first push
+//
+//Parameters:
+//	capacity: The number of bytes the block can hold
+static ArenaBlock* Arena_AllocateBlock(const size_t capacity)
+{
+	ArenaBlock* block = (ArenaBlock*)malloc(sizeof(ArenaBlock) + capacity);
+	if (block == 0x0)
+	{
+		printf("Arena_AllocateBlock failed! Could not allocate %lu bytes!\n", (unsigned long)capacity);
+		return 0x0;
+	}
+	block->next = 0x0;
+	block->capacity = capacity;
+	block->used = 0;
+	return block;
+}
+
+///
+//Gets the number of padding bytes needed so a push from a block at an offset is aligned
+//
+//Parameters:
+//	block: The block being pushed onto
+//	offset: The number of bytes of the block already used
+static size_t Arena_GetPadding(const ArenaBlock* block, const size_t offset)
+{
+	uintptr_t address = (uintptr_t)(block + 1) + offset;
+	return (ARENA_ALIGNMENT - address % ARENA_ALIGNMENT) % ARENA_ALIGNMENT;
+}
+
+///
+//Allocates memory for a new arena
+//
+//Returns:
+//	Pointer to new arena
+Arena* Arena_Allocate()
+{
+	Arena* arena = (Arena*)malloc(sizeof(Arena));
+	return arena;
+}
+
+///
+//Initializes an arena, allocating its first block
+//
+//Parameters:
+//	arena: Arena to initialize
+//	blockSize: The number of bytes in the first block, and the least in every block after it
+void Arena_Initialize(Arena* arena, const size_t blockSize)
+{
+	arena->blockSize = blockSize > 0 ? blockSize : ARENA_DEFAULT_BLOCK_SIZE;
+	arena->first = Arena_AllocateBlock(arena->blockSize);
+	arena->current = arena->first;
+}
+
+///
+//Frees an arena and every block it allocated
+//
+//Parameters:
+//	arena: Arena to free
+void Arena_Free(Arena* arena)
+{
+	ArenaBlock* block = arena->first;
+	while (block != 0x0)
+	{
+		ArenaBlock* next = block->next;
+		free(block);
+		block = next;
+	}
+	free(arena);
+}
+
+///
+//Takes memory from an arena
+//
+//Parameters:
+//	arena: The arena to take the memory from
+//	size: The number of bytes to take
+//
+//Returns:
+//	A pointer to the memory, aligned to ARENA_ALIGNMENT. The memory is not cleared.
+void* Arena_Push(Arena* arena, const size_t size)
+{
+	ArenaBlock* block = arena->current;
+	if (block != 0x0)
+	{
+		size_t padding = Arena_GetPadding(block, block->used);
+		if (block->used + padding + size <= block->capacity)
+		{
+			void* memory = (char*)(block + 1) + block->used + padding;
+			block->used += padding + size;
+			return memory;
+		}
+
+		//Move on to the next block if it is large enough, otherwise link a new one in after this block
+		ArenaBlock* next = block->next;
+		if (next == 0x0 || Arena_GetPadding(next, 0) + size > next->capacity)
+		{
+			size_t capacity = size + ARENA_ALIGNMENT > arena->blockSize ? size + ARENA_ALIGNMENT : arena->blockSize;
+			ArenaBlock* inserted = Arena_AllocateBlock(capacity);
+			if (inserted == 0x0) return 0x0;
+			inserted->next = next;
+			block->next = inserted;
+			next = inserted;
+		}
+		block = next;
+	}
+	else
+	{
+		//The arena has no blocks yet
+		size_t capacity = size + ARENA_ALIGNMENT > arena->blockSize ? size + ARENA_ALIGNMENT : arena->blockSize;
+		block = Arena_AllocateBlock(capacity);
+		if (block == 0x0) return 0x0;
+		arena->first = block;
+	}
+
+	arena->current = block;
+	size_t padding = Arena_GetPadding(block, 0);
+	block->used = padding + size;
+	return (char*)(block + 1) + padding;
+}
+
+///
+//Gets the current position of an arena, to reset it back to later
+//
+//Parameters:
+//	arena: The arena to get the position of
+ArenaMarker Arena_GetMarker(const Arena* arena)
+{
+	ArenaMarker marker;
+	marker.block = arena->current;
+	marker.used = arena->current != 0x0 ? arena->current->used : 0;
+	return marker;
+}
+
+///
+//Releases all memory pushed onto an arena since a marker was taken. The blocks are kept for later pushes.
+//
+//Parameters:
+//	arena: The arena to reset
+//	marker: A marker from Arena_GetMarker on the same arena
+void Arena_ResetToMarker(Arena* arena, const ArenaMarker marker)
+{
+	//A marker taken before the arena had any blocks resets it to the start
+	if (marker.block == 0x0)
+	{
+		Arena_Reset(arena);
+		return;
+	}
+	arena->current = marker.block;
+	arena->current->used = marker.used;
+}
+
+///
+//Releases all memory pushed onto an arena. The blocks are kept for later pushes.
+//
+//Parameters:
+//	arena: The arena to reset
+void Arena_Reset(Arena* arena)
+{
+	arena->current = arena->first;
+	if (arena->current != 0x0) arena->current->used = 0;
+}
+
+///
+//Gets the number of bytes an arena has allocated for its blocks
+//
+//Parameters:
+//	arena: The arena to measure
+size_t Arena_GetCapacity(const Arena* arena)
+{
+	size_t capacity = 0;
+	for (const ArenaBlock* block = arena->first; block != 0x0; block = block->next)
+	{
+		capacity += block->capacity;
+	}
+	return capacity;
+}
+
+///
+//Gets the arena the Vector and Matrix libraries take their temporaries from.
+//It is created the first time it is used, and grows to the most memory any one operation has needed.
+Arena* Arena_GetScratch()
+{
+	return &Arena_scratch;
+}
@@ -0,0 +1,510 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "CorotationalBody.h"
+
+//Marks a component of a fixed node, which has no row in the system of equations
+#define COROTATIONALBODY_FIXED 0xFFFFFFFF
+
+///
+//Gathers the positions of the four nodes of an element into one vector
+//
+//Parameters:
+//	dest: The vector of 12 components to store the positions in
+//	positions: The positions of every node, three components per node
+//	tetrahedron: The four nodes of the element
+static void CorotationalBody_GatherElement(FixedVector<12>* dest, const float* positions, const uint32_t* tetrahedron)
+{
+	for (int node = 0; node < 4; node++)
+	{
+		const float* position = positions + 3 * tetrahedron[node];
+		for (int i = 0; i < 3; i++) dest->components[3 * node + i] = position[i];
+	}
+}
+
+///
+//Multiplies each of the four nodes' parts of an element vector by a rotation or its transpose
+//
+//Parameters:
+//	dest: The vector of 12 components to store the product in
+//	rotation: The rotation of the element
+//	vector: The vector of 12 components to rotate
+//	transpose: Rotates by the transpose of the rotation when nonzero
+static void CorotationalBody_RotateElement(FixedVector<12>* dest, const FixedMatrix<3, 3>& rotation, const FixedVector<12>& vector, const int transpose)
+{
+	const float* r = rotation.components;
+	for (int node = 0; node < 4; node++)
+	{
+		const float* v = vector.components + 3 * node;
+		float* d = dest->components + 3 * node;
+		for (int i = 0; i < 3; i++)
+		{
+			if (transpose) d[i] = r[i] * v[0] + r[3 + i] * v[1] + r[6 + i] * v[2];
+			else d[i] = r[3 * i] * v[0] + r[3 * i + 1] * v[1] + r[3 * i + 2] * v[2];
+		}
+	}
+}
+
+///
+//Computes the rotation matrix of a unit quaternion
+//
+//Parameters:
+//	dest: The array of 9 floats to store the rotation matrix in, row major
+//	q: The unit quaternion (w, x, y, z)
+static void CorotationalBody_GetRotationMatrix(float* dest, const float* q)
+{
+	dest[0] = 1.0f - 2.0f * (q[2] * q[2] + q[3] * q[3]);
+	dest[1] = 2.0f * (q[1] * q[2] - q[0] * q[3]);
+	dest[2] = 2.0f * (q[1] * q[3] + q[0] * q[2]);
+	dest[3] = 2.0f * (q[1] * q[2] + q[0] * q[3]);
+	dest[4] = 1.0f - 2.0f * (q[1] * q[1] + q[3] * q[3]);
+	dest[5] = 2.0f * (q[2] * q[3] - q[0] * q[1]);
+	dest[6] = 2.0f * (q[1] * q[3] - q[0] * q[2]);
+	dest[7] = 2.0f * (q[2] * q[3] + q[0] * q[1]);
+	dest[8] = 1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2]);
+}
+
+///
+//Computes the stiffness matrix Ke = V * B^T * E * B of a linear tetrahedral element
+//
+//Parameters:
+//	stiffness: The matrix to store the element stiffness matrix in
+//	restInverse: The inverse of the element's rest edge matrix, whose rows are the gradients of the shape functions of nodes 1, 2 and 3
+//	volume: The rest volume of the element
+//	youngsModulus: The stiffness of the material
+//	poissonRatio: How much the material bulges out when squeezed
+static void CorotationalBody_ComputeStiffness(FixedMatrix<12, 12>* stiffness, const FixedMatrix<3, 3>& restInverse, const float volume, const float youngsModulus, const float poissonRatio)
+{
+	//The gradient of node 0's shape function makes the four sum to zero
+	float gradients[4][3];
+	for (int i = 0; i < 3; i++)
+	{
+		gradients[0][i] = -(restInverse.GetIndex(0, i) + restInverse.GetIndex(1, i) + restInverse.GetIndex(2, i));
+		for (int node = 1; node < 4; node++) gradients[node][i] = restInverse.GetIndex(node - 1, i);
+	}
+
+	//B maps the displacements of the nodes to the strain (xx, yy, zz, xy, yz, zx)
+	FixedMatrix<6, 12> strainDisplacement = FixedMatrix<6, 12>::Zero();
+	for (int node = 0; node < 4; node++)
+	{
+		float x = gradients[node][0];
+		float y = gradients[node][1];
+		float z = gradients[node][2];
+		int col = 3 * node;
+		*strainDisplacement.Index(0, col) = x;
+		*strainDisplacement.Index(1, col + 1) = y;
+		*strainDisplacement.Index(2, col + 2) = z;
+		*strainDisplacement.Index(3, col) = y;
+		*strainDisplacement.Index(3, col + 1) = x;
+		*strainDisplacement.Index(4, col + 1) = z;
+		*strainDisplacement.Index(4, col + 2) = y;
+		*strainDisplacement.Index(5, col) = z;
+		*strainDisplacement.Index(5, col + 2) = x;
+	}
+
+	//E maps the strain to the stress of an isotropic material, from its Lame parameters
+	float lambda = youngsModulus * poissonRatio / ((1.0f + poissonRatio) * (1.0f - 2.0f * poissonRatio));
+	float mu = youngsModulus / (2.0f * (1.0f + poissonRatio));
+	FixedMatrix<6, 6> elasticity = FixedMatrix<6, 6>::Zero();
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++) *elasticity.Index(i, j) = lambda;
+		*elasticity.Index(i, i) = lambda + 2.0f * mu;
+		*elasticity.Index(i + 3, i + 3) = mu;
+	}
+
+	FixedMatrix<12, 6> transpose;
+	Matrix_GetTransposeArray(transpose.components, strainDisplacement.components, 6, 12);
+	FixedMatrix<6, 12> stress;
+	Matrix_GetProductMatrixArray(stress.components, elasticity.components, strainDisplacement.components, 6, 6, 12);
+	Matrix_GetProductMatrixArray(stiffness->components, transpose.components, stress.components, 12, 6, 12);
+	Matrix_ScaleArray(stiffness->components, 12, 12, volume);
+}
+
+///
+//Multiplies the system matrix M * (1 + dt * alpha) + (dt^2 + dt * beta) * K_R by a vector, element by element
+//
+//Parameters:
+//	dest: The array to store the product in, one component per free component
+//	body: The corotational body whose system matrix to multiply by
+//	vector: The vector to multiply, one component per free component
+static void CorotationalBody_GetSystemProduct(float* dest, const CorotationalBody* body, const float* vector)
+{
+	float* full = body->fullWork[1];
+	float* product = body->fullWork[0];
+	memset(full, 0, sizeof(float) * 3 * body->numNodes);
+	memset(product, 0, sizeof(float) * 3 * body->numNodes);
+	for (uint32_t k = 0; k < body->numFreeComponents; k++) full[body->freeComponents[k]] = vector[k];
+
+	//K_R * v = sum of R * Ke * R^T * v over the elements
+	for (uint32_t e = 0; e < body->numTetrahedra; e++)
+	{
+		const uint32_t* tetrahedron = body->tetrahedra + 4 * e;
+		FixedVector<12> elementVector, rotated;
+		CorotationalBody_GatherElement(&elementVector, full, tetrahedron);
+		CorotationalBody_RotateElement(&rotated, body->rotations[e], elementVector, 1);
+		FixedVector<12> force = body->stiffnesses[e] * rotated;
+		CorotationalBody_RotateElement(&rotated, body->rotations[e], force, 0);
+		for (int node = 0; node < 4; node++)
+		{
+			float* p = product + 3 * tetrahedron[node];
+			for (int i = 0; i < 3; i++) p[i] += rotated.components[3 * node + i];
+		}
+	}
+
+	float massFactor = 1.0f + body->timeStep * body->massDamping;
+	float stiffnessFactor = body->timeStep * body->timeStep + body->timeStep * body->stiffnessDamping;
+	for (uint32_t k = 0; k < body->numFreeComponents; k++)
+	{
+		uint32_t component = body->freeComponents[k];
+		dest[k] = massFactor * body->masses[component / 3] * vector[k] + stiffnessFactor * product[component];
+	}
+}
+
+///
+//Allocates memory for a new corotational body
+//
+//Returns:
+//	Pointer to new corotational body
+CorotationalBody* CorotationalBody_Allocate()
+{
+	CorotationalBody* body = (CorotationalBody*)malloc(sizeof(CorotationalBody));
+	return body;
+}
+
+///
+//Initializes a corotational body from a tetrahedral mesh, precomputing the element stiffness matrices and
+//factoring the system matrix with no rotations
+//
+//Parameters:
+//	body: The corotational body to initialize
+//	mesh: The mesh the body is made from
+//	fixed: An array with one entry per node of the mesh, nonzero for each node which can't move, or NULL
+//	youngsModulus: The stiffness of the material
+//	poissonRatio: How much the material bulges out when squeezed, less than 0.5
+//	density: The mass of the material per unit volume
+//	timeStep: The amount of time each step moves the body forward
+//
+//Returns:
+//	0 if the system matrix could not be factored, 1 otherwise
+int CorotationalBody_Initialize(CorotationalBody* body, const TetrahedralMesh* mesh, const uint8_t* fixed, const float youngsModulus, const float poissonRatio, const float density, const float timeStep)
+{
+	uint32_t numComponents = 3 * mesh->numNodes;
+	body->numNodes = mesh->numNodes;
+	body->restPositions = (float*)malloc(sizeof(float) * numComponents);
+	body->positions = (float*)malloc(sizeof(float) * numComponents);
+	body->velocities = (float*)calloc(numComponents, sizeof(float));
+	body->externalForces = (float*)calloc(numComponents, sizeof(float));
+	body->masses = (float*)calloc(mesh->numNodes, sizeof(float));
+	body->fixed = (uint8_t*)calloc(mesh->numNodes, sizeof(uint8_t));
+	memcpy(body->restPositions, mesh->positions, sizeof(float) * numComponents);
+	memcpy(body->positions, mesh->positions, sizeof(float) * numComponents);
+	if (fixed != 0x0) memcpy(body->fixed, fixed, sizeof(uint8_t) * mesh->numNodes);
+
+	body->numTetrahedra = mesh->numTetrahedra;
+	body->tetrahedra = (uint32_t*)malloc(sizeof(uint32_t) * 4 * mesh->numTetrahedra);
+	memcpy(body->tetrahedra, mesh->tetrahedra, sizeof(uint32_t) * 4 * mesh->numTetrahedra);
+	body->stiffnesses = (FixedMatrix<12, 12>*)malloc(sizeof(FixedMatrix<12, 12>) * mesh->numTetrahedra);
+	body->restForces = (FixedVector<12>*)malloc(sizeof(FixedVector<12>) * mesh->numTetrahedra);
+	body->restInverses = (FixedMatrix<3, 3>*)malloc(sizeof(FixedMatrix<3, 3>) * mesh->numTetrahedra);
+	body->rotations = (FixedMatrix<3, 3>*)malloc(sizeof(FixedMatrix<3, 3>) * mesh->numTetrahedra);
+	body->quaternions = (float*)malloc(sizeof(float) * 4 * mesh->numTetrahedra);
+
+	body->timeStep = timeStep;
+	body->gravity[0] = 0.0f;
+	body->gravity[1] = -9.81f;
+	body->gravity[2] = 0.0f;
+	body->massDamping = 0.05f;
+	body->stiffnessDamping = 0.01f;
+	body->maxIterations = 50;
+	body->tolerance = 1.0e-3f;
+	body->iterations = 0;
+
+	//Precompute each element
+	for (uint32_t e = 0; e < mesh->numTetrahedra; e++)
+	{
+		const uint32_t* tetrahedron = mesh->tetrahedra + 4 * e;
+		const float* p0 = mesh->positions + 3 * tetrahedron[0];
+
+		//The columns of the rest edge matrix are the edges from node 0
+		FixedMatrix<3, 3> restEdges;
+		for (int col = 0; col < 3; col++)
+		{
+			const float* p = mesh->positions + 3 * tetrahedron[col + 1];
+			for (int row = 0; row < 3; row++) *restEdges.Index(row, col) = p[row] - p0[row];
+		}
+		float volume = Matrix_GetDeterminateArray(restEdges.components, 3, 3) / 6.0f;
+		if (volume <= 0.0f)
+		{
+			printf("CorotationalBody_Initialize failed! Tetrahedron %u has a volume of %f!\n", e, volume);
+		}
+		Matrix_GetInverseArray(body->restInverses[e].components, restEdges.components, 3, 3);
+
+		CorotationalBody_ComputeStiffness(body->stiffnesses + e, body->restInverses[e], volume, youngsModulus, poissonRatio);
+		FixedVector<12> restElement;
+		CorotationalBody_GatherElement(&restElement, mesh->positions, tetrahedron);
+		body->restForces[e] = body->stiffnesses[e] * restElement;
+
+		for (int node = 0; node < 4; node++) body->masses[tetrahedron[node]] += density * volume / 4.0f;
+
+		body->rotations[e] = FixedMatrix<3, 3>::Identity();
+		float* quaternion = body->quaternions + 4 * e;
+		quaternion[0] = 1.0f;
+		quaternion[1] = quaternion[2] = quaternion[3] = 0.0f;
+	}
+
+	//Number the rows of the system of equations
+	uint32_t* rows = (uint32_t*)malloc(sizeof(uint32_t) * numComponents);
+	body->numFreeComponents = 0;
+	for (uint32_t component = 0; component < numComponents; component++)
+	{
+		rows[component] = body->fixed[component / 3] ? COROTATIONALBODY_FIXED : body->numFreeComponents++;
+	}
+	body->freeComponents = (uint32_t*)malloc(sizeof(uint32_t) * (body->numFreeComponents > 0 ? body->numFreeComponents : 1));
+	for (uint32_t component = 0; component < numComponents; component++)
+	{
+		if (rows[component] != COROTATIONALBODY_FIXED) body->freeComponents[rows[component]] = component;
+	}
+
+	//Assemble the system matrix with no rotations, A_0 = M * (1 + dt * alpha) + (dt^2 + dt * beta) * K
+	float massFactor = 1.0f + timeStep * body->massDamping;
+	float stiffnessFactor = timeStep * timeStep + timeStep * body->stiffnessDamping;
+	SparseMatrix* system = SparseMatrix_Allocate();
+	SparseMatrix_Initialize(system, body->numFreeComponents, body->numFreeComponents);
+	for (uint32_t k = 0; k < body->numFreeComponents; k++)
+	{
+		SparseMatrix_AddTriplet(system, k, k, massFactor * body->masses[body->freeComponents[k] / 3]);
+	}
+	for (uint32_t e = 0; e < mesh->numTetrahedra; e++)
+	{
+		const uint32_t* tetrahedron = mesh->tetrahedra + 4 * e;
+		for (int i = 0; i < 12; i++)
+		{
+			uint32_t row = rows[3 * tetrahedron[i / 3] + i % 3];
+			if (row == COROTATIONALBODY_FIXED) continue;
+			for (int j = 0; j < 12; j++)
+			{
+				uint32_t col = rows[3 * tetrahedron[j / 3] + j % 3];
+				if (col == COROTATIONALBODY_FIXED) continue;
+				SparseMatrix_AddTriplet(system, row, col, stiffnessFactor * body->stiffnesses[e].GetIndex(i, j));
+			}
+		}
+	}
+	SparseMatrix_Compress(system);
+	free(rows);
+
+	body->factor = SparseCholesky_Allocate();
+	int factored = SparseCholesky_Decompose(body->factor, system);
+	SparseMatrix_Free(system);
+	if (!factored)
+	{
+		printf("CorotationalBody_Initialize failed! The system matrix is not positive definite!\n");
+	}
+
+	for (int i = 0; i < 2; i++) body->fullWork[i] = (float*)malloc(sizeof(float) * numComponents);
+	for (int i = 0; i < 5; i++) body->solveWork[i] = (float*)malloc(sizeof(float) * (body->numFreeComponents > 0 ? body->numFreeComponents : 1));
+
+	return factored;
+}
+
+///
+//Frees a corotational body's resources
+//
+//Parameters:
+//	body: The corotational body to free
+void CorotationalBody_Free(CorotationalBody* body)
+{
+	free(body->restPositions);
+	free(body->positions);
+	free(body->velocities);
+	free(body->externalForces);
+	free(body->masses);
+	free(body->fixed);
+	free(body->tetrahedra);
+	free(body->stiffnesses);
+	free(body->restForces);
+	free(body->restInverses);
+	free(body->rotations);
+	free(body->quaternions);
+	free(body->freeComponents);
+	SparseCholesky_Free(body->factor);
+	for (int i = 0; i < 2; i++) free(body->fullWork[i]);
+	for (int i = 0; i < 5; i++) free(body->solveWork[i]);
+	free(body);
+}
+
+///
+//Moves a corotational body forward by one time step
+//
+//Parameters:
+//	body: The corotational body to step
+void CorotationalBody_Step(CorotationalBody* body)
+{
+	float dt = body->timeStep;
+
+	//Step 1: Find the rotation of each element from its deformation gradient F = Ds * Dm^-1
+	for (uint32_t e = 0; e < body->numTetrahedra; e++)
+	{
+		const uint32_t* tetrahedron = body->tetrahedra + 4 * e;
+		const float* p0 = body->positions + 3 * tetrahedron[0];
+		FixedMatrix<3, 3> edges;
+		for (int col = 0; col < 3; col++)
+		{
+			const float* p = body->positions + 3 * tetrahedron[col + 1];
+			for (int row = 0; row < 3; row++) *edges.Index(row, col) = p[row] - p0[row];
+		}
+		FixedMatrix<3, 3> deformation = edges * body->restInverses[e];
+
+		float* q = body->quaternions + 4 * e;
+		CorotationalBody_ExtractRotation(q, deformation, 10);
+
+		CorotationalBody_GetRotationMatrix(body->rotations[e].components, q);
+	}
+
+	//Step 2: Compute the right hand side M * v + dt * (f_ext + M * g + f_elastic)
+	float* rhs = body->fullWork[0];
+	for (uint32_t node = 0; node < body->numNodes; node++)
+	{
+		float mass = body->masses[node];
+		for (int i = 0; i < 3; i++)
+		{
+			uint32_t component = 3 * node + i;
+			rhs[component] = mass * body->velocities[component] + dt * (body->externalForces[component] + mass * body->gravity[i]);
+		}
+	}
+	for (uint32_t e = 0; e < body->numTetrahedra; e++)
+	{
+		//f_elastic = -R * (Ke * R^T * x - Ke * x0)
+		const uint32_t* tetrahedron = body->tetrahedra + 4 * e;
+		FixedVector<12> elementPositions, rotated;
+		CorotationalBody_GatherElement(&elementPositions, body->positions, tetrahedron);
+		CorotationalBody_RotateElement(&rotated, body->rotations[e], elementPositions, 1);
+		FixedVector<12> force = body->stiffnesses[e] * rotated;
+		force -= body->restForces[e];
+		CorotationalBody_RotateElement(&rotated, body->rotations[e], force, 0);
+		for (int node = 0; node < 4; node++)
+		{
+			float* r = rhs + 3 * tetrahedron[node];
+			for (int i = 0; i < 3; i++) r[i] -= dt * rotated.components[3 * node + i];
+		}
+	}
+
+	//Step 3: Solve for the new velocities with conjugate gradients, preconditioned by the factorization of A_0
+	uint32_t n = body->numFreeComponents;
+	float* residual = body->solveWork[0];
+	float* velocity = body->solveWork[1];
+	float* preconditioned = body->solveWork[2];
+	float* direction = body->solveWork[3];
+	float* product = body->solveWork[4];
+
+	float rhsMagSq = 0.0f;
+	for (uint32_t k = 0; k < n; k++)
+	{
+		residual[k] = rhs[body->freeComponents[k]];
+		velocity[k] = body->velocities[body->freeComponents[k]];
+		rhsMagSq += residual[k] * residual[k];
+	}
+
+	//Start from the velocities of the last step
+	CorotationalBody_GetSystemProduct(product, body, velocity);
+	float residualMagSq = 0.0f;
+	for (uint32_t k = 0; k < n; k++)
+	{
+		residual[k] -= product[k];
+		residualMagSq += residual[k] * residual[k];
+	}
+
+	float threshold = body->tolerance * body->tolerance * rhsMagSq;
+	memcpy(preconditioned, residual, sizeof(float) * n);
+	SparseCholesky_SolveArray(preconditioned, body->factor);
+	memcpy(direction, preconditioned, sizeof(float) * n);
+	float residualDotPreconditioned = 0.0f;
+	for (uint32_t k = 0; k < n; k++) residualDotPreconditioned += residual[k] * preconditioned[k];
+
+	body->iterations = 0;
+	while (residualMagSq > threshold && body->iterations < body->maxIterations)
+	{
+		CorotationalBody_GetSystemProduct(product, body, direction);
+		float directionDotProduct = 0.0f;
+		for (uint32_t k = 0; k < n; k++) directionDotProduct += direction[k] * product[k];
+		if (directionDotProduct <= 0.0f) break;
+
+		float alpha = residualDotPreconditioned / directionDotProduct;
+		residualMagSq = 0.0f;
+		for (uint32_t k = 0; k < n; k++)
+		{
+			velocity[k] += alpha * direction[k];
+			residual[k] -= alpha * product[k];
+			residualMagSq += residual[k] * residual[k];
+		}
+		body->iterations++;
+		if (residualMagSq <= threshold) break;
+
+		memcpy(preconditioned, residual, sizeof(float) * n);
+		SparseCholesky_SolveArray(preconditioned, body->factor);
+		float nextDot = 0.0f;
+		for (uint32_t k = 0; k < n; k++) nextDot += residual[k] * preconditioned[k];
+		float beta = nextDot / residualDotPreconditioned;
+		residualDotPreconditioned = nextDot;
+		for (uint32_t k = 0; k < n; k++) direction[k] = preconditioned[k] + beta * direction[k];
+	}
+
+	//Step 4: Move the nodes with their new velocities
+	for (uint32_t k = 0; k < n; k++)
+	{
+		uint32_t component = body->freeComponents[k];
+		body->velocities[component] = velocity[k];
+		body->positions[component] += dt * velocity[k];
+	}
+}
+
+///
+//Finds the rotation nearest to a matrix, starting from a guess.
+//Each iteration turns the rotation about the axis which best lines its columns up with the columns of the matrix.
+//
+//Parameters:
+//	quaternion: The guess (w, x, y, z), replaced by the rotation
+//	mat: The matrix to find the rotation of
+//	maxIterations: The most iterations to refine the rotation for
+void CorotationalBody_ExtractRotation(float* quaternion, const FixedMatrix<3, 3>& mat, const uint32_t maxIterations)
+{
+	float* q = quaternion;
+	for (uint32_t iteration = 0; iteration < maxIterations; iteration++)
+	{
+		//Rotation of the current quaternion
+		float r[9];
+		CorotationalBody_GetRotationMatrix(r, q);
+
+		//omega = sum of the columns of R crossed with the columns of the matrix / |sum of their dot products|
+		float omega[3] = { 0.0f, 0.0f, 0.0f };
+		float dot = 0.0f;
+		for (int col = 0; col < 3; col++)
+		{
+			float rx = r[col], ry = r[3 + col], rz = r[6 + col];
+			float ax = mat.components[col], ay = mat.components[3 + col], az = mat.components[6 + col];
+			omega[0] += ry * az - rz * ay;
+			omega[1] += rz * ax - rx * az;
+			omega[2] += rx * ay - ry * ax;
+			dot += rx * ax + ry * ay + rz * az;
+		}
+		float scale = 1.0f / (fabsf(dot) + 1.0e-9f);
+		for (int i = 0; i < 3; i++) omega[i] *= scale;
+
+		float angle = sqrtf(omega[0] * omega[0] + omega[1] * omega[1] + omega[2] * omega[2]);
+		if (angle < 1.0e-9f) break;
+
+		//q = quaternion of a turn by angle about omega * q
+		float s = sinf(0.5f * angle) / angle;
+		float turn[4] = { cosf(0.5f * angle), omega[0] * s, omega[1] * s, omega[2] * s };
+		float product[4];
+		product[0] = turn[0] * q[0] - turn[1] * q[1] - turn[2] * q[2] - turn[3] * q[3];
+		product[1] = turn[0] * q[1] + turn[1] * q[0] + turn[2] * q[3] - turn[3] * q[2];
+		product[2] = turn[0] * q[2] - turn[1] * q[3] + turn[2] * q[0] + turn[3] * q[1];
+		product[3] = turn[0] * q[3] + turn[1] * q[2] - turn[2] * q[1] + turn[3] * q[0];
+
+		float magnitude = sqrtf(product[0] * product[0] + product[1] * product[1] + product[2] * product[2] + product[3] * product[3]);
+		for (int i = 0; i < 4; i++) q[i] = product[i] / magnitude;
+	}
+}
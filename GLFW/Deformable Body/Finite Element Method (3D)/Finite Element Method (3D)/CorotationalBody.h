@@ -0,0 +1,128 @@
+/*
+A deformable body simulated with the finite element method on a mesh of linear tetrahedra, using corotational
+(stiffness warped) linear elasticity.
+
+Linear elasticity measures how far each element has been displaced from its rest shape, u = x - x0, and pushes
+back with f = -Ke * u, where the element stiffness matrix Ke = V * B^T * E * B only depends on the rest shape. It
+is computed once for every element when the body is made. The catch is that a rotated element has been displaced
+from its rest shape too, so a plain linear body swells up and shears apart whenever part of it turns. A corotational
+body first finds the rotation R of each element, and measures the displacement in the element's rotated frame:
+
+	f = -R * Ke * (R^T * x - x0)
+
+so rotating an element produces no force. R is the rotation nearest to the element's deformation gradient F. It is
+found as a quaternion by the method of Muller et al., starting from the rotation found for the element on the
+previous step, which is nearly always within one or two iterations of the answer.
+
+Each step is implicit Euler, which is stable for any time step. The new velocities are the solution of
+
+	(M * (1 + dt * alpha) + (dt^2 + dt * beta) * K_R) * v' = M * v + dt * (f_ext + f_elastic)
+
+where K_R is the sum of R * Ke * R^T over the elements, and alpha and beta are the Rayleigh damping coefficients.
+The system matrix A_0 with every rotation set to the identity does not change, so it is assembled and factored with
+a sparse Cholesky factorization once when the body is made. The rotated system is then solved with conjugate
+gradients, using that factorization to precondition it: while the elements have not turned the preconditioner is
+the exact inverse and one back substitution solves the system, and as they turn it remains close enough that the
+solve converges in a few more. K_R is never assembled; its product with a vector is done element by element.
+Limiting the solve to one iteration takes a single back substitution each step, leaving the rotated stiffness
+out of the implicit part of the step; it stays stable, but bends a little further before springing back.
+
+Every array a step uses is allocated when the body is made, so stepping the body allocates no memory.
+
+References:
+Real-Time Physics by Muller et al., Chapter 3 (corotational FEM)
+A Robust Method to Extract the Rotational Part of Deformations by Muller, Bender, Chentanez and Macklin
+*/
+
+#ifndef COROTATIONALBODY_H
+#define COROTATIONALBODY_H
+
+#include "TetrahedralMesh.h"
+#include "SparseCholesky.h"
+#include "FixedMatrix.h"
+
+typedef struct CorotationalBody
+{
+	uint32_t numNodes;
+	float* restPositions;				//Three components per node
+	float* positions;
+	float* velocities;
+	float* externalForces;				//Applied every step until changed
+	float* masses;						//Lumped mass of each node
+	uint8_t* fixed;						//Nonzero for each node which can't move
+
+	uint32_t numTetrahedra;
+	uint32_t* tetrahedra;				//Four nodes per tetrahedron
+	FixedMatrix<12, 12>* stiffnesses;	//Element stiffness matrices Ke
+	FixedVector<12>* restForces;		//Ke * x0 of each element
+	FixedMatrix<3, 3>* restInverses;	//Inverse of each element's rest edge matrix
+	FixedMatrix<3, 3>* rotations;		//Rotation of each element on the current step
+	float* quaternions;					//Four components per element (w, x, y, z), to start each extraction from
+
+	float timeStep;
+	float gravity[3];
+	float massDamping;					//Rayleigh damping coefficients
+	float stiffnessDamping;
+
+	//The system of equations only has rows for the components of the nodes which are not fixed
+	uint32_t numFreeComponents;
+	uint32_t* freeComponents;			//Which component of the node positions each row is for
+	SparseCholesky* factor;				//Factorization of the system matrix with no rotations
+
+	uint32_t maxIterations;				//Most conjugate gradient iterations each step, 1 for a single back substitution
+	float tolerance;					//Residual to stop at, relative to the right hand side
+	uint32_t iterations;				//Conjugate gradient iterations taken on the last step
+
+	//Work arrays
+	float* fullWork[2];					//Three components per node
+	float* solveWork[5];				//One component per free component
+}CorotationalBody;
+
+///
+//Allocates memory for a new corotational body
+//
+//Returns:
+//	Pointer to new corotational body
+CorotationalBody* CorotationalBody_Allocate();
+
+///
+//Initializes a corotational body from a tetrahedral mesh, precomputing the element stiffness matrices and
+//factoring the system matrix with no rotations
+//
+//Parameters:
+//	body: The corotational body to initialize
+//	mesh: The mesh the body is made from
+//	fixed: An array with one entry per node of the mesh, nonzero for each node which can't move, or NULL
+//	youngsModulus: The stiffness of the material
+//	poissonRatio: How much the material bulges out when squeezed, less than 0.5
+//	density: The mass of the material per unit volume
+//	timeStep: The amount of time each step moves the body forward
+//
+//Returns:
+//	0 if the system matrix could not be factored, 1 otherwise
+int CorotationalBody_Initialize(CorotationalBody* body, const TetrahedralMesh* mesh, const uint8_t* fixed, const float youngsModulus, const float poissonRatio, const float density, const float timeStep);
+
+///
+//Frees a corotational body's resources
+//
+//Parameters:
+//	body: The corotational body to free
+void CorotationalBody_Free(CorotationalBody* body);
+
+///
+//Moves a corotational body forward by one time step
+//
+//Parameters:
+//	body: The corotational body to step
+void CorotationalBody_Step(CorotationalBody* body);
+
+///
+//Finds the rotation nearest to a matrix, starting from a guess
+//
+//Parameters:
+//	quaternion: The guess (w, x, y, z), replaced by the rotation
+//	mat: The matrix to find the rotation of
+//	maxIterations: The most iterations to refine the rotation for
+void CorotationalBody_ExtractRotation(float* quaternion, const FixedMatrix<3, 3>& mat, const uint32_t maxIterations);
+
+#endif
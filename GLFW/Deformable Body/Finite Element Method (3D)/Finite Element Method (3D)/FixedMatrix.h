@@ -0,0 +1,548 @@
+/*
+A matrix whose number of rows and columns are fixed when the program is compiled. FixedMatrix<3, 3> is nine
+floats stored in row major order inside the matrix, the same order as the components of a Matrix, so it needs
+no malloc and no free and its loops all run a number of times the compiler knows.
+
+Knowing the count is not enough for a compiler to unroll the loops, and the pivot search of an LU decomposition
+branches on every column whatever its size. So the 2x2, 3x3 and 4x4 matrices used in physics have their own product,
+transform, determinant and inverse, written out component by component below the template.
+
+The sizes are checked by the compiler: multiplying a FixedMatrix<2, 3> by a FixedMatrix<4, 2> does not compile,
+and the determinant, inverse and solve are only there for square matrices.
+
+The 2x2, 3x3 and 4x4 determinants and inverses use cofactors and the adjugate matrix, the same as MatrixBatch. The
+determinant and inverse of larger matrices, and every solve, use an LU decomposition with partial pivoting, the same as
+Matrix_LUDecomposeArray, done on a copy of the matrix on the stack.
+
+A FixedMatrix can be handed to any function of the Matrix library through AsMatrix, which makes a Matrix that
+points at its components. Copying to and from a Matrix checks the dimensions and prints an error if they differ.
+*/
+
+#ifndef FIXEDMATRIX_H
+#define FIXEDMATRIX_H
+
+#include "Matrix.h"
+#include "FixedVector.h"
+
+template <uint16_t R, uint16_t C>
+struct FixedMatrix
+{
+	enum { numRows = R, numColumns = C };
+
+	float components[R * C];
+
+	///
+	//Makes a matrix with every component set to 0
+	static FixedMatrix Zero()
+	{
+		FixedMatrix mat;
+		for (int i = 0; i < R * C; i++) mat.components[i] = 0.0f;
+		return mat;
+	}
+
+	///
+	//Makes an identity matrix
+	static FixedMatrix Identity()
+	{
+		static_assert(R == C, "Only a square matrix can be an identity matrix");
+		FixedMatrix mat = Zero();
+		for (int i = 0; i < R; i++) mat.components[i * C + i] = 1.0f;
+		return mat;
+	}
+
+	///
+	//Makes a matrix from an array of R * C floats in row major order
+	static FixedMatrix FromArray(const float* src)
+	{
+		FixedMatrix mat;
+		for (int i = 0; i < R * C; i++) mat.components[i] = src[i];
+		return mat;
+	}
+
+	///
+	//Makes a Matrix which shares this matrix's components, for calling the Matrix library.
+	//The Matrix must not be freed, and is only valid for as long as this matrix is.
+	Matrix AsMatrix()
+	{
+		Matrix mat;
+		mat.numRows = R;
+		mat.numColumns = C;
+		mat.components = components;
+		return mat;
+	}
+
+	///
+	//Copies the components of a Matrix into this matrix
+	//
+	//Parameters:
+	//	src: The Matrix to copy, which must have R rows and C columns
+	void CopyFrom(const Matrix* src)
+	{
+		if (src->numRows != R || src->numColumns != C)
+		{
+			printf("FixedMatrix::CopyFrom Failed! Matrix is %dx%d instead of %dx%d! Matrix was not copied!\n", src->numRows, src->numColumns, R, C);
+			return;
+		}
+		for (int i = 0; i < R * C; i++) components[i] = src->components[i];
+	}
+
+	///
+	//Copies the components of this matrix into a Matrix
+	//
+	//Parameters:
+	//	dest: The Matrix to copy into, which must have R rows and C columns
+	void CopyTo(Matrix* dest) const
+	{
+		if (dest->numRows != R || dest->numColumns != C)
+		{
+			printf("FixedMatrix::CopyTo Failed! Matrix is %dx%d instead of %dx%d! Matrix was not copied!\n", dest->numRows, dest->numColumns, R, C);
+			return;
+		}
+		for (int i = 0; i < R * C; i++) dest->components[i] = components[i];
+	}
+
+	float* Index(int row, int col) { return &components[row * C + col]; }
+	float GetIndex(int row, int col) const { return components[row * C + col]; }
+
+	FixedMatrix& operator+=(const FixedMatrix& other)
+	{
+		for (int i = 0; i < R * C; i++) components[i] += other.components[i];
+		return *this;
+	}
+
+	FixedMatrix& operator-=(const FixedMatrix& other)
+	{
+		for (int i = 0; i < R * C; i++) components[i] -= other.components[i];
+		return *this;
+	}
+
+	FixedMatrix& operator*=(float scalarValue)
+	{
+		for (int i = 0; i < R * C; i++) components[i] *= scalarValue;
+		return *this;
+	}
+
+	FixedMatrix operator+(const FixedMatrix& other) const { FixedMatrix sum = *this; return sum += other; }
+	FixedMatrix operator-(const FixedMatrix& other) const { FixedMatrix difference = *this; return difference -= other; }
+	FixedMatrix operator*(float scalarValue) const { FixedMatrix product = *this; return product *= scalarValue; }
+
+	///
+	//Multiplies this matrix by a matrix with C rows. Each row of the product is a sum of the other matrix's rows,
+	//so the inner loop runs along a row of both matrices.
+	template <uint16_t K>
+	FixedMatrix<R, K> operator*(const FixedMatrix<C, K>& RHSMatrix) const
+	{
+		FixedMatrix<R, K> product = FixedMatrix<R, K>::Zero();
+		for (int row = 0; row < R; row++)
+		{
+			for (int dot = 0; dot < C; dot++)
+			{
+				float scale = components[row * C + dot];
+				for (int col = 0; col < K; col++)
+				{
+					product.components[row * K + col] += scale * RHSMatrix.components[dot * K + col];
+				}
+			}
+		}
+		return product;
+	}
+
+	FixedVector<R> operator*(const FixedVector<C>& RHSVector) const
+	{
+		FixedVector<R> product;
+		for (int row = 0; row < R; row++)
+		{
+			float dot = 0.0f;
+			for (int col = 0; col < C; col++) dot += components[row * C + col] * RHSVector.components[col];
+			product.components[row] = dot;
+		}
+		return product;
+	}
+
+	FixedMatrix<C, R> GetTranspose() const
+	{
+		FixedMatrix<C, R> transpose;
+		for (int row = 0; row < R; row++)
+		{
+			for (int col = 0; col < C; col++)
+			{
+				transpose.components[col * R + row] = components[row * C + col];
+			}
+		}
+		return transpose;
+	}
+
+	///
+	//Factors this square matrix into L and U in place, exactly as Matrix_LUDecomposeArray does
+	//
+	//Parameters:
+	//	pivots: An array of R indices to store the row order in
+	//
+	//Returns:
+	//	1 or -1 if an even or odd number of rows were swapped, or 0 if the matrix is singular
+	int LUDecompose(uint16_t* pivots)
+	{
+		static_assert(R == C, "Only a square matrix can be factored");
+		int sign = 1;
+		for (int i = 0; i < R; i++) pivots[i] = i;
+
+		for (int col = 0; col < R; col++)
+		{
+			//Find the largest pivot in this column
+			int pivotRow = col;
+			float largest = fabsf(components[col * C + col]);
+			for (int row = col + 1; row < R; row++)
+			{
+				if (fabsf(components[row * C + col]) > largest)
+				{
+					largest = fabsf(components[row * C + col]);
+					pivotRow = row;
+				}
+			}
+
+			if (largest == 0.0f) return 0;
+
+			if (pivotRow != col)
+			{
+				for (int j = 0; j < C; j++)
+				{
+					float temp = components[col * C + j];
+					components[col * C + j] = components[pivotRow * C + j];
+					components[pivotRow * C + j] = temp;
+				}
+				uint16_t tempPivot = pivots[col];
+				pivots[col] = pivots[pivotRow];
+				pivots[pivotRow] = tempPivot;
+				sign = -sign;
+			}
+
+			//Eliminate this column from every row below the diagonal
+			for (int row = col + 1; row < R; row++)
+			{
+				float multiplier = components[row * C + col] / components[col * C + col];
+				components[row * C + col] = multiplier;
+				for (int j = col + 1; j < C; j++)
+				{
+					components[row * C + j] -= multiplier * components[col * C + j];
+				}
+			}
+		}
+		return sign;
+	}
+
+	///
+	//Solves A * x = b using this matrix as the factorization of A from LUDecompose
+	//
+	//Parameters:
+	//	RHSVector: The right hand side b
+	//	pivots: The row order from LUDecompose
+	//
+	//Returns:
+	//	The solution x
+	FixedVector<R> LUSolve(const FixedVector<R>& RHSVector, const uint16_t* pivots) const
+	{
+		FixedVector<R> solution;
+		for (int i = 0; i < R; i++) solution.components[i] = RHSVector.components[pivots[i]];
+
+		//Forward substitution, L has ones on the diagonal
+		for (int row = 0; row < R; row++)
+		{
+			for (int col = 0; col < row; col++) solution.components[row] -= components[row * C + col] * solution.components[col];
+		}
+
+		//Back substitution
+		for (int row = R - 1; row >= 0; row--)
+		{
+			for (int col = row + 1; col < C; col++) solution.components[row] -= components[row * C + col] * solution.components[col];
+			solution.components[row] /= components[row * C + row];
+		}
+		return solution;
+	}
+
+	float GetDeterminate() const
+	{
+		FixedMatrix LU = *this;
+		uint16_t pivots[R];
+		float determinate = (float)LU.LUDecompose(pivots);
+		for (int i = 0; i < R; i++) determinate *= LU.components[i * C + i];
+		return determinate;
+	}
+
+	///
+	//Calculates the inverse of this square matrix
+	//
+	//Parameters:
+	//	dest: The matrix to store the inverse in, left unchanged if this matrix is singular
+	//
+	//Returns:
+	//	false if this matrix is singular, true otherwise
+	bool GetInverse(FixedMatrix* dest) const
+	{
+		FixedMatrix LU = *this;
+		uint16_t pivots[R];
+		if (LU.LUDecompose(pivots) == 0) return false;
+
+		FixedVector<R> column = FixedVector<R>::Zero();
+		for (int col = 0; col < C; col++)
+		{
+			column.components[col] = 1.0f;
+			FixedVector<R> inverseColumn = LU.LUSolve(column, pivots);
+			column.components[col] = 0.0f;
+			for (int row = 0; row < R; row++) dest->components[row * C + col] = inverseColumn.components[row];
+		}
+		return true;
+	}
+
+	///
+	//Solves the system of equations A * x = b, where A is this matrix
+	//
+	//Parameters:
+	//	vector: The right hand side b, replaced by the solution x. Left unchanged if this matrix is singular.
+	//
+	//Returns:
+	//	false if this matrix is singular, true otherwise
+	bool Solve(FixedVector<R>* vector) const
+	{
+		FixedMatrix LU = *this;
+		uint16_t pivots[R];
+		if (LU.LUDecompose(pivots) == 0) return false;
+		*vector = LU.LUSolve(*vector, pivots);
+		return true;
+	}
+};
+
+//The 2x2, 3x3 and 4x4 products and transforms, written out so each component is one sum of products no matter how
+//much the compiler unrolls
+template <>
+template <>
+inline FixedMatrix<2, 2> FixedMatrix<2, 2>::operator*(const FixedMatrix<2, 2>& RHSMatrix) const
+{
+	const float* a = components;
+	const float* b = RHSMatrix.components;
+	FixedMatrix<2, 2> product;
+	product.components[0] = a[0] * b[0] + a[1] * b[2];
+	product.components[1] = a[0] * b[1] + a[1] * b[3];
+	product.components[2] = a[2] * b[0] + a[3] * b[2];
+	product.components[3] = a[2] * b[1] + a[3] * b[3];
+	return product;
+}
+
+template <>
+inline FixedVector<2> FixedMatrix<2, 2>::operator*(const FixedVector<2>& RHSVector) const
+{
+	const float* a = components;
+	const float* v = RHSVector.components;
+	FixedVector<2> product;
+	product.components[0] = a[0] * v[0] + a[1] * v[1];
+	product.components[1] = a[2] * v[0] + a[3] * v[1];
+	return product;
+}
+
+template <>
+template <>
+inline FixedMatrix<3, 3> FixedMatrix<3, 3>::operator*(const FixedMatrix<3, 3>& RHSMatrix) const
+{
+	const float* a = components;
+	const float* b = RHSMatrix.components;
+	FixedMatrix<3, 3> product;
+	product.components[0] = a[0] * b[0] + a[1] * b[3] + a[2] * b[6];
+	product.components[1] = a[0] * b[1] + a[1] * b[4] + a[2] * b[7];
+	product.components[2] = a[0] * b[2] + a[1] * b[5] + a[2] * b[8];
+	product.components[3] = a[3] * b[0] + a[4] * b[3] + a[5] * b[6];
+	product.components[4] = a[3] * b[1] + a[4] * b[4] + a[5] * b[7];
+	product.components[5] = a[3] * b[2] + a[4] * b[5] + a[5] * b[8];
+	product.components[6] = a[6] * b[0] + a[7] * b[3] + a[8] * b[6];
+	product.components[7] = a[6] * b[1] + a[7] * b[4] + a[8] * b[7];
+	product.components[8] = a[6] * b[2] + a[7] * b[5] + a[8] * b[8];
+	return product;
+}
+
+template <>
+inline FixedVector<3> FixedMatrix<3, 3>::operator*(const FixedVector<3>& RHSVector) const
+{
+	const float* a = components;
+	const float* v = RHSVector.components;
+	FixedVector<3> product;
+	product.components[0] = a[0] * v[0] + a[1] * v[1] + a[2] * v[2];
+	product.components[1] = a[3] * v[0] + a[4] * v[1] + a[5] * v[2];
+	product.components[2] = a[6] * v[0] + a[7] * v[1] + a[8] * v[2];
+	return product;
+}
+
+template <>
+template <>
+inline FixedMatrix<4, 4> FixedMatrix<4, 4>::operator*(const FixedMatrix<4, 4>& RHSMatrix) const
+{
+	const float* a = components;
+	const float* b = RHSMatrix.components;
+	FixedMatrix<4, 4> product;
+	product.components[0] = a[0] * b[0] + a[1] * b[4] + a[2] * b[8] + a[3] * b[12];
+	product.components[1] = a[0] * b[1] + a[1] * b[5] + a[2] * b[9] + a[3] * b[13];
+	product.components[2] = a[0] * b[2] + a[1] * b[6] + a[2] * b[10] + a[3] * b[14];
+	product.components[3] = a[0] * b[3] + a[1] * b[7] + a[2] * b[11] + a[3] * b[15];
+	product.components[4] = a[4] * b[0] + a[5] * b[4] + a[6] * b[8] + a[7] * b[12];
+	product.components[5] = a[4] * b[1] + a[5] * b[5] + a[6] * b[9] + a[7] * b[13];
+	product.components[6] = a[4] * b[2] + a[5] * b[6] + a[6] * b[10] + a[7] * b[14];
+	product.components[7] = a[4] * b[3] + a[5] * b[7] + a[6] * b[11] + a[7] * b[15];
+	product.components[8] = a[8] * b[0] + a[9] * b[4] + a[10] * b[8] + a[11] * b[12];
+	product.components[9] = a[8] * b[1] + a[9] * b[5] + a[10] * b[9] + a[11] * b[13];
+	product.components[10] = a[8] * b[2] + a[9] * b[6] + a[10] * b[10] + a[11] * b[14];
+	product.components[11] = a[8] * b[3] + a[9] * b[7] + a[10] * b[11] + a[11] * b[15];
+	product.components[12] = a[12] * b[0] + a[13] * b[4] + a[14] * b[8] + a[15] * b[12];
+	product.components[13] = a[12] * b[1] + a[13] * b[5] + a[14] * b[9] + a[15] * b[13];
+	product.components[14] = a[12] * b[2] + a[13] * b[6] + a[14] * b[10] + a[15] * b[14];
+	product.components[15] = a[12] * b[3] + a[13] * b[7] + a[14] * b[11] + a[15] * b[15];
+	return product;
+}
+
+template <>
+inline FixedVector<4> FixedMatrix<4, 4>::operator*(const FixedVector<4>& RHSVector) const
+{
+	const float* a = components;
+	const float* v = RHSVector.components;
+	FixedVector<4> product;
+	product.components[0] = a[0] * v[0] + a[1] * v[1] + a[2] * v[2] + a[3] * v[3];
+	product.components[1] = a[4] * v[0] + a[5] * v[1] + a[6] * v[2] + a[7] * v[3];
+	product.components[2] = a[8] * v[0] + a[9] * v[1] + a[10] * v[2] + a[11] * v[3];
+	product.components[3] = a[12] * v[0] + a[13] * v[1] + a[14] * v[2] + a[15] * v[3];
+	return product;
+}
+
+///
+//Finds a 2x2 determinant as the product of the diagonal minus the product of the other two components
+template <>
+inline float FixedMatrix<2, 2>::GetDeterminate() const
+{
+	return components[0] * components[3] - components[1] * components[2];
+}
+
+///
+//Inverts a 2x2 matrix by swapping its diagonal and negating the rest, over its determinant
+template <>
+inline bool FixedMatrix<2, 2>::GetInverse(FixedMatrix<2, 2>* dest) const
+{
+	const float* m = components;
+	float determinate = m[0] * m[3] - m[1] * m[2];
+	if (determinate == 0.0f) return false;
+
+	float inverseDeterminate = 1.0f / determinate;
+	dest->components[0] = m[3] * inverseDeterminate;
+	dest->components[1] = -m[1] * inverseDeterminate;
+	dest->components[2] = -m[2] * inverseDeterminate;
+	dest->components[3] = m[0] * inverseDeterminate;
+	return true;
+}
+
+///
+//Expands a 3x3 determinant along the first row, as MatrixBatch_GetInverse does
+template <>
+inline float FixedMatrix<3, 3>::GetDeterminate() const
+{
+	const float* m = components;
+	return m[0] * (m[4] * m[8] - m[5] * m[7]) + m[1] * (m[5] * m[6] - m[3] * m[8]) + m[2] * (m[3] * m[7] - m[4] * m[6]);
+}
+
+///
+//Inverts a 3x3 matrix with its adjugate matrix, the transpose of the matrix of cofactors, as MatrixBatch_GetInverse does
+template <>
+inline bool FixedMatrix<3, 3>::GetInverse(FixedMatrix<3, 3>* dest) const
+{
+	const float* m = components;
+	float adjugate[9];
+	adjugate[0] = m[4] * m[8] - m[5] * m[7];
+	adjugate[1] = m[2] * m[7] - m[1] * m[8];
+	adjugate[2] = m[1] * m[5] - m[2] * m[4];
+	adjugate[3] = m[5] * m[6] - m[3] * m[8];
+	adjugate[4] = m[0] * m[8] - m[2] * m[6];
+	adjugate[5] = m[2] * m[3] - m[0] * m[5];
+	adjugate[6] = m[3] * m[7] - m[4] * m[6];
+	adjugate[7] = m[1] * m[6] - m[0] * m[7];
+	adjugate[8] = m[0] * m[4] - m[1] * m[3];
+
+	float determinate = m[0] * adjugate[0] + m[1] * adjugate[3] + m[2] * adjugate[6];
+	if (determinate == 0.0f) return false;
+
+	float inverseDeterminate = 1.0f / determinate;
+	for (int i = 0; i < 9; i++) dest->components[i] = adjugate[i] * inverseDeterminate;
+	return true;
+}
+
+///
+//Finds a 4x4 determinant from the determinants of the 2x2 matrices in the top two rows and the bottom two rows
+//(the Laplace expansion theorem), as MatrixBatch_GetInverse does
+template <>
+inline float FixedMatrix<4, 4>::GetDeterminate() const
+{
+	const float* m = components;
+	float s0 = m[0] * m[5] - m[4] * m[1];
+	float s1 = m[0] * m[6] - m[4] * m[2];
+	float s2 = m[0] * m[7] - m[4] * m[3];
+	float s3 = m[1] * m[6] - m[5] * m[2];
+	float s4 = m[1] * m[7] - m[5] * m[3];
+	float s5 = m[2] * m[7] - m[6] * m[3];
+
+	float c0 = m[8] * m[13] - m[12] * m[9];
+	float c1 = m[8] * m[14] - m[12] * m[10];
+	float c2 = m[8] * m[15] - m[12] * m[11];
+	float c3 = m[9] * m[14] - m[13] * m[10];
+	float c4 = m[9] * m[15] - m[13] * m[11];
+	float c5 = m[10] * m[15] - m[14] * m[11];
+
+	return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+}
+
+///
+//Inverts a 4x4 matrix with its adjugate matrix, built from the same 2x2 determinants as GetDeterminate,
+//as MatrixBatch_GetInverse does
+template <>
+inline bool FixedMatrix<4, 4>::GetInverse(FixedMatrix<4, 4>* dest) const
+{
+	const float* m = components;
+	float s0 = m[0] * m[5] - m[4] * m[1];
+	float s1 = m[0] * m[6] - m[4] * m[2];
+	float s2 = m[0] * m[7] - m[4] * m[3];
+	float s3 = m[1] * m[6] - m[5] * m[2];
+	float s4 = m[1] * m[7] - m[5] * m[3];
+	float s5 = m[2] * m[7] - m[6] * m[3];
+
+	float c0 = m[8] * m[13] - m[12] * m[9];
+	float c1 = m[8] * m[14] - m[12] * m[10];
+	float c2 = m[8] * m[15] - m[12] * m[11];
+	float c3 = m[9] * m[14] - m[13] * m[10];
+	float c4 = m[9] * m[15] - m[13] * m[11];
+	float c5 = m[10] * m[15] - m[14] * m[11];
+
+	float determinate = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+	if (determinate == 0.0f) return false;
+
+	float inverseDeterminate = 1.0f / determinate;
+	float* inverse = dest->components;
+	inverse[0] = (m[5] * c5 - m[6] * c4 + m[7] * c3) * inverseDeterminate;
+	inverse[1] = -(m[1] * c5 - m[2] * c4 + m[3] * c3) * inverseDeterminate;
+	inverse[2] = (m[13] * s5 - m[14] * s4 + m[15] * s3) * inverseDeterminate;
+	inverse[3] = -(m[9] * s5 - m[10] * s4 + m[11] * s3) * inverseDeterminate;
+
+	inverse[4] = -(m[4] * c5 - m[6] * c2 + m[7] * c1) * inverseDeterminate;
+	inverse[5] = (m[0] * c5 - m[2] * c2 + m[3] * c1) * inverseDeterminate;
+	inverse[6] = -(m[12] * s5 - m[14] * s2 + m[15] * s1) * inverseDeterminate;
+	inverse[7] = (m[8] * s5 - m[10] * s2 + m[11] * s1) * inverseDeterminate;
+
+	inverse[8] = (m[4] * c4 - m[5] * c2 + m[7] * c0) * inverseDeterminate;
+	inverse[9] = -(m[0] * c4 - m[1] * c2 + m[3] * c0) * inverseDeterminate;
+	inverse[10] = (m[12] * s4 - m[13] * s2 + m[15] * s0) * inverseDeterminate;
+	inverse[11] = -(m[8] * s4 - m[9] * s2 + m[11] * s0) * inverseDeterminate;
+
+	inverse[12] = -(m[4] * c3 - m[5] * c1 + m[6] * c0) * inverseDeterminate;
+	inverse[13] = (m[0] * c3 - m[1] * c1 + m[2] * c0) * inverseDeterminate;
+	inverse[14] = -(m[12] * s3 - m[13] * s1 + m[14] * s0) * inverseDeterminate;
+	inverse[15] = (m[8] * s3 - m[9] * s1 + m[10] * s0) * inverseDeterminate;
+	return true;
+}
+
+template <uint16_t R, uint16_t C>
+FixedMatrix<R, C> operator*(float scalarValue, const FixedMatrix<R, C>& mat)
+{
+	return mat * scalarValue;
+}
+
+#endif
@@ -0,0 +1,67 @@
+/*
+Title: Finite Element Method (3D)
+File Name: FragmentShader.glsl
+Copyright  2015
+Original authors: Nicholas Gallagher
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is a demonstration of using the finite element method to simulate deformable body physics in 3D.
+The demo contains a beam made from a grid of cubes, each split into 6 tetrahedra, which is fixed to a wall
+at its left end and bends under its own weight.
+
+Each tetrahedron is a linear finite element. Its stiffness matrix only depends on its rest shape, so the stiffness
+matrices of every element are computed once at the startup of the program. Each physics timestep finds the rotation
+of every element from its deformation (a polar decomposition, found by refining the rotation of the last timestep),
+and measures how far each element has been deformed in its own rotated frame. This is corotational or "stiffness
+warped" FEM: the beam can bend and twist a long way without the swelling which plain linear elasticity shows as
+soon as anything rotates.
+
+Each physics timestep is an implicit Euler step, which stays stable for any timestep but needs the solution of a
+large sparse system of equations. The system with no rotations never changes, so it is factored with a sparse
+Cholesky factorization once at the startup of the program. Each timestep solves the rotated system with conjugate
+gradients using that factorization as the preconditioner, so while the beam is at rest one back substitution solves
+it and while it bends it takes a handful. The FEM Benchmark project steps the same beam without a window with ten
+thousand tetrahedra and more, and reports how long each part takes.
+
+The user can apply forces to the right end of the beam.
+Hold the left mouse button to apply a force along the positive Y axis.
+Hold the right mouse button to apply a force along the negative Y axis.
+
+References:
+Real-Time Physics by Matthias Muller et al., Chapter 3 (corotational FEM)
+A Robust Method to Extract the Rotational Part of Deformations by Muller, Bender, Chentanez and Macklin
+Direct Methods for Sparse Linear Systems by Timothy A. Davis
+PhysicsTimestep by Brockton Roth
+Base by Srinivasan Thiagarajan
+*/
+
+
+#version 400 core // Identifies the version of the shader, this line must be on a separate line from the rest of the shader code
+
+layout(location = 0) out vec4 out_color; // Establishes the variable we will pass out of this shader.
+
+in vec4 color;	// Take in a vec4 for color
+ 
+ uniform mat4 hue;	//Global hue control
+
+void main(void)
+{
+	out_color = hue * color; // Set our out_color equal to our in color, basically making this a pass-through shader.
+}
\ No newline at end of file
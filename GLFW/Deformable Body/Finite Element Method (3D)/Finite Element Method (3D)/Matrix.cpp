@@ -0,0 +1,1308 @@
+/*
+Title: Finite Element Method (3D)
+File Name: Matrix.cpp
+Copyright  2015
+Original authors: Nicholas Gallagher
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the Q public license.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+Description:
+This is a demonstration on how to program various vector
+and matrix operations. When run a few operations and their results will
+be printed into a console window. The operations are performed on arrays of floats. 
+This program was written in a C99 compatible subset of C++.
+
+All operations have been programmed to be scalable to any dimension.
+Operations includes the Vector operations Addition, subtraction, dot product, cross product,
+projection, and magnitude aswell as the Matrix operations multiplication, inversion, determinant calculation,
+minor calculation, row slicing, column slicing, and indexing.
+
+The user must press CTRL+f5 to fun the solution and have the window say open.
+Alternatively the user can click Debug->Run without debugging.
+
+References:
+NGen by Nicholas Gallagher
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "Matrix.h"
+
+///
+//Allocates memory for a new matrix
+//
+//Parameters:
+//	numRows: The number of rows in the matrix
+//	numCols: The number of columns in the matrix
+//
+//Returns:
+//	Pointer to new matrix
+Matrix* Matrix_Allocate()
+{
+	Matrix* mat = (Matrix*)malloc(sizeof(Matrix));
+	return mat;
+}
+
+///
+//Initializes a matrices components and sets as identity matrix
+//
+//Parameters:
+//	mat: Matrix to initialize
+void Matrix_Initialize(Matrix* mat, const uint16_t numRows, const uint16_t numCols)
+{
+	mat->numRows = numRows;
+	mat->numColumns = numCols;
+	mat->components = (float*)calloc(sizeof(float), mat->numRows * mat->numColumns);
+	if (mat->numRows == mat->numColumns)
+	{
+		Matrix_ToIdentity(mat);
+	}
+}
+
+///
+//Initializes a matrix with components taken from an arena, and sets it as an identity matrix if it is square.
+//The matrix must not be freed with Matrix_Free; its components are released when the arena is reset.
+//
+//Parameters:
+//	mat: Matrix to initialize
+//	numRows: The number of rows in the matrix
+//	numCols: The number of columns in the matrix
+//	arena: The arena to take the components from
+void Matrix_InitializeFromArena(Matrix* mat, const uint16_t numRows, const uint16_t numCols, Arena* arena)
+{
+	mat->numRows = numRows;
+	mat->numColumns = numCols;
+	mat->components = (float*)Arena_Push(arena, sizeof(float) * numRows * numCols);
+	memset(mat->components, 0, sizeof(float) * numRows * numCols);
+	if (mat->numRows == mat->numColumns)
+	{
+		Matrix_ToIdentity(mat);
+	}
+}
+
+///
+//Frees a matrix's resources
+//
+//Parameters:
+//	mat: Matrix to free
+void Matrix_Free(Matrix* mat)
+{
+	free(mat->components);
+	free(mat);
+}
+
+
+///
+//Copies a matrix array
+//
+//Parameters:
+//	dest: The destination of the copy
+//	source: The matrix to copy
+//	numRows: The number of rows in the matrix being copied
+//	numCols: The number of columns in the matrix being copied
+void Matrix_CopyArray(float* dest, const float* source, const uint16_t numRows, const uint16_t numCols)
+{
+	memcpy(dest, source, sizeof(float)* numRows * numCols);
+}
+//Checks for errors then calls matrix_CopyArray
+void Matrix_Copy(Matrix* dest, const Matrix* src)
+{
+	if (dest->numRows != src->numRows || dest->numColumns != src->numColumns)
+	{
+		printf("Matrix_Copy failed! Source and destination of unequal dimensions. Matrix not copied.");
+	}
+	else
+	{
+		Matrix_CopyArray(dest->components, src->components, src->numRows, src->numColumns);
+	}
+}
+
+///
+//Transforms a matrix into an nXn Identity matrix
+//
+//Parameters:
+//	mat: The matrix to transform
+//	dim: The dimension of the desired identity matrix
+void Matrix_ToIdentityArray(float* mat, const uint16_t dim)
+{
+	for (int row = 0; row < dim; row++)
+	{
+		for (int column = 0; column < dim; column++)
+		{
+			if (row == column)
+			{
+				mat[(dim * row) + column] = 1;
+			}
+			else
+			{
+				mat[(dim * row) + column] = 0;
+			}
+		}
+	}
+}
+//Calls Matrix_ToIdentityArray after error checking
+void Matrix_ToIdentity(Matrix* mat)
+{
+	//Make sure matrix is nXn
+	if (mat->numRows == mat->numColumns)
+	{
+		Matrix_ToIdentityArray(mat->components, mat->numRows);
+	}
+	else
+	{
+		printf("Matrix_ToIdentity failed! Matrix is not NxN. Matrix not transformed to identity\n");
+	}
+}
+
+///
+//Indexes an array representing a matrix
+//
+//Parameters:
+//	mat: The matrix to index
+//	row: the row of the element we wish to index
+//	col: The column of the element we wish to index
+//	numCols: The number of columns in the matrix
+float* Matrix_IndexArray(float* mat, const uint16_t row, const uint16_t col, const uint16_t numCols)
+{
+	return mat + (row * numCols) + col;
+}
+//Const correct indexing
+float Matrix_GetIndexArray(const float* mat, const uint16_t row, const uint16_t col, const uint16_t numCols)
+{
+	return mat[(row * numCols) + col];
+}
+//Performs error checking then calls Matrix_IndexArray and returns null on failure
+float* Matrix_Index(Matrix* mat, const uint16_t row, const uint16_t col)
+{
+	//Make sure the desired index is valid
+	if (row >= mat->numRows && col >= mat->numColumns)
+	{
+		printf("Matrix_Index failed! Index is not valid. Index not found, returning null pointer.\n");
+		return 0x0;
+	}
+	else
+	{
+		return Matrix_IndexArray(mat->components, row, col, mat->numColumns);
+	}
+}
+//Performs error checking then calls Matrix_GetIndexArray, returns null on failure
+float Matrix_GetIndex(const Matrix* mat, const uint16_t row, const uint16_t col)
+{
+	//Make sure the desired index is valid
+	if (row >= mat->numRows && col >= mat->numColumns)
+	{
+		printf("Matrix_Index failed! Index is not valid. Index not found, returning null pointer.\n");
+		return 0x0;
+	}
+	else
+	{
+		return Matrix_GetIndexArray(mat->components, row, col, mat->numColumns);
+	}
+}
+
+
+///
+//Gets the minor matrix corresponding to the specified index
+//
+//Parameters:
+//	dest: The destination matrix
+//	mat: The matrix to extract the minor from
+//	row: The row of the index to get the corresponding minor of
+//	col: The column of the index to get the corresponding minor of
+//	numRows: The number of rows in the matrix we are extracting the minor from
+//	numColumns: The number of columns in the matrix we are extracting the minor from
+void Matrix_GetMinorArray(float* dest, const float* mat, const uint16_t row, const uint16_t col, const uint16_t numRows, const uint16_t numColumns)
+{
+	uint16_t destRow = 0, destColumn = 0;
+	for(uint16_t srcRow = 0; srcRow < numRows; srcRow++)
+	{
+		if(srcRow == row) continue;
+		for(uint16_t srcColumn = 0; srcColumn < numColumns; srcColumn++)
+		{
+			if(srcColumn == col)continue;
+			*Matrix_IndexArray(dest, destRow, destColumn, numColumns - 1) = Matrix_GetIndexArray(mat, srcRow, srcColumn, numColumns);
+			destColumn++;
+		}
+		destColumn = 0;
+		destRow++;
+	}
+}
+//Checks for errors then calls CMatrix_GetMinorArray
+void Matrix_GetMinor(Matrix* dest, const Matrix* mat, const uint16_t row, const uint16_t col)
+{
+	if(dest->numRows != mat->numRows - 1 || dest->numColumns != mat->numColumns - 1)
+	{
+		printf("CMatrix_GetMinor failed! Destination matrix is not of proper dimensions. Minor not retrieved.\n");
+		return;
+	}
+	else if(mat->numRows <= 2 || mat->numColumns <= 2)
+	{
+		printf("CMatrix_GetMinor failed! Matrix is not of proper dimensions to have a minor matrix extracted. Minor not retrieved.\n");
+	}
+	else
+	{
+		Matrix_GetMinorArray(dest->components, mat->components, row, col, mat->numRows, mat->numColumns);
+	}
+}
+
+///
+//Gets an array representing a row Vector of this matrix
+//
+//Parameters:
+//	destination: The destination of the row Vector array
+//	mat: The matrix to get a row from
+//	desiredRow: The row to get
+//	numColumns: The number of columns in the source matrix
+void Matrix_GetRowVectorArray(float* destination, const float* mat, const uint16_t desiredRow, const uint16_t numColumns)
+{
+	for (int i = 0; i < numColumns; i++)
+	{
+		destination[i] = Matrix_GetIndexArray(mat, desiredRow, i, numColumns);
+	}
+}
+
+//Checks for errors then calls Matrix_GetRowVectorArray
+void Matrix_GetRowVector(Vector* destination, const Matrix* mat, const uint16_t desiredRow)
+{
+	if (destination->dimension == mat->numColumns)
+	{
+		if (desiredRow < mat->numRows)
+		{
+			Matrix_GetRowVectorArray(destination->components, mat->components, desiredRow, mat->numColumns);
+		}
+		else
+		{
+			printf("Matrix_GetRowVector failed! Invalid desired row! Row Vector not retrieved.\n");
+		}
+	}
+	else
+	{
+		printf("Matrix_GetRowVector failed! Matrix and Vector not of compatible dimension. Row Vector not retrieved.\n");
+	}
+}
+
+///
+//Gets an array representing a column of this Vector
+//
+//Parameters:
+//	destination: The destination of the column Vector array
+//	mat: The matrix to get a column from
+//	desiredCol: The column to get from the matrix
+//	numRows: The number of rows in the matrix
+//	numColumns: The number of columns in the matrix
+void Matrix_GetColumnVectorArray(float* destination, const float* mat, const uint16_t desiredCol, const uint16_t numRows, const uint16_t numColumns)
+{
+	for(uint16_t i = 0; i < numRows; i++)
+	{
+		destination[i] = Matrix_GetIndexArray(mat, i, desiredCol, numColumns);
+	}
+}
+//Checks for errors then calls Matrix_GetColumnVectorArray
+void Matrix_GetColumnVector(Vector* destination, const Matrix* mat, const uint16_t desiredCol)
+{
+	if (destination->dimension == mat->numRows)
+	{
+		if (desiredCol < mat->numColumns)
+		{
+			Matrix_GetColumnVectorArray(destination->components, mat->components, desiredCol, mat->numRows, mat->numColumns);
+		}
+		else
+		{
+			printf("Matrix_GetColumnVector failed! Invalid desired Column! Column Vector not retrieved.\n");
+		}
+	}
+	else
+	{
+		printf("Matrix_GetRowVector failed! Matrix and Vector not of compatible dimension. Column Vector not retrieved.\n");
+	}
+}
+
+///
+//Slices a row of a matrix storing the contents in a Vector
+//
+//Parameters:
+//	destination: The destination array to hold the row contents
+//	mat: The matrix to slice
+//	desiredRow: The row of the matrix to slice
+//	sliceStart: The index to begin slicing the row (inclusive)
+//	sliceRange: The amount of indices to slice
+//	numColumns:	The number of columns in the matrix
+void Matrix_SliceRowArray(float* destination, const float* mat, const uint16_t desiredRow, const uint16_t sliceStart, const uint16_t sliceRange, const uint16_t numColumns)
+{
+	//The ugliest line of code written by me so far this year.
+	memcpy(destination, Matrix_IndexArray((float*)mat, desiredRow, sliceStart, numColumns), sliceRange * sizeof(float));
+}
+//Checks for errors then calls Matrix_SliceRowArray
+void Matrix_SliceRow(Vector* destination, const Matrix* mat, const uint16_t desiredRow, const uint16_t sliceStart, const uint16_t sliceRange)
+{
+	if(desiredRow < mat->numRows)
+	{
+		if(sliceStart + sliceRange <= mat->numColumns)
+		{
+			if(destination->dimension >= sliceRange)
+			{
+				Matrix_SliceRowArray(destination->components, mat->components, desiredRow, sliceStart, sliceRange, mat->numColumns);
+			}
+			else
+			{
+				printf("Matrix_SliceRow Failed! Slice is outside bounds of destination Vector. Slice not retrieved.\n");
+			}
+		}
+		else
+		{
+			printf("Matrix_SliceRow Failed! Slice is outside bounds of matrix. Slice not retrieved.\n");
+		}
+	}
+	else
+	{
+		printf("Matrix_SliceRow failed! Row is outside bounds of matrix. Slice not retrieved.\n");
+	}
+}
+
+///
+//Slices a column of a matrix storing the contents in a Vector
+//
+//Parameters:
+//	destination: The destination array to hold the row contents
+//	mat: The matrix to slice
+//	desiredColumn: The row of the matrix to slice
+//	sliceStart: The index to begin slicing the row (inclusive)
+//	sliceRange: The amount of indices to slice
+//	numColumns:	The number of columns in the matrix
+void Matrix_SliceColumnArray(float* destination, const float* mat, const uint16_t desiredColumn, const uint16_t sliceStart, const uint16_t sliceRange, const uint16_t numColumns)
+{
+	for(int i = 0; i < sliceRange; i++)
+		destination[i] = Matrix_GetIndexArray(mat, sliceStart + i, desiredColumn, numColumns);
+}
+//Checks for errors then calls Matrix_SliceColumnArray
+void Matrix_SliceColumn(Vector* destination, const Matrix* mat, const uint16_t desiredColumn, const uint16_t sliceStart, const uint16_t sliceRange)
+{
+	if(desiredColumn > 0 && desiredColumn < mat->numColumns)
+	{
+		if(sliceStart + sliceRange < mat->numRows)
+		{
+			if(destination->dimension >= sliceRange)
+			{
+				Matrix_SliceColumnArray(destination->components, mat->components, desiredColumn, sliceStart, sliceRange, mat->numColumns);
+			}
+			else
+			{
+				printf("Matrix_SliceColumn Failed! Slice is outside bounds of destination Vector. Slice not retrieved.\n");
+			}
+		}
+		else
+		{
+			printf("Matrix_SliceColumn Failed! Slice is outside bounds of matrix. Slice not retrieved.\n");
+		}
+	}
+	else
+	{
+		printf("Matrix_SliceColumn failed! Column is outside bounds of matrix. Slice not retrieved.\n");
+	}
+}
+
+///
+//Scales a matrix by a scalar
+//
+//Parameters:
+//	matrix: A pointer to the array of floats representing the matrix to scale
+//	numRows: The number of rows in the matrix
+//	numCols: The number of columns in the matrix
+//	scalarValue: The value by which to scale the matrix
+void Matrix_ScaleArray(float* matrix, const uint16_t numRows, const uint16_t numColumns, const float scalarValue)
+{
+	for(int i = 0; i < numRows * numColumns; i++)
+	{
+		matrix[i] *= scalarValue;
+	}
+}
+//Calls Matrix_ScaleArray
+void Matrix_Scale(Matrix* matrix, const float scalarValue)
+{
+	Matrix_ScaleArray(matrix->components, matrix->numRows, matrix->numColumns, scalarValue);
+}
+
+///
+//Calculates the determinate of a matrix in array form.
+//The determinate of the LU factorization is the product of the diagonal of U, negated if an odd number of rows were swapped.
+//
+//Parameters:
+//	mat: The matrix to calculate the determinate of
+//	numColumns: The number of columns in the matrix
+//	numRows: The number of rows in the matrix
+float Matrix_GetDeterminateArray(const float* mat, const uint16_t numRows, const uint16_t numColumns)
+{
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	float* LU = (float*)Arena_Push(scratch, sizeof(float) * numRows * numColumns);
+	uint16_t* pivots = (uint16_t*)Arena_Push(scratch, sizeof(uint16_t) * numRows);
+	Matrix_CopyArray(LU, mat, numRows, numColumns);
+
+	float determinate = (float)Matrix_LUDecomposeArray(LU, pivots, numRows);
+	if (determinate != 0.0f)
+	{
+		for (int i = 0; i < numRows; i++)
+		{
+			determinate *= Matrix_GetIndexArray(LU, i, i, numColumns);
+		}
+	}
+
+	Arena_ResetToMarker(scratch, marker);
+	return determinate;
+}
+//Checks for errors then calls CMatrix_GetDeterminateArray
+float Matrix_GetDeterminate(const Matrix* mat)
+{
+	//Make sure matrix is nxn, else return 0
+	if(mat->numRows != mat->numColumns)
+	{
+		return 0;
+	}
+	else
+	{
+		return Matrix_GetDeterminateArray(mat->components, mat->numRows, mat->numColumns);
+	}
+}
+
+///
+//Trasposes a matrix in array form
+//Matrix must be NxN
+//
+//Parameters:
+//	mat: The matrix to transpose in array form
+//	numRows: The number of rows in the matrix
+//	numColumns: the number of columns in the matrix
+void Matrix_TransposeArray(float* mat, const uint16_t numRows, const uint16_t numColumns)
+{
+	for(int i = 0; i < numRows; i++)
+	{
+		for(int j = i + 1; j < numColumns; j++)
+		{
+			float temp = *Matrix_IndexArray(mat, i, j, numColumns);
+			*Matrix_IndexArray(mat, i, j, numColumns) = Matrix_GetIndexArray(mat, j, i, numColumns);
+			*Matrix_IndexArray(mat, j, i, numColumns) = temp;
+		}
+	}
+}
+//Checks for errors then calls Matrix_TransposeArray
+void Matrix_Transpose(Matrix* mat)
+{
+	if(mat->numRows != mat->numColumns)
+	{
+		printf("Matrix_Transpose Failed! Matrix is not NxN! Matrix was not transposed! Consider using Matrix_GetTranspose!\n");
+		return;
+	}
+	Matrix_TransposeArray(mat->components, mat->numRows, mat->numColumns);
+}
+
+
+///
+//Finds the transpose of a matrix array and stores it in a given array
+//
+//Parameters:
+//	dest: A pointer to an array of floats as the destinaton of the transpose matrix
+//	matrix: A pointer to an array of floats representing the matrix to transpose
+//	numRows: the number of rows in the matrix
+//	numColumns: The number of columns in the matrix
+void Matrix_GetTransposeArray(float* dest,const float* matrix, const uint16_t numRows, const uint16_t numColumns)
+{
+	for(int i = 0; i < numRows; i++)
+	{
+		for(int j = 0; j < numColumns; j++)
+		{
+			*Matrix_IndexArray(dest, j, i, numRows) = Matrix_GetIndexArray(matrix, i, j, numColumns);
+		}
+	}
+}
+//Checks for errors, then calls Matrix_GetTransposeArray
+void Matrix_GetTranspose(Matrix* dest, Matrix* src)
+{
+	if(dest->numRows != src->numColumns || dest->numColumns != src->numRows)
+	{
+		printf("Matrix_GetTranspose failed! Destiantion matrix is ot of proper dimensions! Transpose not found!\n");
+		return;
+	}
+
+	Matrix_GetTransposeArray(dest->components, src->components, src->numRows, src->numColumns);
+}
+
+///
+//Calculates the inverse of a matrix in array form.
+//The destination is left unchanged if the matrix is not invertible.
+//
+//Parameters:
+//	dest: A pointer to an array of floats to store the inverse of the components
+//	matrix: A pointer to an array of floats containing the components of the matrix to invert
+//	numRows: The number of rows in the matrix being inverted
+//	numCols: The number of columns in the matrix being inverted
+void Matrix_GetInverseArray(float* dest, const float* matrix, const uint16_t numRows, const uint16_t numCols)
+{
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	float* LU = (float*)Arena_Push(scratch, sizeof(float) * numRows * numCols);
+	uint16_t* pivots = (uint16_t*)Arena_Push(scratch, sizeof(uint16_t) * numRows);
+	Matrix_CopyArray(LU, matrix, numRows, numCols);
+
+	if (Matrix_LUDecomposeArray(LU, pivots, numRows) != 0)
+	{
+		Matrix_LUInverseArray(dest, LU, pivots, numRows);
+	}
+
+	Arena_ResetToMarker(scratch, marker);
+}
+//Checks for errors, then calls Matrix_GetInverseArray
+void Matrix_GetInverse(Matrix* dest, const Matrix* matrix)
+{
+	if(dest->numRows != matrix->numRows || dest->numColumns != matrix->numColumns)
+	{
+		printf("Matrix_GetInverse failed! Dimensions of destination and input matrices do not match! Inverse not found!\n");
+		return;
+	}
+	else if(matrix->numRows != matrix->numColumns)
+	{
+		printf("Matrix_GetInverse failed! Matrix is not invertible! Inverse not found!\n");
+		return;
+	}
+
+	//Factor once, both to check that the matrix is invertible and to find the inverse
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	float* LU = (float*)Arena_Push(scratch, sizeof(float) * matrix->numRows * matrix->numColumns);
+	uint16_t* pivots = (uint16_t*)Arena_Push(scratch, sizeof(uint16_t) * matrix->numRows);
+	Matrix_CopyArray(LU, matrix->components, matrix->numRows, matrix->numColumns);
+
+	if (Matrix_LUDecomposeArray(LU, pivots, matrix->numRows) == 0)
+	{
+		printf("Matrix_GetInverse failed! Matrix is not invertible! Inverse not found!\n");
+	}
+	else
+	{
+		Matrix_LUInverseArray(dest->components, LU, pivots, matrix->numRows);
+	}
+
+	Arena_ResetToMarker(scratch, marker);
+}
+
+///
+//Factors a square matrix in array form into a lower and an upper triangular matrix with partial pivoting, so that
+//the matrix with its rows reordered by the pivots is equal to L * U.
+//The factorization is stored over the matrix: U on and above the diagonal, and L below it.
+//The diagonal of L is all ones and is not stored.
+//
+//Each column is eliminated from the rows below the diagonal in turn (Gaussian elimination), keeping the multipliers
+//as L. Before each column the row with the largest value in that column is swapped onto the diagonal, so nothing is
+//ever divided by a tiny pivot. This takes O(n^3) time, where expanding by cofactors takes O(n!).
+//
+//Parameters:
+//	mat: The matrix to factor, replaced by its factorization
+//	pivots: An array of dim indices to store the row order in. Row i of the factorization came from row pivots[i] of the matrix.
+//	dim: The number of rows and columns in the matrix
+//
+//Returns:
+//	1 or -1 if an even or odd number of rows were swapped, or 0 if the matrix is singular
+int Matrix_LUDecomposeArray(float* mat, uint16_t* pivots, const uint16_t dim)
+{
+	int sign = 1;
+	for (int i = 0; i < dim; i++)
+	{
+		pivots[i] = i;
+	}
+
+	for (int col = 0; col < dim; col++)
+	{
+		//Find the largest pivot in this column
+		int pivotRow = col;
+		float largest = fabsf(mat[col * dim + col]);
+		for (int row = col + 1; row < dim; row++)
+		{
+			if (fabsf(mat[row * dim + col]) > largest)
+			{
+				largest = fabsf(mat[row * dim + col]);
+				pivotRow = row;
+			}
+		}
+
+		//If the whole column is zero below the diagonal, the matrix is singular
+		if (largest == 0.0f)
+		{
+			return 0;
+		}
+
+		if (pivotRow != col)
+		{
+			for (int j = 0; j < dim; j++)
+			{
+				float temp = mat[col * dim + j];
+				mat[col * dim + j] = mat[pivotRow * dim + j];
+				mat[pivotRow * dim + j] = temp;
+			}
+			uint16_t tempPivot = pivots[col];
+			pivots[col] = pivots[pivotRow];
+			pivots[pivotRow] = tempPivot;
+			sign = -sign;
+		}
+
+		//Eliminate this column from every row below the diagonal
+		const float* pivotRowComponents = mat + col * dim;
+		for (int row = col + 1; row < dim; row++)
+		{
+			float* rowComponents = mat + row * dim;
+			float multiplier = rowComponents[col] / pivotRowComponents[col];
+			rowComponents[col] = multiplier;
+			for (int j = col + 1; j < dim; j++)
+			{
+				rowComponents[j] -= multiplier * pivotRowComponents[j];
+			}
+		}
+	}
+
+	return sign;
+}
+//Checks for errors then calls Matrix_LUDecomposeArray
+int Matrix_LUDecompose(Matrix* mat, uint16_t* pivots)
+{
+	if (mat->numRows != mat->numColumns)
+	{
+		printf("Matrix_LUDecompose failed! Matrix is not NxN! Matrix not factored.\n");
+		return 0;
+	}
+	return Matrix_LUDecomposeArray(mat->components, pivots, mat->numRows);
+}
+
+///
+//Solves the system of equations A * x = b in place using the LU factorization of A.
+//Since L * U * x = b (with b reordered by the pivots), first L * y = b is solved from the top row down,
+//then U * x = y from the bottom row up.
+//
+//Parameters:
+//	vector: The right hand side b, replaced by the solution x
+//	LU: The factorization of A from Matrix_LUDecomposeArray
+//	pivots: The row order from Matrix_LUDecomposeArray
+//	dim: The number of rows and columns in A
+void Matrix_LUSolveArray(float* vector, const float* LU, const uint16_t* pivots, const uint16_t dim)
+{
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	float* reordered = (float*)Arena_Push(scratch, sizeof(float) * dim);
+	for (int i = 0; i < dim; i++)
+	{
+		reordered[i] = vector[pivots[i]];
+	}
+
+	//Forward substitution, L has ones on the diagonal
+	for (int row = 0; row < dim; row++)
+	{
+		float sum = reordered[row];
+		for (int col = 0; col < row; col++)
+		{
+			sum -= LU[row * dim + col] * reordered[col];
+		}
+		reordered[row] = sum;
+	}
+
+	//Back substitution
+	for (int row = dim - 1; row >= 0; row--)
+	{
+		float sum = reordered[row];
+		for (int col = row + 1; col < dim; col++)
+		{
+			sum -= LU[row * dim + col] * reordered[col];
+		}
+		reordered[row] = sum / LU[row * dim + row];
+	}
+
+	Vector_CopyArray(vector, reordered, dim);
+	Arena_ResetToMarker(scratch, marker);
+}
+//Checks for errors then calls Matrix_LUSolveArray
+void Matrix_LUSolve(Vector* vector, const Matrix* LU, const uint16_t* pivots)
+{
+	if (LU->numRows != LU->numColumns)
+	{
+		printf("Matrix_LUSolve failed! Matrix is not NxN! System not solved.\n");
+	}
+	else if (LU->numColumns != vector->dimension)
+	{
+		printf("Matrix_LUSolve failed! Operands are of incompatible sizes. System not solved.\n");
+	}
+	else
+	{
+		Matrix_LUSolveArray(vector->components, LU->components, pivots, LU->numRows);
+	}
+}
+
+///
+//Calculates the inverse of a matrix from its LU factorization by solving for each column of the identity matrix
+//
+//Parameters:
+//	dest: A pointer to an array of floats to store the inverse in
+//	LU: The factorization of the matrix from Matrix_LUDecomposeArray
+//	pivots: The row order from Matrix_LUDecomposeArray
+//	dim: The number of rows and columns in the matrix
+void Matrix_LUInverseArray(float* dest, const float* LU, const uint16_t* pivots, const uint16_t dim)
+{
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	float* column = (float*)Arena_Push(scratch, sizeof(float) * dim);
+	for (int col = 0; col < dim; col++)
+	{
+		for (int row = 0; row < dim; row++)
+		{
+			column[row] = row == col ? 1.0f : 0.0f;
+		}
+
+		Matrix_LUSolveArray(column, LU, pivots, dim);
+
+		for (int row = 0; row < dim; row++)
+		{
+			*Matrix_IndexArray(dest, row, col, dim) = column[row];
+		}
+	}
+	Arena_ResetToMarker(scratch, marker);
+}
+
+///
+//Solves the system of equations A * x = b in place by factoring a copy of A.
+//To solve many systems with the same matrix, factor it once with Matrix_LUDecomposeArray and call Matrix_LUSolveArray for each.
+//
+//Parameters:
+//	vector: The right hand side b, replaced by the solution x
+//	mat: The matrix A
+//	dim: The number of rows and columns in A
+//
+//Returns:
+//	0 if A is singular and the vector was left unchanged, 1 otherwise
+int Matrix_SolveArray(float* vector, const float* mat, const uint16_t dim)
+{
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	float* LU = (float*)Arena_Push(scratch, sizeof(float) * dim * dim);
+	uint16_t* pivots = (uint16_t*)Arena_Push(scratch, sizeof(uint16_t) * dim);
+	Matrix_CopyArray(LU, mat, dim, dim);
+
+	int solved = Matrix_LUDecomposeArray(LU, pivots, dim) != 0;
+	if (solved)
+	{
+		Matrix_LUSolveArray(vector, LU, pivots, dim);
+	}
+
+	Arena_ResetToMarker(scratch, marker);
+	return solved;
+}
+//Checks for errors then calls Matrix_SolveArray
+void Matrix_Solve(Vector* vector, const Matrix* mat)
+{
+	if (mat->numRows != mat->numColumns)
+	{
+		printf("Matrix_Solve failed! Matrix is not NxN! System not solved.\n");
+	}
+	else if (mat->numColumns != vector->dimension)
+	{
+		printf("Matrix_Solve failed! Operands are of incompatible sizes. System not solved.\n");
+	}
+	else if (!Matrix_SolveArray(vector->components, mat->components, mat->numRows))
+	{
+		printf("Matrix_Solve failed! Matrix is singular! System not solved.\n");
+	}
+}
+
+//Sizes of the blocks the product of two matrices is computed in.
+//A block of the right hand side matrix MATRIX_BLOCK_DEPTH rows by MATRIX_BLOCK_COLUMNS columns (256KB) stays in the
+//L2 cache while every row of the left hand side matrix is multiplied by it, and the MATRIX_BLOCK_DEPTH by 16 strip of it
+//being multiplied by four rows at a time (16KB) stays in the L1 cache.
+#define MATRIX_BLOCK_DEPTH 256
+#define MATRIX_BLOCK_COLUMNS 256
+//The number of rows of a transposed right hand side matrix which are dotted with every row of the left hand side at a time
+#define MATRIX_BLOCK_DOT_ROWS 64
+
+#if defined(__AVX2__)
+//Visual Studio enables FMA along with /arch:AVX2, other compilers need it asked for separately
+#if defined(__FMA__) || defined(_MSC_VER)
+#define MATRIX_FMADD(a, b, c) _mm256_fmadd_ps(a, b, c)
+#else
+#define MATRIX_FMADD(a, b, c) _mm256_add_ps(_mm256_mul_ps(a, b), c)
+#endif
+
+///
+//Adds the eight floats in a register together
+static float Matrix_HorizontalSum(__m256 v)
+{
+	__m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+	sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+	sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+	return _mm_cvtss_f32(sum);
+}
+#endif
+
+///
+//Gets the dot product of two arrays of floats
+//
+//Parameters:
+//	a: The first array
+//	b: The second array
+//	count: The number of floats in each array
+static float Matrix_DotArray(const float* a, const float* b, const int count)
+{
+	int i = 0;
+	float sum = 0.0f;
+#if defined(__AVX2__)
+	__m256 sum0 = _mm256_setzero_ps();
+	__m256 sum1 = _mm256_setzero_ps();
+	for (; i + 16 <= count; i += 16)
+	{
+		sum0 = MATRIX_FMADD(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+		sum1 = MATRIX_FMADD(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), sum1);
+	}
+	for (; i + 8 <= count; i += 8)
+	{
+		sum0 = MATRIX_FMADD(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+	}
+	sum = Matrix_HorizontalSum(_mm256_add_ps(sum0, sum1));
+#endif
+	for (; i < count; i++)
+	{
+		sum += a[i] * b[i];
+	}
+	return sum;
+}
+
+///
+//Adds the product of up to four rows of the left hand side matrix and a block of the right hand side matrix onto the
+//destination matrix.
+//
+//With AVX2, four rows by sixteen columns of the destination are kept in eight registers while the block's depth is
+//walked, so each row of the right hand side strip is loaded once for all four rows, and each component of the left hand
+//side is broadcast once for sixteen columns.
+//
+//Parameters:
+//	dest: The destination matrix
+//	LHS: The left hand side matrix
+//	RHS: The right hand side matrix
+//	row: The first row of the block
+//	numRows: The number of rows in the block, at most 4
+//	depthStart: The first column of the left hand side (and row of the right hand side) in the block
+//	depthEnd: One past the last column of the left hand side in the block
+//	colStart: The first column of the right hand side in the block
+//	colEnd: One past the last column of the right hand side in the block
+//	LHSNumCols: The number of columns in the left hand side matrix
+//	RHSNumCols: The number of columns in the right hand side matrix
+static void Matrix_MultiplyBlockArray(float* dest, const float* LHS, const float* RHS, const int row, const int numRows, const int depthStart, const int depthEnd, const int colStart, const int colEnd, const int LHSNumCols, const int RHSNumCols)
+{
+	int col = colStart;
+#if defined(__AVX2__)
+	if (numRows == 4)
+	{
+		const float* a0 = LHS + row * LHSNumCols;
+		const float* a1 = a0 + LHSNumCols;
+		const float* a2 = a1 + LHSNumCols;
+		const float* a3 = a2 + LHSNumCols;
+		float* c0 = dest + row * RHSNumCols;
+		float* c1 = c0 + RHSNumCols;
+		float* c2 = c1 + RHSNumCols;
+		float* c3 = c2 + RHSNumCols;
+
+		for (; col + 16 <= colEnd; col += 16)
+		{
+			__m256 c00 = _mm256_loadu_ps(c0 + col), c01 = _mm256_loadu_ps(c0 + col + 8);
+			__m256 c10 = _mm256_loadu_ps(c1 + col), c11 = _mm256_loadu_ps(c1 + col + 8);
+			__m256 c20 = _mm256_loadu_ps(c2 + col), c21 = _mm256_loadu_ps(c2 + col + 8);
+			__m256 c30 = _mm256_loadu_ps(c3 + col), c31 = _mm256_loadu_ps(c3 + col + 8);
+
+			for (int k = depthStart; k < depthEnd; k++)
+			{
+				const float* b = RHS + k * RHSNumCols + col;
+				__m256 b0 = _mm256_loadu_ps(b);
+				__m256 b1 = _mm256_loadu_ps(b + 8);
+
+				__m256 a = _mm256_broadcast_ss(a0 + k);
+				c00 = MATRIX_FMADD(a, b0, c00);
+				c01 = MATRIX_FMADD(a, b1, c01);
+				a = _mm256_broadcast_ss(a1 + k);
+				c10 = MATRIX_FMADD(a, b0, c10);
+				c11 = MATRIX_FMADD(a, b1, c11);
+				a = _mm256_broadcast_ss(a2 + k);
+				c20 = MATRIX_FMADD(a, b0, c20);
+				c21 = MATRIX_FMADD(a, b1, c21);
+				a = _mm256_broadcast_ss(a3 + k);
+				c30 = MATRIX_FMADD(a, b0, c30);
+				c31 = MATRIX_FMADD(a, b1, c31);
+			}
+
+			_mm256_storeu_ps(c0 + col, c00); _mm256_storeu_ps(c0 + col + 8, c01);
+			_mm256_storeu_ps(c1 + col, c10); _mm256_storeu_ps(c1 + col + 8, c11);
+			_mm256_storeu_ps(c2 + col, c20); _mm256_storeu_ps(c2 + col + 8, c21);
+			_mm256_storeu_ps(c3 + col, c30); _mm256_storeu_ps(c3 + col + 8, c31);
+		}
+
+		for (; col + 8 <= colEnd; col += 8)
+		{
+			__m256 c00 = _mm256_loadu_ps(c0 + col);
+			__m256 c10 = _mm256_loadu_ps(c1 + col);
+			__m256 c20 = _mm256_loadu_ps(c2 + col);
+			__m256 c30 = _mm256_loadu_ps(c3 + col);
+
+			for (int k = depthStart; k < depthEnd; k++)
+			{
+				__m256 b0 = _mm256_loadu_ps(RHS + k * RHSNumCols + col);
+				c00 = MATRIX_FMADD(_mm256_broadcast_ss(a0 + k), b0, c00);
+				c10 = MATRIX_FMADD(_mm256_broadcast_ss(a1 + k), b0, c10);
+				c20 = MATRIX_FMADD(_mm256_broadcast_ss(a2 + k), b0, c20);
+				c30 = MATRIX_FMADD(_mm256_broadcast_ss(a3 + k), b0, c30);
+			}
+
+			_mm256_storeu_ps(c0 + col, c00);
+			_mm256_storeu_ps(c1 + col, c10);
+			_mm256_storeu_ps(c2 + col, c20);
+			_mm256_storeu_ps(c3 + col, c30);
+		}
+	}
+#endif
+
+	//The remaining columns, or every column without AVX2.
+	//The inner loop runs along a row of the destination and of the right hand side, so the compiler can vectorize it.
+	for (int r = row; r < row + numRows; r++)
+	{
+		float* c = dest + r * RHSNumCols;
+		const float* a = LHS + r * LHSNumCols;
+		for (int k = depthStart; k < depthEnd; k++)
+		{
+			float scalar = a[k];
+			const float* b = RHS + k * RHSNumCols;
+			for (int j = col; j < colEnd; j++)
+			{
+				c[j] += scalar * b[j];
+			}
+		}
+	}
+}
+
+///
+//Multiplies a matrix onto another, transforming the latter.
+//
+//Parameters:
+//	LHSMatrix: Left hand side matrix (Will not be altered)
+//	RHSMatrix: Right hand side matrix (Destination of product)
+//	LHSNumRows: Number of rows in the left hand side matrix 
+//	LHSNumCols: Number of columns in the left hand side matrix (Must be equal to the number of rows in the right hand side matrix)
+void Matrix_TransformMatrixArray(const float* LHSMatrix, float* RHSMatrix, const uint16_t LHSNumRows, const uint16_t LHSNumCols, const uint16_t RHSNumCols)
+{
+	//Create a copy of the right hand side matrix
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	float* RHSCopy = (float*)Arena_Push(scratch, sizeof(float) * LHSNumCols * RHSNumCols);
+
+	Matrix_CopyArray(RHSCopy, RHSMatrix, LHSNumCols, RHSNumCols);
+
+	//Get product of LHSMatrix and RHSCopy and store in RHSMatrix
+	Matrix_GetProductMatrixArray(RHSMatrix, LHSMatrix, RHSCopy, LHSNumRows, LHSNumCols, RHSNumCols);
+
+	Arena_ResetToMarker(scratch, marker);
+}
+//Checks for errors then calls Matrix_TransformMatrixArray
+void Matrix_TransformMatrix(const Matrix* LHSMatrix, Matrix* RHSMatrix)
+{
+	//Make sure the dimensions of LHS and RHS Transpose match
+
+	if (LHSMatrix->numColumns == RHSMatrix->numRows)
+	{
+		Matrix_TransformMatrixArray(LHSMatrix->components, RHSMatrix->components, LHSMatrix->numRows, LHSMatrix->numColumns, RHSMatrix->numColumns);
+		return;
+	}
+
+	//If code reaches this point, method failed.
+
+	printf("Matrix_TransformMatrix failed! Dimensions of operands are not compatible. Matrix not transformed.\n");
+}
+
+///
+//Gets the product of a matrix acting upon another matrix.
+//The product is computed in blocks which fit in the cache, see Matrix_MultiplyBlockArray.
+//The destination must not be either of the operands.
+//
+//Parameters:
+//	destMatrix: The destination of the product matrix
+//	LHSMatrix: The left hand side matrix
+//	RHSMatrix: The right hand side matrix
+//	LHSNumRows: The number of rows in the left hand side matrix
+//	LHSNumCols: The number of columns in the left hand side matrix
+void Matrix_GetProductMatrixArray(float* destMatrix, const float* LHSMatrix, const float* RHSMatrix, const uint16_t LHSNumRows, const uint16_t LHSNumCols, const uint16_t RHSNumCols)
+{
+	memset(destMatrix, 0, sizeof(float) * LHSNumRows * RHSNumCols);
+
+	for (int depth = 0; depth < LHSNumCols; depth += MATRIX_BLOCK_DEPTH)
+	{
+		int depthEnd = depth + MATRIX_BLOCK_DEPTH < LHSNumCols ? depth + MATRIX_BLOCK_DEPTH : LHSNumCols;
+		for (int col = 0; col < RHSNumCols; col += MATRIX_BLOCK_COLUMNS)
+		{
+			int colEnd = col + MATRIX_BLOCK_COLUMNS < RHSNumCols ? col + MATRIX_BLOCK_COLUMNS : RHSNumCols;
+			for (int row = 0; row < LHSNumRows; row += 4)
+			{
+				int numRows = LHSNumRows - row < 4 ? LHSNumRows - row : 4;
+				Matrix_MultiplyBlockArray(destMatrix, LHSMatrix, RHSMatrix, row, numRows, depth, depthEnd, col, colEnd, LHSNumCols, RHSNumCols);
+			}
+		}
+	}
+}
+//Checks for errors then calls GetProductMatrixArray
+void Matrix_GetProductMatrix(Matrix* destMatrix, const Matrix* LHSMatrix, const Matrix* RHSMatrix)
+{
+	//Ensure the LHSMatrix's number of columns is equivilent to the RHSMatrix's number of rows
+	if (LHSMatrix->numColumns != RHSMatrix->numRows)
+	{
+		printf("Matrix_GetProductMatrix Failed! LHSMatrix and RHSMatrix are not of compatible dimensions! Product not retrieved.");
+	}
+	else if (destMatrix->numRows != LHSMatrix->numRows || destMatrix->numColumns != RHSMatrix->numColumns)
+	{
+		printf("Matrix_GetPRoductMatrix Failed! destMatrix is not of correct size for product. Product not retrieved.");
+	}
+	else
+	{
+		Matrix_GetProductMatrixArray(destMatrix->components, LHSMatrix->components, RHSMatrix->components, LHSMatrix->numRows, LHSMatrix->numColumns, RHSMatrix->numColumns);
+	}
+}
+
+///
+//Gets the product of a matrix acting upon another matrix, given the transpose of the right hand side matrix.
+//Every component of the product is the dot product of a row of the left hand side and a row of the transpose,
+//which are both contiguous in memory, so this is the faster product when the right hand side is on hand transposed
+//(such as for A * transpose(A)).
+//The destination must not be either of the operands.
+//
+//Parameters:
+//	destMatrix: The destination of the product matrix
+//	LHSMatrix: The left hand side matrix
+//	RHSTranspose: The transpose of the right hand side matrix, with RHSNumCols rows and LHSNumCols columns
+//	LHSNumRows: The number of rows in the left hand side matrix
+//	LHSNumCols: The number of columns in the left hand side matrix
+//	RHSNumCols: The number of columns in the right hand side matrix (rows in its transpose)
+void Matrix_GetProductMatrixTransposeArray(float* destMatrix, const float* LHSMatrix, const float* RHSTranspose, const uint16_t LHSNumRows, const uint16_t LHSNumCols, const uint16_t RHSNumCols)
+{
+	//Each block of rows of the transpose stays in the cache while every row of the left hand side is dotted with it
+	for (int block = 0; block < RHSNumCols; block += MATRIX_BLOCK_DOT_ROWS)
+	{
+		int blockEnd = block + MATRIX_BLOCK_DOT_ROWS < RHSNumCols ? block + MATRIX_BLOCK_DOT_ROWS : RHSNumCols;
+		int row = 0;
+#if defined(__AVX2__)
+		//Two rows of the left hand side are dotted with four rows of the transpose at once, in eight registers
+		int depthEnd = LHSNumCols - LHSNumCols % 8;
+		for (; row + 2 <= LHSNumRows; row += 2)
+		{
+			const float* a0 = LHSMatrix + row * LHSNumCols;
+			const float* a1 = a0 + LHSNumCols;
+			float* c0 = destMatrix + row * RHSNumCols;
+			float* c1 = c0 + RHSNumCols;
+
+			int col = block;
+			for (; col + 4 <= blockEnd; col += 4)
+			{
+				const float* b0 = RHSTranspose + col * LHSNumCols;
+				const float* b1 = b0 + LHSNumCols;
+				const float* b2 = b1 + LHSNumCols;
+				const float* b3 = b2 + LHSNumCols;
+
+				__m256 s00 = _mm256_setzero_ps(), s01 = _mm256_setzero_ps(), s02 = _mm256_setzero_ps(), s03 = _mm256_setzero_ps();
+				__m256 s10 = _mm256_setzero_ps(), s11 = _mm256_setzero_ps(), s12 = _mm256_setzero_ps(), s13 = _mm256_setzero_ps();
+				for (int k = 0; k < depthEnd; k += 8)
+				{
+					__m256 x0 = _mm256_loadu_ps(a0 + k);
+					__m256 x1 = _mm256_loadu_ps(a1 + k);
+					__m256 y = _mm256_loadu_ps(b0 + k);
+					s00 = MATRIX_FMADD(x0, y, s00);
+					s10 = MATRIX_FMADD(x1, y, s10);
+					y = _mm256_loadu_ps(b1 + k);
+					s01 = MATRIX_FMADD(x0, y, s01);
+					s11 = MATRIX_FMADD(x1, y, s11);
+					y = _mm256_loadu_ps(b2 + k);
+					s02 = MATRIX_FMADD(x0, y, s02);
+					s12 = MATRIX_FMADD(x1, y, s12);
+					y = _mm256_loadu_ps(b3 + k);
+					s03 = MATRIX_FMADD(x0, y, s03);
+					s13 = MATRIX_FMADD(x1, y, s13);
+				}
+
+				int remaining = LHSNumCols - depthEnd;
+				c0[col] = Matrix_HorizontalSum(s00) + Matrix_DotArray(a0 + depthEnd, b0 + depthEnd, remaining);
+				c0[col + 1] = Matrix_HorizontalSum(s01) + Matrix_DotArray(a0 + depthEnd, b1 + depthEnd, remaining);
+				c0[col + 2] = Matrix_HorizontalSum(s02) + Matrix_DotArray(a0 + depthEnd, b2 + depthEnd, remaining);
+				c0[col + 3] = Matrix_HorizontalSum(s03) + Matrix_DotArray(a0 + depthEnd, b3 + depthEnd, remaining);
+				c1[col] = Matrix_HorizontalSum(s10) + Matrix_DotArray(a1 + depthEnd, b0 + depthEnd, remaining);
+				c1[col + 1] = Matrix_HorizontalSum(s11) + Matrix_DotArray(a1 + depthEnd, b1 + depthEnd, remaining);
+				c1[col + 2] = Matrix_HorizontalSum(s12) + Matrix_DotArray(a1 + depthEnd, b2 + depthEnd, remaining);
+				c1[col + 3] = Matrix_HorizontalSum(s13) + Matrix_DotArray(a1 + depthEnd, b3 + depthEnd, remaining);
+			}
+			for (; col < blockEnd; col++)
+			{
+				c0[col] = Matrix_DotArray(a0, RHSTranspose + col * LHSNumCols, LHSNumCols);
+				c1[col] = Matrix_DotArray(a1, RHSTranspose + col * LHSNumCols, LHSNumCols);
+			}
+		}
+#endif
+		//The remaining rows, or every row without AVX2
+		for (; row < LHSNumRows; row++)
+		{
+			for (int col = block; col < blockEnd; col++)
+			{
+				destMatrix[row * RHSNumCols + col] = Matrix_DotArray(LHSMatrix + row * LHSNumCols, RHSTranspose + col * LHSNumCols, LHSNumCols);
+			}
+		}
+	}
+}
+//Checks for errors then calls Matrix_GetProductMatrixTransposeArray
+void Matrix_GetProductMatrixTranspose(Matrix* destMatrix, const Matrix* LHSMatrix, const Matrix* RHSTranspose)
+{
+	if (LHSMatrix->numColumns != RHSTranspose->numColumns)
+	{
+		printf("Matrix_GetProductMatrixTranspose Failed! LHSMatrix and RHSTranspose are not of compatible dimensions! Product not retrieved.\n");
+	}
+	else if (destMatrix->numRows != LHSMatrix->numRows || destMatrix->numColumns != RHSTranspose->numRows)
+	{
+		printf("Matrix_GetProductMatrixTranspose Failed! destMatrix is not of correct size for product. Product not retrieved.\n");
+	}
+	else
+	{
+		Matrix_GetProductMatrixTransposeArray(destMatrix->components, LHSMatrix->components, RHSTranspose->components, LHSMatrix->numRows, LHSMatrix->numColumns, RHSTranspose->numRows);
+	}
+}
+
+///
+//Multiplies a matrix onto a vecor, transforming the Vector
+//
+//Parameters:
+//	LHSMatrix: The left hand side operand, the matrix
+//	RHSVector: The right had side operand and the destination, the Vector
+//	LHSNumRows: The number of rows in the Left Hand Side matrix
+//	LHSNumCols: The number of rows in the Right Hand Side matrix
+void Matrix_TransformVectorArray(const float* LHSMatrix, float* RHSVector, const uint16_t LHSNumRows, const uint16_t LHSNumCols)
+{
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	float* RHSCopy = (float*)Arena_Push(scratch, sizeof(float) * LHSNumCols);
+
+	Vector_CopyArray(RHSCopy, RHSVector, LHSNumCols);
+
+	Matrix_GetProductVectorArray(RHSVector, LHSMatrix, RHSCopy, LHSNumRows, LHSNumCols);
+
+	Arena_ResetToMarker(scratch, marker);
+}
+//Checks for errors then calls Matrix_TransformVectorArray
+void Matrix_TransformVector(const Matrix* LHSMatrix, Vector* RHSVector)
+{
+	if (LHSMatrix->numColumns != RHSVector->dimension)
+	{
+		printf("Matrix_TransformVector failed! Operands are of incompatible sizes. Vector not transformed.\n");
+	}
+	else if (LHSMatrix->numRows != LHSMatrix->numColumns)
+	{
+		printf("Matrix_TransformVector failed! Matrix must be square to tranform vetor. Vector not transformed.\n");
+	}
+	else
+	{
+		Matrix_TransformVectorArray(LHSMatrix->components, RHSVector->components, LHSMatrix->numRows, LHSMatrix->numColumns);
+	}
+}
+
+///
+//Gets the product of a matrix acting upon a Vector.
+//With AVX2, four rows are dotted with the Vector at once so each part of the Vector is loaded once for all four.
+//The destination must not be the Vector operand.
+//
+//Parameters:
+//	destVector: The destination of the product Vector
+//	LHSMatrix: The left hand side matrix operand
+//	RHSVector: The right hand side Vector operand
+//	LHSNumRows: The number of rows in the LHS Matrix operand
+//	LHSNumCols: The number of columns in the LHS MatrixOperand
+void Matrix_GetProductVectorArray(float* destVector, const float* LHSMatrix, const float* RHSVector, const uint16_t LHSNumRows, const uint16_t LHSNumCols)
+{
+	int row = 0;
+#if defined(__AVX2__)
+	int depthEnd = LHSNumCols - LHSNumCols % 8;
+	for (; row + 4 <= LHSNumRows; row += 4)
+	{
+		const float* a0 = LHSMatrix + row * LHSNumCols;
+		const float* a1 = a0 + LHSNumCols;
+		const float* a2 = a1 + LHSNumCols;
+		const float* a3 = a2 + LHSNumCols;
+
+		__m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps(), s2 = _mm256_setzero_ps(), s3 = _mm256_setzero_ps();
+		for (int k = 0; k < depthEnd; k += 8)
+		{
+			__m256 x = _mm256_loadu_ps(RHSVector + k);
+			s0 = MATRIX_FMADD(_mm256_loadu_ps(a0 + k), x, s0);
+			s1 = MATRIX_FMADD(_mm256_loadu_ps(a1 + k), x, s1);
+			s2 = MATRIX_FMADD(_mm256_loadu_ps(a2 + k), x, s2);
+			s3 = MATRIX_FMADD(_mm256_loadu_ps(a3 + k), x, s3);
+		}
+
+		int remaining = LHSNumCols - depthEnd;
+		destVector[row] = Matrix_HorizontalSum(s0) + Matrix_DotArray(a0 + depthEnd, RHSVector + depthEnd, remaining);
+		destVector[row + 1] = Matrix_HorizontalSum(s1) + Matrix_DotArray(a1 + depthEnd, RHSVector + depthEnd, remaining);
+		destVector[row + 2] = Matrix_HorizontalSum(s2) + Matrix_DotArray(a2 + depthEnd, RHSVector + depthEnd, remaining);
+		destVector[row + 3] = Matrix_HorizontalSum(s3) + Matrix_DotArray(a3 + depthEnd, RHSVector + depthEnd, remaining);
+	}
+#endif
+	for (; row < LHSNumRows; row++)
+	{
+		destVector[row] = Matrix_DotArray(LHSMatrix + row * LHSNumCols, RHSVector, LHSNumCols);
+	}
+}
+//Checks for errors then calls Matrix_GetPRoductVectorArray
+void Matrix_GetProductVector(Vector* destVector, const Matrix* LHSMatrix, const Vector* RHSVector)
+{
+	if (destVector->dimension != LHSMatrix->numRows)
+	{
+		printf("Matrix_GetProductVector failed! Destination is not the proper size. Product Vector not retrieved\n");
+	}
+	else if (LHSMatrix->numColumns != RHSVector->dimension)
+	{
+		printf("Matrix_GetProductVector failed! Operands are of incompatible size. Product Vector not retrieved\n");
+	}
+	else
+	{
+		Matrix_GetProductVectorArray(destVector->components, LHSMatrix->components, RHSVector->components, LHSMatrix->numRows, LHSMatrix->numColumns);
+	}
+}
+
+///
+//Prints out a matrix
+//
+//Parameters:
+//	mat: The Matrix to print
+//	numRows: The number of rows in the matrix
+//	numCols: The number of columns in the matrix
+void Matrix_PrintArray(const float* mat, const uint16_t numRows, const uint16_t numCols)
+{
+	printf("[ ");
+	for (int row = 0; row < numRows; row++)
+	{
+		for (int col = 0; col < numCols; col++)
+		{
+			printf("%f ", Matrix_GetIndexArray(mat, row, col, numCols));
+		}
+		if (row < numRows - 1)
+			printf("\n  ");
+		else
+			printf("]\n");
+	}
+}
+//Calls Matrix_PrintArray
+void Matrix_Print(const Matrix* mat)
+{
+	Matrix_PrintArray(mat->components, mat->numRows, mat->numColumns);
+}
@@ -0,0 +1,534 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "ModalBody.h"
+
+//The most subspace iterations ModalBasis_Compute takes
+#define MODALBASIS_MAX_ITERATIONS 100
+
+//The arrays of a modal basis file
+#define MODALBASIS_NUM_ARRAYS 4
+
+//Marks a component of a fixed node, which has no row in the stiffness matrix
+#define MODALBASIS_FIXED 0xFFFFFFFF
+
+///
+//Finds the eigenvalues and eigenvectors of a small symmetric matrix with the cyclic Jacobi method, which turns
+//each component off the diagonal to zero in turn until the matrix is diagonal
+//
+//Parameters:
+//	mat: The symmetric dim x dim matrix, replaced by the diagonal matrix of its eigenvalues
+//	eigenvectors: A dim x dim matrix to store the eigenvectors in, one per column
+//	dim: The dimension of the matrix
+static void ModalBasis_GetSymmetricEigen(double* mat, double* eigenvectors, const uint32_t dim)
+{
+	for (uint32_t i = 0; i < dim * dim; i++) eigenvectors[i] = 0.0;
+	for (uint32_t i = 0; i < dim; i++) eigenvectors[i * dim + i] = 1.0;
+
+	for (int sweep = 0; sweep < 50; sweep++)
+	{
+		double offDiagonal = 0.0, diagonal = 0.0;
+		for (uint32_t i = 0; i < dim; i++)
+		{
+			diagonal += mat[i * dim + i] * mat[i * dim + i];
+			for (uint32_t j = i + 1; j < dim; j++) offDiagonal += mat[i * dim + j] * mat[i * dim + j];
+		}
+		if (offDiagonal <= 1.0e-24 * diagonal) break;
+
+		for (uint32_t p = 0; p < dim; p++)
+		{
+			for (uint32_t q = p + 1; q < dim; q++)
+			{
+				double apq = mat[p * dim + q];
+				if (apq == 0.0) continue;
+
+				//The rotation which zeroes component (p, q)
+				double theta = (mat[q * dim + q] - mat[p * dim + p]) / (2.0 * apq);
+				double t = (theta >= 0.0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+				double c = 1.0 / sqrt(t * t + 1.0);
+				double s = t * c;
+
+				for (uint32_t k = 0; k < dim; k++)
+				{
+					double akp = mat[k * dim + p];
+					double akq = mat[k * dim + q];
+					mat[k * dim + p] = c * akp - s * akq;
+					mat[k * dim + q] = s * akp + c * akq;
+				}
+				for (uint32_t k = 0; k < dim; k++)
+				{
+					double apk = mat[p * dim + k];
+					double aqk = mat[q * dim + k];
+					mat[p * dim + k] = c * apk - s * aqk;
+					mat[q * dim + k] = s * apk + c * aqk;
+				}
+				for (uint32_t k = 0; k < dim; k++)
+				{
+					double vkp = eigenvectors[k * dim + p];
+					double vkq = eigenvectors[k * dim + q];
+					eigenvectors[k * dim + p] = c * vkp - s * vkq;
+					eigenvectors[k * dim + q] = s * vkp + c * vkq;
+				}
+			}
+		}
+	}
+}
+
+///
+//Allocates memory for a new modal basis
+//
+//Returns:
+//	Pointer to new modal basis
+ModalBasis* ModalBasis_Allocate()
+{
+	ModalBasis* basis = (ModalBasis*)malloc(sizeof(ModalBasis));
+	basis->numNodes = 0;
+	basis->numModes = 0;
+	basis->key = 0;
+	basis->eigenvalues = 0x0;
+	basis->masses = 0x0;
+	basis->restPositions = 0x0;
+	basis->modes = 0x0;
+	basis->cache = 0x0;
+	return basis;
+}
+
+///
+//Hashes everything the modes of a body depend on: its mesh, fixed nodes, masses and element stiffness
+//matrices (which hold its Young's modulus, Poisson ratio and density), and the settings they are found with
+//
+//Parameters:
+//	body: An initialized corotational body
+//	numModes: The number of modes to find
+//	tolerance: The tolerance of the subspace iterations
+//
+//Returns:
+//	The key of the modes, the same for any two bodies whose modes are the same
+uint64_t ModalBasis_GetKey(const CorotationalBody* body, const uint32_t numModes, const float tolerance)
+{
+	uint64_t key = PrecomputeCache_Hash(PRECOMPUTECACHE_HASH_SEED, &body->numNodes, sizeof(uint32_t));
+	key = PrecomputeCache_Hash(key, &body->numTetrahedra, sizeof(uint32_t));
+	key = PrecomputeCache_Hash(key, body->restPositions, sizeof(float) * 3 * body->numNodes);
+	key = PrecomputeCache_Hash(key, body->masses, sizeof(float) * body->numNodes);
+	key = PrecomputeCache_Hash(key, body->fixed, sizeof(uint8_t) * body->numNodes);
+	key = PrecomputeCache_Hash(key, body->tetrahedra, sizeof(uint32_t) * 4 * body->numTetrahedra);
+	key = PrecomputeCache_Hash(key, body->stiffnesses, sizeof(FixedMatrix<12, 12>) * body->numTetrahedra);
+	key = PrecomputeCache_Hash(key, &numModes, sizeof(uint32_t));
+	key = PrecomputeCache_Hash(key, &tolerance, sizeof(float));
+	return key;
+}
+
+///
+//Computes the lowest vibration modes of a body with subspace iteration
+//
+//Parameters:
+//	basis: The modal basis to store the modes in
+//	body: An initialized corotational body whose element stiffness matrices, masses and fixed nodes to use
+//	numModes: The number of modes to find
+//	tolerance: The iterations stop once no eigenvalue changed by more than this fraction of itself, around 1e-4 since floats do not settle much below 1e-5
+//
+//Returns:
+//	The number of iterations taken, 0 if the stiffness matrix could not be factored
+uint32_t ModalBasis_Compute(ModalBasis* basis, const CorotationalBody* body, const uint32_t numModes, const float tolerance)
+{
+	uint32_t n = body->numFreeComponents;
+	uint32_t numComponents = 3 * body->numNodes;
+	uint32_t modes = numModes < n ? numModes : n;
+
+	//A few extra vectors in the block speed up the convergence of the last modes
+	uint32_t blockSize = modes + (modes < 8 ? modes : 8);
+	if (blockSize > n) blockSize = n;
+
+	//Assemble the stiffness matrix of the free components
+	uint32_t* rows = (uint32_t*)malloc(sizeof(uint32_t) * numComponents);
+	for (uint32_t component = 0; component < numComponents; component++) rows[component] = MODALBASIS_FIXED;
+	for (uint32_t k = 0; k < n; k++) rows[body->freeComponents[k]] = k;
+
+	SparseMatrix* stiffness = SparseMatrix_Allocate();
+	SparseMatrix_Initialize(stiffness, n, n);
+	for (uint32_t e = 0; e < body->numTetrahedra; e++)
+	{
+		const uint32_t* tetrahedron = body->tetrahedra + 4 * e;
+		for (int i = 0; i < 12; i++)
+		{
+			uint32_t row = rows[3 * tetrahedron[i / 3] + i % 3];
+			if (row == MODALBASIS_FIXED) continue;
+			for (int j = 0; j < 12; j++)
+			{
+				uint32_t col = rows[3 * tetrahedron[j / 3] + j % 3];
+				if (col == MODALBASIS_FIXED) continue;
+				SparseMatrix_AddTriplet(stiffness, row, col, body->stiffnesses[e].GetIndex(i, j));
+			}
+		}
+	}
+	SparseMatrix_Compress(stiffness);
+	free(rows);
+
+	//Without fixed nodes K is singular, since moving the whole body takes no force
+	SparseCholesky* factor = SparseCholesky_Allocate();
+	if (n == 0 || !SparseCholesky_Decompose(factor, stiffness))
+	{
+		printf("ModalBasis_Compute failed! The stiffness matrix is not positive definite, is any node fixed?\n");
+		SparseCholesky_Free(factor);
+		SparseMatrix_Free(stiffness);
+		return 0;
+	}
+
+	float* masses = (float*)malloc(sizeof(float) * n);
+	for (uint32_t k = 0; k < n; k++) masses[k] = body->masses[body->freeComponents[k] / 3];
+
+	float* block = (float*)malloc(sizeof(float) * blockSize * n);
+	float* next = (float*)malloc(sizeof(float) * blockSize * n);
+	float* product = (float*)malloc(sizeof(float) * n);
+	double* reduced = (double*)malloc(sizeof(double) * blockSize * blockSize);
+	double* eigenvectors = (double*)malloc(sizeof(double) * blockSize * blockSize);
+	double* eigenvalues = (double*)malloc(sizeof(double) * blockSize);
+	double* previous = (double*)malloc(sizeof(double) * blockSize);
+	uint32_t* order = (uint32_t*)malloc(sizeof(uint32_t) * blockSize);
+
+	//Start from a block of pseudo random vectors, the same every time
+	uint32_t seed = 12345;
+	for (uint32_t i = 0; i < blockSize * n; i++)
+	{
+		seed = seed * 1664525 + 1013904223;
+		block[i] = (float)(seed >> 8) / (float)(1 << 24) - 0.5f;
+	}
+	for (uint32_t j = 0; j < blockSize; j++) previous[j] = 0.0;
+
+	uint32_t iteration = 0;
+	while (iteration < MODALBASIS_MAX_ITERATIONS)
+	{
+		iteration++;
+
+		//Step 1: Multiply the block by K^-1 * M
+		for (uint32_t j = 0; j < blockSize; j++)
+		{
+			float* vector = next + j * n;
+			for (uint32_t k = 0; k < n; k++) vector[k] = masses[k] * block[j * n + k];
+			SparseCholesky_SolveArray(vector, factor);
+		}
+
+		//Step 2: Make the block orthonormal with respect to M, twice over to keep it orthonormal in floats
+		for (uint32_t j = 0; j < blockSize; j++)
+		{
+			float* vector = next + j * n;
+			for (int pass = 0; pass < 2; pass++)
+			{
+				for (uint32_t i = 0; i < j; i++)
+				{
+					const float* other = next + i * n;
+					double dot = 0.0;
+					for (uint32_t k = 0; k < n; k++) dot += (double)masses[k] * other[k] * vector[k];
+					for (uint32_t k = 0; k < n; k++) vector[k] -= (float)dot * other[k];
+				}
+			}
+			double magSq = 0.0;
+			for (uint32_t k = 0; k < n; k++) magSq += (double)masses[k] * vector[k] * vector[k];
+			float scale = magSq > 0.0 ? (float)(1.0 / sqrt(magSq)) : 0.0f;
+			for (uint32_t k = 0; k < n; k++) vector[k] *= scale;
+		}
+
+		//Step 3: Restrict K to the block. M restricted to the block is the identity.
+		for (uint32_t j = 0; j < blockSize; j++)
+		{
+			SparseMatrix_GetProductVectorArray(product, stiffness->rowStart, stiffness->columns, stiffness->values, next + j * n, n);
+			for (uint32_t i = 0; i <= j; i++)
+			{
+				const float* other = next + i * n;
+				double dot = 0.0;
+				for (uint32_t k = 0; k < n; k++) dot += (double)other[k] * product[k];
+				reduced[i * blockSize + j] = reduced[j * blockSize + i] = dot;
+			}
+		}
+
+		//Step 4: The eigenvectors of the restricted problem give the best approximations of the modes in the block
+		ModalBasis_GetSymmetricEigen(reduced, eigenvectors, blockSize);
+		for (uint32_t j = 0; j < blockSize; j++)
+		{
+			order[j] = j;
+			eigenvalues[j] = reduced[j * blockSize + j];
+		}
+		for (uint32_t j = 1; j < blockSize; j++)
+		{
+			for (uint32_t i = j; i > 0 && eigenvalues[order[i - 1]] > eigenvalues[order[i]]; i--)
+			{
+				uint32_t temp = order[i];
+				order[i] = order[i - 1];
+				order[i - 1] = temp;
+			}
+		}
+		for (uint32_t j = 0; j < blockSize; j++)
+		{
+			float* vector = block + j * n;
+			for (uint32_t k = 0; k < n; k++) vector[k] = 0.0f;
+			for (uint32_t i = 0; i < blockSize; i++)
+			{
+				float weight = (float)eigenvectors[i * blockSize + order[j]];
+				const float* other = next + i * n;
+				for (uint32_t k = 0; k < n; k++) vector[k] += weight * other[k];
+			}
+		}
+
+		//Step 5: Stop once the eigenvalues of the wanted modes have settled
+		int converged = 1;
+		for (uint32_t j = 0; j < modes; j++)
+		{
+			double eigenvalue = eigenvalues[order[j]];
+			if (fabs(eigenvalue - previous[j]) > tolerance * fabs(eigenvalue)) converged = 0;
+			previous[j] = eigenvalue;
+		}
+		if (converged) break;
+	}
+
+	//Store the modes with a component for every node, zero at the fixed ones
+	basis->numNodes = body->numNodes;
+	basis->numModes = modes;
+	basis->key = ModalBasis_GetKey(body, numModes, tolerance);
+	basis->eigenvalues = (float*)malloc(sizeof(float) * (modes > 0 ? modes : 1));
+	basis->masses = (float*)malloc(sizeof(float) * body->numNodes);
+	basis->restPositions = (float*)malloc(sizeof(float) * numComponents);
+	basis->modes = (float*)calloc((size_t)modes * numComponents + 1, sizeof(float));
+	memcpy(basis->masses, body->masses, sizeof(float) * body->numNodes);
+	memcpy(basis->restPositions, body->restPositions, sizeof(float) * numComponents);
+	for (uint32_t j = 0; j < modes; j++)
+	{
+		basis->eigenvalues[j] = (float)previous[j];
+		float* mode = basis->modes + (size_t)j * numComponents;
+		for (uint32_t k = 0; k < n; k++) mode[body->freeComponents[k]] = block[j * n + k];
+	}
+
+	free(masses);
+	free(block);
+	free(next);
+	free(product);
+	free(reduced);
+	free(eigenvectors);
+	free(eigenvalues);
+	free(previous);
+	free(order);
+	SparseCholesky_Free(factor);
+	SparseMatrix_Free(stiffness);
+
+	return iteration;
+}
+
+///
+//Saves a modal basis to a precompute cache file, along with the key it was computed with
+//
+//Parameters:
+//	basis: The modal basis to save
+//	fileName: The name of the file to write
+//
+//Returns:
+//	0 if the file could not be written, 1 otherwise
+int ModalBasis_Save(const ModalBasis* basis, const char* fileName)
+{
+	size_t numComponents = 3 * (size_t)basis->numNodes;
+	const void* arrays[MODALBASIS_NUM_ARRAYS] = { basis->eigenvalues, basis->masses, basis->restPositions, basis->modes };
+	size_t sizes[MODALBASIS_NUM_ARRAYS] =
+	{
+		sizeof(float) * basis->numModes,
+		sizeof(float) * basis->numNodes,
+		sizeof(float) * numComponents,
+		sizeof(float) * basis->numModes * numComponents
+	};
+	return PrecomputeCache_Save(fileName, basis->key, MODALBASIS_NUM_ARRAYS, arrays, sizes);
+}
+
+///
+//Loads a modal basis by mapping a file saved with ModalBasis_Save into memory.
+//The arrays of the basis point into the file, so they must not be changed.
+//
+//Parameters:
+//	basis: The modal basis to load the modes into
+//	fileName: The name of the file to map
+//	key: ModalBasis_GetKey of the body and settings the modes are wanted for
+//
+//Returns:
+//	0 if the file could not be mapped, does not hold a modal basis or was computed with a different key, 1 otherwise
+int ModalBasis_Load(ModalBasis* basis, const char* fileName, const uint64_t key)
+{
+	PrecomputeCache* cache = PrecomputeCache_Allocate();
+	if (!PrecomputeCache_Load(cache, fileName, key, MODALBASIS_NUM_ARRAYS))
+	{
+		PrecomputeCache_Free(cache);
+		return 0;
+	}
+
+	//The number of modes and nodes follow from the sizes of the first two arrays, and fix the sizes of the others
+	uint32_t numModes = (uint32_t)(cache->sizes[0] / sizeof(float));
+	uint32_t numNodes = (uint32_t)(cache->sizes[1] / sizeof(float));
+	size_t numComponents = 3 * (size_t)numNodes;
+	if (cache->sizes[0] != sizeof(float) * numModes || cache->sizes[1] != sizeof(float) * numNodes
+		|| cache->sizes[2] != sizeof(float) * numComponents || cache->sizes[3] != sizeof(float) * numModes * numComponents)
+	{
+		printf("ModalBasis_Load failed! %s does not hold a modal basis!\n", fileName);
+		PrecomputeCache_Free(cache);
+		return 0;
+	}
+
+	basis->numNodes = numNodes;
+	basis->numModes = numModes;
+	basis->key = key;
+	basis->eigenvalues = (float*)cache->arrays[0];
+	basis->masses = (float*)cache->arrays[1];
+	basis->restPositions = (float*)cache->arrays[2];
+	basis->modes = (float*)cache->arrays[3];
+	basis->cache = cache;
+	return 1;
+}
+
+///
+//Frees a modal basis's resources, unmapping its file if it was loaded from one
+//
+//Parameters:
+//	basis: The modal basis to free
+void ModalBasis_Free(ModalBasis* basis)
+{
+	if (basis->cache != 0x0)
+	{
+		PrecomputeCache_Free(basis->cache);
+	}
+	else
+	{
+		free(basis->eigenvalues);
+		free(basis->masses);
+		free(basis->restPositions);
+		free(basis->modes);
+	}
+	free(basis);
+}
+
+///
+//Allocates memory for a new modal body
+//
+//Returns:
+//	Pointer to new modal body
+ModalBody* ModalBody_Allocate()
+{
+	ModalBody* body = (ModalBody*)malloc(sizeof(ModalBody));
+	return body;
+}
+
+///
+//Initializes a modal body at rest
+//
+//Parameters:
+//	body: The modal body to initialize
+//	basis: The modes the body moves along, which must not be freed before the body
+//	gravity: The acceleration of gravity
+//	timeStep: The amount of time each step moves the body forward
+void ModalBody_Initialize(ModalBody* body, const ModalBasis* basis, const float* gravity, const float timeStep)
+{
+	uint32_t numModes = basis->numModes > 0 ? basis->numModes : 1;
+	body->basis = basis;
+	body->displacements = (float*)calloc(numModes, sizeof(float));
+	body->velocities = (float*)calloc(numModes, sizeof(float));
+	body->forces = (float*)calloc(numModes, sizeof(float));
+	body->gravityForces = (float*)calloc(numModes, sizeof(float));
+
+	body->timeStep = timeStep;
+	body->massDamping = 0.05f;
+	body->stiffnessDamping = 0.01f;
+
+	//Gravity pulls on every node with a force of m * g
+	size_t numComponents = 3 * (size_t)basis->numNodes;
+	for (uint32_t j = 0; j < basis->numModes; j++)
+	{
+		const float* mode = basis->modes + j * numComponents;
+		double force = 0.0;
+		for (uint32_t node = 0; node < basis->numNodes; node++)
+		{
+			const float* component = mode + 3 * node;
+			force += basis->masses[node] * (component[0] * gravity[0] + component[1] * gravity[1] + component[2] * gravity[2]);
+		}
+		body->gravityForces[j] = (float)force;
+	}
+}
+
+///
+//Frees a modal body's resources
+//
+//Parameters:
+//	body: The modal body to free
+void ModalBody_Free(ModalBody* body)
+{
+	free(body->displacements);
+	free(body->velocities);
+	free(body->forces);
+	free(body->gravityForces);
+	free(body);
+}
+
+///
+//Removes the forces applied to a modal body
+//
+//Parameters:
+//	body: The modal body to clear the forces of
+void ModalBody_ClearForces(ModalBody* body)
+{
+	memset(body->forces, 0, sizeof(float) * body->basis->numModes);
+}
+
+///
+//Applies a force to a node of a modal body until the forces are cleared
+//
+//Parameters:
+//	body: The modal body to apply the force to
+//	node: The node to apply the force to
+//	force: The three components of the force
+void ModalBody_ApplyForce(ModalBody* body, const uint32_t node, const float* force)
+{
+	const ModalBasis* basis = body->basis;
+	size_t numComponents = 3 * (size_t)basis->numNodes;
+	for (uint32_t j = 0; j < basis->numModes; j++)
+	{
+		const float* component = basis->modes + j * numComponents + 3 * node;
+		body->forces[j] += component[0] * force[0] + component[1] * force[1] + component[2] * force[2];
+	}
+}
+
+///
+//Moves a modal body forward by one time step. This only depends on the number of modes.
+//Each mode takes an implicit Euler step of its own oscillator, the same step a CorotationalBody takes with no rotations.
+//
+//Parameters:
+//	body: The modal body to step
+void ModalBody_Step(ModalBody* body)
+{
+	const ModalBasis* basis = body->basis;
+	float dt = body->timeStep;
+	for (uint32_t j = 0; j < basis->numModes; j++)
+	{
+		float eigenvalue = basis->eigenvalues[j];
+		float damping = body->massDamping + body->stiffnessDamping * eigenvalue;
+		float force = body->forces[j] + body->gravityForces[j] - eigenvalue * body->displacements[j];
+
+		//(1 + dt * damping + dt^2 * lambda) * v' = v + dt * (f - lambda * q)
+		body->velocities[j] = (body->velocities[j] + dt * force) / (1.0f + dt * damping + dt * dt * eigenvalue);
+		body->displacements[j] += dt * body->velocities[j];
+	}
+}
+
+///
+//Computes the positions of the nodes of a modal body
+//
+//Parameters:
+//	positions: An array of three components per node to store the positions in
+//	body: The modal body to get the positions of
+void ModalBody_GetPositions(float* positions, const ModalBody* body)
+{
+	const ModalBasis* basis = body->basis;
+	size_t numComponents = 3 * (size_t)basis->numNodes;
+	memcpy(positions, basis->restPositions, sizeof(float) * numComponents);
+	for (uint32_t j = 0; j < basis->numModes; j++)
+	{
+		float displacement = body->displacements[j];
+		const float* mode = basis->modes + j * numComponents;
+		for (size_t i = 0; i < numComponents; i++) positions[i] += displacement * mode[i];
+	}
+}
@@ -0,0 +1,187 @@
+/*
+A deformable body simulated in a reduced space of its lowest vibration modes (modal analysis).
+
+A linear finite element body with stiffness matrix K and mass matrix M moves as the sum of its vibration modes:
+the solutions of K * phi = lambda * M * phi. Scaled so that phi^T * M * phi = 1, each mode is a single harmonic
+oscillator which moves independently of all of the others:
+
+	q'' + (alpha + beta * lambda) * q' + lambda * q = phi^T * f
+
+where q is how far the body has moved along the mode, lambda = omega^2 is the square of its angular frequency and
+alpha and beta are the Rayleigh damping coefficients. The slow, low frequency modes are the ones anyone sees, so a
+body keeps only its k lowest modes and each step is k of these oscillators, however many nodes the body has. A force
+on a node only costs a dot product per mode, and the positions of the nodes, x = x0 + sum of q * phi, are only needed
+when the body is drawn. Because the modes are the linear modes around the rest shape, a modal body is best for
+small deformations: props which wobble, sway and bounce, not ones which fold up.
+
+The modes are found with subspace iteration. A block of vectors is repeatedly multiplied by K^-1 * M, using the
+sparse Cholesky factorization of K, which pulls it toward the lowest modes, and after each multiplication the best
+approximations of the modes within the block are found by solving the small eigenvalue problem of K and M
+restricted to the block (the Rayleigh-Ritz method). The block is a few vectors larger than the number of modes, so
+the last modes wanted converge about as fast as the first.
+
+Finding the modes takes much longer than a step, so a basis of modes is computed once and saved to a file. The
+file is a precompute cache (see PrecomputeCache.h) of four arrays: the eigenvalues, the masses and rest positions of
+the nodes, and the modes. Loading it maps the file into memory instead of reading it, and any number of bodies share
+one basis. The cache's key is hashed from the body and settings the modes were found from, so a file left by a
+different mesh or material is found out and the modes computed again instead of silently moving the body along the
+wrong ones.
+
+References:
+Real-Time Deformation and Fracture in a Game Environment by O'Brien and Hodgins (modal analysis)
+Interactive Deformation Using Modal Analysis with Constraints by Hauser, Shen and O'Brien
+Numerical Methods for Large Eigenvalue Problems by Yousef Saad, Chapter 5 (subspace iteration)
+*/
+
+#ifndef MODALBODY_H
+#define MODALBODY_H
+
+#include "CorotationalBody.h"
+#include "PrecomputeCache.h"
+
+typedef struct ModalBasis
+{
+	uint32_t numNodes;
+	uint32_t numModes;
+	uint64_t key;					//ModalBasis_GetKey of the body and settings the modes were found from
+	float* eigenvalues;				//lambda = omega^2 of each mode, from lowest to highest
+	float* masses;					//Lumped mass of each node
+	float* restPositions;			//Three components per node
+	float* modes;					//Three components per node per mode, mode after mode, zero at the fixed nodes
+
+	PrecomputeCache* cache;			//The file the basis is mapped from, or null if it owns its arrays
+}ModalBasis;
+
+typedef struct ModalBody
+{
+	const ModalBasis* basis;
+	float* displacements;			//q of each mode
+	float* velocities;				//q' of each mode
+	float* forces;					//phi^T * f of the forces applied since they were last cleared
+	float* gravityForces;			//phi^T * M * g
+
+	float timeStep;
+	float massDamping;				//Rayleigh damping coefficients
+	float stiffnessDamping;
+}ModalBody;
+
+///
+//Allocates memory for a new modal basis
+//
+//Returns:
+//	Pointer to new modal basis
+ModalBasis* ModalBasis_Allocate();
+
+///
+//Hashes everything the modes of a body depend on: its mesh, fixed nodes, masses and element stiffness
+//matrices (which hold its Young's modulus, Poisson ratio and density), and the settings they are found with
+//
+//Parameters:
+//	body: An initialized corotational body
+//	numModes: The number of modes to find
+//	tolerance: The tolerance of the subspace iterations
+//
+//Returns:
+//	The key of the modes, the same for any two bodies whose modes are the same
+uint64_t ModalBasis_GetKey(const CorotationalBody* body, const uint32_t numModes, const float tolerance);
+
+///
+//Computes the lowest vibration modes of a body with subspace iteration
+//
+//Parameters:
+//	basis: The modal basis to store the modes in
+//	body: An initialized corotational body whose element stiffness matrices, masses and fixed nodes to use
+//	numModes: The number of modes to find
+//	tolerance: The iterations stop once no eigenvalue changed by more than this fraction of itself, around 1e-4 since floats do not settle much below 1e-5
+//
+//Returns:
+//	The number of iterations taken, 0 if the stiffness matrix could not be factored
+uint32_t ModalBasis_Compute(ModalBasis* basis, const CorotationalBody* body, const uint32_t numModes, const float tolerance);
+
+///
+//Saves a modal basis to a precompute cache file, along with the key it was computed with
+//
+//Parameters:
+//	basis: The modal basis to save
+//	fileName: The name of the file to write
+//
+//Returns:
+//	0 if the file could not be written, 1 otherwise
+int ModalBasis_Save(const ModalBasis* basis, const char* fileName);
+
+///
+//Loads a modal basis by mapping a file saved with ModalBasis_Save into memory.
+//The arrays of the basis point into the file, so they must not be changed.
+//
+//Parameters:
+//	basis: An allocated modal basis with no modes to load the modes into
+//	fileName: The name of the file to map
+//	key: ModalBasis_GetKey of the body and settings the modes are wanted for
+//
+//Returns:
+//	0 if the file could not be mapped, does not hold a modal basis or was computed with a different key, 1 otherwise
+int ModalBasis_Load(ModalBasis* basis, const char* fileName, const uint64_t key);
+
+///
+//Frees a modal basis's resources, unmapping its file if it was loaded from one
+//
+//Parameters:
+//	basis: The modal basis to free
+void ModalBasis_Free(ModalBasis* basis);
+
+///
+//Allocates memory for a new modal body
+//
+//Returns:
+//	Pointer to new modal body
+ModalBody* ModalBody_Allocate();
+
+///
+//Initializes a modal body at rest
+//
+//Parameters:
+//	body: The modal body to initialize
+//	basis: The modes the body moves along, which must not be freed before the body
+//	gravity: The acceleration of gravity
+//	timeStep: The amount of time each step moves the body forward
+void ModalBody_Initialize(ModalBody* body, const ModalBasis* basis, const float* gravity, const float timeStep);
+
+///
+//Frees a modal body's resources
+//
+//Parameters:
+//	body: The modal body to free
+void ModalBody_Free(ModalBody* body);
+
+///
+//Removes the forces applied to a modal body
+//
+//Parameters:
+//	body: The modal body to clear the forces of
+void ModalBody_ClearForces(ModalBody* body);
+
+///
+//Applies a force to a node of a modal body until the forces are cleared
+//
+//Parameters:
+//	body: The modal body to apply the force to
+//	node: The node to apply the force to
+//	force: The three components of the force
+void ModalBody_ApplyForce(ModalBody* body, const uint32_t node, const float* force);
+
+///
+//Moves a modal body forward by one time step. This only depends on the number of modes.
+//
+//Parameters:
+//	body: The modal body to step
+void ModalBody_Step(ModalBody* body);
+
+///
+//Computes the positions of the nodes of a modal body
+//
+//Parameters:
+//	positions: An array of three components per node to store the positions in
+//	body: The modal body to get the positions of
+void ModalBody_GetPositions(float* positions, const ModalBody* body);
+
+#endif
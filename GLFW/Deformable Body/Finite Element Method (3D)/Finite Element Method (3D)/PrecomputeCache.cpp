@@ -0,0 +1,278 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "PrecomputeCache.h"
+
+///
+//Rounds a size up to the alignment of the arrays in a cache file
+//
+//Parameters:
+//	size: The size to round up
+//
+//Returns:
+//	The smallest multiple of PRECOMPUTECACHE_ALIGNMENT which is at least size
+static size_t PrecomputeCache_Align(const size_t size)
+{
+	return (size + PRECOMPUTECACHE_ALIGNMENT - 1) & ~(size_t)(PRECOMPUTECACHE_ALIGNMENT - 1);
+}
+
+///
+//Unmaps the file a cache was loaded from
+//
+//Parameters:
+//	cache: The precompute cache to unmap
+static void PrecomputeCache_Unmap(PrecomputeCache* cache)
+{
+#ifdef _WIN32
+	UnmapViewOfFile(cache->mapping);
+	CloseHandle((HANDLE)cache->mappingHandle);
+	CloseHandle((HANDLE)cache->fileHandle);
+#else
+	munmap(cache->mapping, cache->mappingSize);
+#endif
+	cache->mapping = 0x0;
+	cache->mappingSize = 0;
+	cache->key = 0;
+	cache->numArrays = 0;
+}
+
+///
+//Adds data onto a hash with the 64 bit FNV-1a hash function
+//
+//Parameters:
+//	hash: The hash so far, PRECOMPUTECACHE_HASH_SEED to start a new one
+//	data: The data to add
+//	size: The size of the data in bytes
+//
+//Returns:
+//	The hash of everything added so far
+uint64_t PrecomputeCache_Hash(uint64_t hash, const void* data, const size_t size)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+///
+//Allocates memory for a new precompute cache
+//
+//Returns:
+//	Pointer to new precompute cache
+PrecomputeCache* PrecomputeCache_Allocate()
+{
+	PrecomputeCache* cache = (PrecomputeCache*)malloc(sizeof(PrecomputeCache));
+	cache->key = 0;
+	cache->numArrays = 0;
+	cache->mapping = 0x0;
+	cache->mappingSize = 0;
+	cache->fileHandle = 0x0;
+	cache->mappingHandle = 0x0;
+	return cache;
+}
+
+///
+//Saves arrays to a cache file, replacing it if it exists.
+//The arrays are written to a temporary file which is then renamed over the file, so other processes which have
+//the old file mapped keep seeing all of it.
+//
+//Parameters:
+//	fileName: The name of the file to write
+//	key: The hash of the inputs the arrays were computed from
+//	numArrays: The number of arrays to save, at most PRECOMPUTECACHE_MAX_ARRAYS
+//	arrays: The arrays to save
+//	sizes: The size of each array in bytes
+//
+//Returns:
+//	0 if the file could not be written, 1 otherwise
+int PrecomputeCache_Save(const char* fileName, const uint64_t key, const uint32_t numArrays, const void* const* arrays, const size_t* sizes)
+{
+	if (numArrays > PRECOMPUTECACHE_MAX_ARRAYS)
+	{
+		printf("PrecomputeCache_Save failed! A cache can hold at most %d arrays. Cache not saved.\n", PRECOMPUTECACHE_MAX_ARRAYS);
+		return 0;
+	}
+
+	size_t nameLength = strlen(fileName);
+	char* tempName = (char*)malloc(nameLength + 5);
+	memcpy(tempName, fileName, nameLength);
+	memcpy(tempName + nameLength, ".tmp", 5);
+
+	FILE* file = fopen(tempName, "wb");
+	if (file == 0x0)
+	{
+		printf("PrecomputeCache_Save failed! Could not open %s for writing!\n", tempName);
+		free(tempName);
+		return 0;
+	}
+
+	PrecomputeCacheFileHeader header;
+	memset(&header, 0, sizeof(PrecomputeCacheFileHeader));
+	memcpy(header.magic, "FEMCACHE", 8);
+	header.version = PRECOMPUTECACHE_FILE_VERSION;
+	header.numArrays = numArrays;
+	header.key = key;
+	for (uint32_t i = 0; i < numArrays; i++)
+	{
+		header.sizes[i] = sizes[i];
+	}
+
+	//Each array is padded out to the alignment, starting after the header padded out the same way
+	static const char padding[PRECOMPUTECACHE_ALIGNMENT] = { 0 };
+	size_t headerPadding = PrecomputeCache_Align(sizeof(PrecomputeCacheFileHeader)) - sizeof(PrecomputeCacheFileHeader);
+	int written = fwrite(&header, sizeof(PrecomputeCacheFileHeader), 1, file) == 1
+		&& fwrite(padding, 1, headerPadding, file) == headerPadding;
+	for (uint32_t i = 0; i < numArrays && written; i++)
+	{
+		size_t arrayPadding = PrecomputeCache_Align(sizes[i]) - sizes[i];
+		written = fwrite(arrays[i], 1, sizes[i], file) == sizes[i]
+			&& fwrite(padding, 1, arrayPadding, file) == arrayPadding;
+	}
+	written = fclose(file) == 0 && written;
+
+	if (!written)
+	{
+		printf("PrecomputeCache_Save failed! Could not write all of %s!\n", tempName);
+		remove(tempName);
+		free(tempName);
+		return 0;
+	}
+
+#ifdef _WIN32
+	int renamed = MoveFileExA(tempName, fileName, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	int renamed = rename(tempName, fileName) == 0;
+#endif
+	if (!renamed)
+	{
+		printf("PrecomputeCache_Save failed! Could not replace %s!\n", fileName);
+		remove(tempName);
+	}
+	free(tempName);
+	return renamed;
+}
+
+///
+//Loads a cache by mapping a file saved with PrecomputeCache_Save into memory
+//
+//Parameters:
+//	cache: An allocated precompute cache with no file mapped
+//	fileName: The name of the file to map
+//	key: The hash of the current inputs
+//	numArrays: The number of arrays the file must have
+//
+//Returns:
+//	0 if the file could not be mapped, is not a cache, or is out of date, 1 otherwise
+int PrecomputeCache_Load(PrecomputeCache* cache, const char* fileName, const uint64_t key, const uint32_t numArrays)
+{
+	void* memory = 0x0;
+	size_t size = 0;
+
+#ifdef _WIN32
+	//Sharing delete lets PrecomputeCache_Save rename a new file over this one while it is mapped
+	HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		printf("PrecomputeCache_Load failed! Could not open %s!\n", fileName);
+		return 0;
+	}
+	LARGE_INTEGER fileSize;
+	GetFileSizeEx(file, &fileSize);
+	size = (size_t)fileSize.QuadPart;
+	HANDLE mappingHandle = size > 0 ? CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+	if (mappingHandle != NULL) memory = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (memory == 0x0)
+	{
+		printf("PrecomputeCache_Load failed! Could not map %s!\n", fileName);
+		if (mappingHandle != NULL) CloseHandle(mappingHandle);
+		CloseHandle(file);
+		return 0;
+	}
+	cache->fileHandle = file;
+	cache->mappingHandle = mappingHandle;
+#else
+	int file = open(fileName, O_RDONLY);
+	if (file < 0)
+	{
+		printf("PrecomputeCache_Load failed! Could not open %s!\n", fileName);
+		return 0;
+	}
+	struct stat status;
+	if (fstat(file, &status) == 0) size = (size_t)status.st_size;
+	if (size > 0) memory = mmap(0x0, size, PROT_READ, MAP_SHARED, file, 0);
+	close(file);
+	if (memory == 0x0 || memory == MAP_FAILED)
+	{
+		printf("PrecomputeCache_Load failed! Could not map %s!\n", fileName);
+		return 0;
+	}
+	cache->fileHandle = 0x0;
+	cache->mappingHandle = 0x0;
+#endif
+
+	cache->mapping = memory;
+	cache->mappingSize = size;
+
+	//Check the file is a cache of the inputs given
+	const PrecomputeCacheFileHeader* header = (const PrecomputeCacheFileHeader*)memory;
+	if (size < sizeof(PrecomputeCacheFileHeader) || memcmp(header->magic, "FEMCACHE", 8) != 0 || header->version != PRECOMPUTECACHE_FILE_VERSION)
+	{
+		printf("PrecomputeCache_Load failed! %s is not a cache file of version %d!\n", fileName, PRECOMPUTECACHE_FILE_VERSION);
+		PrecomputeCache_Unmap(cache);
+		return 0;
+	}
+	if (header->key != key || header->numArrays != numArrays)
+	{
+		printf("PrecomputeCache_Load failed! %s was computed from different inputs!\n", fileName);
+		PrecomputeCache_Unmap(cache);
+		return 0;
+	}
+
+	//Check the file holds every array the header says, and point at them
+	size_t offset = PrecomputeCache_Align(sizeof(PrecomputeCacheFileHeader));
+	for (uint32_t i = 0; i < numArrays; i++)
+	{
+		if (offset > size || header->sizes[i] > size - offset)
+		{
+			printf("PrecomputeCache_Load failed! %s is missing part of its arrays!\n", fileName);
+			PrecomputeCache_Unmap(cache);
+			return 0;
+		}
+		cache->arrays[i] = (const char*)memory + offset;
+		cache->sizes[i] = (size_t)header->sizes[i];
+		offset += PrecomputeCache_Align(cache->sizes[i]);
+	}
+
+	cache->key = key;
+	cache->numArrays = numArrays;
+	return 1;
+}
+
+///
+//Frees a precompute cache's resources, unmapping its file
+//
+//Parameters:
+//	cache: The precompute cache to free
+void PrecomputeCache_Free(PrecomputeCache* cache)
+{
+	if (cache->mapping != 0x0)
+	{
+		PrecomputeCache_Unmap(cache);
+	}
+	free(cache);
+}
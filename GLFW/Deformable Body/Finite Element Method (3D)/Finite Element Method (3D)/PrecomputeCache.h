@@ -0,0 +1,110 @@
+/*
+A file which saves the arrays a simulation precomputes at startup, so later runs with the same inputs can skip
+computing them again.
+
+The file starts with a key: a hash of everything the arrays were computed from (the mesh, the material and the
+boundary conditions). A cache is only loaded if its key matches the key of the current inputs, so changing any input
+makes the old file out of date and the arrays are computed and saved again.
+
+The arrays are stored one after another, each starting on a multiple of PRECOMPUTECACHE_ALIGNMENT bytes, so loading the
+cache maps the file into memory and points at the arrays where they are instead of reading them. Startup then takes
+about as long as the operating system takes to map the file, and the pages of an array are only read from disk when it
+is first used. The mapping is read only, so the arrays must not be changed. Saving never changes a file in place:
+a new file is written beside it and renamed over it, so a process which still has the old file mapped keeps it whole.
+
+The arrays are written in the byte order of the machine which saved them, so a cache should not be copied to a machine
+of a different byte order.
+*/
+
+#ifndef PRECOMPUTECACHE_H
+#define PRECOMPUTECACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define PRECOMPUTECACHE_FILE_VERSION 1
+#define PRECOMPUTECACHE_MAX_ARRAYS 8
+#define PRECOMPUTECACHE_ALIGNMENT 16
+
+//The hash to start a key from (the FNV-1a offset basis)
+#define PRECOMPUTECACHE_HASH_SEED 14695981039346656037ULL
+
+typedef struct PrecomputeCacheFileHeader
+{
+	char magic[8];								//"FEMCACHE"
+	uint32_t version;
+	uint32_t numArrays;
+	uint64_t key;
+	uint64_t sizes[PRECOMPUTECACHE_MAX_ARRAYS];	//Size of each array in bytes
+}PrecomputeCacheFileHeader;
+
+typedef struct PrecomputeCache
+{
+	uint64_t key;
+	uint32_t numArrays;
+	const void* arrays[PRECOMPUTECACHE_MAX_ARRAYS];	//Point into the mapped file
+	size_t sizes[PRECOMPUTECACHE_MAX_ARRAYS];
+
+	//The mapped file
+	void* mapping;
+	size_t mappingSize;
+	void* fileHandle;
+	void* mappingHandle;
+}PrecomputeCache;
+
+///
+//Adds data onto a hash with the 64 bit FNV-1a hash function
+//
+//Parameters:
+//	hash: The hash so far, PRECOMPUTECACHE_HASH_SEED to start a new one
+//	data: The data to add
+//	size: The size of the data in bytes
+//
+//Returns:
+//	The hash of everything added so far
+uint64_t PrecomputeCache_Hash(uint64_t hash, const void* data, const size_t size);
+
+///
+//Allocates memory for a new precompute cache
+//
+//Returns:
+//	Pointer to new precompute cache
+PrecomputeCache* PrecomputeCache_Allocate();
+
+///
+//Saves arrays to a cache file, replacing it if it exists.
+//The arrays are written to a temporary file which is then renamed over the file, so other processes which have
+//the old file mapped keep seeing all of it.
+//
+//Parameters:
+//	fileName: The name of the file to write
+//	key: The hash of the inputs the arrays were computed from
+//	numArrays: The number of arrays to save, at most PRECOMPUTECACHE_MAX_ARRAYS
+//	arrays: The arrays to save
+//	sizes: The size of each array in bytes
+//
+//Returns:
+//	0 if the file could not be written, 1 otherwise
+int PrecomputeCache_Save(const char* fileName, const uint64_t key, const uint32_t numArrays, const void* const* arrays, const size_t* sizes);
+
+///
+//Loads a cache by mapping a file saved with PrecomputeCache_Save into memory
+//
+//Parameters:
+//	cache: An allocated precompute cache with no file mapped
+//	fileName: The name of the file to map
+//	key: The hash of the current inputs
+//	numArrays: The number of arrays the file must have
+//
+//Returns:
+//	0 if the file could not be mapped, is not a cache, or is out of date, 1 otherwise
+int PrecomputeCache_Load(PrecomputeCache* cache, const char* fileName, const uint64_t key, const uint32_t numArrays);
+
+///
+//Frees a precompute cache's resources, unmapping its file
+//
+//Parameters:
+//	cache: The precompute cache to free
+void PrecomputeCache_Free(PrecomputeCache* cache);
+
+#endif
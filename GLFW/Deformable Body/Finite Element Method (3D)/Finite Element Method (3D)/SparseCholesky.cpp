@@ -0,0 +1,435 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+
+#include "SparseCholesky.h"
+
+//Marks a missing node in the elimination tree and in the breadth first searches
+#define SPARSECHOLESKY_NONE 0xFFFFFFFF
+
+///
+//Allocates memory for a new sparse Cholesky factorization
+//
+//Returns:
+//	Pointer to new sparse Cholesky factorization
+SparseCholesky* SparseCholesky_Allocate()
+{
+	SparseCholesky* factor = (SparseCholesky*)malloc(sizeof(SparseCholesky));
+	factor->dimension = 0;
+	factor->permutation = 0x0;
+	factor->numNonzeros = 0;
+	factor->columnStart = 0x0;
+	factor->rows = 0x0;
+	factor->values = 0x0;
+	return factor;
+}
+
+///
+//Frees a sparse Cholesky factorization's resources
+//
+//Parameters:
+//	factor: Sparse Cholesky factorization to free
+void SparseCholesky_Free(SparseCholesky* factor)
+{
+	free(factor->permutation);
+	free(factor->columnStart);
+	free(factor->rows);
+	free(factor->values);
+	free(factor);
+}
+
+///
+//Gets the number of other rows a row of a symmetric matrix is connected to
+static uint32_t SparseCholesky_GetDegree(const SparseMatrix* mat, const uint32_t row)
+{
+	uint32_t degree = 0;
+	for (uint32_t p = mat->rowStart[row]; p < mat->rowStart[row + 1]; p++)
+	{
+		if (mat->columns[p] != row) degree++;
+	}
+	return degree;
+}
+
+///
+//Searches breadth first through the rows connected to a root which are not yet ordered
+//
+//Parameters:
+//	queue: An array to store the rows in, in the order they are reached
+//	level: The level of each row reached, set for every row in the queue
+//	mat: The symmetric matrix being searched
+//	root: The row to start from
+//	ordered: Which rows have already been ordered and are skipped
+//
+//Returns:
+//	The number of rows reached
+static uint32_t SparseCholesky_SearchLevels(uint32_t* queue, uint32_t* level, const SparseMatrix* mat, const uint32_t root, const uint8_t* ordered)
+{
+	uint32_t head = 0;
+	uint32_t tail = 0;
+	queue[tail++] = root;
+	level[root] = 0;
+	while (head < tail)
+	{
+		uint32_t row = queue[head++];
+		for (uint32_t p = mat->rowStart[row]; p < mat->rowStart[row + 1]; p++)
+		{
+			uint32_t neighbor = mat->columns[p];
+			if (ordered[neighbor] || level[neighbor] != SPARSECHOLESKY_NONE) continue;
+			level[neighbor] = level[row] + 1;
+			queue[tail++] = neighbor;
+		}
+	}
+	return tail;
+}
+
+///
+//Finds the reverse Cuthill-McKee ordering of a symmetric sparse matrix.
+//Each connected part of the matrix's graph is started from a node of least degree at the far end of the part.
+//
+//Parameters:
+//	permutation: An array of numRows indices to store the ordering in. Row i of the reordered matrix is row permutation[i].
+//	mat: The compressed symmetric matrix to order
+void SparseCholesky_GetReverseCuthillMcKee(uint32_t* permutation, const SparseMatrix* mat)
+{
+	uint32_t n = mat->numRows;
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	uint32_t* degree = (uint32_t*)Arena_Push(scratch, sizeof(uint32_t) * n);
+	uint32_t* level = (uint32_t*)Arena_Push(scratch, sizeof(uint32_t) * n);
+	uint32_t* queue = (uint32_t*)Arena_Push(scratch, sizeof(uint32_t) * n);
+	uint8_t* ordered = (uint8_t*)Arena_Push(scratch, sizeof(uint8_t) * n);
+	for (uint32_t i = 0; i < n; i++)
+	{
+		degree[i] = SparseCholesky_GetDegree(mat, i);
+		level[i] = SPARSECHOLESKY_NONE;
+		ordered[i] = 0;
+	}
+
+	uint32_t numOrdered = 0;
+	for (uint32_t seed = 0; seed < n; seed++)
+	{
+		if (ordered[seed]) continue;
+
+		//Find a node at the far end of this part of the graph: search from the root, move the root to the
+		//least connected node of the last level, and repeat while that makes the search any deeper
+		uint32_t root = seed;
+		uint32_t depth = 0;
+		for (int attempt = 0; attempt < 8; attempt++)
+		{
+			uint32_t reached = SparseCholesky_SearchLevels(queue, level, mat, root, ordered);
+			uint32_t lastLevel = level[queue[reached - 1]];
+			uint32_t candidate = queue[reached - 1];
+			for (uint32_t q = reached; q > 0 && level[queue[q - 1]] == lastLevel; q--)
+			{
+				if (degree[queue[q - 1]] < degree[candidate]) candidate = queue[q - 1];
+			}
+			for (uint32_t q = 0; q < reached; q++) level[queue[q]] = SPARSECHOLESKY_NONE;
+
+			if (attempt > 0 && lastLevel <= depth) break;
+			depth = lastLevel;
+			root = candidate;
+		}
+
+		//Cuthill-McKee: number the part breadth first from the root, visiting the neighbors of each node from least to most connected
+		uint32_t head = numOrdered;
+		uint32_t tail = numOrdered;
+		permutation[tail++] = root;
+		ordered[root] = 1;
+		while (head < tail)
+		{
+			uint32_t row = permutation[head++];
+			uint32_t first = tail;
+			for (uint32_t p = mat->rowStart[row]; p < mat->rowStart[row + 1]; p++)
+			{
+				uint32_t neighbor = mat->columns[p];
+				if (ordered[neighbor]) continue;
+				ordered[neighbor] = 1;
+
+				//Insert the neighbor into the newly queued rows, sorted by degree
+				uint32_t q = tail++;
+				while (q > first && degree[permutation[q - 1]] > degree[neighbor])
+				{
+					permutation[q] = permutation[q - 1];
+					q--;
+				}
+				permutation[q] = neighbor;
+			}
+		}
+		numOrdered = tail;
+	}
+
+	//Reverse the ordering
+	for (uint32_t i = 0; i < n / 2; i++)
+	{
+		uint32_t temp = permutation[i];
+		permutation[i] = permutation[n - 1 - i];
+		permutation[n - 1 - i] = temp;
+	}
+
+	Arena_ResetToMarker(scratch, marker);
+}
+
+///
+//Finds the nonzero pattern of row k of L, which is every node on the paths up the elimination tree from the
+//nonzero components of row k of the reordered matrix, stopping at k.
+//
+//Parameters:
+//	pattern: An array of dimension indices. The pattern is stored at the end of it, from the returned index on,
+//		in an order where every column comes after the columns it depends on.
+//	stack: An array of dimension indices to hold each path while it is reversed
+//	mark: The row last reached at each node, which must not be k for any node before this call
+//	upperStart, upperRows: The components on and above the diagonal of the reordered matrix, by columns
+//	parent: The elimination tree
+//	k: The row of L to find
+//	dimension: The number of rows of the matrix
+//
+//Returns:
+//	The index of the start of the pattern
+static uint32_t SparseCholesky_GetRowPattern(uint32_t* pattern, uint32_t* stack, uint32_t* mark, const uint32_t* upperStart, const uint32_t* upperRows, const uint32_t* parent, const uint32_t k, const uint32_t dimension)
+{
+	uint32_t top = dimension;
+	mark[k] = k;
+	for (uint32_t p = upperStart[k]; p < upperStart[k + 1]; p++)
+	{
+		uint32_t i = upperRows[p];
+		uint32_t length = 0;
+		for (; mark[i] != k; i = parent[i])
+		{
+			stack[length++] = i;
+			mark[i] = k;
+		}
+		while (length > 0)
+		{
+			pattern[--top] = stack[--length];
+		}
+	}
+	return top;
+}
+
+///
+//Factors a symmetric positive definite sparse matrix
+//
+//Parameters:
+//	factor: An allocated sparse Cholesky factorization to store the factorization in
+//	mat: The compressed symmetric positive definite matrix to factor
+//
+//Returns:
+//	0 if the matrix is not positive definite, 1 otherwise
+int SparseCholesky_Decompose(SparseCholesky* factor, const SparseMatrix* mat)
+{
+	uint32_t n = mat->numRows;
+	free(factor->permutation);
+	free(factor->columnStart);
+	free(factor->rows);
+	free(factor->values);
+	factor->dimension = n;
+	factor->permutation = (uint32_t*)malloc(sizeof(uint32_t) * (n > 0 ? n : 1));
+	factor->columnStart = (uint32_t*)malloc(sizeof(uint32_t) * (n + 1));
+	factor->rows = 0x0;
+	factor->values = 0x0;
+	factor->numNonzeros = 0;
+
+	SparseCholesky_GetReverseCuthillMcKee(factor->permutation, mat);
+
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	uint32_t* inverse = (uint32_t*)Arena_Push(scratch, sizeof(uint32_t) * n);
+	for (uint32_t i = 0; i < n; i++)
+	{
+		inverse[factor->permutation[i]] = i;
+	}
+
+	//Gather the components on and above the diagonal of the reordered matrix by columns.
+	//Component (i, j) of the matrix is component (inverse[i], inverse[j]) of the reordered matrix.
+	uint32_t* upperStart = (uint32_t*)Arena_Push(scratch, sizeof(uint32_t) * (n + 1));
+	memset(upperStart, 0, sizeof(uint32_t) * (n + 1));
+	for (uint32_t row = 0; row < n; row++)
+	{
+		for (uint32_t p = mat->rowStart[row]; p < mat->rowStart[row + 1]; p++)
+		{
+			uint32_t a = inverse[row];
+			uint32_t b = inverse[mat->columns[p]];
+			if (a <= b) upperStart[b + 1]++;
+		}
+	}
+	for (uint32_t col = 0; col < n; col++)
+	{
+		upperStart[col + 1] += upperStart[col];
+	}
+	uint32_t* upperRows = (uint32_t*)Arena_Push(scratch, sizeof(uint32_t) * upperStart[n]);
+	float* upperValues = (float*)Arena_Push(scratch, sizeof(float) * upperStart[n]);
+	uint32_t* next = (uint32_t*)Arena_Push(scratch, sizeof(uint32_t) * (n + 1));
+	memcpy(next, upperStart, sizeof(uint32_t) * (n + 1));
+	for (uint32_t row = 0; row < n; row++)
+	{
+		for (uint32_t p = mat->rowStart[row]; p < mat->rowStart[row + 1]; p++)
+		{
+			uint32_t a = inverse[row];
+			uint32_t b = inverse[mat->columns[p]];
+			if (a <= b)
+			{
+				upperRows[next[b]] = a;
+				upperValues[next[b]++] = mat->values[p];
+			}
+		}
+	}
+
+	//Build the elimination tree: the parent of column i is the first row below i with a nonzero in column i of L.
+	//The ancestors are path compressed so walking up the tree stays fast.
+	uint32_t* parent = (uint32_t*)Arena_Push(scratch, sizeof(uint32_t) * n);
+	uint32_t* ancestor = (uint32_t*)Arena_Push(scratch, sizeof(uint32_t) * n);
+	for (uint32_t k = 0; k < n; k++)
+	{
+		parent[k] = SPARSECHOLESKY_NONE;
+		ancestor[k] = SPARSECHOLESKY_NONE;
+		for (uint32_t p = upperStart[k]; p < upperStart[k + 1]; p++)
+		{
+			uint32_t i = upperRows[p];
+			while (i != SPARSECHOLESKY_NONE && i < k)
+			{
+				uint32_t nextAncestor = ancestor[i];
+				ancestor[i] = k;
+				if (nextAncestor == SPARSECHOLESKY_NONE) parent[i] = k;
+				i = nextAncestor;
+			}
+		}
+	}
+
+	//Count the components of each column of L from the pattern of each row
+	uint32_t* pattern = (uint32_t*)Arena_Push(scratch, sizeof(uint32_t) * n);
+	uint32_t* stack = (uint32_t*)Arena_Push(scratch, sizeof(uint32_t) * n);
+	uint32_t* mark = (uint32_t*)Arena_Push(scratch, sizeof(uint32_t) * n);
+	for (uint32_t i = 0; i < n; i++)
+	{
+		mark[i] = SPARSECHOLESKY_NONE;
+		factor->columnStart[i + 1] = 1;
+	}
+	factor->columnStart[0] = 0;
+	for (uint32_t k = 0; k < n; k++)
+	{
+		uint32_t top = SparseCholesky_GetRowPattern(pattern, stack, mark, upperStart, upperRows, parent, k, n);
+		for (; top < n; top++)
+		{
+			factor->columnStart[pattern[top] + 1]++;
+		}
+	}
+	for (uint32_t col = 0; col < n; col++)
+	{
+		factor->columnStart[col + 1] += factor->columnStart[col];
+	}
+	factor->numNonzeros = factor->columnStart[n];
+	factor->rows = (uint32_t*)malloc(sizeof(uint32_t) * (factor->numNonzeros > 0 ? factor->numNonzeros : 1));
+	factor->values = (float*)malloc(sizeof(float) * (factor->numNonzeros > 0 ? factor->numNonzeros : 1));
+
+	//Compute each row of L by solving L(0:k-1, 0:k-1) * L(k, 0:k-1)^T = A(0:k-1, k) over its pattern
+	float* x = (float*)Arena_Push(scratch, sizeof(float) * n);
+	for (uint32_t i = 0; i < n; i++)
+	{
+		mark[i] = SPARSECHOLESKY_NONE;
+		next[i] = factor->columnStart[i];
+		x[i] = 0.0f;
+	}
+
+	int positiveDefinite = 1;
+	for (uint32_t k = 0; k < n && positiveDefinite; k++)
+	{
+		uint32_t top = SparseCholesky_GetRowPattern(pattern, stack, mark, upperStart, upperRows, parent, k, n);
+		for (uint32_t p = upperStart[k]; p < upperStart[k + 1]; p++)
+		{
+			x[upperRows[p]] = upperValues[p];
+		}
+		float diagonal = x[k];
+		x[k] = 0.0f;
+
+		for (; top < n; top++)
+		{
+			uint32_t i = pattern[top];
+			float component = x[i] / factor->values[factor->columnStart[i]];
+			x[i] = 0.0f;
+			for (uint32_t p = factor->columnStart[i] + 1; p < next[i]; p++)
+			{
+				x[factor->rows[p]] -= factor->values[p] * component;
+			}
+			diagonal -= component * component;
+
+			uint32_t p = next[i]++;
+			factor->rows[p] = k;
+			factor->values[p] = component;
+		}
+
+		if (diagonal <= 0.0f)
+		{
+			positiveDefinite = 0;
+			break;
+		}
+		uint32_t p = next[k]++;
+		factor->rows[p] = k;
+		factor->values[p] = sqrtf(diagonal);
+	}
+
+	Arena_ResetToMarker(scratch, marker);
+	return positiveDefinite;
+}
+
+///
+//Solves the system of equations A * x = b in place using the factorization of A
+//
+//Parameters:
+//	vector: The right hand side b, replaced by the solution x
+//	factor: The factorization of A from SparseCholesky_Decompose
+void SparseCholesky_SolveArray(float* vector, const SparseCholesky* factor)
+{
+	uint32_t n = factor->dimension;
+	const uint32_t* columnStart = factor->columnStart;
+	const uint32_t* rows = factor->rows;
+	const float* values = factor->values;
+
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	float* reordered = (float*)Arena_Push(scratch, sizeof(float) * n);
+	for (uint32_t i = 0; i < n; i++)
+	{
+		reordered[i] = vector[factor->permutation[i]];
+	}
+
+	//Forward substitution, L * y = P * b, a column at a time
+	for (uint32_t col = 0; col < n; col++)
+	{
+		float y = reordered[col] / values[columnStart[col]];
+		reordered[col] = y;
+		for (uint32_t p = columnStart[col] + 1; p < columnStart[col + 1]; p++)
+		{
+			reordered[rows[p]] -= values[p] * y;
+		}
+	}
+
+	//Back substitution, L^T * z = y, where column j of L is row j of L^T
+	for (uint32_t col = n; col > 0; col--)
+	{
+		float sum = reordered[col - 1];
+		for (uint32_t p = columnStart[col - 1] + 1; p < columnStart[col]; p++)
+		{
+			sum -= values[p] * reordered[rows[p]];
+		}
+		reordered[col - 1] = sum / values[columnStart[col - 1]];
+	}
+
+	for (uint32_t i = 0; i < n; i++)
+	{
+		vector[factor->permutation[i]] = reordered[i];
+	}
+	Arena_ResetToMarker(scratch, marker);
+}
+//Checks for errors then calls SparseCholesky_SolveArray
+void SparseCholesky_Solve(Vector* vector, const SparseCholesky* factor)
+{
+	if (vector->dimension != factor->dimension)
+	{
+		printf("SparseCholesky_Solve failed! Operands are of incompatible sizes. System not solved.\n");
+	}
+	else
+	{
+		SparseCholesky_SolveArray(vector->components, factor);
+	}
+}
@@ -0,0 +1,88 @@
+/*
+A sparse Cholesky factorization, A = P^T * L * L^T * P, of a symmetric positive definite sparse matrix A. Once
+a matrix has been factored, each system of equations A * x = b is solved exactly by one forward and one back
+substitution, which is how a finite element body whose system matrix does not change can be stepped without
+iterating.
+
+Unlike the incomplete Cholesky factorization of SparseMatrix, the factor L has nonzero components wherever the
+elimination fills them in, not only where A has them. How much fill there is depends heavily on the order of the
+rows and columns, so before factoring they are reordered with the reverse Cuthill-McKee ordering, which numbers
+the rows in breadth first order through the graph of the matrix. This keeps every row's components close to the
+diagonal, and for a long mesh like a beam the fill stays within a narrow band.
+
+The factorization works one row of L at a time (an up-looking Cholesky). The nonzero pattern of each row is found
+by walking the elimination tree of the matrix up from the nonzero components of that row of A, so a first pass
+counts the components of each column of L and a second pass computes them, with no wasted space.
+
+L is stored by columns: the components of column j are stored from columnStart[j] up to columnStart[j + 1] - 1,
+in the rows and values arrays, starting with the diagonal.
+
+References:
+Direct Methods for Sparse Linear Systems by Timothy A. Davis
+*/
+
+#ifndef SPARSECHOLESKY_H
+#define SPARSECHOLESKY_H
+
+#include "SparseMatrix.h"
+#include <stdint.h>
+
+typedef struct SparseCholesky
+{
+	uint32_t dimension;
+
+	//Row i of the reordered matrix is row permutation[i] of A
+	uint32_t* permutation;
+
+	//The factor L by columns
+	uint32_t numNonzeros;
+	uint32_t* columnStart;
+	uint32_t* rows;
+	float* values;
+}SparseCholesky;
+
+///
+//Allocates memory for a new sparse Cholesky factorization
+//
+//Returns:
+//	Pointer to new sparse Cholesky factorization
+SparseCholesky* SparseCholesky_Allocate();
+
+///
+//Frees a sparse Cholesky factorization's resources
+//
+//Parameters:
+//	factor: Sparse Cholesky factorization to free
+void SparseCholesky_Free(SparseCholesky* factor);
+
+///
+//Finds the reverse Cuthill-McKee ordering of a symmetric sparse matrix.
+//Each connected part of the matrix's graph is started from a node of least degree at the far end of the part.
+//
+//Parameters:
+//	permutation: An array of numRows indices to store the ordering in. Row i of the reordered matrix is row permutation[i].
+//	mat: The compressed symmetric matrix to order
+void SparseCholesky_GetReverseCuthillMcKee(uint32_t* permutation, const SparseMatrix* mat);
+
+///
+//Factors a symmetric positive definite sparse matrix
+//
+//Parameters:
+//	factor: An allocated sparse Cholesky factorization to store the factorization in
+//	mat: The compressed symmetric positive definite matrix to factor
+//
+//Returns:
+//	0 if the matrix is not positive definite, 1 otherwise
+int SparseCholesky_Decompose(SparseCholesky* factor, const SparseMatrix* mat);
+
+///
+//Solves the system of equations A * x = b in place using the factorization of A
+//
+//Parameters:
+//	vector: The right hand side b, replaced by the solution x
+//	factor: The factorization of A from SparseCholesky_Decompose
+void SparseCholesky_SolveArray(float* vector, const SparseCholesky* factor);
+//Checks for errors then calls SparseCholesky_SolveArray
+void SparseCholesky_Solve(Vector* vector, const SparseCholesky* factor);
+
+#endif
@@ -0,0 +1,544 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+
+#include "SparseMatrix.h"
+
+///
+//Allocates memory for a new sparse matrix
+//
+//Returns:
+//	Pointer to new sparse matrix
+SparseMatrix* SparseMatrix_Allocate()
+{
+	SparseMatrix* mat = (SparseMatrix*)malloc(sizeof(SparseMatrix));
+	return mat;
+}
+
+///
+//Initializes a sparse matrix with no nonzero components
+//
+//Parameters:
+//	mat: Sparse matrix to initialize
+//	numRows: The number of rows in the matrix
+//	numCols: The number of columns in the matrix
+void SparseMatrix_Initialize(SparseMatrix* mat, const uint32_t numRows, const uint32_t numCols)
+{
+	mat->numRows = numRows;
+	mat->numColumns = numCols;
+
+	mat->numTriplets = 0;
+	mat->tripletCapacity = 0;
+	mat->tripletRows = 0x0;
+	mat->tripletColumns = 0x0;
+	mat->tripletValues = 0x0;
+
+	mat->numNonzeros = 0;
+	mat->rowStart = (uint32_t*)calloc(sizeof(uint32_t), numRows + 1);
+	mat->columns = 0x0;
+	mat->values = 0x0;
+}
+
+///
+//Frees a sparse matrix's resources
+//
+//Parameters:
+//	mat: Sparse matrix to free
+void SparseMatrix_Free(SparseMatrix* mat)
+{
+	free(mat->tripletRows);
+	free(mat->tripletColumns);
+	free(mat->tripletValues);
+
+	free(mat->rowStart);
+	free(mat->columns);
+	free(mat->values);
+	free(mat);
+}
+
+///
+//Adds a value onto a component of a sparse matrix. The value is summed with the component when the matrix is compressed.
+//The triplet arrays double in size whenever they fill up.
+//
+//Parameters:
+//	mat: The sparse matrix to add to
+//	row: The row of the component
+//	col: The column of the component
+//	value: The value to add
+void SparseMatrix_AddTriplet(SparseMatrix* mat, const uint32_t row, const uint32_t col, const float value)
+{
+	if (row >= mat->numRows || col >= mat->numColumns)
+	{
+		printf("SparseMatrix_AddTriplet failed! Index is not valid. Triplet not added.\n");
+		return;
+	}
+
+	if (mat->numTriplets == mat->tripletCapacity)
+	{
+		mat->tripletCapacity = mat->tripletCapacity == 0 ? 16 : mat->tripletCapacity * 2;
+		mat->tripletRows = (uint32_t*)realloc(mat->tripletRows, sizeof(uint32_t) * mat->tripletCapacity);
+		mat->tripletColumns = (uint32_t*)realloc(mat->tripletColumns, sizeof(uint32_t) * mat->tripletCapacity);
+		mat->tripletValues = (float*)realloc(mat->tripletValues, sizeof(float) * mat->tripletCapacity);
+	}
+
+	mat->tripletRows[mat->numTriplets] = row;
+	mat->tripletColumns[mat->numTriplets] = col;
+	mat->tripletValues[mat->numTriplets] = value;
+	mat->numTriplets++;
+}
+
+///
+//Sums the triplets added since the last compression into the compressed sparse rows.
+//
+//The components already compressed and the new triplets are placed into their rows with a counting sort.
+//Each row is then sorted by column with an insertion sort (rows of a stiffness matrix are short), and runs of
+//the same column are summed into one component.
+//
+//Parameters:
+//	mat: The sparse matrix to compress
+void SparseMatrix_Compress(SparseMatrix* mat)
+{
+	uint32_t numRows = mat->numRows;
+	uint32_t total = mat->numNonzeros + mat->numTriplets;
+
+	//Count the components of each row
+	uint32_t* rowStart = (uint32_t*)calloc(sizeof(uint32_t), numRows + 1);
+	for (uint32_t row = 0; row < numRows; row++)
+	{
+		rowStart[row + 1] = mat->rowStart[row + 1] - mat->rowStart[row];
+	}
+	for (uint32_t i = 0; i < mat->numTriplets; i++)
+	{
+		rowStart[mat->tripletRows[i] + 1]++;
+	}
+	for (uint32_t row = 0; row < numRows; row++)
+	{
+		rowStart[row + 1] += rowStart[row];
+	}
+
+	//Place every component in its row
+	uint32_t* columns = (uint32_t*)malloc(sizeof(uint32_t) * (total > 0 ? total : 1));
+	float* values = (float*)malloc(sizeof(float) * (total > 0 ? total : 1));
+	uint32_t* next = (uint32_t*)malloc(sizeof(uint32_t) * (numRows > 0 ? numRows : 1));
+	for (uint32_t row = 0; row < numRows; row++)
+	{
+		next[row] = rowStart[row];
+		for (uint32_t i = mat->rowStart[row]; i < mat->rowStart[row + 1]; i++)
+		{
+			columns[next[row]] = mat->columns[i];
+			values[next[row]++] = mat->values[i];
+		}
+	}
+	for (uint32_t i = 0; i < mat->numTriplets; i++)
+	{
+		uint32_t row = mat->tripletRows[i];
+		columns[next[row]] = mat->tripletColumns[i];
+		values[next[row]++] = mat->tripletValues[i];
+	}
+	free(next);
+
+	//Sort each row by column and sum duplicates, moving the rows down over the removed duplicates
+	uint32_t numNonzeros = 0;
+	for (uint32_t row = 0; row < numRows; row++)
+	{
+		uint32_t start = rowStart[row];
+		uint32_t end = rowStart[row + 1];
+
+		for (uint32_t i = start + 1; i < end; i++)
+		{
+			uint32_t column = columns[i];
+			float value = values[i];
+			uint32_t j = i;
+			while (j > start && columns[j - 1] > column)
+			{
+				columns[j] = columns[j - 1];
+				values[j] = values[j - 1];
+				j--;
+			}
+			columns[j] = column;
+			values[j] = value;
+		}
+
+		rowStart[row] = numNonzeros;
+		for (uint32_t i = start; i < end; i++)
+		{
+			if (numNonzeros > rowStart[row] && columns[numNonzeros - 1] == columns[i])
+			{
+				values[numNonzeros - 1] += values[i];
+			}
+			else
+			{
+				columns[numNonzeros] = columns[i];
+				values[numNonzeros] = values[i];
+				numNonzeros++;
+			}
+		}
+	}
+	rowStart[numRows] = numNonzeros;
+
+	free(mat->rowStart);
+	free(mat->columns);
+	free(mat->values);
+	mat->rowStart = rowStart;
+	mat->columns = columns;
+	mat->values = values;
+	mat->numNonzeros = numNonzeros;
+
+	free(mat->tripletRows);
+	free(mat->tripletColumns);
+	free(mat->tripletValues);
+	mat->tripletRows = 0x0;
+	mat->tripletColumns = 0x0;
+	mat->tripletValues = 0x0;
+	mat->numTriplets = 0;
+	mat->tripletCapacity = 0;
+}
+
+///
+//Indexes a compressed sparse matrix with a binary search of the row
+//
+//Parameters:
+//	mat: The matrix to index
+//	row: The row of the element we wish to index
+//	col: The column of the element we wish to index
+//
+//Returns:
+//	A pointer to the component, or null if the component is not stored
+float* SparseMatrix_Index(SparseMatrix* mat, const uint32_t row, const uint32_t col)
+{
+	if (row >= mat->numRows || col >= mat->numColumns)
+	{
+		printf("SparseMatrix_Index failed! Index is not valid. Index not found, returning null pointer.\n");
+		return 0x0;
+	}
+
+	uint32_t low = mat->rowStart[row];
+	uint32_t high = mat->rowStart[row + 1];
+	while (low < high)
+	{
+		uint32_t middle = (low + high) / 2;
+		if (mat->columns[middle] < col) low = middle + 1;
+		else high = middle;
+	}
+	return low < mat->rowStart[row + 1] && mat->columns[low] == col ? mat->values + low : 0x0;
+}
+//Const correct indexing, returns 0 if the component is not stored
+float SparseMatrix_GetIndex(const SparseMatrix* mat, const uint32_t row, const uint32_t col)
+{
+	float* component = SparseMatrix_Index((SparseMatrix*)mat, row, col);
+	return component ? *component : 0.0f;
+}
+
+///
+//Gets the compressed matrix with one row and one column removed, as when a boundary condition is applied
+//
+//Parameters:
+//	dest: An initialized sparse matrix with one less row and column than mat to store the minor in
+//	mat: The compressed sparse matrix to get the minor of
+//	row: The row to remove
+//	col: The column to remove
+void SparseMatrix_GetMinor(SparseMatrix* dest, const SparseMatrix* mat, const uint32_t row, const uint32_t col)
+{
+	if (dest->numRows != mat->numRows - 1 || dest->numColumns != mat->numColumns - 1)
+	{
+		printf("SparseMatrix_GetMinor failed! Destination matrix is not of proper dimensions. Minor not retrieved.\n");
+		return;
+	}
+	else if (row >= mat->numRows || col >= mat->numColumns)
+	{
+		printf("SparseMatrix_GetMinor failed! Row or column to remove is not in the matrix. Minor not retrieved.\n");
+		return;
+	}
+
+	free(dest->columns);
+	free(dest->values);
+	dest->columns = (uint32_t*)malloc(sizeof(uint32_t) * (mat->numNonzeros > 0 ? mat->numNonzeros : 1));
+	dest->values = (float*)malloc(sizeof(float) * (mat->numNonzeros > 0 ? mat->numNonzeros : 1));
+
+	uint32_t numNonzeros = 0;
+	uint32_t destRow = 0;
+	for (uint32_t srcRow = 0; srcRow < mat->numRows; srcRow++)
+	{
+		if (srcRow == row) continue;
+
+		dest->rowStart[destRow] = numNonzeros;
+		for (uint32_t i = mat->rowStart[srcRow]; i < mat->rowStart[srcRow + 1]; i++)
+		{
+			if (mat->columns[i] == col) continue;
+			dest->columns[numNonzeros] = mat->columns[i] > col ? mat->columns[i] - 1 : mat->columns[i];
+			dest->values[numNonzeros] = mat->values[i];
+			numNonzeros++;
+		}
+		destRow++;
+	}
+	dest->rowStart[dest->numRows] = numNonzeros;
+	dest->numNonzeros = numNonzeros;
+}
+
+///
+//Multiplies a vector by a compressed sparse matrix
+//
+//Parameters:
+//	dest: The destination of the product, must not be the same array as vector
+//	rowStart: The start of each row of the matrix and the end of the last row
+//	columns: The column of each nonzero component
+//	values: The value of each nonzero component
+//	vector: The vector to multiply
+//	numRows: The number of rows in the matrix
+void SparseMatrix_GetProductVectorArray(float* dest, const uint32_t* rowStart, const uint32_t* columns, const float* values, const float* vector, const uint32_t numRows)
+{
+	for (uint32_t row = 0; row < numRows; row++)
+	{
+		float sum = 0.0f;
+		for (uint32_t i = rowStart[row]; i < rowStart[row + 1]; i++)
+		{
+			sum += values[i] * vector[columns[i]];
+		}
+		dest[row] = sum;
+	}
+}
+//Checks for errors then calls SparseMatrix_GetProductVectorArray
+void SparseMatrix_GetProductVector(Vector* dest, const SparseMatrix* mat, const Vector* vector)
+{
+	if (dest->dimension != mat->numRows)
+	{
+		printf("SparseMatrix_GetProductVector failed! Destination is not the proper size. Product Vector not retrieved\n");
+	}
+	else if (vector->dimension != mat->numColumns)
+	{
+		printf("SparseMatrix_GetProductVector failed! Operands are of incompatible size. Product Vector not retrieved\n");
+	}
+	else if (mat->numTriplets > 0)
+	{
+		printf("SparseMatrix_GetProductVector failed! Matrix has triplets which have not been compressed. Product Vector not retrieved\n");
+	}
+	else
+	{
+		SparseMatrix_GetProductVectorArray(dest->components, mat->rowStart, mat->columns, mat->values, vector->components, mat->numRows);
+	}
+}
+
+///
+//Computes the incomplete Cholesky factorization of a compressed symmetric positive definite matrix.
+//
+//L starts as a copy of the lower triangle of the matrix, so the diagonal is the last component of each row.
+//Row by row, each component is found from the rows above it:
+//	L(i, j) = (A(i, j) - sum of L(i, k) * L(j, k)) / L(j, j)
+//	L(i, i) = sqrt(A(i, i) - sum of L(i, k)^2)
+//Where k runs over the columns before j stored in both row i and row j, which are found by walking the two sorted
+//rows together. Any product landing outside the stored components is dropped, which is what makes it incomplete.
+//
+//Parameters:
+//	dest: An initialized sparse matrix of the same dimensions to store L in
+//	mat: The matrix to factor
+//
+//Returns:
+//	1 if the matrix was factored, 0 if a pivot was not positive
+int SparseMatrix_IncompleteCholesky(SparseMatrix* dest, const SparseMatrix* mat)
+{
+	if (dest->numRows != mat->numRows || dest->numColumns != mat->numColumns || mat->numRows != mat->numColumns)
+	{
+		printf("SparseMatrix_IncompleteCholesky failed! Matrices are not NxN and of equal dimensions. Matrix not factored.\n");
+		return 0;
+	}
+
+	//Copy the lower triangle
+	free(dest->columns);
+	free(dest->values);
+	dest->columns = (uint32_t*)malloc(sizeof(uint32_t) * (mat->numNonzeros > 0 ? mat->numNonzeros : 1));
+	dest->values = (float*)malloc(sizeof(float) * (mat->numNonzeros > 0 ? mat->numNonzeros : 1));
+
+	uint32_t numNonzeros = 0;
+	for (uint32_t row = 0; row < mat->numRows; row++)
+	{
+		dest->rowStart[row] = numNonzeros;
+		for (uint32_t i = mat->rowStart[row]; i < mat->rowStart[row + 1] && mat->columns[i] <= row; i++)
+		{
+			dest->columns[numNonzeros] = mat->columns[i];
+			dest->values[numNonzeros] = mat->values[i];
+			numNonzeros++;
+		}
+
+		//Every row needs its diagonal to factor
+		if (numNonzeros == dest->rowStart[row] || dest->columns[numNonzeros - 1] != row)
+		{
+			dest->rowStart[row + 1] = numNonzeros;
+			dest->numNonzeros = numNonzeros;
+			return 0;
+		}
+	}
+	dest->rowStart[mat->numRows] = numNonzeros;
+	dest->numNonzeros = numNonzeros;
+
+	//Factor row by row
+	const uint32_t* rowStart = dest->rowStart;
+	const uint32_t* columns = dest->columns;
+	float* values = dest->values;
+	for (uint32_t row = 0; row < dest->numRows; row++)
+	{
+		uint32_t diagonal = rowStart[row + 1] - 1;
+		for (uint32_t i = rowStart[row]; i < diagonal; i++)
+		{
+			uint32_t col = columns[i];
+			uint32_t colDiagonal = rowStart[col + 1] - 1;
+
+			float sum = values[i];
+			uint32_t a = rowStart[row];
+			uint32_t b = rowStart[col];
+			while (a < i && b < colDiagonal)
+			{
+				if (columns[a] < columns[b]) a++;
+				else if (columns[a] > columns[b]) b++;
+				else sum -= values[a++] * values[b++];
+			}
+			values[i] = sum / values[colDiagonal];
+		}
+
+		float sum = values[diagonal];
+		for (uint32_t i = rowStart[row]; i < diagonal; i++)
+		{
+			sum -= values[i] * values[i];
+		}
+		if (sum <= 0.0f)
+		{
+			return 0;
+		}
+		values[diagonal] = sqrtf(sum);
+	}
+	return 1;
+}
+
+///
+//Applies an incomplete Cholesky preconditioner, solving L * transpose(L) * dest = vector
+//
+//Parameters:
+//	dest: The destination of the solution
+//	factor: L
+//	vector: The vector to precondition
+static void SparseMatrix_ApplyPreconditioner(float* dest, const SparseMatrix* factor, const float* vector)
+{
+	const uint32_t* rowStart = factor->rowStart;
+	const uint32_t* columns = factor->columns;
+	const float* values = factor->values;
+
+	//Forward substitution, the diagonal is the last component of each row
+	for (uint32_t row = 0; row < factor->numRows; row++)
+	{
+		uint32_t diagonal = rowStart[row + 1] - 1;
+		float sum = vector[row];
+		for (uint32_t i = rowStart[row]; i < diagonal; i++)
+		{
+			sum -= values[i] * dest[columns[i]];
+		}
+		dest[row] = sum / values[diagonal];
+	}
+
+	//Back substitution, column i of transpose(L) is row i of L
+	for (uint32_t row = factor->numRows; row-- > 0;)
+	{
+		uint32_t diagonal = rowStart[row + 1] - 1;
+		dest[row] /= values[diagonal];
+		for (uint32_t i = rowStart[row]; i < diagonal; i++)
+		{
+			dest[columns[i]] -= values[i] * dest[row];
+		}
+	}
+}
+
+///
+//Solves the system of equations A * x = b with the preconditioned conjugate gradient method.
+//
+//Each iteration moves x along a search direction which is conjugate to (A-orthogonal to) every direction before it,
+//by the amount which minimizes the error along it. The preconditioner makes the directions follow M^-1 * r rather than
+//the residual r itself, where M = L * transpose(L) is close to A, which takes far fewer iterations than plain
+//conjugate gradients when A is poorly conditioned, as stiffness matrices are.
+//
+//Parameters:
+//	x: An initial guess at the solution, replaced by the solution
+//	mat: The compressed symmetric positive definite matrix A
+//	preconditioner: The incomplete Cholesky factorization of A from SparseMatrix_IncompleteCholesky, or null for none
+//	b: The right hand side
+//	maxIterations: The most iterations to take
+//	tolerance: The iterations stop once the length of the residual b - A * x is this fraction of the length of b
+//
+//Returns:
+//	The number of iterations taken
+uint32_t SparseMatrix_SolveConjugateGradient(float* x, const SparseMatrix* mat, const SparseMatrix* preconditioner, const float* b, const uint32_t maxIterations, const float tolerance)
+{
+	uint32_t n = mat->numRows;
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	float* residual = (float*)Arena_Push(scratch, sizeof(float) * n);
+	float* preconditioned = (float*)Arena_Push(scratch, sizeof(float) * n);
+	float* direction = (float*)Arena_Push(scratch, sizeof(float) * n);
+	float* product = (float*)Arena_Push(scratch, sizeof(float) * n);
+
+	//r = b - A * x
+	SparseMatrix_GetProductVectorArray(product, mat->rowStart, mat->columns, mat->values, x, n);
+	float bMagSq = 0.0f;
+	for (uint32_t i = 0; i < n; i++)
+	{
+		residual[i] = b[i] - product[i];
+		bMagSq += b[i] * b[i];
+	}
+
+	//z = M^-1 * r, p = z
+	if (preconditioner) SparseMatrix_ApplyPreconditioner(preconditioned, preconditioner, residual);
+	else memcpy(preconditioned, residual, sizeof(float) * n);
+	memcpy(direction, preconditioned, sizeof(float) * n);
+
+	float residualDotPreconditioned = 0.0f;
+	for (uint32_t i = 0; i < n; i++)
+	{
+		residualDotPreconditioned += residual[i] * preconditioned[i];
+	}
+
+	float toleranceSq = tolerance * tolerance * bMagSq;
+	uint32_t iteration = 0;
+	for (; iteration < maxIterations; iteration++)
+	{
+		float residualMagSq = 0.0f;
+		for (uint32_t i = 0; i < n; i++)
+		{
+			residualMagSq += residual[i] * residual[i];
+		}
+		if (residualMagSq <= toleranceSq) break;
+
+		//alpha = (r . z) / (p . A * p)
+		SparseMatrix_GetProductVectorArray(product, mat->rowStart, mat->columns, mat->values, direction, n);
+		float curvature = 0.0f;
+		for (uint32_t i = 0; i < n; i++)
+		{
+			curvature += direction[i] * product[i];
+		}
+		if (curvature <= 0.0f) break;
+		float alpha = residualDotPreconditioned / curvature;
+
+		for (uint32_t i = 0; i < n; i++)
+		{
+			x[i] += alpha * direction[i];
+			residual[i] -= alpha * product[i];
+		}
+
+		if (preconditioner) SparseMatrix_ApplyPreconditioner(preconditioned, preconditioner, residual);
+		else memcpy(preconditioned, residual, sizeof(float) * n);
+
+		//beta = (r' . z') / (r . z), p = z' + beta * p
+		float nextDot = 0.0f;
+		for (uint32_t i = 0; i < n; i++)
+		{
+			nextDot += residual[i] * preconditioned[i];
+		}
+		float beta = nextDot / residualDotPreconditioned;
+		residualDotPreconditioned = nextDot;
+
+		for (uint32_t i = 0; i < n; i++)
+		{
+			direction[i] = preconditioned[i] + beta * direction[i];
+		}
+	}
+
+	Arena_ResetToMarker(scratch, marker);
+	return iteration;
+}
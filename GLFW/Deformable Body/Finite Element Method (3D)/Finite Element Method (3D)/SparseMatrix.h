@@ -0,0 +1,148 @@
+/*
+A sparse matrix, which only stores its nonzero components. A finite element stiffness matrix only has nonzero
+components between nodes which share an element, so for a real mesh almost all of a dense matrix would be zeros.
+
+The matrix is built in coordinate (COO) form: each component is added as a triplet of row, column and value,
+in any order, and a component may be added more than once. This is how a stiffness matrix is assembled, since
+every element adds its own stiffness onto the components of its nodes. Compressing the matrix sorts the triplets
+and sums the duplicates into compressed sparse row (CSR) form: the nonzero components of row i are stored from
+rowStart[i] up to rowStart[i + 1] - 1, sorted by column, in the columns and values arrays.
+
+Once compressed the matrix can be multiplied by vectors, and a symmetric positive definite matrix can be solved
+with the conjugate gradient method, preconditioned by an incomplete Cholesky factorization.
+Rows and columns are indexed with 32 bits, so a sparse matrix is not limited to 65535 rows like a Matrix.
+*/
+
+#ifndef SPARSEMATRIX_H
+#define SPARSEMATRIX_H
+
+#include "Vector.h"
+#include <stdint.h>
+
+typedef struct SparseMatrix
+{
+	uint32_t numRows;
+	uint32_t numColumns;
+
+	//Triplets added since the matrix was last compressed
+	uint32_t numTriplets;
+	uint32_t tripletCapacity;
+	uint32_t* tripletRows;
+	uint32_t* tripletColumns;
+	float* tripletValues;
+
+	//Compressed sparse rows
+	uint32_t numNonzeros;
+	uint32_t* rowStart;
+	uint32_t* columns;
+	float* values;
+}SparseMatrix;
+
+///
+//Allocates memory for a new sparse matrix
+//
+//Returns:
+//	Pointer to new sparse matrix
+SparseMatrix* SparseMatrix_Allocate();
+
+///
+//Initializes a sparse matrix with no nonzero components
+//
+//Parameters:
+//	mat: Sparse matrix to initialize
+//	numRows: The number of rows in the matrix
+//	numCols: The number of columns in the matrix
+void SparseMatrix_Initialize(SparseMatrix* mat, const uint32_t numRows, const uint32_t numCols);
+
+///
+//Frees a sparse matrix's resources
+//
+//Parameters:
+//	mat: Sparse matrix to free
+void SparseMatrix_Free(SparseMatrix* mat);
+
+///
+//Adds a value onto a component of a sparse matrix. The value is summed with the component when the matrix is compressed.
+//
+//Parameters:
+//	mat: The sparse matrix to add to
+//	row: The row of the component
+//	col: The column of the component
+//	value: The value to add
+void SparseMatrix_AddTriplet(SparseMatrix* mat, const uint32_t row, const uint32_t col, const float value);
+
+///
+//Sums the triplets added since the last compression into the compressed sparse rows.
+//Must be called after adding triplets and before using the matrix.
+//
+//Parameters:
+//	mat: The sparse matrix to compress
+void SparseMatrix_Compress(SparseMatrix* mat);
+
+///
+//Indexes a compressed sparse matrix
+//
+//Parameters:
+//	mat: The matrix to index
+//	row: The row of the element we wish to index
+//	col: The column of the element we wish to index
+//
+//Returns:
+//	A pointer to the component, or null if the component is not stored
+float* SparseMatrix_Index(SparseMatrix* mat, const uint32_t row, const uint32_t col);
+//Const correct indexing, returns 0 if the component is not stored
+float SparseMatrix_GetIndex(const SparseMatrix* mat, const uint32_t row, const uint32_t col);
+
+///
+//Gets the compressed matrix with one row and one column removed, as when a boundary condition is applied
+//
+//Parameters:
+//	dest: An initialized sparse matrix with one less row and column than mat to store the minor in
+//	mat: The compressed sparse matrix to get the minor of
+//	row: The row to remove
+//	col: The column to remove
+void SparseMatrix_GetMinor(SparseMatrix* dest, const SparseMatrix* mat, const uint32_t row, const uint32_t col);
+
+///
+//Multiplies a vector by a compressed sparse matrix
+//
+//Parameters:
+//	dest: The destination of the product, must not be the same array as vector
+//	rowStart: The start of each row of the matrix and the end of the last row
+//	columns: The column of each nonzero component
+//	values: The value of each nonzero component
+//	vector: The vector to multiply
+//	numRows: The number of rows in the matrix
+void SparseMatrix_GetProductVectorArray(float* dest, const uint32_t* rowStart, const uint32_t* columns, const float* values, const float* vector, const uint32_t numRows);
+//Checks for errors then calls SparseMatrix_GetProductVectorArray
+void SparseMatrix_GetProductVector(Vector* dest, const SparseMatrix* mat, const Vector* vector);
+
+///
+//Computes the incomplete Cholesky factorization of a compressed symmetric positive definite matrix:
+//a lower triangular L with the same nonzero components as the lower triangle of the matrix, such that
+//L * transpose(L) is close to the matrix. Fill in outside of those components is dropped.
+//
+//Parameters:
+//	dest: An initialized sparse matrix of the same dimensions to store L in
+//	mat: The matrix to factor
+//
+//Returns:
+//	1 if the matrix was factored, 0 if a pivot was not positive
+int SparseMatrix_IncompleteCholesky(SparseMatrix* dest, const SparseMatrix* mat);
+
+///
+//Solves the system of equations A * x = b with the preconditioned conjugate gradient method
+//
+//Parameters:
+//	x: An initial guess at the solution, replaced by the solution
+//	mat: The compressed symmetric positive definite matrix A
+//	preconditioner: The incomplete Cholesky factorization of A from SparseMatrix_IncompleteCholesky, or null for none
+//	b: The right hand side
+//	maxIterations: The most iterations to take
+//	tolerance: The iterations stop once the length of the residual b - A * x is this fraction of the length of b
+//
+//Returns:
+//	The number of iterations taken
+uint32_t SparseMatrix_SolveConjugateGradient(float* x, const SparseMatrix* mat, const SparseMatrix* preconditioner, const float* b, const uint32_t maxIterations, const float tolerance);
+
+#endif
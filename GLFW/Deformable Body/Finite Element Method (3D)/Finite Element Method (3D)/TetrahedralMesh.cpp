@@ -0,0 +1,197 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "TetrahedralMesh.h"
+
+//A face of a tetrahedron, with its nodes sorted to find the faces two tetrahedra share, and wound facing out
+typedef struct TetrahedralMesh_Face
+{
+	uint32_t sorted[3];
+	uint32_t wound[3];
+}TetrahedralMesh_Face;
+
+static int TetrahedralMesh_CompareFaces(const void* a, const void* b)
+{
+	const TetrahedralMesh_Face* faceA = (const TetrahedralMesh_Face*)a;
+	const TetrahedralMesh_Face* faceB = (const TetrahedralMesh_Face*)b;
+	for (int i = 0; i < 3; i++)
+	{
+		if (faceA->sorted[i] != faceB->sorted[i]) return faceA->sorted[i] < faceB->sorted[i] ? -1 : 1;
+	}
+	return 0;
+}
+
+///
+//Allocates memory for a new tetrahedral mesh
+//
+//Returns:
+//	Pointer to new tetrahedral mesh
+TetrahedralMesh* TetrahedralMesh_Allocate()
+{
+	TetrahedralMesh* mesh = (TetrahedralMesh*)malloc(sizeof(TetrahedralMesh));
+	mesh->numNodes = 0;
+	mesh->positions = 0x0;
+	mesh->numTetrahedra = 0;
+	mesh->tetrahedra = 0x0;
+	mesh->numSurfaceTriangles = 0;
+	mesh->surfaceTriangles = 0x0;
+	return mesh;
+}
+
+///
+//Initializes a tetrahedral mesh as a box made of cubes, with its lowest corner at the origin
+//
+//Parameters:
+//	mesh: The tetrahedral mesh to initialize
+//	cellsX, cellsY, cellsZ: The number of cubes along each axis
+//	cellSize: The length of the side of each cube
+void TetrahedralMesh_InitializeBox(TetrahedralMesh* mesh, const uint32_t cellsX, const uint32_t cellsY, const uint32_t cellsZ, const float cellSize)
+{
+	uint32_t nodesX = cellsX + 1;
+	uint32_t nodesY = cellsY + 1;
+	uint32_t nodesZ = cellsZ + 1;
+
+	mesh->numNodes = nodesX * nodesY * nodesZ;
+	mesh->positions = (float*)malloc(sizeof(float) * 3 * mesh->numNodes);
+	for (uint32_t x = 0; x < nodesX; x++)
+	{
+		for (uint32_t y = 0; y < nodesY; y++)
+		{
+			for (uint32_t z = 0; z < nodesZ; z++)
+			{
+				float* position = mesh->positions + 3 * ((x * nodesY + y) * nodesZ + z);
+				position[0] = x * cellSize;
+				position[1] = y * cellSize;
+				position[2] = z * cellSize;
+			}
+		}
+	}
+
+	//Each tetrahedron walks from the lowest corner of the cube to the highest along the three axes in one of the six orders
+	const int axisOrders[6][3] = { { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 } };
+
+	mesh->numTetrahedra = 6 * cellsX * cellsY * cellsZ;
+	mesh->tetrahedra = (uint32_t*)malloc(sizeof(uint32_t) * 4 * mesh->numTetrahedra);
+	uint32_t* tetrahedron = mesh->tetrahedra;
+	for (uint32_t x = 0; x < cellsX; x++)
+	{
+		for (uint32_t y = 0; y < cellsY; y++)
+		{
+			for (uint32_t z = 0; z < cellsZ; z++)
+			{
+				for (int order = 0; order < 6; order++)
+				{
+					uint32_t corner[3] = { x, y, z };
+					for (int i = 0; i < 4; i++)
+					{
+						if (i > 0) corner[axisOrders[order][i - 1]]++;
+						tetrahedron[i] = (corner[0] * nodesY + corner[1]) * nodesZ + corner[2];
+					}
+
+					//Half of the orders wind the tetrahedron inside out
+					if (TetrahedralMesh_GetVolume(mesh->positions, tetrahedron) < 0.0f)
+					{
+						uint32_t temp = tetrahedron[2];
+						tetrahedron[2] = tetrahedron[3];
+						tetrahedron[3] = temp;
+					}
+					tetrahedron += 4;
+				}
+			}
+		}
+	}
+
+	mesh->numSurfaceTriangles = 0;
+	mesh->surfaceTriangles = 0x0;
+	TetrahedralMesh_FindSurface(mesh);
+}
+
+///
+//Frees a tetrahedral mesh's resources
+//
+//Parameters:
+//	mesh: The tetrahedral mesh to free
+void TetrahedralMesh_Free(TetrahedralMesh* mesh)
+{
+	free(mesh->positions);
+	free(mesh->tetrahedra);
+	free(mesh->surfaceTriangles);
+	free(mesh);
+}
+
+///
+//Finds the triangles of a tetrahedral mesh which only belong to one tetrahedron.
+//Every face of every tetrahedron is listed and sorted by its nodes, so a face two tetrahedra share shows up twice in a row.
+//
+//Parameters:
+//	mesh: The tetrahedral mesh to find the surface of, whose tetrahedra all have a positive volume
+void TetrahedralMesh_FindSurface(TetrahedralMesh* mesh)
+{
+	//The faces of a tetrahedron with a positive volume, wound counterclockwise from outside
+	const int faceCorners[4][3] = { { 1, 2, 3 }, { 0, 3, 2 }, { 0, 1, 3 }, { 0, 2, 1 } };
+
+	uint32_t numFaces = 4 * mesh->numTetrahedra;
+	TetrahedralMesh_Face* faces = (TetrahedralMesh_Face*)malloc(sizeof(TetrahedralMesh_Face) * (numFaces > 0 ? numFaces : 1));
+	for (uint32_t t = 0; t < mesh->numTetrahedra; t++)
+	{
+		for (int f = 0; f < 4; f++)
+		{
+			TetrahedralMesh_Face* face = faces + 4 * t + f;
+			for (int i = 0; i < 3; i++)
+			{
+				face->wound[i] = face->sorted[i] = mesh->tetrahedra[4 * t + faceCorners[f][i]];
+			}
+
+			//Sort the three nodes
+			for (int i = 1; i < 3; i++)
+			{
+				for (int j = i; j > 0 && face->sorted[j - 1] > face->sorted[j]; j--)
+				{
+					uint32_t temp = face->sorted[j];
+					face->sorted[j] = face->sorted[j - 1];
+					face->sorted[j - 1] = temp;
+				}
+			}
+		}
+	}
+	qsort(faces, numFaces, sizeof(TetrahedralMesh_Face), TetrahedralMesh_CompareFaces);
+
+	free(mesh->surfaceTriangles);
+	mesh->surfaceTriangles = (uint32_t*)malloc(sizeof(uint32_t) * 3 * (numFaces > 0 ? numFaces : 1));
+	mesh->numSurfaceTriangles = 0;
+	for (uint32_t f = 0; f < numFaces;)
+	{
+		uint32_t end = f + 1;
+		while (end < numFaces && TetrahedralMesh_CompareFaces(faces + f, faces + end) == 0) end++;
+		if (end == f + 1)
+		{
+			uint32_t* triangle = mesh->surfaceTriangles + 3 * mesh->numSurfaceTriangles++;
+			for (int i = 0; i < 3; i++) triangle[i] = faces[f].wound[i];
+		}
+		f = end;
+	}
+	free(faces);
+}
+
+///
+//Determines the volume of a tetrahedron of a mesh, which is negative if the tetrahedron is inside out
+//
+//Parameters:
+//	positions: The positions of the nodes, three components per node
+//	tetrahedron: The four nodes of the tetrahedron
+float TetrahedralMesh_GetVolume(const float* positions, const uint32_t* tetrahedron)
+{
+	const float* p0 = positions + 3 * tetrahedron[0];
+	float edges[3][3];
+	for (int e = 0; e < 3; e++)
+	{
+		const float* p = positions + 3 * tetrahedron[e + 1];
+		for (int i = 0; i < 3; i++) edges[e][i] = p[i] - p0[i];
+	}
+
+	//V = ((p1 - p0) x (p2 - p0)) . (p3 - p0) / 6
+	float crossX = edges[0][1] * edges[1][2] - edges[0][2] * edges[1][1];
+	float crossY = edges[0][2] * edges[1][0] - edges[0][0] * edges[1][2];
+	float crossZ = edges[0][0] * edges[1][1] - edges[0][1] * edges[1][0];
+	return (crossX * edges[2][0] + crossY * edges[2][1] + crossZ * edges[2][2]) / 6.0f;
+}
@@ -0,0 +1,67 @@
+/*
+A tetrahedral mesh: a set of nodes and the tetrahedra which fill the volume between them. This is the mesh a
+linear tetrahedral finite element body is made from, each tetrahedron being one element.
+
+A box can be made from a grid of cubes, each split into six tetrahedra around the diagonal from its lowest to its
+highest corner. Every cube is split the same way, so the faces of neighboring cubes' tetrahedra line up.
+
+The surface of the mesh is every triangle which belongs to only one tetrahedron. The surface triangles are wound
+counterclockwise when seen from outside of the mesh, and are what is drawn of the body.
+*/
+
+#ifndef TETRAHEDRALMESH_H
+#define TETRAHEDRALMESH_H
+
+#include <stdint.h>
+
+typedef struct TetrahedralMesh
+{
+	uint32_t numNodes;
+	float* positions;				//Three components per node
+
+	uint32_t numTetrahedra;
+	uint32_t* tetrahedra;			//Four nodes per tetrahedron, ordered so the tetrahedron has a positive volume
+
+	uint32_t numSurfaceTriangles;
+	uint32_t* surfaceTriangles;		//Three nodes per triangle
+}TetrahedralMesh;
+
+///
+//Allocates memory for a new tetrahedral mesh
+//
+//Returns:
+//	Pointer to new tetrahedral mesh
+TetrahedralMesh* TetrahedralMesh_Allocate();
+
+///
+//Initializes a tetrahedral mesh as a box made of cubes, with its lowest corner at the origin
+//
+//Parameters:
+//	mesh: The tetrahedral mesh to initialize
+//	cellsX, cellsY, cellsZ: The number of cubes along each axis
+//	cellSize: The length of the side of each cube
+void TetrahedralMesh_InitializeBox(TetrahedralMesh* mesh, const uint32_t cellsX, const uint32_t cellsY, const uint32_t cellsZ, const float cellSize);
+
+///
+//Frees a tetrahedral mesh's resources
+//
+//Parameters:
+//	mesh: The tetrahedral mesh to free
+void TetrahedralMesh_Free(TetrahedralMesh* mesh);
+
+///
+//Finds the triangles of a tetrahedral mesh which only belong to one tetrahedron
+//
+//Parameters:
+//	mesh: The tetrahedral mesh to find the surface of, whose tetrahedra all have a positive volume
+void TetrahedralMesh_FindSurface(TetrahedralMesh* mesh);
+
+///
+//Determines the volume of a tetrahedron of a mesh, which is negative if the tetrahedron is inside out
+//
+//Parameters:
+//	positions: The positions of the nodes, three components per node
+//	tetrahedron: The four nodes of the tetrahedron
+float TetrahedralMesh_GetVolume(const float* positions, const uint32_t* tetrahedron);
+
+#endif
@@ -0,0 +1,551 @@
+/*
+Title: Finite Element Method (3D)
+File Name: main.cpp
+Copyright  2015
+Original authors: Nicholas Gallagher
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is a demonstration of using the finite element method to simulate deformable body physics in 3D.
+The demo contains a beam made from a grid of cubes, each split into 6 tetrahedra, which is fixed to a wall
+at its left end and bends under its own weight.
+
+Each tetrahedron is a linear finite element. Its stiffness matrix only depends on its rest shape, so the stiffness
+matrices of every element are computed once at the startup of the program. Each physics timestep finds the rotation
+of every element from its deformation (a polar decomposition, found by refining the rotation of the last timestep),
+and measures how far each element has been deformed in its own rotated frame. This is corotational or "stiffness
+warped" FEM: the beam can bend and twist a long way without the swelling which plain linear elasticity shows as
+soon as anything rotates.
+
+Each physics timestep is an implicit Euler step, which stays stable for any timestep but needs the solution of a
+large sparse system of equations. The system with no rotations never changes, so it is factored with a sparse
+Cholesky factorization once at the startup of the program. Each timestep solves the rotated system with conjugate
+gradients using that factorization as the preconditioner, so while the beam is at rest one back substitution solves
+it and while it bends it takes a handful. The FEM Benchmark project steps the same beam without a window with ten
+thousand tetrahedra and more, and reports how long each part takes.
+
+The beam can instead be simulated as a modal body (change bodyType in main). The lowest vibration modes of the beam
+are found once with subspace iteration and saved to BeamModes.modes, which later runs map into memory instead of
+computing them again. Each timestep then moves the beam along its 16 modes as 16 independent harmonic oscillators,
+which costs the same however many nodes the beam has; this is how hundreds of small deformable props can be
+simulated at once, as long as they only wobble and sway about their rest shape (see ModalBody.h).
+
+The user can apply forces to the right end of the beam.
+Hold the left mouse button to apply a force along the positive Y axis.
+Hold the right mouse button to apply a force along the negative Y axis.
+
+References:
+Real-Time Physics by Matthias Muller et al., Chapter 3 (corotational FEM)
+Interactive Deformation Using Modal Analysis with Constraints by Hauser, Shen and O'Brien
+A Robust Method to Extract the Rotational Part of Deformations by Muller, Bender, Chentanez and Macklin
+Direct Methods for Sparse Linear Systems by Timothy A. Davis
+PhysicsTimestep by Brockton Roth
+Base by Srinivasan Thiagarajan
+*/
+
+#include "GLIncludes.h"
+#include "CorotationalBody.h"
+#include "ModalBody.h"
+
+// Global data members
+#pragma region Base_data
+// This is your reference to your shader program.
+// This will be assigned with glCreateProgram().
+// This program will run on your GPU.
+GLuint program;
+
+// These are your references to your actual compiled shaders
+GLuint vertex_shader;
+GLuint fragment_shader;
+
+// This is a reference to your uniform MVP matrix in your vertex shader
+GLuint uniMVP;
+GLuint uniHue;
+
+// Matrix for storing the View Projection transformation
+glm::mat4 VP;
+
+// This is a matrix to be sent to the shaders which can control global hue alteration
+glm::mat4 hue;
+
+// Reference to the window object being created by GLFW.
+GLFWwindow* window;
+
+struct Vertex
+{
+	float
+		x, y, z,
+		r, g, b, a;
+};
+
+//Struct for rendering
+struct Mesh
+{
+	GLuint VBO;
+	GLuint EBO;
+	GLuint VAO;
+	glm::mat4 translation;
+	glm::mat4 rotation;
+	glm::mat4 scale;
+	int numVertices;
+	int numIndices;
+	struct Vertex* vertices;
+	GLuint* indices;
+	GLenum primitive;
+
+	Mesh::Mesh(int numVert, struct Vertex* vert, int numInd, GLuint* inds, GLenum primType)
+	{
+
+		glm::mat4 translation = glm::mat4(1.0f);
+		glm::mat4 rotation = glm::mat4(1.0f);
+		glm::mat4 scale = glm::mat4(1.0f);
+
+		this->numVertices = numVert;
+		this->vertices = new struct Vertex[this->numVertices];
+		memcpy(this->vertices, vert, this->numVertices * sizeof(struct Vertex));
+
+		this->numIndices = numInd;
+		this->indices = new GLuint[this->numIndices];
+		memcpy(this->indices, inds, this->numIndices * sizeof(GLuint));
+
+		this->primitive = primType;
+
+		//Generate VAO
+		glGenVertexArrays(1, &this->VAO);
+		//bind VAO
+		glBindVertexArray(VAO);
+
+		//Generate VBO & EBO
+		//We must use an element buffer here so that we do not need to worry about duplicate vertices
+		//while we are repositioning the vertices of the mesh
+		glGenBuffers(1, &this->VBO);
+		glGenBuffers(1, &this->EBO);
+
+		//Configure VBO & EBO
+		glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->EBO);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(struct Vertex) * this->numVertices, this->vertices, GL_DYNAMIC_DRAW);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * this->numIndices, this->indices, GL_STATIC_DRAW);
+
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(struct Vertex), (void*)0);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(struct Vertex), (void*)12);
+	}
+
+	Mesh::~Mesh(void)
+	{
+		delete[] this->vertices;
+		delete[] this->indices;
+		glDeleteVertexArrays(1, &this->VAO);
+		glDeleteBuffers(1, &this->VBO);
+		glDeleteBuffers(1, &this->EBO);
+	}
+
+	glm::mat4 Mesh::GetModelMatrix()
+	{
+		return translation * rotation * scale;
+	}
+
+	void Mesh::RefreshData(void)
+	{
+		//Because we are changing the vertices themselves and not transforming them
+		//We must write the new vertices over the old on the GPU.
+		glBindVertexArray(VAO);
+
+		GLvoid* memory = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
+		memcpy(memory, vertices, numVertices * sizeof(Vertex));
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+	}
+
+	void Mesh::Draw(void)
+	{
+		//Generate the MVP for this model
+		glm::mat4 MVP = VP * this->GetModelMatrix();
+
+		//Bind the VAO being drawn
+		glBindVertexArray(this->VAO);
+
+		// Set the uniform matrix in our shader to our MVP matrix for this mesh.
+		glUniformMatrix4fv(uniMVP, 1, GL_FALSE, glm::value_ptr(MVP));
+		//Draw the mesh
+		glDrawElements(this->primitive, this->numIndices, GL_UNSIGNED_INT, 0);
+	}
+};
+
+//The ways the beam can be simulated
+enum BodyType
+{
+	BODY_COROTATIONAL,	//Step the whole tetrahedral mesh with corotational FEM
+	BODY_MODAL			//Step the lowest vibration modes of the mesh
+};
+
+struct Mesh* surface;
+
+//The tetrahedral mesh the body is made from, and the body itself
+TetrahedralMesh* tetrahedralMesh;
+CorotationalBody* body;
+
+//The modes of the body and the modal body moving along them, when simulating a modal body
+ModalBasis* modalBasis;
+ModalBody* modalBody;
+float* modalPositions;
+
+//The nodes at the free end of the beam, which the user pushes on
+uint32_t numTipNodes;
+uint32_t* tipNodes;
+
+double time = 0.0;
+double timebase = 0.0;
+double accumulator = 0.0;
+double physicsStep = 0.012; // This is the number of milliseconds we intend for the physics to update.
+
+#pragma endregion Base_data
+
+// Functions called only once every time the program is executed.
+#pragma region Helper_functions
+
+//Read shader source
+std::string readShader(std::string fileName)
+{
+	std::string shaderCode;
+	std::string line;
+
+	std::ifstream file(fileName, std::ios::in);
+	if (!file.good())
+	{
+		std::cout << "Can't read file: " << fileName.data() << std::endl;
+		return "";
+	}
+
+	file.seekg(0, std::ios::end);
+	shaderCode.resize((unsigned int)file.tellg());
+	file.seekg(0, std::ios::beg);
+
+	file.read(&shaderCode[0], shaderCode.size());
+
+	file.close();
+
+	return shaderCode;
+}
+
+//Creates shader program
+GLuint createShader(std::string sourceCode, GLenum shaderType)
+{
+	GLuint shader = glCreateShader(shaderType);
+	const char *shader_code_ptr = sourceCode.c_str();
+	const int shader_code_size = sourceCode.size();
+
+	glShaderSource(shader, 1, &shader_code_ptr, &shader_code_size);
+	glCompileShader(shader);
+
+	GLint isCompiled = 0;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
+
+	if (isCompiled == GL_FALSE)
+	{
+		char infolog[1024];
+		glGetShaderInfoLog(shader, 1024, NULL, infolog);
+		std::cout << "The shader failed to compile with the error:" << std::endl << infolog << std::endl;
+
+		glDeleteShader(shader);
+	}
+
+	return shader;
+}
+
+// Initialization code
+void init()
+{
+	// Initializes the glew library
+	glewInit();
+	glEnable(GL_DEPTH_TEST);
+
+	// Create shaders
+	std::string vertShader = readShader("VertexShader.glsl");
+	std::string fragShader = readShader("FragmentShader.glsl");
+
+	vertex_shader = createShader(vertShader, GL_VERTEX_SHADER);
+	fragment_shader = createShader(fragShader, GL_FRAGMENT_SHADER);
+
+	program = glCreateProgram();
+	glAttachShader(program, vertex_shader);
+	glAttachShader(program, fragment_shader);
+	glLinkProgram(program);
+
+
+	//Generate the View Projection matrix, looking at the beam from the front and a little above
+	glm::mat4 view = glm::lookAt(glm::vec3(0.2f, 0.8f, 3.2f), glm::vec3(0.2f, -0.2f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	glm::mat4 proj = glm::perspective(45.0f, 800.0f / 800.0f, 0.1f, 100.0f);
+	VP = proj * view;
+
+	//Create uniforms
+	uniMVP = glGetUniformLocation(program, "MVP");
+	uniHue = glGetUniformLocation(program, "hue");
+
+	// Set options
+	glFrontFace(GL_CCW);
+	glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+}
+
+
+#pragma endregion Helper_functions
+
+// This runs once every physics timestep.
+void update(float dt)
+{
+	//Step 0: Calculate external force on the tip of the beam if there is any
+	float force = 0.0f;
+	if(glfwGetMouseButton(window, 0) == GLFW_PRESS)
+	{
+		force = 400.0f;
+	}
+	if(glfwGetMouseButton(window, 1) == GLFW_PRESS)
+	{
+		force = -400.0f;
+	}
+
+	//Step 1: Move the body forward one timestep, with the force spread evenly over the nodes at the tip.
+	//The body's timestep was set to the physics step when it was made, and every array it uses was allocated then.
+	const float* positions;
+	if(modalBody)
+	{
+		float tipForce[3] = { 0.0f, force / numTipNodes, 0.0f };
+		ModalBody_ClearForces(modalBody);
+		for(uint32_t i = 0; i < numTipNodes; i++)
+		{
+			ModalBody_ApplyForce(modalBody, tipNodes[i], tipForce);
+		}
+		ModalBody_Step(modalBody);
+
+		//The positions of the nodes are only needed to draw the body
+		ModalBody_GetPositions(modalPositions, modalBody);
+		positions = modalPositions;
+	}
+	else
+	{
+		for(uint32_t i = 0; i < numTipNodes; i++)
+		{
+			body->externalForces[3 * tipNodes[i] + 1] = force / numTipNodes;
+		}
+		CorotationalBody_Step(body);
+		positions = body->positions;
+	}
+
+	//Step 2: Move the vertices of the surface to the new positions of the nodes
+	for(uint32_t i = 0; i < tetrahedralMesh->numNodes; i++)
+	{
+		surface->vertices[i].x = positions[3 * i];
+		surface->vertices[i].y = positions[3 * i + 1];
+		surface->vertices[i].z = positions[3 * i + 2];
+	}
+}
+
+// This runs once every frame to determine the FPS and how often to call update based on the physics step.
+void checkTime()
+{
+	// Get the current time.
+	time = glfwGetTime();
+
+	// Get the time since we last ran an update.
+	double dt = time - timebase;
+
+	// If more time has passed than our physics timestep.
+	if (dt > physicsStep)
+	{
+
+		timebase = time; // set new last updated time
+
+		// Limit dt
+		if (dt > 0.25)
+		{
+			dt = 0.25;
+		}
+		accumulator += dt;
+
+		// Update physics necessary amount
+		while (accumulator >= physicsStep)
+		{
+			update(physicsStep);
+			accumulator -= physicsStep;
+		}
+	}
+}
+
+
+
+// This function runs every frame
+void renderScene()
+{
+	// Clear the color buffer and the depth buffer
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	// Clear the screen to black
+	glClearColor(0.0, 0.0, 0.0, 1.0);
+	glLineWidth(1.0f);
+
+	// Tell OpenGL to use the shader program you've created.
+	glUseProgram(program);
+
+	//Set hue uniform
+	glUniformMatrix4fv(uniHue, 1, GL_FALSE, glm::value_ptr(hue));
+
+	//Refresh the surface vertices
+	surface->RefreshData();
+	// Draw the Gameobjects
+	surface->Draw();
+}
+
+#pragma endregion util_Functions
+
+
+
+void main()
+{
+	glfwInit();
+
+	// Create a window
+	window = glfwCreateWindow(800, 800, "Finite Element Method 3D", nullptr, nullptr);
+	glfwMakeContextCurrent(window);
+	glfwSwapInterval(0);
+
+	// Initializes most things needed before the main loop
+	init();
+
+	//Number of cubes along each side of the beam, each of which is split into 6 tetrahedra.
+	//See the FEM Benchmark project for how the step time grows with the number of tetrahedra.
+	const uint32_t cellsX = 16;
+	const uint32_t cellsY = 4;
+	const uint32_t cellsZ = 4;
+	const float cellSize = 0.1f;
+	//How the beam is simulated
+	const BodyType bodyType = BODY_COROTATIONAL;
+
+	//Generate the tetrahedral mesh, centered on the Z axis
+	tetrahedralMesh = TetrahedralMesh_Allocate();
+	TetrahedralMesh_InitializeBox(tetrahedralMesh, cellsX, cellsY, cellsZ, cellSize);
+	for(uint32_t i = 0; i < tetrahedralMesh->numNodes; i++)
+	{
+		tetrahedralMesh->positions[3 * i] -= 0.5f * cellsX * cellSize;
+		tetrahedralMesh->positions[3 * i + 1] -= 0.5f * cellsY * cellSize;
+		tetrahedralMesh->positions[3 * i + 2] -= 0.5f * cellsZ * cellSize;
+	}
+
+	//The nodes at the left end of the beam are fixed to the wall, and the user pushes on the nodes at the right end
+	float left = -0.5f * cellsX * cellSize;
+	float right = 0.5f * cellsX * cellSize;
+	uint8_t* fixed = new uint8_t[tetrahedralMesh->numNodes];
+	tipNodes = new uint32_t[tetrahedralMesh->numNodes];
+	numTipNodes = 0;
+	for(uint32_t i = 0; i < tetrahedralMesh->numNodes; i++)
+	{
+		float x = tetrahedralMesh->positions[3 * i];
+		fixed[i] = x < left + 0.5f * cellSize;
+		if(x > right - 0.5f * cellSize) tipNodes[numTipNodes++] = i;
+	}
+
+	//Generate the softbody: a soft rubber-like material with the density of water
+	body = CorotationalBody_Allocate();
+	CorotationalBody_Initialize(body, tetrahedralMesh, fixed, 2000000.0f, 0.3f, 1000.0f, (float)physicsStep);
+	delete[] fixed;
+
+	//The modal body is moved along the modes of the softbody, which are only computed if no earlier run saved them for this mesh and material
+	modalBasis = 0x0;
+	modalBody = 0x0;
+	modalPositions = 0x0;
+	if(bodyType == BODY_MODAL)
+	{
+		uint64_t modalKey = ModalBasis_GetKey(body, 16, 0.0001f);
+		modalBasis = ModalBasis_Allocate();
+		if(!ModalBasis_Load(modalBasis, "BeamModes.modes", modalKey))
+		{
+			printf("Computing the modes of the beam...\n");
+			ModalBasis_Free(modalBasis);
+			modalBasis = ModalBasis_Allocate();
+			ModalBasis_Compute(modalBasis, body, 16, 0.0001f);
+			ModalBasis_Save(modalBasis, "BeamModes.modes");
+		}
+
+		modalBody = ModalBody_Allocate();
+		ModalBody_Initialize(modalBody, modalBasis, body->gravity, (float)physicsStep);
+		modalPositions = new float[3 * tetrahedralMesh->numNodes];
+	}
+
+	//Every node is a vertex, but only the surface triangles are drawn
+	Vertex* surfaceVerts = new Vertex[tetrahedralMesh->numNodes];
+	for(uint32_t i = 0; i < tetrahedralMesh->numNodes; i++)
+	{
+		Vertex* v = surfaceVerts + i;
+		v->x = tetrahedralMesh->positions[3 * i];
+		v->y = tetrahedralMesh->positions[3 * i + 1];
+		v->z = tetrahedralMesh->positions[3 * i + 2];
+
+		v->r = 0.0f;
+		v->g = 1.0f;
+		v->b = 1.0f;
+		v->a = 1.0f;
+	}
+
+	//surface creation
+	surface = new struct Mesh(tetrahedralMesh->numNodes, surfaceVerts, 3 * tetrahedralMesh->numSurfaceTriangles, tetrahedralMesh->surfaceTriangles, GL_TRIANGLES);
+	delete[] surfaceVerts;
+
+	//Print controls
+	printf("Controls:\nPress and hold the left mouse button to push the right end of the beam up.\n");
+	printf("Press and hold the right mouse button to push the right end of the beam down.\n");
+
+
+	// Enter the main loop.
+	while (!glfwWindowShouldClose(window))
+	{
+		//Check time will update the programs clock and determine if & how many times the physics must be updated
+		checkTime();
+
+		// Call the render function.
+		renderScene();
+
+		// Swaps the back buffer to the front buffer
+		// Remember, you're rendering to the back buffer, then once rendering is complete, you're moving the back buffer to the front so it can be displayed.
+		glfwSwapBuffers(window);
+
+		// Checks to see if any events are pending and then processes them.
+		glfwPollEvents();
+	}
+
+	// After the program is over, cleanup your data!
+	glDeleteShader(vertex_shader);
+	glDeleteShader(fragment_shader);
+	glDeleteProgram(program);
+	// Note: If at any point you stop using a "program" or shaders, you should free the data up then and there.
+
+	delete surface;
+	delete[] tipNodes;
+	if(modalBody)
+	{
+		ModalBody_Free(modalBody);
+		ModalBasis_Free(modalBasis);
+		delete[] modalPositions;
+	}
+	CorotationalBody_Free(body);
+	TetrahedralMesh_Free(tetrahedralMesh);
+
+
+	// Frees up GLFW memory
+	glfwTerminate();
+}
\ No newline at end of file
@@ -34,6 +34,16 @@ to maintain stability of the spring system while using Newton Euler integration.
 In order to avoid this, one should use another integration scheme such as 
 Order 4 Runge-Kutta.
 
+This example also contains one such scheme, implicit (backward Euler) integration. Instead of moving each
+point mass by the forces at the start of the step, the implicit step solves for the velocities whose forces
+at the end of the step agree with them, which is a sparse linear system solved with a preconditioned conjugate
+gradient (see ImplicitSpringSolver). It stays stable with a full 60 Hz timestep and much stiffer springs.
+Press I to switch between explicit and implicit integration.
+Press Page Up and Page Down to double or halve the spring coefficient.
+
+The springs themselves are kept in a spring network (see SpringNetwork), which both integration modes are built from.
+Press B to add bend springs, which join every point mass to the one two further along the rope.
+
 The user can move the mouse to displace one end of the rope. The user can also
 left click to cause wind coming from the left, and right click to cause wind to come from the right.
 
@@ -43,6 +53,8 @@ Base by Srinivasan Thiagarajan
 */
 
 #include "GLIncludes.h"
+#include "ImplicitSpringSolver.h"
+#include "SpringNetwork.h"
 
 // Global data members
 #pragma region Base_data
@@ -255,6 +267,17 @@ double timebase = 0.0;
 double accumulator = 0.0;
 double physicsStep = 0.001; // This is the number of milliseconds we intend for the physics to update.
 
+//Explicit integration needs a very short timestep to stay stable, implicit integration can take a whole frame at 60 Hz
+const double explicitStep = 0.001;
+const double implicitStep = 1.0 / 60.0;
+bool implicitIntegration = false;
+
+//The springs of the rope, shared by both integration modes
+SpringNetwork* network;
+bool bendSprings = false;
+
+ImplicitSpringSolver* solver;
+
 #pragma endregion Base_data								  
 
 // Functions called only once every time the program is executed.
@@ -347,27 +370,115 @@ void init()
 #pragma endregion Helper_functions
 
 ///
-//Performs second order euler integration for linear motion
+//Creates the spring network of the rope, with a spring between each pair of neighboring rigidbodies. With bend springs,
+//every rigidbody also gets a spring to the one two further along, which keeps the rope from folding back on itself.
+void BuildSpringNetwork()
+{
+	std::vector<glm::vec3> restPositions;
+	for(unsigned int i = 0; i < body->numRigidBodies; i++)
+	{
+		restPositions.push_back(body->rigidBodies[i].position);
+	}
+
+	network = new SpringNetwork(body->numRigidBodies, &restPositions[0]);
+	for(unsigned int i = 1; i < body->numRigidBodies; i++)
+	{
+		network->AddSpring(i - 1, i, body->restLength);
+		if(bendSprings && i > 1)
+			network->AddSpring(i - 2, i, 2.0f * body->restLength);
+	}
+	network->Build();
+}
+
+///
+//Creates the implicit solver with a spring for each spring of the network
+void BuildImplicitSolver()
+{
+	std::vector<ImplicitSpring> springs;
+	for(unsigned int s = 0; s < network->numSprings(); s++)
+	{
+		ImplicitSpring spring = { network->springs()[s].i, network->springs()[s].j, network->springs()[s].restLength };
+		springs.push_back(spring);
+	}
+
+	solver = new ImplicitSpringSolver(network->numPoints(), &springs[0], springs.size());
+}
+
+///
+//Adds or removes the bend springs, rebuilding the implicit solver from the new network
+void RebuildSprings()
+{
+	delete network;
+	delete solver;
+
+	bendSprings = !bendSprings;
+	BuildSpringNetwork();
+	BuildImplicitSolver();
+}
+
+///
+//Performs one explicit step of the whole rope with the spring network, copying the rigidbodies in and out
+//the same way as UpdateImplicit
+//
+//Parameters:
+//	dt: The timestep
+//	externalForce: The wind applied to every rigidbody
+void UpdateExplicit(float dt, const glm::vec3& externalForce)
+{
+	network->coefficient = body->coefficient;
+	network->dampening = body->dampening;
+
+	for(unsigned int i = 0; i < body->numRigidBodies; i++)
+	{
+		network->positions[i] = body->rigidBodies[i].position;
+		network->velocities[i] = body->rigidBodies[i].velocity;
+		network->inverseMasses[i] = body->rigidBodies[i].inverseMass;
+		//Add any and all external forces here
+		network->forces[i] = gravity * body->rigidBodies[i].mass + externalForce;
+	}
+
+	//The first rigidbody follows the mouse, so the step must not move it
+	network->inverseMasses[0] = 0.0f;
+
+	network->Step(dt);
+
+	for(unsigned int i = 1; i < body->numRigidBodies; i++)
+	{
+		body->rigidBodies[i].position = network->positions[i];
+		body->rigidBodies[i].velocity = network->velocities[i];
+	}
+}
+
+///
+//Performs one implicit step of the whole rope. The rigidbodies are copied into the solver and back,
+//so the integration can be switched at any time.
 //
 //Parameters:
 //	dt: The timestep
-//	body: The rigidbody being integrated
-void IntegrateLinear(float dt, RigidBody &body)
+//	externalForce: The wind applied to every rigidbody
+void UpdateImplicit(float dt, const glm::vec3& externalForce)
 {
-	//Calculate the current acceleration
-	body.acceleration = body.inverseMass * body.netForce;
-	
-	//Calculate new position with
-	//	X = X0 + V0*dt + (1/2) * A * dt^2
-	glm::vec3 v0dT = dt * body.velocity;						//Solve for the first degree term
-	glm::vec3 aT2 = (0.5f) * body.acceleration * powf(dt, 2);	//Solve for the second degree term
-	body.position += v0dT + aT2;								//Take sum
-
-	//determine the new velocity
-	body.velocity += dt * body.acceleration + body.inverseMass * body.netImpulse;
-
-	//Zero the net impulse and net force!
-	body.netForce = body.netImpulse = glm::vec3(0.0f);
+	solver->coefficient = body->coefficient;
+	solver->dampening = body->dampening;
+
+	for(unsigned int i = 0; i < body->numRigidBodies; i++)
+	{
+		solver->positions[i] = body->rigidBodies[i].position;
+		solver->velocities[i] = body->rigidBodies[i].velocity;
+		solver->inverseMasses[i] = body->rigidBodies[i].inverseMass;
+		solver->externalForces[i] = gravity * body->rigidBodies[i].mass + externalForce;
+	}
+
+	//The first rigidbody follows the mouse, so the solver must not move it
+	solver->inverseMasses[0] = 0.0f;
+
+	solver->Step(dt);
+
+	for(unsigned int i = 1; i < body->numRigidBodies; i++)
+	{
+		body->rigidBodies[i].position = solver->positions[i];
+		body->rigidBodies[i].velocity = solver->velocities[i];
+	}
 }
 
 // This runs once every physics timestep.
@@ -403,36 +514,13 @@ void update(float dt)
 		externalForce.x -= 1.0f;
 	}
 
-	//Apply acceleration due to gravity to the objects
-	//We will start at rigidBody 1 because the first rigidbody will be pinned to the mouse position.
-	for(int i = 1; i < body->numRigidBodies; i++)
+	if(implicitIntegration)
 	{
-		//Calculate force body[i-1] is applying to body[i]
-		//Get displacement from rigidBody[i-1] to rigidBody[i]
-		glm::vec3 displacement = body->rigidBodies[i - 1].position - body->rigidBodies[i].position;
-		//Extract the direction and the magnitude from this displacement
-		glm::vec3 direction = glm::normalize(displacement);
-		float mag = glm::length(displacement);
-
-		//Calculate and Add the applied force according the Hooke's law
-		//Fspring = -k(dX)
-		//And from that we must add the dampening force:
-		//Fdamp = -V * C 
-		//Where C is the dampening constant
-		body->rigidBodies[i].netForce += body->coefficient * (mag - body->restLength) * direction - body->rigidBodies[i].velocity * body->dampening;
-
-		//If there is a next rigidbody, perform the same computations on it.
-		if(i < body->numRigidBodies-1)
-		{
-			displacement = body->rigidBodies[i + 1].position - body->rigidBodies[i].position;
-			direction = glm::normalize(displacement);
-			mag = glm::length(displacement);
-
-			body->rigidBodies[i].netForce += body->coefficient * (mag - body->restLength) * direction - body->rigidBodies[i].velocity * body->dampening;
-		}
-
-		//Add any and all external forces below here here
-		body->rigidBodies[i].netForce += gravity * body->rigidBodies[i].mass + externalForce;
+		UpdateImplicit(dt, externalForce);
+	}
+	else
+	{
+		UpdateExplicit(dt, externalForce);
 	}
 
 
@@ -440,8 +528,6 @@ void update(float dt)
 	//For each rigidbody
 	for(int i = 1; i < body->numRigidBodies; i++)
 	{
-		//Integrate kinematics
-		IntegrateLinear(dt, body->rigidBodies[i]);
 		//Get it's position assuming the 0th body is the origin of the system
 		glm::vec3 relativePosition =  body->rigidBodies[i].position - body->rigidBodies[0].position;
 		//And change the mesh's vertices to match this
@@ -509,6 +595,34 @@ void renderScene()
 	rope->Draw();
 }
 
+void OnKeyPress(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+	if(action == GLFW_PRESS)
+	{
+		if(key == GLFW_KEY_I)
+		{
+			implicitIntegration = !implicitIntegration;
+			physicsStep = implicitIntegration ? implicitStep : explicitStep;
+			printf("\nIntegration:\t%s\n", implicitIntegration ? "Implicit" : "Explicit");
+		}
+		else if(key == GLFW_KEY_B)
+		{
+			RebuildSprings();
+			printf("\nBend springs:\t%s (%u springs)\n", bendSprings ? "On" : "Off", network->numSprings());
+		}
+		else if(key == GLFW_KEY_PAGE_UP)
+		{
+			body->coefficient *= 2.0f;
+			printf("\nSpring coefficient:\t%f\n", body->coefficient);
+		}
+		else if(key == GLFW_KEY_PAGE_DOWN)
+		{
+			body->coefficient *= 0.5f;
+			printf("\nSpring coefficient:\t%f\n", body->coefficient);
+		}
+	}
+}
+
 #pragma endregion util_Functions
 
 
@@ -522,6 +636,8 @@ void main()
 	glfwMakeContextCurrent(window);
 	glfwSwapInterval(0);
 
+	glfwSetKeyCallback(window, OnKeyPress);
+
 	// Initializes most things needed before the main loop
 	init();
 
@@ -556,9 +672,14 @@ void main()
 
 	//Generate the softbody
 	body = new SoftBody(*rope, coeff, rest, damp);
+	BuildSpringNetwork();
+	BuildImplicitSolver();
 
 	//Print controls
 	printf("Controls:\nMove mouse to displace one end of rope.\nLeft click to cause wind to the right.\nRight click to cause wind to the left.\n");
+	printf("Press I to switch between explicit and implicit integration\n");
+	printf("Press Page Up and Page Down to double or halve the spring coefficient\n");
+	printf("Press B to add or remove bend springs\n");
 
 	// Enter the main loop.
 	while (!glfwWindowShouldClose(window))
@@ -585,6 +706,8 @@ void main()
 
 	delete rope;
 	delete body;
+	delete solver;
+	delete network;
 
 
 	// Frees up GLFW memory
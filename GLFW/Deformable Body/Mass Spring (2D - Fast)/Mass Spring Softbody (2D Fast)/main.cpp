@@ -37,6 +37,11 @@ Hold Left shift to switch the axis to the Y axis.
 It should be noted that this is a more complex example focused on increasing the speed of 
 the iterative algorithm. For a straight forward demonstation see the Mass Spring (2D) example.
 
+To keep the loops fast, the point masses are not separate objects. Each of their properties (position, velocity, net force)
+is kept in its own array, and all of the arrays share one allocation. The springs are listed once each, as the pair of
+point masses they join and their rest length. Each timestep first adds up the force of every spring in one pass, then
+integrates every point mass in a second pass, so the result does not depend on the order anything is visited in.
+
 References:
 Game Physics by David Eberly
 NGenVS by Nicholas Gallagher
@@ -171,54 +176,19 @@ struct Mesh
 	}
 };
 
-//Struct for rigidbody kinematics
-struct RigidBody
+//A spring between two point masses of a softbody
+struct Spring
 {
-	float mass;						//We will need to use both mass and inverse mass extensively here.
-	float inverseMass;				//I tend to use inverse mass as opposed to mass itself. It saves lots of divides when forces are involved.
-
-	float* position;				//Position of the rigidbody
-	float* velocity;				//The velocity of the rigidbody
-	float* acceleration;			//The acceleration of the rigidbody
-
-	float* netForce;				//Forces over time
-	float* netImpulse;			//Instantaneous forces
-
-	///
-	//Parameterized constructor, creates rigidbody with specified initial values
-	//
-	//Parameters:
-	//	pos: Initial position
-	//	vel: Initial velocity
-	//	acc: Initial acceleration
-	//	mass: The mass of the rigidbody (0.0f for infinite mass)
-	RigidBody::RigidBody(float* pos, float vel[3], float acc[3], float m)	
-	{
-		mass = m;
-		inverseMass = m == 0.0f ? 0.0f : 1.0f / m;
-
-		position = pos;
-		velocity = new float[3];
-		acceleration = new float[3];
-		memcpy(velocity, vel, sizeof(float) * 3);
-		memcpy(acceleration, acc, sizeof(float) * 3);
-
-		netForce = new float[3];
-		netImpulse = new float[3];
-		memset(netForce, 0, sizeof(float) * 3);
-		memset(netImpulse, 0, sizeof(float) * 3);
-	}
-
-	RigidBody::~RigidBody()
-	{
-		delete[] netForce;
-		delete[] netImpulse;
-		delete[] acceleration;
-		delete[] velocity;
-	}
+	unsigned int i;		//Index of the point mass at one end
+	unsigned int j;		//Index of the point mass at the other end
+	float restLength;	//The length the spring rests at
 };
 
-//A struct for 1D Mass-Spring softbody physics
+//A struct for 2D Mass-Spring softbody physics
+//
+//Every property of the point masses is kept in its own array, and every array lives in one contiguous block.
+//Each pass over the softbody reads and writes only the arrays it needs, straight through from start to end,
+//instead of chasing a pointer to every point mass and then to each of its properties.
 struct SoftBody
 {
 	int subdivisionsX; 
@@ -227,23 +197,39 @@ struct SoftBody
 	float restHeight;
 	float restWidth;
 
-	//The rigidbodies of the point masses which make up the softbody mass-spring system
-	unsigned int numRigidBodies;
-	struct RigidBody*** bodies;
+	//The point masses which make up the softbody mass-spring system. Point mass (i, j) of the grid is at index i * subdivisionsX + j,
+	//the same as its vertex in the mesh.
+	unsigned int numPoints;
+	float* inverseMass;				//Inverse mass of each point mass (0.0f for infinite mass)
+	float* positionX;				//Position of each point mass
+	float* positionY;
+	float* positionZ;
+	float* velocityX;				//Velocity of each point mass
+	float* velocityY;
+	float* velocityZ;
+	float* netForceX;				//Forces over time acting on each point mass
+	float* netForceY;
+	float* netForceZ;
+
+	//Every spring in the system, each listed once
+	unsigned int numSprings;
+	struct Spring* springs;
 
 	float coefficient;	//The spring coefficients between the point masses in the system
-	//float restLength;	//The resting length of the springs
 	float dampening;	//The dampening coefficient of the springs
 
 	SoftBody::SoftBody()
 	{
-		numRigidBodies = 0;
+		numPoints = 0;
+		numSprings = 0;
 		coefficient = 0.0f;
-		//restLength = 0.0f;
 		dampening = 0.0f;
 
 		subdivisionsX = subdivisionsY = 0;
 		restHeight = restWidth = 0;
+
+		inverseMass = 0;
+		springs = 0;
 	}
 
 	SoftBody::SoftBody(
@@ -256,40 +242,80 @@ struct SoftBody
 		subdivisionsX = subX;
 		subdivisionsY = subY;
 
-		numRigidBodies = subX * subY;
+		numPoints = subX * subY;
 		coefficient = coeff;
-		//restLength = rest;
 		dampening = damp;
 
 		restHeight = rHeight;
 		restWidth = rWidth;
 
-		float zero[3] = {0.0f, 0.0f, 0.0f};
+		//One allocation holds every array
+		inverseMass = new float[numPoints * 10];
+		positionX = inverseMass + numPoints;
+		positionY = positionX + numPoints;
+		positionZ = positionY + numPoints;
+		velocityX = positionZ + numPoints;
+		velocityY = velocityX + numPoints;
+		velocityZ = velocityY + numPoints;
+		netForceX = velocityZ + numPoints;
+		netForceY = netForceX + numPoints;
+		netForceZ = netForceY + numPoints;
+
+		memset(velocityX, 0, sizeof(float) * numPoints * 6);
+		for(unsigned int p = 0; p < numPoints; ++p)
+		{
+			inverseMass[p] = 1.0f;
+			positionX[p] = m.vertices[p].x;
+			positionY[p] = m.vertices[p].y;
+			positionZ[p] = m.vertices[p].z;
+		}
 
-		bodies = new struct RigidBody**[subY];
+		//Each point mass gets a spring to the point mass right of it and the point mass above it
+		numSprings = (subX - 1) * subY + subX * (subY - 1);
+		springs = new struct Spring[numSprings];
+		unsigned int s = 0;
 		for(int i = 0; i < subdivisionsY; ++i)
 		{
-			bodies[i] = new struct RigidBody*[subX];
 			for(int j = 0; j < subdivisionsX; ++j)
 			{
-				bodies[i][j] = new struct RigidBody((float*)(m.vertices + i * subdivisionsY + j), zero, zero, 1.0f);
+				unsigned int p = i * subdivisionsX + j;
+				if(j < subdivisionsX - 1)
+				{
+					springs[s].i = p;
+					springs[s].j = p + 1;
+					springs[s].restLength = restWidth;
+					++s;
+				}
+				if(i < subdivisionsY - 1)
+				{
+					springs[s].i = p;
+					springs[s].j = p + subdivisionsX;
+					springs[s].restLength = restHeight;
+					++s;
+				}
 			}
 		}
-
-
 	}
 
 	SoftBody::~SoftBody()
 	{
-		for(int i = 0; i < subdivisionsY; ++i)
+		delete[] springs;
+		delete[] inverseMass;
+	}
+
+	///
+	//Copies the positions of the point masses into the vertices of a mesh
+	//
+	//Parameters:
+	//	m: The mesh the softbody was made from
+	void SoftBody::CopyToMesh(Mesh& m)
+	{
+		for(unsigned int p = 0; p < numPoints; ++p)
 		{
-			for(int j = 0; j < subdivisionsX; ++j)
-			{
-				delete bodies[i][j];
-			}
-			delete[] bodies[i];
+			m.vertices[p].x = positionX[p];
+			m.vertices[p].y = positionY[p];
+			m.vertices[p].z = positionZ[p];
 		}
-		delete[] bodies;
 	}
 };
 
@@ -396,38 +422,71 @@ void init()
 #pragma endregion Helper_functions
 
 ///
-//Performs second order euler integration for linear motion
+//Calculates the force of every spring and adds it to the point masses at both of its ends
 //
 //Parameters:
-//	dt: The timestep
-//	body: The rigidbody being integrated
-void IntegrateLinear(float dt, RigidBody &body)
+//	body: The softbody whose springs are being solved
+void AccumulateSpringForces(SoftBody &body)
 {
-	//Calculate the current acceleration
-	*(body.acceleration) = body.inverseMass * *(body.netForce);
-	*(body.acceleration + 1) = body.inverseMass * *(body.netForce + 1);
-	*(body.acceleration + 2) = body.inverseMass * *(body.netForce + 2);
-
+	for(unsigned int s = 0; s < body.numSprings; ++s)
+	{
+		unsigned int i = body.springs[s].i;
+		unsigned int j = body.springs[s].j;
+
+		//Get displacement from point mass i to point mass j
+		float displacement[3] = { body.positionX[j] - body.positionX[i], body.positionY[j] - body.positionY[i], body.positionZ[j] - body.positionZ[i] };
+		//Extract the direction and the magnitude from this displacement
+		float mag = sqrtf(displacement[0] * displacement[0] + displacement[1] * displacement[1] + displacement[2] * displacement[2]);
+		float stretch = mag - body.springs[s].restLength;
+
+		//Calculate the applied force according the Hooke's law
+		//Fspring = -k(dX)
+		//Which pulls i toward j and j toward i equally
+		float scale = body.coefficient * stretch / mag;
+		float force[3] = { scale * displacement[0], scale * displacement[1], scale * displacement[2] };
+
+		//And from that we must add the dampening force on each end:
+		//Fdamp = -V * C 
+		//Where C is the dampening constant
+		body.netForceX[i] += force[0] - body.velocityX[i] * body.dampening;
+		body.netForceY[i] += force[1] - body.velocityY[i] * body.dampening;
+		body.netForceZ[i] += force[2] - body.velocityZ[i] * body.dampening;
+
+		body.netForceX[j] += -force[0] - body.velocityX[j] * body.dampening;
+		body.netForceY[j] += -force[1] - body.velocityY[j] * body.dampening;
+		body.netForceZ[j] += -force[2] - body.velocityZ[j] * body.dampening;
+	}
+}
 
-	//Calculate new position with
-	//	X = X0 + V0*dt + (1/2) * A * dt^2
-	float v0dT[3] = {dt * *(body.velocity), dt * *(body.velocity + 1), dt * *(body.velocity + 2)};	//Solve for the first degree term
+///
+//Performs second order euler integration for linear motion on every point mass of a softbody.
+//This runs only after every force has been added, so the result does not depend on the order the point masses are visited in.
+//
+//Parameters:
+//	dt: The timestep
+//	body: The softbody being integrated
+void IntegrateLinear(float dt, SoftBody &body)
+{
 	float hdt2 = 0.5f * dt * dt;
-	float aT2[3] = {*(body.acceleration) * hdt2, *(body.acceleration + 1) * hdt2, *(body.acceleration + 2) * hdt2};	//Solve for the second degree term
-	//Take sum
-	*(body.position) += *(v0dT) + *(aT2);
-	*(body.position + 1) += *(v0dT + 1) + *(aT2 + 1);
-	*(body.position + 2) += *(v0dT + 2) + *(aT2 + 2);
-
-	//determine the new velocity
-	*(body.velocity) += dt * *(body.acceleration) + body.inverseMass * *(body.netImpulse);
-	*(body.velocity + 1) += dt * *(body.acceleration + 1) + body.inverseMass * *(body.netImpulse + 1);
-	*(body.velocity + 2) += dt * *(body.acceleration + 2) + body.inverseMass * *(body.netImpulse + 2);
-
+	for(unsigned int p = 0; p < body.numPoints; ++p)
+	{
+		//Calculate the current acceleration
+		float acceleration[3] = { body.inverseMass[p] * body.netForceX[p], body.inverseMass[p] * body.netForceY[p], body.inverseMass[p] * body.netForceZ[p] };
+
+		//Calculate new position with
+		//	X = X0 + V0*dt + (1/2) * A * dt^2
+		body.positionX[p] += dt * body.velocityX[p] + acceleration[0] * hdt2;
+		body.positionY[p] += dt * body.velocityY[p] + acceleration[1] * hdt2;
+		body.positionZ[p] += dt * body.velocityZ[p] + acceleration[2] * hdt2;
+
+		//determine the new velocity
+		body.velocityX[p] += dt * acceleration[0];
+		body.velocityY[p] += dt * acceleration[1];
+		body.velocityZ[p] += dt * acceleration[2];
+	}
 
-	//Zero the net impulse and net force!
-	memset(body.netForce, 0, 12);
-	memset(body.netImpulse, 0, 12);
+	//Zero the net force!
+	memset(body.netForceX, 0, sizeof(float) * body.numPoints * 3);
 }
 
 // This runs once every physics timestep.
@@ -461,144 +520,17 @@ void update(float dt)
 		}
 	}
 
-	float displacement[3];	//The displacement between nodes
-	float direction[3];
-	float mag;
-
-	int i = 0, j = 0;
-
-	//Apply forces to each rigidbody making up the softbody
-	while(i < body->subdivisionsY)
+	//The external force is applied to the bottom edge of the softbody
+	for(int j = 0; j < body->subdivisionsX; ++j)
 	{
-
-
-
-		//If there is a rigidbody above this one, calculate the spring force between this rigidbody and the rigidbody above
-		if(i > 0)
-		{
-			int finalI = i - 1, finalJ = j;
-			//Get displacement from rigidBody[i-1] to rigidBody[i]
-			*(displacement) = *((*(*(body->bodies + finalI) + finalJ))->position) - *((*(*(body->bodies + i) + j))->position);
-			*(displacement + 1) = *((*(*(body->bodies + finalI) + finalJ))->position + 1) - *((*(*(body->bodies + i) + j))->position + 1);
-			*(displacement + 2) = *((*(*(body->bodies + finalI) + finalJ))->position + 2) - *((*(*(body->bodies + i) + j))->position + 2);
-			//Extract the direction and the magnitude from this displacement
-			mag = sqrtf(*(displacement)**(displacement)+*(displacement+1)**(displacement+1)+*(displacement+2)**(displacement+2));
-			*(direction) = *(displacement)/mag;
-			*(direction + 1) = *(displacement + 1)/mag;
-			*(direction + 2) = *(displacement + 2)/mag;
-
-
-
-			//Calculate and Add the applied force according the Hooke's law
-			//Fspring = -k(dX)
-			//And from that we must add the dampening force:
-			//Fdamp = -V * C 
-			//Where C is the dampening constant
-			*((*(*(body->bodies + i) + j))->netForce) += body->coefficient * (*(displacement) -  body->restHeight * *(direction)) - *((*(*(body->bodies + i) + j))->velocity) * body->dampening;
-			*((*(*(body->bodies + i) + j))->netForce + 1) += body->coefficient * (*(displacement + 1) -  body->restHeight * *(direction + 1)) - *((*(*(body->bodies + i) + j))->velocity + 1) * body->dampening;
-			*((*(*(body->bodies + i) + j))->netForce + 2) += body->coefficient * (*(displacement + 2) -  body->restHeight * *(direction + 2)) - *((*(*(body->bodies + i) + j))->velocity + 2) * body->dampening;
-
-		}
-		else
-		{
-			*((*(*(body->bodies + i) + j))->netForce) += *(externalForce);
-			*((*(*(body->bodies + i) + j))->netForce + 1) += *(externalForce + 1);
-			*((*(*(body->bodies + i) + j))->netForce + 2) += *(externalForce + 2);
-		}
-
-		//If there is a rigidbody below this one, calculate the spring force between this rigidbody and the one below
-		if(i < body->subdivisionsY - 1)
-		{
-			int finalI = i + 1, finalJ = j;
-			//Get displacement from rigidBody[i-1] to rigidBody[i]
-			*(displacement) = *((*(*(body->bodies + finalI) + finalJ))->position) - *((*(*(body->bodies + i) + j))->position);
-			*(displacement + 1) = *((*(*(body->bodies + finalI) + finalJ))->position + 1) - *((*(*(body->bodies + i) + j))->position + 1);
-			*(displacement + 2) = *((*(*(body->bodies + finalI) + finalJ))->position + 2) - *((*(*(body->bodies + i) + j))->position + 2);
-			//Extract the direction and the magnitude from this displacement
-			mag = sqrtf(*(displacement)**(displacement)+*(displacement+1)**(displacement+1)+*(displacement+2)**(displacement+2));
-			*(direction) = *(displacement)/mag;
-			*(direction + 1) = *(displacement + 1)/mag;
-			*(direction + 2) = *(displacement + 2)/mag;
-
-
-
-			//Calculate and Add the applied force according the Hooke's law
-			//Fspring = -k(dX)
-			//And from that we must add the dampening force:
-			//Fdamp = -V * C 
-			//Where C is the dampening constant
-			*((*(*(body->bodies + i) + j))->netForce) += body->coefficient * (*(displacement) -  body->restHeight * *(direction)) - *((*(*(body->bodies + i) + j))->velocity) * body->dampening;
-			*((*(*(body->bodies + i) + j))->netForce + 1) += body->coefficient * (*(displacement + 1) -  body->restHeight * *(direction + 1)) - *((*(*(body->bodies + i) + j))->velocity + 1) * body->dampening;
-			*((*(*(body->bodies + i) + j))->netForce + 2) += body->coefficient * (*(displacement + 2) -  body->restHeight * *(direction + 2)) - *((*(*(body->bodies + i) + j))->velocity + 2) * body->dampening;
-		}
-
-		//If there is a rigidbody left of this one, calculate the spring force between this rigidbody and the one below
-		if(j > 0)
-		{
-			int finalI = i, finalJ = j - 1;
-			//Get displacement from rigidBody[i-1] to rigidBody[i]
-			*(displacement) = *((*(*(body->bodies + finalI) + finalJ))->position) - *((*(*(body->bodies + i) + j))->position);
-			*(displacement + 1) = *((*(*(body->bodies + finalI) + finalJ))->position + 1) - *((*(*(body->bodies + i) + j))->position + 1);
-			*(displacement + 2) = *((*(*(body->bodies + finalI) + finalJ))->position + 2) - *((*(*(body->bodies + i) + j))->position + 2);
-			//Extract the direction and the magnitude from this displacement
-			mag = sqrtf(*(displacement)**(displacement)+*(displacement+1)**(displacement+1)+*(displacement+2)**(displacement+2));
-			*(direction) = *(displacement)/mag;
-			*(direction + 1) = *(displacement + 1)/mag;
-			*(direction + 2) = *(displacement + 2)/mag;
-
-
-
-			//Calculate and Add the applied force according the Hooke's law
-			//Fspring = -k(dX)
-			//And from that we must add the dampening force:
-			//Fdamp = -V * C 
-			//Where C is the dampening constant
-			*((*(*(body->bodies + i) + j))->netForce) += body->coefficient * (*(displacement) -  body->restWidth * *(direction)) - *((*(*(body->bodies + i) + j))->velocity) * body->dampening;
-			*((*(*(body->bodies + i) + j))->netForce + 1) += body->coefficient * (*(displacement + 1) -  body->restWidth * *(direction + 1)) - *((*(*(body->bodies + i) + j))->velocity + 1) * body->dampening;
-			*((*(*(body->bodies + i) + j))->netForce + 2) += body->coefficient * (*(displacement + 2) -  body->restWidth * *(direction + 2)) - *((*(*(body->bodies + i) + j))->velocity + 2) * body->dampening;
-		}
-
-		//If there is a rigidbody right of this one, calculate the spring force between this rigidbody and the one below
-		if(j < body->subdivisionsX - 1)
-		{
-			int finalI = i, finalJ = j + 1;
-			//Get displacement from rigidBody[i-1] to rigidBody[i]
-			*(displacement) = *((*(*(body->bodies + finalI) + finalJ))->position) - *((*(*(body->bodies + i) + j))->position);
-			*(displacement + 1) = *((*(*(body->bodies + finalI) + finalJ))->position + 1) - *((*(*(body->bodies + i) + j))->position + 1);
-			*(displacement + 2) = *((*(*(body->bodies + finalI) + finalJ))->position + 2) - *((*(*(body->bodies + i) + j))->position + 2);
-			//Extract the direction and the magnitude from this displacement
-			mag = sqrtf(*(displacement)**(displacement)+*(displacement+1)**(displacement+1)+*(displacement+2)**(displacement+2));
-			*(direction) = *(displacement)/mag;
-			*(direction + 1) = *(displacement + 1)/mag;
-			*(direction + 2) = *(displacement + 2)/mag;
-
-
-
-			//Calculate and Add the applied force according the Hooke's law
-			//Fspring = -k(dX)
-			//And from that we must add the dampening force:
-			//Fdamp = -V * C 
-			//Where C is the dampening constant
-			*((*(*(body->bodies + i) + j))->netForce) += body->coefficient * (*(displacement) -  body->restWidth * *(direction)) - *((*(*(body->bodies + i) + j))->velocity) * body->dampening;
-			*((*(*(body->bodies + i) + j))->netForce + 1) += body->coefficient * (*(displacement + 1) -  body->restWidth * *(direction + 1)) - *((*(*(body->bodies + i) + j))->velocity + 1) * body->dampening;
-			*((*(*(body->bodies + i) + j))->netForce + 2) += body->coefficient * (*(displacement + 2) -  body->restWidth * *(direction + 2)) - *((*(*(body->bodies + i) + j))->velocity + 2) * body->dampening;
-		}	
-
-		//Note: We lose some realism by performing the integration in this loop.
-		//For a more realistic simulation this should be in a separate loop, however we save a lot of time.
-		IntegrateLinear(dt, (*(*(*(body->bodies + i) + j))));
-
-
-		++j;
-		if(j == body->subdivisionsX) 
-		{
-			++i; 
-			j = 0;
-		}
-
+		body->netForceX[j] += externalForce[0];
+		body->netForceY[j] += externalForce[1];
+		body->netForceZ[j] += externalForce[2];
 	}
 
-
+	//Add the force of every spring, then move every point mass
+	AccumulateSpringForces(*body);
+	IntegrateLinear(dt, *body);
 }
 
 // This runs once every frame to determine the FPS and how often to call update based on the physics step.
@@ -650,7 +582,8 @@ void renderScene()
 	//Set hue uniform
 	glUniformMatrix4fv(uniHue, 1, GL_FALSE, glm::value_ptr(hue));
 
-	//Refresh the rope vertices
+	//Refresh the lattice vertices
+	body->CopyToMesh(*lattice);
 	lattice->RefreshData();
 	// Draw the Gameobjects
 	lattice->Draw();
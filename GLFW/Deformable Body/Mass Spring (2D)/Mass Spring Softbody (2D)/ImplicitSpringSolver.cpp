@@ -0,0 +1,248 @@
+#include "ImplicitSpringSolver.h"
+
+#include <float.h>
+#include <algorithm>
+
+// Dot product of two whole vectors of the system
+float Dot(const std::vector<glm::vec3>& a, const std::vector<glm::vec3>& b)
+{
+	float sum = 0.0f;
+	for (unsigned int i = 0; i < a.size(); ++i)
+	{
+		sum += glm::dot(a[i], b[i]);
+	}
+	return sum;
+}
+
+// Finds the block in column c of row r. Every block a spring needs is made by the constructor, so this always finds one.
+unsigned int FindBlock(const std::vector<unsigned int>& rowStart, const std::vector<unsigned int>& columns, unsigned int r, unsigned int c)
+{
+	std::vector<unsigned int>::const_iterator first = columns.begin() + rowStart[r];
+	std::vector<unsigned int>::const_iterator last = columns.begin() + rowStart[r + 1];
+	return std::lower_bound(first, last, c) - columns.begin();
+}
+
+// Each row has a block for the point mass itself and one for every point mass it shares a spring with.
+// The columns of each row are sorted so the blocks can be found with a binary search.
+ImplicitSpringSolver::ImplicitSpringSolver(unsigned int numPoints, const ImplicitSpring* springs, unsigned int numSprings)
+{
+	_numPoints = numPoints;
+	_springs.assign(springs, springs + numSprings);
+
+	coefficient = 0.0f;
+	dampening = 0.0f;
+	tolerance = 1e-4f;
+	maxIterations = 100;
+	_lastIterations = 0;
+
+	positions.resize(numPoints, glm::vec3(0.0f));
+	velocities.resize(numPoints, glm::vec3(0.0f));
+	externalForces.resize(numPoints, glm::vec3(0.0f));
+	inverseMasses.resize(numPoints, 1.0f);
+
+	std::vector<std::vector<unsigned int> > neighbors(numPoints);
+	_degrees.resize(numPoints, 0.0f);
+	for (unsigned int p = 0; p < numPoints; ++p)
+	{
+		neighbors[p].push_back(p);
+	}
+	for (unsigned int s = 0; s < numSprings; ++s)
+	{
+		neighbors[springs[s].i].push_back(springs[s].j);
+		neighbors[springs[s].j].push_back(springs[s].i);
+		_degrees[springs[s].i] += 1.0f;
+		_degrees[springs[s].j] += 1.0f;
+	}
+
+	_rowStart.resize(numPoints + 1);
+	_rowStart[0] = 0;
+	for (unsigned int p = 0; p < numPoints; ++p)
+	{
+		std::sort(neighbors[p].begin(), neighbors[p].end());
+		neighbors[p].erase(std::unique(neighbors[p].begin(), neighbors[p].end()), neighbors[p].end());
+		_columns.insert(_columns.end(), neighbors[p].begin(), neighbors[p].end());
+		_rowStart[p + 1] = _columns.size();
+	}
+	_blocks.resize(_columns.size());
+
+	_diagonalBlocks.resize(numPoints);
+	for (unsigned int p = 0; p < numPoints; ++p)
+	{
+		_diagonalBlocks[p] = FindBlock(_rowStart, _columns, p, p);
+	}
+
+	_springBlocks.resize(numSprings * 2);
+	for (unsigned int s = 0; s < numSprings; ++s)
+	{
+		_springBlocks[s * 2] = FindBlock(_rowStart, _columns, springs[s].i, springs[s].j);
+		_springBlocks[s * 2 + 1] = FindBlock(_rowStart, _columns, springs[s].j, springs[s].i);
+	}
+
+	_rhs.resize(numPoints);
+	_dv.resize(numPoints, glm::vec3(0.0f));
+	_residual.resize(numPoints);
+	_preconditioned.resize(numPoints);
+	_direction.resize(numPoints);
+	_product.resize(numPoints);
+	_inverseDiagonal.resize(numPoints);
+}
+
+ImplicitSpringSolver::~ImplicitSpringSolver()
+{
+}
+
+// For a spring from i to j with length l, rest length L and direction n, the force on i is k * (l - L) * n and
+// its derivative with respect to the position of j is
+//
+//		K = k * (n * n^T + (1 - L / l) * (I - n * n^T))
+//
+// The derivative with respect to i is -K, and the force on j is the opposite. When a spring is compressed the
+// second term is negative and can make the matrix indefinite, which conjugate gradient cannot handle, so it is
+// dropped. This only changes how the step converges, not the forces themselves.
+void ImplicitSpringSolver::Assemble(float dt)
+{
+	float h2 = dt * dt;
+
+	for (unsigned int b = 0; b < _blocks.size(); ++b)
+	{
+		_blocks[b] = glm::mat3(0.0f);
+	}
+
+	// The forces that do not come from the springs: external forces and dampening
+	for (unsigned int p = 0; p < _numPoints; ++p)
+	{
+		float damping = dampening * _degrees[p];
+		_rhs[p] = externalForces[p] - damping * velocities[p];
+
+		float mass = inverseMasses[p] == 0.0f ? 1.0f : 1.0f / inverseMasses[p];
+		_blocks[_diagonalBlocks[p]] = glm::mat3(mass + dt * damping);
+	}
+
+	for (unsigned int s = 0; s < _springs.size(); ++s)
+	{
+		unsigned int i = _springs[s].i;
+		unsigned int j = _springs[s].j;
+
+		glm::vec3 displacement = positions[j] - positions[i];
+		float length = glm::length(displacement);
+		if (length <= FLT_EPSILON)
+		{
+			continue;
+		}
+		glm::vec3 direction = displacement / length;
+
+		glm::vec3 force = coefficient * (length - _springs[s].restLength) * direction;
+
+		glm::mat3 nnT = glm::outerProduct(direction, direction);
+		glm::mat3 K = coefficient * nnT;
+		float transverse = 1.0f - _springs[s].restLength / length;
+		if (transverse > 0.0f)
+		{
+			K += (coefficient * transverse) * (glm::mat3(1.0f) - nnT);
+		}
+
+		// F + h * dF/dx * v
+		glm::vec3 Kdv = dt * (K * (velocities[j] - velocities[i]));
+		_rhs[i] += force + Kdv;
+		_rhs[j] -= force + Kdv;
+
+		// -h^2 * dF/dx
+		glm::mat3 hK = h2 * K;
+		_blocks[_diagonalBlocks[i]] += hK;
+		_blocks[_diagonalBlocks[j]] += hK;
+		_blocks[_springBlocks[s * 2]] -= hK;
+		_blocks[_springBlocks[s * 2 + 1]] -= hK;
+	}
+
+	for (unsigned int p = 0; p < _numPoints; ++p)
+	{
+		_rhs[p] *= dt;
+		_inverseDiagonal[p] = inverseMasses[p] == 0.0f ? glm::mat3(1.0f) : glm::inverse(_blocks[_diagonalBlocks[p]]);
+	}
+}
+
+void ImplicitSpringSolver::Multiply(const std::vector<glm::vec3>& x, std::vector<glm::vec3>& y) const
+{
+	for (unsigned int r = 0; r < _numPoints; ++r)
+	{
+		glm::vec3 sum(0.0f);
+		for (unsigned int b = _rowStart[r]; b < _rowStart[r + 1]; ++b)
+		{
+			sum += _blocks[b] * x[_columns[b]];
+		}
+		y[r] = sum;
+	}
+	Filter(y);
+}
+
+void ImplicitSpringSolver::Filter(std::vector<glm::vec3>& x) const
+{
+	for (unsigned int p = 0; p < _numPoints; ++p)
+	{
+		if (inverseMasses[p] == 0.0f) x[p] = glm::vec3(0.0f);
+	}
+}
+
+// The change in velocity from the last step is where the solve starts, since consecutive steps of a
+// smoothly moving system need similar changes.
+void ImplicitSpringSolver::Step(float dt)
+{
+	Assemble(dt);
+	Filter(_rhs);
+	Filter(_dv);
+
+	// residual = b - A * dv
+	Multiply(_dv, _product);
+	for (unsigned int p = 0; p < _numPoints; ++p)
+	{
+		_residual[p] = _rhs[p] - _product[p];
+		_preconditioned[p] = _inverseDiagonal[p] * _residual[p];
+		_direction[p] = _preconditioned[p];
+	}
+
+	float threshold = tolerance * tolerance * Dot(_rhs, _rhs);
+	float rz = Dot(_residual, _preconditioned);
+
+	_lastIterations = 0;
+	while (_lastIterations < maxIterations && Dot(_residual, _residual) > threshold)
+	{
+		Multiply(_direction, _product);
+		float pAp = Dot(_direction, _product);
+		if (pAp <= 0.0f)
+		{
+			break;
+		}
+
+		float alpha = rz / pAp;
+		for (unsigned int p = 0; p < _numPoints; ++p)
+		{
+			_dv[p] += alpha * _direction[p];
+			_residual[p] -= alpha * _product[p];
+			_preconditioned[p] = _inverseDiagonal[p] * _residual[p];
+		}
+
+		float rzNext = Dot(_residual, _preconditioned);
+		float beta = rzNext / rz;
+		rz = rzNext;
+		for (unsigned int p = 0; p < _numPoints; ++p)
+		{
+			_direction[p] = _preconditioned[p] + beta * _direction[p];
+		}
+
+		++_lastIterations;
+	}
+
+	for (unsigned int p = 0; p < _numPoints; ++p)
+	{
+		externalForces[p] = glm::vec3(0.0f);
+		if (inverseMasses[p] == 0.0f) continue;
+
+		velocities[p] += _dv[p];
+		positions[p] += dt * velocities[p];
+	}
+}
+
+int ImplicitSpringSolver::lastIterations() const
+{
+	return _lastIterations;
+}
@@ -0,0 +1,158 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include "glm\glm.hpp"
+
+class XPBDBarrier;
+
+// A distance constraint between two point masses, given by their indices
+struct XPBDConstraint
+{
+	unsigned int i;
+	unsigned int j;
+	float restLength;
+};
+
+// Steps a mass spring system with extended position based dynamics (XPBD, Macklin, Muller and Chentanev).
+//
+// Instead of turning each spring into a force, every spring becomes a constraint on the distance between its two
+// point masses. Each substep moves the point masses freely, then projects the constraints by moving the point masses
+// directly, and finally derives the velocities from how far everything moved. Plain position based dynamics gets
+// stiffer the more iterations and substeps it takes; XPBD gives every constraint a compliance (the inverse of its
+// spring coefficient) and tracks a Lagrange multiplier per constraint, which makes the stiffness independent of both.
+// The cost of a step is fixed by the number of substeps and iterations, however stiff the springs are.
+//
+// The constraints are solved Gauss-Seidel style: each one sees the corrections of the ones solved before it. To do
+// that in parallel, the constraints are split into colors so that no two constraints of the same color share a point
+// mass. The constraints of one color are then independent of each other and are split across threads, and the colors
+// are solved one after another. Since the constraints of a color never touch the same point mass, the result does
+// not depend on the number of threads.
+//
+// The solver can also keep the point masses from passing through each other (self collision). Every substep, after
+// the constraints, the point masses are sorted into a spatial hash with cells twice as wide as the thickness, and
+// every point mass closer than the thickness to another is pushed away from it. Point masses that are only a few
+// constraints apart are skipped, since the constraints already keep them at their rest distance. The pushes are
+// all worked out from the positions before any of them is applied, so each thread can take its own share of the
+// hash buckets and the result still does not depend on the number of threads.
+//
+// The worker threads are started once, when the solver is made, and wait at the barrier between steps, so a step
+// only costs waking them.
+class XPBDSolver
+{
+public:
+
+	///
+	//Makes a solver for a fixed set of point masses and constraints, and colors the constraints
+	//
+	//Parameters:
+	//	numPoints: The number of point masses
+	//	constraints: The distance constraints between them
+	//	numConstraints: The number of constraints
+	XPBDSolver(unsigned int numPoints, const XPBDConstraint* constraints, unsigned int numConstraints);
+	~XPBDSolver();
+
+	///
+	//Advances the system by one timestep, split into the given number of substeps. The positions and velocities
+	//are updated in place. External forces are cleared afterward, the same way the explicit step clears its forces.
+	//
+	//Parameters:
+	//	dt: The timestep
+	void Step(float dt);
+
+	// The state of each point mass. Fill these in before calling Step and read the results back out after.
+	std::vector<glm::vec3> positions;
+	std::vector<glm::vec3> velocities;
+	std::vector<glm::vec3> externalForces;
+	// 0.0f pins the point mass in place. Pinned point masses can still be moved by the caller between steps.
+	std::vector<float> inverseMasses;
+
+	float compliance;	//The inverse of the stiffness of every constraint, 0.0f for completely rigid
+	float dampening;	//Every constraint a point mass is part of slows it by -dampening * velocity
+
+	int substeps;		//The number of substeps each step is split into
+	int iterations;		//The number of times the constraints are solved each substep
+
+	// The number of threads each color is split across, 0 to pick from the number of constraints and hardware threads.
+	// Changing it restarts the worker threads on the next step.
+	unsigned int numThreads;
+
+	unsigned int numColors() const;
+
+	///
+	//Turns self collision on or off
+	//
+	//Parameters:
+	//	thickness: How close two point masses may get to each other, 0.0f to turn self collision off
+	//	exclusionDepth: Point masses this many constraints apart or closer never collide with each other
+	void SetSelfCollision(float thickness, int exclusionDepth);
+
+	float selfCollisionThickness() const;
+
+private:
+
+	// The number of threads numThreads asks for
+	unsigned int ThreadCount() const;
+
+	// Stops any worker threads and starts threadCount - 1 new ones. The calling thread is always thread 0.
+	void StartWorkers(unsigned int threadCount);
+
+	// Releases the worker threads to quit and waits for them
+	void StopWorkers();
+
+	// Runs on each worker thread, waiting at the barrier for each step and doing its share of it
+	void Work(unsigned int thread);
+
+	// Runs the whole step on one thread's share of the point masses and of each color. thread and threadCount
+	// pick the share, and every thread waits for the rest between colors.
+	void StepThread(float dt, unsigned int thread, unsigned int threadCount, XPBDBarrier& barrier);
+
+	// Runs one thread's share of the self collision stage
+	void CollideThread(unsigned int thread, unsigned int threadCount, XPBDBarrier& barrier);
+
+	// The hash bucket of the cell at the given cell coordinates
+	unsigned int Bucket(int x, int y, int z) const;
+
+	// Whether point masses i and j are close enough in the constraints to never collide
+	bool Excluded(unsigned int i, unsigned int j) const;
+
+	unsigned int _numPoints;
+
+	// The constraints, sorted by color. The constraints of color c are _constraints[_colorStart[c]] up to
+	// _constraints[_colorStart[c + 1] - 1].
+	std::vector<XPBDConstraint> _constraints;
+	std::vector<unsigned int> _colorStart;
+
+	// The Lagrange multiplier of each constraint, reset every substep
+	std::vector<float> _lambdas;
+
+	// Where each point mass was at the start of the substep
+	std::vector<glm::vec3> _previous;
+
+	// How many constraints each point mass is part of
+	std::vector<float> _degrees;
+
+	float _thickness;
+
+	// The point masses each point mass never collides with, sorted, in the same layout as _colorStart
+	std::vector<unsigned int> _excludedStart;
+	std::vector<unsigned int> _excluded;
+
+	// The spatial hash: the hash bucket of every point mass, and the point masses sorted by bucket. The point
+	// masses in bucket b are _sortedPoints[_bucketStart[b]] up to _sortedPoints[_bucketStart[b + 1] - 1].
+	std::vector<unsigned int> _pointBuckets;
+	std::vector<unsigned int> _bucketStart;
+	std::vector<unsigned int> _sortedPoints;
+	// The position and inverse mass (in w) of each point mass of _sortedPoints, in the same order
+	std::vector<glm::vec4> _sortedPositions;
+
+	// How far the self collision moves each point mass this substep
+	std::vector<glm::vec3> _corrections;
+
+	// The worker threads, the barrier they wait at between steps and between colors, and the timestep of the step
+	// they are released for
+	std::vector<std::thread> _workers;
+	XPBDBarrier* _barrier;
+	unsigned int _threadCount;
+	float _dt;
+	bool _quit;
+};
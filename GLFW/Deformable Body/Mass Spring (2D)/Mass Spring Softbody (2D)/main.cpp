@@ -39,6 +39,34 @@ It is best if an algorithm like this is done on the GPU, however even on the CPU
 is a very inefficient way to implement the algorithm. Please see the "Mass Spring Softbody (2D Fast)"
 example for some tips on speeding this up even when running on the CPU.
 
+The springs can also be integrated implicitly (backward Euler). Instead of moving each point mass by the forces
+at the start of the step, the implicit step solves for the velocities whose forces at the end of the step agree
+with them, which is a sparse linear system solved with a preconditioned conjugate gradient (see ImplicitSpringSolver).
+It costs more per step, but stays stable with stiff springs and a full 60 Hz timestep, where the explicit step
+needs a short timestep and soft springs or the cloth explodes.
+
+The springs can also be stepped with extended position based dynamics (XPBD, see XPBDSolver). Each spring becomes
+a constraint on the distance between its point masses, and every substep the point masses are moved freely and then
+pulled back to satisfy the constraints directly. The constraints are split into colors which share no point masses,
+so the constraints of a color can be solved on several threads at once. The stiffness only depends on the spring
+coefficient, not on how many substeps and iterations are taken, and the cost of a step never grows with the stiffness.
+
+With XPBD the cloth can also be kept from passing through itself (self collision). Every substep the point masses
+are sorted into a spatial hash, and any two closer than the spacing of the cloth are pushed apart, unless they are
+within two springs of each other. Fold the cloth over itself to see it.
+
+The springs themselves are kept in a spring network (see SpringNetwork), which every integration mode is built from.
+The explicit step works out the force of each spring in the network once and adds it to both ends, so the same code
+runs however the springs are laid out. Press B to swap the lattice for a triangle mesh of it, which adds a shear spring
+across each cell and a bend spring across each edge between two triangles.
+
+Press I to cycle between explicit, implicit and XPBD integration.
+Press Page Up and Page Down to double or halve the spring coefficient.
+Press the Left and Right arrow keys to change the number of XPBD iterations.
+Press Minus and Equals to change the number of XPBD substeps.
+Press C to turn XPBD self collision on or off.
+Press B to add or remove shear and bend springs.
+
 References:
 Game Physics by David Eberly
 NGenVS by Nicholas Gallagher
@@ -47,6 +75,9 @@ Base by Srinivasan Thiagarajan
 */
 
 #include "GLIncludes.h"
+#include "ImplicitSpringSolver.h"
+#include "XPBDSolver.h"
+#include "SpringNetwork.h"
 
 // Global data members
 #pragma region Base_data
@@ -308,6 +339,27 @@ double timebase = 0.0;
 double accumulator = 0.0;
 double physicsStep = 0.012; // This is the number of milliseconds we intend for the physics to update.
 
+//Explicit integration needs a short timestep to stay stable, implicit integration and XPBD can take a whole frame at 60 Hz
+const double explicitStep = 0.012;
+const double implicitStep = 1.0 / 60.0;
+const double xpbdStep = 1.0 / 60.0;
+
+enum IntegrationMode
+{
+	Explicit_Euler,
+	Implicit_Euler,
+	Extended_Position_Based
+};
+const char* integrationNames[] = { "Explicit", "Implicit", "XPBD" };
+IntegrationMode integration = Explicit_Euler;
+
+//The springs of the softbody, shared by every integration mode
+SpringNetwork* network;
+bool extraSprings = false;
+
+ImplicitSpringSolver* solver;
+XPBDSolver* xpbd;
+
 #pragma endregion Base_data								  
 
 // Functions called only once every time the program is executed.
@@ -400,27 +452,234 @@ void init()
 #pragma endregion Helper_functions
 
 ///
-//Performs second order euler integration for linear motion
+//Creates the spring network of the softbody. Point mass (i, j) is index i * subdivisionsX + j, the same as its vertex
+//in the mesh. Normally each point mass has a spring to its neighbors along the lattice. With extra springs, each cell
+//of the lattice is cut into two triangles and the network is made from the triangles instead, which adds a shear spring
+//across every cell and a bend spring across every edge between two triangles.
+void BuildSpringNetwork()
+{
+	std::vector<glm::vec3> restPositions;
+	for(int i = 0; i < body->subdivisionsY; ++i)
+	{
+		for(int j = 0; j < body->subdivisionsX; ++j)
+		{
+			restPositions.push_back(glm::vec3(body->restWidth * j, body->restHeight * i, 0.0f));
+		}
+	}
+
+	network = new SpringNetwork(restPositions.size(), &restPositions[0]);
+
+	if(extraSprings)
+	{
+		std::vector<unsigned int> triangles;
+		for(int i = 0; i < body->subdivisionsY - 1; ++i)
+		{
+			for(int j = 0; j < body->subdivisionsX - 1; ++j)
+			{
+				unsigned int index = i * body->subdivisionsX + j;
+				unsigned int cell[6] = {
+					index, index + 1, index + body->subdivisionsX + 1,
+					index, index + body->subdivisionsX + 1, index + body->subdivisionsX
+				};
+				triangles.insert(triangles.end(), cell, cell + 6);
+			}
+		}
+		network->AddTriangles(&triangles[0], triangles.size() / 3, true);
+	}
+	else
+	{
+		for(int i = 0; i < body->subdivisionsY; ++i)
+		{
+			for(int j = 0; j < body->subdivisionsX; ++j)
+			{
+				unsigned int index = i * body->subdivisionsX + j;
+				if(j < body->subdivisionsX - 1)
+					network->AddSpring(index, index + 1);
+				if(i < body->subdivisionsY - 1)
+					network->AddSpring(index, index + body->subdivisionsX);
+			}
+		}
+	}
+
+	network->Build();
+}
+
+///
+//Creates the implicit solver with a spring for each spring of the network
+void BuildImplicitSolver()
+{
+	std::vector<ImplicitSpring> springs;
+	for(unsigned int s = 0; s < network->numSprings(); ++s)
+	{
+		ImplicitSpring spring = { network->springs()[s].i, network->springs()[s].j, network->springs()[s].restLength };
+		springs.push_back(spring);
+	}
+
+	solver = new ImplicitSpringSolver(network->numPoints(), &springs[0], springs.size());
+}
+
+///
+//Creates the XPBD solver with a constraint for each spring of the network
+void BuildXPBDSolver()
+{
+	std::vector<XPBDConstraint> constraints;
+	for(unsigned int s = 0; s < network->numSprings(); ++s)
+	{
+		XPBDConstraint constraint = { network->springs()[s].i, network->springs()[s].j, network->springs()[s].restLength };
+		constraints.push_back(constraint);
+	}
+
+	xpbd = new XPBDSolver(network->numPoints(), &constraints[0], constraints.size());
+}
+
+///
+//Swaps the springs of the softbody between the lattice and the triangles with shear and bend springs, rebuilding
+//every solver from the new network. The XPBD settings carry over.
+void RebuildSprings()
+{
+	int iterations = xpbd->iterations;
+	int substeps = xpbd->substeps;
+	float thickness = xpbd->selfCollisionThickness();
+
+	delete network;
+	delete solver;
+	delete xpbd;
+
+	extraSprings = !extraSprings;
+	BuildSpringNetwork();
+	BuildImplicitSolver();
+	BuildXPBDSolver();
+
+	xpbd->iterations = iterations;
+	xpbd->substeps = substeps;
+	if(thickness > 0.0f)
+		xpbd->SetSelfCollision(thickness, 2);
+}
+
+///
+//Performs one explicit step of the whole softbody with the spring network, copying the rigidbodies in and out
+//the same way as UpdateImplicit
 //
 //Parameters:
 //	dt: The timestep
-//	body: The rigidbody being integrated
-void IntegrateLinear(float dt, RigidBody &body)
+//	externalForce: The force applied to the bottom row
+void UpdateExplicit(float dt, const glm::vec3& externalForce)
 {
-	//Calculate the current acceleration
-	body.acceleration = body.inverseMass * body.netForce;
+	network->coefficient = body->coefficient;
+	network->dampening = body->dampening;
 
-	//Calculate new position with
-	//	X = X0 + V0*dt + (1/2) * A * dt^2
-	glm::vec3 v0dT = dt * body.velocity;						//Solve for the first degree term
-	glm::vec3 aT2 = (0.5f) * body.acceleration * powf(dt, 2);	//Solve for the second degree term
-	body.position += v0dT + aT2;								//Take sum
+	for(int i = 0; i < body->subdivisionsY; ++i)
+	{
+		for(int j = 0; j < body->subdivisionsX; ++j)
+		{
+			int index = i * body->subdivisionsX + j;
+			network->positions[index] = body->bodies[i][j].position;
+			network->velocities[index] = body->bodies[i][j].velocity;
+			network->inverseMasses[index] = body->bodies[i][j].inverseMass;
+			//If the vertex is on the bottom row, apply the external force
+			if(i == 0)
+				network->forces[index] += externalForce;
+		}
+	}
 
-	//determine the new velocity
-	body.velocity += dt * body.acceleration + body.inverseMass * body.netImpulse;
+	network->Step(dt);
 
-	//Zero the net impulse and net force!
-	body.netForce = body.netImpulse = glm::vec3(0.0f);
+	for(int i = 0; i < body->subdivisionsY; ++i)
+	{
+		for(int j = 0; j < body->subdivisionsX; ++j)
+		{
+			int index = i * body->subdivisionsX + j;
+			body->bodies[i][j].position = network->positions[index];
+			body->bodies[i][j].velocity = network->velocities[index];
+
+			lattice->vertices[index].x = body->bodies[i][j].position.x;
+			lattice->vertices[index].y = body->bodies[i][j].position.y;
+			lattice->vertices[index].z = body->bodies[i][j].position.z;
+		}
+	}
+}
+
+///
+//Performs one implicit step of the whole softbody. The rigidbodies are copied into the solver and back,
+//so the integration can be switched at any time.
+//
+//Parameters:
+//	dt: The timestep
+//	externalForce: The force applied to the bottom row
+void UpdateImplicit(float dt, const glm::vec3& externalForce)
+{
+	solver->coefficient = body->coefficient;
+	solver->dampening = body->dampening;
+
+	for(int i = 0; i < body->subdivisionsY; ++i)
+	{
+		for(int j = 0; j < body->subdivisionsX; ++j)
+		{
+			int index = i * body->subdivisionsX + j;
+			solver->positions[index] = body->bodies[i][j].position;
+			solver->velocities[index] = body->bodies[i][j].velocity;
+			solver->inverseMasses[index] = body->bodies[i][j].inverseMass;
+			if(i == 0)
+				solver->externalForces[index] = externalForce;
+		}
+	}
+
+	solver->Step(dt);
+
+	for(int i = 0; i < body->subdivisionsY; ++i)
+	{
+		for(int j = 0; j < body->subdivisionsX; ++j)
+		{
+			int index = i * body->subdivisionsX + j;
+			body->bodies[i][j].position = solver->positions[index];
+			body->bodies[i][j].velocity = solver->velocities[index];
+
+			lattice->vertices[index].x = body->bodies[i][j].position.x;
+			lattice->vertices[index].y = body->bodies[i][j].position.y;
+			lattice->vertices[index].z = body->bodies[i][j].position.z;
+		}
+	}
+}
+
+///
+//Performs one XPBD step of the whole softbody, copying the rigidbodies in and out the same way as UpdateImplicit
+//
+//Parameters:
+//	dt: The timestep
+//	externalForce: The force applied to the bottom row
+void UpdateXPBD(float dt, const glm::vec3& externalForce)
+{
+	xpbd->compliance = 1.0f / body->coefficient;
+	xpbd->dampening = body->dampening;
+
+	for(int i = 0; i < body->subdivisionsY; ++i)
+	{
+		for(int j = 0; j < body->subdivisionsX; ++j)
+		{
+			int index = i * body->subdivisionsX + j;
+			xpbd->positions[index] = body->bodies[i][j].position;
+			xpbd->velocities[index] = body->bodies[i][j].velocity;
+			xpbd->inverseMasses[index] = body->bodies[i][j].inverseMass;
+			if(i == 0)
+				xpbd->externalForces[index] = externalForce;
+		}
+	}
+
+	xpbd->Step(dt);
+
+	for(int i = 0; i < body->subdivisionsY; ++i)
+	{
+		for(int j = 0; j < body->subdivisionsX; ++j)
+		{
+			int index = i * body->subdivisionsX + j;
+			body->bodies[i][j].position = xpbd->positions[index];
+			body->bodies[i][j].velocity = xpbd->velocities[index];
+
+			lattice->vertices[index].x = body->bodies[i][j].position.x;
+			lattice->vertices[index].y = body->bodies[i][j].position.y;
+			lattice->vertices[index].z = body->bodies[i][j].position.z;
+		}
+	}
 }
 
 // This runs once every physics timestep.
@@ -454,84 +713,18 @@ void update(float dt)
 		}
 	}
 
-	glm::vec3 displacement;	//The displacement between nodes
-	glm::vec3 direction;	//The direction of the displacement
-	float mag;				//The magnitude of the dispplacement
-
-	//Apply forces to each rigidbody making up the softbody
-	for(int i = 0; i < body->subdivisionsY; i++)
+	if(integration == Implicit_Euler)
 	{
-
-		for(int j = 0; j < body->subdivisionsX; ++j)
-		{
-
-			//If there is a rigidbody above this one, calculate the spring force between this rigidbody and the rigidbody above
-			if(i > 0)
-			{
-				//Get displacement from rigidBody[i-1] to rigidBody[i]
-				displacement = body->bodies[i - 1][j].position - body->bodies[i][j].position;
-				//Extract the direction and the magnitude from this displacement
-				direction = glm::normalize(displacement);
-				mag = glm::length(displacement);
-
-				//Calculate and Add the applied force according the Hooke's law
-				//Fspring = -k(dX)
-				//And from that we must add the dampening force:
-				//Fdamp = -V * C 
-				//Where C is the dampening constant
-				body->bodies[i][j].netForce += body->coefficient * (mag - body->restHeight) * direction - body->bodies[i][j].velocity * body->dampening;
-			}
-
-			//If there is a rigidbody below this one, calculate the spring force between this rigidbody and the one below
-			if(i < body->subdivisionsY - 1)
-			{
-				displacement = body->bodies[i + 1][j].position - body->bodies[i][j].position;
-				direction = glm::normalize(displacement);
-				mag = glm::length(displacement);
-				body->bodies[i][j].netForce += body->coefficient * (mag - body->restHeight) * direction - body->bodies[i][j].velocity * body->dampening;
-			}
-
-			//If there is a rigidbody left of this one, calculate the spring force between this rigidbody and the one below
-			if(j > 0)
-			{
-				displacement = body->bodies[i][j - 1].position - body->bodies[i][j].position;
-				direction = glm::normalize(displacement);
-				mag = glm::length(displacement);
-				body->bodies[i][j].netForce += body->coefficient * (mag - body->restWidth) * direction - body->bodies[i][j].velocity * body->dampening;
-			}
-
-			//If there is a rigidbody right of this one, calculate the spring force between this rigidbody and the one below
-			if(j < body->subdivisionsX - 1)
-			{
-				displacement = body->bodies[i][j + 1].position - body->bodies[i][j].position;
-				direction = glm::normalize(displacement);
-				mag = glm::length(displacement);
-				body->bodies[i][j].netForce += body->coefficient * (mag - body->restWidth) * direction - body->bodies[i][j].velocity * body->dampening;
-			}
-
-			//If the vertex is on the bottom row, apply the external force
-			if(i == 0)
-				body->bodies[i][j].netForce += externalForce;
-		}
+		UpdateImplicit(dt, externalForce);
+		return;
 	}
-
-
-	//Update the rigidbodies & mesh
-	//For each rigidbody
-	for(int i = 0; i < body->subdivisionsY; ++i)
+	if(integration == Extended_Position_Based)
 	{
-		for(int j = 0; j < body->subdivisionsX;++j)
-		{
-			int numVertex = i * body->subdivisionsY + j;
-			//Integrate kinematics
-			IntegrateLinear(dt, body->bodies[i][j]);
-			//And change the mesh's vertices to match this rigidbodies position
-			lattice->vertices[numVertex].x = body->bodies[i][j].position.x;
-			lattice->vertices[numVertex].y = body->bodies[i][j].position.y;
-			lattice->vertices[numVertex].z = body->bodies[i][j].position.z;
-		}
+		UpdateXPBD(dt, externalForce);
+		return;
 	}
 
+	UpdateExplicit(dt, externalForce);
 }
 
 // This runs once every frame to determine the FPS and how often to call update based on the physics step.
@@ -589,6 +782,65 @@ void renderScene()
 	lattice->Draw();
 }
 
+void OnKeyPress(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+	if(action == GLFW_PRESS)
+	{
+		if(key == GLFW_KEY_I)
+		{
+			integration = (IntegrationMode)((integration + 1) % 3);
+			physicsStep = integration == Implicit_Euler ? implicitStep : integration == Extended_Position_Based ? xpbdStep : explicitStep;
+			printf("\nIntegration:\t%s\n", integrationNames[integration]);
+			if(integration == Extended_Position_Based)
+				printf("Constraint colors:\t%u\n", xpbd->numColors());
+		}
+		else if(key == GLFW_KEY_RIGHT)
+		{
+			++xpbd->iterations;
+			printf("\nXPBD iterations:\t%d\n", xpbd->iterations);
+		}
+		else if(key == GLFW_KEY_LEFT && xpbd->iterations > 1)
+		{
+			--xpbd->iterations;
+			printf("\nXPBD iterations:\t%d\n", xpbd->iterations);
+		}
+		else if(key == GLFW_KEY_EQUAL)
+		{
+			++xpbd->substeps;
+			printf("\nXPBD substeps:\t%d\n", xpbd->substeps);
+		}
+		else if(key == GLFW_KEY_MINUS && xpbd->substeps > 1)
+		{
+			--xpbd->substeps;
+			printf("\nXPBD substeps:\t%d\n", xpbd->substeps);
+		}
+		else if(key == GLFW_KEY_C)
+		{
+			//Point masses are kept a spring's length apart, unless they are within two springs of each other
+			if(xpbd->selfCollisionThickness() > 0.0f)
+				xpbd->SetSelfCollision(0.0f, 0);
+			else
+				xpbd->SetSelfCollision(glm::min(body->restWidth, body->restHeight), 2);
+			printf("\nXPBD self collision:\t%s\n", xpbd->selfCollisionThickness() > 0.0f ? "On" : "Off");
+		}
+		else if(key == GLFW_KEY_B)
+		{
+			RebuildSprings();
+			printf("\nShear and bend springs:\t%s (%u springs)\n", extraSprings ? "On" : "Off", network->numSprings());
+		}
+		else if(key == GLFW_KEY_PAGE_UP)
+		{
+			body->coefficient *= 2.0f;
+			printf("\nSpring coefficient:\t%f\n", body->coefficient);
+		}
+		else if(key == GLFW_KEY_PAGE_DOWN)
+		{
+			body->coefficient *= 0.5f;
+			printf("\nSpring coefficient:\t%f\n", body->coefficient);
+		}
+	}
+}
+
 #pragma endregion util_Functions
 
 
@@ -602,6 +854,8 @@ void main()
 	glfwMakeContextCurrent(window);
 	glfwSwapInterval(0);
 
+	glfwSetKeyCallback(window, OnKeyPress);
+
 	// Initializes most things needed before the main loop
 	init();
 
@@ -653,12 +907,21 @@ void main()
 
 	//Generate the softbody
 	body = new SoftBody(1.0f, 1.0f, 10, 10, coeff, damp);
+	BuildSpringNetwork();
+	BuildImplicitSolver();
+	BuildXPBDSolver();
 
 	//Print controls
 	printf("Controls:\nPress and hold the left mouse button to cause a positive constant force\n along the selected axis.\n");
 	printf("Press and hold the right mouse button to cause a negative constant force\n along the selected axis.\n");
 	printf("The selected axis by default is the X axis\n");
 	printf("Hold Left Shift to change the selected axis to the Y axis\n");
+	printf("Press I to cycle between explicit, implicit and XPBD integration\n");
+	printf("Press Page Up and Page Down to double or halve the spring coefficient\n");
+	printf("Press Left and Right to change the number of XPBD iterations\n");
+	printf("Press Minus and Equals to change the number of XPBD substeps\n");
+	printf("Press C to turn XPBD self collision on or off\n");
+	printf("Press B to add or remove shear and bend springs\n");
 	
 
 	// Enter the main loop.
@@ -686,6 +949,9 @@ void main()
 
 	delete lattice;
 	delete body;
+	delete solver;
+	delete xpbd;
+	delete network;
 
 
 	// Frees up GLFW memory
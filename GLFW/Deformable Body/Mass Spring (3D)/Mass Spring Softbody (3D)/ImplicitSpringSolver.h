@@ -0,0 +1,102 @@
+#pragma once
+#include <vector>
+#include "glm\glm.hpp"
+
+// A spring between two point masses, given by their indices
+struct ImplicitSpring
+{
+	unsigned int i;
+	unsigned int j;
+	float restLength;
+};
+
+// Steps a mass spring system with implicit (backward) Euler integration, as described by Baraff and Witkin.
+//
+// Explicit integration only uses the forces at the start of the step, so stiff springs overshoot and the system
+// blows up unless the timestep is tiny. Backward Euler instead solves for the velocities at the end of the step,
+// using the forces at the end of the step. The forces are linearized around the current state, which turns the
+// step into the linear system
+//
+//		(M - h * dF/dv - h^2 * dF/dx) * dv = h * (F + h * dF/dx * v)
+//
+// which stays stable for any spring coefficient and timestep. The matrix has a 3x3 block for every point mass and
+// one for each end of every spring, so it is stored as a sparse block matrix (block compressed rows). The springs
+// never change, so where each block lives is worked out once when the solver is made, and every step only fills
+// in the values. The system is solved with a conjugate gradient preconditioned by the inverse of each diagonal block.
+//
+// The damping matches the explicit examples: every spring a point mass is attached to slows it by -dampening * velocity.
+class ImplicitSpringSolver
+{
+public:
+
+	///
+	//Makes a solver for a fixed set of point masses and springs
+	//
+	//Parameters:
+	//	numPoints: The number of point masses
+	//	springs: The springs between them
+	//	numSprings: The number of springs
+	ImplicitSpringSolver(unsigned int numPoints, const ImplicitSpring* springs, unsigned int numSprings);
+	~ImplicitSpringSolver();
+
+	///
+	//Advances the system by one timestep. The positions and velocities are updated in place.
+	//External forces are cleared afterward, the same way the explicit step clears its forces.
+	//
+	//Parameters:
+	//	dt: The timestep
+	void Step(float dt);
+
+	// The state of each point mass. Fill these in before calling Step and read the results back out after.
+	std::vector<glm::vec3> positions;
+	std::vector<glm::vec3> velocities;
+	std::vector<glm::vec3> externalForces;
+	// 0.0f pins the point mass in place. Pinned point masses can still be moved by the caller between steps.
+	std::vector<float> inverseMasses;
+
+	float coefficient;	//The spring coefficient of every spring
+	float dampening;	//The dampening coefficient of every spring
+
+	// The solve stops once the residual has shrunk by this factor, or after this many iterations
+	float tolerance;
+	int maxIterations;
+
+	// How many conjugate gradient iterations the last step took
+	int lastIterations() const;
+
+private:
+
+	// Computes the spring forces and fills the matrix and right hand side for this step
+	void Assemble(float dt);
+
+	// y = A * x
+	void Multiply(const std::vector<glm::vec3>& x, std::vector<glm::vec3>& y) const;
+
+	// Zeroes the entries of pinned point masses, so their velocities are never changed by the solve
+	void Filter(std::vector<glm::vec3>& x) const;
+
+	unsigned int _numPoints;
+	std::vector<ImplicitSpring> _springs;
+
+	// Block compressed rows: the blocks of row r are _blocks[_rowStart[r]] to _blocks[_rowStart[r + 1] - 1],
+	// and _columns holds the column of each block
+	std::vector<unsigned int> _rowStart;
+	std::vector<unsigned int> _columns;
+	std::vector<glm::mat3> _blocks;
+	// Where the diagonal block of each row is, and the two blocks each spring writes to
+	std::vector<unsigned int> _diagonalBlocks;
+	std::vector<unsigned int> _springBlocks;
+	// How many springs each point mass is attached to
+	std::vector<float> _degrees;
+
+	// Conjugate gradient vectors, kept between steps so stepping never allocates
+	std::vector<glm::vec3> _rhs;
+	std::vector<glm::vec3> _dv;
+	std::vector<glm::vec3> _residual;
+	std::vector<glm::vec3> _preconditioned;
+	std::vector<glm::vec3> _direction;
+	std::vector<glm::vec3> _product;
+	std::vector<glm::mat3> _inverseDiagonal;
+
+	int _lastIterations;
+};
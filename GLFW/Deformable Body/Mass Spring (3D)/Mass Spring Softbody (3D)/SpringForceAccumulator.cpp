@@ -0,0 +1,301 @@
+#include "SpringForceAccumulator.h"
+
+#include <float.h>
+#include <math.h>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+#include <xmmintrin.h>
+
+// Below this many springs per thread, waking the threads costs more than they save
+#define MIN_SPRINGS_PER_THREAD 4096
+
+// Holds every thread that reaches it until all of them have, so no thread starts on a color before
+// every thread has finished the one before it.
+class SpringBarrier
+{
+public:
+	SpringBarrier(unsigned int count)
+	{
+		_count = count;
+		_waiting = 0;
+		_generation = 0;
+	}
+
+	void Wait()
+	{
+		if (_count == 1) return;
+
+		std::unique_lock<std::mutex> lock(_mutex);
+		unsigned int generation = _generation;
+		if (++_waiting == _count)
+		{
+			_waiting = 0;
+			++_generation;
+			_condition.notify_all();
+		}
+		else
+		{
+			_condition.wait(lock, [this, generation] { return generation != _generation; });
+		}
+	}
+
+private:
+	std::mutex _mutex;
+	std::condition_variable _condition;
+	unsigned int _count;
+	unsigned int _waiting;
+	unsigned int _generation;
+};
+
+// Splits count items starting at first into threadCount blocks and gives the block for thread. Every block but
+// the last starts and ends on a multiple of four from first, so a color is always cut into the same groups of four
+// springs however many threads there are.
+void ShareGroups(unsigned int first, unsigned int count, unsigned int thread, unsigned int threadCount, unsigned int& begin, unsigned int& end)
+{
+	unsigned int groups = (count + 3) / 4;
+	begin = first + std::min(count, 4 * (unsigned int)((unsigned long long)groups * thread / threadCount));
+	end = first + std::min(count, 4 * (unsigned int)((unsigned long long)groups * (thread + 1) / threadCount));
+}
+
+// Colors are handed out greedily: each spring takes the lowest color neither of its point masses has been
+// given yet. A lattice with springs along each axis needs two colors per axis.
+SpringForceAccumulator::SpringForceAccumulator(unsigned int numPoints, const ForceSpring* springs, unsigned int numSprings)
+{
+	_numPoints = numPoints;
+
+	coefficient = 0.0f;
+	dampening = 0.0f;
+	numThreads = 0;
+
+	positionX.resize(numPoints, 0.0f);
+	positionY.resize(numPoints, 0.0f);
+	positionZ.resize(numPoints, 0.0f);
+	velocityX.resize(numPoints, 0.0f);
+	velocityY.resize(numPoints, 0.0f);
+	velocityZ.resize(numPoints, 0.0f);
+	forceX.resize(numPoints, 0.0f);
+	forceY.resize(numPoints, 0.0f);
+	forceZ.resize(numPoints, 0.0f);
+	_degrees.resize(numPoints, 0.0f);
+
+	std::vector<std::vector<unsigned int> > pointColors(numPoints);
+	std::vector<unsigned int> colors(numSprings);
+	unsigned int colorCount = 0;
+	for (unsigned int s = 0; s < numSprings; ++s)
+	{
+		const std::vector<unsigned int>& usedI = pointColors[springs[s].i];
+		const std::vector<unsigned int>& usedJ = pointColors[springs[s].j];
+
+		unsigned int color = 0;
+		while (std::find(usedI.begin(), usedI.end(), color) != usedI.end() || std::find(usedJ.begin(), usedJ.end(), color) != usedJ.end())
+		{
+			++color;
+		}
+
+		colors[s] = color;
+		pointColors[springs[s].i].push_back(color);
+		pointColors[springs[s].j].push_back(color);
+		if (color + 1 > colorCount) colorCount = color + 1;
+
+		_degrees[springs[s].i] += 1.0f;
+		_degrees[springs[s].j] += 1.0f;
+	}
+
+	// Counting sort by color
+	_colorStart.assign(colorCount + 1, 0);
+	for (unsigned int s = 0; s < numSprings; ++s)
+	{
+		++_colorStart[colors[s] + 1];
+	}
+	for (unsigned int color = 0; color < colorCount; ++color)
+	{
+		_colorStart[color + 1] += _colorStart[color];
+	}
+
+	_springI.resize(numSprings);
+	_springJ.resize(numSprings);
+	_restLengths.resize(numSprings);
+	std::vector<unsigned int> next(_colorStart.begin(), _colorStart.end() - 1);
+	for (unsigned int s = 0; s < numSprings; ++s)
+	{
+		unsigned int index = next[colors[s]]++;
+		_springI[index] = springs[s].i;
+		_springJ[index] = springs[s].j;
+		_restLengths[index] = springs[s].restLength;
+	}
+
+	_barrier = 0;
+	_threadCount = 0;
+	_quit = false;
+	StartWorkers(ThreadCount());
+}
+
+SpringForceAccumulator::~SpringForceAccumulator()
+{
+	StopWorkers();
+}
+
+// The calling thread takes the first share itself. Its last wait at the barrier, after the last color, is only
+// passed once every worker has finished too.
+void SpringForceAccumulator::Accumulate()
+{
+	unsigned int threadCount = ThreadCount();
+	if (threadCount != _threadCount) StartWorkers(threadCount);
+
+	_barrier->Wait();
+	AccumulateThread(0, _threadCount, *_barrier);
+}
+
+unsigned int SpringForceAccumulator::ThreadCount() const
+{
+	unsigned int threadCount = numThreads;
+	if (threadCount == 0)
+	{
+		threadCount = std::min(std::thread::hardware_concurrency(), (unsigned int)_springI.size() / MIN_SPRINGS_PER_THREAD);
+	}
+	if (threadCount == 0) threadCount = 1;
+	return threadCount;
+}
+
+void SpringForceAccumulator::StartWorkers(unsigned int threadCount)
+{
+	StopWorkers();
+
+	_barrier = new SpringBarrier(threadCount);
+	_threadCount = threadCount;
+	_quit = false;
+	for (unsigned int t = 1; t < threadCount; ++t)
+	{
+		_workers.push_back(std::thread(&SpringForceAccumulator::Work, this, t));
+	}
+}
+
+// The workers are all waiting at the barrier, so passing it with _quit set lets every one of them return
+void SpringForceAccumulator::StopWorkers()
+{
+	if (_barrier == 0) return;
+
+	_quit = true;
+	_barrier->Wait();
+	for (unsigned int t = 0; t < _workers.size(); ++t)
+	{
+		_workers[t].join();
+	}
+	_workers.clear();
+
+	delete _barrier;
+	_barrier = 0;
+	_threadCount = 0;
+}
+
+void SpringForceAccumulator::Work(unsigned int thread)
+{
+	for (;;)
+	{
+		_barrier->Wait();
+		if (_quit) return;
+		AccumulateThread(thread, _threadCount, *_barrier);
+	}
+}
+
+void SpringForceAccumulator::AccumulateThread(unsigned int thread, unsigned int threadCount, SpringBarrier& barrier)
+{
+	// Each spring slows both of its ends by -dampening * velocity, so a point mass is slowed once per spring it is attached to
+	unsigned int pointBegin, pointEnd;
+	ShareGroups(0, _numPoints, thread, threadCount, pointBegin, pointEnd);
+	for (unsigned int p = pointBegin; p < pointEnd; ++p)
+	{
+		float damping = dampening * _degrees[p];
+		forceX[p] = -damping * velocityX[p];
+		forceY[p] = -damping * velocityY[p];
+		forceZ[p] = -damping * velocityZ[p];
+	}
+	barrier.Wait();
+
+	for (unsigned int color = 0; color + 1 < _colorStart.size(); ++color)
+	{
+		unsigned int begin, end;
+		ShareGroups(_colorStart[color], _colorStart[color + 1] - _colorStart[color], thread, threadCount, begin, end);
+		AccumulateSprings(begin, end);
+		barrier.Wait();
+	}
+}
+
+// For a spring from i to j with displacement d, length l and rest length L, the force on i is
+//
+//		k * (l - L) * d / l
+//
+// and the force on j is the opposite. A spring with no length has no direction and gives no force. Four springs
+// are computed at a time, and the springs left over at the end of the color are computed one at a time with the
+// same operations.
+void SpringForceAccumulator::AccumulateSprings(unsigned int first, unsigned int last)
+{
+	const __m128 k = _mm_set1_ps(coefficient);
+	const __m128 epsilon = _mm_set1_ps(FLT_EPSILON);
+
+	float fx[4], fy[4], fz[4];
+
+	unsigned int s = first;
+	for (; s + 4 <= last; s += 4)
+	{
+		const unsigned int* i = &_springI[s];
+		const unsigned int* j = &_springJ[s];
+
+		__m128 dx = _mm_sub_ps(
+			_mm_set_ps(positionX[j[3]], positionX[j[2]], positionX[j[1]], positionX[j[0]]),
+			_mm_set_ps(positionX[i[3]], positionX[i[2]], positionX[i[1]], positionX[i[0]]));
+		__m128 dy = _mm_sub_ps(
+			_mm_set_ps(positionY[j[3]], positionY[j[2]], positionY[j[1]], positionY[j[0]]),
+			_mm_set_ps(positionY[i[3]], positionY[i[2]], positionY[i[1]], positionY[i[0]]));
+		__m128 dz = _mm_sub_ps(
+			_mm_set_ps(positionZ[j[3]], positionZ[j[2]], positionZ[j[1]], positionZ[j[0]]),
+			_mm_set_ps(positionZ[i[3]], positionZ[i[2]], positionZ[i[1]], positionZ[i[0]]));
+
+		__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+		__m128 stretch = _mm_sub_ps(length, _mm_loadu_ps(&_restLengths[s]));
+		__m128 scale = _mm_div_ps(_mm_mul_ps(k, stretch), length);
+		scale = _mm_and_ps(scale, _mm_cmpgt_ps(length, epsilon));
+
+		_mm_storeu_ps(fx, _mm_mul_ps(scale, dx));
+		_mm_storeu_ps(fy, _mm_mul_ps(scale, dy));
+		_mm_storeu_ps(fz, _mm_mul_ps(scale, dz));
+
+		// No two springs of a color share a point mass, so the four can be added one after another
+		for (int n = 0; n < 4; ++n)
+		{
+			forceX[i[n]] += fx[n];
+			forceY[i[n]] += fy[n];
+			forceZ[i[n]] += fz[n];
+			forceX[j[n]] -= fx[n];
+			forceY[j[n]] -= fy[n];
+			forceZ[j[n]] -= fz[n];
+		}
+	}
+
+	for (; s < last; ++s)
+	{
+		unsigned int i = _springI[s];
+		unsigned int j = _springJ[s];
+
+		float dx = positionX[j] - positionX[i];
+		float dy = positionY[j] - positionY[i];
+		float dz = positionZ[j] - positionZ[i];
+
+		float length = sqrtf(dx * dx + dy * dy + dz * dz);
+		if (length <= FLT_EPSILON) continue;
+		float scale = coefficient * (length - _restLengths[s]) / length;
+
+		forceX[i] += scale * dx;
+		forceY[i] += scale * dy;
+		forceZ[i] += scale * dz;
+		forceX[j] -= scale * dx;
+		forceY[j] -= scale * dy;
+		forceZ[j] -= scale * dz;
+	}
+}
+
+unsigned int SpringForceAccumulator::numColors() const
+{
+	return _colorStart.size() - 1;
+}
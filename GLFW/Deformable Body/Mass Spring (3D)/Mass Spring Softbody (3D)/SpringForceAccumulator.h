@@ -0,0 +1,96 @@
+#pragma once
+#include <vector>
+#include <thread>
+
+class SpringBarrier;
+
+// A spring between two point masses, given by their indices
+struct ForceSpring
+{
+	unsigned int i;
+	unsigned int j;
+	float restLength;
+};
+
+// Computes the spring and dampening forces of a mass spring system, visiting every spring once.
+//
+// Gathering the forces point by point evaluates every spring twice, once from each end. Here each spring is
+// evaluated once and its force is added to both of its ends instead. That would be a race if two threads added to
+// the same point mass at once, so the springs are split into colors where no two springs of a color share a point
+// mass. The springs of one color are split across threads, four at a time with SSE, and the colors are done one
+// after another. Every point mass always receives its forces in the same order, so the result does not depend on
+// the number of threads. The worker threads are started once, when the accumulator is made, and wait at the barrier
+// between calls, so a call only costs waking them.
+//
+// The state is kept as separate arrays for each axis so four springs can be loaded into SSE registers at once.
+class SpringForceAccumulator
+{
+public:
+
+	///
+	//Makes an accumulator for a fixed set of point masses and springs, and colors the springs
+	//
+	//Parameters:
+	//	numPoints: The number of point masses
+	//	springs: The springs between them
+	//	numSprings: The number of springs
+	SpringForceAccumulator(unsigned int numPoints, const ForceSpring* springs, unsigned int numSprings);
+	~SpringForceAccumulator();
+
+	///
+	//Overwrites the forces with the spring and dampening forces of the current positions and velocities
+	void Accumulate();
+
+	// The state of each point mass, one array per axis. Fill in the positions and velocities before calling
+	// Accumulate and read the forces out after.
+	std::vector<float> positionX, positionY, positionZ;
+	std::vector<float> velocityX, velocityY, velocityZ;
+	std::vector<float> forceX, forceY, forceZ;
+
+	float coefficient;	//The spring coefficient of every spring
+	float dampening;	//Every spring a point mass is attached to slows it by -dampening * velocity
+
+	// The number of threads each color is split across, 0 to pick from the number of springs and hardware threads.
+	// Changing it restarts the worker threads on the next call to Accumulate.
+	unsigned int numThreads;
+
+	unsigned int numColors() const;
+
+private:
+
+	// The number of threads numThreads asks for
+	unsigned int ThreadCount() const;
+
+	// Stops any worker threads and starts threadCount - 1 new ones. The calling thread is always thread 0.
+	void StartWorkers(unsigned int threadCount);
+
+	// Releases the worker threads to quit and waits for them
+	void StopWorkers();
+
+	// Runs on each worker thread, waiting at the barrier for each call to Accumulate and doing its share of it
+	void Work(unsigned int thread);
+
+	// Does one thread's share of the point masses and of each color
+	void AccumulateThread(unsigned int thread, unsigned int threadCount, SpringBarrier& barrier);
+
+	// Adds the forces of springs first up to last, which must all be in the same color
+	void AccumulateSprings(unsigned int first, unsigned int last);
+
+	unsigned int _numPoints;
+
+	// The springs sorted by color, one array per field. The springs of color c are _colorStart[c] up to
+	// _colorStart[c + 1] - 1.
+	std::vector<unsigned int> _springI;
+	std::vector<unsigned int> _springJ;
+	std::vector<float> _restLengths;
+	std::vector<unsigned int> _colorStart;
+
+	// How many springs each point mass is attached to
+	std::vector<float> _degrees;
+
+	// The worker threads, and the barrier they wait at between calls and between colors
+	std::vector<std::thread> _workers;
+	SpringBarrier* _barrier;
+	unsigned int _threadCount;
+	bool _quit;
+};
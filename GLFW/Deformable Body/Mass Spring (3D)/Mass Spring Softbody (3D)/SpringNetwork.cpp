@@ -0,0 +1,228 @@
+#include "SpringNetwork.h"
+#include "SpringForceAccumulator.h"
+
+#include <algorithm>
+
+// Sorts springs by their point masses, the lower index first, so springs between the same pair end up next to each other
+bool SpringPairLess(const NetworkSpring& a, const NetworkSpring& b)
+{
+	return a.i != b.i ? a.i < b.i : a.j < b.j;
+}
+
+bool SpringPairEqual(const NetworkSpring& a, const NetworkSpring& b)
+{
+	return a.i == b.i && a.j == b.j;
+}
+
+// An edge of a triangle, with the lower index first, and the corner of the triangle across from it
+struct TriangleEdge
+{
+	unsigned int i;
+	unsigned int j;
+	unsigned int opposite;
+
+	bool operator<(const TriangleEdge& other) const
+	{
+		return i != other.i ? i < other.i : j < other.j;
+	}
+};
+
+SpringNetwork::SpringNetwork(unsigned int numPoints, const glm::vec3* restPositions)
+{
+	_numPoints = numPoints;
+	_restPositions.assign(restPositions, restPositions + numPoints);
+
+	coefficient = 0.0f;
+	dampening = 0.0f;
+	numThreads = 0;
+
+	positions.assign(restPositions, restPositions + numPoints);
+	velocities.resize(numPoints, glm::vec3(0.0f));
+	forces.resize(numPoints, glm::vec3(0.0f));
+	inverseMasses.resize(numPoints, 1.0f);
+
+	_neighborStart.assign(numPoints + 1, 0);
+	_accumulator = 0;
+}
+
+SpringNetwork::~SpringNetwork()
+{
+	delete _accumulator;
+}
+
+void SpringNetwork::AddSpring(unsigned int i, unsigned int j)
+{
+	AddSpring(i, j, glm::length(_restPositions[j] - _restPositions[i]));
+}
+
+void SpringNetwork::AddSpring(unsigned int i, unsigned int j, float restLength)
+{
+	NetworkSpring spring = { std::min(i, j), std::max(i, j), restLength };
+	_springs.push_back(spring);
+}
+
+// Every edge is listed once per triangle it is in. After sorting, an edge shared by two triangles shows up twice in
+// a row, and the two corners across from it get a bend spring.
+void SpringNetwork::AddTriangles(const unsigned int* indices, unsigned int numTriangles, bool bendSprings)
+{
+	std::vector<TriangleEdge> edges;
+	for (unsigned int t = 0; t < numTriangles; ++t)
+	{
+		const unsigned int* corners = indices + 3 * t;
+		for (int e = 0; e < 3; ++e)
+		{
+			unsigned int a = corners[e];
+			unsigned int b = corners[(e + 1) % 3];
+			TriangleEdge edge = { std::min(a, b), std::max(a, b), corners[(e + 2) % 3] };
+			edges.push_back(edge);
+
+			AddSpring(a, b);
+		}
+	}
+
+	if (!bendSprings) return;
+
+	std::sort(edges.begin(), edges.end());
+	for (unsigned int e = 0; e + 1 < edges.size(); ++e)
+	{
+		if (edges[e].i == edges[e + 1].i && edges[e].j == edges[e + 1].j && edges[e].opposite != edges[e + 1].opposite)
+		{
+			AddSpring(edges[e].opposite, edges[e + 1].opposite);
+		}
+	}
+}
+
+void SpringNetwork::AddTetrahedra(const unsigned int* indices, unsigned int numTetrahedra)
+{
+	for (unsigned int t = 0; t < numTetrahedra; ++t)
+	{
+		const unsigned int* corners = indices + 4 * t;
+		for (int a = 0; a < 4; ++a)
+		{
+			for (int b = a + 1; b < 4; ++b)
+			{
+				AddSpring(corners[a], corners[b]);
+			}
+		}
+	}
+}
+
+// The adjacency lists are filled with a counting sort: count the springs of each point mass, turn the counts into
+// starting offsets, then place every spring in the lists of both of its point masses.
+void SpringNetwork::Build()
+{
+	std::stable_sort(_springs.begin(), _springs.end(), SpringPairLess);
+	_springs.erase(std::unique(_springs.begin(), _springs.end(), SpringPairEqual), _springs.end());
+
+	_neighborStart.assign(_numPoints + 1, 0);
+	for (unsigned int s = 0; s < _springs.size(); ++s)
+	{
+		++_neighborStart[_springs[s].i + 1];
+		++_neighborStart[_springs[s].j + 1];
+	}
+	for (unsigned int p = 0; p < _numPoints; ++p)
+	{
+		_neighborStart[p + 1] += _neighborStart[p];
+	}
+
+	_neighbors.resize(_neighborStart[_numPoints]);
+	_neighborSprings.resize(_neighborStart[_numPoints]);
+	std::vector<unsigned int> next(_neighborStart.begin(), _neighborStart.end() - 1);
+	for (unsigned int s = 0; s < _springs.size(); ++s)
+	{
+		unsigned int i = _springs[s].i;
+		unsigned int j = _springs[s].j;
+
+		_neighbors[next[i]] = j;
+		_neighborSprings[next[i]++] = s;
+		_neighbors[next[j]] = i;
+		_neighborSprings[next[j]++] = s;
+	}
+
+	std::vector<ForceSpring> springs(_springs.size());
+	for (unsigned int s = 0; s < _springs.size(); ++s)
+	{
+		ForceSpring spring = { _springs[s].i, _springs[s].j, _springs[s].restLength };
+		springs[s] = spring;
+	}
+
+	delete _accumulator;
+	_accumulator = new SpringForceAccumulator(_numPoints, springs.empty() ? 0 : &springs[0], springs.size());
+}
+
+// The accumulator keeps each axis in its own array, so the state is copied in, the springs are worked out over the
+// flat array, and the spring and dampening forces are added onto the forces already there.
+void SpringNetwork::ComputeForces()
+{
+	_accumulator->coefficient = coefficient;
+	_accumulator->dampening = dampening;
+	_accumulator->numThreads = numThreads;
+	for (unsigned int p = 0; p < _numPoints; ++p)
+	{
+		_accumulator->positionX[p] = positions[p].x;
+		_accumulator->positionY[p] = positions[p].y;
+		_accumulator->positionZ[p] = positions[p].z;
+		_accumulator->velocityX[p] = velocities[p].x;
+		_accumulator->velocityY[p] = velocities[p].y;
+		_accumulator->velocityZ[p] = velocities[p].z;
+	}
+
+	_accumulator->Accumulate();
+
+	for (unsigned int p = 0; p < _numPoints; ++p)
+	{
+		forces[p] += glm::vec3(_accumulator->forceX[p], _accumulator->forceY[p], _accumulator->forceZ[p]);
+	}
+}
+
+void SpringNetwork::Integrate(float dt)
+{
+	for (unsigned int p = 0; p < _numPoints; ++p)
+	{
+		if (inverseMasses[p] != 0.0f)
+		{
+			//X = X0 + V0*dt + (1/2) * A * dt^2
+			glm::vec3 acceleration = inverseMasses[p] * forces[p];
+			positions[p] += dt * velocities[p] + (0.5f * dt * dt) * acceleration;
+			velocities[p] += dt * acceleration;
+		}
+
+		forces[p] = glm::vec3(0.0f);
+	}
+}
+
+void SpringNetwork::Step(float dt)
+{
+	ComputeForces();
+	Integrate(dt);
+}
+
+unsigned int SpringNetwork::numPoints() const
+{
+	return _numPoints;
+}
+
+unsigned int SpringNetwork::numSprings() const
+{
+	return _springs.size();
+}
+
+const NetworkSpring* SpringNetwork::springs() const
+{
+	return _springs.empty() ? 0 : &_springs[0];
+}
+
+const unsigned int* SpringNetwork::neighborStart() const
+{
+	return &_neighborStart[0];
+}
+
+const unsigned int* SpringNetwork::neighbors() const
+{
+	return _neighbors.empty() ? 0 : &_neighbors[0];
+}
+
+const unsigned int* SpringNetwork::neighborSprings() const
+{
+	return _neighborSprings.empty() ? 0 : &_neighborSprings[0];
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <vector>
+#include "glm\glm.hpp"
+
+class SpringForceAccumulator;
+
+// A spring between two point masses, given by their indices
+struct NetworkSpring
+{
+	unsigned int i;
+	unsigned int j;
+	float restLength;
+};
+
+// The topology of a mass spring system: which point masses are joined by springs, and how long each spring is at rest.
+//
+// The springs can be added one at a time, or made from the edges of a triangle mesh (a cloth) or a tetrahedral mesh
+// (a solid). A triangle mesh can also get bend springs, between the two corners facing each other across every edge
+// shared by two triangles, which resist folding the cloth along that edge. Springs added twice are only kept once.
+//
+// Once built, the springs are kept as one flat array, which the implicit and XPBD solvers can be made from, and as
+// adjacency lists in compressed sparse row (CSR) form: the springs of point mass p are listed from
+// neighborStart()[p] up to neighborStart()[p + 1] - 1. The explicit step goes over the flat array with a
+// SpringForceAccumulator, which works out every spring once and adds its force to both ends, so it works the same
+// for any topology.
+//
+// This is the one spring network of the 1D, 2D and 3D mass spring examples. The 1D and 2D projects build it from here.
+class SpringNetwork
+{
+public:
+
+	///
+	//Makes a network with no springs
+	//
+	//Parameters:
+	//	numPoints: The number of point masses
+	//	restPositions: Where each point mass is when no spring is stretched, used for the rest lengths
+	SpringNetwork(unsigned int numPoints, const glm::vec3* restPositions);
+	~SpringNetwork();
+
+	///
+	//Adds a spring between point masses i and j, as long as they are apart at rest or with the given rest length
+	void AddSpring(unsigned int i, unsigned int j);
+	void AddSpring(unsigned int i, unsigned int j, float restLength);
+
+	///
+	//Adds a spring along every edge of a triangle mesh
+	//
+	//Parameters:
+	//	indices: Three point masses per triangle
+	//	numTriangles: The number of triangles
+	//	bendSprings: Whether to also add a spring across every edge shared by two triangles
+	void AddTriangles(const unsigned int* indices, unsigned int numTriangles, bool bendSprings);
+
+	///
+	//Adds a spring along every edge of a tetrahedral mesh
+	//
+	//Parameters:
+	//	indices: Four point masses per tetrahedron
+	//	numTetrahedra: The number of tetrahedra
+	void AddTetrahedra(const unsigned int* indices, unsigned int numTetrahedra);
+
+	///
+	//Removes springs which were added more than once, builds the adjacency lists and colors the springs for the
+	//explicit step. Call after adding the springs and before stepping.
+	void Build();
+
+	///
+	//Adds the force of every spring and its dampening to the forces of its point masses, working out each spring once
+	void ComputeForces();
+
+	///
+	//Moves every point mass by its velocity and force with second order Euler integration, then clears the forces.
+	//Point masses with an inverse mass of 0.0f are left where they are.
+	void Integrate(float dt);
+
+	///
+	//Computes the forces, then integrates
+	void Step(float dt);
+
+	// The state of each point mass. Fill in the positions, velocities and any external forces before stepping.
+	std::vector<glm::vec3> positions;
+	std::vector<glm::vec3> velocities;
+	std::vector<glm::vec3> forces;
+	std::vector<float> inverseMasses;
+
+	float coefficient;	//The spring coefficient of every spring
+	float dampening;	//Every spring a point mass is attached to slows it by -dampening * velocity
+
+	// The number of threads the forces are worked out across, 0 to pick from the number of springs and hardware threads
+	unsigned int numThreads;
+
+	unsigned int numPoints() const;
+	unsigned int numSprings() const;
+	const NetworkSpring* springs() const;
+
+	// The adjacency lists. neighbors()[n] is the point mass at the other end of spring neighborSprings()[n].
+	const unsigned int* neighborStart() const;
+	const unsigned int* neighbors() const;
+	const unsigned int* neighborSprings() const;
+
+private:
+
+	unsigned int _numPoints;
+	std::vector<glm::vec3> _restPositions;
+
+	std::vector<NetworkSpring> _springs;
+
+	std::vector<unsigned int> _neighborStart;
+	std::vector<unsigned int> _neighbors;
+	std::vector<unsigned int> _neighborSprings;
+
+	// Made from the flat array of springs by Build
+	SpringForceAccumulator* _accumulator;
+};
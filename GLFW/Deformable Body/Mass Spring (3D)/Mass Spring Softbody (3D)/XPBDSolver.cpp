@@ -0,0 +1,500 @@
+#include "XPBDSolver.h"
+
+#include <float.h>
+#include <math.h>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+
+// Below this many constraints per thread, waking the threads costs more than they save
+#define MIN_CONSTRAINTS_PER_THREAD 2048
+
+// Holds every thread that reaches it until all of them have, so no thread starts on a color before
+// every thread has finished the one before it.
+class XPBDBarrier
+{
+public:
+	XPBDBarrier(unsigned int count)
+	{
+		_count = count;
+		_waiting = 0;
+		_generation = 0;
+	}
+
+	void Wait()
+	{
+		if (_count == 1) return;
+
+		std::unique_lock<std::mutex> lock(_mutex);
+		unsigned int generation = _generation;
+		if (++_waiting == _count)
+		{
+			_waiting = 0;
+			++_generation;
+			_condition.notify_all();
+		}
+		else
+		{
+			_condition.wait(lock, [this, generation] { return generation != _generation; });
+		}
+	}
+
+private:
+	std::mutex _mutex;
+	std::condition_variable _condition;
+	unsigned int _count;
+	unsigned int _waiting;
+	unsigned int _generation;
+};
+
+// Splits count items starting at first into threadCount nearly equal blocks and gives the block for thread
+void Share(unsigned int first, unsigned int count, unsigned int thread, unsigned int threadCount, unsigned int& begin, unsigned int& end)
+{
+	begin = first + (unsigned int)((unsigned long long)count * thread / threadCount);
+	end = first + (unsigned int)((unsigned long long)count * (thread + 1) / threadCount);
+}
+
+// Colors are handed out greedily: each constraint takes the lowest color neither of its point masses has
+// been given yet. A point mass with n constraints ends up in at most n colors, so a lattice needs only a few.
+XPBDSolver::XPBDSolver(unsigned int numPoints, const XPBDConstraint* constraints, unsigned int numConstraints)
+{
+	_numPoints = numPoints;
+
+	compliance = 0.0f;
+	dampening = 0.0f;
+	substeps = 4;
+	iterations = 2;
+	numThreads = 0;
+
+	positions.resize(numPoints, glm::vec3(0.0f));
+	velocities.resize(numPoints, glm::vec3(0.0f));
+	externalForces.resize(numPoints, glm::vec3(0.0f));
+	inverseMasses.resize(numPoints, 1.0f);
+	_previous.resize(numPoints);
+	_degrees.resize(numPoints, 0.0f);
+
+	std::vector<std::vector<unsigned int> > pointColors(numPoints);
+	std::vector<unsigned int> colors(numConstraints);
+	unsigned int colorCount = 0;
+	for (unsigned int c = 0; c < numConstraints; ++c)
+	{
+		const std::vector<unsigned int>& usedI = pointColors[constraints[c].i];
+		const std::vector<unsigned int>& usedJ = pointColors[constraints[c].j];
+
+		unsigned int color = 0;
+		while (std::find(usedI.begin(), usedI.end(), color) != usedI.end() || std::find(usedJ.begin(), usedJ.end(), color) != usedJ.end())
+		{
+			++color;
+		}
+
+		colors[c] = color;
+		pointColors[constraints[c].i].push_back(color);
+		pointColors[constraints[c].j].push_back(color);
+		if (color + 1 > colorCount) colorCount = color + 1;
+
+		_degrees[constraints[c].i] += 1.0f;
+		_degrees[constraints[c].j] += 1.0f;
+	}
+
+	// Counting sort by color
+	_colorStart.assign(colorCount + 1, 0);
+	for (unsigned int c = 0; c < numConstraints; ++c)
+	{
+		++_colorStart[colors[c] + 1];
+	}
+	for (unsigned int color = 0; color < colorCount; ++color)
+	{
+		_colorStart[color + 1] += _colorStart[color];
+	}
+
+	_constraints.resize(numConstraints);
+	std::vector<unsigned int> next(_colorStart.begin(), _colorStart.end() - 1);
+	for (unsigned int c = 0; c < numConstraints; ++c)
+	{
+		_constraints[next[colors[c]]++] = constraints[c];
+	}
+
+	_lambdas.resize(numConstraints, 0.0f);
+
+	_thickness = 0.0f;
+
+	_barrier = 0;
+	_threadCount = 0;
+	_dt = 0.0f;
+	_quit = false;
+	StartWorkers(ThreadCount());
+}
+
+XPBDSolver::~XPBDSolver()
+{
+	StopWorkers();
+}
+
+// The calling thread takes the first share itself. Every thread waits at the barrier once more after its share,
+// so the step only returns once the workers are done with the positions and velocities.
+void XPBDSolver::Step(float dt)
+{
+	unsigned int threadCount = ThreadCount();
+	if (threadCount != _threadCount) StartWorkers(threadCount);
+
+	_dt = dt;
+	_barrier->Wait();
+	StepThread(dt, 0, _threadCount, *_barrier);
+	_barrier->Wait();
+
+	for (unsigned int p = 0; p < _numPoints; ++p)
+	{
+		externalForces[p] = glm::vec3(0.0f);
+	}
+}
+
+unsigned int XPBDSolver::ThreadCount() const
+{
+	unsigned int threadCount = numThreads;
+	if (threadCount == 0)
+	{
+		threadCount = std::min(std::thread::hardware_concurrency(), (unsigned int)_constraints.size() / MIN_CONSTRAINTS_PER_THREAD);
+	}
+	if (threadCount == 0) threadCount = 1;
+	return threadCount;
+}
+
+void XPBDSolver::StartWorkers(unsigned int threadCount)
+{
+	StopWorkers();
+
+	_barrier = new XPBDBarrier(threadCount);
+	_threadCount = threadCount;
+	_quit = false;
+	for (unsigned int t = 1; t < threadCount; ++t)
+	{
+		_workers.push_back(std::thread(&XPBDSolver::Work, this, t));
+	}
+}
+
+// The workers are all waiting at the barrier, so passing it with _quit set lets every one of them return
+void XPBDSolver::StopWorkers()
+{
+	if (_barrier == 0) return;
+
+	_quit = true;
+	_barrier->Wait();
+	for (unsigned int t = 0; t < _workers.size(); ++t)
+	{
+		_workers[t].join();
+	}
+	_workers.clear();
+
+	delete _barrier;
+	_barrier = 0;
+	_threadCount = 0;
+}
+
+void XPBDSolver::Work(unsigned int thread)
+{
+	for (;;)
+	{
+		_barrier->Wait();
+		if (_quit) return;
+		StepThread(_dt, thread, _threadCount, *_barrier);
+		_barrier->Wait();
+	}
+}
+
+// For a constraint C = |xj - xi| - L with direction n from i to j, one XPBD iteration changes its multiplier by
+//
+//		dLambda = (-C - alpha * lambda) / (wi + wj + alpha),	alpha = compliance / h^2
+//
+// and moves each point mass along the constraint gradient by its inverse mass times dLambda. With zero compliance
+// this is the plain position based dynamics projection.
+void XPBDSolver::StepThread(float dt, unsigned int thread, unsigned int threadCount, XPBDBarrier& barrier)
+{
+	float h = dt / substeps;
+	float alpha = compliance / (h * h);
+
+	unsigned int pointBegin, pointEnd;
+	Share(0, _numPoints, thread, threadCount, pointBegin, pointEnd);
+	unsigned int lambdaBegin, lambdaEnd;
+	Share(0, _constraints.size(), thread, threadCount, lambdaBegin, lambdaEnd);
+
+	for (int substep = 0; substep < substeps; ++substep)
+	{
+		// Move every point mass freely by its velocity and the external forces
+		for (unsigned int p = pointBegin; p < pointEnd; ++p)
+		{
+			_previous[p] = positions[p];
+			if (inverseMasses[p] == 0.0f) continue;
+
+			velocities[p] += h * inverseMasses[p] * externalForces[p];
+			positions[p] += h * velocities[p];
+		}
+		for (unsigned int c = lambdaBegin; c < lambdaEnd; ++c)
+		{
+			_lambdas[c] = 0.0f;
+		}
+		barrier.Wait();
+
+		// Pull the point masses back together
+		for (int iteration = 0; iteration < iterations; ++iteration)
+		{
+			for (unsigned int color = 0; color + 1 < _colorStart.size(); ++color)
+			{
+				unsigned int begin, end;
+				Share(_colorStart[color], _colorStart[color + 1] - _colorStart[color], thread, threadCount, begin, end);
+				for (unsigned int c = begin; c < end; ++c)
+				{
+					unsigned int i = _constraints[c].i;
+					unsigned int j = _constraints[c].j;
+					float wi = inverseMasses[i];
+					float wj = inverseMasses[j];
+					if (wi + wj == 0.0f) continue;
+
+					glm::vec3 displacement = positions[j] - positions[i];
+					float length = glm::length(displacement);
+					if (length <= FLT_EPSILON) continue;
+					glm::vec3 direction = displacement / length;
+
+					float C = length - _constraints[c].restLength;
+					float dLambda = (-C - alpha * _lambdas[c]) / (wi + wj + alpha);
+					_lambdas[c] += dLambda;
+
+					positions[i] -= (wi * dLambda) * direction;
+					positions[j] += (wj * dLambda) * direction;
+				}
+				barrier.Wait();
+			}
+		}
+
+		if (_thickness > 0.0f)
+		{
+			barrier.Wait();
+			CollideThread(thread, threadCount, barrier);
+		}
+
+		// The velocity is however far the point mass moved this substep. The dampening is applied implicitly,
+		// v / (1 + h * c * w), so it can never reverse the velocity no matter how large it is.
+		for (unsigned int p = pointBegin; p < pointEnd; ++p)
+		{
+			if (inverseMasses[p] == 0.0f) continue;
+
+			velocities[p] = (positions[p] - _previous[p]) / h;
+			velocities[p] /= 1.0f + h * dampening * _degrees[p] * inverseMasses[p];
+		}
+	}
+}
+
+unsigned int XPBDSolver::numColors() const
+{
+	return _colorStart.size() - 1;
+}
+
+// The point masses each point mass never collides with are found by a breadth first search through the constraints
+// from every point mass, going exclusionDepth constraints deep. In a lattice of springs along each axis that skips
+// every point mass within exclusionDepth steps along the lattice.
+void XPBDSolver::SetSelfCollision(float thickness, int exclusionDepth)
+{
+	_thickness = thickness;
+	if (thickness <= 0.0f) return;
+
+	// The constraints each point mass is part of, as a list of neighbors per point mass
+	std::vector<unsigned int> neighborStart(_numPoints + 1, 0);
+	for (unsigned int c = 0; c < _constraints.size(); ++c)
+	{
+		++neighborStart[_constraints[c].i + 1];
+		++neighborStart[_constraints[c].j + 1];
+	}
+	for (unsigned int p = 0; p < _numPoints; ++p)
+	{
+		neighborStart[p + 1] += neighborStart[p];
+	}
+	std::vector<unsigned int> neighbors(neighborStart[_numPoints]);
+	std::vector<unsigned int> next(neighborStart.begin(), neighborStart.end() - 1);
+	for (unsigned int c = 0; c < _constraints.size(); ++c)
+	{
+		neighbors[next[_constraints[c].i]++] = _constraints[c].j;
+		neighbors[next[_constraints[c].j]++] = _constraints[c].i;
+	}
+
+	// depths[q] is how many constraints q is from the point mass being searched from, -1 if not reached yet
+	std::vector<int> depths(_numPoints, -1);
+	std::vector<unsigned int> reached;
+	_excludedStart.assign(1, 0);
+	_excluded.clear();
+	for (unsigned int p = 0; p < _numPoints; ++p)
+	{
+		reached.assign(1, p);
+		depths[p] = 0;
+		for (unsigned int r = 0; r < reached.size(); ++r)
+		{
+			unsigned int q = reached[r];
+			if (depths[q] == exclusionDepth) continue;
+			for (unsigned int n = neighborStart[q]; n < neighborStart[q + 1]; ++n)
+			{
+				if (depths[neighbors[n]] != -1) continue;
+				depths[neighbors[n]] = depths[q] + 1;
+				reached.push_back(neighbors[n]);
+			}
+		}
+
+		for (unsigned int r = 0; r < reached.size(); ++r)
+		{
+			depths[reached[r]] = -1;
+		}
+		std::sort(reached.begin() + 1, reached.end());
+		_excluded.insert(_excluded.end(), reached.begin() + 1, reached.end());
+		_excludedStart.push_back(_excluded.size());
+	}
+
+	// At least twice as many buckets as point masses keeps most buckets to a single cell. A power of two lets the
+	// hash be cut down to a bucket with a mask instead of a division.
+	unsigned int numBuckets = 1;
+	while (numBuckets < 2 * _numPoints) numBuckets *= 2;
+	_pointBuckets.resize(_numPoints);
+	_bucketStart.resize(numBuckets + 1);
+	_sortedPoints.resize(_numPoints);
+	_sortedPositions.resize(_numPoints);
+	_corrections.resize(_numPoints);
+}
+
+float XPBDSolver::selfCollisionThickness() const
+{
+	return _thickness;
+}
+
+// Cells are hashed by multiplying y and z by large primes, as in Teschner et al., but x is added as it is, so cells
+// next to each other along x land in buckets next to each other. Going through the point masses in bucket order
+// then mostly finds their neighbors already in the cache. Different cells can land in the same bucket, which only
+// costs a few extra distance checks.
+unsigned int XPBDSolver::Bucket(int x, int y, int z) const
+{
+	unsigned int hash = (unsigned int)x + (unsigned int)y * 73856093u + (unsigned int)z * 19349663u;
+	return hash & (_bucketStart.size() - 2);
+}
+
+// A point mass with nothing excluded is checked first, since _excluded is empty when no point mass has anything
+// excluded and indexing it then is undefined
+bool XPBDSolver::Excluded(unsigned int i, unsigned int j) const
+{
+	if (_excludedStart[i] == _excludedStart[i + 1]) return false;
+
+	const unsigned int* begin = &_excluded[0] + _excludedStart[i];
+	const unsigned int* end = &_excluded[0] + _excludedStart[i + 1];
+	return std::binary_search(begin, end, j);
+}
+
+// Two point masses i and j closer than the thickness d are pushed apart along the line between them until they are
+// d apart, i by wi / (wi + wj) of the overlap and j by the rest, so pinned point masses never move. A point mass
+// close to several others gets the average of their pushes rather than the sum, so crowded point masses are not
+// pushed too far (they are pushed apart further every substep until they settle).
+//
+// The cells are twice as wide as the thickness, so everything close enough to a point mass is in one of the eight
+// cells around the corner of its cell nearest to it (fewer when it is far from every corner).
+void XPBDSolver::CollideThread(unsigned int thread, unsigned int threadCount, XPBDBarrier& barrier)
+{
+	float cellSize = 2.0f * _thickness;
+	float thicknessSquared = _thickness * _thickness;
+	unsigned int numBuckets = _bucketStart.size() - 1;
+
+	unsigned int pointBegin, pointEnd;
+	Share(0, _numPoints, thread, threadCount, pointBegin, pointEnd);
+	for (unsigned int p = pointBegin; p < pointEnd; ++p)
+	{
+		_pointBuckets[p] = Bucket((int)floorf(positions[p].x / cellSize), (int)floorf(positions[p].y / cellSize), (int)floorf(positions[p].z / cellSize));
+	}
+	barrier.Wait();
+
+	// Counting sort by bucket. It is a single pass over the point masses, which is short next to the distance checks.
+	if (thread == 0)
+	{
+		std::fill(_bucketStart.begin(), _bucketStart.end(), 0);
+		for (unsigned int p = 0; p < _numPoints; ++p)
+		{
+			++_bucketStart[_pointBuckets[p] + 1];
+		}
+		for (unsigned int b = 0; b < numBuckets; ++b)
+		{
+			_bucketStart[b + 1] += _bucketStart[b];
+		}
+		for (unsigned int p = 0; p < _numPoints; ++p)
+		{
+			_sortedPoints[_bucketStart[_pointBuckets[p]]++] = p;
+		}
+		// Filling moved every start up to the next bucket's, so shift them back
+		for (unsigned int b = numBuckets; b > 0; --b)
+		{
+			_bucketStart[b] = _bucketStart[b - 1];
+		}
+		_bucketStart[0] = 0;
+	}
+	barrier.Wait();
+
+	// Copy the positions and inverse masses out in bucket order, so the point masses of a bucket are read from one
+	// place instead of from all over the arrays
+	unsigned int sortedBegin, sortedEnd;
+	Share(0, _numPoints, thread, threadCount, sortedBegin, sortedEnd);
+	for (unsigned int s = sortedBegin; s < sortedEnd; ++s)
+	{
+		unsigned int p = _sortedPoints[s];
+		_sortedPositions[s] = glm::vec4(positions[p], inverseMasses[p]);
+	}
+	barrier.Wait();
+
+	// Each thread takes a share of the buckets, as a share of the sorted point masses, and only ever writes the
+	// corrections of point masses in its own buckets.
+	for (unsigned int s = sortedBegin; s < sortedEnd; ++s)
+	{
+		unsigned int i = _sortedPoints[s];
+		_corrections[i] = glm::vec3(0.0f);
+		float wi = _sortedPositions[s].w;
+		if (wi == 0.0f) continue;
+
+		glm::vec3 position(_sortedPositions[s]);
+		glm::ivec3 low((int)floorf((position.x - _thickness) / cellSize), (int)floorf((position.y - _thickness) / cellSize), (int)floorf((position.z - _thickness) / cellSize));
+		glm::ivec3 high((int)floorf((position.x + _thickness) / cellSize), (int)floorf((position.y + _thickness) / cellSize), (int)floorf((position.z + _thickness) / cellSize));
+
+		// Neighboring cells can share a bucket, which must only be searched once
+		unsigned int buckets[8];
+		int numNeighborBuckets = 0;
+		for (int x = low.x; x <= high.x; ++x)
+		{
+			for (int y = low.y; y <= high.y; ++y)
+			{
+				for (int z = low.z; z <= high.z; ++z)
+				{
+					unsigned int bucket = Bucket(x, y, z);
+					if (std::find(buckets, buckets + numNeighborBuckets, bucket) == buckets + numNeighborBuckets)
+					{
+						buckets[numNeighborBuckets++] = bucket;
+					}
+				}
+			}
+		}
+
+		glm::vec3 correction(0.0f);
+		int contacts = 0;
+		for (int b = 0; b < numNeighborBuckets; ++b)
+		{
+			for (unsigned int n = _bucketStart[buckets[b]]; n < _bucketStart[buckets[b] + 1]; ++n)
+			{
+				if (n == s) continue;
+
+				glm::vec3 displacement = position - glm::vec3(_sortedPositions[n]);
+				float distanceSquared = glm::dot(displacement, displacement);
+				if (distanceSquared >= thicknessSquared || distanceSquared <= FLT_EPSILON) continue;
+				if (Excluded(i, _sortedPoints[n])) continue;
+
+				float distance = sqrtf(distanceSquared);
+				float share = wi / (wi + _sortedPositions[n].w);
+				correction += (share * (_thickness - distance) / distance) * displacement;
+				++contacts;
+			}
+		}
+		if (contacts > 0) _corrections[i] = correction / (float)contacts;
+	}
+	barrier.Wait();
+
+	for (unsigned int p = pointBegin; p < pointEnd; ++p)
+	{
+		positions[p] += _corrections[p];
+	}
+}
@@ -30,6 +30,12 @@ Each physics timestep the mass spring system is solved to determine the force on
 individual point mass in the system. This is done using Hooke's law. The springs also contain 
 dampening forces to help relax the system upon purterbation.
 
+Rather than have every point mass gather the forces of its springs, which works out every spring twice,
+each spring is worked out once and its force is added to both of its ends (see SpringForceAccumulator). The springs
+are split into colors where no two springs share a point mass, so the springs of a color can be worked out four at
+a time with SSE and split across threads without two of them ever adding to the same point mass at once. The forces
+come out the same no matter how many threads are used.
+
 The user can apply forces to the bottom edge of the cloth.
 Hold the left mouse button to apply a force along the positive X axis.
 Hold the right mouse button to apply a force along the negative X axis.
@@ -37,6 +43,31 @@ Hold Left shift to switch the axis to the Y axis.
 Press the up arrow to increase the rigidness of the structure.
 Press the down arrow to decrease the rigidness of the structure.
 
+The springs can also be integrated implicitly (backward Euler). Instead of moving each point mass by the forces
+at the start of the step, the implicit step solves for the velocities whose forces at the end of the step agree
+with them, which is a sparse linear system solved with a preconditioned conjugate gradient (see ImplicitSpringSolver).
+It stays stable with a full 60 Hz timestep and far stiffer springs than the explicit step can handle.
+
+The springs can also be stepped with extended position based dynamics (XPBD, see XPBDSolver), which turns each
+spring into a distance constraint and pulls the point masses back to satisfy the constraints directly every substep.
+The constraints are colored so that no two of one color share a point mass, and each color is solved across threads.
+Its cost per step is set by the substeps and iterations alone, however stiff the springs are.
+
+With XPBD the softbody can also be kept from passing through itself (self collision), which pushes apart any two
+point masses closer than the spacing of the lattice unless they are within two springs of each other.
+
+The springs themselves are kept in a spring network (see SpringNetwork), which every integration mode is built from,
+and which does the whole explicit step, the forces and the integration, the same way as in the 1D and 2D demos.
+Press B to swap the lattice for a tetrahedral mesh of it, which adds springs across the faces and through the middle
+of every cell.
+
+Press I to cycle between explicit, implicit and XPBD integration.
+Press Page Up and Page Down to double or halve the spring coefficient.
+Press the Left and Right arrow keys to change the number of XPBD iterations.
+Press Minus and Equals to change the number of XPBD substeps.
+Press C to turn XPBD self collision on or off.
+Press B to switch between lattice and tetrahedral springs.
+
 References:
 Game Physics by David Eberly
 NGenVS by Nicholas Gallagher
@@ -45,6 +76,9 @@ Base by Srinivasan Thiagarajan
 */
 
 #include "GLIncludes.h"
+#include "ImplicitSpringSolver.h"
+#include "XPBDSolver.h"
+#include "SpringNetwork.h"
 
 // Global data members
 #pragma region Base_data
@@ -319,6 +353,27 @@ double timebase = 0.0;
 double accumulator = 0.0;
 double physicsStep = 0.012; // This is the number of milliseconds we intend for the physics to update.
 
+//Explicit integration needs a short timestep to stay stable, implicit integration and XPBD can take a whole frame at 60 Hz
+const double explicitStep = 0.012;
+const double implicitStep = 1.0 / 60.0;
+const double xpbdStep = 1.0 / 60.0;
+
+enum IntegrationMode
+{
+	Explicit_Euler,
+	Implicit_Euler,
+	Extended_Position_Based
+};
+const char* integrationNames[] = { "Explicit", "Implicit", "XPBD" };
+IntegrationMode integration = Explicit_Euler;
+
+//The springs of the softbody, shared by every integration mode
+SpringNetwork* network;
+bool extraSprings = false;
+
+ImplicitSpringSolver* solver;
+XPBDSolver* xpbd;
+
 #pragma endregion Base_data								  
 
 // Functions called only once every time the program is executed.
@@ -411,27 +466,290 @@ void init()
 #pragma endregion Helper_functions
 
 ///
-//Performs second order euler integration for linear motion
+//Creates the spring network of the softbody.
+//Point mass (i, j, k) is index (i * subdivisionsY + j) * subdivisionsX + k, the same as its vertex in the mesh.
+//Normally each point mass has a spring to its neighbors along each axis of the lattice. With extra springs, each cell
+//of the lattice is cut into six tetrahedra which all share the diagonal from its lowest to its highest corner, and the
+//network is made from the tetrahedra instead. That adds a spring across one diagonal of every face and across the
+//cell, which keep the cells from shearing flat.
+void BuildSpringNetwork()
+{
+	std::vector<glm::vec3> restPositions;
+	for(int i = 0; i < body->subdivisionsZ; ++i)
+	{
+		for(int j = 0; j < body->subdivisionsY; ++j)
+		{
+			for(int k = 0; k < body->subdivisionsX; ++k)
+			{
+				restPositions.push_back(glm::vec3(body->restWidth * k, body->restHeight * j, body->restDepth * i));
+			}
+		}
+	}
+
+	network = new SpringNetwork(restPositions.size(), &restPositions[0]);
+
+	unsigned int stepX = 1;
+	unsigned int stepY = body->subdivisionsX;
+	unsigned int stepZ = body->subdivisionsX * body->subdivisionsY;
+
+	if(extraSprings)
+	{
+		//Each tetrahedron goes from the lowest corner to the highest one by stepping along the axes in a different order
+		unsigned int orders[6][3] = {
+			{ stepX, stepY, stepZ }, { stepX, stepZ, stepY }, { stepY, stepX, stepZ },
+			{ stepY, stepZ, stepX }, { stepZ, stepX, stepY }, { stepZ, stepY, stepX }
+		};
+
+		std::vector<unsigned int> tetrahedra;
+		for(int i = 0; i < body->subdivisionsZ - 1; ++i)
+		{
+			for(int j = 0; j < body->subdivisionsY - 1; ++j)
+			{
+				for(int k = 0; k < body->subdivisionsX - 1; ++k)
+				{
+					unsigned int index = (i * body->subdivisionsY + j) * body->subdivisionsX + k;
+					for(int t = 0; t < 6; ++t)
+					{
+						unsigned int corners[4] = {
+							index,
+							index + orders[t][0],
+							index + orders[t][0] + orders[t][1],
+							index + stepX + stepY + stepZ
+						};
+						tetrahedra.insert(tetrahedra.end(), corners, corners + 4);
+					}
+				}
+			}
+		}
+		network->AddTetrahedra(&tetrahedra[0], tetrahedra.size() / 4);
+	}
+	else
+	{
+		for(int i = 0; i < body->subdivisionsZ; ++i)
+		{
+			for(int j = 0; j < body->subdivisionsY; ++j)
+			{
+				for(int k = 0; k < body->subdivisionsX; ++k)
+				{
+					unsigned int index = (i * body->subdivisionsY + j) * body->subdivisionsX + k;
+					if(k < body->subdivisionsX - 1)
+						network->AddSpring(index, index + stepX);
+					if(j < body->subdivisionsY - 1)
+						network->AddSpring(index, index + stepY);
+					if(i < body->subdivisionsZ - 1)
+						network->AddSpring(index, index + stepZ);
+				}
+			}
+		}
+	}
+
+	network->Build();
+}
+
+///
+//Creates the implicit solver with a spring for each spring of the network
+void BuildImplicitSolver()
+{
+	std::vector<ImplicitSpring> springs;
+	for(unsigned int s = 0; s < network->numSprings(); ++s)
+	{
+		ImplicitSpring spring = { network->springs()[s].i, network->springs()[s].j, network->springs()[s].restLength };
+		springs.push_back(spring);
+	}
+
+	solver = new ImplicitSpringSolver(network->numPoints(), &springs[0], springs.size());
+}
+
+///
+//Creates the XPBD solver with a constraint for each spring of the network
+void BuildXPBDSolver()
+{
+	std::vector<XPBDConstraint> constraints;
+	for(unsigned int s = 0; s < network->numSprings(); ++s)
+	{
+		XPBDConstraint constraint = { network->springs()[s].i, network->springs()[s].j, network->springs()[s].restLength };
+		constraints.push_back(constraint);
+	}
+
+	xpbd = new XPBDSolver(network->numPoints(), &constraints[0], constraints.size());
+}
+
+///
+//Swaps the springs of the softbody between the lattice and the tetrahedra, rebuilding every solver from the new
+//network. The XPBD settings carry over.
+void RebuildSprings()
+{
+	int iterations = xpbd->iterations;
+	int substeps = xpbd->substeps;
+	float thickness = xpbd->selfCollisionThickness();
+
+	delete network;
+	delete solver;
+	delete xpbd;
+
+	extraSprings = !extraSprings;
+	BuildSpringNetwork();
+	BuildImplicitSolver();
+	BuildXPBDSolver();
+
+	xpbd->iterations = iterations;
+	xpbd->substeps = substeps;
+	if(thickness > 0.0f)
+		xpbd->SetSelfCollision(thickness, 2);
+}
+
+///
+//Performs one implicit step of the whole softbody. The rigidbodies are copied into the solver and back,
+//so the integration can be switched at any time.
 //
 //Parameters:
 //	dt: The timestep
-//	body: The rigidbody being integrated
-void IntegrateLinear(float dt, RigidBody &body)
+//	gravity: The force of gravity on every rigidbody
+//	externalForce: The force applied to the bottom layer
+void UpdateImplicit(float dt, const glm::vec3& gravity, const glm::vec3& externalForce)
 {
-	//Calculate the current acceleration
-	body.acceleration = body.inverseMass * body.netForce;
+	solver->coefficient = body->coefficient;
+	solver->dampening = body->dampening;
 
-	//Calculate new position with
-	//	X = X0 + V0*dt + (1/2) * A * dt^2
-	glm::vec3 v0dT = dt * body.velocity;						//Solve for the first degree term
-	glm::vec3 aT2 = (0.5f) * body.acceleration * powf(dt, 2);	//Solve for the second degree term
-	body.position += v0dT + aT2;								//Take sum
+	for(int i = 0; i < body->subdivisionsZ; ++i)
+	{
+		for(int j = 0; j < body->subdivisionsY; ++j)
+		{
+			for(int k = 0; k < body->subdivisionsX; ++k)
+			{
+				int index = (i * body->subdivisionsY + j) * body->subdivisionsX + k;
+				solver->positions[index] = body->bodies[i][j][k].position;
+				solver->velocities[index] = body->bodies[i][j][k].velocity;
+				solver->inverseMasses[index] = body->bodies[i][j][k].inverseMass;
+				solver->externalForces[index] = j == 0 ? gravity + externalForce : gravity;
+
+				//The top layer is pinned in place
+				if(j == body->subdivisionsY - 1)
+					solver->inverseMasses[index] = 0.0f;
+			}
+		}
+	}
 
-	//determine the new velocity
-	body.velocity += dt * body.acceleration + body.inverseMass * body.netImpulse;
+	solver->Step(dt);
+
+	for(int i = 0; i < body->subdivisionsZ; ++i)
+	{
+		for(int j = 0; j < body->subdivisionsY; ++j)
+		{
+			for(int k = 0; k < body->subdivisionsX; ++k)
+			{
+				int index = (i * body->subdivisionsY + j) * body->subdivisionsX + k;
+				body->bodies[i][j][k].position = solver->positions[index];
+				body->bodies[i][j][k].velocity = solver->velocities[index];
 
-	//Zero the net impulse and net force!
-	body.netForce = body.netImpulse = glm::vec3(0.0f);
+				lattice->vertices[index].x = body->bodies[i][j][k].position.x;
+				lattice->vertices[index].y = body->bodies[i][j][k].position.y;
+				lattice->vertices[index].z = body->bodies[i][j][k].position.z;
+			}
+		}
+	}
+}
+
+///
+//Performs one XPBD step of the whole softbody, copying the rigidbodies in and out the same way as UpdateImplicit
+//
+//Parameters:
+//	dt: The timestep
+//	gravity: The force of gravity on every rigidbody
+//	externalForce: The force applied to the bottom layer
+void UpdateXPBD(float dt, const glm::vec3& gravity, const glm::vec3& externalForce)
+{
+	xpbd->compliance = 1.0f / body->coefficient;
+	xpbd->dampening = body->dampening;
+
+	for(int i = 0; i < body->subdivisionsZ; ++i)
+	{
+		for(int j = 0; j < body->subdivisionsY; ++j)
+		{
+			for(int k = 0; k < body->subdivisionsX; ++k)
+			{
+				int index = (i * body->subdivisionsY + j) * body->subdivisionsX + k;
+				xpbd->positions[index] = body->bodies[i][j][k].position;
+				xpbd->velocities[index] = body->bodies[i][j][k].velocity;
+				xpbd->inverseMasses[index] = body->bodies[i][j][k].inverseMass;
+				xpbd->externalForces[index] = j == 0 ? gravity + externalForce : gravity;
+
+				//The top layer is pinned in place
+				if(j == body->subdivisionsY - 1)
+					xpbd->inverseMasses[index] = 0.0f;
+			}
+		}
+	}
+
+	xpbd->Step(dt);
+
+	for(int i = 0; i < body->subdivisionsZ; ++i)
+	{
+		for(int j = 0; j < body->subdivisionsY; ++j)
+		{
+			for(int k = 0; k < body->subdivisionsX; ++k)
+			{
+				int index = (i * body->subdivisionsY + j) * body->subdivisionsX + k;
+				body->bodies[i][j][k].position = xpbd->positions[index];
+				body->bodies[i][j][k].velocity = xpbd->velocities[index];
+
+				lattice->vertices[index].x = body->bodies[i][j][k].position.x;
+				lattice->vertices[index].y = body->bodies[i][j][k].position.y;
+				lattice->vertices[index].z = body->bodies[i][j][k].position.z;
+			}
+		}
+	}
+}
+
+///
+//Performs one explicit step of the whole softbody, copying the rigidbodies in and out the same way as UpdateImplicit.
+//The network works out the force of every spring once and integrates them.
+//
+//Parameters:
+//	dt: The timestep
+//	gravity: The force of gravity on every rigidbody
+//	externalForce: The force applied to the bottom layer
+void UpdateExplicit(float dt, const glm::vec3& gravity, const glm::vec3& externalForce)
+{
+	network->coefficient = body->coefficient;
+	network->dampening = body->dampening;
+	for(int i = 0; i < body->subdivisionsZ; ++i)
+	{
+		for(int j = 0; j < body->subdivisionsY; ++j)
+		{
+			for(int k = 0; k < body->subdivisionsX; ++k)
+			{
+				int index = (i * body->subdivisionsY + j) * body->subdivisionsX + k;
+				network->positions[index] = body->bodies[i][j][k].position;
+				network->velocities[index] = body->bodies[i][j][k].velocity;
+				network->inverseMasses[index] = body->bodies[i][j][k].inverseMass;
+				network->forces[index] = j == 0 ? gravity + externalForce : gravity;
+
+				//The top layer is pinned in place
+				if(j == body->subdivisionsY - 1)
+					network->inverseMasses[index] = 0.0f;
+			}
+		}
+	}
+
+	network->Step(dt);
+
+	for(int i = 0; i < body->subdivisionsZ; ++i)
+	{
+		for(int j = 0; j < body->subdivisionsY; ++j)
+		{
+			for(int k = 0; k < body->subdivisionsX; ++k)
+			{
+				int index = (i * body->subdivisionsY + j) * body->subdivisionsX + k;
+				body->bodies[i][j][k].position = network->positions[index];
+				body->bodies[i][j][k].velocity = network->velocities[index];
+
+				lattice->vertices[index].x = body->bodies[i][j][k].position.x;
+				lattice->vertices[index].y = body->bodies[i][j][k].position.y;
+				lattice->vertices[index].z = body->bodies[i][j][k].position.z;
+			}
+		}
+	}
 }
 
 // This runs once every physics timestep.
@@ -469,166 +787,18 @@ void update(float dt)
 		}
 	}
 
-	glm::vec3 displacement;	//The displacement between nodes
-	glm::vec3 direction;	//The direction of the displacement
-	float mag;				//The magnitude of the dispplacement
-
-	//Apply forces to each rigidbody making up the softbody
-	for(int i = 0; i < body->subdivisionsZ; ++i)
+	if(integration == Implicit_Euler)
 	{
-		for(int j = 0; j < body->subdivisionsY; ++j)
-		{
-
-			for(int k = 0; k < body->subdivisionsX; ++k)
-			{
-				glm::vec3 neighborForce(0.0f);
-
-				//If there is a rigidbody behind this one, calculate teh spring force between this rigidbody and the rigidbody behind
-				if(i > 0)
-				{
-					displacement = body->bodies[i - 1][j][k].position - body->bodies[i][j][k].position;
-					mag = glm::length(displacement);
-					if(mag > FLT_EPSILON)
-					{
-						direction = glm::normalize(displacement);
-					}
-					else
-					{
-						direction = glm::vec3(0.0f);
-						mag = 0.0f;
-					}
-					neighborForce += body->coefficient * (mag - body->restDepth) * direction - body->bodies[i][j][k].velocity * body->dampening;
-				}
-
-				//If there is a rigidbody in front of this one, calculate the spring force between this rigidbody and the rigidbody in front
-				if(i < body->subdivisionsZ - 1)
-				{
-					displacement = body->bodies[i + 1][j][k].position - body->bodies[i][j][k].position;
-					mag = glm::length(displacement);
-					if(mag > FLT_EPSILON)
-					{
-						direction = glm::normalize(displacement);
-					}
-					else
-					{
-						direction = glm::vec3(0.0f);
-						mag = 0.0f;
-					}
-					neighborForce += body->coefficient * (mag - body->restDepth) * direction - body->bodies[i][j][k].velocity * body->dampening;
-				}
-
-				//If there is a rigidbody above this one, calculate the spring force between this rigidbody and the rigidbody above
-				if(j > 0)
-				{
-					//Get displacement from rigidBody[i-1] to rigidBody[i]
-					displacement = body->bodies[i][j - 1][k].position - body->bodies[i][j][k].position;
-					//Extract the direction and the magnitude from this displacement
-					mag = glm::length(displacement);
-					if(mag > FLT_EPSILON)
-					{
-						direction = glm::normalize(displacement);
-					}
-					else
-					{
-						direction = glm::vec3(0.0f);
-						mag = 0.0f;
-					}
-
-					//Calculate and Add the applied force according the Hooke's law
-					//Fspring = -k(dX)
-					//And from that we must add the dampening force:
-					//Fdamp = -V * C 
-					//Where C is the dampening constant
-					neighborForce += body->coefficient * (mag - body->restHeight) * direction - body->bodies[i][j][k].velocity * body->dampening;
-				}
-
-				//If there is a rigidbody below this one, calculate the spring force between this rigidbody and the one below
-				if(j < body->subdivisionsY - 1)
-				{
-					displacement = body->bodies[i][j + 1][k].position - body->bodies[i][j][k].position;
-					mag = glm::length(displacement);
-					if(mag > FLT_EPSILON)
-					{
-						direction = glm::normalize(displacement);
-					}
-					else
-					{
-						direction = glm::vec3(0.0f);
-						mag = 0.0f;
-					}
-					neighborForce += body->coefficient * (mag - body->restHeight) * direction - body->bodies[i][j][k].velocity * body->dampening;
-				}
-
-				//If there is a rigidbody left of this one, calculate the spring force between this rigidbody and the one below
-				if(k > 0)
-				{
-					displacement = body->bodies[i][j][k - 1].position - body->bodies[i][j][k].position;
-					mag = glm::length(displacement);
-					if(mag > FLT_EPSILON)
-					{
-						direction = glm::normalize(displacement);
-					}
-					else
-					{
-						direction = glm::vec3(0.0f);
-						mag = 0.0f;
-					}
-					neighborForce += body->coefficient * (mag - body->restWidth) * direction - body->bodies[i][j][k].velocity * body->dampening;
-				}
-
-				//If there is a rigidbody right of this one, calculate the spring force between this rigidbody and the one below
-				if(k < body->subdivisionsX - 1)
-				{
-					displacement = body->bodies[i][j][k + 1].position - body->bodies[i][j][k].position;
-					mag = glm::length(displacement);
-					if(mag > FLT_EPSILON)
-					{
-						direction = glm::normalize(displacement);
-					}
-					else
-					{
-						direction = glm::vec3(0.0f);
-						mag = 0.0f;
-					}
-					neighborForce += body->coefficient * (mag - body->restWidth) * direction - body->bodies[i][j][k].velocity * body->dampening;
-				}
-
-				//If the vertex is on the bottom row, apply the external force
-				//if(i == body->subdivisionsZ - 1)
-
-				if(j != body->subdivisionsY - 1)
-				{
-					body->bodies[i][j][k].netForce += neighborForce + gravity;
-					if(j == 0 )
-					{
-						body->bodies[i][j][k].netForce += externalForce;
-					}
-
-				}
-			}
-		}
+		UpdateImplicit(dt, gravity, externalForce);
+		return;
 	}
-
-
-	//Update the rigidbodies & mesh
-	//For each rigidbody
-	for(int i = 0; i < body->subdivisionsZ; ++i)
+	if(integration == Extended_Position_Based)
 	{
-		for(int j = 0; j < body->subdivisionsY;++j)
-		{
-			for(int k = 0; k < body->subdivisionsX; k++)
-			{
-				int numVertex = i * body->subdivisionsY * body->subdivisionsX + j * body->subdivisionsX + k;
-				//Integrate kinematics
-				IntegrateLinear(dt, body->bodies[i][j][k]);
-				//And change the mesh's vertices to match this rigidbodies position
-				lattice->vertices[numVertex].x = body->bodies[i][j][k].position.x;
-				lattice->vertices[numVertex].y = body->bodies[i][j][k].position.y;
-				lattice->vertices[numVertex].z = body->bodies[i][j][k].position.z;
-			}
-		}
+		UpdateXPBD(dt, gravity, externalForce);
+		return;
 	}
 
+	UpdateExplicit(dt, gravity, externalForce);
 }
 
 // This runs once every frame to determine the FPS and how often to call update based on the physics step.
@@ -703,6 +873,62 @@ void OnKeyPress(GLFWwindow* window, int key, int scancode, int action, int mods)
 			printf("\rRigidness:\t%f", body->dampening);
 		}
 	}
+
+	if(action == GLFW_PRESS)
+	{
+		if(key == GLFW_KEY_I)
+		{
+			integration = (IntegrationMode)((integration + 1) % 3);
+			physicsStep = integration == Implicit_Euler ? implicitStep : integration == Extended_Position_Based ? xpbdStep : explicitStep;
+			printf("\nIntegration:\t%s\n", integrationNames[integration]);
+			if(integration == Extended_Position_Based)
+				printf("Constraint colors:\t%u\n", xpbd->numColors());
+		}
+		else if(key == GLFW_KEY_RIGHT)
+		{
+			++xpbd->iterations;
+			printf("\nXPBD iterations:\t%d\n", xpbd->iterations);
+		}
+		else if(key == GLFW_KEY_LEFT && xpbd->iterations > 1)
+		{
+			--xpbd->iterations;
+			printf("\nXPBD iterations:\t%d\n", xpbd->iterations);
+		}
+		else if(key == GLFW_KEY_EQUAL)
+		{
+			++xpbd->substeps;
+			printf("\nXPBD substeps:\t%d\n", xpbd->substeps);
+		}
+		else if(key == GLFW_KEY_MINUS && xpbd->substeps > 1)
+		{
+			--xpbd->substeps;
+			printf("\nXPBD substeps:\t%d\n", xpbd->substeps);
+		}
+		else if(key == GLFW_KEY_C)
+		{
+			//Point masses are kept a spring's length apart, unless they are within two springs of each other
+			if(xpbd->selfCollisionThickness() > 0.0f)
+				xpbd->SetSelfCollision(0.0f, 0);
+			else
+				xpbd->SetSelfCollision(glm::min(body->restWidth, glm::min(body->restHeight, body->restDepth)), 2);
+			printf("\nXPBD self collision:\t%s\n", xpbd->selfCollisionThickness() > 0.0f ? "On" : "Off");
+		}
+		else if(key == GLFW_KEY_B)
+		{
+			RebuildSprings();
+			printf("\nTetrahedral springs:\t%s (%u springs)\n", extraSprings ? "On" : "Off", network->numSprings());
+		}
+		else if(key == GLFW_KEY_PAGE_UP)
+		{
+			body->coefficient *= 2.0f;
+			printf("\nSpring coefficient:\t%f\n", body->coefficient);
+		}
+		else if(key == GLFW_KEY_PAGE_DOWN)
+		{
+			body->coefficient *= 0.5f;
+			printf("\nSpring coefficient:\t%f\n", body->coefficient);
+		}
+	}
 }
 
 #pragma endregion util_Functions
@@ -778,6 +1004,9 @@ void main()
 
 	//Generate the softbody
 	body = new SoftBody(1.0f, 1.0f, 1.0f, subX, subY, subZ, coeff, damp);
+	BuildSpringNetwork();
+	BuildImplicitSolver();
+	BuildXPBDSolver();
 
 	//Print controls
 	printf("Controls:\nPress and hold the left mouse button to cause a positive constant force\nalong the selected axis.\n");
@@ -787,6 +1016,12 @@ void main()
 	printf("All forces will be applied along the bottom of the structure.\n");
 	printf("Press the up arrow to increase rigidness of the structure.\n");
 	printf("Press the down arrow to decrease rigidness of the structure.\n");
+	printf("Press I to cycle between explicit, implicit and XPBD integration\n");
+	printf("Press Page Up and Page Down to double or halve the spring coefficient\n");
+	printf("Press Left and Right to change the number of XPBD iterations\n");
+	printf("Press Minus and Equals to change the number of XPBD substeps\n");
+	printf("Press C to turn XPBD self collision on or off\n");
+	printf("Press B to switch between lattice and tetrahedral springs\n");
 
 
 	// Enter the main loop.
@@ -814,6 +1049,9 @@ void main()
 
 	delete lattice;
 	delete body;
+	delete solver;
+	delete xpbd;
+	delete network;
 
 
 	// Frees up GLFW memory
@@ -0,0 +1,432 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <float.h>
+
+#include "BVH.h"
+
+//What a node returns when a ray misses its box
+#define BVH_MISS FLT_MAX
+
+///
+//A box, and the number of triangles whose centroids fall in it, for choosing a split
+typedef struct BVHBin
+{
+	glm::vec3 min;
+	glm::vec3 max;
+	uint32_t count;
+}BVHBin;
+
+///
+//The triangle bounds and centroids the tree is built from
+typedef struct BVHBuild
+{
+	glm::vec3* mins;
+	glm::vec3* maxs;
+	glm::vec3* centroids;
+	uint32_t* indices;		//The triangles, in the order of the leaves
+}BVHBuild;
+
+///
+//Gets the surface area of a box
+//
+//Parameters:
+//	min: The lower corner of the box
+//	max: The upper corner of the box
+static float BVH_GetArea(const glm::vec3& min, const glm::vec3& max)
+{
+	glm::vec3 extent = max - min;
+	return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+}
+
+///
+//Splits a node in two, and its children in turn, until splitting no longer makes tracing through it cheaper
+//
+//Parameters:
+//	bvh: The BVH being built
+//	build: The bounds of the triangles
+//	nodeIndex: The node to split, whose triangles and box are already set
+//	depth: The depth of the node in the tree
+static void BVH_Subdivide(BVH* bvh, BVHBuild* build, const uint32_t nodeIndex, const int depth)
+{
+	BVHNode* node = bvh->nodes + nodeIndex;
+	uint32_t first = node->leftFirst;
+	uint32_t count = node->count;
+	if (count <= 1 || depth >= BVH_MAX_DEPTH - 1) return;
+
+	//The splits are chosen along the extent of the centroids, rather than of the triangles
+	glm::vec3 centroidMin(FLT_MAX), centroidMax(-FLT_MAX);
+	for (uint32_t i = first; i < first + count; i++)
+	{
+		centroidMin = glm::min(centroidMin, build->centroids[build->indices[i]]);
+		centroidMax = glm::max(centroidMax, build->centroids[build->indices[i]]);
+	}
+
+	//Tracing through a leaf costs one triangle test per triangle, and through an interior node one box test
+	//plus the cost of each child weighted by the chance a ray through the node also goes through the child
+	float bestCost = (float)count;
+	int bestAxis = -1;
+	int bestSplit = 0;
+	float parentArea = BVH_GetArea(node->min, node->max);
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float extent = centroidMax[axis] - centroidMin[axis];
+		if (extent <= 0.0f) continue;
+		float scale = BVH_NUM_BINS / extent;
+
+		BVHBin bins[BVH_NUM_BINS];
+		for (int b = 0; b < BVH_NUM_BINS; b++)
+		{
+			bins[b].min = glm::vec3(FLT_MAX);
+			bins[b].max = glm::vec3(-FLT_MAX);
+			bins[b].count = 0;
+		}
+		for (uint32_t i = first; i < first + count; i++)
+		{
+			uint32_t triangle = build->indices[i];
+			int b = (int)((build->centroids[triangle][axis] - centroidMin[axis]) * scale);
+			if (b > BVH_NUM_BINS - 1) b = BVH_NUM_BINS - 1;
+			bins[b].min = glm::min(bins[b].min, build->mins[triangle]);
+			bins[b].max = glm::max(bins[b].max, build->maxs[triangle]);
+			bins[b].count++;
+		}
+
+		//Sweep from the left and then the right, so each split's two sides are known in one pass each
+		float leftArea[BVH_NUM_BINS - 1];
+		uint32_t leftCount[BVH_NUM_BINS - 1];
+		glm::vec3 boxMin(FLT_MAX), boxMax(-FLT_MAX);
+		uint32_t sum = 0;
+		for (int b = 0; b < BVH_NUM_BINS - 1; b++)
+		{
+			boxMin = glm::min(boxMin, bins[b].min);
+			boxMax = glm::max(boxMax, bins[b].max);
+			sum += bins[b].count;
+			leftArea[b] = sum > 0 ? BVH_GetArea(boxMin, boxMax) : 0.0f;
+			leftCount[b] = sum;
+		}
+		boxMin = glm::vec3(FLT_MAX);
+		boxMax = glm::vec3(-FLT_MAX);
+		sum = 0;
+		for (int b = BVH_NUM_BINS - 1; b > 0; b--)
+		{
+			boxMin = glm::min(boxMin, bins[b].min);
+			boxMax = glm::max(boxMax, bins[b].max);
+			sum += bins[b].count;
+			if (sum == 0 || leftCount[b - 1] == 0) continue;
+
+			float cost = 1.0f + (leftArea[b - 1] * leftCount[b - 1] + BVH_GetArea(boxMin, boxMax) * sum) / parentArea;
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestSplit = b;
+			}
+		}
+	}
+	if (bestAxis < 0) return;
+
+	//Move the triangles left of the split to the front of the node's range
+	float scale = BVH_NUM_BINS / (centroidMax[bestAxis] - centroidMin[bestAxis]);
+	uint32_t i = first;
+	uint32_t j = first + count;
+	while (i < j)
+	{
+		int b = (int)((build->centroids[build->indices[i]][bestAxis] - centroidMin[bestAxis]) * scale);
+		if (b > BVH_NUM_BINS - 1) b = BVH_NUM_BINS - 1;
+		if (b < bestSplit)
+		{
+			i++;
+		}
+		else
+		{
+			uint32_t swap = build->indices[i];
+			build->indices[i] = build->indices[--j];
+			build->indices[j] = swap;
+		}
+	}
+	uint32_t leftCount = i - first;
+	if (leftCount == 0 || leftCount == count) return;
+
+	uint32_t leftIndex = bvh->numNodes;
+	bvh->numNodes += 2;
+	for (int side = 0; side < 2; side++)
+	{
+		BVHNode* child = bvh->nodes + leftIndex + side;
+		child->leftFirst = side == 0 ? first : first + leftCount;
+		child->count = side == 0 ? leftCount : count - leftCount;
+		child->min = glm::vec3(FLT_MAX);
+		child->max = glm::vec3(-FLT_MAX);
+		for (uint32_t k = child->leftFirst; k < child->leftFirst + child->count; k++)
+		{
+			child->min = glm::min(child->min, build->mins[build->indices[k]]);
+			child->max = glm::max(child->max, build->maxs[build->indices[k]]);
+		}
+	}
+	node->leftFirst = leftIndex;
+	node->count = 0;
+
+	BVH_Subdivide(bvh, build, leftIndex, depth + 1);
+	BVH_Subdivide(bvh, build, leftIndex + 1, depth + 1);
+}
+
+///
+//Finds where a ray enters a node's box
+//
+//Parameters:
+//	node: The node whose box to test
+//	origin: The start of the ray
+//	inverseDir: 1 over each component of the ray's direction
+//	maxT: The farthest along the ray to look
+//
+//Returns:
+//	The distance along the ray at which it enters the box (negative if it starts inside), or BVH_MISS
+static inline float BVH_IntersectBox(const BVHNode* node, const glm::vec3& origin, const glm::vec3& inverseDir, const float maxT)
+{
+	float t1 = (node->min.x - origin.x) * inverseDir.x;
+	float t2 = (node->max.x - origin.x) * inverseDir.x;
+	float tNear = t1 < t2 ? t1 : t2;
+	float tFar = t1 < t2 ? t2 : t1;
+
+	t1 = (node->min.y - origin.y) * inverseDir.y;
+	t2 = (node->max.y - origin.y) * inverseDir.y;
+	tNear = glm::max(tNear, t1 < t2 ? t1 : t2);
+	tFar = glm::min(tFar, t1 < t2 ? t2 : t1);
+
+	t1 = (node->min.z - origin.z) * inverseDir.z;
+	t2 = (node->max.z - origin.z) * inverseDir.z;
+	tNear = glm::max(tNear, t1 < t2 ? t1 : t2);
+	tFar = glm::min(tFar, t1 < t2 ? t2 : t1);
+
+	return tFar >= tNear && tFar > 0.0f && tNear < maxT ? tNear : BVH_MISS;
+}
+
+///
+//Allocates memory for a new BVH
+//
+//Returns:
+//	Pointer to new BVH
+BVH* BVH_Allocate()
+{
+	BVH* bvh = (BVH*)malloc(sizeof(BVH));
+	bvh->nodes = 0x0;
+	bvh->numNodes = 0;
+	bvh->triangles = 0x0;
+	bvh->numTriangles = 0;
+	return bvh;
+}
+
+///
+//Builds a BVH over a list of triangles, copying them
+//
+//Parameters:
+//	bvh: An allocated BVH, which is rebuilt if it has already been built
+//	triangles: The triangles to build the BVH over
+//	numTriangles: The number of triangles
+void BVH_Build(BVH* bvh, const Triangle* triangles, const uint32_t numTriangles)
+{
+	free(bvh->nodes);
+	free(bvh->triangles);
+	bvh->nodes = 0x0;
+	bvh->triangles = 0x0;
+	bvh->numNodes = 0;
+	bvh->numTriangles = 0;
+	if (numTriangles == 0)
+	{
+		printf("BVH_Build failed! There are no triangles. BVH not built.\n");
+		return;
+	}
+
+	BVHBuild build;
+	build.mins = (glm::vec3*)malloc(sizeof(glm::vec3) * numTriangles);
+	build.maxs = (glm::vec3*)malloc(sizeof(glm::vec3) * numTriangles);
+	build.centroids = (glm::vec3*)malloc(sizeof(glm::vec3) * numTriangles);
+	build.indices = (uint32_t*)malloc(sizeof(uint32_t) * numTriangles);
+
+	//A binary tree with a triangle or more in every leaf has fewer than twice as many nodes as triangles
+	bvh->nodes = (BVHNode*)malloc(sizeof(BVHNode) * (2 * numTriangles - 1));
+	bvh->triangles = (Triangle*)malloc(sizeof(Triangle) * numTriangles);
+	if (build.mins == 0x0 || build.maxs == 0x0 || build.centroids == 0x0 || build.indices == 0x0 || bvh->nodes == 0x0 || bvh->triangles == 0x0)
+	{
+		printf("BVH_Build failed! Could not allocate memory for %u triangles. BVH not built.\n", numTriangles);
+		free(build.mins);
+		free(build.maxs);
+		free(build.centroids);
+		free(build.indices);
+		free(bvh->nodes);
+		free(bvh->triangles);
+		bvh->nodes = 0x0;
+		bvh->triangles = 0x0;
+		return;
+	}
+
+	BVHNode* root = bvh->nodes;
+	root->leftFirst = 0;
+	root->count = numTriangles;
+	root->min = glm::vec3(FLT_MAX);
+	root->max = glm::vec3(-FLT_MAX);
+	for (uint32_t i = 0; i < numTriangles; i++)
+	{
+		build.mins[i] = glm::min(triangles[i].a, glm::min(triangles[i].b, triangles[i].c));
+		build.maxs[i] = glm::max(triangles[i].a, glm::max(triangles[i].b, triangles[i].c));
+		build.centroids[i] = (triangles[i].a + triangles[i].b + triangles[i].c) / 3.0f;
+		build.indices[i] = i;
+		root->min = glm::min(root->min, build.mins[i]);
+		root->max = glm::max(root->max, build.maxs[i]);
+	}
+	bvh->numNodes = 1;
+
+	BVH_Subdivide(bvh, &build, 0, 0);
+
+	for (uint32_t i = 0; i < numTriangles; i++)
+	{
+		bvh->triangles[i] = triangles[build.indices[i]];
+	}
+	bvh->numTriangles = numTriangles;
+
+	free(build.mins);
+	free(build.maxs);
+	free(build.centroids);
+	free(build.indices);
+}
+
+///
+//Frees a BVH's resources
+//
+//Parameters:
+//	bvh: The BVH to free
+void BVH_Free(BVH* bvh)
+{
+	free(bvh->nodes);
+	free(bvh->triangles);
+	free(bvh);
+}
+
+///
+//Finds the closest triangle a ray hits
+//
+//Parameters:
+//	bvh: The BVH to trace the ray through
+//	origin: The start of the ray
+//	dir: The direction of the ray
+//	maxT: The farthest along the ray to look
+//	t: Set to the distance along the ray of the closest hit
+//
+//Returns:
+//	The triangle hit, or 0x0 if the ray hits nothing closer than maxT
+const Triangle* BVH_Intersect(const BVH* bvh, const glm::vec3& origin, const glm::vec3& dir, const float maxT, float* t)
+{
+	const Triangle* closest = 0x0;
+	float smallest = maxT;
+	*t = smallest;
+	if (bvh->numNodes == 0) return closest;
+
+	glm::vec3 inverseDir = 1.0f / dir;
+	const BVHNode* stack[BVH_MAX_DEPTH];
+	float stackT[BVH_MAX_DEPTH];
+	int size = 0;
+
+	const BVHNode* node = bvh->nodes;
+	if (BVH_IntersectBox(node, origin, inverseDir, smallest) == BVH_MISS) return closest;
+	for (;;)
+	{
+		if (node->count > 0)
+		{
+			for (uint32_t i = node->leftFirst; i < node->leftFirst + node->count; i++)
+			{
+				float hit = Triangle_Intersect(origin, dir, bvh->triangles[i]);
+				if (hit != -1.0f && hit < smallest)
+				{
+					smallest = hit;
+					closest = bvh->triangles + i;
+				}
+			}
+		}
+		else
+		{
+			//Visit the nearer child first, and come back to the farther one if it is still nearer than any hit
+			const BVHNode* near = bvh->nodes + node->leftFirst;
+			const BVHNode* far = near + 1;
+			float nearT = BVH_IntersectBox(near, origin, inverseDir, smallest);
+			float farT = BVH_IntersectBox(far, origin, inverseDir, smallest);
+			if (farT < nearT)
+			{
+				const BVHNode* swapNode = near;
+				near = far;
+				far = swapNode;
+				float swapT = nearT;
+				nearT = farT;
+				farT = swapT;
+			}
+			if (nearT != BVH_MISS)
+			{
+				if (farT != BVH_MISS)
+				{
+					stack[size] = far;
+					stackT[size++] = farT;
+				}
+				node = near;
+				continue;
+			}
+		}
+
+		//Go back to the nearest node left which could still hold a closer hit
+		do
+		{
+			if (size == 0)
+			{
+				*t = smallest;
+				return closest;
+			}
+			node = stack[--size];
+		} while (stackT[size] >= smallest);
+	}
+}
+
+///
+//Determines whether a ray hits any triangle
+//
+//Parameters:
+//	bvh: The BVH to trace the ray through
+//	origin: The start of the ray
+//	dir: The direction of the ray
+//	maxT: The farthest along the ray to look
+//
+//Returns:
+//	1 if the ray hits a triangle closer than maxT, 0 otherwise
+int BVH_Occluded(const BVH* bvh, const glm::vec3& origin, const glm::vec3& dir, const float maxT)
+{
+	if (bvh->numNodes == 0) return 0;
+
+	glm::vec3 inverseDir = 1.0f / dir;
+	const BVHNode* stack[BVH_MAX_DEPTH];
+	int size = 0;
+
+	const BVHNode* node = bvh->nodes;
+	if (BVH_IntersectBox(node, origin, inverseDir, maxT) == BVH_MISS) return 0;
+	for (;;)
+	{
+		if (node->count > 0)
+		{
+			for (uint32_t i = node->leftFirst; i < node->leftFirst + node->count; i++)
+			{
+				float hit = Triangle_Intersect(origin, dir, bvh->triangles[i]);
+				if (hit != -1.0f && hit < maxT) return 1;
+			}
+		}
+		else
+		{
+			//Any hit will do, so there is no need to order the children
+			const BVHNode* left = bvh->nodes + node->leftFirst;
+			int hitLeft = BVH_IntersectBox(left, origin, inverseDir, maxT) != BVH_MISS;
+			int hitRight = BVH_IntersectBox(left + 1, origin, inverseDir, maxT) != BVH_MISS;
+			if (hitLeft || hitRight)
+			{
+				if (hitLeft && hitRight) stack[size++] = left + 1;
+				node = hitLeft ? left : left + 1;
+				continue;
+			}
+		}
+
+		if (size == 0) return 0;
+		node = stack[--size];
+	}
+}
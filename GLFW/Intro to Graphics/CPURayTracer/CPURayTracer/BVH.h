@@ -0,0 +1,104 @@
+/*
+A bounding volume hierarchy over the triangles of a scene, so a ray is only tested against the few triangles near
+its path instead of all of them.
+
+Every node of the tree holds a box around all the triangles below it. A ray which misses a node's box can not hit any
+of those triangles, so the whole subtree is skipped. The tree is built from the top down: each node's triangles are
+split in two along one axis, choosing the split with the surface area heuristic, which estimates the cost of
+tracing a ray through the two halves from the chance a ray hits each half's box (the box's surface area) times the
+number of triangles in it. The candidate splits are the edges of BVH_NUM_BINS equal bins along each axis, which is
+nearly as good as trying every triangle and takes time linear in the number of triangles. A node becomes a leaf when
+no split is cheaper than testing its triangles.
+
+The nodes are stored in one array of 32 byte nodes, two to a cache line, with the two children of a node next to each
+other. The triangles are copied in the order of the leaves, so a leaf's triangles are next to each other too.
+
+Rays are traced through the tree with a small stack, visiting the nearer child first so the closest hit is found
+early and farther boxes are skipped. Shadow rays only need to know whether anything is in the way, so BVH_Occluded
+stops at the first hit.
+
+References:
+On fast Construction of SAH-based Bounding Volume Hierarchies by Ingo Wald
+Physically Based Rendering by Pharr, Jakob and Humphreys, Chapter 4
+*/
+
+#ifndef BVH_H
+#define BVH_H
+
+#include <stdint.h>
+
+#include "Scene.h"
+
+//The number of candidate splits along each axis is one less than this
+#define BVH_NUM_BINS 16
+//The deepest a tree can be, which is the size of the traversal stack
+#define BVH_MAX_DEPTH 64
+
+typedef struct BVHNode
+{
+	glm::vec3 min;
+	uint32_t leftFirst;		//The left child of an interior node (the right child is after it), or the first triangle of a leaf
+	glm::vec3 max;
+	uint32_t count;			//The number of triangles in a leaf, 0 for an interior node
+}BVHNode;
+
+typedef struct BVH
+{
+	BVHNode* nodes;
+	uint32_t numNodes;
+
+	Triangle* triangles;	//The triangles of the scene, in the order of the leaves
+	uint32_t numTriangles;
+}BVH;
+
+///
+//Allocates memory for a new BVH
+//
+//Returns:
+//	Pointer to new BVH
+BVH* BVH_Allocate();
+
+///
+//Builds a BVH over a list of triangles, copying them
+//
+//Parameters:
+//	bvh: An allocated BVH, which is rebuilt if it has already been built
+//	triangles: The triangles to build the BVH over
+//	numTriangles: The number of triangles
+void BVH_Build(BVH* bvh, const Triangle* triangles, const uint32_t numTriangles);
+
+///
+//Frees a BVH's resources
+//
+//Parameters:
+//	bvh: The BVH to free
+void BVH_Free(BVH* bvh);
+
+///
+//Finds the closest triangle a ray hits
+//
+//Parameters:
+//	bvh: The BVH to trace the ray through
+//	origin: The start of the ray
+//	dir: The direction of the ray
+//	maxT: The farthest along the ray to look
+//	t: Set to the distance along the ray of the closest hit
+//
+//Returns:
+//	The triangle hit, or 0x0 if the ray hits nothing closer than maxT
+const Triangle* BVH_Intersect(const BVH* bvh, const glm::vec3& origin, const glm::vec3& dir, const float maxT, float* t);
+
+///
+//Determines whether a ray hits any triangle
+//
+//Parameters:
+//	bvh: The BVH to trace the ray through
+//	origin: The start of the ray
+//	dir: The direction of the ray
+//	maxT: The farthest along the ray to look
+//
+//Returns:
+//	1 if the ray hits a triangle closer than maxT, 0 otherwise
+int BVH_Occluded(const BVH* bvh, const glm::vec3& origin, const glm::vec3& dir, const float maxT);
+
+#endif
@@ -0,0 +1,82 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "Image.h"
+
+///
+//Writes an image to a binary PPM file
+//
+//Parameters:
+//	fileName: The name of the file to write
+//	rgb: The red, green and blue of each pixel, top row first
+//	width: The width of the image in pixels
+//	height: The height of the image in pixels
+//
+//Returns:
+//	0 if the file could not be written, 1 otherwise
+int Image_WritePPM(const char* fileName, const float* rgb, const uint32_t width, const uint32_t height)
+{
+	FILE* file = fopen(fileName, "wb");
+	if (file == 0x0)
+	{
+		printf("Image_WritePPM failed! Could not open %s. Image not written.\n", fileName);
+		return 0;
+	}
+
+	unsigned char* row = (unsigned char*)malloc(width * 3);
+	fprintf(file, "P6\n%u %u\n255\n", width, height);
+	for (uint32_t y = 0; y < height; y++)
+	{
+		for (uint32_t x = 0; x < width * 3; x++)
+		{
+			float value = rgb[y * width * 3 + x];
+			if (value < 0.0f) value = 0.0f;
+			if (value > 1.0f) value = 1.0f;
+			row[x] = (unsigned char)(value * 255.0f + 0.5f);
+		}
+		fwrite(row, 1, width * 3, file);
+	}
+	free(row);
+
+	int written = !ferror(file);
+	if (fclose(file) != 0) written = 0;
+	if (!written) printf("Image_WritePPM failed! Could not write to %s. Image not written.\n", fileName);
+	return written;
+}
+
+///
+//Writes an image to a PFM file
+//
+//Parameters:
+//	fileName: The name of the file to write
+//	rgb: The red, green and blue of each pixel, top row first
+//	width: The width of the image in pixels
+//	height: The height of the image in pixels
+//
+//Returns:
+//	0 if the file could not be written, 1 otherwise
+int Image_WritePFM(const char* fileName, const float* rgb, const uint32_t width, const uint32_t height)
+{
+	FILE* file = fopen(fileName, "wb");
+	if (file == 0x0)
+	{
+		printf("Image_WritePFM failed! Could not open %s. Image not written.\n", fileName);
+		return 0;
+	}
+
+	//The floats are written in this machine's byte order, which the sign of the scale records
+	const uint16_t one = 1;
+	int littleEndian = *(const unsigned char*)&one == 1;
+	fprintf(file, "PF\n%u %u\n%s\n", width, height, littleEndian ? "-1.0" : "1.0");
+	for (uint32_t y = height; y > 0; y--)
+	{
+		fwrite(rgb + (y - 1) * width * 3, sizeof(float), width * 3, file);
+	}
+
+	int written = !ferror(file);
+	if (fclose(file) != 0) written = 0;
+	if (!written) printf("Image_WritePFM failed! Could not write to %s. Image not written.\n", fileName);
+	return written;
+}
@@ -0,0 +1,41 @@
+/*
+Writes rendered images to disk, so the ray tracer can run without a window.
+
+Images are given as rows of red, green and blue floats, top row first. They can be written as binary PPM (P6), eight
+bits a channel clamped to [0, 1], which most image viewers open, or as PFM, 32 bit floats a channel, which keeps the
+exact values the ray tracer computed for comparing one render against another. PFM stores its rows bottom row first,
+and the sign of the scale in its header gives the byte order of the floats, negative for little endian.
+*/
+
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include <stdint.h>
+
+///
+//Writes an image to a binary PPM file
+//
+//Parameters:
+//	fileName: The name of the file to write
+//	rgb: The red, green and blue of each pixel, top row first
+//	width: The width of the image in pixels
+//	height: The height of the image in pixels
+//
+//Returns:
+//	0 if the file could not be written, 1 otherwise
+int Image_WritePPM(const char* fileName, const float* rgb, const uint32_t width, const uint32_t height);
+
+///
+//Writes an image to a PFM file
+//
+//Parameters:
+//	fileName: The name of the file to write
+//	rgb: The red, green and blue of each pixel, top row first
+//	width: The width of the image in pixels
+//	height: The height of the image in pixels
+//
+//Returns:
+//	0 if the file could not be written, 1 otherwise
+int Image_WritePFM(const char* fileName, const float* rgb, const uint32_t width, const uint32_t height);
+
+#endif
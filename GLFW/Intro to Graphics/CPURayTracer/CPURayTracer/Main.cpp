@@ -0,0 +1,402 @@
+/*
+Title: CPU Ray Tracer
+File Name: Main.cpp
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+References:
+https://github.com/LWJGL/lwjgl3-wiki/wiki/2.6.1.-Ray-tracing-with-OpenGL-Compute-Shaders-(Part-I)
+Physically Based Rendering by Pharr, Jakob and Humphreys
+
+Description:
+The Basic, Intermediate and Advanced Ray Tracers trace every pixel in their fragment shaders, testing each primary,
+shadow and reflection ray against every one of the triangles hard coded there. This program renders the same
+scenes on the CPU, without a window or a GPU, and writes the image to a file. It is meant for reference renders to
+compare the shaders against, and for timing scenes far larger than the shaders can trace on servers with no GPU.
+
+The camera is made by the same calcCameraRays as the GLSL ray tracers, at their starting position, and trace and
+addToPixColor below follow the shader of the same name, so a render matches a screenshot of the example. The
+triangles are put in a BVH (see BVH.h), so each ray is only tested against the few triangles near its path, and
+shadow rays stop at the first triangle in the way. The image is split into square tiles which are rendered across a
+pool of threads that steal tiles from each other (see ThreadPool.h).
+
+The scene can be made larger with a field of generated spheres, each 2208 triangles, or with a Wavefront OBJ file.
+64 spheres give a scene of over 140000 triangles.
+
+Options:
+	-width n, -height n: The size of the image, 800 by 600 by default as in the examples
+	-shader basic|intermediate|advanced: Which ray tracer to match, advanced by default
+	-threads n: The number of threads to render with, one per hardware thread by default
+	-tile n: The width and height of the tiles in pixels, 16 by default
+	-spheres n: Adds n spheres to the floor
+	-obj file: Adds the triangles of an OBJ file
+	-bruteforce: Tests every ray against every triangle, as the shaders do, instead of using the BVH
+	-output file: The file to write, as PFM if its name ends in .pfm and as PPM otherwise, CPURayTracer.ppm by default
+
+Run it with Release settings.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <chrono>
+#endif
+
+#include "glm\glm.hpp"
+#include "glm\gtc\matrix_transform.hpp"
+#include "Scene.h"
+#include "BVH.h"
+#include "ThreadPool.h"
+#include "Image.h"
+
+// The ray tracers whose shading can be matched, and the number of triangles in each one's scene
+enum Shader
+{
+	SHADER_BASIC,
+	SHADER_INTERMEDIATE,
+	SHADER_ADVANCED
+};
+const char* shaderNames[] = { "basic", "intermediate", "advanced" };
+const uint32_t shaderTriangles[] = { 14, 14, 26 };
+
+// The number of rays a worker has traced, padded to a cache line so workers do not share one
+struct RayCount
+{
+	uint64_t rays;
+	char padding[64 - sizeof(uint64_t)];
+};
+
+// Everything the tiles are rendered from
+struct Render
+{
+	const Scene* scene;
+	const BVH* bvh;				// 0x0 to test every triangle instead
+	Shader shader;
+
+	glm::vec3 eye;
+	glm::vec3 ray00, ray01, ray10, ray11;
+
+	uint32_t width, height;
+	uint32_t tileSize, tilesX;
+	float* pixels;				// Three floats a pixel, top row first
+
+	RayCount* rayCounts;		// One for each worker
+};
+
+// The standard clocks in Visual Studio 2013 only tick once a millisecond, so the performance counter is used there
+double GetSeconds()
+{
+#ifdef _WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// This is the calcCameraRays of the GLSL ray tracers, unchanged, so the images line up.
+// It takes the eye position, the point the camera looks at, the up vector, the vertical field of view, the aspect ratio,
+// and the four corner rays to fill in.
+void calcCameraRays(glm::vec3 eye, glm::vec3 center, glm::vec3 up, float fov, float ratio, glm::vec4* r00, glm::vec4* r01, glm::vec4* r10, glm::vec4* r11)
+{
+	// Grab a ray from the camera position toward where the camera is to be centered on.
+	glm::vec3 centerRay = center - eye;
+
+	// w: Vector from center toward eye
+	// u: Vector pointing directly right relative to the camera.
+	// v: Vector pointing directly upward relative to the camera.
+
+	// Create a w vector which is the opposite of that ray.
+	glm::vec3 w = -centerRay;
+
+	// Get the rightward (relative to camera) pointing vector by crossing up with w.
+	glm::vec3 u = glm::cross(up, w);
+
+	// Get the upward (relative to camera) pointing vector by crossing the rightward vector with your w vector.
+	glm::vec3 v = glm::cross(w, u);
+
+	// Each ray starts based off of the center ray. Then we will rotate them over the
+	*r00 = glm::vec4(centerRay, 1.0f);
+	*r01 = *r00;
+	*r10 = *r00;
+	*r11 = *r00;
+
+	// We create these two helper variables, as when we rotate the ray about it's relative Y axis (v), we will then need to rotate it about it's relative X axis (u).
+	// This means that u has to be rotated by v too, otherwise the rotation will not be accurate. When the ray is rotated about v, so then are it's relative axes.
+	glm::vec4 uRotateLeft = glm::vec4(u, 1.0f) * glm::rotate(glm::mat4(), glm::radians(-fov * ratio / 2.0f), v);
+	glm::vec4 uRotateRight = glm::vec4(u, 1.0f) * glm::rotate(glm::mat4(), glm::radians(fov * ratio / 2.0f), v);
+
+	// Now we simply take the ray and rotate it in each direction to create our four corner rays.
+	*r00 = *r00 * glm::rotate(glm::mat4(), glm::radians(-fov * ratio / 2.0f), v) * glm::rotate(glm::mat4(), glm::radians(fov / 2.0f), glm::vec3(uRotateLeft.x, uRotateLeft.y, uRotateLeft.z));
+	*r01 = *r01 * glm::rotate(glm::mat4(), glm::radians(-fov * ratio / 2.0f), v) * glm::rotate(glm::mat4(), glm::radians(-fov / 2.0f), glm::vec3(uRotateLeft.x, uRotateLeft.y, uRotateLeft.z));
+	*r10 = *r10 * glm::rotate(glm::mat4(), glm::radians(fov * ratio / 2.0f), v) * glm::rotate(glm::mat4(), glm::radians(fov / 2.0f), glm::vec3(uRotateRight.x, uRotateRight.y, uRotateRight.z));
+	*r11 = *r11 * glm::rotate(glm::mat4(), glm::radians(fov * ratio / 2.0f), v) * glm::rotate(glm::mat4(), glm::radians(-fov / 2.0f), glm::vec3(uRotateRight.x, uRotateRight.y, uRotateRight.z));
+}
+
+// Finds the closest triangle along a ray, as intersectTriangles does in the shaders, returning 0x0 if there is none
+const Triangle* intersectTriangles(const Render* render, const glm::vec3& origin, const glm::vec3& dir, float* t)
+{
+	if (render->bvh != 0x0) return BVH_Intersect(render->bvh, origin, dir, SCENE_MAX_DISTANCE, t);
+	return Scene_Intersect(render->scene, origin, dir, SCENE_MAX_DISTANCE, t);
+}
+
+// Determines whether anything is in the way of a light shining on a point.
+// The shaders trace from the light toward the point and call it shadowed when the closest hit is more than 0.1 in front
+// of the point. That is the same as any hit closer than 0.1 in front of it, so the search can stop at the first one.
+bool isInShadow(const Render* render, const glm::vec3& lightPos, const glm::vec3& point, float dist)
+{
+	float maxT = glm::min(SCENE_MAX_DISTANCE, dist - 0.1f);
+	if (maxT <= 0.0f) return false;
+
+	glm::vec3 dir = glm::normalize(point - lightPos);
+	if (render->bvh != 0x0) return BVH_Occluded(render->bvh, lightPos, dir, maxT) != 0;
+
+	float t;
+	return Scene_Intersect(render->scene, lightPos, dir, maxT, &t) != 0x0;
+}
+
+// The light one point light adds to a point on a triangle, as addToPixColor does in the Intermediate and Advanced
+// shaders. The Advanced shader also reflects the eye ray off the triangle and adds half of what it sees.
+glm::vec3 addToPixColor(const Render* render, const glm::vec3& lightPos, const glm::vec3& pointToLight, const glm::vec3& dir, const glm::vec3& point, const Triangle* triangle, RayCount* rayCount)
+{
+	float lightIntensity = render->scene->lightIntensity;
+
+	// Get the distance from point on surface to light
+	float dist = glm::length(pointToLight);
+
+	rayCount->rays++;
+	if (isInShadow(render, lightPos, point, dist)) return glm::vec3(0.0f, 0.0f, 0.0f);
+
+	// Get a reflection vector bouncing the light ray off the surface of the triangle.
+	glm::vec3 normalPTL = pointToLight / dist;
+	glm::vec3 r = glm::normalize((2.0f * glm::dot(triangle->normal, normalPTL) * triangle->normal) - normalPTL);
+
+	// pow of a negative number is undefined in GLSL, and comes out as 0 on the GPUs the examples were written on.
+	float facing = glm::dot(r, -dir);
+	float specular = facing > 0.0f ? facing * facing * facing * facing / (dist * dist) : 0.0f;
+	float diffuse = glm::max(0.0f, glm::dot(triangle->normal, normalPTL)) / (dist * dist);
+	glm::vec3 pixColor = (triangle->color * diffuse * lightIntensity) + (lightIntensity * specular * glm::vec3(1.0f, 1.0f, 1.0f));
+	if (render->shader != SHADER_ADVANCED) return pixColor;
+
+	// The reflection Level variable determines how much of the original surface you see versus the reflection.
+	float reflectionLevel = 0.5f;
+	// The reflection power variable determines the strength of the reflected light.
+	float reflectionPower = 0.35f;
+
+	glm::vec3 reflectColor(0.0f, 0.0f, 0.0f);
+	glm::vec3 reflectedEyeToPoint = glm::normalize(dir - (2.0f * glm::dot(dir, triangle->normal) * triangle->normal));
+
+	rayCount->rays++;
+	float t;
+	const Triangle* reflectHit = intersectTriangles(render, point, reflectedEyeToPoint, &t);
+	if (reflectHit != 0x0)
+	{
+		// The reflected point is lit without a shadow test, and by the unnormalized vector to the light, as in the shader
+		glm::vec3 reflectPointToLight = lightPos - (point + reflectedEyeToPoint * t);
+		float reflectDistance = glm::length(reflectPointToLight);
+		float reflectDiffuse = glm::max(0.0f, glm::dot(reflectHit->normal, reflectPointToLight)) / (reflectDistance * reflectDistance);
+		reflectColor = reflectHit->color * reflectDiffuse * lightIntensity * reflectionPower;
+	}
+
+	return reflectColor * reflectionLevel + pixColor * (1.0f - reflectionLevel);
+}
+
+// Finds the color seen along a ray, as trace does in the shaders
+glm::vec3 trace(const Render* render, const glm::vec3& origin, const glm::vec3& dir, RayCount* rayCount)
+{
+	rayCount->rays++;
+	float t;
+	const Triangle* triangle = intersectTriangles(render, origin, dir, &t);
+	if (triangle == 0x0) return glm::vec3(0.0f, 0.0f, 0.0f);
+	if (render->shader == SHADER_BASIC) return triangle->color;
+
+	// Start with some ambient light, then add each light's.
+	glm::vec3 point = origin + dir * t;
+	glm::vec3 pixColor = triangle->color * 0.1f;
+	for (int j = 0; j < SCENE_NUM_LIGHTS; j++)
+	{
+		const glm::vec3& light = render->scene->lights[j];
+		pixColor += addToPixColor(render, light, light - point, dir, point, triangle, rayCount);
+	}
+	return pixColor;
+}
+
+// Renders one tile of the image. This is run by the thread pool once for every tile.
+void renderTile(uint32_t task, uint32_t worker, void* data)
+{
+	const Render* render = (const Render*)data;
+	RayCount* rayCount = render->rayCounts + worker;
+
+	uint32_t left = (task % render->tilesX) * render->tileSize;
+	uint32_t top = (task / render->tilesX) * render->tileSize;
+	uint32_t right = glm::min(left + render->tileSize, render->width);
+	uint32_t bottom = glm::min(top + render->tileSize, render->height);
+	for (uint32_t y = top; y < bottom; y++)
+	{
+		// The texture coordinates the fragment shader gets at the pixel's center, with y going up from the bottom row
+		float v = 1.0f - (y + 0.5f) / render->height;
+		glm::vec3 rayLeft = glm::mix(render->ray00, render->ray01, v);
+		glm::vec3 rayRight = glm::mix(render->ray10, render->ray11, v);
+		for (uint32_t x = left; x < right; x++)
+		{
+			float u = (x + 0.5f) / render->width;
+			glm::vec3 dir = glm::normalize(glm::mix(rayLeft, rayRight, u));
+			glm::vec3 color = trace(render, render->eye, dir, rayCount);
+
+			float* pixel = render->pixels + (y * render->width + x) * 3;
+			pixel[0] = color.r;
+			pixel[1] = color.g;
+			pixel[2] = color.b;
+		}
+	}
+}
+
+// Reads an unsigned number for an option, returning false if there is not one
+bool readNumber(int argc, char* argv[], int& i, uint32_t* value)
+{
+	if (i + 1 >= argc) return false;
+	char* end;
+	unsigned long number = strtoul(argv[i + 1], &end, 10);
+	if (end == argv[i + 1] || *end != '\0') return false;
+	*value = (uint32_t)number;
+	i++;
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	uint32_t width = 800;
+	uint32_t height = 600;
+	Shader shader = SHADER_ADVANCED;
+	uint32_t numThreads = 0;
+	uint32_t tileSize = 16;
+	uint32_t numSpheres = 0;
+	const char* objFile = 0x0;
+	bool bruteForce = false;
+	const char* outputFile = "CPURayTracer.ppm";
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool valid = true;
+		if (strcmp(argv[i], "-width") == 0) valid = readNumber(argc, argv, i, &width) && width > 0;
+		else if (strcmp(argv[i], "-height") == 0) valid = readNumber(argc, argv, i, &height) && height > 0;
+		else if (strcmp(argv[i], "-threads") == 0) valid = readNumber(argc, argv, i, &numThreads);
+		else if (strcmp(argv[i], "-tile") == 0) valid = readNumber(argc, argv, i, &tileSize) && tileSize > 0;
+		else if (strcmp(argv[i], "-spheres") == 0) valid = readNumber(argc, argv, i, &numSpheres);
+		else if (strcmp(argv[i], "-bruteforce") == 0) bruteForce = true;
+		else if (strcmp(argv[i], "-obj") == 0 && i + 1 < argc) objFile = argv[++i];
+		else if (strcmp(argv[i], "-output") == 0 && i + 1 < argc) outputFile = argv[++i];
+		else if (strcmp(argv[i], "-shader") == 0 && i + 1 < argc)
+		{
+			i++;
+			valid = false;
+			for (int s = SHADER_BASIC; s <= SHADER_ADVANCED; s++)
+			{
+				if (strcmp(argv[i], shaderNames[s]) == 0)
+				{
+					shader = (Shader)s;
+					valid = true;
+				}
+			}
+		}
+		else valid = false;
+
+		if (!valid)
+		{
+			printf("Usage: CPURayTracer [-width n] [-height n] [-shader basic|intermediate|advanced] [-threads n] [-tile n] [-spheres n] [-obj file] [-bruteforce] [-output file.ppm|file.pfm]\n");
+			return 1;
+		}
+	}
+
+	Scene* scene = Scene_Allocate();
+	Scene_Initialize(scene, shaderTriangles[shader]);
+	if (numSpheres > 0) Scene_AddSpheres(scene, numSpheres);
+	if (objFile != 0x0 && !Scene_LoadOBJ(scene, objFile, glm::vec3(0.8f, 0.8f, 0.8f)))
+	{
+		Scene_Free(scene);
+		return 1;
+	}
+	printf("Scene: %u triangles, %s shading\n", scene->numTriangles, shaderNames[shader]);
+
+	BVH* bvh = 0x0;
+	if (!bruteForce)
+	{
+		double start = GetSeconds();
+		bvh = BVH_Allocate();
+		BVH_Build(bvh, scene->triangles, scene->numTriangles);
+		printf("BVH: %u nodes built in %.1f ms\n", bvh->numNodes, (GetSeconds() - start) * 1000.0);
+	}
+
+	ThreadPool* pool = ThreadPool_Allocate();
+	ThreadPool_Initialize(pool, numThreads);
+
+	// The camera starts where the GLSL ray tracers' does
+	glm::vec4 r00, r01, r10, r11;
+	glm::vec3 cameraPos(4.0f, 8.0f, 8.0f);
+	calcCameraRays(cameraPos, glm::vec3(0.0f, 0.5f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), 60.0f, (float)width / height, &r00, &r01, &r10, &r11);
+
+	Render render;
+	render.scene = scene;
+	render.bvh = bvh;
+	render.shader = shader;
+	render.eye = cameraPos;
+	render.ray00 = glm::vec3(r00);
+	render.ray01 = glm::vec3(r01);
+	render.ray10 = glm::vec3(r10);
+	render.ray11 = glm::vec3(r11);
+	render.width = width;
+	render.height = height;
+	render.tileSize = tileSize;
+	render.tilesX = (width + tileSize - 1) / tileSize;
+	render.pixels = (float*)malloc(sizeof(float) * 3 * width * height);
+	render.rayCounts = new RayCount[pool->numThreads];
+	for (uint32_t i = 0; i < pool->numThreads; i++)
+	{
+		render.rayCounts[i].rays = 0;
+	}
+	uint32_t numTiles = render.tilesX * ((height + tileSize - 1) / tileSize);
+
+	double start = GetSeconds();
+	ThreadPool_Run(pool, numTiles, renderTile, &render);
+	double seconds = GetSeconds() - start;
+
+	uint64_t rays = 0;
+	uint32_t stolen = 0;
+	for (uint32_t i = 0; i < pool->numThreads; i++)
+	{
+		rays += render.rayCounts[i].rays;
+		stolen += pool->queues[i].numStolen;
+	}
+	printf("Render: %ux%u in %u tiles on %u threads, %.1f ms, %.2f million rays a second, %u tiles stolen\n",
+		width, height, numTiles, pool->numThreads, seconds * 1000.0, rays / seconds / 1000000.0, stolen);
+
+	size_t length = strlen(outputFile);
+	bool pfm = length >= 4 && (strcmp(outputFile + length - 4, ".pfm") == 0 || strcmp(outputFile + length - 4, ".PFM") == 0);
+	int written = pfm ? Image_WritePFM(outputFile, render.pixels, width, height) : Image_WritePPM(outputFile, render.pixels, width, height);
+	if (written) printf("Wrote %s\n", outputFile);
+
+	free(render.pixels);
+	delete[] render.rayCounts;
+	ThreadPool_Free(pool);
+	if (bvh != 0x0) BVH_Free(bvh);
+	Scene_Free(scene);
+	return written ? 0 : 1;
+}
@@ -0,0 +1,295 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "Scene.h"
+
+//The triangles of the AdvancedRayTracer fragment shader. The first 14 are the scene of the Basic and Intermediate
+//ray tracers.
+static const Triangle Scene_shaderTriangles[26] =
+{
+	// Flat Box
+	// Top face triangles
+	{ glm::vec3(-5.0f, 0.0f, 5.0f), glm::vec3(-5.0f, 0.0f, -5.0f), glm::vec3(5.0f, 0.0f, -5.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f) },
+	{ glm::vec3(-5.0f, 0.0f, 5.0f), glm::vec3(5.0f, 0.0f, -5.0f), glm::vec3(5.0f, 0.0f, 5.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f) },
+	// Cube Box
+	// Back face triangles
+	{ glm::vec3(-0.5f, 1.0f, -0.5f), glm::vec3(0.5f, 1.0f, -0.5f), glm::vec3(-0.5f, 2.0f, -0.5f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	{ glm::vec3(0.5f, 1.0f, -0.5f), glm::vec3(0.5f, 2.0f, -0.5f), glm::vec3(-0.5f, 2.0f, -0.5f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	// Front face triangles
+	{ glm::vec3(-0.5f, 1.0f, 0.5f), glm::vec3(-0.5f, 2.0f, 0.5f), glm::vec3(0.5f, 2.0f, 0.5f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	{ glm::vec3(-0.5f, 1.0f, 0.5f), glm::vec3(0.5f, 2.0f, 0.5f), glm::vec3(0.5f, 1.0f, 0.5f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	// Right face triangles
+	{ glm::vec3(0.5f, 1.0f, 0.5f), glm::vec3(0.5f, 2.0f, 0.5f), glm::vec3(0.5f, 2.0f, -0.5f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	{ glm::vec3(0.5f, 1.0f, 0.5f), glm::vec3(0.5f, 2.0f, -0.5f), glm::vec3(0.5f, 1.0f, -0.5f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	// Left face triangles
+	{ glm::vec3(-0.5f, 1.0f, -0.5f), glm::vec3(-0.5f, 2.0f, -0.5f), glm::vec3(-0.5f, 2.0f, 0.5f), glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	{ glm::vec3(-0.5f, 1.0f, -0.5f), glm::vec3(-0.5f, 2.0f, 0.5f), glm::vec3(-0.5f, 1.0f, 0.5f), glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	// Top face triangles
+	{ glm::vec3(-0.5f, 2.0f, 0.5f), glm::vec3(-0.5f, 2.0f, -0.5f), glm::vec3(0.5f, 2.0f, -0.5f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	{ glm::vec3(-0.5f, 2.0f, 0.5f), glm::vec3(0.5f, 2.0f, -0.5f), glm::vec3(0.5f, 2.0f, 0.5f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	// Bottom face triangles
+	{ glm::vec3(-0.5f, 1.0f, 0.5f), glm::vec3(0.5f, 1.0f, 0.5f), glm::vec3(0.5f, 1.0f, -0.5f), glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	{ glm::vec3(-0.5f, 1.0f, 0.5f), glm::vec3(0.5f, 1.0f, -0.5f), glm::vec3(-0.5f, 1.0f, -0.5f), glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	// Cube Box 2
+	// Back face triangles
+	{ glm::vec3(2.5f, 3.5f, 2.5f), glm::vec3(3.5f, 3.5f, 2.5f), glm::vec3(2.5f, 4.5f, 2.5f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	{ glm::vec3(3.5f, 3.5f, 2.5f), glm::vec3(3.5f, 4.5f, 2.5f), glm::vec3(2.5f, 4.5f, 2.5f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	// Front face triangles
+	{ glm::vec3(2.5f, 3.5f, 1.5f), glm::vec3(2.5f, 4.5f, 1.5f), glm::vec3(3.5f, 4.5f, 1.5f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	{ glm::vec3(2.5f, 3.5f, 1.5f), glm::vec3(3.5f, 4.5f, 1.5f), glm::vec3(3.5f, 3.5f, 1.5f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	// Right face triangles
+	{ glm::vec3(3.5f, 3.5f, 1.5f), glm::vec3(3.5f, 4.5f, 1.5f), glm::vec3(3.5f, 4.5f, 2.5f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	{ glm::vec3(3.5f, 3.5f, 1.5f), glm::vec3(3.5f, 4.5f, 2.5f), glm::vec3(3.5f, 3.5f, 2.5f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	// Left face triangles
+	{ glm::vec3(2.5f, 3.5f, 2.5f), glm::vec3(2.5f, 4.5f, 2.5f), glm::vec3(2.5f, 4.5f, 1.5f), glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	{ glm::vec3(2.5f, 3.5f, 2.5f), glm::vec3(2.5f, 4.5f, 1.5f), glm::vec3(2.5f, 3.5f, 1.5f), glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	// Top face triangles
+	{ glm::vec3(2.5f, 4.5f, 1.5f), glm::vec3(2.5f, 4.5f, 2.5f), glm::vec3(3.5f, 4.5f, 2.5f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	{ glm::vec3(2.5f, 4.5f, 1.5f), glm::vec3(3.5f, 4.5f, 2.5f), glm::vec3(3.5f, 4.5f, 1.5f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	// Bottom face triangles
+	{ glm::vec3(2.5f, 3.5f, 1.5f), glm::vec3(3.5f, 3.5f, 1.5f), glm::vec3(3.5f, 3.5f, 2.5f), glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+	{ glm::vec3(2.5f, 3.5f, 1.5f), glm::vec3(3.5f, 3.5f, 2.5f), glm::vec3(2.5f, 3.5f, 2.5f), glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f) }
+};
+
+///
+//Makes room for more triangles in a scene
+//
+//Parameters:
+//	scene: The scene to grow
+//	numTriangles: The number of triangles the scene must have room for
+static void Scene_Reserve(Scene* scene, const uint32_t numTriangles)
+{
+	if (numTriangles <= scene->capacity) return;
+
+	uint32_t capacity = scene->capacity * 2 > numTriangles ? scene->capacity * 2 : numTriangles;
+	Triangle* triangles = (Triangle*)realloc(scene->triangles, sizeof(Triangle) * capacity);
+	if (triangles == 0x0)
+	{
+		printf("Scene_Reserve failed! Could not allocate %u triangles!\n", capacity);
+		return;
+	}
+	scene->triangles = triangles;
+	scene->capacity = capacity;
+}
+
+///
+//Allocates memory for a new scene
+//
+//Returns:
+//	Pointer to new scene
+Scene* Scene_Allocate()
+{
+	Scene* scene = (Scene*)malloc(sizeof(Scene));
+	scene->triangles = 0x0;
+	scene->numTriangles = 0;
+	scene->capacity = 0;
+	return scene;
+}
+
+///
+//Initializes a scene with the triangles and lights of one of the GLSL ray tracers
+//
+//Parameters:
+//	scene: The scene to initialize
+//	numShaderTriangles: 14 for the scene of the Basic and Intermediate ray tracers, 26 for the Advanced ray tracer
+void Scene_Initialize(Scene* scene, const uint32_t numShaderTriangles)
+{
+	uint32_t count = numShaderTriangles < 26 ? numShaderTriangles : 26;
+	Scene_Reserve(scene, count);
+	memcpy(scene->triangles, Scene_shaderTriangles, sizeof(Triangle) * count);
+	scene->numTriangles = count;
+
+	scene->lights[0] = glm::vec3(5.0f, 3.0f, 0.0f);
+	scene->lights[1] = glm::vec3(-8.0f, 5.0f, 5.0f);
+	scene->lights[2] = glm::vec3(5.0f, 8.0f, -5.0f);
+	scene->lights[3] = glm::vec3(-5.0f, 5.0f, -5.0f);
+	scene->lightIntensity = 6.0f;
+}
+
+///
+//Frees a scene's resources
+//
+//Parameters:
+//	scene: The scene to free
+void Scene_Free(Scene* scene)
+{
+	free(scene->triangles);
+	free(scene);
+}
+
+///
+//Adds a triangle to a scene, finding its normal from its winding
+//
+//Parameters:
+//	scene: The scene to add the triangle to
+//	a, b, c: The corners of the triangle, counter clockwise seen from the front
+//	color: The color of the triangle
+void Scene_AddTriangle(Scene* scene, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& color)
+{
+	glm::vec3 normal = glm::cross(b - a, c - a);
+	float length = glm::length(normal);
+	//Degenerate triangles can never be hit
+	if (length == 0.0f) return;
+
+	Scene_Reserve(scene, scene->numTriangles + 1);
+	if (scene->numTriangles >= scene->capacity) return;
+
+	Triangle* triangle = scene->triangles + scene->numTriangles++;
+	triangle->a = a;
+	triangle->b = b;
+	triangle->c = c;
+	triangle->normal = normal / length;
+	triangle->color = color;
+}
+
+///
+//Adds the faces of a Wavefront OBJ file to a scene. Only the vertex positions and faces are read; faces with more
+//than three corners are split into a fan of triangles.
+//
+//Parameters:
+//	scene: The scene to add the triangles to
+//	fileName: The name of the OBJ file
+//	color: The color of the triangles
+//
+//Returns:
+//	0 if the file could not be read, 1 otherwise
+int Scene_LoadOBJ(Scene* scene, const char* fileName, const glm::vec3& color)
+{
+	FILE* file = fopen(fileName, "r");
+	if (file == 0x0)
+	{
+		printf("Scene_LoadOBJ failed! Could not open %s!\n", fileName);
+		return 0;
+	}
+
+	glm::vec3* positions = 0x0;
+	uint32_t numPositions = 0;
+	uint32_t positionCapacity = 0;
+
+	char line[1024];
+	while (fgets(line, sizeof(line), file) != 0x0)
+	{
+		if (line[0] == 'v' && line[1] == ' ')
+		{
+			glm::vec3 position;
+			if (sscanf(line + 2, "%f %f %f", &position.x, &position.y, &position.z) != 3) continue;
+			if (numPositions == positionCapacity)
+			{
+				positionCapacity = positionCapacity == 0 ? 1024 : positionCapacity * 2;
+				positions = (glm::vec3*)realloc(positions, sizeof(glm::vec3) * positionCapacity);
+			}
+			positions[numPositions++] = position;
+		}
+		else if (line[0] == 'f' && line[1] == ' ')
+		{
+			//Each corner is v, v/vt, v//vn or v/vt/vn, and negative indices count back from the last position
+			uint32_t corners[3];
+			int numCorners = 0;
+			for (char* token = strtok(line + 2, " \t\r\n"); token != 0x0; token = strtok(0x0, " \t\r\n"))
+			{
+				long index = strtol(token, 0x0, 10);
+				if (index < 0) index += numPositions + 1;
+				if (index < 1 || index > (long)numPositions)
+				{
+					numCorners = -1;
+					break;
+				}
+
+				corners[numCorners < 2 ? numCorners : 2] = (uint32_t)index - 1;
+				if (++numCorners >= 3)
+				{
+					Scene_AddTriangle(scene, positions[corners[0]], positions[corners[1]], positions[corners[2]], color);
+					corners[1] = corners[2];
+				}
+			}
+			if (numCorners < 0)
+			{
+				printf("Scene_LoadOBJ failed! A face of %s uses a vertex which is not defined. Face skipped.\n", fileName);
+			}
+		}
+	}
+
+	free(positions);
+	fclose(file);
+	return 1;
+}
+
+///
+//Adds a grid of spheres standing on the floor to a scene, each of SCENE_SPHERE_SLICES segments around and half that
+//many from pole to pole, for 2208 triangles a sphere.
+//
+//Parameters:
+//	scene: The scene to add the spheres to
+//	numSpheres: The number of spheres to add
+void Scene_AddSpheres(Scene* scene, const uint32_t numSpheres)
+{
+	const int slices = SCENE_SPHERE_SLICES;
+	const int stacks = SCENE_SPHERE_SLICES / 2;
+	const float pi = 3.14159265358979f;
+
+	//The spheres fill the 10 by 10 floor in a square grid
+	uint32_t gridSize = (uint32_t)ceilf(sqrtf((float)numSpheres));
+	float cellSize = 10.0f / gridSize;
+	float radius = cellSize * 0.4f;
+
+	Scene_Reserve(scene, scene->numTriangles + numSpheres * 2 * slices * (stacks - 1));
+	for (uint32_t sphere = 0; sphere < numSpheres; sphere++)
+	{
+		uint32_t row = sphere / gridSize;
+		uint32_t col = sphere % gridSize;
+		glm::vec3 center(-5.0f + (col + 0.5f) * cellSize, radius, -5.0f + (row + 0.5f) * cellSize);
+		glm::vec3 color(0.3f + 0.7f * (float)col / gridSize, 0.3f + 0.7f * (float)row / gridSize, 0.5f);
+
+		for (int stack = 0; stack < stacks; stack++)
+		{
+			float theta0 = pi * stack / stacks;
+			float theta1 = pi * (stack + 1) / stacks;
+			for (int slice = 0; slice < slices; slice++)
+			{
+				float phi0 = 2.0f * pi * slice / slices;
+				float phi1 = 2.0f * pi * (slice + 1) / slices;
+				glm::vec3 p00 = center + radius * glm::vec3(sinf(theta0) * cosf(phi0), cosf(theta0), sinf(theta0) * sinf(phi0));
+				glm::vec3 p01 = center + radius * glm::vec3(sinf(theta0) * cosf(phi1), cosf(theta0), sinf(theta0) * sinf(phi1));
+				glm::vec3 p10 = center + radius * glm::vec3(sinf(theta1) * cosf(phi0), cosf(theta1), sinf(theta1) * sinf(phi0));
+				glm::vec3 p11 = center + radius * glm::vec3(sinf(theta1) * cosf(phi1), cosf(theta1), sinf(theta1) * sinf(phi1));
+
+				//The quads touching the poles are single triangles
+				if (stack != 0) Scene_AddTriangle(scene, p00, p01, p10, color);
+				if (stack != stacks - 1) Scene_AddTriangle(scene, p01, p11, p10, color);
+			}
+		}
+	}
+}
+
+///
+//Finds the closest triangle a ray hits by testing every triangle, as intersectTriangles does in the shaders
+//
+//Parameters:
+//	scene: The scene to test the ray against
+//	origin: The start of the ray
+//	dir: The direction of the ray
+//	maxT: The farthest along the ray to look
+//	t: Set to the distance along the ray of the closest hit
+//
+//Returns:
+//	The triangle hit, or 0x0 if the ray hits nothing closer than maxT
+const Triangle* Scene_Intersect(const Scene* scene, const glm::vec3& origin, const glm::vec3& dir, const float maxT, float* t)
+{
+	const Triangle* closest = 0x0;
+	float smallest = maxT;
+	for (uint32_t i = 0; i < scene->numTriangles; i++)
+	{
+		float hit = Triangle_Intersect(origin, dir, scene->triangles[i]);
+		if (hit != -1.0f && hit < smallest)
+		{
+			smallest = hit;
+			closest = scene->triangles + i;
+		}
+	}
+	*t = smallest;
+	return closest;
+}
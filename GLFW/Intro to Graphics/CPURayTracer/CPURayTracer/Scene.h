@@ -0,0 +1,145 @@
+/*
+The triangles and lights the CPU ray tracer renders.
+
+A scene starts with the triangles and the four point lights the GLSL ray tracers (BasicRayTracer,
+IntermediateRayTracer and AdvancedRayTracer) hard code in their fragment shaders. The Basic and Intermediate shaders
+have the floor and one cube, 14 triangles, and the Advanced shader adds a second cube, 26 triangles. More triangles
+can be added from a Wavefront OBJ file, or generated as a field of spheres standing on the floor, to make scenes large
+enough to need the BVH.
+
+Each triangle keeps one normal and one color, as in the shaders. The normals of added triangles are found from their
+winding, counter clockwise seen from the front.
+*/
+
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <stdint.h>
+
+#include "glm\glm.hpp"
+
+#define SCENE_NUM_LIGHTS 4
+//The farthest a ray can hit anything, MAX_SCENE_BOUNDS in the shaders
+#define SCENE_MAX_DISTANCE 100.0f
+//The number of segments around each generated sphere
+#define SCENE_SPHERE_SLICES 48
+
+typedef struct Triangle
+{
+	glm::vec3 a;
+	glm::vec3 b;
+	glm::vec3 c;
+	glm::vec3 normal;
+	glm::vec3 color;
+}Triangle;
+
+typedef struct Scene
+{
+	Triangle* triangles;
+	uint32_t numTriangles;
+	uint32_t capacity;			//The number of triangles there is room for
+
+	glm::vec3 lights[SCENE_NUM_LIGHTS];
+	float lightIntensity;
+}Scene;
+
+///
+//Determines whether a ray hits a triangle, using the Moller-Trumbore test exactly as rayIntersectsTriangle does in the
+//shaders.
+//
+//Parameters:
+//	origin: The start of the ray
+//	dir: The direction of the ray
+//	triangle: The triangle to test
+//
+//Returns:
+//	The distance t along the ray at which it hits the triangle, or -1.0f if it does not
+inline float Triangle_Intersect(const glm::vec3& origin, const glm::vec3& dir, const Triangle& triangle)
+{
+	glm::vec3 e1 = triangle.b - triangle.a;
+	glm::vec3 e2 = triangle.c - triangle.a;
+	glm::vec3 h = glm::cross(dir, e2);
+	float a = glm::dot(e1, h);
+	if (a > -0.00001f && a < 0.00001f) return -1.0f;
+
+	float f = 1.0f / a;
+	glm::vec3 s = origin - triangle.a;
+	float u = f * glm::dot(s, h);
+	if (u < 0.0f || u > 1.0f) return -1.0f;
+
+	glm::vec3 q = glm::cross(s, e1);
+	float v = f * glm::dot(dir, q);
+	if (v < 0.0f || u + v > 1.0f) return -1.0f;
+
+	float t = f * glm::dot(e2, q);
+	return t > 0.00001f ? t : -1.0f;
+}
+
+///
+//Allocates memory for a new scene
+//
+//Returns:
+//	Pointer to new scene
+Scene* Scene_Allocate();
+
+///
+//Initializes a scene with the triangles and lights of one of the GLSL ray tracers
+//
+//Parameters:
+//	scene: The scene to initialize
+//	numShaderTriangles: 14 for the scene of the Basic and Intermediate ray tracers, 26 for the Advanced ray tracer
+void Scene_Initialize(Scene* scene, const uint32_t numShaderTriangles);
+
+///
+//Frees a scene's resources
+//
+//Parameters:
+//	scene: The scene to free
+void Scene_Free(Scene* scene);
+
+///
+//Adds a triangle to a scene, finding its normal from its winding
+//
+//Parameters:
+//	scene: The scene to add the triangle to
+//	a, b, c: The corners of the triangle, counter clockwise seen from the front
+//	color: The color of the triangle
+void Scene_AddTriangle(Scene* scene, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& color);
+
+///
+//Adds the faces of a Wavefront OBJ file to a scene. Only the vertex positions and faces are read; faces with more
+//than three corners are split into a fan of triangles.
+//
+//Parameters:
+//	scene: The scene to add the triangles to
+//	fileName: The name of the OBJ file
+//	color: The color of the triangles
+//
+//Returns:
+//	0 if the file could not be read, 1 otherwise
+int Scene_LoadOBJ(Scene* scene, const char* fileName, const glm::vec3& color);
+
+///
+//Adds a grid of spheres standing on the floor to a scene, each of SCENE_SPHERE_SLICES segments around and half that
+//many from pole to pole, for 2208 triangles a sphere.
+//
+//Parameters:
+//	scene: The scene to add the spheres to
+//	numSpheres: The number of spheres to add
+void Scene_AddSpheres(Scene* scene, const uint32_t numSpheres);
+
+///
+//Finds the closest triangle a ray hits by testing every triangle, as intersectTriangles does in the shaders
+//
+//Parameters:
+//	scene: The scene to test the ray against
+//	origin: The start of the ray
+//	dir: The direction of the ray
+//	maxT: The farthest along the ray to look
+//	t: Set to the distance along the ray of the closest hit
+//
+//Returns:
+//	The triangle hit, or 0x0 if the ray hits nothing closer than maxT
+const Triangle* Scene_Intersect(const Scene* scene, const glm::vec3& origin, const glm::vec3& dir, const float maxT, float* t);
+
+#endif
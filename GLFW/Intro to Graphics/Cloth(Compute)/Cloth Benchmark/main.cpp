@@ -0,0 +1,354 @@
+/*
+Title: Cloth Benchmark
+File Name: main.cpp
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+The Cloth (Compute) example steps its cloth with a compute shader, and falls back on ClothCPU where there are no
+compute shaders. This program times both on the same cloths so they can be compared:
+
+	- ClothCPU on a single thread
+	- ClothCPU on every hardware thread, when there is more than one
+	- ComputeShader.glsl, when a window with an OpenGL 4.3 context can be made
+
+The GPU is optional. On a machine without one (or without a display), the GPU rows are skipped and the CPU rows
+are still measured, which makes this the way to check how fast the cloth will run on a simulation server.
+
+Every backend starts each cloth from the same flat sheet with the same wind and runs the same number of
+dispatches, so the positions they end up with can be compared. Each row reports the largest difference from
+the single threaded CPU result. The threaded CPU rows should match exactly. The GPU rows will not, since the
+GPU's square roots and divisions round differently, but they should stay small.
+
+The cloths are sized in multiples of ten, since the shader runs in 10x10 work groups, starting with the
+80x40 cloth of the example. One update of the example is 1000 dispatches, so the ms_per_update column says
+whether a backend can keep up with the example's 12 ms physics step.
+
+The program is compiled with AVX2 so ClothCPU can do eight particles at a time. It takes two optional arguments:
+the file to write the CSV to, and the path of ComputeShader.glsl. Run it with Release settings.
+
+References:
+OpenGL 4 shading language cookbook by David Wolff
+*/
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <chrono>
+#endif
+
+#include "glew\glew.h"
+#include "glfw\glfw3.h"
+#include "ClothCPU.h"
+
+// The number of particle updates each backend is timed for on every cloth
+#define PARTICLE_UPDATES 50000000.0
+#define MIN_DISPATCHES 100
+#define WARM_UP_DISPATCHES 10
+
+// The same wind the example blows while space is held
+const glm::vec3 wind(0.2f, 0.0f, 0.0f);
+
+// The standard clocks in Visual Studio 2013 only tick once a millisecond, so the performance counter is used there
+double GetSeconds()
+{
+#ifdef _WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// The flat sheet the example starts with, four floats per particle
+void MakeCloth(unsigned int particlesX, unsigned int particlesY, std::vector<float>& positions, std::vector<float>& velocities)
+{
+	positions.resize(particlesX * particlesY * 4);
+	velocities.assign(particlesX * particlesY * 4, 0.0f);
+	for (unsigned int i = 0; i < particlesY; i++)
+	{
+		for (unsigned int j = 0; j < particlesX; j++)
+		{
+			float* p = &positions[(i * particlesX + j) * 4];
+			p[0] = j * (1.0f / particlesX);
+			p[1] = i * (1.0f / particlesY);
+			p[2] = 0.0f;
+			p[3] = 1.0f;
+		}
+	}
+}
+
+struct Result
+{
+	std::string backend;
+	unsigned int threads;
+	double seconds;
+	std::vector<float> positions;
+};
+
+#pragma region CPU
+
+void RunCPU(unsigned int particlesX, unsigned int particlesY, int dispatches, unsigned int threads, Result& result)
+{
+	std::vector<float> positions, velocities;
+	MakeCloth(particlesX, particlesY, positions, velocities);
+
+	ClothCPU cloth(particlesX, particlesY, &positions[0], &velocities[0]);
+	cloth.RestLengthHoriz = 1.0f / particlesX;
+	cloth.RestLengthVert = 1.0f / particlesY;
+	cloth.RestLengthDiag = sqrtf(cloth.RestLengthHoriz * cloth.RestLengthHoriz + cloth.RestLengthVert * cloth.RestLengthVert);
+	cloth.externalForce = wind;
+	cloth.numThreads = threads;
+
+	cloth.Dispatch(WARM_UP_DISPATCHES);
+
+	double start = GetSeconds();
+	cloth.Dispatch(dispatches);
+	result.seconds = GetSeconds() - start;
+
+	result.backend = ClothCPU::usesAVX() ? "cpu avx" : "cpu";
+	result.threads = threads;
+	result.positions.resize(positions.size());
+	cloth.GetPositions(&result.positions[0]);
+}
+
+#pragma endregion
+
+#pragma region GPU
+
+GLFWwindow* window;
+GLuint computeProgram;
+
+std::string ReadFile(const char* fileName)
+{
+	std::ifstream file(fileName, std::ios::in | std::ios::binary);
+	if (!file.good())
+	{
+		return "";
+	}
+	return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+///
+//Makes an invisible window with an OpenGL 4.3 context and compiles the compute shader
+//
+//Returns:
+//	Whether the GPU can be benchmarked, after printing why not if it can't
+bool InitGPU(const char* shaderFile)
+{
+	if (!glfwInit())
+	{
+		printf("GPU: GLFW could not be initialized (no display?), skipping the GPU\n");
+		return false;
+	}
+
+	glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	window = glfwCreateWindow(64, 64, "Cloth Benchmark", nullptr, nullptr);
+	if (window == nullptr)
+	{
+		printf("GPU: no OpenGL 4.3 context, skipping the GPU\n");
+		return false;
+	}
+	glfwMakeContextCurrent(window);
+
+	glewExperimental = GL_TRUE;
+	if (glewInit() != GLEW_OK || !(GLEW_VERSION_4_3 || GLEW_ARB_compute_shader))
+	{
+		printf("GPU: compute shaders are not supported, skipping the GPU\n");
+		return false;
+	}
+
+	std::string source = ReadFile(shaderFile);
+	if (source.empty())
+	{
+		printf("GPU: can't read %s, skipping the GPU\n", shaderFile);
+		return false;
+	}
+
+	GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+	const char* sourcePtr = source.c_str();
+	glShaderSource(shader, 1, &sourcePtr, NULL);
+	glCompileShader(shader);
+
+	GLint isCompiled = 0;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
+	if (isCompiled == GL_FALSE)
+	{
+		char infolog[1024];
+		glGetShaderInfoLog(shader, 1024, NULL, infolog);
+		printf("GPU: the shader failed to compile with the error:\n%s\n", infolog);
+		return false;
+	}
+
+	computeProgram = glCreateProgram();
+	glAttachShader(computeProgram, shader);
+	glLinkProgram(computeProgram);
+	glDeleteShader(shader);
+
+	printf("GPU: %s\n", (const char*)glGetString(GL_RENDERER));
+	return true;
+}
+
+// The same buffers and dispatch loop as update() in the example
+void RunGPU(unsigned int particlesX, unsigned int particlesY, int dispatches, Result& result)
+{
+	std::vector<float> positions, velocities;
+	MakeCloth(particlesX, particlesY, positions, velocities);
+	GLsizeiptr size = positions.size() * sizeof(GLfloat);
+
+	GLuint posBuf[2], velBuf[2];
+	glGenBuffers(2, posBuf);
+	glGenBuffers(2, velBuf);
+	for (int b = 0; b < 2; b++)
+	{
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, posBuf[b]);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, size, &positions[0], GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, velBuf[b]);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, size, &velocities[0], GL_DYNAMIC_COPY);
+	}
+
+	float horizontalRest = 1.0f / particlesX;
+	float verticalRest = 1.0f / particlesY;
+
+	glUseProgram(computeProgram);
+	glUniform1f(glGetUniformLocation(computeProgram, "RestLengthHoriz"), horizontalRest);
+	glUniform1f(glGetUniformLocation(computeProgram, "RestLengthVert"), verticalRest);
+	glUniform1f(glGetUniformLocation(computeProgram, "RestLengthDiag"), sqrtf(horizontalRest * horizontalRest + verticalRest * verticalRest));
+	glUniform3fv(glGetUniformLocation(computeProgram, "externalForce"), 1, (const float*)&wind);
+
+	int readBuffer = 0;
+	double start = 0.0;
+	for (int i = 0; i < WARM_UP_DISPATCHES + dispatches; i++)
+	{
+		if (i == WARM_UP_DISPATCHES)
+		{
+			glFinish();
+			start = GetSeconds();
+		}
+
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, posBuf[readBuffer]);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, posBuf[1 - readBuffer]);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, velBuf[readBuffer]);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, velBuf[1 - readBuffer]);
+
+		glDispatchCompute(particlesX / 10, particlesY / 10, 1);
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+		readBuffer = 1 - readBuffer;
+	}
+	glFinish();
+	result.seconds = GetSeconds() - start;
+
+	result.backend = "gpu";
+	result.threads = 0;
+	result.positions.resize(positions.size());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, posBuf[readBuffer]);
+	glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, &result.positions[0]);
+
+	glDeleteBuffers(2, posBuf);
+	glDeleteBuffers(2, velBuf);
+}
+
+#pragma endregion
+
+// The largest difference between any coordinate of two results
+double MaxDifference(const Result& a, const Result& b)
+{
+	double difference = 0.0;
+	for (unsigned int i = 0; i < a.positions.size(); ++i)
+	{
+		if (i % 4 == 3) continue;
+		double d = fabs((double)a.positions[i] - (double)b.positions[i]);
+		// A NaN anywhere means the cloth blew up in one of them
+		if (d != d) return d;
+		if (d > difference) difference = d;
+	}
+	return difference;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* fileName = argc > 1 ? argv[1] : "ClothBenchmark.csv";
+	const char* shaderFile = argc > 2 ? argv[2] : "../Cloth(Compute)/ComputeShader.glsl";
+
+	FILE* file = fopen(fileName, "w");
+	if (file == 0)
+	{
+		printf("Could not open %s for writing!\n", fileName);
+		return 1;
+	}
+
+	bool gpu = InitGPU(shaderFile);
+	unsigned int hardwareThreads = std::thread::hardware_concurrency();
+
+	FILE* outputs[2] = { stdout, file };
+	for (int o = 0; o < 2; ++o)
+	{
+		fprintf(outputs[o], "backend,particles_x,particles_y,threads,dispatches,ms_per_dispatch,ms_per_update,particle_updates_per_s,max_difference\n");
+	}
+
+	const unsigned int sizes[][2] = { { 80, 40 }, { 160, 80 }, { 320, 160 }, { 640, 320 }, { 1280, 640 } };
+	for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+	{
+		unsigned int particlesX = sizes[s][0];
+		unsigned int particlesY = sizes[s][1];
+		double particles = (double)particlesX * particlesY;
+		int dispatches = (int)(PARTICLE_UPDATES / particles);
+		if (dispatches < MIN_DISPATCHES) dispatches = MIN_DISPATCHES;
+
+		std::vector<Result> results(1);
+		RunCPU(particlesX, particlesY, dispatches, 1, results[0]);
+		if (hardwareThreads > 1)
+		{
+			results.push_back(Result());
+			RunCPU(particlesX, particlesY, dispatches, hardwareThreads, results.back());
+		}
+		if (gpu)
+		{
+			results.push_back(Result());
+			RunGPU(particlesX, particlesY, dispatches, results.back());
+		}
+
+		for (unsigned int r = 0; r < results.size(); ++r)
+		{
+			double msPerDispatch = results[r].seconds * 1000.0 / dispatches;
+			for (int o = 0; o < 2; ++o)
+			{
+				fprintf(outputs[o], "%s,%u,%u,%u,%d,%.4f,%.2f,%.0f,%g\n",
+					results[r].backend.c_str(), particlesX, particlesY, results[r].threads, dispatches,
+					msPerDispatch, msPerDispatch * 1000.0, particles * dispatches / results[r].seconds,
+					MaxDifference(results[0], results[r]));
+				fflush(outputs[o]);
+			}
+		}
+	}
+
+	fclose(file);
+	if (window) glfwDestroyWindow(window);
+	glfwTerminate();
+	return 0;
+}
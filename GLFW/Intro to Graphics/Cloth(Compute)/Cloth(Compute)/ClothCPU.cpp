@@ -0,0 +1,356 @@
+#include "ClothCPU.h"
+
+#include <math.h>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+// Below this many rows per thread, waiting for the other threads after every dispatch costs more than they save
+#define MIN_ROWS_PER_THREAD 32
+
+// Holds every thread that reaches it until all of them have, so no thread starts the next dispatch
+// while another is still reading the buffer it is about to write.
+class ClothBarrier
+{
+public:
+	ClothBarrier(unsigned int count)
+	{
+		_count = count;
+		_waiting = 0;
+		_generation = 0;
+	}
+
+	void Wait()
+	{
+		if (_count == 1) return;
+
+		std::unique_lock<std::mutex> lock(_mutex);
+		unsigned int generation = _generation;
+		if (++_waiting == _count)
+		{
+			_waiting = 0;
+			++_generation;
+			_condition.notify_all();
+		}
+		else
+		{
+			_condition.wait(lock, [this, generation] { return generation != _generation; });
+		}
+	}
+
+private:
+	std::mutex _mutex;
+	std::condition_variable _condition;
+	unsigned int _count;
+	unsigned int _waiting;
+	unsigned int _generation;
+};
+
+ClothCPU::ClothCPU(unsigned int particlesX, unsigned int particlesY, const float* positions, const float* velocities)
+{
+	_particlesX = particlesX;
+	_particlesY = particlesY;
+	_read = 0;
+
+	Gravity = glm::vec3(0.0f, -10.0f, 0.0f);
+	externalForce = glm::vec3(0.0f);
+	ParticleMass = 0.1f;
+	particleInvMass = 1.0f / 0.1f;
+	SpringK = 2000.0f;
+	RestLengthHoriz = 0.0f;
+	RestLengthVert = 0.0f;
+	RestLengthDiag = 0.0f;
+	deltaT = 0.00001f;
+	DampingConst = 0.1f;
+	numThreads = 0;
+
+	unsigned int count = particlesX * particlesY;
+	for (int b = 0; b < 2; ++b)
+	{
+		_buffers[b].x.resize(count);
+		_buffers[b].y.resize(count);
+		_buffers[b].z.resize(count);
+		_buffers[b].vx.resize(count);
+		_buffers[b].vy.resize(count);
+		_buffers[b].vz.resize(count);
+	}
+
+	SetState(positions, velocities);
+}
+
+ClothCPU::~ClothCPU()
+{
+}
+
+void ClothCPU::Dispatch(int count)
+{
+	if (count <= 0) return;
+
+	unsigned int threadCount = numThreads;
+	if (threadCount == 0)
+	{
+		threadCount = std::min(std::thread::hardware_concurrency(), _particlesY / MIN_ROWS_PER_THREAD);
+	}
+	threadCount = std::min(threadCount, _particlesY);
+	if (threadCount == 0) threadCount = 1;
+
+	ClothBarrier barrier(threadCount);
+
+	// The calling thread takes the first block of rows itself
+	std::vector<std::thread> threads;
+	for (unsigned int t = 1; t < threadCount; ++t)
+	{
+		threads.push_back(std::thread(&ClothCPU::DispatchThread, this, count, t, threadCount, std::ref(barrier)));
+	}
+	DispatchThread(count, 0, threadCount, barrier);
+	for (unsigned int t = 0; t < threads.size(); ++t)
+	{
+		threads[t].join();
+	}
+
+	_read ^= count & 1;
+}
+
+void ClothCPU::DispatchThread(int count, unsigned int thread, unsigned int threadCount, ClothBarrier& barrier)
+{
+	unsigned int rowBegin = _particlesY * thread / threadCount;
+	unsigned int rowEnd = _particlesY * (thread + 1) / threadCount;
+
+	int read = _read;
+	for (int i = 0; i < count; ++i)
+	{
+		for (unsigned int y = rowBegin; y < rowEnd; ++y)
+		{
+			UpdateRow(y, _buffers[read], _buffers[1 - read]);
+		}
+
+		read = 1 - read;
+		barrier.Wait();
+	}
+}
+
+// The same as one invocation of the shader for each particle. Note that the shader uses the horizontal rest
+// length for the vertical springs too, and so does this, so both versions give the same cloth.
+void ClothCPU::UpdateParticles(unsigned int y, unsigned int first, unsigned int last, const ClothBuffer& in, ClothBuffer& out) const
+{
+	for (unsigned int x = first; x < last; ++x)
+	{
+		unsigned int idx = y * _particlesX + x;
+
+		glm::vec3 p(in.x[idx], in.y[idx], in.z[idx]);
+		glm::vec3 v(in.vx[idx], in.vy[idx], in.vz[idx]);
+
+		//compensate for external forces (gravity and wind)
+		glm::vec3 force = (Gravity * ParticleMass) + externalForce;
+
+		unsigned int neighbors[4];
+		int numNeighbors = 0;
+		if (x > 0) neighbors[numNeighbors++] = idx - 1;
+		if (x < _particlesX - 1) neighbors[numNeighbors++] = idx + 1;
+		if (y > 0) neighbors[numNeighbors++] = idx - _particlesX;
+		if (y < _particlesY - 1) neighbors[numNeighbors++] = idx + _particlesX;
+
+		for (int n = 0; n < numNeighbors; ++n)
+		{
+			glm::vec3 r = glm::vec3(in.x[neighbors[n]], in.y[neighbors[n]], in.z[neighbors[n]]) - p;
+			float length = sqrtf(r.x * r.x + r.y * r.y + r.z * r.z);
+			force += r * (SpringK * (length - RestLengthHoriz) / length);
+		}
+
+		force += -DampingConst * v;
+
+		glm::vec3 a = force * particleInvMass;
+
+		glm::vec3 position = p + (v * deltaT) + (0.5f * a * deltaT * deltaT);
+		glm::vec3 velocity = v + a * deltaT;
+
+		out.x[idx] = position.x;
+		out.y[idx] = position.y;
+		out.z[idx] = position.z;
+		out.vx[idx] = velocity.x;
+		out.vy[idx] = velocity.y;
+		out.vz[idx] = velocity.z;
+	}
+}
+
+#ifdef __AVX__
+// Adds the force of the springs from eight particles to the eight neighbors r away from them
+inline void AddSprings(__m256& fx, __m256& fy, __m256& fz, __m256 rx, __m256 ry, __m256 rz, __m256 k, __m256 rest)
+{
+	__m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(rx, rx), _mm256_mul_ps(ry, ry)), _mm256_mul_ps(rz, rz)));
+	__m256 scale = _mm256_div_ps(_mm256_mul_ps(k, _mm256_sub_ps(length, rest)), length);
+	fx = _mm256_add_ps(fx, _mm256_mul_ps(rx, scale));
+	fy = _mm256_add_ps(fy, _mm256_mul_ps(ry, scale));
+	fz = _mm256_add_ps(fz, _mm256_mul_ps(rz, scale));
+}
+#endif
+
+// The particles at either end of the row are missing a neighbor, so they are done one at a time along with any
+// left over when the row does not divide into eights. Everything in between has both a left and a right neighbor.
+void ClothCPU::UpdateRow(unsigned int y, const ClothBuffer& in, ClothBuffer& out) const
+{
+	unsigned int x = 0;
+
+#ifdef __AVX__
+	if (_particlesX > 2)
+	{
+		UpdateParticles(y, 0, 1, in, out);
+		x = 1;
+
+		const unsigned int row = y * _particlesX;
+		const bool below = y > 0;
+		const bool above = y < _particlesY - 1;
+
+		const __m256 k = _mm256_set1_ps(SpringK);
+		const __m256 rest = _mm256_set1_ps(RestLengthHoriz);
+		const __m256 damping = _mm256_set1_ps(-DampingConst);
+		const __m256 inverseMass = _mm256_set1_ps(particleInvMass);
+		const __m256 dt = _mm256_set1_ps(deltaT);
+		const __m256 halfDt2 = _mm256_set1_ps(0.5f * deltaT * deltaT);
+		const __m256 externalX = _mm256_set1_ps(Gravity.x * ParticleMass + externalForce.x);
+		const __m256 externalY = _mm256_set1_ps(Gravity.y * ParticleMass + externalForce.y);
+		const __m256 externalZ = _mm256_set1_ps(Gravity.z * ParticleMass + externalForce.z);
+
+		for (; x + 8 <= _particlesX - 1; x += 8)
+		{
+			unsigned int idx = row + x;
+
+			__m256 px = _mm256_loadu_ps(&in.x[idx]);
+			__m256 py = _mm256_loadu_ps(&in.y[idx]);
+			__m256 pz = _mm256_loadu_ps(&in.z[idx]);
+			__m256 vx = _mm256_loadu_ps(&in.vx[idx]);
+			__m256 vy = _mm256_loadu_ps(&in.vy[idx]);
+			__m256 vz = _mm256_loadu_ps(&in.vz[idx]);
+
+			__m256 fx = externalX;
+			__m256 fy = externalY;
+			__m256 fz = externalZ;
+
+			//Left and right
+			AddSprings(fx, fy, fz,
+				_mm256_sub_ps(_mm256_loadu_ps(&in.x[idx - 1]), px),
+				_mm256_sub_ps(_mm256_loadu_ps(&in.y[idx - 1]), py),
+				_mm256_sub_ps(_mm256_loadu_ps(&in.z[idx - 1]), pz), k, rest);
+			AddSprings(fx, fy, fz,
+				_mm256_sub_ps(_mm256_loadu_ps(&in.x[idx + 1]), px),
+				_mm256_sub_ps(_mm256_loadu_ps(&in.y[idx + 1]), py),
+				_mm256_sub_ps(_mm256_loadu_ps(&in.z[idx + 1]), pz), k, rest);
+
+			//Below and above
+			if (below)
+			{
+				AddSprings(fx, fy, fz,
+					_mm256_sub_ps(_mm256_loadu_ps(&in.x[idx - _particlesX]), px),
+					_mm256_sub_ps(_mm256_loadu_ps(&in.y[idx - _particlesX]), py),
+					_mm256_sub_ps(_mm256_loadu_ps(&in.z[idx - _particlesX]), pz), k, rest);
+			}
+			if (above)
+			{
+				AddSprings(fx, fy, fz,
+					_mm256_sub_ps(_mm256_loadu_ps(&in.x[idx + _particlesX]), px),
+					_mm256_sub_ps(_mm256_loadu_ps(&in.y[idx + _particlesX]), py),
+					_mm256_sub_ps(_mm256_loadu_ps(&in.z[idx + _particlesX]), pz), k, rest);
+			}
+
+			fx = _mm256_add_ps(fx, _mm256_mul_ps(damping, vx));
+			fy = _mm256_add_ps(fy, _mm256_mul_ps(damping, vy));
+			fz = _mm256_add_ps(fz, _mm256_mul_ps(damping, vz));
+
+			__m256 ax = _mm256_mul_ps(fx, inverseMass);
+			__m256 ay = _mm256_mul_ps(fy, inverseMass);
+			__m256 az = _mm256_mul_ps(fz, inverseMass);
+
+			//p + v * dt + a * dt^2 / 2
+			_mm256_storeu_ps(&out.x[idx], _mm256_add_ps(_mm256_add_ps(px, _mm256_mul_ps(vx, dt)), _mm256_mul_ps(ax, halfDt2)));
+			_mm256_storeu_ps(&out.y[idx], _mm256_add_ps(_mm256_add_ps(py, _mm256_mul_ps(vy, dt)), _mm256_mul_ps(ay, halfDt2)));
+			_mm256_storeu_ps(&out.z[idx], _mm256_add_ps(_mm256_add_ps(pz, _mm256_mul_ps(vz, dt)), _mm256_mul_ps(az, halfDt2)));
+
+			//v + a * dt
+			_mm256_storeu_ps(&out.vx[idx], _mm256_add_ps(vx, _mm256_mul_ps(ax, dt)));
+			_mm256_storeu_ps(&out.vy[idx], _mm256_add_ps(vy, _mm256_mul_ps(ay, dt)));
+			_mm256_storeu_ps(&out.vz[idx], _mm256_add_ps(vz, _mm256_mul_ps(az, dt)));
+		}
+	}
+#endif
+
+	UpdateParticles(y, x, _particlesX, in, out);
+
+	//Pin the top Vertices
+	if (y == _particlesY - 1)
+	{
+		for (unsigned int column = 0; column < _particlesX; ++column)
+		{
+			if (column % 10 != 0 && column != _particlesX - 1) continue;
+
+			unsigned int idx = y * _particlesX + column;
+			out.x[idx] = in.x[idx];
+			out.y[idx] = in.y[idx];
+			out.z[idx] = in.z[idx];
+			out.vx[idx] = in.vx[idx];
+			out.vy[idx] = in.vy[idx];
+			out.vz[idx] = in.vz[idx];
+		}
+	}
+}
+
+void ClothCPU::GetPositions(float* positions) const
+{
+	const ClothBuffer& current = _buffers[_read];
+	for (unsigned int i = 0; i < current.x.size(); ++i)
+	{
+		positions[i * 4] = current.x[i];
+		positions[i * 4 + 1] = current.y[i];
+		positions[i * 4 + 2] = current.z[i];
+		positions[i * 4 + 3] = 1.0f;
+	}
+}
+
+void ClothCPU::GetVelocities(float* velocities) const
+{
+	const ClothBuffer& current = _buffers[_read];
+	for (unsigned int i = 0; i < current.x.size(); ++i)
+	{
+		velocities[i * 4] = current.vx[i];
+		velocities[i * 4 + 1] = current.vy[i];
+		velocities[i * 4 + 2] = current.vz[i];
+		velocities[i * 4 + 3] = 0.0f;
+	}
+}
+
+void ClothCPU::SetState(const float* positions, const float* velocities)
+{
+	ClothBuffer& current = _buffers[_read];
+	for (unsigned int i = 0; i < current.x.size(); ++i)
+	{
+		current.x[i] = positions[i * 4];
+		current.y[i] = positions[i * 4 + 1];
+		current.z[i] = positions[i * 4 + 2];
+		current.vx[i] = velocities[i * 4];
+		current.vy[i] = velocities[i * 4 + 1];
+		current.vz[i] = velocities[i * 4 + 2];
+	}
+}
+
+unsigned int ClothCPU::particlesX() const
+{
+	return _particlesX;
+}
+
+unsigned int ClothCPU::particlesY() const
+{
+	return _particlesY;
+}
+
+bool ClothCPU::usesAVX()
+{
+#ifdef __AVX__
+	return true;
+#else
+	return false;
+#endif
+}
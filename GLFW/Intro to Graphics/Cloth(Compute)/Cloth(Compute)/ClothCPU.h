@@ -0,0 +1,88 @@
+#pragma once
+#include <vector>
+#include "glm\glm.hpp"
+
+class ClothBarrier;
+
+// One copy of the cloth's state, the CPU side of the PositionIn / VelocityIn (or Out) buffers of ComputeShader.glsl.
+// Each axis is its own array so eight particles of a row can be loaded into one AVX register.
+struct ClothBuffer
+{
+	std::vector<float> x, y, z;
+	std::vector<float> vx, vy, vz;
+};
+
+// Runs the cloth update of ComputeShader.glsl on the CPU, for machines without compute shaders (or without a GPU).
+//
+// Each dispatch reads every particle from one buffer and writes it to the other, and the buffers are swapped
+// afterward, the same as the ping-pong between posBuf[0] and posBuf[1] in the GPU version. Every particle only
+// reads from the input buffer, so any particle can be updated independently of the rest. The rows are split into
+// blocks across threads, and each row is done eight particles at a time with AVX when the program is compiled
+// with it (/arch:AVX2 or /arch:AVX in Visual Studio). The threads are started once per call to Dispatch and wait
+// for each other between dispatches, instead of being started for every dispatch.
+//
+// The fields mirror the uniforms of the shader and start with the same values, so the CPU cloth behaves the same way.
+class ClothCPU
+{
+public:
+
+	///
+	//Makes a cloth of particlesX by particlesY particles
+	//
+	//Parameters:
+	//	particlesX: The number of particles in each row
+	//	particlesY: The number of rows
+	//	positions: Four floats per particle, the same layout as the position buffer of the shader
+	//	velocities: Four floats per particle, the same layout as the velocity buffer of the shader
+	ClothCPU(unsigned int particlesX, unsigned int particlesY, const float* positions, const float* velocities);
+	~ClothCPU();
+
+	///
+	//Does the same as count calls to glDispatchCompute with ComputeShader.glsl, swapping the buffers after each one
+	void Dispatch(int count);
+
+	///
+	//Copies the current state out, or replaces it, as four floats per particle. The w of every position is 1.
+	void GetPositions(float* positions) const;
+	void GetVelocities(float* velocities) const;
+	void SetState(const float* positions, const float* velocities);
+
+	// The uniforms of ComputeShader.glsl
+	glm::vec3 Gravity;
+	glm::vec3 externalForce;
+	float ParticleMass;
+	float particleInvMass;
+	float SpringK;
+	float RestLengthHoriz;
+	float RestLengthVert;
+	float RestLengthDiag;
+	float deltaT;
+	float DampingConst;
+
+	// The number of threads the rows are split across, 0 to pick from the number of rows and hardware threads
+	unsigned int numThreads;
+
+	unsigned int particlesX() const;
+	unsigned int particlesY() const;
+
+	// Whether rows are done eight particles at a time with AVX, which depends on how the program was compiled
+	static bool usesAVX();
+
+private:
+
+	// Runs count dispatches on one thread's block of rows
+	void DispatchThread(int count, unsigned int thread, unsigned int threadCount, ClothBarrier& barrier);
+
+	// Updates particles first up to last of row y, reading from in and writing to out, one at a time
+	void UpdateParticles(unsigned int y, unsigned int first, unsigned int last, const ClothBuffer& in, ClothBuffer& out) const;
+
+	// Updates every particle of row y
+	void UpdateRow(unsigned int y, const ClothBuffer& in, ClothBuffer& out) const;
+
+	unsigned int _particlesX;
+	unsigned int _particlesY;
+
+	// _buffers[_read] holds the current state, the other is written to by the next dispatch
+	ClothBuffer _buffers[2];
+	int _read;
+};
@@ -0,0 +1,109 @@
+/*
+Steps the cloth with extended position based dynamics (XPBD) instead of explicit spring forces.
+
+Every spring is a distance constraint. One substep is three kinds of dispatch, chosen by the Stage uniform:
+
+Stage 0: every particle remembers where it is and moves freely by its velocity, gravity and the wind.
+         Every constraint's Lagrange multiplier is reset.
+Stage 1: the constraints of one color are projected, one invocation per constraint. The constraints were sorted
+         by color on the CPU so that no two constraints of a color share a particle, so the invocations never write
+         to the same particle. The CPU dispatches the colors one after another with a memory barrier in between.
+Stage 2: every particle's velocity becomes however far it moved during the substep.
+
+The positions and velocities are the same buffers the explicit compute shader reads from, so the cloth can be
+switched between the two at any time.
+*/
+
+#version 430
+
+layout (local_size_x = 64) in;
+
+struct Constraint
+{
+	uint i;
+	uint j;
+	float restLength;
+	float lambda;
+};
+
+uniform int Stage;
+uniform uint NumParticles;
+uniform uint NumConstraints;
+uniform uint ColorOffset;		//The first constraint of the color being solved in stage 1
+uniform uint ColorCount;		//The number of constraints in that color
+
+uniform vec3 Gravity = vec3(0.0f,-10.0f,0.0f);
+uniform vec3 externalForce;
+uniform float deltaT;			//The length of one substep
+uniform float Compliance;		//The inverse of the spring coefficient
+uniform float DampingConst = 0.1f;
+
+layout (std430, binding = 0) buffer Pos { vec4 Position[]; };
+layout (std430, binding = 2) buffer Vel { vec4 Velocity[]; };
+//xyz: where the particle was at the start of the substep, w: the inverse mass of the particle, 0 when it is pinned
+layout (std430, binding = 4) buffer Prev { vec4 Previous[]; };
+layout (std430, binding = 5) buffer Cons { Constraint Constraints[]; };
+
+void main(void)
+{
+	uint idx = gl_GlobalInvocationID.x;
+
+	if(Stage == 0)
+	{
+		if(idx < NumConstraints)
+			Constraints[idx].lambda = 0.0f;
+
+		if(idx >= NumParticles)
+			return;
+
+		float w = Previous[idx].w;
+		Previous[idx].xyz = Position[idx].xyz;
+		if(w == 0.0f)
+			return;
+
+		vec3 v = Velocity[idx].xyz + deltaT * (Gravity + w * externalForce);
+		Velocity[idx].xyz = v;
+		Position[idx].xyz += deltaT * v;
+	}
+	else if(Stage == 1)
+	{
+		if(idx >= ColorCount)
+			return;
+
+		Constraint c = Constraints[ColorOffset + idx];
+		float wi = Previous[c.i].w;
+		float wj = Previous[c.j].w;
+		float alpha = Compliance / (deltaT * deltaT);
+		if(wi + wj == 0.0f)
+			return;
+
+		vec3 r = Position[c.j].xyz - Position[c.i].xyz;
+		float len = length(r);
+		if(len == 0.0f)
+			return;
+		vec3 n = r / len;
+
+		//dLambda = (-C - alpha * lambda) / (wi + wj + alpha)
+		float dLambda = (c.restLength - len - alpha * c.lambda) / (wi + wj + alpha);
+		Constraints[ColorOffset + idx].lambda = c.lambda + dLambda;
+
+		Position[c.i].xyz -= wi * dLambda * n;
+		Position[c.j].xyz += wj * dLambda * n;
+	}
+	else
+	{
+		if(idx >= NumParticles)
+			return;
+
+		float w = Previous[idx].w;
+		if(w == 0.0f)
+		{
+			Velocity[idx].xyz = vec3(0.0f);
+			return;
+		}
+
+		//The dampening is applied implicitly so it can never reverse the velocity
+		vec3 v = (Position[idx].xyz - Previous[idx].xyz) / deltaT;
+		Velocity[idx].xyz = v / (1.0f + deltaT * DampingConst * w);
+	}
+}
@@ -45,11 +45,28 @@ Then we simply call the drawArrays function of openGL. Notice how we never read
 from the buffers on the CPU side of the applicaiton. This is the advantage of using 
 shaders in this type of situations: We avoid unnecessary transfer of data from CPU to GPU.
 
+The cloth can also be stepped with extended position based dynamics (XPBD, see XPBDShader.glsl). Every spring
+becomes a distance constraint, and each substep the particles move freely before being pulled back to satisfy
+the constraints directly. Since the constraints are solved one after another, each one seeing the corrections
+of the ones before it, they cannot all run at once. Instead the constraints are split into colors on the CPU so
+that no two constraints of a color share a particle, and each color is one dispatch with a memory barrier after it.
+The stiffness comes from the spring coefficient alone, so a few substeps per update replace the 1000 tiny
+explicit steps. Press X to switch between the two, the Left and Right arrow keys to change the number of
+XPBD iterations, and the Up and Down arrow keys to change the number of XPBD substeps. XPBD only runs on the GPU.
+
+Not every GPU supports compute shaders, so the same explicit update can also run on the CPU (see ClothCPU).
+Every particle of a dispatch only reads the buffers of the last one, so the rows are split across threads and each
+row is done eight particles at a time with AVX (the project is compiled with /arch:AVX2). The CPU cloth writes its
+positions into the same buffer the GPU one does, so the drawing is the same either way. The CPU is used
+automatically when compute shaders are missing, and C switches between the two otherwise. The Cloth Benchmark project times both.
+
 References:
 OpenGL 4 shading language cookbook by David Wolff
+XPBD: Position-Based Simulation of Compliant Constrained Dynamics by Miles Macklin, Matthias Muller and Nuttapong Chentanez
 */
 
 #include "GLIncludes.h"
+#include "ClothCPU.h"
 
 //number of Particles in each direction. these  particles will be uniformly spread from 0 to 1.
 #define NUMBER_OF_PARTICLES_X 80
@@ -68,6 +85,8 @@ GLuint vao;
 GLuint vertex_shader;
 GLuint fragment_shader;
 GLuint compute_shader;
+GLuint xpbd_shader;
+GLuint xpbdProgram;
 
 // This is a reference to your uniform MVP matrix in your vertex shader
 GLuint uniVP;
@@ -75,6 +94,37 @@ GLuint uniVP;
 GLuint posBuf[2];
 GLuint velBuf[2];
 
+//The XPBD buffers: where each particle was at the start of the substep along with its inverse mass, and the constraints
+GLuint prevBuf;
+GLuint constraintBuf;
+
+//A distance constraint as laid out in the XPBD shader
+struct Constraint
+{
+	GLuint i;
+	GLuint j;
+	GLfloat restLength;
+	GLfloat lambda;
+};
+
+//The constraints are sorted by color. Color c is colorStart[c] up to colorStart[c + 1] - 1.
+std::vector<GLuint> colorStart;
+GLuint numConstraints;
+
+bool useXPBD = false;
+int xpbdSubsteps = 10;
+int xpbdIterations = 2;
+//The explicit path takes 1000 steps of 0.00001 each update, so XPBD covers the same time
+const float xpbdStep = 0.01f;
+const float springK = 2000.0f;
+const float particleMass = 0.1f;
+
+//The CPU version of the explicit update, used when there are no compute shaders or C is pressed
+ClothCPU* cpuCloth;
+bool useCPU = false;
+bool hasComputeShaders;
+std::vector<GLfloat> cpuPositions;
+
 //This vector is used to simulate wind in this example.
 glm::vec3 externalForce = glm::vec3(0);
 
@@ -186,12 +236,14 @@ void init()
 	std::string vertShader = readShader("VertexShader.glsl");
 	std::string fragShader = readShader("FragmentShader.glsl");
 	std::string computeShader = readShader("computeShader.glsl");
+	std::string xpbdShader = readShader("XPBDShader.glsl");
 
 	// createShader consolidates all of the shader compilation code
 	vertex_shader = createShader(vertShader, GL_VERTEX_SHADER);
 	fragment_shader = createShader(fragShader, GL_FRAGMENT_SHADER);
 	// Compile the compute sahder like any other shader
 	compute_shader = createShader(computeShader, GL_COMPUTE_SHADER);
+	xpbd_shader = createShader(xpbdShader, GL_COMPUTE_SHADER);
 
 	program = glCreateProgram();
 	glAttachShader(program, vertex_shader);		// This attaches our vertex shader to our program.
@@ -206,6 +258,10 @@ void init()
 	glAttachShader(computeProgram, compute_shader);
 	glLinkProgram(computeProgram);
 
+	xpbdProgram = glCreateProgram();
+	glAttachShader(xpbdProgram, xpbd_shader);
+	glLinkProgram(xpbdProgram);
+
 	//get the pointers to the uniform variables
 	uniVP = glGetUniformLocation(program, "VP");
 
@@ -280,13 +336,189 @@ void setup()
 	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, velBuf[1]);
 	glBufferData(GL_SHADER_STORAGE_BUFFER, velocity.size() * sizeof(GLfloat), NULL, GL_DYNAMIC_COPY);
 
+	//The XPBD shader keeps each particle's inverse mass next to its previous position, 0 for the pinned particles
+	std::vector<GLfloat> previous(positions);
+	for (int i = 0; i < NUMBER_OF_PARTICLES_Y; i++)
+	{
+		for (int j = 0; j < NUMBER_OF_PARTICLES_X; j++)
+		{
+			bool pinned = i == NUMBER_OF_PARTICLES_Y - 1 && (j % 10 == 0 || j == NUMBER_OF_PARTICLES_X - 1);
+			previous[(i * NUMBER_OF_PARTICLES_X + j) * 4 + 3] = pinned ? 0.0f : 1.0f / particleMass;
+		}
+	}
+
+	glGenBuffers(1, &prevBuf);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, prevBuf);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, previous.size() * sizeof(GLfloat), &previous[0], GL_DYNAMIC_COPY);
+
+	//One constraint to the right of and one above every particle
+	std::vector<Constraint> constraints;
+	for (int i = 0; i < NUMBER_OF_PARTICLES_Y; i++)
+	{
+		for (int j = 0; j < NUMBER_OF_PARTICLES_X; j++)
+		{
+			GLuint index = i * NUMBER_OF_PARTICLES_X + j;
+			if (j < NUMBER_OF_PARTICLES_X - 1)
+			{
+				Constraint c = { index, index + 1, horizontalRest, 0.0f };
+				constraints.push_back(c);
+			}
+			if (i < NUMBER_OF_PARTICLES_Y - 1)
+			{
+				Constraint c = { index, index + NUMBER_OF_PARTICLES_X, verticalRest, 0.0f };
+				constraints.push_back(c);
+			}
+		}
+	}
+	numConstraints = constraints.size();
+
+	//Give each constraint the lowest color neither of its particles has yet, then sort the constraints by color
+	std::vector<std::vector<GLuint> > particleColors(NUMBER_OF_PARTICLES);
+	std::vector<GLuint> colors(numConstraints);
+	cpuCloth = new ClothCPU(NUMBER_OF_PARTICLES_X, NUMBER_OF_PARTICLES_Y, &positions[0], &velocity[0]);
+	cpuCloth->RestLengthHoriz = horizontalRest;
+	cpuCloth->RestLengthVert = verticalRest;
+	cpuCloth->RestLengthDiag = DiagonalRest;
+	cpuPositions.resize(positions.size());
+
+	GLuint numColors = 0;
+	for (GLuint c = 0; c < numConstraints; c++)
+	{
+		std::vector<GLuint>& usedI = particleColors[constraints[c].i];
+		std::vector<GLuint>& usedJ = particleColors[constraints[c].j];
+
+		GLuint color = 0;
+		while (std::find(usedI.begin(), usedI.end(), color) != usedI.end() || std::find(usedJ.begin(), usedJ.end(), color) != usedJ.end())
+			color++;
+
+		colors[c] = color;
+		usedI.push_back(color);
+		usedJ.push_back(color);
+		if (color + 1 > numColors) numColors = color + 1;
+	}
+
+	colorStart.assign(numColors + 1, 0);
+	for (GLuint c = 0; c < numConstraints; c++)
+		colorStart[colors[c] + 1]++;
+	for (GLuint color = 0; color < numColors; color++)
+		colorStart[color + 1] += colorStart[color];
+
+	std::vector<Constraint> sorted(numConstraints);
+	std::vector<GLuint> next(colorStart.begin(), colorStart.end() - 1);
+	for (GLuint c = 0; c < numConstraints; c++)
+		sorted[next[colors[c]]++] = constraints[c];
+
+	glGenBuffers(1, &constraintBuf);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, constraintBuf);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sorted.size() * sizeof(Constraint), &sorted[0], GL_DYNAMIC_COPY);
 }
 
 // Functions called between every frame. game logic
 #pragma region util_functions
+
+//Dispatches enough 64 wide work groups to cover count invocations
+void dispatch(GLuint count)
+{
+	glDispatchCompute((count + 63) / 64, 1, 1);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+// Steps the cloth once with XPBD. Each substep is a predict dispatch, a dispatch per color for every iteration,
+// and a velocity dispatch. The explicit update leaves the current state in posBuf[0] and velBuf[0], and so does this.
+void updateXPBD()
+{
+	float h = xpbdStep / xpbdSubsteps;
+
+	glUseProgram(xpbdProgram);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, posBuf[0]);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, velBuf[0]);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, prevBuf);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, constraintBuf);
+
+	glUniform1ui(glGetUniformLocation(xpbdProgram, "NumParticles"), NUMBER_OF_PARTICLES);
+	glUniform1ui(glGetUniformLocation(xpbdProgram, "NumConstraints"), numConstraints);
+	glUniform3fv(glGetUniformLocation(xpbdProgram, "externalForce"), 1, (float*) &externalForce);
+	glUniform1f(glGetUniformLocation(xpbdProgram, "deltaT"), h);
+	glUniform1f(glGetUniformLocation(xpbdProgram, "Compliance"), 1.0f / springK);
+
+	GLint stage = glGetUniformLocation(xpbdProgram, "Stage");
+	GLint colorOffset = glGetUniformLocation(xpbdProgram, "ColorOffset");
+	GLint colorCount = glGetUniformLocation(xpbdProgram, "ColorCount");
+
+	for (int substep = 0; substep < xpbdSubsteps; substep++)
+	{
+		glUniform1i(stage, 0);
+		dispatch(numConstraints > NUMBER_OF_PARTICLES ? numConstraints : NUMBER_OF_PARTICLES);
+
+		glUniform1i(stage, 1);
+		for (int iteration = 0; iteration < xpbdIterations; iteration++)
+		{
+			for (GLuint color = 0; color + 1 < colorStart.size(); color++)
+			{
+				glUniform1ui(colorOffset, colorStart[color]);
+				glUniform1ui(colorCount, colorStart[color + 1] - colorStart[color]);
+				dispatch(colorStart[color + 1] - colorStart[color]);
+			}
+		}
+
+		glUniform1i(stage, 2);
+		dispatch(NUMBER_OF_PARTICLES);
+	}
+}
+
+// Runs the same 1000 explicit steps as update() on the CPU and copies the positions into posBuf[0] to be drawn.
+// Without compute shaders, setup() could not give posBuf[0] any storage as a shader storage buffer, so the
+// positions are sent with glBufferData as an array buffer instead, which works on any version of OpenGL.
+void updateCPU()
+{
+	cpuCloth->externalForce = externalForce;
+	cpuCloth->Dispatch(1000);
+
+	cpuCloth->GetPositions(&cpuPositions[0]);
+	glBindBuffer(GL_ARRAY_BUFFER, posBuf[0]);
+	glBufferData(GL_ARRAY_BUFFER, cpuPositions.size() * sizeof(GLfloat), &cpuPositions[0], GL_DYNAMIC_DRAW);
+}
+
+// Moves the cloth between the CPU and the GPU, copying the current positions and velocities across
+void switchBackend()
+{
+	std::vector<GLfloat> velocities(cpuPositions.size());
+	if (!useCPU)
+	{
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, posBuf[0]);
+		glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, cpuPositions.size() * sizeof(GLfloat), &cpuPositions[0]);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, velBuf[0]);
+		glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, velocities.size() * sizeof(GLfloat), &velocities[0]);
+		cpuCloth->SetState(&cpuPositions[0], &velocities[0]);
+	}
+	else
+	{
+		cpuCloth->GetVelocities(&velocities[0]);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, velBuf[0]);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, velocities.size() * sizeof(GLfloat), &velocities[0]);
+	}
+
+	useCPU = !useCPU;
+	printf("\nRunning on the:\t%s\n", useCPU ? "CPU" : "GPU");
+	if (useXPBD)
+		printf("Integration:\t%s\n", useCPU ? "Explicit (XPBD is not available on the CPU)" : "XPBD");
+}
+
 // This runs once every physics timestep.
 void update()
 {
+	if (useCPU)
+	{
+		updateCPU();
+		return;
+	}
+
+	if (useXPBD)
+	{
+		updateXPBD();
+		return;
+	}
+
 	GLuint readBuffer = 0;
 	
 	//Use the program, compute shader is linked to and set the uniform values.
@@ -353,7 +585,48 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 	}
 	if (key == GLFW_KEY_SPACE && (action == GLFW_RELEASE))
 		externalForce = glm::vec3(0);
-	
+
+	if (action == GLFW_PRESS)
+	{
+		if (key == GLFW_KEY_C)
+		{
+			if (hasComputeShaders)
+				switchBackend();
+			else
+				printf("\nCompute shaders are not supported, the cloth can only run on the CPU\n");
+		}
+		else if (key == GLFW_KEY_X)
+		{
+			//XPBD only exists as a compute shader, ClothCPU has just the explicit update
+			if (useCPU)
+				printf("\nXPBD is not available on the CPU, press C to run on the GPU first\n");
+			else
+			{
+				useXPBD = !useXPBD;
+				printf("\nIntegration:\t%s\n", useXPBD ? "XPBD" : "Explicit");
+			}
+		}
+		else if (key == GLFW_KEY_RIGHT)
+		{
+			xpbdIterations++;
+			printf("\nXPBD iterations:\t%d\n", xpbdIterations);
+		}
+		else if (key == GLFW_KEY_LEFT && xpbdIterations > 1)
+		{
+			xpbdIterations--;
+			printf("\nXPBD iterations:\t%d\n", xpbdIterations);
+		}
+		else if (key == GLFW_KEY_UP)
+		{
+			xpbdSubsteps++;
+			printf("\nXPBD substeps:\t%d\n", xpbdSubsteps);
+		}
+		else if (key == GLFW_KEY_DOWN && xpbdSubsteps > 1)
+		{
+			xpbdSubsteps--;
+			printf("\nXPBD substeps:\t%d\n", xpbdSubsteps);
+		}
+	}
 }
 
 #pragma endregion Helper_functions
@@ -418,9 +691,22 @@ void main()
 	std::cout << glGetString(GL_VERSION);
 
 	setup();
+
+	hasComputeShaders = GLEW_VERSION_4_3 || GLEW_ARB_compute_shader;
+	if (!hasComputeShaders)
+	{
+		printf("\nCompute shaders are not supported, running the cloth on the CPU\n");
+		useCPU = true;
+	}
 	// Sends the funtion as a funtion pointer along with the window to which it should be applied to.
 	glfwSetKeyCallback(window, key_callback);
 
+	printf("\nControls:\nHold Space to blow wind at the cloth\n");
+	printf("Press X to switch between explicit and XPBD integration (XPBD runs on the GPU only)\n");
+	printf("Press C to switch between running the explicit update on the GPU and the CPU\n");
+	printf("Press Left and Right to change the number of XPBD iterations\n");
+	printf("Press Up and Down to change the number of XPBD substeps\n");
+
 	// Enter the main loop.
 	while (!glfwWindowShouldClose(window))
 	{
@@ -442,6 +728,7 @@ void main()
 	glDeleteShader(vertex_shader);
 	glDeleteShader(fragment_shader);
 	glDeleteProgram(program);
+	delete cpuCloth;
 	// Note: If at any point you stop using a "program" or shaders, you should free the data up then and there.
 
 
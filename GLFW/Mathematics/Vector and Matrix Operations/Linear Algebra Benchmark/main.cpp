@@ -0,0 +1,899 @@
+/*
+Title: Linear Algebra Benchmark
+File Name: main.cpp
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+The examples do their math in one of several ways: with the Vector_ and Matrix_ functions on arrays of floats, with
+the same functions on Vector and Matrix structs whose results are allocated as they are needed, with the fixed size
+FixedVector and FixedMatrix templates, with MatrixBatch on many matrices at once, or with glm. This program times
+each way doing the same operations on the same operands, so there is data for choosing which one to use in a hot loop:
+
+	- dot: the dot product of two vectors
+	- cross: the cross product of dimension - 1 vectors (the rows of a matrix)
+	- normalize: a copy of a vector scaled to a magnitude of 1
+	- product: the product of two matrices
+	- transform: the product of a matrix and a vector
+	- determinant: the determinant of a matrix
+	- inverse: the inverse of a matrix
+	- transpose: the transpose of a matrix
+
+on dimensions from 2 up to 1024. The ways, or paths, are:
+
+	- array: Vector_*Array and Matrix_*Array, writing straight into the results
+	- struct: the Vector and Matrix functions, allocating a new Vector or Matrix for each result, copying the result
+	  out and freeing it, the way most of the examples make their temporaries
+	- arena: the same, but taking each new Vector or Matrix from an Arena instead of allocating it
+	- fixed: FixedVector and FixedMatrix, for dimensions 2 to 4 (and 3 for the cross product)
+	- batch: MatrixBatch on every operand at once, for the products, transforms and inverses of dimensions 3 and 4
+	- glm: glm::vec and glm::mat, for dimensions 2 to 4 (and 3 for the cross product)
+
+The general cross product takes dimension determinants of dimension - 1 sized matrices, so it is only timed up to
+CROSS_MAX_DIMENSION.
+
+Each row of the output reports the nanoseconds one operation takes, the number of times one operation calls malloc,
+and the largest difference from the results of the array path, relative to the largest of those results. Every path
+is run over enough operands to fill a few tens of kilobytes, so the small dimensions are timed over thousands of
+operations, and each run is repeated until it has taken at least a tenth of a second. The allocations counted are
+the two mallocs of every Vector_Allocate and Vector_Initialize (or Matrix_Allocate and Matrix_Initialize) pair, and
+every block an arena allocates while timing; these are the only places the Vector and Matrix libraries allocate
+memory.
+
+glm stores its matrices column by column, so the operands are read by glm as their transposes. The glm path
+multiplies in the reverse order (B * A, v * M) to get the same results, and the inverse and transpose come out the
+same either way.
+
+The program is compiled with AVX2. It takes one optional argument: the file to write the CSV to. Run it with
+Release settings.
+
+References:
+glm by G-Truc Creation
+*/
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <chrono>
+#endif
+
+#include "glm/glm.hpp"
+
+#include "Matrix.h"
+#include "Vector.h"
+#include "Arena.h"
+#include "FixedMatrix.h"
+#include "MatrixBatch.h"
+
+// Each run is repeated until it has been timed for at least this long
+#define MIN_SECONDS 0.1
+#define MIN_REPEATS 3
+
+// Each run does enough operations for its operand matrices to hold about this many floats
+#define OPERAND_FLOATS 16384
+
+#define MAX_DIMENSION 1024
+#define CROSS_MAX_DIMENSION 128
+
+// The standard clocks in Visual Studio 2013 only tick once a millisecond, so the performance counter is used there
+double GetSeconds()
+{
+#ifdef _WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+enum Operation
+{
+	DOT,
+	CROSS,
+	NORMALIZE,
+	PRODUCT,
+	TRANSFORM,
+	DETERMINANT,
+	INVERSE,
+	TRANSPOSE,
+	NUM_OPERATIONS
+};
+
+enum Path
+{
+	PATH_ARRAY,
+	PATH_STRUCT,
+	PATH_ARENA,
+	PATH_FIXED,
+	PATH_BATCH,
+	PATH_GLM,
+	NUM_PATHS
+};
+
+///
+//Everything one run of an operation works on, for one dimension
+struct Operands
+{
+	uint16_t dim;
+	uint32_t count;				//The number of operations in one run
+
+	float* vectors1;			//count vectors of dim floats
+	float* vectors2;
+	float* matrices1;			//count matrices of dim * dim floats, row after row
+	float* matrices2;
+	float* results;				//Room for count matrices
+	float** crossVectors;		//dim - 1 pointers to the vectors of one cross product
+
+	//The operands as Vector and Matrix structs
+	Vector* vectorViews1;
+	Vector* vectorViews2;
+	Matrix* matrixViews1;
+	Matrix* matrixViews2;
+
+	//Where the struct path takes its temporaries from, 0x0 to allocate them
+	Arena* arena;
+
+	//The operands as batches, for dimensions 3 and 4
+	MatrixBatch* batch1;
+	MatrixBatch* batch2;
+	MatrixBatch* batchResult;
+	VectorBatch* vectorBatch;
+	VectorBatch* vectorBatchResult;
+};
+
+typedef void(*Benchmark)(Operands* operands);
+
+// The number of mallocs the struct path has made
+unsigned long allocations = 0;
+
+///
+//Makes a new vector for a result, from the operands' arena if they have one
+Vector* NewVector(Operands* operands, uint16_t dim)
+{
+	Vector* vec;
+	if (operands->arena != 0x0)
+	{
+		vec = (Vector*)Arena_Push(operands->arena, sizeof(Vector));
+		Vector_InitializeFromArena(vec, dim, operands->arena);
+	}
+	else
+	{
+		vec = Vector_Allocate();
+		Vector_Initialize(vec, dim);
+		allocations += 2;
+	}
+	return vec;
+}
+
+///
+//Frees a vector from NewVector, or releases everything taken from the operands' arena
+void DeleteVector(Operands* operands, Vector* vec)
+{
+	if (operands->arena != 0x0) Arena_Reset(operands->arena);
+	else Vector_Free(vec);
+}
+
+///
+//Makes a new matrix for a result, from the operands' arena if they have one
+Matrix* NewMatrix(Operands* operands, uint16_t numRows, uint16_t numCols)
+{
+	Matrix* mat;
+	if (operands->arena != 0x0)
+	{
+		mat = (Matrix*)Arena_Push(operands->arena, sizeof(Matrix));
+		Matrix_InitializeFromArena(mat, numRows, numCols, operands->arena);
+	}
+	else
+	{
+		mat = Matrix_Allocate();
+		Matrix_Initialize(mat, numRows, numCols);
+		allocations += 2;
+	}
+	return mat;
+}
+
+///
+//Frees a matrix from NewMatrix, or releases everything taken from the operands' arena
+void DeleteMatrix(Operands* operands, Matrix* mat)
+{
+	if (operands->arena != 0x0) Arena_Reset(operands->arena);
+	else Matrix_Free(mat);
+}
+
+unsigned long CountArenaBlocks(const Arena* arena)
+{
+	unsigned long blocks = 0;
+	if (arena == 0x0) return blocks;
+	for (const ArenaBlock* block = arena->first; block != 0x0; block = block->next) ++blocks;
+	return blocks;
+}
+
+// The array path
+
+void ArrayDot(Operands* o)
+{
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		o->results[i] = Vector_DotProductArray(o->vectors1 + i * o->dim, o->vectors2 + i * o->dim, o->dim);
+	}
+}
+
+void ArrayCross(Operands* o)
+{
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		for (int j = 0; j < o->dim - 1; ++j) o->crossVectors[j] = o->matrices1 + (i * o->dim + j) * o->dim;
+		Vector_CrossProductArray(o->results + i * o->dim, o->dim, o->crossVectors);
+	}
+}
+
+void ArrayNormalize(Operands* o)
+{
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		Vector_CopyArray(o->results + i * o->dim, o->vectors1 + i * o->dim, o->dim);
+		Vector_NormalizeArray(o->results + i * o->dim, o->dim);
+	}
+}
+
+void ArrayProduct(Operands* o)
+{
+	unsigned int size = o->dim * o->dim;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		Matrix_GetProductMatrixArray(o->results + i * size, o->matrices1 + i * size, o->matrices2 + i * size, o->dim, o->dim, o->dim);
+	}
+}
+
+void ArrayTransform(Operands* o)
+{
+	unsigned int size = o->dim * o->dim;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		Matrix_GetProductVectorArray(o->results + i * o->dim, o->matrices1 + i * size, o->vectors1 + i * o->dim, o->dim, o->dim);
+	}
+}
+
+void ArrayDeterminant(Operands* o)
+{
+	unsigned int size = o->dim * o->dim;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		o->results[i] = Matrix_GetDeterminateArray(o->matrices1 + i * size, o->dim, o->dim);
+	}
+}
+
+void ArrayInverse(Operands* o)
+{
+	unsigned int size = o->dim * o->dim;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		Matrix_GetInverseArray(o->results + i * size, o->matrices1 + i * size, o->dim, o->dim);
+	}
+}
+
+void ArrayTranspose(Operands* o)
+{
+	unsigned int size = o->dim * o->dim;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		Matrix_GetTransposeArray(o->results + i * size, o->matrices1 + i * size, o->dim, o->dim);
+	}
+}
+
+// The struct path, which is also the arena path when the operands have an arena
+
+void StructDot(Operands* o)
+{
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		o->results[i] = Vector_DotProduct(o->vectorViews1 + i, o->vectorViews2 + i);
+	}
+}
+
+// Vector_CrossProduct takes its vectors as arguments, so this is only timed for the dimensions listed here
+void StructCross(Operands* o)
+{
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		Vector rows[3];
+		for (int j = 0; j < o->dim - 1; ++j)
+		{
+			rows[j].dimension = o->dim;
+			rows[j].components = o->matrices1 + (i * o->dim + j) * o->dim;
+		}
+
+		Vector* cross = NewVector(o, o->dim);
+		switch (o->dim)
+		{
+		case 2: Vector_CrossProduct(cross, rows); break;
+		case 3: Vector_CrossProduct(cross, rows, rows + 1); break;
+		case 4: Vector_CrossProduct(cross, rows, rows + 1, rows + 2); break;
+		}
+		Vector_CopyArray(o->results + i * o->dim, cross->components, o->dim);
+		DeleteVector(o, cross);
+	}
+}
+
+void StructNormalize(Operands* o)
+{
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		Vector* normal = NewVector(o, o->dim);
+		Vector_Copy(normal, o->vectorViews1 + i);
+		Vector_Normalize(normal);
+		Vector_CopyArray(o->results + i * o->dim, normal->components, o->dim);
+		DeleteVector(o, normal);
+	}
+}
+
+void StructProduct(Operands* o)
+{
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		Matrix* product = NewMatrix(o, o->dim, o->dim);
+		Matrix_GetProductMatrix(product, o->matrixViews1 + i, o->matrixViews2 + i);
+		Matrix_CopyArray(o->results + i * o->dim * o->dim, product->components, o->dim, o->dim);
+		DeleteMatrix(o, product);
+	}
+}
+
+void StructTransform(Operands* o)
+{
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		Vector* product = NewVector(o, o->dim);
+		Matrix_GetProductVector(product, o->matrixViews1 + i, o->vectorViews1 + i);
+		Vector_CopyArray(o->results + i * o->dim, product->components, o->dim);
+		DeleteVector(o, product);
+	}
+}
+
+void StructDeterminant(Operands* o)
+{
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		o->results[i] = Matrix_GetDeterminate(o->matrixViews1 + i);
+	}
+}
+
+void StructInverse(Operands* o)
+{
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		Matrix* inverse = NewMatrix(o, o->dim, o->dim);
+		Matrix_GetInverse(inverse, o->matrixViews1 + i);
+		Matrix_CopyArray(o->results + i * o->dim * o->dim, inverse->components, o->dim, o->dim);
+		DeleteMatrix(o, inverse);
+	}
+}
+
+void StructTranspose(Operands* o)
+{
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		Matrix* transpose = NewMatrix(o, o->dim, o->dim);
+		Matrix_GetTranspose(transpose, o->matrixViews1 + i);
+		Matrix_CopyArray(o->results + i * o->dim * o->dim, transpose->components, o->dim, o->dim);
+		DeleteMatrix(o, transpose);
+	}
+}
+
+// The fixed path. The operands are read in place, since a FixedVector or FixedMatrix is just its components.
+
+template <uint16_t N>
+void FixedDot(Operands* o)
+{
+	const FixedVector<N>* vectors1 = (const FixedVector<N>*)o->vectors1;
+	const FixedVector<N>* vectors2 = (const FixedVector<N>*)o->vectors2;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		o->results[i] = vectors1[i].DotProduct(vectors2[i]);
+	}
+}
+
+void FixedCross(Operands* o)
+{
+	const FixedVector<3>* rows = (const FixedVector<3>*)o->matrices1;
+	FixedVector<3>* results = (FixedVector<3>*)o->results;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		results[i] = FixedVector_CrossProduct(rows[i * 3], rows[i * 3 + 1]);
+	}
+}
+
+template <uint16_t N>
+void FixedNormalize(Operands* o)
+{
+	const FixedVector<N>* vectors = (const FixedVector<N>*)o->vectors1;
+	FixedVector<N>* results = (FixedVector<N>*)o->results;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		results[i] = vectors[i];
+		results[i].Normalize();
+	}
+}
+
+template <uint16_t N>
+void FixedProduct(Operands* o)
+{
+	const FixedMatrix<N, N>* matrices1 = (const FixedMatrix<N, N>*)o->matrices1;
+	const FixedMatrix<N, N>* matrices2 = (const FixedMatrix<N, N>*)o->matrices2;
+	FixedMatrix<N, N>* results = (FixedMatrix<N, N>*)o->results;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		results[i] = matrices1[i] * matrices2[i];
+	}
+}
+
+template <uint16_t N>
+void FixedTransform(Operands* o)
+{
+	const FixedMatrix<N, N>* matrices = (const FixedMatrix<N, N>*)o->matrices1;
+	const FixedVector<N>* vectors = (const FixedVector<N>*)o->vectors1;
+	FixedVector<N>* results = (FixedVector<N>*)o->results;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		results[i] = matrices[i] * vectors[i];
+	}
+}
+
+template <uint16_t N>
+void FixedDeterminant(Operands* o)
+{
+	const FixedMatrix<N, N>* matrices = (const FixedMatrix<N, N>*)o->matrices1;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		o->results[i] = matrices[i].GetDeterminate();
+	}
+}
+
+template <uint16_t N>
+void FixedInverse(Operands* o)
+{
+	const FixedMatrix<N, N>* matrices = (const FixedMatrix<N, N>*)o->matrices1;
+	FixedMatrix<N, N>* results = (FixedMatrix<N, N>*)o->results;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		matrices[i].GetInverse(results + i);
+	}
+}
+
+template <uint16_t N>
+void FixedTranspose(Operands* o)
+{
+	const FixedMatrix<N, N>* matrices = (const FixedMatrix<N, N>*)o->matrices1;
+	FixedMatrix<N, N>* results = (FixedMatrix<N, N>*)o->results;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		results[i] = matrices[i].GetTranspose();
+	}
+}
+
+template <uint16_t N>
+Benchmark GetFixedBenchmark(Operation operation)
+{
+	switch (operation)
+	{
+	case DOT: return FixedDot<N>;
+	case CROSS: return N == 3 ? FixedCross : 0x0;
+	case NORMALIZE: return FixedNormalize<N>;
+	case PRODUCT: return FixedProduct<N>;
+	case TRANSFORM: return FixedTransform<N>;
+	case DETERMINANT: return FixedDeterminant<N>;
+	case INVERSE: return FixedInverse<N>;
+	case TRANSPOSE: return FixedTranspose<N>;
+	default: return 0x0;
+	}
+}
+
+// The batch path. The results are copied out of the result batches after timing.
+
+void BatchProduct(Operands* o)
+{
+	MatrixBatch_GetProduct(o->batchResult, o->batch1, o->batch2);
+}
+
+void BatchTransform(Operands* o)
+{
+	MatrixBatch_TransformVectors(o->vectorBatchResult, o->batch1, o->vectorBatch);
+}
+
+void BatchInverse(Operands* o)
+{
+	MatrixBatch_GetInverse(o->batchResult, o->batch1);
+}
+
+// The glm path
+
+template <uint16_t N> struct Glm;
+template <> struct Glm<2> { typedef glm::vec2 Vector; typedef glm::mat2 Matrix; };
+template <> struct Glm<3> { typedef glm::vec3 Vector; typedef glm::mat3 Matrix; };
+template <> struct Glm<4> { typedef glm::vec4 Vector; typedef glm::mat4 Matrix; };
+
+template <uint16_t N>
+void GlmDot(Operands* o)
+{
+	const typename Glm<N>::Vector* vectors1 = (const typename Glm<N>::Vector*)o->vectors1;
+	const typename Glm<N>::Vector* vectors2 = (const typename Glm<N>::Vector*)o->vectors2;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		o->results[i] = glm::dot(vectors1[i], vectors2[i]);
+	}
+}
+
+void GlmCross(Operands* o)
+{
+	const glm::vec3* rows = (const glm::vec3*)o->matrices1;
+	glm::vec3* results = (glm::vec3*)o->results;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		results[i] = glm::cross(rows[i * 3], rows[i * 3 + 1]);
+	}
+}
+
+template <uint16_t N>
+void GlmNormalize(Operands* o)
+{
+	const typename Glm<N>::Vector* vectors = (const typename Glm<N>::Vector*)o->vectors1;
+	typename Glm<N>::Vector* results = (typename Glm<N>::Vector*)o->results;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		results[i] = glm::normalize(vectors[i]);
+	}
+}
+
+template <uint16_t N>
+void GlmProduct(Operands* o)
+{
+	const typename Glm<N>::Matrix* matrices1 = (const typename Glm<N>::Matrix*)o->matrices1;
+	const typename Glm<N>::Matrix* matrices2 = (const typename Glm<N>::Matrix*)o->matrices2;
+	typename Glm<N>::Matrix* results = (typename Glm<N>::Matrix*)o->results;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		results[i] = matrices2[i] * matrices1[i];
+	}
+}
+
+template <uint16_t N>
+void GlmTransform(Operands* o)
+{
+	const typename Glm<N>::Matrix* matrices = (const typename Glm<N>::Matrix*)o->matrices1;
+	const typename Glm<N>::Vector* vectors = (const typename Glm<N>::Vector*)o->vectors1;
+	typename Glm<N>::Vector* results = (typename Glm<N>::Vector*)o->results;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		results[i] = vectors[i] * matrices[i];
+	}
+}
+
+template <uint16_t N>
+void GlmDeterminant(Operands* o)
+{
+	const typename Glm<N>::Matrix* matrices = (const typename Glm<N>::Matrix*)o->matrices1;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		o->results[i] = glm::determinant(matrices[i]);
+	}
+}
+
+template <uint16_t N>
+void GlmInverse(Operands* o)
+{
+	const typename Glm<N>::Matrix* matrices = (const typename Glm<N>::Matrix*)o->matrices1;
+	typename Glm<N>::Matrix* results = (typename Glm<N>::Matrix*)o->results;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		results[i] = glm::inverse(matrices[i]);
+	}
+}
+
+template <uint16_t N>
+void GlmTranspose(Operands* o)
+{
+	const typename Glm<N>::Matrix* matrices = (const typename Glm<N>::Matrix*)o->matrices1;
+	typename Glm<N>::Matrix* results = (typename Glm<N>::Matrix*)o->results;
+	for (uint32_t i = 0; i < o->count; ++i)
+	{
+		results[i] = glm::transpose(matrices[i]);
+	}
+}
+
+template <uint16_t N>
+Benchmark GetGlmBenchmark(Operation operation)
+{
+	switch (operation)
+	{
+	case DOT: return GlmDot<N>;
+	case CROSS: return N == 3 ? GlmCross : 0x0;
+	case NORMALIZE: return GlmNormalize<N>;
+	case PRODUCT: return GlmProduct<N>;
+	case TRANSFORM: return GlmTransform<N>;
+	case DETERMINANT: return GlmDeterminant<N>;
+	case INVERSE: return GlmInverse<N>;
+	case TRANSPOSE: return GlmTranspose<N>;
+	default: return 0x0;
+	}
+}
+
+///
+//Gets the function which times an operation along a path, or 0x0 if the path can not do that operation on that dimension
+Benchmark GetBenchmark(Path path, Operation operation, uint16_t dim)
+{
+	if (operation == CROSS && dim > CROSS_MAX_DIMENSION) return 0x0;
+
+	const Benchmark arrayBenchmarks[NUM_OPERATIONS] = { ArrayDot, ArrayCross, ArrayNormalize, ArrayProduct, ArrayTransform, ArrayDeterminant, ArrayInverse, ArrayTranspose };
+	const Benchmark structBenchmarks[NUM_OPERATIONS] = { StructDot, StructCross, StructNormalize, StructProduct, StructTransform, StructDeterminant, StructInverse, StructTranspose };
+
+	switch (path)
+	{
+	case PATH_ARRAY:
+		return arrayBenchmarks[operation];
+	case PATH_STRUCT:
+		if (operation == CROSS && dim > 4) return 0x0;
+		return structBenchmarks[operation];
+	case PATH_ARENA:
+		// The dot product and determinant make no temporaries, so they would be the same as the struct path
+		if (operation == DOT || operation == DETERMINANT || (operation == CROSS && dim > 4)) return 0x0;
+		return structBenchmarks[operation];
+	case PATH_FIXED:
+		if (dim == 2) return GetFixedBenchmark<2>(operation);
+		if (dim == 3) return GetFixedBenchmark<3>(operation);
+		if (dim == 4) return GetFixedBenchmark<4>(operation);
+		return 0x0;
+	case PATH_BATCH:
+		if (dim != 3 && dim != 4) return 0x0;
+		if (operation == PRODUCT) return BatchProduct;
+		if (operation == TRANSFORM) return BatchTransform;
+		if (operation == INVERSE) return BatchInverse;
+		return 0x0;
+	case PATH_GLM:
+		if (dim == 2) return GetGlmBenchmark<2>(operation);
+		if (dim == 3) return GetGlmBenchmark<3>(operation);
+		if (dim == 4) return GetGlmBenchmark<4>(operation);
+		return 0x0;
+	default:
+		return 0x0;
+	}
+}
+
+///
+//Gets the number of floats an operation's results take up
+unsigned int GetResultCount(Operation operation, const Operands* operands)
+{
+	switch (operation)
+	{
+	case DOT:
+	case DETERMINANT:
+		return operands->count;
+	case CROSS:
+	case NORMALIZE:
+	case TRANSFORM:
+		return operands->count * operands->dim;
+	default:
+		return operands->count * operands->dim * operands->dim;
+	}
+}
+
+///
+//Copies the results of the batch path out of its result batches
+void CopyBatchResults(Operation operation, Operands* operands)
+{
+	unsigned int size = operands->dim * operands->dim;
+	for (uint32_t i = 0; i < operands->count; ++i)
+	{
+		if (operation == TRANSFORM) VectorBatch_GetVectorArray(operands->results + i * operands->dim, operands->vectorBatchResult, i);
+		else MatrixBatch_GetMatrixArray(operands->results + i * size, operands->batchResult, i);
+	}
+}
+
+///
+//Times one operation along one path, returning the seconds a single operation takes
+//
+//Parameters:
+//	benchmark: The function doing a run of the operation
+//	operands: The operands of the run
+//	allocationsPerOperation: Set to the number of mallocs a single operation makes
+double Time(Benchmark benchmark, Operands* operands, double* allocationsPerOperation)
+{
+	// The first run grows the arenas to the most this operation needs, and is not counted
+	benchmark(operands);
+
+	Arena* scratch = Arena_GetScratch();
+	unsigned long startAllocations = allocations + CountArenaBlocks(scratch) + CountArenaBlocks(operands->arena);
+
+	int repeats = 0;
+	double start = GetSeconds();
+	double seconds = 0.0;
+	while (repeats < MIN_REPEATS || seconds < MIN_SECONDS)
+	{
+		benchmark(operands);
+		++repeats;
+		seconds = GetSeconds() - start;
+	}
+
+	unsigned long endAllocations = allocations + CountArenaBlocks(scratch) + CountArenaBlocks(operands->arena);
+	*allocationsPerOperation = (double)(endAllocations - startAllocations) / ((double)repeats * operands->count);
+	return seconds / ((double)repeats * operands->count);
+}
+
+///
+//Gets the largest difference between two sets of results, relative to the largest of the reference results.
+//The operands are random, so some of the matrices are nearly singular and have very large inverses.
+float MaxRelativeDifference(const float* reference, const float* results, unsigned int count)
+{
+	float difference = 0.0f;
+	float largest = 0.0f;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		float d = fabsf(reference[i] - results[i]);
+		if (d > difference) difference = d;
+		if (fabsf(reference[i]) > largest) largest = fabsf(reference[i]);
+	}
+	return largest > 0.0f ? difference / largest : difference;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* fileName = argc > 1 ? argv[1] : "LinearAlgebraBenchmark.csv";
+
+	FILE* file = fopen(fileName, "w");
+	if (file == 0)
+	{
+		printf("Could not open %s for writing!\n", fileName);
+		return 1;
+	}
+
+	FILE* outputs[2] = { stdout, file };
+	for (int o = 0; o < 2; ++o)
+	{
+		fprintf(outputs[o], "operation,dimension,path,ns_per_op,allocations_per_op,max_relative_difference\n");
+	}
+
+	const char* operationNames[NUM_OPERATIONS] = { "dot", "cross", "normalize", "product", "transform", "determinant", "inverse", "transpose" };
+	const char* pathNames[NUM_PATHS] = { "array", "struct", "arena", "fixed", "batch", "glm" };
+
+	Arena* arena = Arena_Allocate();
+	Arena_Initialize(arena, ARENA_DEFAULT_BLOCK_SIZE);
+
+	const uint16_t dims[] = { 2, 3, 4, 8, 16, 32, 64, 128, 256, 512, MAX_DIMENSION };
+	const int numDims = sizeof(dims) / sizeof(dims[0]);
+
+	srand(1);
+	for (int d = 0; d < numDims; ++d)
+	{
+		Operands operands;
+		operands.dim = dims[d];
+		unsigned int size = operands.dim * operands.dim;
+		operands.count = size < OPERAND_FLOATS ? OPERAND_FLOATS / size : 1;
+
+		unsigned int vectorCount = operands.count * operands.dim;
+		unsigned int matrixCount = operands.count * size;
+		operands.vectors1 = (float*)malloc(sizeof(float) * vectorCount);
+		operands.vectors2 = (float*)malloc(sizeof(float) * vectorCount);
+		operands.matrices1 = (float*)malloc(sizeof(float) * matrixCount);
+		operands.matrices2 = (float*)malloc(sizeof(float) * matrixCount);
+		operands.results = (float*)malloc(sizeof(float) * matrixCount);
+		operands.crossVectors = (float**)malloc(sizeof(float*) * operands.dim);
+		float* reference = (float*)malloc(sizeof(float) * matrixCount);
+
+		for (unsigned int i = 0; i < vectorCount; ++i)
+		{
+			operands.vectors1[i] = (float)rand() / RAND_MAX * 2.0f - 1.0f;
+			operands.vectors2[i] = (float)rand() / RAND_MAX * 2.0f - 1.0f;
+		}
+		for (unsigned int i = 0; i < matrixCount; ++i)
+		{
+			operands.matrices1[i] = (float)rand() / RAND_MAX * 2.0f - 1.0f;
+			operands.matrices2[i] = (float)rand() / RAND_MAX * 2.0f - 1.0f;
+		}
+
+		operands.vectorViews1 = (Vector*)malloc(sizeof(Vector) * operands.count);
+		operands.vectorViews2 = (Vector*)malloc(sizeof(Vector) * operands.count);
+		operands.matrixViews1 = (Matrix*)malloc(sizeof(Matrix) * operands.count);
+		operands.matrixViews2 = (Matrix*)malloc(sizeof(Matrix) * operands.count);
+		for (uint32_t i = 0; i < operands.count; ++i)
+		{
+			operands.vectorViews1[i].dimension = operands.dim;
+			operands.vectorViews1[i].components = operands.vectors1 + i * operands.dim;
+			operands.vectorViews2[i].dimension = operands.dim;
+			operands.vectorViews2[i].components = operands.vectors2 + i * operands.dim;
+			operands.matrixViews1[i].numRows = operands.matrixViews1[i].numColumns = operands.dim;
+			operands.matrixViews1[i].components = operands.matrices1 + i * size;
+			operands.matrixViews2[i].numRows = operands.matrixViews2[i].numColumns = operands.dim;
+			operands.matrixViews2[i].components = operands.matrices2 + i * size;
+		}
+		operands.arena = 0x0;
+
+		operands.batch1 = operands.batch2 = operands.batchResult = 0x0;
+		operands.vectorBatch = operands.vectorBatchResult = 0x0;
+		if (operands.dim == 3 || operands.dim == 4)
+		{
+			operands.batch1 = MatrixBatch_Allocate();
+			operands.batch2 = MatrixBatch_Allocate();
+			operands.batchResult = MatrixBatch_Allocate();
+			operands.vectorBatch = VectorBatch_Allocate();
+			operands.vectorBatchResult = VectorBatch_Allocate();
+			MatrixBatch_Initialize(operands.batch1, operands.dim, operands.dim, operands.count);
+			MatrixBatch_Initialize(operands.batch2, operands.dim, operands.dim, operands.count);
+			MatrixBatch_Initialize(operands.batchResult, operands.dim, operands.dim, operands.count);
+			VectorBatch_Initialize(operands.vectorBatch, operands.dim, operands.count);
+			VectorBatch_Initialize(operands.vectorBatchResult, operands.dim, operands.count);
+			for (uint32_t i = 0; i < operands.count; ++i)
+			{
+				MatrixBatch_SetMatrixArray(operands.batch1, i, operands.matrices1 + i * size);
+				MatrixBatch_SetMatrixArray(operands.batch2, i, operands.matrices2 + i * size);
+				VectorBatch_SetVectorArray(operands.vectorBatch, i, operands.vectors1 + i * operands.dim);
+			}
+		}
+
+		for (int op = 0; op < NUM_OPERATIONS; ++op)
+		{
+			for (int path = 0; path < NUM_PATHS; ++path)
+			{
+				Benchmark benchmark = GetBenchmark((Path)path, (Operation)op, operands.dim);
+				if (benchmark == 0x0) continue;
+
+				operands.arena = path == PATH_ARENA ? arena : 0x0;
+				double allocationsPerOperation;
+				double seconds = Time(benchmark, &operands, &allocationsPerOperation);
+
+				// Every other path is compared against the results of the array path, which is timed first
+				unsigned int resultCount = GetResultCount((Operation)op, &operands);
+				if (path == PATH_BATCH) CopyBatchResults((Operation)op, &operands);
+				if (path == PATH_ARRAY) memcpy(reference, operands.results, sizeof(float) * resultCount);
+				for (int o = 0; o < 2; ++o)
+				{
+					fprintf(outputs[o], "%s,%u,%s,%.2f,%.2f,%g\n",
+						operationNames[op], operands.dim, pathNames[path], seconds * 1e9, allocationsPerOperation,
+						MaxRelativeDifference(reference, operands.results, resultCount));
+					fflush(outputs[o]);
+				}
+			}
+		}
+
+		if (operands.batch1 != 0x0)
+		{
+			MatrixBatch_Free(operands.batch1);
+			MatrixBatch_Free(operands.batch2);
+			MatrixBatch_Free(operands.batchResult);
+			VectorBatch_Free(operands.vectorBatch);
+			VectorBatch_Free(operands.vectorBatchResult);
+		}
+		free(operands.vectors1);
+		free(operands.vectors2);
+		free(operands.matrices1);
+		free(operands.matrices2);
+		free(operands.results);
+		free(operands.crossVectors);
+		free(operands.vectorViews1);
+		free(operands.vectorViews2);
+		free(operands.matrixViews1);
+		free(operands.matrixViews2);
+		free(reference);
+	}
+
+	Arena_Free(arena);
+	fclose(file);
+	return 0;
+}
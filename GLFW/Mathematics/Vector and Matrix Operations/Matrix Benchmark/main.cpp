@@ -0,0 +1,220 @@
+/*
+Title: Matrix Benchmark
+File Name: main.cpp
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+Matrix.cpp multiplies matrices in cache sized blocks, and with AVX2 and FMA instructions when it is compiled for
+them. This program times those products against the plain triple loop they replaced, which is kept below exactly
+as it was written, on square matrices from 4x4 up to 1024x1024:
+
+	- matrix_product: Matrix_GetProductMatrixArray against the plain triple loop
+	- matrix_product_transpose: Matrix_GetProductMatrixTransposeArray, given the right hand matrix already
+	  transposed, against the plain triple loop
+	- vector_product: Matrix_GetProductVectorArray against the plain double loop
+
+Every row reports the time of one product, how many billions of floating point operations a second that is, how
+many times faster it is than the plain loop, and the largest difference from the plain loop's result. The
+differences are not zero, since the blocked products add up the terms in a different order, but they should stay
+around the rounding error of a float times the size of the matrix.
+
+Each product is repeated until it has run for at least a tenth of a second, so the small sizes are measured
+over many repeats. The program is compiled with AVX2. It takes one optional argument: the file to write the CSV
+to. Run it with Release settings.
+
+References:
+What Every Programmer Should Know About Memory by Ulrich Drepper
+*/
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <chrono>
+#endif
+
+#include "Matrix.h"
+
+// Each product is repeated until it has been timed for at least this long
+#define MIN_SECONDS 0.1
+#define MIN_REPEATS 3
+
+// The standard clocks in Visual Studio 2013 only tick once a millisecond, so the performance counter is used there
+double GetSeconds()
+{
+#ifdef _WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+///
+//The matrix product as Matrix.cpp used to compute it, one dot product of a row and a column at a time
+void PlainProductMatrixArray(float* destMatrix, const float* LHSMatrix, const float* RHSMatrix, const uint16_t LHSNumRows, const uint16_t LHSNumCols, const uint16_t RHSNumCols)
+{
+	for (int rows = 0; rows < LHSNumRows; rows++)
+	{
+		for (int cols = 0; cols < RHSNumCols; cols++)
+		{
+			*Matrix_IndexArray(destMatrix, rows, cols, RHSNumCols) = 0.0f;
+			for (int dot = 0; dot < LHSNumCols; dot++)
+			{
+				float increment = Matrix_GetIndexArray(LHSMatrix, rows, dot, LHSNumCols) * Matrix_GetIndexArray(RHSMatrix, dot, cols, RHSNumCols);
+				*Matrix_IndexArray(destMatrix, rows, cols, RHSNumCols) += increment;
+			}
+		}
+	}
+}
+
+///
+//The matrix vector product as Matrix.cpp used to compute it
+void PlainProductVectorArray(float* destVector, const float* LHSMatrix, const float* RHSVector, const uint16_t LHSNumRows, const uint16_t LHSNumCols)
+{
+	for (int row = 0; row < LHSNumRows; row++)
+	{
+		destVector[row] = 0;
+		for (int col = 0; col < LHSNumCols; col++)
+		{
+			destVector[row] += Matrix_GetIndexArray(LHSMatrix, row, col, LHSNumCols) * RHSVector[col];
+		}
+	}
+}
+
+// The products being timed, each given the left matrix, the right matrix (or its transpose, or a vector) and the size
+enum Operation
+{
+	PLAIN_MATRIX,
+	BLOCKED_MATRIX,
+	BLOCKED_MATRIX_TRANSPOSE,
+	PLAIN_VECTOR,
+	BLOCKED_VECTOR
+};
+
+void Run(Operation operation, float* dest, const float* LHS, const float* RHS, const float* RHSTranspose, uint16_t dim)
+{
+	switch (operation)
+	{
+	case PLAIN_MATRIX: PlainProductMatrixArray(dest, LHS, RHS, dim, dim, dim); break;
+	case BLOCKED_MATRIX: Matrix_GetProductMatrixArray(dest, LHS, RHS, dim, dim, dim); break;
+	case BLOCKED_MATRIX_TRANSPOSE: Matrix_GetProductMatrixTransposeArray(dest, LHS, RHSTranspose, dim, dim, dim); break;
+	case PLAIN_VECTOR: PlainProductVectorArray(dest, LHS, RHS, dim, dim); break;
+	case BLOCKED_VECTOR: Matrix_GetProductVectorArray(dest, LHS, RHS, dim, dim); break;
+	}
+}
+
+///
+//Times one product, returning the seconds a single product takes
+double Time(Operation operation, float* dest, const float* LHS, const float* RHS, const float* RHSTranspose, uint16_t dim)
+{
+	Run(operation, dest, LHS, RHS, RHSTranspose, dim);
+
+	int repeats = 0;
+	double start = GetSeconds();
+	double seconds = 0.0;
+	while (repeats < MIN_REPEATS || seconds < MIN_SECONDS)
+	{
+		Run(operation, dest, LHS, RHS, RHSTranspose, dim);
+		++repeats;
+		seconds = GetSeconds() - start;
+	}
+	return seconds / repeats;
+}
+
+float MaxDifference(const float* a, const float* b, unsigned int count)
+{
+	float difference = 0.0f;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		float d = fabsf(a[i] - b[i]);
+		if (d > difference) difference = d;
+	}
+	return difference;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* fileName = argc > 1 ? argv[1] : "MatrixBenchmark.csv";
+
+	FILE* file = fopen(fileName, "w");
+	if (file == 0)
+	{
+		printf("Could not open %s for writing!\n", fileName);
+		return 1;
+	}
+
+	FILE* outputs[2] = { stdout, file };
+	for (int o = 0; o < 2; ++o)
+	{
+		fprintf(outputs[o], "operation,dimension,ms_plain,ms_blocked,gflops_plain,gflops_blocked,speedup,max_difference\n");
+	}
+
+	const char* names[] = { "matrix_product", "matrix_product_transpose", "vector_product" };
+	const Operation plain[] = { PLAIN_MATRIX, PLAIN_MATRIX, PLAIN_VECTOR };
+	const Operation blocked[] = { BLOCKED_MATRIX, BLOCKED_MATRIX_TRANSPOSE, BLOCKED_VECTOR };
+
+	srand(1);
+	for (unsigned int dim = 4; dim <= 1024; dim *= 2)
+	{
+		unsigned int count = dim * dim;
+		float* LHS = (float*)malloc(sizeof(float) * count);
+		float* RHS = (float*)malloc(sizeof(float) * count);
+		float* RHSTranspose = (float*)malloc(sizeof(float) * count);
+		float* plainResult = (float*)malloc(sizeof(float) * count);
+		float* blockedResult = (float*)malloc(sizeof(float) * count);
+
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			LHS[i] = (float)rand() / RAND_MAX * 2.0f - 1.0f;
+			RHS[i] = (float)rand() / RAND_MAX * 2.0f - 1.0f;
+		}
+		Matrix_CopyArray(RHSTranspose, RHS, dim, dim);
+		Matrix_TransposeArray(RHSTranspose, dim, dim);
+
+		for (int op = 0; op < 3; ++op)
+		{
+			double plainSeconds = Time(plain[op], plainResult, LHS, RHS, RHSTranspose, dim);
+			double blockedSeconds = Time(blocked[op], blockedResult, LHS, RHS, RHSTranspose, dim);
+
+			// A matrix product is dim^3 multiplies and adds, a matrix vector product dim^2
+			double flops = 2.0 * count * (plain[op] == PLAIN_VECTOR ? 1.0 : dim);
+			unsigned int resultCount = plain[op] == PLAIN_VECTOR ? dim : count;
+			for (int o = 0; o < 2; ++o)
+			{
+				fprintf(outputs[o], "%s,%u,%.4f,%.4f,%.2f,%.2f,%.2f,%g\n",
+					names[op], dim, plainSeconds * 1000.0, blockedSeconds * 1000.0,
+					flops / plainSeconds * 1e-9, flops / blockedSeconds * 1e-9, plainSeconds / blockedSeconds,
+					MaxDifference(plainResult, blockedResult, resultCount));
+				fflush(outputs[o]);
+			}
+		}
+
+		free(LHS);
+		free(RHS);
+		free(RHSTranspose);
+		free(plainResult);
+		free(blockedResult);
+	}
+
+	fclose(file);
+	return 0;
+}
@@ -0,0 +1,150 @@
+/*
+A vector whose dimension is fixed when the program is compiled. FixedVector<3> is three floats and nothing
+else: the components are stored inside the vector instead of behind a pointer, so it can live on the stack,
+be copied by value and be kept in arrays without a malloc for each vector.
+
+Since the dimension is a template argument, every loop below runs a number of times the compiler knows, and
+for the small vectors used in physics (2, 3 and 4 components) an optimizing build unrolls them completely into
+straight-line code.
+
+A FixedVector can be handed to any function of the Vector library through AsVector, which makes a Vector that
+points at its components. Copying to and from a Vector checks the dimensions and prints an error if they differ,
+the same as the library's own checked functions.
+*/
+
+#ifndef FIXEDVECTOR_H
+#define FIXEDVECTOR_H
+
+#include "Vector.h"
+#include <stdio.h>
+#include <math.h>
+
+template <uint16_t N>
+struct FixedVector
+{
+	enum { dimension = N };
+
+	float components[N];
+
+	///
+	//Makes a vector with every component set to 0
+	static FixedVector Zero()
+	{
+		FixedVector vec;
+		for (int i = 0; i < N; i++) vec.components[i] = 0.0f;
+		return vec;
+	}
+
+	///
+	//Makes a vector from an array of N floats
+	static FixedVector FromArray(const float* src)
+	{
+		FixedVector vec;
+		for (int i = 0; i < N; i++) vec.components[i] = src[i];
+		return vec;
+	}
+
+	///
+	//Makes a Vector which shares this vector's components, for calling the Vector library.
+	//The Vector must not be freed, and is only valid for as long as this vector is.
+	Vector AsVector()
+	{
+		Vector vec;
+		vec.dimension = N;
+		vec.components = components;
+		return vec;
+	}
+
+	///
+	//Copies the components of a Vector into this vector
+	//
+	//Parameters:
+	//	src: The Vector to copy, which must have N components
+	void CopyFrom(const Vector* src)
+	{
+		if (src->dimension != N)
+		{
+			printf("FixedVector::CopyFrom Failed! Vector has %d components instead of %d! Vector was not copied!\n", src->dimension, N);
+			return;
+		}
+		for (int i = 0; i < N; i++) components[i] = src->components[i];
+	}
+
+	///
+	//Copies the components of this vector into a Vector
+	//
+	//Parameters:
+	//	dest: The Vector to copy into, which must have N components
+	void CopyTo(Vector* dest) const
+	{
+		if (dest->dimension != N)
+		{
+			printf("FixedVector::CopyTo Failed! Vector has %d components instead of %d! Vector was not copied!\n", dest->dimension, N);
+			return;
+		}
+		for (int i = 0; i < N; i++) dest->components[i] = components[i];
+	}
+
+	float& operator[](int i) { return components[i]; }
+	float operator[](int i) const { return components[i]; }
+
+	FixedVector& operator+=(const FixedVector& other)
+	{
+		for (int i = 0; i < N; i++) components[i] += other.components[i];
+		return *this;
+	}
+
+	FixedVector& operator-=(const FixedVector& other)
+	{
+		for (int i = 0; i < N; i++) components[i] -= other.components[i];
+		return *this;
+	}
+
+	FixedVector& operator*=(float scaleValue)
+	{
+		for (int i = 0; i < N; i++) components[i] *= scaleValue;
+		return *this;
+	}
+
+	FixedVector operator+(const FixedVector& other) const { FixedVector sum = *this; return sum += other; }
+	FixedVector operator-(const FixedVector& other) const { FixedVector difference = *this; return difference -= other; }
+	FixedVector operator*(float scaleValue) const { FixedVector product = *this; return product *= scaleValue; }
+	FixedVector operator-() const { return *this * -1.0f; }
+
+	float DotProduct(const FixedVector& other) const
+	{
+		float dot = 0.0f;
+		for (int i = 0; i < N; i++) dot += components[i] * other.components[i];
+		return dot;
+	}
+
+	float GetMagSq() const { return DotProduct(*this); }
+	float GetMag() const { return sqrtf(GetMagSq()); }
+
+	///
+	//Scales this vector to a magnitude of 1. A vector with no magnitude is left as it is.
+	void Normalize()
+	{
+		float mag = GetMag();
+		if (mag != 0.0f) *this *= 1.0f / mag;
+	}
+};
+
+template <uint16_t N>
+FixedVector<N> operator*(float scaleValue, const FixedVector<N>& vec)
+{
+	return vec * scaleValue;
+}
+
+///
+//Determines the cross product of two vectors with 3 components
+inline FixedVector<3> FixedVector_CrossProduct(const FixedVector<3>& vec1, const FixedVector<3>& vec2)
+{
+	FixedVector<3> cross;
+	cross.components[0] = vec1.components[1] * vec2.components[2] - vec1.components[2] * vec2.components[1];
+	cross.components[1] = vec1.components[2] * vec2.components[0] - vec1.components[0] * vec2.components[2];
+	cross.components[2] = vec1.components[0] * vec2.components[1] - vec1.components[1] * vec2.components[0];
+	return cross;
+}
+
+#endif
@@ -25,7 +25,10 @@ This program was written in a C99 compatible subset of C++.
 All operations have been programmed to be scalable to any dimension.
 Operations includes the Vector operations Addition, subtraction, dot product, cross product,
 projection, and magnitude aswell as the Matrix operations multiplication, inversion, determinant calculation,
-minor calculation, row slicing, column slicing, and indexing.
+LU decomposition, solving systems of linear equations, minor calculation, row slicing, column slicing, and indexing.
+Determinants, inverses and linear solves all use an LU decomposition with partial pivoting, which takes O(n^3) time.
+Products of matrices and vectors are computed in cache sized blocks, and with AVX2 and FMA instructions when
+compiled for them (/arch:AVX2), eight components at a time.
 
 The user must press CTRL+f5 to fun the solution and have the window say open.
 Alternatively the user can click Debug->Run without debugging.
@@ -73,6 +76,17 @@ Matrix* Matrix_Allocate();
 //	mat: Matrix to initialize
 void Matrix_Initialize(Matrix* mat, const uint16_t numRows, const uint16_t numCols);
 
+///
+//Initializes a matrix with components taken from an arena, and sets it as an identity matrix if it is square.
+//The matrix must not be freed with Matrix_Free; its components are released when the arena is reset.
+//
+//Parameters:
+//	mat: Matrix to initialize
+//	numRows: The number of rows in the matrix
+//	numCols: The number of columns in the matrix
+//	arena: The arena to take the components from
+void Matrix_InitializeFromArena(Matrix* mat, const uint16_t numRows, const uint16_t numCols, Arena* arena);
+
 
 ///
 //Frees a matrix's resources
@@ -246,6 +260,60 @@ void Matrix_GetInverseArray(float* dest, const float* matrix, const uint16_t num
 //Checks for errors, then calls Matrix_GetInverseArray
 void Matrix_GetInverse(Matrix* dest, const Matrix* matrix);
 
+///
+//Factors a square matrix in array form into a lower and an upper triangular matrix with partial pivoting, so that
+//the matrix with its rows reordered by the pivots is equal to L * U.
+//The factorization is stored over the matrix: U on and above the diagonal, and L below it.
+//The diagonal of L is all ones and is not stored.
+//
+//Parameters:
+//	mat: The matrix to factor, replaced by its factorization
+//	pivots: An array of dim indices to store the row order in. Row i of the factorization came from row pivots[i] of the matrix.
+//	dim: The number of rows and columns in the matrix
+//
+//Returns:
+//	1 or -1 if an even or odd number of rows were swapped, or 0 if the matrix is singular
+int Matrix_LUDecomposeArray(float* mat, uint16_t* pivots, const uint16_t dim);
+//Checks for errors then calls Matrix_LUDecomposeArray
+int Matrix_LUDecompose(Matrix* mat, uint16_t* pivots);
+
+///
+//Solves the system of equations A * x = b in place using the LU factorization of A
+//
+//Parameters:
+//	vector: The right hand side b, replaced by the solution x
+//	LU: The factorization of A from Matrix_LUDecomposeArray
+//	pivots: The row order from Matrix_LUDecomposeArray
+//	dim: The number of rows and columns in A
+void Matrix_LUSolveArray(float* vector, const float* LU, const uint16_t* pivots, const uint16_t dim);
+//Checks for errors then calls Matrix_LUSolveArray
+void Matrix_LUSolve(Vector* vector, const Matrix* LU, const uint16_t* pivots);
+
+///
+//Calculates the inverse of a matrix from its LU factorization by solving for each column of the identity matrix
+//
+//Parameters:
+//	dest: A pointer to an array of floats to store the inverse in
+//	LU: The factorization of the matrix from Matrix_LUDecomposeArray
+//	pivots: The row order from Matrix_LUDecomposeArray
+//	dim: The number of rows and columns in the matrix
+void Matrix_LUInverseArray(float* dest, const float* LU, const uint16_t* pivots, const uint16_t dim);
+
+///
+//Solves the system of equations A * x = b in place by factoring a copy of A.
+//To solve many systems with the same matrix, factor it once with Matrix_LUDecomposeArray and call Matrix_LUSolveArray for each.
+//
+//Parameters:
+//	vector: The right hand side b, replaced by the solution x
+//	mat: The matrix A
+//	dim: The number of rows and columns in A
+//
+//Returns:
+//	0 if A is singular and the vector was left unchanged, 1 otherwise
+int Matrix_SolveArray(float* vector, const float* mat, const uint16_t dim);
+//Checks for errors then calls Matrix_SolveArray
+void Matrix_Solve(Vector* vector, const Matrix* mat);
+
 ///
 //Multiplies a matrix onto another, transforming the latter.
 //
@@ -271,6 +339,22 @@ void Matrix_GetProductMatrixArray(float* destMatrix, const float* LHSMatrix, con
 //Checks for errors then calls GetProductMatrixArray
 void Matrix_GetProductMatrix(Matrix* destMatrix, const Matrix* LHSMatrix, const Matrix* RHSMatrix);
 
+///
+//Gets the product of a matrix acting upon another matrix, given the transpose of the right hand side matrix.
+//Every component of the product is the dot product of two rows, so this is the faster product when the right hand
+//side is on hand transposed (such as for A * transpose(A)).
+//
+//Parameters:
+//	destMatrix: The destination of the product matrix
+//	LHSMatrix: The left hand side matrix
+//	RHSTranspose: The transpose of the right hand side matrix, with RHSNumCols rows and LHSNumCols columns
+//	LHSNumRows: The number of rows in the left hand side matrix
+//	LHSNumCols: The number of columns in the left hand side matrix
+//	RHSNumCols: The number of columns in the right hand side matrix (rows in its transpose)
+void Matrix_GetProductMatrixTransposeArray(float* destMatrix, const float* LHSMatrix, const float* RHSTranspose, const uint16_t LHSNumRows, const uint16_t LHSNumCols, const uint16_t RHSNumCols);
+//Checks for errors then calls Matrix_GetProductMatrixTransposeArray
+void Matrix_GetProductMatrixTranspose(Matrix* destMatrix, const Matrix* LHSMatrix, const Matrix* RHSTranspose);
+
 ///
 //Multiplies a matrix onto a vecor, transforming the Vector
 //
@@ -0,0 +1,754 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "MatrixBatch.h"
+
+//A register of lanes, each holding the same component of a different matrix.
+//Every operation below is written once in terms of these, and works on as many matrices at a time as a register holds.
+#if defined(__AVX__)
+#include <immintrin.h>
+typedef __m256 MatrixBatch_Lanes;
+#define MATRIXBATCH_WIDTH 8
+#define MatrixBatch_Load(p) _mm256_load_ps(p)
+#define MatrixBatch_Store(p, v) _mm256_store_ps(p, v)
+#define MatrixBatch_Add(a, b) _mm256_add_ps(a, b)
+#define MatrixBatch_Sub(a, b) _mm256_sub_ps(a, b)
+#define MatrixBatch_Mul(a, b) _mm256_mul_ps(a, b)
+#define MatrixBatch_Negate(a) _mm256_xor_ps(a, _mm256_set1_ps(-0.0f))
+#define MatrixBatch_Min(a, b) _mm256_min_ps(a, b)
+#define MatrixBatch_Sqrt(a) _mm256_sqrt_ps(a)
+#define MatrixBatch_Set(f) _mm256_set1_ps(f)
+//All bits set in each lane where |a| > b, clear elsewhere (and where either is NaN)
+#define MatrixBatch_AbsGreater(a, b) _mm256_cmp_ps(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a), b, _CMP_GT_OQ)
+//The reciprocal of each lane of a in the lanes set in mask, 0 in the others
+#define MatrixBatch_ReciprocalIn(a, mask) _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.0f), a), mask)
+//One bit for each lane set in mask, the first lane in the lowest bit
+#define MatrixBatch_GetMaskBits(mask) _mm256_movemask_ps(mask)
+//Visual Studio enables FMA along with /arch:AVX2, other compilers need it asked for separately
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define MatrixBatch_MulAdd(a, b, c) _mm256_fmadd_ps(a, b, c)
+#else
+#define MatrixBatch_MulAdd(a, b, c) _mm256_add_ps(_mm256_mul_ps(a, b), c)
+#endif
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+typedef __m128 MatrixBatch_Lanes;
+#define MATRIXBATCH_WIDTH 4
+#define MatrixBatch_Load(p) _mm_load_ps(p)
+#define MatrixBatch_Store(p, v) _mm_store_ps(p, v)
+#define MatrixBatch_Add(a, b) _mm_add_ps(a, b)
+#define MatrixBatch_Sub(a, b) _mm_sub_ps(a, b)
+#define MatrixBatch_Mul(a, b) _mm_mul_ps(a, b)
+#define MatrixBatch_Negate(a) _mm_xor_ps(a, _mm_set1_ps(-0.0f))
+#define MatrixBatch_Min(a, b) _mm_min_ps(a, b)
+#define MatrixBatch_Sqrt(a) _mm_sqrt_ps(a)
+#define MatrixBatch_Set(f) _mm_set1_ps(f)
+#define MatrixBatch_AbsGreater(a, b) _mm_cmpgt_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), a), b)
+#define MatrixBatch_ReciprocalIn(a, mask) _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.0f), a), mask)
+#define MatrixBatch_GetMaskBits(mask) _mm_movemask_ps(mask)
+#define MatrixBatch_MulAdd(a, b, c) _mm_add_ps(_mm_mul_ps(a, b), c)
+#else
+typedef float MatrixBatch_Lanes;
+#define MATRIXBATCH_WIDTH 1
+#define MatrixBatch_Load(p) (*(p))
+#define MatrixBatch_Store(p, v) (*(p) = (v))
+#define MatrixBatch_Add(a, b) ((a) + (b))
+#define MatrixBatch_Sub(a, b) ((a) - (b))
+#define MatrixBatch_Mul(a, b) ((a) * (b))
+#define MatrixBatch_Negate(a) (-(a))
+#define MatrixBatch_Min(a, b) ((a) < (b) ? (a) : (b))
+#define MatrixBatch_Sqrt(a) sqrtf(a)
+#define MatrixBatch_Set(f) (f)
+//The single lane's mask is 1.0f where |a| > b and 0.0f elsewhere
+#define MatrixBatch_AbsGreater(a, b) (fabsf(a) > (b) ? 1.0f : 0.0f)
+#define MatrixBatch_ReciprocalIn(a, mask) ((mask) != 0.0f ? 1.0f / (a) : 0.0f)
+#define MatrixBatch_GetMaskBits(mask) ((mask) != 0.0f ? 1 : 0)
+#define MatrixBatch_MulAdd(a, b, c) ((a) * (b) + (c))
+#endif
+
+//a * b - c * d, the determinant of a 2x2 matrix
+#define MatrixBatch_Det2(a, b, c, d) MatrixBatch_Sub(MatrixBatch_Mul(a, b), MatrixBatch_Mul(c, d))
+//a * b - c * d + e * f, a row of a 3x3 matrix dotted with a row of cofactors
+#define MatrixBatch_Cofactor(a, b, c, d, e, f) MatrixBatch_MulAdd(e, f, MatrixBatch_Det2(a, b, c, d))
+
+///
+//Allocates zeroed memory for the component arrays of a batch, aligned for AVX loads
+//
+//Parameters:
+//	memory: A pointer to store the allocation in, to free later
+//	numFloats: The number of floats to allocate
+//
+//Returns:
+//	The aligned start of the memory
+static float* MatrixBatch_AllocateAligned(void** memory, const size_t numFloats)
+{
+	const size_t alignment = MATRIXBATCH_PADDING * sizeof(float);
+	*memory = calloc(numFloats * sizeof(float) + alignment, 1);
+	uintptr_t address = (uintptr_t)*memory;
+	return (float*)((address + alignment - 1) & ~(uintptr_t)(alignment - 1));
+}
+
+///
+//Gets the number of floats from one component array of a batch to the next
+//
+//Parameters:
+//	count: The number of matrices or vectors in the batch
+static uint32_t MatrixBatch_GetStride(const uint32_t count)
+{
+	uint32_t stride = (count + MATRIXBATCH_PADDING - 1) / MATRIXBATCH_PADDING * MATRIXBATCH_PADDING;
+
+	//Component arrays a multiple of 1KB apart fall in the same few sets of the L1 cache, which only holds 8 lines from
+	//each set, so the sixteen arrays of a 4x4 matrix would evict each other. Another cache line apart, they are spread out.
+	if (stride % 256 == 0) stride += 16;
+	return stride > 0 ? stride : MATRIXBATCH_PADDING;
+}
+
+///
+//Counts the lanes of a register which hold singular matrices of the batch, rather than padding
+//
+//Parameters:
+//	invertibleBits: One bit for each lane whose matrix is invertible, from MatrixBatch_GetMaskBits
+//	first: The index of the matrix in the register's first lane
+//	count: The number of matrices in the batch
+static uint32_t MatrixBatch_CountSingular(const unsigned int invertibleBits, const uint32_t first, const uint32_t count)
+{
+	unsigned int mask = ~invertibleBits & ((1u << MATRIXBATCH_WIDTH) - 1u);
+	if (count - first < MATRIXBATCH_WIDTH) mask &= (1u << (count - first)) - 1u;
+
+	uint32_t zeros = 0;
+	for (; mask != 0; mask >>= 1)
+	{
+		zeros += mask & 1u;
+	}
+	return zeros;
+}
+
+///
+//Finds which matrices of a register are far enough from singular to invert.
+//
+//A determinant computed in floats is rarely exactly 0, even for a matrix with two equal rows: the rounding of each
+//product is left over, and how much is left over changes with the instruction set (fused multiply-adds round once
+//where a multiply and an add round twice). So the determinant is compared against a tolerance instead, scaled to the
+//matrix. The magnitude of a determinant is at most the product of the lengths of the matrix's rows (Hadamard's
+//inequality), and likewise of its columns, and the rounding error of computing it grows with the same products.
+//The smaller of the two is used, so a model matrix with a large translation in one row or column still counts as
+//invertible.
+//
+//Parameters:
+//	m: The components of the matrices, along the rows
+//	n: The number of rows and columns, 3 or 4
+//	determinant: The determinants of the matrices
+//
+//Returns:
+//	A mask with the lanes of the invertible matrices set
+static MatrixBatch_Lanes MatrixBatch_GetInvertible(const MatrixBatch_Lanes* m, const int n, const MatrixBatch_Lanes determinant)
+{
+	MatrixBatch_Lanes rowProduct = MatrixBatch_Set(1.0f);
+	MatrixBatch_Lanes columnProduct = MatrixBatch_Set(1.0f);
+	for (int i = 0; i < n; i++)
+	{
+		MatrixBatch_Lanes row = MatrixBatch_Mul(m[i * n], m[i * n]);
+		MatrixBatch_Lanes column = MatrixBatch_Mul(m[i], m[i]);
+		for (int k = 1; k < n; k++)
+		{
+			row = MatrixBatch_MulAdd(m[i * n + k], m[i * n + k], row);
+			column = MatrixBatch_MulAdd(m[k * n + i], m[k * n + i], column);
+		}
+		rowProduct = MatrixBatch_Mul(rowProduct, MatrixBatch_Sqrt(row));
+		columnProduct = MatrixBatch_Mul(columnProduct, MatrixBatch_Sqrt(column));
+	}
+
+	MatrixBatch_Lanes tolerance = MatrixBatch_Mul(MatrixBatch_Set(MATRIXBATCH_SINGULAR_TOLERANCE), MatrixBatch_Min(rowProduct, columnProduct));
+	return MatrixBatch_AbsGreater(determinant, tolerance);
+}
+
+///
+//Multiplies every matrix of one batch's component arrays by the matching matrix of another's
+//
+//Parameters:
+//	dest: The component arrays to store the products in
+//	LHS: The component arrays of the left hand side matrices
+//	RHS: The component arrays of the right hand side matrices
+//	count: The number of matrices
+//	stride: The number of floats from one component array to the next
+//	n: The number of rows and columns of each matrix
+//	transposeLHS: Nonzero to multiply by the transpose of each left hand side matrix
+template<int n, int transposeLHS>
+static void MatrixBatch_GetProductArray(float* dest, const float* LHS, const float* RHS, const uint32_t count, const uint32_t stride)
+{
+	//The left hand side component of row r and column k is at a[r * rowStep + k * columnStep]
+	const int rowStep = transposeLHS ? 1 : n;
+	const int columnStep = transposeLHS ? n : 1;
+
+	for (uint32_t i = 0; i < count; i += MATRIXBATCH_WIDTH)
+	{
+		MatrixBatch_Lanes a[16], b[16];
+		for (int c = 0; c < n * n; c++)
+		{
+			a[c] = MatrixBatch_Load(LHS + c * stride + i);
+			b[c] = MatrixBatch_Load(RHS + c * stride + i);
+		}
+
+		for (int row = 0; row < n; row++)
+		{
+			for (int col = 0; col < n; col++)
+			{
+				MatrixBatch_Lanes sum = MatrixBatch_Mul(a[row * rowStep], b[col]);
+				for (int k = 1; k < n; k++)
+				{
+					sum = MatrixBatch_MulAdd(a[row * rowStep + k * columnStep], b[k * n + col], sum);
+				}
+				MatrixBatch_Store(dest + (row * n + col) * stride + i, sum);
+			}
+		}
+	}
+}
+
+///
+//Inverts the upper left 3x3 matrix of every matrix of a batch's component arrays with the adjugate matrix
+//
+//Parameters:
+//	dest: The component arrays of the 3x3 matrices to store the inverses in
+//	src: The component arrays of the matrices to invert
+//	count: The number of matrices
+//	stride: The number of floats from one component array to the next
+//	srcColumns: The number of columns of each matrix to invert, 3 or 4
+//	transpose: Nonzero to store the transpose of each inverse instead
+//
+//Returns:
+//	The number of matrices which were singular
+static uint32_t MatrixBatch_GetInverse3Array(float* dest, const float* src, const uint32_t count, const uint32_t stride, const int srcColumns, const int transpose)
+{
+	uint32_t singular = 0;
+	for (uint32_t i = 0; i < count; i += MATRIXBATCH_WIDTH)
+	{
+		MatrixBatch_Lanes m[9];
+		for (int row = 0; row < 3; row++)
+		{
+			for (int col = 0; col < 3; col++)
+			{
+				m[row * 3 + col] = MatrixBatch_Load(src + (row * srcColumns + col) * stride + i);
+			}
+		}
+
+		//The adjugate matrix is the transpose of the matrix of cofactors
+		MatrixBatch_Lanes adjugate[9];
+		adjugate[0] = MatrixBatch_Det2(m[4], m[8], m[5], m[7]);
+		adjugate[1] = MatrixBatch_Det2(m[2], m[7], m[1], m[8]);
+		adjugate[2] = MatrixBatch_Det2(m[1], m[5], m[2], m[4]);
+		adjugate[3] = MatrixBatch_Det2(m[5], m[6], m[3], m[8]);
+		adjugate[4] = MatrixBatch_Det2(m[0], m[8], m[2], m[6]);
+		adjugate[5] = MatrixBatch_Det2(m[2], m[3], m[0], m[5]);
+		adjugate[6] = MatrixBatch_Det2(m[3], m[7], m[4], m[6]);
+		adjugate[7] = MatrixBatch_Det2(m[1], m[6], m[0], m[7]);
+		adjugate[8] = MatrixBatch_Det2(m[0], m[4], m[1], m[3]);
+
+		//Expanding along the first row
+		MatrixBatch_Lanes determinant = MatrixBatch_MulAdd(m[2], adjugate[6], MatrixBatch_MulAdd(m[1], adjugate[3], MatrixBatch_Mul(m[0], adjugate[0])));
+		MatrixBatch_Lanes invertible = MatrixBatch_GetInvertible(m, 3, determinant);
+		singular += MatrixBatch_CountSingular(MatrixBatch_GetMaskBits(invertible), i, count);
+		MatrixBatch_Lanes inverseDeterminant = MatrixBatch_ReciprocalIn(determinant, invertible);
+
+		for (int row = 0; row < 3; row++)
+		{
+			for (int col = 0; col < 3; col++)
+			{
+				int c = transpose ? col * 3 + row : row * 3 + col;
+				MatrixBatch_Store(dest + c * stride + i, MatrixBatch_Mul(adjugate[row * 3 + col], inverseDeterminant));
+			}
+		}
+	}
+	return singular;
+}
+
+///
+//Inverts every matrix of a batch's component arrays of 4x4 matrices with the adjugate matrix, computed from the
+//determinants of the 2x2 matrices in the top two rows and the bottom two rows (the Laplace expansion theorem)
+//
+//Parameters:
+//	dest: The component arrays to store the inverses in
+//	src: The component arrays of the matrices to invert
+//	count: The number of matrices
+//	stride: The number of floats from one component array to the next
+//
+//Returns:
+//	The number of matrices which were singular
+static uint32_t MatrixBatch_GetInverse4Array(float* dest, const float* src, const uint32_t count, const uint32_t stride)
+{
+	uint32_t singular = 0;
+	for (uint32_t i = 0; i < count; i += MATRIXBATCH_WIDTH)
+	{
+		MatrixBatch_Lanes m[16];
+		for (int c = 0; c < 16; c++)
+		{
+			m[c] = MatrixBatch_Load(src + c * stride + i);
+		}
+
+		//Determinants of the 2x2 matrices in the top two rows
+		MatrixBatch_Lanes s0 = MatrixBatch_Det2(m[0], m[5], m[4], m[1]);
+		MatrixBatch_Lanes s1 = MatrixBatch_Det2(m[0], m[6], m[4], m[2]);
+		MatrixBatch_Lanes s2 = MatrixBatch_Det2(m[0], m[7], m[4], m[3]);
+		MatrixBatch_Lanes s3 = MatrixBatch_Det2(m[1], m[6], m[5], m[2]);
+		MatrixBatch_Lanes s4 = MatrixBatch_Det2(m[1], m[7], m[5], m[3]);
+		MatrixBatch_Lanes s5 = MatrixBatch_Det2(m[2], m[7], m[6], m[3]);
+
+		//And in the bottom two rows
+		MatrixBatch_Lanes c0 = MatrixBatch_Det2(m[8], m[13], m[12], m[9]);
+		MatrixBatch_Lanes c1 = MatrixBatch_Det2(m[8], m[14], m[12], m[10]);
+		MatrixBatch_Lanes c2 = MatrixBatch_Det2(m[8], m[15], m[12], m[11]);
+		MatrixBatch_Lanes c3 = MatrixBatch_Det2(m[9], m[14], m[13], m[10]);
+		MatrixBatch_Lanes c4 = MatrixBatch_Det2(m[9], m[15], m[13], m[11]);
+		MatrixBatch_Lanes c5 = MatrixBatch_Det2(m[10], m[15], m[14], m[11]);
+
+		//det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0
+		MatrixBatch_Lanes determinant = MatrixBatch_Add(MatrixBatch_Cofactor(s0, c5, s1, c4, s2, c3), MatrixBatch_Cofactor(s3, c2, s4, c1, s5, c0));
+		MatrixBatch_Lanes invertible = MatrixBatch_GetInvertible(m, 4, determinant);
+		singular += MatrixBatch_CountSingular(MatrixBatch_GetMaskBits(invertible), i, count);
+		MatrixBatch_Lanes inverseDeterminant = MatrixBatch_ReciprocalIn(determinant, invertible);
+		MatrixBatch_Lanes negativeInverseDeterminant = MatrixBatch_Negate(inverseDeterminant);
+
+		MatrixBatch_Store(dest + 0 * stride + i, MatrixBatch_Mul(MatrixBatch_Cofactor(m[5], c5, m[6], c4, m[7], c3), inverseDeterminant));
+		MatrixBatch_Store(dest + 1 * stride + i, MatrixBatch_Mul(MatrixBatch_Cofactor(m[1], c5, m[2], c4, m[3], c3), negativeInverseDeterminant));
+		MatrixBatch_Store(dest + 2 * stride + i, MatrixBatch_Mul(MatrixBatch_Cofactor(m[13], s5, m[14], s4, m[15], s3), inverseDeterminant));
+		MatrixBatch_Store(dest + 3 * stride + i, MatrixBatch_Mul(MatrixBatch_Cofactor(m[9], s5, m[10], s4, m[11], s3), negativeInverseDeterminant));
+
+		MatrixBatch_Store(dest + 4 * stride + i, MatrixBatch_Mul(MatrixBatch_Cofactor(m[4], c5, m[6], c2, m[7], c1), negativeInverseDeterminant));
+		MatrixBatch_Store(dest + 5 * stride + i, MatrixBatch_Mul(MatrixBatch_Cofactor(m[0], c5, m[2], c2, m[3], c1), inverseDeterminant));
+		MatrixBatch_Store(dest + 6 * stride + i, MatrixBatch_Mul(MatrixBatch_Cofactor(m[12], s5, m[14], s2, m[15], s1), negativeInverseDeterminant));
+		MatrixBatch_Store(dest + 7 * stride + i, MatrixBatch_Mul(MatrixBatch_Cofactor(m[8], s5, m[10], s2, m[11], s1), inverseDeterminant));
+
+		MatrixBatch_Store(dest + 8 * stride + i, MatrixBatch_Mul(MatrixBatch_Cofactor(m[4], c4, m[5], c2, m[7], c0), inverseDeterminant));
+		MatrixBatch_Store(dest + 9 * stride + i, MatrixBatch_Mul(MatrixBatch_Cofactor(m[0], c4, m[1], c2, m[3], c0), negativeInverseDeterminant));
+		MatrixBatch_Store(dest + 10 * stride + i, MatrixBatch_Mul(MatrixBatch_Cofactor(m[12], s4, m[13], s2, m[15], s0), inverseDeterminant));
+		MatrixBatch_Store(dest + 11 * stride + i, MatrixBatch_Mul(MatrixBatch_Cofactor(m[8], s4, m[9], s2, m[11], s0), negativeInverseDeterminant));
+
+		MatrixBatch_Store(dest + 12 * stride + i, MatrixBatch_Mul(MatrixBatch_Cofactor(m[4], c3, m[5], c1, m[6], c0), negativeInverseDeterminant));
+		MatrixBatch_Store(dest + 13 * stride + i, MatrixBatch_Mul(MatrixBatch_Cofactor(m[0], c3, m[1], c1, m[2], c0), inverseDeterminant));
+		MatrixBatch_Store(dest + 14 * stride + i, MatrixBatch_Mul(MatrixBatch_Cofactor(m[12], s3, m[13], s1, m[14], s0), negativeInverseDeterminant));
+		MatrixBatch_Store(dest + 15 * stride + i, MatrixBatch_Mul(MatrixBatch_Cofactor(m[8], s3, m[9], s1, m[10], s0), inverseDeterminant));
+	}
+	return singular;
+}
+
+///
+//Allocates memory for a new batch of matrices
+//
+//Returns:
+//	Pointer to new matrix batch
+MatrixBatch* MatrixBatch_Allocate()
+{
+	MatrixBatch* batch = (MatrixBatch*)malloc(sizeof(MatrixBatch));
+	return batch;
+}
+
+///
+//Initializes a batch of zero matrices
+//
+//Parameters:
+//	batch: The matrix batch to initialize
+//	numRows: The number of rows in each matrix, 3 or 4
+//	numColumns: The number of columns in each matrix, 3 or 4
+//	count: The number of matrices in the batch
+void MatrixBatch_Initialize(MatrixBatch* batch, const uint16_t numRows, const uint16_t numColumns, const uint32_t count)
+{
+	batch->count = count;
+	batch->stride = MatrixBatch_GetStride(count);
+	batch->numRows = numRows;
+	batch->numColumns = numColumns;
+	batch->components = MatrixBatch_AllocateAligned(&batch->memory, (size_t)numRows * numColumns * batch->stride);
+}
+
+///
+//Frees a matrix batch's resources
+//
+//Parameters:
+//	batch: The matrix batch to free
+void MatrixBatch_Free(MatrixBatch* batch)
+{
+	free(batch->memory);
+	free(batch);
+}
+
+///
+//Copies one matrix into a batch
+//
+//Parameters:
+//	batch: The batch to copy the matrix into
+//	index: The position of the matrix in the batch
+//	matrix: The components of the matrix, row after row
+void MatrixBatch_SetMatrixArray(MatrixBatch* batch, const uint32_t index, const float* matrix)
+{
+	if (index >= batch->count)
+	{
+		printf("MatrixBatch_SetMatrixArray failed! Index is not in the batch. Matrix not set.\n");
+		return;
+	}
+	for (int c = 0; c < batch->numRows * batch->numColumns; c++)
+	{
+		batch->components[c * batch->stride + index] = matrix[c];
+	}
+}
+
+///
+//Copies one matrix out of a batch
+//
+//Parameters:
+//	matrix: An array to store the components of the matrix in, row after row
+//	batch: The batch to copy the matrix out of
+//	index: The position of the matrix in the batch
+void MatrixBatch_GetMatrixArray(float* matrix, const MatrixBatch* batch, const uint32_t index)
+{
+	if (index >= batch->count)
+	{
+		printf("MatrixBatch_GetMatrixArray failed! Index is not in the batch. Matrix not retrieved.\n");
+		return;
+	}
+	for (int c = 0; c < batch->numRows * batch->numColumns; c++)
+	{
+		matrix[c] = batch->components[c * batch->stride + index];
+	}
+}
+
+///
+//Multiplies each matrix of one batch by the matching matrix of another
+//
+//Parameters:
+//	dest: A batch of square matrices to store LHS * RHS in
+//	LHS: The batch of left hand side matrices
+//	RHS: The batch of right hand side matrices
+void MatrixBatch_GetProduct(MatrixBatch* dest, const MatrixBatch* LHS, const MatrixBatch* RHS)
+{
+	const int n = dest->numRows;
+	if (dest->numColumns != n || LHS->numRows != n || LHS->numColumns != n || RHS->numRows != n || RHS->numColumns != n || (n != 3 && n != 4))
+	{
+		printf("MatrixBatch_GetProduct failed! Matrices are not all 3x3 or all 4x4. Products not computed.\n");
+	}
+	else if (LHS->count != dest->count || RHS->count != dest->count)
+	{
+		printf("MatrixBatch_GetProduct failed! Batches are not of equal counts. Products not computed.\n");
+	}
+	//Called with a constant size so the compiler can unroll the loops of each
+	else if (n == 3)
+	{
+		MatrixBatch_GetProductArray<3, 0>(dest->components, LHS->components, RHS->components, dest->count, dest->stride);
+	}
+	else
+	{
+		MatrixBatch_GetProductArray<4, 0>(dest->components, LHS->components, RHS->components, dest->count, dest->stride);
+	}
+}
+
+///
+//Multiplies the transpose of each matrix of one batch by the matching matrix of another
+//
+//Parameters:
+//	dest: A batch of square matrices to store transpose(LHS) * RHS in
+//	LHS: The batch of left hand side matrices, which are transposed
+//	RHS: The batch of right hand side matrices
+void MatrixBatch_GetTransposeProduct(MatrixBatch* dest, const MatrixBatch* LHS, const MatrixBatch* RHS)
+{
+	const int n = dest->numRows;
+	if (dest->numColumns != n || LHS->numRows != n || LHS->numColumns != n || RHS->numRows != n || RHS->numColumns != n || (n != 3 && n != 4))
+	{
+		printf("MatrixBatch_GetTransposeProduct failed! Matrices are not all 3x3 or all 4x4. Products not computed.\n");
+	}
+	else if (LHS->count != dest->count || RHS->count != dest->count)
+	{
+		printf("MatrixBatch_GetTransposeProduct failed! Batches are not of equal counts. Products not computed.\n");
+	}
+	else if (n == 3)
+	{
+		MatrixBatch_GetProductArray<3, 1>(dest->components, LHS->components, RHS->components, dest->count, dest->stride);
+	}
+	else
+	{
+		MatrixBatch_GetProductArray<4, 1>(dest->components, LHS->components, RHS->components, dest->count, dest->stride);
+	}
+}
+
+///
+//Rotates each tensor of a batch by the matching rotation of another: R * I * transpose(R).
+//This is how the inertia tensor (or inverse inertia tensor) of a rigid body is moved from its local frame to the world.
+//
+//Parameters:
+//	dest: A batch of 3x3 matrices to store the rotated tensors in
+//	rotations: The batch of 3x3 rotation matrices
+//	tensors: The batch of 3x3 tensors to rotate
+void MatrixBatch_RotateTensor(MatrixBatch* dest, const MatrixBatch* rotations, const MatrixBatch* tensors)
+{
+	if (dest->numRows != 3 || dest->numColumns != 3 || rotations->numRows != 3 || rotations->numColumns != 3 || tensors->numRows != 3 || tensors->numColumns != 3)
+	{
+		printf("MatrixBatch_RotateTensor failed! Matrices are not all 3x3. Tensors not rotated.\n");
+		return;
+	}
+	if (rotations->count != dest->count || tensors->count != dest->count)
+	{
+		printf("MatrixBatch_RotateTensor failed! Batches are not of equal counts. Tensors not rotated.\n");
+		return;
+	}
+
+	const uint32_t stride = dest->stride;
+	for (uint32_t i = 0; i < dest->count; i += MATRIXBATCH_WIDTH)
+	{
+		MatrixBatch_Lanes r[9], t[9];
+		for (int c = 0; c < 9; c++)
+		{
+			r[c] = MatrixBatch_Load(rotations->components + c * stride + i);
+			t[c] = MatrixBatch_Load(tensors->components + c * stride + i);
+		}
+
+		//R * I
+		MatrixBatch_Lanes rt[9];
+		for (int row = 0; row < 3; row++)
+		{
+			for (int col = 0; col < 3; col++)
+			{
+				rt[row * 3 + col] = MatrixBatch_MulAdd(r[row * 3 + 2], t[6 + col], MatrixBatch_MulAdd(r[row * 3 + 1], t[3 + col], MatrixBatch_Mul(r[row * 3], t[col])));
+			}
+		}
+
+		//(R * I) * transpose(R), whose column is a row of R
+		for (int row = 0; row < 3; row++)
+		{
+			for (int col = 0; col < 3; col++)
+			{
+				MatrixBatch_Lanes sum = MatrixBatch_MulAdd(rt[row * 3 + 2], r[col * 3 + 2], MatrixBatch_MulAdd(rt[row * 3 + 1], r[col * 3 + 1], MatrixBatch_Mul(rt[row * 3], r[col * 3])));
+				MatrixBatch_Store(dest->components + (row * 3 + col) * stride + i, sum);
+			}
+		}
+	}
+}
+
+///
+//Inverts each matrix of a batch, using the adjugate matrix.
+//A singular matrix has no inverse, so its inverse is left as the zero matrix.
+//
+//Parameters:
+//	dest: A batch of 3x3 or 4x4 matrices to store the inverses in
+//	batch: The batch of matrices to invert
+//
+//Returns:
+//	The number of matrices which were singular
+uint32_t MatrixBatch_GetInverse(MatrixBatch* dest, const MatrixBatch* batch)
+{
+	const int n = batch->numRows;
+	if (batch->numColumns != n || dest->numRows != n || dest->numColumns != n || (n != 3 && n != 4))
+	{
+		printf("MatrixBatch_GetInverse failed! Matrices are not all 3x3 or all 4x4. Inverses not computed.\n");
+		return 0;
+	}
+	if (batch->count != dest->count)
+	{
+		printf("MatrixBatch_GetInverse failed! Batches are not of equal counts. Inverses not computed.\n");
+		return 0;
+	}
+
+	if (n == 3)
+	{
+		return MatrixBatch_GetInverse3Array(dest->components, batch->components, dest->count, dest->stride, 3, 0);
+	}
+	return MatrixBatch_GetInverse4Array(dest->components, batch->components, dest->count, dest->stride);
+}
+
+///
+//Gets the normal matrix of each model matrix of a batch: the inverse of the transpose of its upper left 3x3 matrix,
+//which keeps normals perpendicular to surfaces that are scaled unevenly.
+//A model matrix which flattens space has no normal matrix, so its normal matrix is left as the zero matrix.
+//
+//Parameters:
+//	dest: A batch of 3x3 matrices to store the normal matrices in
+//	models: The batch of 3x3 or 4x4 model matrices
+//
+//Returns:
+//	The number of model matrices which had no normal matrix
+uint32_t MatrixBatch_GetNormalMatrix(MatrixBatch* dest, const MatrixBatch* models)
+{
+	if (dest->numRows != 3 || dest->numColumns != 3 || models->numRows != models->numColumns || (models->numRows != 3 && models->numRows != 4))
+	{
+		printf("MatrixBatch_GetNormalMatrix failed! Destination is not 3x3 or models are not 3x3 or 4x4. Normal matrices not computed.\n");
+		return 0;
+	}
+	if (models->count != dest->count)
+	{
+		printf("MatrixBatch_GetNormalMatrix failed! Batches are not of equal counts. Normal matrices not computed.\n");
+		return 0;
+	}
+
+	//The inverse of the transpose is the transpose of the inverse
+	return MatrixBatch_GetInverse3Array(dest->components, models->components, dest->count, dest->stride, models->numColumns, 1);
+}
+
+///
+//Multiplies each vector of a batch by the matching matrix of a batch
+//
+//Parameters:
+//	dest: A batch of vectors to store matrix * vector in
+//	batch: The batch of square matrices
+//	vectors: The batch of vectors, of the same dimension as the matrices
+void MatrixBatch_TransformVectors(VectorBatch* dest, const MatrixBatch* batch, const VectorBatch* vectors)
+{
+	const int n = batch->numRows;
+	if (batch->numColumns != n || vectors->dimension != n || dest->dimension != n || (n != 3 && n != 4))
+	{
+		printf("MatrixBatch_TransformVectors failed! Matrices and vectors are not all of dimension 3 or all of dimension 4. Vectors not transformed.\n");
+		return;
+	}
+	if (batch->count != dest->count || vectors->count != dest->count)
+	{
+		printf("MatrixBatch_TransformVectors failed! Batches are not of equal counts. Vectors not transformed.\n");
+		return;
+	}
+
+	const uint32_t matrixStride = batch->stride;
+	const uint32_t vectorStride = dest->stride;
+	for (uint32_t i = 0; i < dest->count; i += MATRIXBATCH_WIDTH)
+	{
+		MatrixBatch_Lanes v[4], result[4];
+		for (int c = 0; c < n; c++)
+		{
+			v[c] = MatrixBatch_Load(vectors->components + c * vectorStride + i);
+		}
+
+		for (int row = 0; row < n; row++)
+		{
+			const float* m = batch->components + row * n * matrixStride + i;
+			result[row] = MatrixBatch_Mul(MatrixBatch_Load(m), v[0]);
+			for (int col = 1; col < n; col++)
+			{
+				result[row] = MatrixBatch_MulAdd(MatrixBatch_Load(m + col * matrixStride), v[col], result[row]);
+			}
+		}
+
+		for (int c = 0; c < n; c++)
+		{
+			MatrixBatch_Store(dest->components + c * vectorStride + i, result[c]);
+		}
+	}
+}
+
+///
+//Moves each point of a batch by the matching affine transformation of a batch, treating the point as (x, y, z, 1).
+//The bottom row of each transformation is ignored, so this is not for projections.
+//
+//Parameters:
+//	dest: A batch of 3 dimensional vectors to store the moved points in
+//	batch: The batch of 4x4 transformation matrices
+//	points: The batch of 3 dimensional points to move
+void MatrixBatch_TransformPoints(VectorBatch* dest, const MatrixBatch* batch, const VectorBatch* points)
+{
+	if (batch->numRows != 4 || batch->numColumns != 4 || points->dimension != 3 || dest->dimension != 3)
+	{
+		printf("MatrixBatch_TransformPoints failed! Matrices are not 4x4 or points are not of dimension 3. Points not transformed.\n");
+		return;
+	}
+	if (batch->count != dest->count || points->count != dest->count)
+	{
+		printf("MatrixBatch_TransformPoints failed! Batches are not of equal counts. Points not transformed.\n");
+		return;
+	}
+
+	const uint32_t matrixStride = batch->stride;
+	const uint32_t vectorStride = dest->stride;
+	for (uint32_t i = 0; i < dest->count; i += MATRIXBATCH_WIDTH)
+	{
+		MatrixBatch_Lanes p[3], result[3];
+		for (int c = 0; c < 3; c++)
+		{
+			p[c] = MatrixBatch_Load(points->components + c * vectorStride + i);
+		}
+
+		for (int row = 0; row < 3; row++)
+		{
+			//Start from the translation in the last column
+			const float* m = batch->components + row * 4 * matrixStride + i;
+			result[row] = MatrixBatch_Load(m + 3 * matrixStride);
+			for (int col = 0; col < 3; col++)
+			{
+				result[row] = MatrixBatch_MulAdd(MatrixBatch_Load(m + col * matrixStride), p[col], result[row]);
+			}
+		}
+
+		for (int c = 0; c < 3; c++)
+		{
+			MatrixBatch_Store(dest->components + c * vectorStride + i, result[c]);
+		}
+	}
+}
+
+///
+//Allocates memory for a new batch of vectors
+//
+//Returns:
+//	Pointer to new vector batch
+VectorBatch* VectorBatch_Allocate()
+{
+	VectorBatch* batch = (VectorBatch*)malloc(sizeof(VectorBatch));
+	return batch;
+}
+
+///
+//Initializes a batch of zero vectors
+//
+//Parameters:
+//	batch: The vector batch to initialize
+//	dimension: The number of components in each vector, 3 or 4
+//	count: The number of vectors in the batch
+void VectorBatch_Initialize(VectorBatch* batch, const uint16_t dimension, const uint32_t count)
+{
+	batch->count = count;
+	batch->stride = MatrixBatch_GetStride(count);
+	batch->dimension = dimension;
+	batch->components = MatrixBatch_AllocateAligned(&batch->memory, (size_t)dimension * batch->stride);
+}
+
+///
+//Frees a vector batch's resources
+//
+//Parameters:
+//	batch: The vector batch to free
+void VectorBatch_Free(VectorBatch* batch)
+{
+	free(batch->memory);
+	free(batch);
+}
+
+///
+//Copies one vector into a batch
+//
+//Parameters:
+//	batch: The batch to copy the vector into
+//	index: The position of the vector in the batch
+//	vector: The components of the vector
+void VectorBatch_SetVectorArray(VectorBatch* batch, const uint32_t index, const float* vector)
+{
+	if (index >= batch->count)
+	{
+		printf("VectorBatch_SetVectorArray failed! Index is not in the batch. Vector not set.\n");
+		return;
+	}
+	for (int c = 0; c < batch->dimension; c++)
+	{
+		batch->components[c * batch->stride + index] = vector[c];
+	}
+}
+
+///
+//Copies one vector out of a batch
+//
+//Parameters:
+//	vector: An array to store the components of the vector in
+//	batch: The batch to copy the vector out of
+//	index: The position of the vector in the batch
+void VectorBatch_GetVectorArray(float* vector, const VectorBatch* batch, const uint32_t index)
+{
+	if (index >= batch->count)
+	{
+		printf("VectorBatch_GetVectorArray failed! Index is not in the batch. Vector not retrieved.\n");
+		return;
+	}
+	for (int c = 0; c < batch->dimension; c++)
+	{
+		vector[c] = batch->components[c * batch->stride + index];
+	}
+}
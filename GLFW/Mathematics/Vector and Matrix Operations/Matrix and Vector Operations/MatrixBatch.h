@@ -0,0 +1,217 @@
+/*
+Batches of many small matrices and vectors, for doing the same 3x3 or 4x4 work on thousands of objects at once
+(rotating the inertia tensors of rigid bodies, inverting them, transforming their normals and points).
+
+A batch is stored as a structure of arrays: instead of one matrix after another, every component has its own array
+holding that component of every matrix in the batch. Component c of matrix i is
+
+	batch->components[c * batch->stride + i]
+
+where c counts along the rows, as in Matrix. Every operation on a batch is then the same arithmetic as on a single
+matrix, done on whole registers of matrices at a time: eight with AVX (/arch:AVX or /arch:AVX2), four with SSE, which
+every x86 and x64 build has. There is no shuffling of components between lanes, so the speed up over looping over the
+matrices one at a time is close to the width of the registers.
+
+Each component array is padded out to a multiple of eight matrices and aligned for AVX loads, so the operations never
+need a separate loop for the last few matrices. The padding is cleared when the batch is initialized; the operations
+write it too, but it is never part of the results.
+
+Every operation takes batches of the same count. The destination may be one of the operands, since each register of
+matrices is loaded before any of its results are stored.
+
+References:
+Intel Intrinsics Guide
+Real-Time Rendering by Akenine-Moller, Haines and Hoffman, Chapter 4 (normal transforms)
+*/
+
+#ifndef MATRIXBATCH_H
+#define MATRIXBATCH_H
+
+#include <stdint.h>
+
+//Matrices are padded out to a multiple of this many, and component arrays aligned to this many floats
+#define MATRIXBATCH_PADDING 8
+//A matrix is treated as singular when its determinant is at most this times the smaller of the products of the
+//lengths of its rows and of its columns (the largest the determinant could be). It is about a hundred times the
+//rounding error of a float, enough to cover the rounding of a 4x4 determinant with or without fused multiply-adds.
+#define MATRIXBATCH_SINGULAR_TOLERANCE 1e-5f
+
+typedef struct MatrixBatch
+{
+	uint32_t count;			//The number of matrices in the batch
+	uint32_t stride;		//The number of floats from one component array to the next
+	uint16_t numRows;		//3 or 4
+	uint16_t numColumns;	//3 or 4
+
+	float* components;		//numRows * numColumns arrays of stride floats
+	void* memory;			//The allocation the components are aligned within
+}MatrixBatch;
+
+typedef struct VectorBatch
+{
+	uint32_t count;			//The number of vectors in the batch
+	uint32_t stride;		//The number of floats from one component array to the next
+	uint16_t dimension;		//3 or 4
+
+	float* components;		//dimension arrays of stride floats
+	void* memory;			//The allocation the components are aligned within
+}VectorBatch;
+
+///
+//Allocates memory for a new batch of matrices
+//
+//Returns:
+//	Pointer to new matrix batch
+MatrixBatch* MatrixBatch_Allocate();
+
+///
+//Initializes a batch of zero matrices
+//
+//Parameters:
+//	batch: The matrix batch to initialize
+//	numRows: The number of rows in each matrix, 3 or 4
+//	numColumns: The number of columns in each matrix, 3 or 4
+//	count: The number of matrices in the batch
+void MatrixBatch_Initialize(MatrixBatch* batch, const uint16_t numRows, const uint16_t numColumns, const uint32_t count);
+
+///
+//Frees a matrix batch's resources
+//
+//Parameters:
+//	batch: The matrix batch to free
+void MatrixBatch_Free(MatrixBatch* batch);
+
+///
+//Copies one matrix into a batch
+//
+//Parameters:
+//	batch: The batch to copy the matrix into
+//	index: The position of the matrix in the batch
+//	matrix: The components of the matrix, row after row
+void MatrixBatch_SetMatrixArray(MatrixBatch* batch, const uint32_t index, const float* matrix);
+
+///
+//Copies one matrix out of a batch
+//
+//Parameters:
+//	matrix: An array to store the components of the matrix in, row after row
+//	batch: The batch to copy the matrix out of
+//	index: The position of the matrix in the batch
+void MatrixBatch_GetMatrixArray(float* matrix, const MatrixBatch* batch, const uint32_t index);
+
+///
+//Multiplies each matrix of one batch by the matching matrix of another
+//
+//Parameters:
+//	dest: A batch of square matrices to store LHS * RHS in
+//	LHS: The batch of left hand side matrices
+//	RHS: The batch of right hand side matrices
+void MatrixBatch_GetProduct(MatrixBatch* dest, const MatrixBatch* LHS, const MatrixBatch* RHS);
+
+///
+//Multiplies the transpose of each matrix of one batch by the matching matrix of another
+//
+//Parameters:
+//	dest: A batch of square matrices to store transpose(LHS) * RHS in
+//	LHS: The batch of left hand side matrices, which are transposed
+//	RHS: The batch of right hand side matrices
+void MatrixBatch_GetTransposeProduct(MatrixBatch* dest, const MatrixBatch* LHS, const MatrixBatch* RHS);
+
+///
+//Rotates each tensor of a batch by the matching rotation of another: R * I * transpose(R).
+//This is how the inertia tensor (or inverse inertia tensor) of a rigid body is moved from its local frame to the world.
+//
+//Parameters:
+//	dest: A batch of 3x3 matrices to store the rotated tensors in
+//	rotations: The batch of 3x3 rotation matrices
+//	tensors: The batch of 3x3 tensors to rotate
+void MatrixBatch_RotateTensor(MatrixBatch* dest, const MatrixBatch* rotations, const MatrixBatch* tensors);
+
+///
+//Inverts each matrix of a batch, using the adjugate matrix.
+//A singular matrix has no inverse, so its inverse is left as the zero matrix. Matrices within rounding error of
+//singular (see MATRIXBATCH_SINGULAR_TOLERANCE) count as singular, whichever instruction set the program is built for.
+//
+//Parameters:
+//	dest: A batch of 3x3 or 4x4 matrices to store the inverses in
+//	batch: The batch of matrices to invert
+//
+//Returns:
+//	The number of matrices which were singular
+uint32_t MatrixBatch_GetInverse(MatrixBatch* dest, const MatrixBatch* batch);
+
+///
+//Gets the normal matrix of each model matrix of a batch: the inverse of the transpose of its upper left 3x3 matrix,
+//which keeps normals perpendicular to surfaces that are scaled unevenly.
+//A model matrix which flattens space has no normal matrix, so its normal matrix is left as the zero matrix. As with
+//MatrixBatch_GetInverse, one within rounding error of flattening space counts as flattening it.
+//
+//Parameters:
+//	dest: A batch of 3x3 matrices to store the normal matrices in
+//	models: The batch of 3x3 or 4x4 model matrices
+//
+//Returns:
+//	The number of model matrices which had no normal matrix
+uint32_t MatrixBatch_GetNormalMatrix(MatrixBatch* dest, const MatrixBatch* models);
+
+///
+//Multiplies each vector of a batch by the matching matrix of a batch
+//
+//Parameters:
+//	dest: A batch of vectors to store matrix * vector in
+//	batch: The batch of square matrices
+//	vectors: The batch of vectors, of the same dimension as the matrices
+void MatrixBatch_TransformVectors(VectorBatch* dest, const MatrixBatch* batch, const VectorBatch* vectors);
+
+///
+//Moves each point of a batch by the matching affine transformation of a batch, treating the point as (x, y, z, 1).
+//The bottom row of each transformation is ignored, so this is not for projections.
+//
+//Parameters:
+//	dest: A batch of 3 dimensional vectors to store the moved points in
+//	batch: The batch of 4x4 transformation matrices
+//	points: The batch of 3 dimensional points to move
+void MatrixBatch_TransformPoints(VectorBatch* dest, const MatrixBatch* batch, const VectorBatch* points);
+
+///
+//Allocates memory for a new batch of vectors
+//
+//Returns:
+//	Pointer to new vector batch
+VectorBatch* VectorBatch_Allocate();
+
+///
+//Initializes a batch of zero vectors
+//
+//Parameters:
+//	batch: The vector batch to initialize
+//	dimension: The number of components in each vector, 3 or 4
+//	count: The number of vectors in the batch
+void VectorBatch_Initialize(VectorBatch* batch, const uint16_t dimension, const uint32_t count);
+
+///
+//Frees a vector batch's resources
+//
+//Parameters:
+//	batch: The vector batch to free
+void VectorBatch_Free(VectorBatch* batch);
+
+///
+//Copies one vector into a batch
+//
+//Parameters:
+//	batch: The batch to copy the vector into
+//	index: The position of the vector in the batch
+//	vector: The components of the vector
+void VectorBatch_SetVectorArray(VectorBatch* batch, const uint32_t index, const float* vector);
+
+///
+//Copies one vector out of a batch
+//
+//Parameters:
+//	vector: An array to store the components of the vector in
+//	batch: The batch to copy the vector out of
+//	index: The position of the vector in the batch
+void VectorBatch_GetVectorArray(float* vector, const VectorBatch* batch, const uint32_t index);
+
+#endif
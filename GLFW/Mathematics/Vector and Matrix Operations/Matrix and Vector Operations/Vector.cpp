@@ -92,6 +92,21 @@ void Vector_Initialize(Vector* vec, uint16_t dim)
 	vec->components = (float*)calloc(sizeof(float), vec->dimension);
 }
 
+///
+//Initializes a Vector with components taken from an arena, setting all components to 0.
+//The Vector must not be freed with Vector_Free; its components are released when the arena is reset.
+//
+//Parameters:
+//	vec: The Vector to initialize
+//	dim: The number of components the Vector has
+//	arena: The arena to take the components from
+void Vector_InitializeFromArena(Vector* vec, uint16_t dim, Arena* arena)
+{
+	vec->dimension = dim;
+	vec->components = (float*)Arena_Push(arena, sizeof(float) * dim);
+	memset(vec->components, 0, sizeof(float) * dim);
+}
+
 ///
 //Frees the memory taken by a Vector
 //
@@ -257,7 +272,10 @@ float Vector_DotProduct(const Vector* vec1, const Vector* vec2)
 void Vector_CrossProductArray(float* dest, const uint16_t dim, float** vectors)
 {
 	//Construct Crossproduct Matrix
-	float* crossMatrix = (float*)malloc(sizeof(float) * dim * dim);
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	float* crossMatrix = (float*)Arena_Push(scratch, sizeof(float) * dim * dim);
+	float* minor = (float*)Arena_Push(scratch, sizeof(float) * (dim - 1) * (dim - 1));
 	for(uint16_t i = 0; i < dim - 1; i++)
 	{
 		for(unsigned int j = 0; j < dim; j++)
@@ -267,12 +285,10 @@ void Vector_CrossProductArray(float* dest, const uint16_t dim, float** vectors)
 	}
 	for(unsigned int i = 0; i < dim; i++)
 	{
-		float* minor = (float*) malloc(sizeof(float) * (dim - 1) * (dim - 1));
 		Matrix_GetMinorArray(minor, crossMatrix, 0, i, dim, dim);
 		dest[i] = powf(-1.0f, (float)(i + 2)) * Matrix_GetDeterminateArray(minor, dim - 1, dim - 1);
-		free(minor);
 	}
-	free(crossMatrix);
+	Arena_ResetToMarker(scratch, marker);
 }
 ///
 //Checks for errors then calls CVector_CrossProductArray
@@ -286,7 +302,9 @@ void Vector_CrossProduct(Vector* dest, ...)
 	va_list argsList;
 	va_start (argsList, dest);	//Initialize arguments list
 
-	float** vectors = (float**)malloc(sizeof(float*) * (argc));
+	Arena* scratch = Arena_GetScratch();
+	ArenaMarker marker = Arena_GetMarker(scratch);
+	float** vectors = (float**)Arena_Push(scratch, sizeof(float*) * (argc));
 	for(int i = 0; i < argc; i++)
 	{
 		Vector* v = va_arg(argsList, Vector*);
@@ -295,7 +313,7 @@ void Vector_CrossProduct(Vector* dest, ...)
 
 	Vector_CrossProductArray(dest->components, dest->dimension, vectors);
 	va_end(argsList);
-	free(vectors);
+	Arena_ResetToMarker(scratch, marker);
 }
 
 ///
@@ -27,6 +27,18 @@ Operations includes the Vector operations Addition, subtraction, dot product, cr
 projection, and magnitude aswell as the Matrix operations multiplication, inversion, determinant calculation,
 minor calculation, row slicing, column slicing, and indexing.
 
+FixedMatrix.h and FixedVector.h do the same operations on matrices and vectors whose size is fixed when the
+program is compiled, such as the 3x3 and 4x4 matrices used by physics. They keep their components inline and
+need no memory allocation, and can be passed to the functions above through AsMatrix and AsVector.
+
+MatrixBatch.h does the same 3x3 and 4x4 operations on thousands of matrices at once, such as rotating the inertia
+tensors of every rigid body in a scene. The matrices are stored component by component so SSE or AVX can work on four
+or eight of them with each instruction.
+
+SparseMatrix.h stores only the nonzero components of a matrix, such as the stiffness matrix of a finite element mesh,
+which is almost all zeros. It is built from triplets of row, column and value, compressed into rows, and solved with
+the conjugate gradient method preconditioned by an incomplete Cholesky factorization.
+
 The user must press CTRL+f5 to fun the solution and have the window say open.
 Alternatively the user can click Debug->Run without debugging.
 
@@ -36,8 +48,12 @@ NGen by Nicholas Gallagher
 #define _CRT_SECURE_NO_WARNINGS
 
 
+#include <stdlib.h>
 #include <stdio.h>
 #include "Matrix.h"
+#include "FixedMatrix.h"
+#include "MatrixBatch.h"
+#include "SparseMatrix.h"
 
 
 int main(int argc, char* argv[])
@@ -122,4 +138,72 @@ int main(int argc, char* argv[])
 	printf("\nR * Rinverse =\n");
 	Matrix_PrintArray(I, numRows, numColumns);
 
+	//Do the same with matrices and vectors of a fixed size, which are kept on the stack
+	FixedMatrix<3, 3> fixedR = FixedMatrix<3, 3>::FromArray(R);
+	FixedVector<3> fixedX = FixedVector<3>::FromArray(X);
+	FixedVector<3> fixedResult = fixedR * fixedX;
+	printf("\nFixed R * X = ");
+	Vector_PrintTransposeArray(fixedResult.components, 3);
+
+	FixedMatrix<3, 3> fixedRinverse;
+	fixedR.GetInverse(&fixedRinverse);
+	FixedMatrix<3, 3> fixedI = fixedR * fixedRinverse;
+	printf("\nFixed R * Rinverse =\n");
+	Matrix fixedIView = fixedI.AsMatrix();
+	Matrix_Print(&fixedIView);
+
+	//Rotate a batch of inertia tensors by R all at once, the tensor of a 1 by 2 by 3 box of mass 12 first
+	const uint32_t batchCount = 100;
+	float tensor[9] = { 13.0f, 0.0f, 0.0f, 0.0f, 10.0f, 0.0f, 0.0f, 0.0f, 5.0f };
+	MatrixBatch* rotations = MatrixBatch_Allocate();
+	MatrixBatch* tensors = MatrixBatch_Allocate();
+	MatrixBatch_Initialize(rotations, 3, 3, batchCount);
+	MatrixBatch_Initialize(tensors, 3, 3, batchCount);
+	for (uint32_t i = 0; i < batchCount; i++)
+	{
+		MatrixBatch_SetMatrixArray(rotations, i, R);
+		MatrixBatch_SetMatrixArray(tensors, i, tensor);
+	}
+	MatrixBatch_RotateTensor(tensors, rotations, tensors);
+
+	MatrixBatch_GetMatrixArray(tensor, tensors, 0);
+	printf("\nBatch R * I * transpose(R) =\n");
+	Matrix_PrintArray(tensor, 3, 3);
+
+	MatrixBatch_Free(rotations);
+	MatrixBatch_Free(tensors);
+
+	//Build the tridiagonal stiffness matrix of a chain of 100 springs fixed at one end from triplets,
+	//each spring adding its stiffness onto the components of both of its ends
+	const uint32_t numSprings = 100;
+	SparseMatrix* K = SparseMatrix_Allocate();
+	SparseMatrix_Initialize(K, numSprings, numSprings);
+	for (uint32_t i = 0; i < numSprings; i++)
+	{
+		SparseMatrix_AddTriplet(K, i, i, 1.0f);
+		if (i > 0)
+		{
+			SparseMatrix_AddTriplet(K, i - 1, i - 1, 1.0f);
+			SparseMatrix_AddTriplet(K, i - 1, i, -1.0f);
+			SparseMatrix_AddTriplet(K, i, i - 1, -1.0f);
+		}
+	}
+	SparseMatrix_Compress(K);
+	printf("\nSparse K: %u x %u with %u nonzero components\n", K->numRows, K->numColumns, K->numNonzeros);
+
+	//Solve K * x = f for a unit force pulling on the free end. A tridiagonal matrix has no fill in, so its incomplete
+	//Cholesky factorization is exact and the solve takes a single iteration.
+	SparseMatrix* L = SparseMatrix_Allocate();
+	SparseMatrix_Initialize(L, numSprings, numSprings);
+	SparseMatrix_IncompleteCholesky(L, K);
+	float* x = (float*)calloc(numSprings, sizeof(float));
+	float* f = (float*)calloc(numSprings, sizeof(float));
+	f[numSprings - 1] = 1.0f;
+	uint32_t iterations = SparseMatrix_SolveConjugateGradient(x, K, L, f, numSprings, 0.0001f);
+	printf("Preconditioned conjugate gradient took %u iterations, the free end moved %f\n", iterations, x[numSprings - 1]);
+
+	free(x);
+	free(f);
+	SparseMatrix_Free(K);
+	SparseMatrix_Free(L);
 }
\ No newline at end of file
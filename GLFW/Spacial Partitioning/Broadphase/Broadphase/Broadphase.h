@@ -0,0 +1,59 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "glm\glm.hpp"
+
+// What every broadphase in this example is given and what it hands back, so any of them can be dropped
+// in front of the same narrowphase (or benchmarked against each other) without changing the caller.
+
+// An axis aligned bounding box
+struct BroadphaseAABB
+{
+	glm::vec3 min;
+	glm::vec3 max;
+};
+
+// Two objects whose boxes overlap. The ids are the ones the objects were registered with and a is always
+// less than b, so the same pair always comes out the same way no matter which broadphase found it.
+struct BroadphasePair
+{
+	uint32_t a;
+	uint32_t b;
+};
+
+inline BroadphasePair MakePair(uint32_t a, uint32_t b)
+{
+	BroadphasePair pair;
+	pair.a = a < b ? a : b;
+	pair.b = a < b ? b : a;
+	return pair;
+}
+
+inline bool Overlaps(const BroadphaseAABB& a, const BroadphaseAABB& b)
+{
+	return a.min.x <= b.max.x && a.max.x >= b.min.x
+		&& a.min.y <= b.max.y && a.max.y >= b.min.y
+		&& a.min.z <= b.max.z && a.max.z >= b.min.z;
+}
+
+// True if b lies entirely inside a
+inline bool Contains(const BroadphaseAABB& a, const BroadphaseAABB& b)
+{
+	return a.min.x <= b.min.x && a.min.y <= b.min.y && a.min.z <= b.min.z
+		&& a.max.x >= b.max.x && a.max.y >= b.max.y && a.max.z >= b.max.z;
+}
+
+inline BroadphaseAABB Union(const BroadphaseAABB& a, const BroadphaseAABB& b)
+{
+	BroadphaseAABB box;
+	box.min = glm::min(a.min, b.min);
+	box.max = glm::max(a.max, b.max);
+	return box;
+}
+
+inline float SurfaceArea(const BroadphaseAABB& box)
+{
+	glm::vec3 d = box.max - box.min;
+	return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
@@ -0,0 +1,393 @@
+#include "DynamicAABBTree.h"
+
+#define NULL_NODE DynamicAABBTreeNode::Null
+
+DynamicAABBTree::DynamicAABBTree(float margin, float displacementMultiplier)
+{
+	_root = NULL_NODE;
+	_freeList = NULL_NODE;
+	_proxyCount = 0;
+	_margin = margin;
+	_displacementMultiplier = displacementMultiplier;
+}
+
+DynamicAABBTree::~DynamicAABBTree()
+{
+}
+
+// Takes a node off the free list, or grows the pool if the list is empty
+int DynamicAABBTree::AllocateNode()
+{
+	int node;
+	if (_freeList != NULL_NODE)
+	{
+		node = _freeList;
+		_freeList = _nodes[node].parent;
+	}
+	else
+	{
+		node = _nodes.size();
+		_nodes.push_back(DynamicAABBTreeNode());
+	}
+
+	DynamicAABBTreeNode& n = _nodes[node];
+	n.parent = NULL_NODE;
+	n.child1 = NULL_NODE;
+	n.child2 = NULL_NODE;
+	n.height = 0;
+	n.id = 0;
+	return node;
+}
+
+void DynamicAABBTree::FreeNode(int node)
+{
+	_nodes[node].parent = _freeList;
+	_nodes[node].height = -1;
+	_freeList = node;
+}
+
+int DynamicAABBTree::CreateProxy(const BroadphaseAABB& box, uint32_t id)
+{
+	int proxy = AllocateNode();
+	glm::vec3 margin = glm::vec3(_margin);
+	_nodes[proxy].box.min = box.min - margin;
+	_nodes[proxy].box.max = box.max + margin;
+	_nodes[proxy].id = id;
+
+	InsertLeaf(proxy);
+	++_proxyCount;
+	return proxy;
+}
+
+void DynamicAABBTree::DestroyProxy(int proxy)
+{
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+	--_proxyCount;
+}
+
+// While an object stays inside its fat box nothing needs to change. Once it leaves, the new fat box is also
+// stretched in the direction the object is moving, since that is where it is most likely to be next.
+bool DynamicAABBTree::MoveProxy(int proxy, const BroadphaseAABB& box, const glm::vec3& displacement)
+{
+	if (Contains(_nodes[proxy].box, box))
+	{
+		return false;
+	}
+
+	RemoveLeaf(proxy);
+
+	glm::vec3 margin = glm::vec3(_margin);
+	BroadphaseAABB fat;
+	fat.min = box.min - margin;
+	fat.max = box.max + margin;
+
+	glm::vec3 d = displacement * _displacementMultiplier;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		if (d[axis] < 0.0f) fat.min[axis] += d[axis];
+		else fat.max[axis] += d[axis];
+	}
+
+	_nodes[proxy].box = fat;
+	InsertLeaf(proxy);
+	return true;
+}
+
+// To find the sibling for a new leaf we walk down from the root, at each step comparing the cost of pairing the
+// leaf with the current node against the cheapest cost it could have further down either child. The cost used is
+// surface area, since the chance of a random query hitting a box is roughly proportional to its surface area.
+// Every node above the new leaf grows to cover it, which is the inheritance cost paid by going deeper.
+void DynamicAABBTree::InsertLeaf(int leaf)
+{
+	if (_root == NULL_NODE)
+	{
+		_root = leaf;
+		_nodes[leaf].parent = NULL_NODE;
+		return;
+	}
+
+	BroadphaseAABB leafBox = _nodes[leaf].box;
+	int index = _root;
+	while (!_nodes[index].isLeaf())
+	{
+		const DynamicAABBTreeNode& node = _nodes[index];
+		float area = SurfaceArea(node.box);
+		float combinedArea = SurfaceArea(Union(node.box, leafBox));
+
+		// Cost of making a new parent for this node and the leaf
+		float cost = 2.0f * combinedArea;
+
+		// Minimum cost of pushing the leaf further down the tree
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		float childCost[2];
+		int children[2] = { node.child1, node.child2 };
+		for (int c = 0; c < 2; ++c)
+		{
+			const DynamicAABBTreeNode& child = _nodes[children[c]];
+			float childArea = SurfaceArea(Union(child.box, leafBox));
+			if (!child.isLeaf()) childArea -= SurfaceArea(child.box);
+			childCost[c] = childArea + inheritanceCost;
+		}
+
+		if (cost < childCost[0] && cost < childCost[1])
+		{
+			break;
+		}
+
+		index = childCost[0] < childCost[1] ? children[0] : children[1];
+	}
+
+	int sibling = index;
+
+	// Put a new parent where the sibling was, with the sibling and the leaf as its children
+	int oldParent = _nodes[sibling].parent;
+	int newParent = AllocateNode();
+	_nodes[newParent].parent = oldParent;
+	_nodes[newParent].box = Union(leafBox, _nodes[sibling].box);
+	_nodes[newParent].height = _nodes[sibling].height + 1;
+	_nodes[newParent].child1 = sibling;
+	_nodes[newParent].child2 = leaf;
+	_nodes[sibling].parent = newParent;
+	_nodes[leaf].parent = newParent;
+
+	if (oldParent == NULL_NODE)
+	{
+		_root = newParent;
+	}
+	else if (_nodes[oldParent].child1 == sibling)
+	{
+		_nodes[oldParent].child1 = newParent;
+	}
+	else
+	{
+		_nodes[oldParent].child2 = newParent;
+	}
+
+	Refit(newParent);
+}
+
+// The leaf's parent is removed and the leaf's sibling takes its place
+void DynamicAABBTree::RemoveLeaf(int leaf)
+{
+	if (leaf == _root)
+	{
+		_root = NULL_NODE;
+		return;
+	}
+
+	int parent = _nodes[leaf].parent;
+	int grandParent = _nodes[parent].parent;
+	int sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+	if (grandParent == NULL_NODE)
+	{
+		_root = sibling;
+		_nodes[sibling].parent = NULL_NODE;
+		FreeNode(parent);
+		return;
+	}
+
+	if (_nodes[grandParent].child1 == parent)
+	{
+		_nodes[grandParent].child1 = sibling;
+	}
+	else
+	{
+		_nodes[grandParent].child2 = sibling;
+	}
+	_nodes[sibling].parent = grandParent;
+	FreeNode(parent);
+
+	Refit(grandParent);
+}
+
+void DynamicAABBTree::Refit(int node)
+{
+	while (node != NULL_NODE)
+	{
+		Rotate(node);
+
+		DynamicAABBTreeNode& n = _nodes[node];
+		const DynamicAABBTreeNode& child1 = _nodes[n.child1];
+		const DynamicAABBTreeNode& child2 = _nodes[n.child2];
+		n.box = Union(child1.box, child2.box);
+		n.height = 1 + (child1.height > child2.height ? child1.height : child2.height);
+
+		node = n.parent;
+	}
+}
+
+// Inserting and removing one leaf at a time leaves the tree in whatever shape the order of updates gave it.
+// To keep it in good shape, each node on the path back up to the root looks at swapping one of its children
+// with one of its grandchildren on the other side. The node's own box does not change, but the child that
+// receives the swapped node gets a new box, and we take whichever swap shrinks that box's surface area the most.
+void DynamicAABBTree::Rotate(int node)
+{
+	DynamicAABBTreeNode& a = _nodes[node];
+	if (a.height < 2)
+	{
+		return;
+	}
+
+	int b = a.child1;
+	int c = a.child2;
+
+	// The four possible swaps: B with one of C's children, or C with one of B's children
+	enum { None, B_C1, B_C2, C_B1, C_B2 };
+	int bestRotation = None;
+	float bestGain = 0.0f;
+
+	if (!_nodes[c].isLeaf())
+	{
+		float area = SurfaceArea(_nodes[c].box);
+		int c1 = _nodes[c].child1;
+		int c2 = _nodes[c].child2;
+
+		float gain = area - SurfaceArea(Union(_nodes[b].box, _nodes[c2].box));
+		if (gain > bestGain) { bestGain = gain; bestRotation = B_C1; }
+
+		gain = area - SurfaceArea(Union(_nodes[b].box, _nodes[c1].box));
+		if (gain > bestGain) { bestGain = gain; bestRotation = B_C2; }
+	}
+
+	if (!_nodes[b].isLeaf())
+	{
+		float area = SurfaceArea(_nodes[b].box);
+		int b1 = _nodes[b].child1;
+		int b2 = _nodes[b].child2;
+
+		float gain = area - SurfaceArea(Union(_nodes[c].box, _nodes[b2].box));
+		if (gain > bestGain) { bestGain = gain; bestRotation = C_B1; }
+
+		gain = area - SurfaceArea(Union(_nodes[c].box, _nodes[b1].box));
+		if (gain > bestGain) { bestGain = gain; bestRotation = C_B2; }
+	}
+
+	if (bestRotation == None)
+	{
+		return;
+	}
+
+	// Every swap has the same shape: the node "moving" trades places with the grandchild "swapped", which sits
+	// under "receiver", the other child of this node.
+	int moving, receiver, swapped;
+	switch (bestRotation)
+	{
+	case B_C1: moving = b; receiver = c; swapped = _nodes[c].child1; break;
+	case B_C2: moving = b; receiver = c; swapped = _nodes[c].child2; break;
+	case C_B1: moving = c; receiver = b; swapped = _nodes[b].child1; break;
+	default: moving = c; receiver = b; swapped = _nodes[b].child2; break;
+	}
+
+	if (a.child1 == moving) a.child1 = swapped;
+	else a.child2 = swapped;
+	_nodes[swapped].parent = node;
+
+	DynamicAABBTreeNode& r = _nodes[receiver];
+	if (r.child1 == swapped) r.child1 = moving;
+	else r.child2 = moving;
+	_nodes[moving].parent = receiver;
+
+	const DynamicAABBTreeNode& r1 = _nodes[r.child1];
+	const DynamicAABBTreeNode& r2 = _nodes[r.child2];
+	r.box = Union(r1.box, r2.box);
+	r.height = 1 + (r1.height > r2.height ? r1.height : r2.height);
+}
+
+void DynamicAABBTree::Query(const BroadphaseAABB& box, std::vector<uint32_t>& results)
+{
+	if (_root == NULL_NODE)
+	{
+		return;
+	}
+
+	_stack.clear();
+	_stack.push_back(_root);
+	while (!_stack.empty())
+	{
+		int index = _stack.back();
+		_stack.pop_back();
+
+		const DynamicAABBTreeNode& node = _nodes[index];
+		if (!Overlaps(node.box, box))
+		{
+			continue;
+		}
+
+		if (node.isLeaf())
+		{
+			results.push_back(node.id);
+		}
+		else
+		{
+			_stack.push_back(node.child1);
+			_stack.push_back(node.child2);
+		}
+	}
+}
+
+// Each leaf searches the tree with its own box. Every overlapping pair would be found from both ends, so
+// a leaf only keeps the leaves that come after it in the node array.
+void DynamicAABBTree::FindPairs(std::vector<BroadphasePair>& pairs)
+{
+	pairs.clear();
+
+	int numNodes = _nodes.size();
+	for (int leaf = 0; leaf < numNodes; ++leaf)
+	{
+		const DynamicAABBTreeNode& leafNode = _nodes[leaf];
+		if (leafNode.height != 0)
+		{
+			continue;
+		}
+
+		_stack.clear();
+		_stack.push_back(_root);
+		while (!_stack.empty())
+		{
+			int index = _stack.back();
+			_stack.pop_back();
+
+			const DynamicAABBTreeNode& node = _nodes[index];
+			if (!Overlaps(node.box, leafNode.box))
+			{
+				continue;
+			}
+
+			if (node.isLeaf())
+			{
+				if (index > leaf)
+				{
+					pairs.push_back(MakePair(leafNode.id, node.id));
+				}
+			}
+			else
+			{
+				_stack.push_back(node.child1);
+				_stack.push_back(node.child2);
+			}
+		}
+	}
+}
+
+const BroadphaseAABB& DynamicAABBTree::GetFatAABB(int proxy) const
+{
+	return _nodes[proxy].box;
+}
+
+int DynamicAABBTree::height() const
+{
+	return _root == NULL_NODE ? 0 : _nodes[_root].height;
+}
+
+int DynamicAABBTree::proxyCount() const
+{
+	return _proxyCount;
+}
+
+size_t DynamicAABBTree::memoryUsed() const
+{
+	return _nodes.capacity() * sizeof(DynamicAABBTreeNode) + _stack.capacity() * sizeof(int);
+}
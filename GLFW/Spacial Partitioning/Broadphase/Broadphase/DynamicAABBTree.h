@@ -0,0 +1,105 @@
+#pragma once
+#include <vector>
+#include "Broadphase.h"
+
+// A node of the tree. Leaves hold one object each; interior nodes always have exactly two children and a box
+// that covers both of them. Nodes are kept in one array and refer to each other by index, so the array can
+// grow without invalidating anything, and removed nodes are kept on a free list to be handed out again.
+struct DynamicAABBTreeNode
+{
+	BroadphaseAABB box;
+	// The parent of a node in the tree, or the next node of the free list
+	int parent;
+	int child1;
+	int child2;
+	// Leaves are at height 0, nodes on the free list at -1
+	int height;
+	// The id of the object in a leaf
+	uint32_t id;
+
+	bool isLeaf() const { return child1 == DynamicAABBTreeNode::Null; }
+
+	static const int Null = -1;
+};
+
+// A bounding volume hierarchy that is updated as objects move instead of being rebuilt. Each object gets a leaf
+// whose box is its own box grown by a margin, so small movements do not touch the tree at all. When an object
+// does leave its fat box, its leaf is taken out and inserted again, which costs O(log n).
+class DynamicAABBTree
+{
+public:
+	///
+	//Parameters:
+	//	margin: How far the box stored for an object reaches past the object's own box on every side
+	//	displacementMultiplier: How many frames of movement the stored box is stretched ahead of a moving object
+	DynamicAABBTree(float margin = 0.1f, float displacementMultiplier = 2.0f);
+	~DynamicAABBTree();
+
+	///
+	//Adds an object to the tree
+	//
+	//Parameters:
+	//	box: The object's box
+	//	id: The id the object is reported by in queries and pairs
+	//
+	//Returns:
+	//	The proxy to pass to MoveProxy and DestroyProxy for this object
+	int CreateProxy(const BroadphaseAABB& box, uint32_t id);
+
+	///
+	//Removes an object from the tree
+	void DestroyProxy(int proxy);
+
+	///
+	//Tells the tree where an object is now
+	//
+	//Parameters:
+	//	proxy: The object's proxy
+	//	box: The object's new box
+	//	displacement: How far the object moved since the last update
+	//
+	//Returns:
+	//	True if the object left its fat box and had to be re-inserted
+	bool MoveProxy(int proxy, const BroadphaseAABB& box, const glm::vec3& displacement);
+
+	///
+	//Appends the ids of all objects whose fat boxes overlap a box to results
+	void Query(const BroadphaseAABB& box, std::vector<uint32_t>& results);
+
+	///
+	//Finds every pair of objects whose fat boxes overlap. The pair buffer is cleared first and reused, so
+	//once it has grown to its largest size finding pairs does not touch the heap.
+	void FindPairs(std::vector<BroadphasePair>& pairs);
+
+	const BroadphaseAABB& GetFatAABB(int proxy) const;
+
+	// The height of the root, 0 for a tree with only one object
+	int height() const;
+
+	int proxyCount() const;
+
+	// Bytes held by the node pool and scratch buffers
+	size_t memoryUsed() const;
+
+private:
+
+	int AllocateNode();
+	void FreeNode(int node);
+
+	void InsertLeaf(int leaf);
+	void RemoveLeaf(int leaf);
+
+	// Walks from a node up to the root, rotating and refitting each node on the way
+	void Refit(int node);
+	void Rotate(int node);
+
+	std::vector<DynamicAABBTreeNode> _nodes;
+	int _root;
+	int _freeList;
+	int _proxyCount;
+	float _margin;
+	float _displacementMultiplier;
+
+	// The stack of nodes left to visit during a query, kept so queries do not allocate
+	std::vector<int> _stack;
+};
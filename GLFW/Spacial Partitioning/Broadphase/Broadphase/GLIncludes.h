@@ -0,0 +1,67 @@
+/*
+Title: Broadphase
+File Name: GLIncludes.h
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+See main.cpp
+
+References:
+Real time collision Detection by Ericson
+3D Sphere collision with MTV derivation and decoupling by Srinivasan Thiagarajan
+*/
+
+
+#ifndef _GL_INCLUDES_H
+#define _GL_INCLUDES_H
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "glew\glew.h"
+#include "glfw\glfw3.h"
+#include "glm\glm.hpp"
+#include "glm\gtc\matrix_transform.hpp"
+#include "glm\gtc\type_ptr.hpp"
+#include "glm\gtx\transform.hpp"
+
+
+#define PI 3.14159265
+#define DIVISIONS  10
+
+// We create a VertexFormat struct, which defines how the data passed into the shader code wil be formatted
+struct VertexFormat
+{
+	glm::vec4 color;	// A vector4 for color has 4 floats: red, green, blue, and alpha
+	glm::vec3 position;	// A vector3 for position has 3 float: x, y, and z coordinates
+
+	// Default constructor
+	VertexFormat()
+	{
+		color = glm::vec4(0.0f);
+		position = glm::vec3(0.0f);
+	}
+
+	// Constructor
+	VertexFormat(const glm::vec3 &pos, const glm::vec4 &iColor)
+	{
+		position = pos;
+		color = iColor;
+	}
+};
+
+#endif _GL_INCLUDES_H
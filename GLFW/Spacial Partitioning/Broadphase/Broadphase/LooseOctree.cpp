@@ -0,0 +1,413 @@
+#include "LooseOctree.h"
+
+#include <math.h>
+
+#define NO_NODE -1
+#define ROOT_NODE 0
+#define MAX_OCTREE_DEPTH 16
+
+// Each coordinate of a cell is less than 2^16, since the tree is at most 16 levels deep
+uint64_t CellKey(int depth, uint32_t x, uint32_t y, uint32_t z)
+{
+	return ((uint64_t)depth << 48) | ((uint64_t)x << 32) | ((uint64_t)y << 16) | (uint64_t)z;
+}
+
+bool BoxInFrustum(const BroadphaseAABB& box, const glm::vec4 planes[6])
+{
+	for (int i = 0; i < 6; ++i)
+	{
+		// The corner of the box furthest along the plane's normal. If even that is behind the plane, the whole box is.
+		glm::vec3 corner = glm::vec3(
+			planes[i].x > 0.0f ? box.max.x : box.min.x,
+			planes[i].y > 0.0f ? box.max.y : box.min.y,
+			planes[i].z > 0.0f ? box.max.z : box.min.z);
+		if (glm::dot(glm::vec3(planes[i]), corner) + planes[i].w < 0.0f)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Clips the ray against the slab between the box's faces on each axis in turn. The ray hits the box if some
+// part of it is left once all three slabs have been clipped.
+bool RayHitsBox(const BroadphaseAABB& box, const glm::vec3& origin, const glm::vec3& direction, float maxT)
+{
+	float tMin = 0.0f;
+	float tMax = maxT;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		if (direction[axis] == 0.0f)
+		{
+			if (origin[axis] < box.min[axis] || origin[axis] > box.max[axis]) return false;
+			continue;
+		}
+
+		float t1 = (box.min[axis] - origin[axis]) / direction[axis];
+		float t2 = (box.max[axis] - origin[axis]) / direction[axis];
+		if (t1 > t2) { float t = t1; t1 = t2; t2 = t; }
+		if (t1 > tMin) tMin = t1;
+		if (t2 < tMax) tMax = t2;
+		if (tMin > tMax) return false;
+	}
+	return true;
+}
+
+LooseOctree::LooseOctree(const glm::vec3& center, float halfSize, int maxDepth)
+{
+	_min = center - glm::vec3(halfSize);
+	_size = halfSize * 2.0f;
+	_maxDepth = maxDepth < 0 ? 0 : (maxDepth > MAX_OCTREE_DEPTH ? MAX_OCTREE_DEPTH : maxDepth);
+	_freeNodes = NO_NODE;
+	_freeObjects = NO_NODE;
+	_proxyCount = 0;
+	_nodeCount = 0;
+
+	// The root always exists. Its loose box is never tested, since it also holds everything that did not fit elsewhere.
+	GetNode(0, 0, 0, 0);
+}
+
+LooseOctree::~LooseOctree()
+{
+}
+
+// The cells at depth d are size / 2^d wide, and the loose box reaches half a cell past each side. An object fits in
+// a cell at depth d if its largest half extent is no more than half that width, so the deepest depth it fits at
+// is the floor of log2(size / (2 * halfExtent)), which frexp gives us without a loop.
+int LooseOctree::FindNode(const BroadphaseAABB& box)
+{
+	glm::vec3 halfExtents = (box.max - box.min) * 0.5f;
+	float halfExtent = glm::max(halfExtents.x, glm::max(halfExtents.y, halfExtents.z));
+
+	int depth = _maxDepth;
+	if (halfExtent > 0.0f)
+	{
+		int exponent;
+		frexp(_size / (2.0f * halfExtent), &exponent);
+		depth = exponent - 1;
+		if (depth < 0) depth = 0;
+		if (depth > _maxDepth) depth = _maxDepth;
+	}
+
+	if (depth == 0)
+	{
+		return ROOT_NODE;
+	}
+
+	glm::vec3 center = (box.min + box.max) * 0.5f;
+	float cells = (float)(1u << depth);
+	glm::vec3 cell = glm::floor((center - _min) / _size * cells);
+	if (cell.x < 0.0f || cell.y < 0.0f || cell.z < 0.0f || cell.x >= cells || cell.y >= cells || cell.z >= cells)
+	{
+		return ROOT_NODE;
+	}
+
+	return GetNode(depth, (uint32_t)cell.x, (uint32_t)cell.y, (uint32_t)cell.z);
+}
+
+// Looking a cell up in the map is constant time. Only when the cell is new do we have to make sure its parents
+// exist as well, and that stops at the first parent that already does.
+int LooseOctree::GetNode(int depth, uint32_t x, uint32_t y, uint32_t z)
+{
+	uint64_t key = CellKey(depth, x, y, z);
+	std::unordered_map<uint64_t, int>::iterator it = _cells.find(key);
+	if (it != _cells.end())
+	{
+		return it->second;
+	}
+
+	int parent = depth > 0 ? GetNode(depth - 1, x >> 1, y >> 1, z >> 1) : NO_NODE;
+
+	int node;
+	if (_freeNodes != NO_NODE)
+	{
+		node = _freeNodes;
+		_freeNodes = _nodes[node].parent;
+	}
+	else
+	{
+		node = _nodes.size();
+		_nodes.push_back(LooseOctreeNode());
+	}
+
+	LooseOctreeNode& n = _nodes[node];
+	float width = _size / (float)(1u << depth);
+	glm::vec3 cellMin = _min + glm::vec3((float)x, (float)y, (float)z) * width;
+	n.looseBox.min = cellMin - glm::vec3(width * 0.5f);
+	n.looseBox.max = cellMin + glm::vec3(width * 1.5f);
+	for (int i = 0; i < 8; ++i) n.children[i] = NO_NODE;
+	n.parent = parent;
+	n.firstObject = NO_NODE;
+	n.numObjects = 0;
+	n.numChildren = 0;
+	n.depth = depth;
+	n.x = x;
+	n.y = y;
+	n.z = z;
+
+	if (parent != NO_NODE)
+	{
+		int slot = (x & 1) | ((y & 1) << 1) | ((z & 1) << 2);
+		_nodes[parent].children[slot] = node;
+		_nodes[parent].numChildren++;
+	}
+
+	_cells[key] = node;
+	_nodeCount++;
+	return node;
+}
+
+void LooseOctree::ReleaseIfEmpty(int node)
+{
+	while (node != ROOT_NODE && _nodes[node].numObjects == 0 && _nodes[node].numChildren == 0)
+	{
+		LooseOctreeNode& n = _nodes[node];
+		int parent = n.parent;
+		int slot = (n.x & 1) | ((n.y & 1) << 1) | ((n.z & 1) << 2);
+		_nodes[parent].children[slot] = NO_NODE;
+		_nodes[parent].numChildren--;
+
+		_cells.erase(CellKey(n.depth, n.x, n.y, n.z));
+		n.parent = _freeNodes;
+		_freeNodes = node;
+		_nodeCount--;
+
+		node = parent;
+	}
+}
+
+void LooseOctree::Link(int object, int node)
+{
+	LooseOctreeObject& o = _objects[object];
+	LooseOctreeNode& n = _nodes[node];
+	o.node = node;
+	o.prev = NO_NODE;
+	o.next = n.firstObject;
+	if (n.firstObject != NO_NODE) _objects[n.firstObject].prev = object;
+	n.firstObject = object;
+	n.numObjects++;
+}
+
+void LooseOctree::Unlink(int object)
+{
+	LooseOctreeObject& o = _objects[object];
+	LooseOctreeNode& n = _nodes[o.node];
+	if (o.prev != NO_NODE) _objects[o.prev].next = o.next;
+	else n.firstObject = o.next;
+	if (o.next != NO_NODE) _objects[o.next].prev = o.prev;
+	n.numObjects--;
+}
+
+int LooseOctree::CreateProxy(const BroadphaseAABB& box, uint32_t id)
+{
+	int object;
+	if (_freeObjects != NO_NODE)
+	{
+		object = _freeObjects;
+		_freeObjects = _objects[object].next;
+	}
+	else
+	{
+		object = _objects.size();
+		_objects.push_back(LooseOctreeObject());
+	}
+
+	_objects[object].box = box;
+	_objects[object].id = id;
+	Link(object, FindNode(box));
+	_proxyCount++;
+	return object;
+}
+
+void LooseOctree::DestroyProxy(int proxy)
+{
+	int node = _objects[proxy].node;
+	Unlink(proxy);
+	ReleaseIfEmpty(node);
+
+	_objects[proxy].node = NO_NODE;
+	_objects[proxy].next = _freeObjects;
+	_freeObjects = proxy;
+	_proxyCount--;
+}
+
+void LooseOctree::MoveProxy(int proxy, const BroadphaseAABB& box)
+{
+	_objects[proxy].box = box;
+
+	int oldNode = _objects[proxy].node;
+	int newNode = FindNode(box);
+	if (newNode == oldNode)
+	{
+		return;
+	}
+
+	Unlink(proxy);
+	Link(proxy, newNode);
+	ReleaseIfEmpty(oldNode);
+}
+
+void LooseOctree::QueryBox(const BroadphaseAABB& box, std::vector<uint32_t>& results)
+{
+	_stack.clear();
+	_stack.push_back(ROOT_NODE);
+	while (!_stack.empty())
+	{
+		const LooseOctreeNode& node = _nodes[_stack.back()];
+		bool isRoot = _stack.back() == ROOT_NODE;
+		_stack.pop_back();
+
+		if (!isRoot && !Overlaps(node.looseBox, box))
+		{
+			continue;
+		}
+
+		for (int o = node.firstObject; o != NO_NODE; o = _objects[o].next)
+		{
+			if (Overlaps(_objects[o].box, box)) results.push_back(_objects[o].id);
+		}
+
+		for (int i = 0; i < 8; ++i)
+		{
+			if (node.children[i] != NO_NODE) _stack.push_back(node.children[i]);
+		}
+	}
+}
+
+void LooseOctree::QueryFrustum(const glm::vec4 planes[6], std::vector<uint32_t>& results)
+{
+	_stack.clear();
+	_stack.push_back(ROOT_NODE);
+	while (!_stack.empty())
+	{
+		const LooseOctreeNode& node = _nodes[_stack.back()];
+		bool isRoot = _stack.back() == ROOT_NODE;
+		_stack.pop_back();
+
+		if (!isRoot && !BoxInFrustum(node.looseBox, planes))
+		{
+			continue;
+		}
+
+		for (int o = node.firstObject; o != NO_NODE; o = _objects[o].next)
+		{
+			if (BoxInFrustum(_objects[o].box, planes)) results.push_back(_objects[o].id);
+		}
+
+		for (int i = 0; i < 8; ++i)
+		{
+			if (node.children[i] != NO_NODE) _stack.push_back(node.children[i]);
+		}
+	}
+}
+
+void LooseOctree::QueryRay(const glm::vec3& origin, const glm::vec3& direction, float maxT, std::vector<uint32_t>& results)
+{
+	_stack.clear();
+	_stack.push_back(ROOT_NODE);
+	while (!_stack.empty())
+	{
+		const LooseOctreeNode& node = _nodes[_stack.back()];
+		bool isRoot = _stack.back() == ROOT_NODE;
+		_stack.pop_back();
+
+		if (!isRoot && !RayHitsBox(node.looseBox, origin, direction, maxT))
+		{
+			continue;
+		}
+
+		for (int o = node.firstObject; o != NO_NODE; o = _objects[o].next)
+		{
+			if (RayHitsBox(_objects[o].box, origin, direction, maxT)) results.push_back(_objects[o].id);
+		}
+
+		for (int i = 0; i < 8; ++i)
+		{
+			if (node.children[i] != NO_NODE) _stack.push_back(node.children[i]);
+		}
+	}
+}
+
+// Each object searches the tree with its own box. Every overlapping pair would be found from both ends, so
+// an object only keeps the objects that come after it in the object array.
+void LooseOctree::FindPairs(std::vector<BroadphasePair>& pairs)
+{
+	pairs.clear();
+
+	int numObjects = _objects.size();
+	for (int object = 0; object < numObjects; ++object)
+	{
+		const LooseOctreeObject& obj = _objects[object];
+		if (obj.node == NO_NODE)
+		{
+			continue;
+		}
+
+		_stack.clear();
+		_stack.push_back(ROOT_NODE);
+		while (!_stack.empty())
+		{
+			const LooseOctreeNode& node = _nodes[_stack.back()];
+			bool isRoot = _stack.back() == ROOT_NODE;
+			_stack.pop_back();
+
+			if (!isRoot && !Overlaps(node.looseBox, obj.box))
+			{
+				continue;
+			}
+
+			for (int o = node.firstObject; o != NO_NODE; o = _objects[o].next)
+			{
+				if (o > object && Overlaps(_objects[o].box, obj.box)) pairs.push_back(MakePair(obj.id, _objects[o].id));
+			}
+
+			for (int i = 0; i < 8; ++i)
+			{
+				if (node.children[i] != NO_NODE) _stack.push_back(node.children[i]);
+			}
+		}
+	}
+}
+
+int LooseOctree::proxyCount() const
+{
+	return _proxyCount;
+}
+
+int LooseOctree::nodeCount() const
+{
+	return _nodeCount;
+}
+
+// The map's nodes are not counted exactly; each entry is estimated as its key and value plus a pointer
+size_t LooseOctree::memoryUsed() const
+{
+	size_t bytes = _nodes.capacity() * sizeof(LooseOctreeNode);
+	bytes += _objects.capacity() * sizeof(LooseOctreeObject);
+	bytes += _cells.size() * (sizeof(uint64_t) + sizeof(int) + sizeof(void*));
+	bytes += _cells.bucket_count() * sizeof(void*);
+	bytes += _stack.capacity() * sizeof(int);
+	return bytes;
+}
+
+// Each plane is a sum or difference of the matrix's last row with one of the others (Gribb and Hartmann).
+// glm matrices are indexed by column first.
+void LooseOctree::ExtractFrustumPlanes(const glm::mat4& m, glm::vec4 planes[6])
+{
+	glm::vec4 row0 = glm::vec4(m[0][0], m[1][0], m[2][0], m[3][0]);
+	glm::vec4 row1 = glm::vec4(m[0][1], m[1][1], m[2][1], m[3][1]);
+	glm::vec4 row2 = glm::vec4(m[0][2], m[1][2], m[2][2], m[3][2]);
+	glm::vec4 row3 = glm::vec4(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+	planes[0] = row3 + row0;	// Left
+	planes[1] = row3 - row0;	// Right
+	planes[2] = row3 + row1;	// Bottom
+	planes[3] = row3 - row1;	// Top
+	planes[4] = row3 + row2;	// Near
+	planes[5] = row3 - row2;	// Far
+
+	for (int i = 0; i < 6; ++i)
+	{
+		planes[i] /= glm::length(glm::vec3(planes[i]));
+	}
+}
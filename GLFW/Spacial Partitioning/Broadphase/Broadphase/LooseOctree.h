@@ -0,0 +1,135 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include "Broadphase.h"
+
+// A cell of the octree. Each cell's loose box is twice the size of the cell itself, so an object whose center is
+// in the cell and whose half extent is no bigger than half the cell's width is always inside the loose box.
+struct LooseOctreeNode
+{
+	BroadphaseAABB looseBox;
+	int children[8];
+	int parent;
+	// The first object stored in this cell, the rest follow through each object's next
+	int firstObject;
+	int numObjects;
+	// Number of children that exist, so empty leaves can be found without checking all 8
+	int numChildren;
+	int depth;
+	// The cell's position in the grid of cells at its depth
+	uint32_t x, y, z;
+};
+
+struct LooseOctreeObject
+{
+	BroadphaseAABB box;
+	uint32_t id;
+	int node;
+	int prev;
+	int next;
+};
+
+// A loose octree over a cube of the world. Every object is kept in exactly one cell, at the depth whose cells are
+// just big enough for it, so big objects sit near the root and small objects near the leaves, and an object's
+// whole box (not only its center) is always inside the loose box of the cell holding it. The depth comes straight
+// from the size of the object and the cell from its center, and cells are found through a hash map, so adding and
+// moving an object takes constant time. Cells are only created once something is put in them and are returned
+// to a pool once they are empty.
+class LooseOctree
+{
+public:
+	///
+	//Parameters:
+	//	center: The center of the cube the tree covers
+	//	halfSize: Half the width of the cube the tree covers
+	//	maxDepth: The deepest level cells can be made at, at most 16
+	LooseOctree(const glm::vec3& center = glm::vec3(0.0f), float halfSize = 1.0f, int maxDepth = 8);
+	~LooseOctree();
+
+	///
+	//Adds an object to the tree. Objects whose centers lie outside the cube, or that are too big for any
+	//cell, are kept at the root, which every query visits.
+	//
+	//Parameters:
+	//	box: The object's box
+	//	id: The id the object is reported by in queries and pairs
+	//
+	//Returns:
+	//	The proxy to pass to MoveProxy and DestroyProxy for this object
+	int CreateProxy(const BroadphaseAABB& box, uint32_t id);
+
+	///
+	//Removes an object from the tree
+	void DestroyProxy(int proxy);
+
+	///
+	//Moves an object's box, moving it to a different cell only if it needs one
+	void MoveProxy(int proxy, const BroadphaseAABB& box);
+
+	///
+	//Appends the ids of all objects whose boxes overlap a box to results
+	void QueryBox(const BroadphaseAABB& box, std::vector<uint32_t>& results);
+
+	///
+	//Appends the ids of all objects whose boxes are at least partly inside a frustum to results
+	//
+	//Parameters:
+	//	planes: The frustum's six planes, as (normal, distance) with normals facing inwards. See ExtractFrustumPlanes.
+	//	results: Destination of the ids found
+	void QueryFrustum(const glm::vec4 planes[6], std::vector<uint32_t>& results);
+
+	///
+	//Appends the ids of all objects whose boxes are hit by a ray to results
+	//
+	//Parameters:
+	//	origin: Where the ray starts
+	//	direction: The direction of the ray, need not be normalized
+	//	maxT: How far along the ray to search, in multiples of direction
+	//	results: Destination of the ids found
+	void QueryRay(const glm::vec3& origin, const glm::vec3& direction, float maxT, std::vector<uint32_t>& results);
+
+	///
+	//Finds every pair of objects whose boxes overlap. The pair buffer is cleared first and reused.
+	void FindPairs(std::vector<BroadphasePair>& pairs);
+
+	int proxyCount() const;
+
+	// The number of cells currently in use
+	int nodeCount() const;
+
+	// Bytes held by the node and object pools, the cell map and scratch buffers
+	size_t memoryUsed() const;
+
+	///
+	//Gets the six planes of the frustum of a view projection matrix, normals facing inwards
+	static void ExtractFrustumPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6]);
+
+private:
+
+	// Finds the cell an object belongs in, creating it if it does not exist yet
+	int FindNode(const BroadphaseAABB& box);
+	int GetNode(int depth, uint32_t x, uint32_t y, uint32_t z);
+
+	void Link(int object, int node);
+	void Unlink(int object);
+
+	// Returns a node with no objects or children to the pool, then does the same for its parent if that empties it
+	void ReleaseIfEmpty(int node);
+
+	std::vector<LooseOctreeNode> _nodes;
+	std::vector<LooseOctreeObject> _objects;
+	int _freeNodes;
+	int _freeObjects;
+	int _proxyCount;
+	int _nodeCount;
+
+	// Cells by depth and position, so any cell can be found without walking down from the root
+	std::unordered_map<uint64_t, int> _cells;
+
+	glm::vec3 _min;
+	float _size;
+	int _maxDepth;
+
+	// The stack of nodes left to visit during a query, kept so queries do not allocate
+	std::vector<int> _stack;
+};
@@ -0,0 +1,341 @@
+#include "SweepAndPrune.h"
+
+#include <algorithm>
+
+// Minimums sort before maximums of the same value, so touching boxes overlap
+bool EndpointLess(const SAPEndpoint& a, const SAPEndpoint& b)
+{
+	return a.value < b.value || (a.value == b.value && !a.isMax() && b.isMax());
+}
+
+// Pairs are looked up by their two proxies, smallest first
+uint64_t PairKey(uint32_t proxy1, uint32_t proxy2)
+{
+	return proxy1 < proxy2 ? ((uint64_t)proxy1 << 32) | proxy2 : ((uint64_t)proxy2 << 32) | proxy1;
+}
+
+SweepAndPrune::SweepAndPrune()
+{
+	_proxyCount = 0;
+	_needsRebuild = false;
+	_stamp = 0;
+	_pairAdded = 0;
+	_pairRemoved = 0;
+	_userData = 0;
+}
+
+SweepAndPrune::~SweepAndPrune()
+{
+}
+
+// The new endpoints are only appended here. Rebuild sorts them into place the next time pairs are asked for.
+int SweepAndPrune::CreateProxy(const BroadphaseAABB& box, uint32_t id)
+{
+	uint32_t proxy;
+	if (!_freeProxies.empty())
+	{
+		proxy = _freeProxies.back();
+		_freeProxies.pop_back();
+	}
+	else
+	{
+		proxy = _proxies.size();
+		_proxies.push_back(SAPProxy());
+	}
+
+	SAPProxy& p = _proxies[proxy];
+	p.box = box;
+	p.id = id;
+	p.alive = true;
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		SAPEndpoint min = { box.min[axis], proxy << 1 };
+		SAPEndpoint max = { box.max[axis], (proxy << 1) | 1u };
+		p.minIndex[axis] = _endpoints[axis].size();
+		_endpoints[axis].push_back(min);
+		p.maxIndex[axis] = _endpoints[axis].size();
+		_endpoints[axis].push_back(max);
+	}
+
+	_needsRebuild = true;
+	++_proxyCount;
+	return proxy;
+}
+
+// The proxy's endpoints are taken out of each array, which keeps the rest of the array in order.
+// Everything after them shifts down, so those endpoints' proxies have their indices corrected.
+void SweepAndPrune::DestroyProxy(int proxy)
+{
+	for (int i = _pairs.size() - 1; i >= 0; --i)
+	{
+		uint64_t key = _pairKeys[i];
+		if ((uint32_t)(key >> 32) == (uint32_t)proxy || (uint32_t)key == (uint32_t)proxy)
+		{
+			RemovePairAt(i);
+		}
+	}
+
+	SAPProxy& p = _proxies[proxy];
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		std::vector<SAPEndpoint>& endpoints = _endpoints[axis];
+		uint32_t first = p.minIndex[axis] < p.maxIndex[axis] ? p.minIndex[axis] : p.maxIndex[axis];
+		endpoints.erase(endpoints.begin() + (p.maxIndex[axis] > p.minIndex[axis] ? p.maxIndex[axis] : p.minIndex[axis]));
+		endpoints.erase(endpoints.begin() + first);
+
+		for (uint32_t i = first; i < endpoints.size(); ++i)
+		{
+			SAPProxy& other = _proxies[endpoints[i].proxy()];
+			if (endpoints[i].isMax()) other.maxIndex[axis] = i;
+			else other.minIndex[axis] = i;
+		}
+	}
+
+	p.alive = false;
+	_freeProxies.push_back(proxy);
+	--_proxyCount;
+}
+
+// Each end of the box is moved in the order that keeps a box's minimum from ever passing its own maximum:
+// first the ends that grow the box, then the ends that shrink it.
+void SweepAndPrune::MoveProxy(int proxy, const BroadphaseAABB& box)
+{
+	SAPProxy& p = _proxies[proxy];
+	BroadphaseAABB old = p.box;
+	p.box = box;
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		std::vector<SAPEndpoint>& endpoints = _endpoints[axis];
+		endpoints[p.minIndex[axis]].value = box.min[axis];
+		endpoints[p.maxIndex[axis]].value = box.max[axis];
+
+		// Unsorted endpoints will be sorted from scratch anyway
+		if (_needsRebuild)
+		{
+			continue;
+		}
+
+		if (box.min[axis] < old.min[axis]) SortDown(axis, p.minIndex[axis]);
+		if (box.max[axis] > old.max[axis]) SortUp(axis, p.maxIndex[axis]);
+		if (box.min[axis] > old.min[axis]) SortUp(axis, p.minIndex[axis]);
+		if (box.max[axis] < old.max[axis]) SortDown(axis, p.maxIndex[axis]);
+	}
+}
+
+// An endpoint moving down past another box's endpoint of the other kind either moves a minimum below a
+// maximum, which is where an overlap begins, or moves a maximum below a minimum, which is where one ends.
+void SweepAndPrune::SortDown(int axis, uint32_t index)
+{
+	std::vector<SAPEndpoint>& endpoints = _endpoints[axis];
+	while (index > 0 && EndpointLess(endpoints[index], endpoints[index - 1]))
+	{
+		Swap(axis, index - 1, index, !endpoints[index].isMax());
+		--index;
+	}
+}
+
+// Moving up is the mirror image: a maximum passing a minimum begins an overlap, a minimum passing a maximum ends one
+void SweepAndPrune::SortUp(int axis, uint32_t index)
+{
+	std::vector<SAPEndpoint>& endpoints = _endpoints[axis];
+	uint32_t last = endpoints.size() - 1;
+	while (index < last && EndpointLess(endpoints[index + 1], endpoints[index]))
+	{
+		Swap(axis, index, index + 1, endpoints[index].isMax());
+		++index;
+	}
+}
+
+// Two boxes overlap along an axis if each one's minimum comes before the other's maximum in that axis's array
+bool SweepAndPrune::OverlapsOnOtherAxes(uint32_t proxy1, uint32_t proxy2, int axis) const
+{
+	const SAPProxy& p1 = _proxies[proxy1];
+	const SAPProxy& p2 = _proxies[proxy2];
+	int axis1 = (axis + 1) % 3;
+	int axis2 = (axis + 2) % 3;
+	return p1.minIndex[axis1] < p2.maxIndex[axis1] && p2.minIndex[axis1] < p1.maxIndex[axis1]
+		&& p1.minIndex[axis2] < p2.maxIndex[axis2] && p2.minIndex[axis2] < p1.maxIndex[axis2];
+}
+
+// Endpoints of the same kind passing each other changes nothing. Otherwise the two boxes have started or stopped
+// overlapping along this axis. A pair is in the set exactly when the boxes overlap in all three endpoint arrays,
+// so it can only start or stop overlapping if the other two arrays already have the boxes overlapping. Checking
+// that first is only a few comparisons, and spares looking up the many boxes that pass each other along one
+// axis while being nowhere near each other along the others.
+void SweepAndPrune::Swap(int axis, uint32_t index1, uint32_t index2, bool beginsOverlap)
+{
+	std::vector<SAPEndpoint>& endpoints = _endpoints[axis];
+	SAPEndpoint e1 = endpoints[index1];
+	SAPEndpoint e2 = endpoints[index2];
+
+	if (e1.isMax() != e2.isMax())
+	{
+		uint32_t proxy1 = e1.proxy();
+		uint32_t proxy2 = e2.proxy();
+		if (OverlapsOnOtherAxes(proxy1, proxy2, axis))
+		{
+			if (beginsOverlap) AddPair(proxy1, proxy2);
+			else RemovePair(proxy1, proxy2);
+		}
+	}
+
+	endpoints[index1] = e2;
+	endpoints[index2] = e1;
+
+	SAPProxy& p1 = _proxies[e1.proxy()];
+	SAPProxy& p2 = _proxies[e2.proxy()];
+	if (e1.isMax()) p1.maxIndex[axis] = index2;
+	else p1.minIndex[axis] = index2;
+	if (e2.isMax()) p2.maxIndex[axis] = index1;
+	else p2.minIndex[axis] = index1;
+}
+
+// Sweeping along x, a box is added to the active list at its minimum and dropped at its maximum. Every box
+// whose minimum is reached while another box is active overlaps it along x, so only those need checking on the
+// other axes. Pairs that are still overlapping are stamped, and any pair left unstamped afterwards is removed,
+// so the callbacks only hear about pairs that actually changed.
+void SweepAndPrune::Rebuild()
+{
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		std::vector<SAPEndpoint>& endpoints = _endpoints[axis];
+		std::sort(endpoints.begin(), endpoints.end(), EndpointLess);
+		for (uint32_t i = 0; i < endpoints.size(); ++i)
+		{
+			SAPProxy& p = _proxies[endpoints[i].proxy()];
+			if (endpoints[i].isMax()) p.maxIndex[axis] = i;
+			else p.minIndex[axis] = i;
+		}
+	}
+
+	++_stamp;
+
+	// Each proxy's place in the active list, so it can be dropped without searching for it
+	_activeIndex.resize(_proxies.size());
+	_active.clear();
+	std::vector<SAPEndpoint>& endpoints = _endpoints[0];
+	for (uint32_t i = 0; i < endpoints.size(); ++i)
+	{
+		uint32_t proxy = endpoints[i].proxy();
+		if (endpoints[i].isMax())
+		{
+			uint32_t index = _activeIndex[proxy];
+			_active[index] = _active.back();
+			_activeIndex[_active[index]] = index;
+			_active.pop_back();
+			continue;
+		}
+
+		for (uint32_t j = 0; j < _active.size(); ++j)
+		{
+			if (OverlapsOnOtherAxes(proxy, _active[j], 0)) AddPair(proxy, _active[j]);
+		}
+		_activeIndex[proxy] = _active.size();
+		_active.push_back(proxy);
+	}
+
+	for (int i = _pairs.size() - 1; i >= 0; --i)
+	{
+		if (_pairStamps[i] != _stamp) RemovePairAt(i);
+	}
+
+	_needsRebuild = false;
+}
+
+void SweepAndPrune::AddPair(uint32_t proxy1, uint32_t proxy2)
+{
+	uint64_t key = PairKey(proxy1, proxy2);
+	std::unordered_map<uint64_t, uint32_t>::iterator it = _pairIndices.find(key);
+	if (it != _pairIndices.end())
+	{
+		_pairStamps[it->second] = _stamp;
+		return;
+	}
+
+	BroadphasePair pair = MakePair(_proxies[proxy1].id, _proxies[proxy2].id);
+	_pairIndices[key] = _pairs.size();
+	_pairs.push_back(pair);
+	_pairKeys.push_back(key);
+	_pairStamps.push_back(_stamp);
+
+	if (_pairAdded) _pairAdded(pair, _userData);
+}
+
+void SweepAndPrune::RemovePair(uint32_t proxy1, uint32_t proxy2)
+{
+	std::unordered_map<uint64_t, uint32_t>::iterator it = _pairIndices.find(PairKey(proxy1, proxy2));
+	if (it != _pairIndices.end())
+	{
+		RemovePairAt(it->second);
+	}
+}
+
+// The last pair is moved into the removed pair's place to keep the array dense
+void SweepAndPrune::RemovePairAt(uint32_t index)
+{
+	BroadphasePair pair = _pairs[index];
+	_pairIndices.erase(_pairKeys[index]);
+
+	uint32_t last = _pairs.size() - 1;
+	if (index != last)
+	{
+		_pairs[index] = _pairs[last];
+		_pairKeys[index] = _pairKeys[last];
+		_pairStamps[index] = _pairStamps[last];
+		_pairIndices[_pairKeys[index]] = index;
+	}
+	_pairs.pop_back();
+	_pairKeys.pop_back();
+	_pairStamps.pop_back();
+
+	if (_pairRemoved) _pairRemoved(pair, _userData);
+}
+
+void SweepAndPrune::FindPairs(std::vector<BroadphasePair>& pairs)
+{
+	if (_needsRebuild)
+	{
+		Rebuild();
+	}
+
+	pairs.assign(_pairs.begin(), _pairs.end());
+}
+
+void SweepAndPrune::SetPairCallbacks(PairCallback added, PairCallback removed, void* userData)
+{
+	_pairAdded = added;
+	_pairRemoved = removed;
+	_userData = userData;
+}
+
+const std::vector<BroadphasePair>& SweepAndPrune::pairs() const
+{
+	return _pairs;
+}
+
+int SweepAndPrune::proxyCount() const
+{
+	return _proxyCount;
+}
+
+// The map's nodes are not counted exactly; each entry is estimated as its key and value plus a pointer
+size_t SweepAndPrune::memoryUsed() const
+{
+	size_t bytes = 0;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		bytes += _endpoints[axis].capacity() * sizeof(SAPEndpoint);
+	}
+	bytes += _proxies.capacity() * sizeof(SAPProxy);
+	bytes += _freeProxies.capacity() * sizeof(uint32_t);
+	bytes += _pairs.capacity() * sizeof(BroadphasePair);
+	bytes += _pairKeys.capacity() * sizeof(uint64_t);
+	bytes += _pairStamps.capacity() * sizeof(uint32_t);
+	bytes += _pairIndices.size() * (sizeof(uint64_t) + sizeof(uint32_t) + sizeof(void*));
+	bytes += _pairIndices.bucket_count() * sizeof(void*);
+	bytes += _active.capacity() * sizeof(uint32_t);
+	bytes += _activeIndex.capacity() * sizeof(uint32_t);
+	return bytes;
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include "Broadphase.h"
+
+// One end of an object's box along one axis. Endpoints are kept sorted by value, with a minimum sorting before
+// a maximum of the same value so that boxes which only touch count as overlapping, the same as Overlaps.
+struct SAPEndpoint
+{
+	float value;
+	// The proxy this endpoint belongs to in the upper bits, and whether it is the maximum in the lowest bit
+	uint32_t data;
+
+	uint32_t proxy() const { return data >> 1; }
+	bool isMax() const { return (data & 1u) != 0; }
+};
+
+struct SAPProxy
+{
+	BroadphaseAABB box;
+	uint32_t id;
+	// Where this proxy's endpoints currently sit in each axis's endpoint array
+	uint32_t minIndex[3];
+	uint32_t maxIndex[3];
+	bool alive;
+};
+
+// Incremental sweep and prune. Each axis keeps every box's minimum and maximum in one sorted array, and the
+// arrays are kept between frames. Objects in a coherent scene only move a little each frame, so an insertion
+// sort puts the arrays back in order in close to linear time. Every time two endpoints swap places, two boxes
+// have started or stopped overlapping on that axis, which is how the set of overlapping pairs is kept up to
+// date without ever searching for it.
+class SweepAndPrune
+{
+public:
+	// Called with a pair when its boxes start or stop overlapping
+	typedef void (*PairCallback)(const BroadphasePair& pair, void* userData);
+
+	SweepAndPrune();
+	~SweepAndPrune();
+
+	///
+	//Adds an object. The endpoints of objects added since the last call to FindPairs are sorted in all at once
+	//the next time it is called, so adding many objects at a time costs a single sort instead of one insertion
+	//sort per object.
+	//
+	//Parameters:
+	//	box: The object's box
+	//	id: The id the object is reported by in pairs
+	//
+	//Returns:
+	//	The proxy to pass to MoveProxy and DestroyProxy for this object
+	int CreateProxy(const BroadphaseAABB& box, uint32_t id);
+
+	///
+	//Removes an object along with any pairs it is part of
+	void DestroyProxy(int proxy);
+
+	///
+	//Moves an object's box and repairs the endpoint arrays around it
+	void MoveProxy(int proxy, const BroadphaseAABB& box);
+
+	///
+	//Copies every pair of overlapping boxes into the pair buffer, which is cleared first. The copy reuses the
+	//buffer's memory, so once it has grown to its largest size this does not touch the heap.
+	void FindPairs(std::vector<BroadphasePair>& pairs);
+
+	///
+	//Sets the functions called when a pair starts or stops overlapping
+	//
+	//Parameters:
+	//	added: Called when two boxes start overlapping, may be null
+	//	removed: Called when two boxes stop overlapping or one of them is destroyed, may be null
+	//	userData: Passed along to both functions
+	void SetPairCallbacks(PairCallback added, PairCallback removed, void* userData);
+
+	// The current set of overlapping pairs, valid once any added objects have been sorted in by FindPairs
+	const std::vector<BroadphasePair>& pairs() const;
+
+	int proxyCount() const;
+
+	// Bytes held by the endpoint arrays, proxies and pair set
+	size_t memoryUsed() const;
+
+private:
+
+	void SortDown(int axis, uint32_t index);
+	void SortUp(int axis, uint32_t index);
+
+	// Whether two boxes overlap along the two axes other than the one given, going by the endpoint arrays
+	bool OverlapsOnOtherAxes(uint32_t proxy1, uint32_t proxy2, int axis) const;
+
+	// Handles two endpoints trading places in an axis
+	void Swap(int axis, uint32_t index1, uint32_t index2, bool beginsOverlap);
+
+	// Sorts every axis from scratch and finds every pair with a single sweep along the x axis
+	void Rebuild();
+
+	void AddPair(uint32_t proxy1, uint32_t proxy2);
+	void RemovePair(uint32_t proxy1, uint32_t proxy2);
+	void RemovePairAt(uint32_t index);
+
+	std::vector<SAPEndpoint> _endpoints[3];
+	std::vector<SAPProxy> _proxies;
+	std::vector<uint32_t> _freeProxies;
+	int _proxyCount;
+
+	// Set when objects have been added that are not yet sorted into the endpoint arrays
+	bool _needsRebuild;
+
+	// The pairs are kept in a dense array so they can be copied out in one go. The map takes a pair of
+	// proxies to its place in the array so pairs can be found and removed in constant time.
+	std::vector<BroadphasePair> _pairs;
+	std::vector<uint64_t> _pairKeys;
+	std::vector<uint32_t> _pairStamps;
+	std::unordered_map<uint64_t, uint32_t> _pairIndices;
+	uint32_t _stamp;
+
+	// The boxes the sweep is currently inside of while rebuilding
+	std::vector<uint32_t> _active;
+	std::vector<uint32_t> _activeIndex;
+
+	PairCallback _pairAdded;
+	PairCallback _pairRemoved;
+	void* _userData;
+};
@@ -0,0 +1,636 @@
+/*
+Title: Broadphase
+File Name: main.cpp
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+The collision examples each test a single pair of shapes. With N shapes, testing every pair costs N*(N-1)/2
+narrowphase tests a frame, almost all of which find nothing. A broadphase cheaply finds the pairs that could
+be touching so the narrowphase only has to run on those.
+
+This program bounces a few hundred spheres of different sizes around inside a box, with three broadphases to choose
+from. All of them take the same boxes and give back pairs in the same format (Broadphase.h), so any of them can sit
+in front of the narrowphase.
+
+The dynamic AABB tree (DynamicAABBTree.h) keeps a slightly enlarged box for every sphere in a bounding volume
+hierarchy. Every frame the spheres tell the tree where they moved to, which only changes the tree when a sphere
+leaves its enlarged box. The tree then lists the pairs whose boxes overlap.
+
+Sweep and prune (SweepAndPrune.h) keeps the ends of every box sorted along each axis. The spheres only move a
+little each frame, so re-sorting is cheap, and each time two ends swap places a pair starts or stops overlapping.
+The set of overlapping pairs is updated as that happens rather than searched for.
+
+The loose octree (LooseOctree.h) stores each sphere in a single cell, at the depth whose cells are just big enough
+for it, so the few large spheres sit near the root and the small ones further down. Its cells overlap their
+neighbours by half a cell, so a sphere's whole box is always inside its cell's bounds and nothing is missed for being
+centered in one cell but reaching into another. Besides finding pairs, the octree is also used to find the spheres
+in the camera's frustum when drawing, and to find the spheres under the mouse when clicking.
+
+The pairs are handed to the same MTV test used in the Sphere_MTVAndDecoupling example, which pushes colliding
+spheres apart and bounces them off each other.
+
+Spheres that touched another sphere this frame are drawn in blue. Click on a sphere to select it, which draws it in green.
+Press "B" to switch between the dynamic AABB tree, sweep and prune, and the loose octree.
+Press "P" to print how many pairs the broadphase found compared to testing every pair, and how long it took.
+Press "R" to scatter the spheres again.
+
+References:
+Real time collision Detection by Ericson
+Box2D by Erin Catto (b2DynamicTree)
+Bullet Physics by Erwin Coumans (btAxisSweep3)
+Game Programming Gems by Thatcher Ulrich (Loose Octrees)
+3D Sphere collision with MTV derivation and decoupling by Srinivasan Thiagarajan
+*/
+
+
+#include "GLIncludes.h"
+#include "DynamicAABBTree.h"
+#include "SweepAndPrune.h"
+#include "LooseOctree.h"
+
+#pragma region program specific Data members
+
+#define NUM_SPHERES 300
+
+// Most spheres are small, but every LARGE_SPHERE_INTERVAL-th sphere is much bigger
+#define LARGE_SPHERE_INTERVAL 50
+float minRadius = 0.02f;
+float maxRadius = 0.05f;
+float largeRadius = 0.2f;
+
+// Half the width of the box the spheres bounce around in
+float boundary = 1.0f;
+
+float maxSpeed = 0.6f;
+
+#pragma endregion
+
+//This struct consists of the basic stuff needed for getting the shape on the screen.
+struct stuff_for_drawing{
+
+	//This stores the address the buffer/memory in the GPU. It acts as a handle to access the buffer memory in GPU.
+	GLuint vbo;
+
+	//This will be used to tell the GPU, how many vertices will be needed to draw during drawcall.
+	int numberOfVertices;
+
+	//This function gets the number of vertices and all the vertex values and stores them in the buffer.
+	void initBuffer(int numVertices, VertexFormat* vertices)
+	{
+		numberOfVertices = numVertices;
+
+		glGenBuffers(1, &vbo);
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(VertexFormat) * numVertices, vertices, GL_STATIC_DRAW);
+
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexFormat), (void*)16);
+
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(VertexFormat), (void*)0);
+	}
+};
+
+struct Sphere{
+	glm::vec3 origin;
+	glm::vec3 velocity;
+	float radius;
+
+	float mass;
+
+	// The sphere's handles in each broadphase
+	int treeProxy;
+	int sapProxy;
+	int octreeProxy;
+
+	// Set when the narrowphase finds this sphere touching another one this frame
+	bool colliding;
+};
+
+std::vector<Sphere> spheres;
+
+// Every sphere is drawn from the same unit sphere, colored for resting, colliding or selected spheres
+stuff_for_drawing sphereMesh, collidingMesh, selectedMesh;
+
+enum BroadphaseType
+{
+	Dynamic_AABB_Tree,
+	Sweep_And_Prune,
+	Loose_Octree,
+	Num_Broadphases
+};
+
+const char* broadphaseNames[Num_Broadphases] = { "the dynamic AABB tree", "sweep and prune", "the loose octree" };
+
+DynamicAABBTree tree(0.02f);
+SweepAndPrune sap;
+LooseOctree octree(glm::vec3(0.0f), 1.0f, 6);
+
+// Only the broadphase in use is kept up to date, except for the octree which is also used for drawing and picking.
+// When switching, the new broadphase catches up on its next update.
+BroadphaseType broadphase = Dynamic_AABB_Tree;
+
+// Spheres found by the octree's frustum and ray queries
+std::vector<uint32_t> visibleSpheres;
+std::vector<uint32_t> rayHits;
+
+int selectedSphere = -1;
+
+// Reused every frame, so once it has grown large enough finding pairs does not allocate
+std::vector<BroadphasePair> pairs;
+
+int numContacts = 0;
+
+// Pairs sweep and prune has reported starting and stopping to overlap since the stats were last printed
+int pairsAdded = 0;
+int pairsRemoved = 0;
+
+// Time spent in the broadphase since the stats were last printed
+double broadphaseTime = 0.0;
+int broadphaseFrames = 0;
+
+#pragma region Global Data member
+GLuint program;
+GLuint vertex_shader;
+GLuint fragment_shader;
+GLuint uniMVP;
+glm::mat4 view;
+glm::mat4 proj;
+glm::mat4 PV;
+GLFWwindow* window;
+double previousTime;
+#pragma endregion
+
+float randomFloat(float min, float max)
+{
+	return min + (max - min) * (rand() / (float)RAND_MAX);
+}
+
+BroadphaseAABB sphereBox(const Sphere& sphere)
+{
+	BroadphaseAABB box;
+	box.min = sphere.origin - glm::vec3(sphere.radius);
+	box.max = sphere.origin + glm::vec3(sphere.radius);
+	return box;
+}
+
+void scatterSpheres()
+{
+	for (unsigned int i = 0; i < spheres.size(); i++)
+	{
+		float extent = boundary - spheres[i].radius;
+		spheres[i].origin = glm::vec3(randomFloat(-extent, extent), randomFloat(-extent, extent), randomFloat(-extent, extent));
+		spheres[i].velocity = glm::vec3(randomFloat(-maxSpeed, maxSpeed), randomFloat(-maxSpeed, maxSpeed), randomFloat(-maxSpeed, maxSpeed));
+		tree.MoveProxy(spheres[i].treeProxy, sphereBox(spheres[i]), glm::vec3(0.0f));
+		sap.MoveProxy(spheres[i].sapProxy, sphereBox(spheres[i]));
+		octree.MoveProxy(spheres[i].octreeProxy, sphereBox(spheres[i]));
+	}
+}
+
+void onPairAdded(const BroadphasePair& pair, void* userData)
+{
+	pairsAdded++;
+}
+
+void onPairRemoved(const BroadphasePair& pair, void* userData)
+{
+	pairsRemoved++;
+}
+
+void setup()
+{
+	// Create a unit sphere mesh the same way as the other sphere examples, each sphere scales it to its own radius
+	std::vector<VertexFormat> vertexSet;
+	float pitch = 0.0f, yaw = 0.0f;
+	float pitchDelta = 360 / DIVISIONS;
+	float yawDelta = 360 / DIVISIONS;
+	glm::vec4 color = glm::vec4(0.7f, 0.2f, 0.0f, 1.0f);
+
+	for (int i = 0; i < DIVISIONS; i++)
+	{
+		for (int j = 0; j < DIVISIONS; j++)
+		{
+			VertexFormat p1, p2, p3, p4;
+			p1.position = glm::vec3(sin(pitch * PI / 180.0) * cos(yaw * PI / 180.0), sin(pitch * PI / 180.0) * sin(yaw * PI / 180.0), cos(pitch * PI / 180.0));
+			p2.position = glm::vec3(sin(pitch * PI / 180.0) * cos((yaw + yawDelta) * PI / 180.0), sin(pitch * PI / 180.0) * sin((yaw + yawDelta) * PI / 180.0), cos(pitch * PI / 180.0));
+			p3.position = glm::vec3(sin((pitch + pitchDelta) * PI / 180.0) * cos((yaw + yawDelta) * PI / 180.0), sin((pitch + pitchDelta) * PI / 180.0) * sin((yaw + yawDelta) * PI / 180.0), cos((pitch + pitchDelta) * PI / 180.0));
+			p4.position = glm::vec3(sin((pitch + pitchDelta) * PI / 180.0) * cos(yaw * PI / 180.0), sin((pitch + pitchDelta) * PI / 180.0) * sin(yaw * PI / 180.0), cos((pitch + pitchDelta) * PI / 180.0));
+			p1.color = p2.color = p3.color = p4.color = color;
+
+			vertexSet.push_back(p1);
+			vertexSet.push_back(p2);
+			vertexSet.push_back(p3);
+			vertexSet.push_back(p1);
+			vertexSet.push_back(p3);
+			vertexSet.push_back(p4);
+
+			yaw = yaw + yawDelta;
+		}
+		pitch += pitchDelta;
+	}
+
+	sphereMesh.initBuffer(vertexSet.size(), &vertexSet[0]);
+
+	for (unsigned int i = 0; i < vertexSet.size(); i++)
+	{
+		vertexSet[i].color = glm::vec4(0.0f, 0.2f, 0.7f, 1.0f);
+	}
+	collidingMesh.initBuffer(vertexSet.size(), &vertexSet[0]);
+
+	for (unsigned int i = 0; i < vertexSet.size(); i++)
+	{
+		vertexSet[i].color = glm::vec4(0.1f, 0.8f, 0.1f, 1.0f);
+	}
+	selectedMesh.initBuffer(vertexSet.size(), &vertexSet[0]);
+
+	// Register every sphere with the broadphase
+	spheres.resize(NUM_SPHERES);
+	for (unsigned int i = 0; i < spheres.size(); i++)
+	{
+		spheres[i].origin = glm::vec3(0.0f);
+		spheres[i].radius = i % LARGE_SPHERE_INTERVAL == 0 ? largeRadius : randomFloat(minRadius, maxRadius);
+		spheres[i].mass = spheres[i].radius * spheres[i].radius * spheres[i].radius;
+		spheres[i].colliding = false;
+		spheres[i].treeProxy = tree.CreateProxy(sphereBox(spheres[i]), i);
+		spheres[i].sapProxy = sap.CreateProxy(sphereBox(spheres[i]), i);
+		spheres[i].octreeProxy = octree.CreateProxy(sphereBox(spheres[i]), i);
+	}
+	sap.SetPairCallbacks(onPairAdded, onPairRemoved, 0);
+	scatterSpheres();
+}
+
+#pragma region Helper_functions
+// Reads the shader file
+std::string readShader(std::string fileName)
+{
+	std::string shaderCode;
+	std::string line;
+
+	std::ifstream file(fileName, std::ios::in);
+	if (!file.good())
+	{
+		std::cout << "Can't read file: " << fileName.data() << std::endl;
+		return "";
+	}
+
+	file.seekg(0, std::ios::end);
+	shaderCode.resize((unsigned int)file.tellg());
+	file.seekg(0, std::ios::beg);
+	file.read(&shaderCode[0], shaderCode.size());
+	file.close();
+	return shaderCode;
+}
+
+// Creates and compiles a shader
+GLuint createShader(std::string sourceCode, GLenum shaderType)
+{
+	GLuint shader = glCreateShader(shaderType);
+	const char *shader_code_ptr = sourceCode.c_str();
+	const int shader_code_size = sourceCode.size();
+
+	glShaderSource(shader, 1, &shader_code_ptr, &shader_code_size);
+	glCompileShader(shader);
+
+	GLint isCompiled = 0;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
+	if (isCompiled == GL_FALSE)
+	{
+		char infolog[1024];
+		glGetShaderInfoLog(shader, 1024, NULL, infolog);
+		std::cout << "The shader failed to compile with the error:" << std::endl << infolog << std::endl;
+		glDeleteShader(shader);
+	}
+
+	return shader;
+}
+
+// Initialization code
+void init()
+{
+	glewInit();
+	glEnable(GL_DEPTH_TEST);
+
+	std::string vertShader = readShader("VertexShader.glsl");
+	std::string fragShader = readShader("FragmentShader.glsl");
+
+	vertex_shader = createShader(vertShader, GL_VERTEX_SHADER);
+	fragment_shader = createShader(fragShader, GL_FRAGMENT_SHADER);
+
+	program = glCreateProgram();
+	glAttachShader(program, vertex_shader);
+	glAttachShader(program, fragment_shader);
+	glLinkProgram(program);
+
+	view = glm::lookAt(glm::vec3(0.0f, 0.0f, 3.5f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	proj = glm::perspective(45.0f, 800.0f / 800.0f, 0.1f, 100.0f);
+	PV = proj * view;
+
+	uniMVP = glGetUniformLocation(program, "MVP");
+
+	glFrontFace(GL_CCW);
+	glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+
+	previousTime = glfwGetTime();
+}
+#pragma endregion
+
+// This function returns true if the two spheres are colliding, and if they are it gives the MTV which moves B out of A.
+bool returnMTV(Sphere &A, Sphere &B, glm::vec3 &mtv)
+{
+	glm::vec3 n;
+	n = B.origin - A.origin;
+
+	// Spheres at exactly the same spot have no direction to be pushed apart in
+	if (n == glm::vec3(0.0f))
+		return false;
+
+	n = glm::normalize(n);
+
+	glm::vec3 min, max;
+	min = A.origin + (n * A.radius);
+	max = B.origin - (n * B.radius);
+
+	if (glm::dot(n, min) > glm::dot(n, max))
+	{
+		float overlap = glm::dot(n, min) - glm::dot(n, max);
+		mtv = n * overlap;
+		return true;
+	}
+	else
+		return false;
+}
+
+#pragma region util_functions
+
+void update()
+{
+	double time = glfwGetTime();
+	float dt = (float)(time - previousTime);
+	previousTime = time;
+	if (dt > 1.0f / 30.0f) dt = 1.0f / 30.0f;
+
+	double broadphaseStart = glfwGetTime();
+
+	// Move the spheres and bounce them off the walls
+	for (unsigned int i = 0; i < spheres.size(); i++)
+	{
+		Sphere& s = spheres[i];
+		glm::vec3 displacement = s.velocity * dt;
+		s.origin += displacement;
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (s.origin[axis] - s.radius < -boundary)
+			{
+				s.origin[axis] = -boundary + s.radius;
+				s.velocity[axis] = fabs(s.velocity[axis]);
+			}
+			else if (s.origin[axis] + s.radius > boundary)
+			{
+				s.origin[axis] = boundary - s.radius;
+				s.velocity[axis] = -fabs(s.velocity[axis]);
+			}
+		}
+
+		s.colliding = false;
+		switch (broadphase)
+		{
+		case Dynamic_AABB_Tree: tree.MoveProxy(s.treeProxy, sphereBox(s), displacement); break;
+		case Sweep_And_Prune: sap.MoveProxy(s.sapProxy, sphereBox(s)); break;
+		default: octree.MoveProxy(s.octreeProxy, sphereBox(s)); break;
+		}
+	}
+
+	// Broadphase: find which spheres could be touching
+	switch (broadphase)
+	{
+	case Dynamic_AABB_Tree: tree.FindPairs(pairs); break;
+	case Sweep_And_Prune: sap.FindPairs(pairs); break;
+	default: octree.FindPairs(pairs); break;
+	}
+
+	broadphaseTime += glfwGetTime() - broadphaseStart;
+	broadphaseFrames++;
+
+	// The octree is used for drawing and picking, so keep it up to date even when it is not the broadphase
+	if (broadphase != Loose_Octree)
+	{
+		for (unsigned int i = 0; i < spheres.size(); i++)
+		{
+			octree.MoveProxy(spheres[i].octreeProxy, sphereBox(spheres[i]));
+		}
+	}
+
+	// Narrowphase: only the pairs the broadphase found are tested
+	numContacts = 0;
+	for (unsigned int i = 0; i < pairs.size(); i++)
+	{
+		Sphere& a = spheres[pairs[i].a];
+		Sphere& b = spheres[pairs[i].b];
+
+		glm::vec3 mtv;
+		if (returnMTV(a, b, mtv))
+		{
+			numContacts++;
+			a.colliding = b.colliding = true;
+
+			// Decouple the spheres, the lighter sphere moving further
+			float totalMass = a.mass + b.mass;
+			a.origin -= mtv * (b.mass / totalMass);
+			b.origin += mtv * (a.mass / totalMass);
+
+			// An elastic bounce along the normal between the centers
+			glm::vec3 n = glm::normalize(mtv);
+			float approach = glm::dot(a.velocity - b.velocity, n);
+			if (approach > 0.0f)
+			{
+				float impulse = 2.0f * approach / totalMass;
+				a.velocity -= n * (impulse * b.mass);
+				b.velocity += n * (impulse * a.mass);
+			}
+		}
+	}
+}
+
+void printStats()
+{
+	// Count the pairs a brute force broadphase would have to test, and how many of them actually overlap
+	int bruteForcePairs = 0;
+	int overlappingPairs = 0;
+	for (unsigned int i = 0; i < spheres.size(); i++)
+	{
+		for (unsigned int j = i + 1; j < spheres.size(); j++)
+		{
+			bruteForcePairs++;
+			if (Overlaps(sphereBox(spheres[i]), sphereBox(spheres[j])))
+				overlappingPairs++;
+		}
+	}
+
+	switch (broadphase)
+	{
+	case Dynamic_AABB_Tree:
+		std::cout << "\n Dynamic AABB tree, spheres: " << tree.proxyCount() << "  Tree height: " << tree.height();
+		break;
+	case Sweep_And_Prune:
+		std::cout << "\n Sweep and prune, spheres: " << sap.proxyCount();
+		std::cout << "\n Pairs added: " << pairsAdded << "  Pairs removed: " << pairsRemoved;
+		break;
+	default:
+		std::cout << "\n Loose octree, spheres: " << octree.proxyCount() << "  Cells in use: " << octree.nodeCount();
+		break;
+	}
+	std::cout << "\n Pairs tested: " << pairs.size() << " (brute force would test " << bruteForcePairs << ")";
+	std::cout << "\n Overlapping boxes: " << overlappingPairs << "  Contacts: " << numContacts;
+	std::cout << "\n Spheres in view: " << visibleSpheres.size();
+	std::cout << "\n Average broadphase time: " << (broadphaseFrames > 0 ? broadphaseTime / broadphaseFrames * 1000.0 : 0.0) << "ms over " << broadphaseFrames << " frames\n";
+
+	pairsAdded = pairsRemoved = 0;
+	broadphaseTime = 0.0;
+	broadphaseFrames = 0;
+}
+
+// Draws every sphere the camera can see, in blue if it is touching another sphere.
+void renderScene()
+{
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	glClearColor(0.2f, 0.2f, 0.2f, 1.0);
+
+	glUseProgram(program);
+
+	glm::vec4 planes[6];
+	LooseOctree::ExtractFrustumPlanes(PV, planes);
+	visibleSpheres.clear();
+	octree.QueryFrustum(planes, visibleSpheres);
+
+	for (unsigned int v = 0; v < visibleSpheres.size(); v++)
+	{
+		int i = visibleSpheres[v];
+		stuff_for_drawing& mesh = i == selectedSphere ? selectedMesh : (spheres[i].colliding ? collidingMesh : sphereMesh);
+		glm::mat4 MVP = PV * glm::translate(spheres[i].origin) * glm::scale(glm::vec3(spheres[i].radius));
+
+		glUniformMatrix4fv(uniMVP, 1, GL_FALSE, glm::value_ptr(MVP));
+		glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexFormat), (void*)16);
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(VertexFormat), (void*)0);
+		glDrawArrays(GL_TRIANGLES, 0, mesh.numberOfVertices);
+	}
+}
+
+// This function is used to handle key inputs.
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+	if (key == GLFW_KEY_B && action == GLFW_PRESS)
+	{
+		broadphase = (BroadphaseType)((broadphase + 1) % Num_Broadphases);
+		broadphaseTime = 0.0;
+		broadphaseFrames = 0;
+		std::cout << "\n Using " << broadphaseNames[broadphase] << "\n";
+	}
+	if (key == GLFW_KEY_P && action == GLFW_PRESS)
+	{
+		printStats();
+	}
+	if (key == GLFW_KEY_R && action == GLFW_PRESS)
+	{
+		scatterSpheres();
+	}
+}
+
+// Casts a ray from the camera through the mouse. The octree finds the spheres whose boxes the ray passes through,
+// and of those the nearest sphere the ray actually hits is selected.
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
+{
+	if (button != GLFW_MOUSE_BUTTON_LEFT || action != GLFW_PRESS)
+		return;
+
+	double x, y;
+	glfwGetCursorPos(window, &x, &y);
+
+	glm::vec4 viewport = glm::vec4(0.0f, 0.0f, 800.0f, 800.0f);
+	glm::vec3 nearPoint = glm::unProject(glm::vec3((float)x, 800.0f - (float)y, 0.0f), view, proj, viewport);
+	glm::vec3 farPoint = glm::unProject(glm::vec3((float)x, 800.0f - (float)y, 1.0f), view, proj, viewport);
+	glm::vec3 direction = farPoint - nearPoint;
+
+	rayHits.clear();
+	octree.QueryRay(nearPoint, direction, 1.0f, rayHits);
+
+	selectedSphere = -1;
+	float nearest = 1.0f;
+	for (unsigned int h = 0; h < rayHits.size(); h++)
+	{
+		// Solve |nearPoint + t * direction - origin| = radius for the first t
+		const Sphere& s = spheres[rayHits[h]];
+		glm::vec3 m = nearPoint - s.origin;
+		float a = glm::dot(direction, direction);
+		float b = glm::dot(m, direction);
+		float c = glm::dot(m, m) - s.radius * s.radius;
+		float discriminant = b * b - a * c;
+		if (discriminant < 0.0f)
+			continue;
+
+		float t = (-b - sqrt(discriminant)) / a;
+		if (t >= 0.0f && t < nearest)
+		{
+			nearest = t;
+			selectedSphere = rayHits[h];
+		}
+	}
+
+	if (selectedSphere >= 0)
+		std::cout << "\n Selected sphere " << selectedSphere << " out of " << rayHits.size() << " boxes under the mouse\n";
+}
+
+#pragma endregion
+
+void main()
+{
+	glfwInit();
+
+	window = glfwCreateWindow(800, 800, "Broadphase", nullptr, nullptr);
+
+	std::cout << "\n This program demonstrates three broadphases in front of a sphere-sphere narrowphase\n\n\n\n\n\n\n\n\n\n";
+	std::cout << "\n Press \"B\" to switch between the dynamic AABB tree, sweep and prune, and the loose octree.";
+	std::cout << "\n Click on a sphere to select it.";
+	std::cout << "\n Press \"P\" to print broadphase statistics.";
+	std::cout << "\n Press \"R\" to scatter the spheres.";
+
+	glfwMakeContextCurrent(window);
+	glfwSwapInterval(0);
+
+	init();
+
+	glfwSetKeyCallback(window, key_callback);
+	glfwSetMouseButtonCallback(window, mouse_button_callback);
+
+	setup();
+
+	while (!glfwWindowShouldClose(window))
+	{
+		update();
+
+		renderScene();
+
+		glfwSwapBuffers(window);
+
+		glfwPollEvents();
+	}
+
+	glDeleteShader(vertex_shader);
+	glDeleteShader(fragment_shader);
+	glDeleteProgram(program);
+
+	glfwTerminate();
+}
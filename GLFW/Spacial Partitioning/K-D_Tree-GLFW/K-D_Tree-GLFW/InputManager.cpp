@@ -8,6 +8,8 @@ bool InputManager::_upKey = false;
 bool InputManager::_prevUpKey = false;
 bool InputManager::_downKey = false;
 bool InputManager::_prevDownKey = false;
+bool InputManager::_spaceKey = false;
+bool InputManager::_prevSpaceKey = false;
 GLFWwindow* InputManager::_window;
 float InputManager::_aspectRatio = 0.0f;
 int InputManager::_windowSize[2];
@@ -27,6 +29,8 @@ void InputManager::Update()
 	_downKey = glfwGetKey(_window, GLFW_KEY_DOWN) == GLFW_PRESS;
 	_prevUpKey = _upKey;
 	_upKey = glfwGetKey(_window, GLFW_KEY_UP) == GLFW_PRESS;
+	_prevSpaceKey = _spaceKey;
+	_spaceKey = glfwGetKey(_window, GLFW_KEY_SPACE) == GLFW_PRESS;
 	glfwGetCursorPos(_window, &_mousePos[0], &_mousePos[1]);
 }
 
@@ -40,3 +44,4 @@ glm::vec2 InputManager::GetMouseCoords()
 bool InputManager::leftMouseButton(bool prev) { if (prev) return _prevLeftMouseButton; else return _leftMouseButton; }
 bool InputManager::upKey(bool prev) { if (prev) return _prevUpKey; else return _upKey; }
 bool InputManager::downKey(bool prev) { if (prev) return _prevDownKey; else return _downKey; }
+bool InputManager::spaceKey(bool prev) { if (prev) return _prevSpaceKey; else return _spaceKey; }
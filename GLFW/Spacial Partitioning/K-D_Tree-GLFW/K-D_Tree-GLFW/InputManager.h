@@ -14,6 +14,7 @@ public:
 	static bool leftMouseButton(bool prev = false);
 	static bool downKey(bool prev = false);
 	static bool upKey(bool prev = false);
+	static bool spaceKey(bool prev = false);
 
 private:
 
@@ -24,6 +25,8 @@ private:
 	static bool _prevUpKey;
 	static bool _downKey;
 	static bool _prevDownKey;
+	static bool _spaceKey;
+	static bool _prevSpaceKey;
 	static GLFWwindow* _window;
 	static float _aspectRatio;
 	static int _windowSize[2];
@@ -84,11 +84,12 @@ void InteractiveShape::Draw(const glm::mat4& viewProjMat)
 	RenderShape::Draw(viewProjMat);
 }
 
-const Collider& InteractiveShape::collider()
+Collider InteractiveShape::collider()
 {
 	Collider ret = _collider;
 	ret.x += _transform.position.x;
 	ret.y += _transform.position.y;
+	ret.z += _transform.position.z;
 	return ret;
 }
 
@@ -5,15 +5,19 @@ struct Collider
 {
 	float width;
 	float height;
+	float depth;
 	float x;
 	float y;
+	float z;
 
 	Collider()
 	{
 		width = 0.0f;
 		height = 0.0f;
+		depth = 0.0f;
 		x = 0.0f;
 		y = 0.0f;
+		z = 0.0f;
 	}
 };
 
@@ -27,7 +31,7 @@ public:
 
 	void Draw(const glm::mat4& viewProjMat);
 
-	const Collider& collider();
+	Collider collider();
 	bool mouseOver();
 	bool mouseOut();
 	bool moved();
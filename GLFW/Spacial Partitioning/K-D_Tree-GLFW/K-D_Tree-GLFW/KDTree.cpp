@@ -0,0 +1,312 @@
+#include "KDTree.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <string.h>
+#include <thread>
+
+// Helpers for this file only, kept out of the global namespace so they cannot clash with those of files linked beside it
+namespace
+{
+
+KDTreeNode MakeLeaf(uint32_t start, uint32_t end)
+{
+	KDTreeNode leaf;
+	leaf.start = start;
+	leaf.packed = ((end - start) << 2) | Leaf_Node;
+	return leaf;
+}
+
+struct CompareAxis
+{
+	int axis;
+	bool operator()(const KDTreeItem& a, const KDTreeItem& b) const { return a.center[axis] < b.center[axis]; }
+};
+
+bool Overlaps(const KDTreeAABB& a, const KDTreeAABB& b)
+{
+	return a.min[0] <= b.max[0] && a.max[0] >= b.min[0]
+		&& a.min[1] <= b.max[1] && a.max[1] >= b.min[1]
+		&& a.min[2] <= b.max[2] && a.max[2] >= b.min[2];
+}
+
+// Runs one block of a batch on a thread pool worker, data being the function that does a block
+template<class Work>
+void RunBlock(uint32_t task, uint32_t worker, void* data)
+{
+	(*(Work*)data)(task);
+}
+
+}
+
+KDTree::KDTree()
+{
+	_dimensions = 2;
+	_maxHalfExtent[0] = _maxHalfExtent[1] = _maxHalfExtent[2] = 0.0f;
+	_pool = 0;
+}
+
+KDTree::~KDTree()
+{
+	if (_pool != 0) ThreadPool_Free(_pool);
+}
+
+// The boxes' centers are copied into the item array, which is then divided up in place. Each interior node
+// takes the range of items it was given, partitions it about the median along its axis and hands each half to one
+// of its children. Nodes below the max depth, or with too few items to divide, become leaves that remember their range.
+// Once the arrays have grown to their largest size, rebuilding the tree does not touch the heap.
+void KDTree::Build(const KDTreeAABB* bounds, unsigned int numItems, int maxDepth, int dimensions)
+{
+	_dimensions = dimensions < 1 ? 1 : (dimensions > 3 ? 3 : dimensions);
+	_maxHalfExtent[0] = _maxHalfExtent[1] = _maxHalfExtent[2] = 0.0f;
+
+	_items.resize(numItems);
+	for (unsigned int i = 0; i < numItems; ++i)
+	{
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			_items[i].center[axis] = (bounds[i].min[axis] + bounds[i].max[axis]) * 0.5f;
+			float halfExtent = (bounds[i].max[axis] - bounds[i].min[axis]) * 0.5f;
+			if (halfExtent > _maxHalfExtent[axis]) _maxHalfExtent[axis] = halfExtent;
+		}
+		_items[i].id = i;
+	}
+
+	_nodes.clear();
+	_nodes.push_back(KDTreeNode());
+
+	// To avoid messy recursion, the ranges still to be divided are kept in a stack. Pushing the right half
+	// before the left half builds the tree depth-first, so each subtree ends up close together in the array.
+	// The stack is a member so it keeps its capacity from one build to the next.
+	std::vector<KDBuildTask>& stack = _buildStack;
+	stack.clear();
+	KDBuildTask root = { 0, 0, numItems, 0 };
+	stack.push_back(root);
+
+	while (!stack.empty())
+	{
+		KDBuildTask task = stack.back();
+		stack.pop_back();
+
+		uint32_t count = task.end - task.start;
+		if (task.depth > maxDepth || count < 2)
+		{
+			_nodes[task.node] = MakeLeaf(task.start, task.end);
+			continue;
+		}
+
+		// There is no need to fully sort the range, only to find the median and split the rest around it
+		CompareAxis compare;
+		compare.axis = task.depth % _dimensions;
+		uint32_t median = task.start + count / 2;
+		std::nth_element(_items.begin() + task.start, _items.begin() + median, _items.begin() + task.end, compare);
+
+		uint32_t left = _nodes.size();
+		_nodes.push_back(KDTreeNode());
+		_nodes.push_back(KDTreeNode());
+
+		KDTreeNode& node = _nodes[task.node];
+		node.axisValue = _items[median].center[compare.axis];
+		node.packed = (left << 2) | compare.axis;
+
+		KDBuildTask rightTask = { left + 1, median, task.end, task.depth + 1 };
+		KDBuildTask leftTask = { left, task.start, median, task.depth + 1 };
+		stack.push_back(rightTask);
+		stack.push_back(leftTask);
+	}
+
+	_bounds.resize(numItems);
+	for (unsigned int i = 0; i < numItems; ++i)
+	{
+		_bounds[i] = bounds[_items[i].id];
+	}
+}
+
+// Every step down the tree reads a single 8 byte node.
+void KDTree::QueryPoint(const float point[3], uint32_t& start, uint32_t& end) const
+{
+	start = end = 0;
+	if (_nodes.empty()) return;
+
+	uint32_t i = 0;
+	while (true)
+	{
+		const KDTreeNode& node = _nodes[i];
+		if (node.isLeaf())
+		{
+			start = node.start;
+			end = node.start + node.count();
+			return;
+		}
+
+		// Go down the tree until we reach a leaf unless we hit a dividing line.
+		float pos = point[node.axis()];
+		if (pos != node.axisValue)
+		{
+			i = pos < node.axisValue ? node.left() : node.right();
+		}
+		else
+		{
+			// If we're actually on the divider, then return both sides. The range of the whole subtree
+			// runs from its left-most leaf to its right-most leaf.
+			uint32_t first = node.left();
+			while (!_nodes[first].isLeaf()) first = _nodes[first].left();
+			uint32_t last = node.right();
+			while (!_nodes[last].isLeaf()) last = _nodes[last].right();
+
+			start = _nodes[first].start;
+			end = _nodes[last].start + _nodes[last].count();
+			return;
+		}
+	}
+}
+
+// Every item left of a dividing line has its center at or before the line, so its box can reach at most the
+// largest half extent past it (and likewise for the right side). A subtree is only searched if the query box
+// reaches into that widened region.
+void KDTree::QueryBox(const KDTreeAABB& box, std::vector<uint32_t>& results) const
+{
+	if (_nodes.empty()) return;
+
+	// The tree is never deeper than the number of bits in a node index, so a small fixed stack is enough
+	uint32_t stack[64];
+	int top = 0;
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		const KDTreeNode& node = _nodes[stack[--top]];
+		if (node.isLeaf())
+		{
+			uint32_t end = node.start + node.count();
+			for (uint32_t i = node.start; i < end; ++i)
+			{
+				if (Overlaps(_bounds[i], box)) results.push_back(_items[i].id);
+			}
+			continue;
+		}
+
+		Axis axis = node.axis();
+		if (box.max[axis] >= node.axisValue - _maxHalfExtent[axis]) stack[top++] = node.right();
+		if (box.min[axis] <= node.axisValue + _maxHalfExtent[axis]) stack[top++] = node.left();
+	}
+}
+
+void KDTree::QueryPointBatch(const float* points, unsigned int numQueries, std::vector<uint32_t>& results, std::vector<KDTreeQueryRange>& ranges, unsigned int numThreads)
+{
+	const std::vector<KDTreeItem>& items = _items;
+	RunBatch(numQueries, results, ranges, numThreads, [this, points, &items](unsigned int query, std::vector<uint32_t>& out)
+	{
+		uint32_t start, end;
+		QueryPoint(points + query * 3, start, end);
+		for (uint32_t i = start; i < end; ++i)
+		{
+			out.push_back(items[i].id);
+		}
+	});
+}
+
+void KDTree::QueryBoxBatch(const KDTreeAABB* boxes, unsigned int numQueries, std::vector<uint32_t>& results, std::vector<KDTreeQueryRange>& ranges, unsigned int numThreads)
+{
+	RunBatch(numQueries, results, ranges, numThreads, [this, boxes](unsigned int query, std::vector<uint32_t>& out)
+	{
+		QueryBox(boxes[query], out);
+	});
+}
+
+// Each thread takes a contiguous block of queries and writes into its own buffer, so threads never share
+// anything they write to. Afterwards the buffers are joined in thread order into the single output buffer
+// and every range is shifted by the offset its thread's buffer landed at. The blocks run on a thread pool started
+// by the first batch, with one worker per hardware thread, so a batch only costs waking the workers. A batch
+// split into more blocks than the pool has workers still runs, just with some workers taking more than one block.
+template<class Query>
+void KDTree::RunBatch(unsigned int numQueries, std::vector<uint32_t>& results, std::vector<KDTreeQueryRange>& ranges, unsigned int numThreads, Query query)
+{
+	if (numThreads == 0) numThreads = std::thread::hardware_concurrency();
+	if (numThreads > numQueries) numThreads = numQueries;
+	if (numThreads == 0) numThreads = 1;
+
+	ranges.resize(numQueries);
+	if (_threadResults.size() < numThreads) _threadResults.resize(numThreads);
+
+	unsigned int blockSize = (numQueries + numThreads - 1) / numThreads;
+	std::vector<std::vector<uint32_t> >& threadResults = _threadResults;
+	auto work = [&](unsigned int thread)
+	{
+		std::vector<uint32_t>& out = threadResults[thread];
+		out.clear();
+
+		unsigned int first = thread * blockSize;
+		unsigned int last = first + blockSize < numQueries ? first + blockSize : numQueries;
+		for (unsigned int q = first; q < last; ++q)
+		{
+			ranges[q].start = out.size();
+			query(q, out);
+			ranges[q].count = out.size() - ranges[q].start;
+		}
+	};
+
+	if (numThreads == 1)
+	{
+		work(0);
+	}
+	else
+	{
+		if (_pool == 0)
+		{
+			_pool = ThreadPool_Allocate();
+			ThreadPool_Initialize(_pool, 0);
+		}
+		ThreadPool_Run(_pool, numThreads, RunBlock<decltype(work)>, &work);
+	}
+
+	unsigned int total = 0;
+	for (unsigned int t = 0; t < numThreads; ++t)
+	{
+		total += threadResults[t].size();
+	}
+	results.resize(total);
+
+	unsigned int offset = 0;
+	for (unsigned int t = 0; t < numThreads; ++t)
+	{
+		unsigned int size = threadResults[t].size();
+		if (size > 0) memcpy(&results[offset], &threadResults[t][0], size * sizeof(uint32_t));
+
+		unsigned int first = t * blockSize;
+		unsigned int last = first + blockSize < numQueries ? first + blockSize : numQueries;
+		for (unsigned int q = first; q < last; ++q)
+		{
+			ranges[q].start += offset;
+		}
+		offset += size;
+	}
+}
+
+const std::vector<KDTreeNode>& KDTree::nodes() const
+{
+	return _nodes;
+}
+
+const std::vector<KDTreeItem>& KDTree::items() const
+{
+	return _items;
+}
+
+int KDTree::dimensions() const
+{
+	return _dimensions;
+}
+
+size_t KDTree::memoryUsed() const
+{
+	size_t bytes = _nodes.capacity() * sizeof(KDTreeNode);
+	bytes += _items.capacity() * sizeof(KDTreeItem);
+	bytes += _bounds.capacity() * sizeof(KDTreeAABB);
+	bytes += _buildStack.capacity() * sizeof(KDBuildTask);
+	for (unsigned int t = 0; t < _threadResults.size(); ++t)
+	{
+		bytes += _threadResults[t].capacity() * sizeof(uint32_t);
+	}
+	return bytes;
+}
@@ -0,0 +1,150 @@
+#pragma once
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+struct ThreadPool;
+
+enum Axis
+{
+	X_Axis,
+	Y_Axis,
+	Z_Axis,
+	// Not a dividing axis, marks a node with no children
+	Leaf_Node
+};
+
+// A single node of the K-D tree, packed into 8 bytes so that a whole path from the root to a leaf
+// fits into a couple of cache lines. Nodes hold no pointers; children are found by offset into the
+// node array and the items a leaf covers are a range of the tree's item array.
+struct KDTreeNode
+{
+	union
+	{
+		// Interior nodes: the location on the axis at which the division is made
+		float axisValue;
+		// Leaf nodes: index of the first item this leaf covers
+		uint32_t start;
+	};
+	// The low two bits hold the Axis of this node. The remaining bits hold the index of the left child
+	// for interior nodes (the right child always directly follows it) or the item count for leaf nodes.
+	uint32_t packed;
+
+	Axis axis() const { return (Axis)(packed & 3u); }
+	bool isLeaf() const { return (packed & 3u) == Leaf_Node; }
+	uint32_t left() const { return packed >> 2; }
+	uint32_t right() const { return (packed >> 2) + 1; }
+	uint32_t count() const { return packed >> 2; }
+};
+
+// An axis aligned bounding box. Points are boxes whose min and max are equal.
+struct KDTreeAABB
+{
+	float min[3];
+	float max[3];
+};
+
+// What the tree sorts. Keeping a copy of the center next to the id means building and searching the
+// tree never has to touch whatever the items came from. The id is the item's index in the array of
+// boxes the tree was built from.
+struct KDTreeItem
+{
+	float center[3];
+	uint32_t id;
+};
+
+// A range of items waiting to be sorted into the node at the given index
+struct KDBuildTask
+{
+	uint32_t node;
+	uint32_t start;
+	uint32_t end;
+	int depth;
+};
+
+// Where the results of one query in a batch were written in the shared output buffer
+struct KDTreeQueryRange
+{
+	uint32_t start;
+	uint32_t count;
+};
+
+// A K-D tree over the centers of up to three dimensional boxes. The tree is rebuilt from scratch by Build
+// and is read-only afterwards, so any number of threads can search it at once.
+class KDTree
+{
+public:
+	KDTree();
+	~KDTree();
+
+	///
+	//Sorts a set of boxes into the tree
+	//
+	//Parameters:
+	//	bounds: The boxes to sort, an item's id is its index in this array
+	//	numItems: The number of boxes
+	//	maxDepth: The depth of the deepest dividing node, leaves sit one level below it
+	//	dimensions: The number of axes to divide along (2 cycles X, Y; 3 cycles X, Y, Z)
+	void Build(const KDTreeAABB* bounds, unsigned int numItems, int maxDepth, int dimensions);
+
+	///
+	//Finds the range of the item array in the same leaf as a point. If the point lies exactly
+	//on a dividing line, the range covers both sides of that line.
+	//
+	//Parameters:
+	//	point: The point to search for
+	//	start: Set to the first item in the range
+	//	end: Set to one past the last item in the range
+	void QueryPoint(const float point[3], uint32_t& start, uint32_t& end) const;
+
+	///
+	//Appends the ids of all items whose boxes overlap a box to results
+	void QueryBox(const KDTreeAABB& box, std::vector<uint32_t>& results) const;
+
+	///
+	//Runs QueryPoint for an array of points across worker threads. The ids found for point i are written to
+	//results[ranges[i].start] through results[ranges[i].start + ranges[i].count - 1]. The output does not depend
+	//on the number of threads. The worker threads are started by the first batch and kept for the next ones.
+	//
+	//Parameters:
+	//	points: The points to search for, 3 floats each
+	//	numQueries: The number of points
+	//	results: Destination of the ids found by every query
+	//	ranges: Destination of each query's range within results
+	//	numThreads: The number of threads to split the queries across, 0 to use one per hardware thread
+	void QueryPointBatch(const float* points, unsigned int numQueries, std::vector<uint32_t>& results, std::vector<KDTreeQueryRange>& ranges, unsigned int numThreads = 0);
+
+	///
+	//Runs QueryBox for an array of boxes across worker threads, see QueryPointBatch
+	void QueryBoxBatch(const KDTreeAABB* boxes, unsigned int numQueries, std::vector<uint32_t>& results, std::vector<KDTreeQueryRange>& ranges, unsigned int numThreads = 0);
+
+	const std::vector<KDTreeNode>& nodes() const;
+	const std::vector<KDTreeItem>& items() const;
+	int dimensions() const;
+
+	// Bytes held by the node, item, box and build stack arrays and the per thread batch buffers
+	size_t memoryUsed() const;
+
+private:
+
+	template<class Query>
+	void RunBatch(unsigned int numQueries, std::vector<uint32_t>& results, std::vector<KDTreeQueryRange>& ranges, unsigned int numThreads, Query query);
+
+	std::vector<KDTreeNode> _nodes;
+	std::vector<KDTreeItem> _items;
+	// The items' boxes in the same order as _items, so leaves can test them front to back
+	std::vector<KDTreeAABB> _bounds;
+	// The largest half extent of any item along each axis. Items are sorted by their centers, so a box
+	// query has to reach this far past a dividing line to be sure it finds everything.
+	float _maxHalfExtent[3];
+	int _dimensions;
+
+	// The ranges still to be divided while building, kept so rebuilds do not allocate
+	std::vector<KDBuildTask> _buildStack;
+
+	// Per thread results of the last batch, kept so batches do not allocate once they have warmed up
+	std::vector<std::vector<uint32_t> > _threadResults;
+
+	// The worker threads the batches run on, null until the first batch with more than one thread
+	ThreadPool* _pool;
+};
@@ -0,0 +1,145 @@
+#include "KDTreeDebugView.h"
+#include "KDTreeManager.h"
+#include "RenderShape.h"
+#include "RenderManager.h"
+
+#include <stack>
+
+std::vector<RenderShape*> KDTreeDebugView::_dividers;
+RenderShape KDTreeDebugView::_lineTemplate;
+bool KDTreeDebugView::_enabled = true;
+unsigned int KDTreeDebugView::_revision = 0;
+
+// The region of the field a node divides
+struct KDDebugRegion
+{
+	unsigned int node;
+	float left;
+	float right;
+	float bottom;
+	float top;
+};
+
+void KDTreeDebugView::Init(RenderShape &lineTemplate)
+{
+	_lineTemplate = lineTemplate;
+	_revision = KDTreeManager::revision() - 1;
+}
+
+// Rebuilds the lines only if the tree has changed since they were last placed
+void KDTreeDebugView::Update()
+{
+	if (_enabled && _revision != KDTreeManager::revision())
+	{
+		Rebuild();
+		_revision = KDTreeManager::revision();
+	}
+}
+
+void KDTreeDebugView::SetEnabled(bool enabled)
+{
+	if (enabled == _enabled) return;
+
+	_enabled = enabled;
+	if (_enabled)
+	{
+		Rebuild();
+		_revision = KDTreeManager::revision();
+	}
+	else
+	{
+		unsigned int size = _dividers.size();
+		for (unsigned int i = 0; i < size; ++i)
+		{
+			_dividers[i]->active() = false;
+		}
+	}
+}
+
+bool KDTreeDebugView::enabled()
+{
+	return _enabled;
+}
+
+// Each node's line spans the region its parent left it, so the regions are passed down the tree alongside the nodes.
+// Most of this code is here for defining the transforms of the dividing lines, entirely aesthetic
+void KDTreeDebugView::Rebuild()
+{
+	const std::vector<KDTreeNode>& nodes = KDTreeManager::nodes();
+	unsigned int numDividers = 0;
+
+	std::stack<KDDebugRegion> stack = std::stack<KDDebugRegion>();
+	if (!nodes.empty())
+	{
+		KDDebugRegion root = { 0, -1.337f, 1.337f, -1.0f, 1.0f };
+		stack.push(root);
+	}
+
+	while (!stack.empty())
+	{
+		KDDebugRegion region = stack.top();
+		stack.pop();
+
+		const KDTreeNode& node = nodes[region.node];
+		if (node.isLeaf()) continue;
+
+		KDDebugRegion leftRegion = region;
+		KDDebugRegion rightRegion = region;
+		leftRegion.node = node.left();
+		rightRegion.node = node.right();
+
+		// Divisions along Z can't be seen from the front, so they get no line
+		if (node.axis() == Z_Axis)
+		{
+			stack.push(rightRegion);
+			stack.push(leftRegion);
+			continue;
+		}
+
+		RenderShape* divider = GetDivider(numDividers++);
+		divider->active() = true;
+
+		if (node.axis() == X_Axis)
+		{
+			divider->transform().rotation = glm::angleAxis(45.0f, glm::vec3(0.0f, 0.0f, 1.0f));
+			divider->transform().position = glm::vec3(node.axisValue, (region.top + region.bottom) / 2.0f, 0.0f);
+			divider->transform().scale = glm::vec3(1.0f, (region.top - region.bottom) / 1.4142136f / 2.0f, 1.0f);
+
+			leftRegion.right = node.axisValue;
+			rightRegion.left = node.axisValue;
+		}
+		else
+		{
+			divider->transform().rotation = glm::angleAxis(-45.0f, glm::vec3(0.0f, 0.0f, 1.0f));
+			divider->transform().position = glm::vec3((region.left + region.right) / 2.0f, node.axisValue, 0.0f);
+			divider->transform().scale = glm::vec3((region.right - region.left) / 1.4142136f / 2.0f, 1.0f, 1.0f);
+
+			leftRegion.top = node.axisValue;
+			rightRegion.bottom = node.axisValue;
+		}
+
+		stack.push(rightRegion);
+		stack.push(leftRegion);
+	}
+
+	// Hide any lines left over from a deeper tree
+	unsigned int size = _dividers.size();
+	for (unsigned int i = numDividers; i < size; ++i)
+	{
+		_dividers[i]->active() = false;
+	}
+}
+
+// Lines are only created the first time the tree needs that many. The RenderManager owns and draws them.
+RenderShape* KDTreeDebugView::GetDivider(unsigned int index)
+{
+	while (_dividers.size() <= index)
+	{
+		RenderShape* line = new RenderShape(_lineTemplate.vao(), _lineTemplate.count(), _lineTemplate.mode(), _lineTemplate.shader(), _lineTemplate.color());
+		line->active() = false;
+		RenderManager::AddShape(line);
+		_dividers.push_back(line);
+	}
+
+	return _dividers[index];
+}
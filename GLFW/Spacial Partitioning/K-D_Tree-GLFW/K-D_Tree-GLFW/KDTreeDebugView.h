@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+
+class RenderShape;
+
+// Draws the green lines that show where the K-D tree divides the field. The tree itself knows nothing
+// about rendering; this view walks the tree's node array whenever the tree has been rebuilt and places
+// one line per interior node.
+class KDTreeDebugView
+{
+public:
+
+	static void Init(RenderShape &lineTemplate);
+
+	static void Update();
+
+	static void SetEnabled(bool enabled);
+
+	static bool enabled();
+
+private:
+
+	static void Rebuild();
+
+	static RenderShape* GetDivider(unsigned int index);
+
+	static std::vector<RenderShape*> _dividers;
+	static RenderShape _lineTemplate;
+	static bool _enabled;
+	static unsigned int _revision;
+};
@@ -1,58 +1,14 @@
 #pragma once
 #include <vector>
+#include "KDTree.h"
 
 class InteractiveShape;
-class RenderShape;
-
-enum Axis
-{
-	X_Axis,
-	Y_Axis
-};
-
-enum Child
-{
-	Left,
-	Right,
-	Root
-};
-
-struct KDTreeNode
-{
-	// Render shape object for displaying this node
-	RenderShape* divider;
-	// The axis along which this node makes its division
-	Axis axis;
-	// The location on the axis at which the division is made
-	float axisValue;
-	// Indicies for left and right children of this node
-	int left;
-	int right;
-	// Index for this node's parent
-	int parent;
-	// Which child (Left or right) this node is to its parent
-	Child child;
-	// Whether or not this node should be displayed to the screen
-	bool active;
-	// What level of subdivision this node exists at
-	int depth;
-	// The child number of this node in this node's subdivision
-	int branchMod;
-	// This node's location in the entire node array
-	int index;
-	// The range of objects that this node has within its division
-	int start;
-	int end;
-	// The beginning and ending locations of the visual line showing this node's division
-	float lineStart;
-	float lineEnd;
-};
 
 class KDTreeManager
 {
 public:
 
-	static void InitKDTree(int maxDepth, RenderShape &lineTemplate);
+	static void InitKDTree(int maxDepth, int dimensions = 2);
 
 	static void UpdateKDtree();
 
@@ -62,23 +18,27 @@ public:
 
 	static void GetNearbyShapes(InteractiveShape* shape, std::vector<InteractiveShape*>& shapeVec);
 
+	static void GetOverlappingShapes(const KDTreeAABB& box, std::vector<InteractiveShape*>& shapeVec);
+
 	static void SetMaxDepth(int newMaxDepth);
 
 	static int maxDepth();
 
-private:
-
-	static KDTreeNode* InitNode(int depth, int parentIndex, int branchMod, int index, Child child, Axis axis);
+	static KDTree& tree();
 
-	static void DeactivateNode(KDTreeNode* node);
+	static const std::vector<KDTreeNode>& nodes();
 
-	static void ActivateNode(KDTreeNode* node, float axisValue);
+	// Incremented every time the tree is rebuilt
+	static unsigned int revision();
 
-	static int GetDepthIndex(int depth);
+private:
 
-	static std::vector<KDTreeNode*> _kdTree;
+	static KDTree _tree;
+	static std::vector<KDTreeAABB> _bounds;
+	static std::vector<uint32_t> _queryResults;
 	static std::vector<InteractiveShape*> _shapes;
 	static int _maxDepth;
 	static int _maxMaxDepth;
-	static RenderShape _lineTemplate;
+	static int _dimensions;
+	static unsigned int _revision;
 };
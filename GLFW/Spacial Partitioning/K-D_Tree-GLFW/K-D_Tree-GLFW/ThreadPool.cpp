@@ -0,0 +1,181 @@
+#include <stdio.h>
+
+#include "ThreadPool.h"
+
+///
+//Takes the next task for a worker, from the front of its own queue or else from the back of another worker's
+//
+//Parameters:
+//	pool: The thread pool
+//	worker: The number of the worker
+//	task: Set to the task taken
+//
+//Returns:
+//	1 if a task was taken, 0 if every queue is empty
+static int ThreadPool_TakeTask(ThreadPool* pool, const uint32_t worker, uint32_t* task)
+{
+	ThreadPoolQueue* own = pool->queues + worker;
+	{
+		std::lock_guard<std::mutex> lock(own->lock);
+		if (!own->tasks.empty())
+		{
+			*task = own->tasks.front();
+			own->tasks.pop_front();
+			return 1;
+		}
+	}
+
+	//Start with the next worker along so the thieves spread out over the queues
+	for (uint32_t i = 1; i < pool->numThreads; i++)
+	{
+		ThreadPoolQueue* victim = pool->queues + (worker + i) % pool->numThreads;
+		std::lock_guard<std::mutex> lock(victim->lock);
+		if (!victim->tasks.empty())
+		{
+			*task = victim->tasks.back();
+			victim->tasks.pop_back();
+			own->numStolen++;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+///
+//Runs on each worker thread, waiting for a batch, running tasks until none are left, and waiting again
+//
+//Parameters:
+//	pool: The thread pool
+//	worker: The number of the worker
+static void ThreadPool_Work(ThreadPool* pool, const uint32_t worker)
+{
+	uint32_t generation = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(pool->lock);
+			pool->start.wait(lock, [pool, generation] { return pool->quit || pool->generation != generation; });
+			if (pool->quit) return;
+			generation = pool->generation;
+		}
+
+		uint32_t numDone = 0;
+		uint32_t task;
+		while (ThreadPool_TakeTask(pool, worker, &task))
+		{
+			pool->task(task, worker, pool->data);
+			numDone++;
+		}
+		pool->queues[worker].numRun += numDone;
+
+		//Every task is taken by now, but others may still be running on other workers. The batch is only done
+		//once every worker has got here, so none is still looking through the queues when the next batch fills them.
+		std::lock_guard<std::mutex> lock(pool->lock);
+		pool->numFinished++;
+		if (pool->numFinished == pool->numThreads) pool->done.notify_one();
+	}
+}
+
+///
+//Allocates memory for a new thread pool
+//
+//Returns:
+//	Pointer to new thread pool
+ThreadPool* ThreadPool_Allocate()
+{
+	ThreadPool* pool = new ThreadPool();
+	pool->threads = 0x0;
+	pool->queues = 0x0;
+	pool->numThreads = 0;
+	pool->task = 0x0;
+	pool->data = 0x0;
+	pool->generation = 0;
+	pool->numFinished = 0;
+	pool->quit = false;
+	return pool;
+}
+
+///
+//Initializes a thread pool, starting its threads
+//
+//Parameters:
+//	pool: The thread pool to initialize
+//	numThreads: The number of worker threads to start, 0 to start one per hardware thread
+void ThreadPool_Initialize(ThreadPool* pool, uint32_t numThreads)
+{
+	if (pool->threads != 0x0)
+	{
+		printf("ThreadPool_Initialize failed! The thread pool is already initialized. Thread pool not initialized.\n");
+		return;
+	}
+	if (numThreads == 0) numThreads = std::thread::hardware_concurrency();
+	if (numThreads == 0) numThreads = 1;
+
+	pool->numThreads = numThreads;
+	pool->queues = new ThreadPoolQueue[numThreads];
+	pool->threads = new std::thread[numThreads];
+	for (uint32_t i = 0; i < numThreads; i++)
+	{
+		pool->queues[i].numRun = 0;
+		pool->queues[i].numStolen = 0;
+		pool->threads[i] = std::thread(ThreadPool_Work, pool, i);
+	}
+}
+
+///
+//Frees a thread pool's resources, stopping its threads
+//
+//Parameters:
+//	pool: The thread pool to free
+void ThreadPool_Free(ThreadPool* pool)
+{
+	{
+		std::lock_guard<std::mutex> lock(pool->lock);
+		pool->quit = true;
+	}
+	pool->start.notify_all();
+	for (uint32_t i = 0; i < pool->numThreads; i++)
+	{
+		pool->threads[i].join();
+	}
+	delete[] pool->threads;
+	delete[] pool->queues;
+	delete pool;
+}
+
+///
+//Runs a batch of tasks across the thread pool, returning once all of them are done
+//
+//Parameters:
+//	pool: The thread pool to run the tasks on
+//	numTasks: The number of tasks
+//	task: The function to run for each task
+//	data: Data passed to each call of the function
+void ThreadPool_Run(ThreadPool* pool, const uint32_t numTasks, ThreadPoolTask task, void* data)
+{
+	if (pool->threads == 0x0)
+	{
+		printf("ThreadPool_Run failed! The thread pool is not initialized. Tasks not run.\n");
+		return;
+	}
+	if (numTasks == 0) return;
+
+	//The workers are all waiting for the next batch, so nothing else touches the queues while they are filled
+	for (uint32_t i = 0; i < pool->numThreads; i++)
+	{
+		uint32_t first = (uint32_t)((uint64_t)numTasks * i / pool->numThreads);
+		uint32_t last = (uint32_t)((uint64_t)numTasks * (i + 1) / pool->numThreads);
+		for (uint32_t t = first; t < last; t++)
+		{
+			pool->queues[i].tasks.push_back(t);
+		}
+	}
+
+	std::unique_lock<std::mutex> lock(pool->lock);
+	pool->task = task;
+	pool->data = data;
+	pool->numFinished = 0;
+	pool->generation++;
+	pool->start.notify_all();
+	pool->done.wait(lock, [pool] { return pool->numFinished == pool->numThreads; });
+}
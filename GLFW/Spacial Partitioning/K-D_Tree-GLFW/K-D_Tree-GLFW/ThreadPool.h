@@ -0,0 +1,95 @@
+/*
+A pool of worker threads which run a batch of numbered tasks, balancing the work between them by work stealing.
+
+Each worker has its own queue of tasks. When a batch is run, the tasks are dealt out to the queues in contiguous
+ranges, so neighbouring tasks (neighbouring tiles of an image) go to the same worker. A worker takes tasks from the
+front of its own queue. When its queue is empty it steals from the back of another worker's queue, the end farthest
+from where that worker is taking, so the two rarely want the same lock at once. Tiles of an image take very different
+times to render (sky is nearly free, a tile full of spheres is not), and stealing keeps every worker busy until the
+whole batch is done instead of leaving some idle while one finishes its range.
+
+The threads are started once and wait between batches, so running a batch only costs waking them.
+
+References:
+Scheduling Multithreaded Computations by Work Stealing by Blumofe and Leiserson
+*/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <stdint.h>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+///
+//A function run for each task of a batch
+//
+//Parameters:
+//	task: The number of the task, from 0 to one less than the number of tasks in the batch
+//	worker: The number of the worker running the task, from 0 to one less than the number of threads
+//	data: The data given to ThreadPool_Run
+typedef void(*ThreadPoolTask)(uint32_t task, uint32_t worker, void* data);
+
+///
+//A worker's queue of tasks, and its counts of the tasks it ran and stole
+typedef struct ThreadPoolQueue
+{
+	std::deque<uint32_t> tasks;
+	std::mutex lock;
+
+	uint32_t numRun;
+	uint32_t numStolen;
+}ThreadPoolQueue;
+
+typedef struct ThreadPool
+{
+	std::thread* threads;
+	ThreadPoolQueue* queues;
+	uint32_t numThreads;
+
+	ThreadPoolTask task;			//The function and data of the batch being run
+	void* data;
+
+	std::mutex lock;				//Guards the members below
+	std::condition_variable start;	//Wakes the workers when a batch is run or the pool is freed
+	std::condition_variable done;	//Wakes ThreadPool_Run when the last worker is done with a batch
+	uint32_t generation;			//The number of batches run, so workers can tell a new batch from a spurious wake
+	uint32_t numFinished;			//The number of workers done with the batch, having found every queue empty
+	bool quit;
+}ThreadPool;
+
+///
+//Allocates memory for a new thread pool
+//
+//Returns:
+//	Pointer to new thread pool
+ThreadPool* ThreadPool_Allocate();
+
+///
+//Initializes a thread pool, starting its threads
+//
+//Parameters:
+//	pool: The thread pool to initialize
+//	numThreads: The number of worker threads to start, 0 to start one per hardware thread
+void ThreadPool_Initialize(ThreadPool* pool, uint32_t numThreads);
+
+///
+//Frees a thread pool's resources, stopping its threads
+//
+//Parameters:
+//	pool: The thread pool to free
+void ThreadPool_Free(ThreadPool* pool);
+
+///
+//Runs a batch of tasks across the thread pool, returning once all of them are done
+//
+//Parameters:
+//	pool: The thread pool to run the tasks on
+//	numTasks: The number of tasks
+//	task: The function to run for each task
+//	data: Data passed to each call of the function
+void ThreadPool_Run(ThreadPool* pool, const uint32_t numTasks, ThreadPoolTask task, void* data);
+
+#endif
@@ -41,8 +41,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 *	- This class handles all user input from the mouse and keyboard.
 *
 *	3) KDTreeManager
-*	- This class maintains an array of references to InteractiveShapes and sorts them into the K-DTree. Furthermore it maintains references to
-*	and updates the transforms of the green division lines to show the borders of the nodes.
+*	- This class maintains an array of references to InteractiveShapes and sorts their colliders into a KDTree.
+*
+*	KDTree
+*	- The tree itself, which works on plain 2D or 3D boxes and knows nothing about shapes or rendering. It is stored as a flat array of
+*	small nodes which hold no pointers. Besides single point and box searches, it can run large batches of searches across worker threads.
+*
+*	4) KDTreeDebugView
+*	- This class maintains references to and updates the transforms of the green division lines to show the borders of the nodes. It reads
+*	the K-D tree's node array whenever the tree changes. Press space to show or hide the lines.
 *
 *	RenderShape
 *	- Holds the instance data for a shape that can be rendered to the screen. This includes a transform, a vao, a shader, the drawing
@@ -71,6 +78,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "RenderManager.h"
 #include "InputManager.h"
 #include "KDTreeManager.h"
+#include "KDTreeDebugView.h"
 
 GLFWwindow* window;
 
@@ -191,7 +199,8 @@ void init()
 
 	InputManager::Init(window);
 
-	KDTreeManager::InitKDTree(5, RenderShape(vao1, 2, GL_LINE_STRIP, shader, glm::vec4(0.0f, 1.0f, 0.3f, 1.0f)));
+	KDTreeManager::InitKDTree(5);
+	KDTreeDebugView::Init(RenderShape(vao1, 2, GL_LINE_STRIP, shader, glm::vec4(0.0f, 1.0f, 0.3f, 1.0f)));
 	
 	unsigned int shapesSize = RenderManager::interactiveShapes().size();
 	for (unsigned int i = 0; i < shapesSize; ++i)
@@ -219,9 +228,14 @@ void step()
 	dDepth -= (InputManager::downKey(true) && !InputManager::downKey());
 	KDTreeManager::SetMaxDepth(KDTreeManager::maxDepth() + dDepth);
 
+	// Show or hide the division lines if space is pressed
+	if (InputManager::spaceKey(true) && !InputManager::spaceKey())
+		KDTreeDebugView::SetEnabled(!KDTreeDebugView::enabled());
+
 	RenderManager::Update(dt);
 	if (RenderManager::shapeMoved())
 		KDTreeManager::UpdateKDtree();
+	KDTreeDebugView::Update();
 
 	RenderManager::Draw();
 
@@ -0,0 +1,123 @@
+#include "UniformGrid.h"
+
+UniformGrid::UniformGrid(const glm::vec3& min, const glm::vec3& max, int cellsPerAxis)
+{
+	_cellsPerAxis = cellsPerAxis < 1 ? 1 : cellsPerAxis;
+	_min = min;
+	_cellSize = (max - min) / (float)_cellsPerAxis;
+	_cells.resize(_cellsPerAxis * _cellsPerAxis * _cellsPerAxis);
+	_maxHalfExtent = glm::vec3(0.0f);
+}
+
+UniformGrid::~UniformGrid()
+{
+}
+
+int UniformGrid::CellIndex(int x, int y, int z) const
+{
+	return (z * _cellsPerAxis + y) * _cellsPerAxis + x;
+}
+
+void UniformGrid::CellOf(const glm::vec3& point, int& x, int& y, int& z) const
+{
+	glm::vec3 cell = glm::floor((point - _min) / _cellSize);
+	x = (int)cell.x;
+	y = (int)cell.y;
+	z = (int)cell.z;
+
+	x = x < 0 ? 0 : (x > _cellsPerAxis - 1 ? _cellsPerAxis - 1 : x);
+	y = y < 0 ? 0 : (y > _cellsPerAxis - 1 ? _cellsPerAxis - 1 : y);
+	z = z < 0 ? 0 : (z > _cellsPerAxis - 1 ? _cellsPerAxis - 1 : z);
+}
+
+// Clearing the cells keeps their memory, so once every cell has grown large enough rebuilding does not allocate
+void UniformGrid::Build(const BroadphaseAABB* boxes, unsigned int numBoxes)
+{
+	for (unsigned int i = 0; i < _cells.size(); ++i)
+	{
+		_cells[i].clear();
+	}
+
+	_boxes.assign(boxes, boxes + numBoxes);
+	_maxHalfExtent = glm::vec3(0.0f);
+
+	for (unsigned int i = 0; i < numBoxes; ++i)
+	{
+		_maxHalfExtent = glm::max(_maxHalfExtent, (boxes[i].max - boxes[i].min) * 0.5f);
+
+		int x, y, z;
+		CellOf((boxes[i].min + boxes[i].max) * 0.5f, x, y, z);
+		_cells[CellIndex(x, y, z)].push_back(i);
+	}
+}
+
+// Any object overlapping the box has its center within the largest half extent of the box, so only the
+// cells under the box grown by that much need checking.
+void UniformGrid::QueryBox(const BroadphaseAABB& box, std::vector<uint32_t>& results) const
+{
+	int minX, minY, minZ, maxX, maxY, maxZ;
+	CellOf(box.min - _maxHalfExtent, minX, minY, minZ);
+	CellOf(box.max + _maxHalfExtent, maxX, maxY, maxZ);
+
+	for (int z = minZ; z <= maxZ; ++z)
+	{
+		for (int y = minY; y <= maxY; ++y)
+		{
+			for (int x = minX; x <= maxX; ++x)
+			{
+				const std::vector<uint32_t>& cell = _cells[CellIndex(x, y, z)];
+				for (unsigned int i = 0; i < cell.size(); ++i)
+				{
+					if (Overlaps(_boxes[cell[i]], box)) results.push_back(cell[i]);
+				}
+			}
+		}
+	}
+}
+
+// Each object checks the cells its box could reach into, the same way the SPH example gathers the neighbours
+// of each particle. Every pair would be found from both ends, so an object only keeps objects with larger ids.
+void UniformGrid::FindPairs(std::vector<BroadphasePair>& pairs) const
+{
+	pairs.clear();
+
+	for (unsigned int c = 0; c < _cells.size(); ++c)
+	{
+		const std::vector<uint32_t>& home = _cells[c];
+		for (unsigned int h = 0; h < home.size(); ++h)
+		{
+			uint32_t id = home[h];
+			const BroadphaseAABB& box = _boxes[id];
+
+			int minX, minY, minZ, maxX, maxY, maxZ;
+			CellOf(box.min - _maxHalfExtent, minX, minY, minZ);
+			CellOf(box.max + _maxHalfExtent, maxX, maxY, maxZ);
+
+			for (int z = minZ; z <= maxZ; ++z)
+			{
+				for (int y = minY; y <= maxY; ++y)
+				{
+					for (int x = minX; x <= maxX; ++x)
+					{
+						const std::vector<uint32_t>& cell = _cells[CellIndex(x, y, z)];
+						for (unsigned int i = 0; i < cell.size(); ++i)
+						{
+							if (cell[i] > id && Overlaps(_boxes[cell[i]], box)) pairs.push_back(MakePair(id, cell[i]));
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+size_t UniformGrid::memoryUsed() const
+{
+	size_t bytes = _cells.capacity() * sizeof(std::vector<uint32_t>);
+	for (unsigned int i = 0; i < _cells.size(); ++i)
+	{
+		bytes += _cells[i].capacity() * sizeof(uint32_t);
+	}
+	bytes += _boxes.capacity() * sizeof(BroadphaseAABB);
+	return bytes;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+#include "Broadphase.h"
+
+// A uniform grid in the style of the one in the Fluid SPH example: the world is cut into equal cells, each cell
+// holds a list of the objects whose centers fall inside it, and the grid is emptied and filled again whenever the
+// objects move. Objects are binned by center only, so searches reach as far past a cell as the largest object does.
+class UniformGrid
+{
+public:
+	///
+	//Parameters:
+	//	min: The lowest corner of the area the grid covers
+	//	max: The highest corner of the area the grid covers
+	//	cellsPerAxis: The number of cells along each axis
+	UniformGrid(const glm::vec3& min, const glm::vec3& max, int cellsPerAxis);
+	~UniformGrid();
+
+	///
+	//Empties the grid and sorts a set of boxes into it. Centers outside the grid go to the nearest edge cell.
+	//
+	//Parameters:
+	//	boxes: The boxes to sort, an object's id is its index in this array
+	//	numBoxes: The number of boxes
+	void Build(const BroadphaseAABB* boxes, unsigned int numBoxes);
+
+	///
+	//Appends the ids of all objects whose boxes overlap a box to results
+	void QueryBox(const BroadphaseAABB& box, std::vector<uint32_t>& results) const;
+
+	///
+	//Finds every pair of objects whose boxes overlap. The pair buffer is cleared first and reused.
+	void FindPairs(std::vector<BroadphasePair>& pairs) const;
+
+	// Bytes held by the cells and the copy of the boxes
+	size_t memoryUsed() const;
+
+private:
+
+	int CellIndex(int x, int y, int z) const;
+	void CellOf(const glm::vec3& point, int& x, int& y, int& z) const;
+
+	glm::vec3 _min;
+	glm::vec3 _cellSize;
+	int _cellsPerAxis;
+
+	std::vector<std::vector<uint32_t> > _cells;
+	std::vector<BroadphaseAABB> _boxes;
+	glm::vec3 _maxHalfExtent;
+};
@@ -0,0 +1,580 @@
+/*
+Title: Spatial Partitioning Benchmark
+File Name: main.cpp
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+There is no single best spatial partitioning structure. Which one wins depends on how many objects there are,
+how they are spread out, how big they are and how much they move. This program times the structures from the
+other spatial partitioning examples on the same generated scenes so they can be compared with numbers:
+
+	- The K-D tree from the K-D Tree example (the KDTree class KDTreeManager wraps), rebuilt every frame
+	- A uniform grid binned by center like the one in the Fluid SPH example, rebuilt every frame
+	- The dynamic AABB tree, sweep and prune and loose octree from the Broadphase example, updated incrementally
+
+Scenes are made of either points or boxes, spread either uniformly or in clusters, from 1,000 up to 1,000,000
+objects. The world grows with the number of objects, so the number of neighbours each object has stays about the
+same. Every scene is made from a fixed seed, so every run (and every structure) sees exactly the same objects.
+
+For each structure and scene the program measures:
+	build:	Putting every object into an empty structure
+	update:	Moving every object a short distance, as they would in one frame of a simulation, and bringing the
+			structure up to date. The K-D tree and grid are rebuilt; the others move each object.
+	query:	Finding the objects in boxes placed around randomly chosen objects
+	pairs:	Finding every pair of overlapping objects
+	memory:	The bytes the structure holds once it has been updated
+
+The results are printed as CSV and also written to a file. Sweep and prune has no box query, so it is left out of
+the query timings and its query columns are empty. It is only run up to 100,000 objects: past that, every object
+passes so many others along each axis as it moves that a single frame takes minutes. The dynamic AABB tree reports
+the pairs of its enlarged boxes, so it finds more pairs than the others, which report exact overlaps.
+
+The program takes two optional arguments: the file to write the CSV to, and the largest number of objects
+to test. Run it with Release settings, debug builds of the standard library are far slower.
+
+References:
+Real time collision Detection by Ericson
+Fluid SPH by Srinivasan Thiagarajan
+*/
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <chrono>
+#endif
+
+#include "KDTree.h"
+#include "DynamicAABBTree.h"
+#include "SweepAndPrune.h"
+#include "LooseOctree.h"
+#include "UniformGrid.h"
+
+#define NUM_UPDATE_FRAMES 5
+#define NUM_QUERIES 1000
+#define RANDOM_SEED 12345
+
+#pragma region Timing and random numbers
+
+// The standard clocks in Visual Studio 2013 only tick once a millisecond, so the performance counter is used there
+double GetSeconds()
+{
+#ifdef _WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// A xorshift generator. The standard library's distributions are allowed to differ between compilers,
+// so the scenes are built from this instead to be the same everywhere.
+struct Random
+{
+	uint32_t state;
+
+	Random(uint32_t seed) { state = seed ? seed : 1; }
+
+	uint32_t Next()
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	float Uniform(float min, float max)
+	{
+		return min + (max - min) * ((Next() >> 8) / 16777216.0f);
+	}
+
+	// Box-Muller transform
+	float Normal(float mean, float deviation)
+	{
+		float u1 = Uniform(1e-7f, 1.0f);
+		float u2 = Uniform(0.0f, 1.0f);
+		return mean + deviation * sqrtf(-2.0f * logf(u1)) * cosf(6.28318530718f * u2);
+	}
+};
+
+#pragma endregion
+
+#pragma region Scenes
+
+struct Scene
+{
+	std::string name;
+	glm::vec3 min;
+	glm::vec3 max;
+	std::vector<glm::vec3> centers;
+	std::vector<glm::vec3> halfExtents;
+	std::vector<glm::vec3> velocities;
+	std::vector<BroadphaseAABB> boxes;
+	std::vector<BroadphaseAABB> queries;
+};
+
+void UpdateBoxes(Scene& scene)
+{
+	scene.boxes.resize(scene.centers.size());
+	for (unsigned int i = 0; i < scene.centers.size(); ++i)
+	{
+		scene.boxes[i].min = scene.centers[i] - scene.halfExtents[i];
+		scene.boxes[i].max = scene.centers[i] + scene.halfExtents[i];
+	}
+}
+
+///
+//Makes a scene with about one object per unit of volume
+//
+//Parameters:
+//	numObjects: The number of objects in the scene
+//	clustered: Whether to gather the objects in clusters instead of spreading them evenly
+//	points: Whether the objects are points instead of boxes
+void MakeScene(Scene& scene, unsigned int numObjects, bool clustered, bool points)
+{
+	Random random(RANDOM_SEED + numObjects * 4 + (clustered ? 2 : 0) + (points ? 1 : 0));
+
+	float halfSize = 0.5f * powf((float)numObjects, 1.0f / 3.0f);
+	scene.name = std::string(clustered ? "clustered" : "uniform") + (points ? " points" : " boxes");
+	scene.min = glm::vec3(-halfSize);
+	scene.max = glm::vec3(halfSize);
+
+	std::vector<glm::vec3> clusters;
+	if (clustered)
+	{
+		clusters.resize(1 + numObjects / 1000);
+		for (unsigned int c = 0; c < clusters.size(); ++c)
+		{
+			clusters[c] = glm::vec3(random.Uniform(-halfSize, halfSize), random.Uniform(-halfSize, halfSize), random.Uniform(-halfSize, halfSize));
+		}
+	}
+	float clusterDeviation = halfSize * 0.05f + 1.0f;
+
+	scene.centers.resize(numObjects);
+	scene.halfExtents.resize(numObjects);
+	scene.velocities.resize(numObjects);
+	for (unsigned int i = 0; i < numObjects; ++i)
+	{
+		glm::vec3 center;
+		if (clustered)
+		{
+			const glm::vec3& cluster = clusters[random.Next() % clusters.size()];
+			center = glm::vec3(random.Normal(cluster.x, clusterDeviation), random.Normal(cluster.y, clusterDeviation), random.Normal(cluster.z, clusterDeviation));
+			center = glm::clamp(center, scene.min, scene.max);
+		}
+		else
+		{
+			center = glm::vec3(random.Uniform(-halfSize, halfSize), random.Uniform(-halfSize, halfSize), random.Uniform(-halfSize, halfSize));
+		}
+
+		scene.centers[i] = center;
+
+		// Mostly small boxes with the odd large one
+		float size = random.Uniform(0.05f, 0.3f);
+		if (random.Next() % 100 == 0) size *= 8.0f;
+		scene.halfExtents[i] = points ? glm::vec3(0.0f) : glm::vec3(size, random.Uniform(0.5f, 1.0f) * size, random.Uniform(0.5f, 1.0f) * size);
+
+		scene.velocities[i] = glm::vec3(random.Uniform(-0.05f, 0.05f), random.Uniform(-0.05f, 0.05f), random.Uniform(-0.05f, 0.05f));
+	}
+	UpdateBoxes(scene);
+
+	// Queries are centered on objects so that they find something even in clustered scenes
+	scene.queries.resize(NUM_QUERIES);
+	for (unsigned int q = 0; q < NUM_QUERIES; ++q)
+	{
+		glm::vec3 center = scene.centers[random.Next() % numObjects];
+		scene.queries[q].min = center - glm::vec3(1.0f);
+		scene.queries[q].max = center + glm::vec3(1.0f);
+	}
+}
+
+// Moves every object by its velocity, bouncing off the edges of the world
+void StepScene(Scene& scene)
+{
+	for (unsigned int i = 0; i < scene.centers.size(); ++i)
+	{
+		scene.centers[i] += scene.velocities[i];
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			if (scene.centers[i][axis] < scene.min[axis] || scene.centers[i][axis] > scene.max[axis])
+			{
+				scene.velocities[i][axis] = -scene.velocities[i][axis];
+				scene.centers[i][axis] += 2.0f * scene.velocities[i][axis];
+			}
+		}
+	}
+	UpdateBoxes(scene);
+}
+
+#pragma endregion
+
+#pragma region Structures
+
+// Gives every structure the same interface so they can all be run through the same benchmark
+class SpatialStructure
+{
+public:
+	virtual ~SpatialStructure() {}
+	virtual const char* name() const = 0;
+	virtual void Build(const Scene& scene) = 0;
+	virtual void Update(const Scene& scene) = 0;
+	// Structures without a box query are left out of the query timings instead of timing a query that does nothing
+	virtual bool hasBoxQuery() const { return true; }
+	virtual void QueryBox(const BroadphaseAABB& box, std::vector<uint32_t>& results) = 0;
+	virtual void FindPairs(std::vector<BroadphasePair>& pairs) = 0;
+	virtual size_t memoryUsed() const = 0;
+	// The most objects worth timing the structure with
+	virtual unsigned int maxObjects() const { return 0xFFFFFFFFu; }
+};
+
+// The boxes are handed to the tree the same way KDTreeManager::UpdateKDtree does it
+class KDTreeStructure : public SpatialStructure
+{
+public:
+	const char* name() const { return "K-D tree"; }
+
+	void Build(const Scene& scene)
+	{
+		unsigned int numObjects = scene.boxes.size();
+		_bounds.resize(numObjects);
+		for (unsigned int i = 0; i < numObjects; ++i)
+		{
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				_bounds[i].min[axis] = scene.boxes[i].min[axis];
+				_bounds[i].max[axis] = scene.boxes[i].max[axis];
+			}
+		}
+
+		// Aim for leaves of around 8 objects
+		int maxDepth = 0;
+		while ((numObjects >> (maxDepth + 1)) > 8) maxDepth++;
+
+		_tree.Build(numObjects > 0 ? &_bounds[0] : 0, numObjects, maxDepth, 3);
+	}
+
+	void Update(const Scene& scene) { Build(scene); }
+
+	void QueryBox(const BroadphaseAABB& box, std::vector<uint32_t>& results)
+	{
+		KDTreeAABB kdBox = { { box.min.x, box.min.y, box.min.z }, { box.max.x, box.max.y, box.max.z } };
+		_tree.QueryBox(kdBox, results);
+	}
+
+	void FindPairs(std::vector<BroadphasePair>& pairs)
+	{
+		pairs.clear();
+		for (uint32_t i = 0; i < _bounds.size(); ++i)
+		{
+			_results.clear();
+			_tree.QueryBox(_bounds[i], _results);
+			for (unsigned int r = 0; r < _results.size(); ++r)
+			{
+				if (_results[r] > i) pairs.push_back(MakePair(i, _results[r]));
+			}
+		}
+	}
+
+	size_t memoryUsed() const
+	{
+		return _tree.memoryUsed() + _bounds.capacity() * sizeof(KDTreeAABB) + _results.capacity() * sizeof(uint32_t);
+	}
+
+private:
+	KDTree _tree;
+	std::vector<KDTreeAABB> _bounds;
+	std::vector<uint32_t> _results;
+};
+
+class UniformGridStructure : public SpatialStructure
+{
+public:
+	UniformGridStructure() { _grid = 0; }
+	~UniformGridStructure() { delete _grid; }
+
+	const char* name() const { return "uniform grid"; }
+
+	// Cells are sized for about two objects each on average
+	void Build(const Scene& scene)
+	{
+		unsigned int numObjects = scene.boxes.size();
+		int cellsPerAxis = (int)powf(numObjects / 2.0f, 1.0f / 3.0f);
+		if (cellsPerAxis < 1) cellsPerAxis = 1;
+
+		delete _grid;
+		_grid = new UniformGrid(scene.min, scene.max, cellsPerAxis);
+		_grid->Build(numObjects > 0 ? &scene.boxes[0] : 0, numObjects);
+	}
+
+	void Update(const Scene& scene)
+	{
+		_grid->Build(scene.boxes.size() > 0 ? &scene.boxes[0] : 0, scene.boxes.size());
+	}
+
+	void QueryBox(const BroadphaseAABB& box, std::vector<uint32_t>& results) { _grid->QueryBox(box, results); }
+	void FindPairs(std::vector<BroadphasePair>& pairs) { _grid->FindPairs(pairs); }
+	size_t memoryUsed() const { return _grid ? _grid->memoryUsed() : 0; }
+
+private:
+	UniformGrid* _grid;
+};
+
+class DynamicAABBTreeStructure : public SpatialStructure
+{
+public:
+	DynamicAABBTreeStructure() { _tree = 0; }
+	~DynamicAABBTreeStructure() { delete _tree; }
+
+	const char* name() const { return "dynamic AABB tree"; }
+
+	void Build(const Scene& scene)
+	{
+		delete _tree;
+		_tree = new DynamicAABBTree(0.1f);
+		_proxies.resize(scene.boxes.size());
+		for (unsigned int i = 0; i < scene.boxes.size(); ++i)
+		{
+			_proxies[i] = _tree->CreateProxy(scene.boxes[i], i);
+		}
+	}
+
+	void Update(const Scene& scene)
+	{
+		for (unsigned int i = 0; i < scene.boxes.size(); ++i)
+		{
+			_tree->MoveProxy(_proxies[i], scene.boxes[i], scene.velocities[i]);
+		}
+	}
+
+	void QueryBox(const BroadphaseAABB& box, std::vector<uint32_t>& results) { _tree->Query(box, results); }
+	void FindPairs(std::vector<BroadphasePair>& pairs) { _tree->FindPairs(pairs); }
+	size_t memoryUsed() const { return (_tree ? _tree->memoryUsed() : 0) + _proxies.capacity() * sizeof(int); }
+
+private:
+	DynamicAABBTree* _tree;
+	std::vector<int> _proxies;
+};
+
+// The endpoints of a batch of new objects are only sorted in when pairs are next asked for,
+// so building includes that first sort.
+class SweepAndPruneStructure : public SpatialStructure
+{
+public:
+	SweepAndPruneStructure() { _sap = 0; }
+	~SweepAndPruneStructure() { delete _sap; }
+
+	const char* name() const { return "sweep and prune"; }
+
+	void Build(const Scene& scene)
+	{
+		delete _sap;
+		_sap = new SweepAndPrune();
+		_proxies.resize(scene.boxes.size());
+		for (unsigned int i = 0; i < scene.boxes.size(); ++i)
+		{
+			_proxies[i] = _sap->CreateProxy(scene.boxes[i], i);
+		}
+		_sap->FindPairs(_scratch);
+	}
+
+	void Update(const Scene& scene)
+	{
+		for (unsigned int i = 0; i < scene.boxes.size(); ++i)
+		{
+			_sap->MoveProxy(_proxies[i], scene.boxes[i]);
+		}
+	}
+
+	bool hasBoxQuery() const { return false; }
+	void QueryBox(const BroadphaseAABB&, std::vector<uint32_t>&) {}
+	void FindPairs(std::vector<BroadphasePair>& pairs) { _sap->FindPairs(pairs); }
+	size_t memoryUsed() const { return (_sap ? _sap->memoryUsed() : 0) + _proxies.capacity() * sizeof(int); }
+
+	// Along any one axis of a 3D world, the number of boxes an endpoint has to pass grows with the world, so
+	// the cost per object keeps climbing. Already at 100,000 boxes a frame takes seconds, and a million would
+	// keep the benchmark running for the better part of an hour.
+	unsigned int maxObjects() const { return 100000; }
+
+private:
+	SweepAndPrune* _sap;
+	std::vector<int> _proxies;
+	std::vector<BroadphasePair> _scratch;
+};
+
+class LooseOctreeStructure : public SpatialStructure
+{
+public:
+	LooseOctreeStructure() { _octree = 0; }
+	~LooseOctreeStructure() { delete _octree; }
+
+	const char* name() const { return "loose octree"; }
+
+	// Deep enough that the smallest cells hold about one object each
+	void Build(const Scene& scene)
+	{
+		int maxDepth = 1;
+		while ((1u << (3 * maxDepth)) < scene.boxes.size() && maxDepth < 16) maxDepth++;
+
+		delete _octree;
+		_octree = new LooseOctree((scene.min + scene.max) * 0.5f, (scene.max.x - scene.min.x) * 0.5f, maxDepth);
+		_proxies.resize(scene.boxes.size());
+		for (unsigned int i = 0; i < scene.boxes.size(); ++i)
+		{
+			_proxies[i] = _octree->CreateProxy(scene.boxes[i], i);
+		}
+	}
+
+	void Update(const Scene& scene)
+	{
+		for (unsigned int i = 0; i < scene.boxes.size(); ++i)
+		{
+			_octree->MoveProxy(_proxies[i], scene.boxes[i]);
+		}
+	}
+
+	void QueryBox(const BroadphaseAABB& box, std::vector<uint32_t>& results) { _octree->QueryBox(box, results); }
+	void FindPairs(std::vector<BroadphasePair>& pairs) { _octree->FindPairs(pairs); }
+	size_t memoryUsed() const { return (_octree ? _octree->memoryUsed() : 0) + _proxies.capacity() * sizeof(int); }
+
+private:
+	LooseOctree* _octree;
+	std::vector<int> _proxies;
+};
+
+#pragma endregion
+
+///
+//Runs every measurement for one structure on one scene and writes a row of CSV to each output
+//
+//Parameters:
+//	structure: The structure to measure
+//	scene: The scene to measure it on, copied so every structure starts from the same positions
+//	outputs: The files to write the row to
+//	numOutputs: The number of files
+void RunBenchmark(SpatialStructure& structure, Scene scene, FILE** outputs, int numOutputs)
+{
+	unsigned int numObjects = scene.boxes.size();
+
+	double start = GetSeconds();
+	structure.Build(scene);
+	double buildTime = GetSeconds() - start;
+
+	double updateTime = 0.0;
+	for (int frame = 0; frame < NUM_UPDATE_FRAMES; ++frame)
+	{
+		StepScene(scene);
+		start = GetSeconds();
+		structure.Update(scene);
+		updateTime += GetSeconds() - start;
+	}
+	updateTime /= NUM_UPDATE_FRAMES;
+
+	std::vector<uint32_t> results;
+	bool hasQuery = structure.hasBoxQuery();
+	size_t numResults = 0;
+	double queryTime = 0.0;
+	if (hasQuery)
+	{
+		start = GetSeconds();
+		for (unsigned int q = 0; q < scene.queries.size(); ++q)
+		{
+			results.clear();
+			structure.QueryBox(scene.queries[q], results);
+			numResults += results.size();
+		}
+		queryTime = GetSeconds() - start;
+	}
+
+	std::vector<BroadphasePair> pairs;
+	start = GetSeconds();
+	structure.FindPairs(pairs);
+	double pairTime = GetSeconds() - start;
+
+	size_t memory = structure.memoryUsed();
+
+	for (int o = 0; o < numOutputs; ++o)
+	{
+		fprintf(outputs[o], "%s,%s,%u,%.3f,%.0f,%.3f,%.0f,",
+			structure.name(), scene.name.c_str(), numObjects,
+			buildTime * 1000.0, numObjects / buildTime,
+			updateTime * 1000.0, numObjects / updateTime);
+
+		if (hasQuery)
+			fprintf(outputs[o], "%.3f,%.0f,%.1f,", queryTime * 1000.0, scene.queries.size() / queryTime, numResults / (double)scene.queries.size());
+		else
+			fprintf(outputs[o], ",,,");
+
+		fprintf(outputs[o], "%.3f,%u,%u,%.1f\n",
+			pairTime * 1000.0, (unsigned int)pairs.size(),
+			(unsigned int)memory, memory / (double)numObjects);
+		fflush(outputs[o]);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const char* fileName = argc > 1 ? argv[1] : "SpatialPartitioningBenchmark.csv";
+	unsigned int maxObjects = argc > 2 ? (unsigned int)atoi(argv[2]) : 1000000;
+
+	FILE* file = fopen(fileName, "w");
+	if (file == 0)
+	{
+		printf("Could not open %s for writing!\n", fileName);
+		return 1;
+	}
+
+	FILE* outputs[2] = { stdout, file };
+	for (int o = 0; o < 2; ++o)
+	{
+		fprintf(outputs[o], "structure,scene,objects,build_ms,build_objects_per_s,update_ms,update_objects_per_s,"
+			"query_ms,queries_per_s,results_per_query,pairs_ms,pairs,memory_bytes,bytes_per_object\n");
+	}
+
+	KDTreeStructure kdTree;
+	UniformGridStructure grid;
+	DynamicAABBTreeStructure dynamicTree;
+	SweepAndPruneStructure sweepAndPrune;
+	LooseOctreeStructure octree;
+	SpatialStructure* structures[] = { &kdTree, &grid, &dynamicTree, &sweepAndPrune, &octree };
+	int numStructures = sizeof(structures) / sizeof(structures[0]);
+
+	for (unsigned int numObjects = 1000; numObjects <= maxObjects; numObjects *= 10)
+	{
+		for (int clustered = 0; clustered < 2; ++clustered)
+		{
+			for (int points = 0; points < 2; ++points)
+			{
+				Scene scene;
+				MakeScene(scene, numObjects, clustered != 0, points != 0);
+				for (int s = 0; s < numStructures; ++s)
+				{
+					if (numObjects > structures[s]->maxObjects()) continue;
+					RunBenchmark(*structures[s], scene, outputs, 2);
+				}
+			}
+		}
+	}
+
+	fclose(file);
+	return 0;
+}